@@ -8,6 +8,7 @@
 #include "neuroh5_types.hh"
 #include "cell_index.hh"
 #include "cell_attributes.hh"
+#include "dataset_creation.hh"
 #include "compact_optional.hh"
 #include "optional_value.hh"
 #include "throw_assert.hh"
@@ -73,7 +74,8 @@ namespace neuroh5
      const set<size_t>              &io_rank_set,
      CellPtr ptr_type = CellPtr(PtrOwner),
      const size_t chunk_size = 4000,
-     const size_t value_chunk_size = 4000
+     const size_t value_chunk_size = 4000,
+     const hdf5::DatasetCreationPolicy& dataset_policy = hdf5::DatasetCreationPolicy()
      );
 
     int append_trees
@@ -85,7 +87,8 @@ namespace neuroh5
      std::forward_list<neurotree_t> &tree_list,
      size_t io_size,
      const size_t chunk_size = 4000,
-     const size_t value_chunk_size = 4000
+     const size_t value_chunk_size = 4000,
+     const hdf5::DatasetCreationPolicy& dataset_policy = hdf5::DatasetCreationPolicy()
      );
 
   }
@@ -2,7 +2,10 @@
 #define CELL_ATTRIBUTES_HH
 
 #include <cstdint>
+#include <map>
+#include <memory>
 #include <string>
+#include <tuple>
 #include <type_traits>
 #include <vector>
 #include <set>
@@ -13,13 +16,18 @@
 #include "mpe_seq.hh"
 #include "neuroh5_types.hh"
 #include "alltoallv_template.hh"
+#include "phase_stats.hh"
 #include "infer_datatype.hh"
 #include "infer_mpi_datatype.hh"
 #include "path_names.hh"
 #include "hdf5_cell_attributes.hh"
 #include "exists_dataset.hh"
 #include "file_access.hh"
+#include "dataset_creation.hh"
 #include "attr_map.hh"
+#include "columnar_attr_map.hh"
+#include "mapped_dataset.hh"
+#include "cell_index_cache.hh"
 #include "compact_optional.hh"
 #include "optional_value.hh"
 #include "range_sample.hh"
@@ -41,7 +49,8 @@ namespace neuroh5
      const CellIndex& index_type,
      const CellPtr&   ptr_type,
      const size_t     chunk_size,
-     const size_t     value_chunk_size
+     const size_t     value_chunk_size,
+     const hdf5::DatasetCreationPolicy& dataset_policy = hdf5::DatasetCreationPolicy()
      );
 
     
@@ -81,6 +90,20 @@ namespace neuroh5
      vector< tuple<string,AttrKind,vector<CELL_IDX_T>,vector<ATTR_PTR_T> > >& out_attributes
      );
 
+    /// Returns the attributes of a namespace with their sorted cell
+    /// indices. The indices are read on rank 0 and each distinct cell
+    /// index is broadcast once. If a file session is open over comm, the
+    /// result is kept in the session and later calls do not communicate.
+    /// Collective over comm.
+    std::shared_ptr<const data::CellAttributeIndex> get_cell_attribute_sorted_index
+    (
+     MPI_Comm                      comm,
+     const string&                 file_name,
+     const string&                 name_space,
+     const string&                 pop_name,
+     const CELL_IDX_T&             pop_start
+     );
+
     
     void read_cell_attributes
     (
@@ -95,6 +118,21 @@ namespace neuroh5
      size_t numitems = 0
      );
 
+    /// Same as above, with the values of each attribute stored in a
+    /// single contiguous column.
+    void read_cell_attributes
+    (
+     MPI_Comm         comm,
+     const string&    file_name,
+     const string&    name_space,
+     const set<string>& attr_mask,
+     const string&    pop_name,
+     const CELL_IDX_T& pop_start,
+     data::ColumnarAttrMap& attr_values,
+     size_t offset = 0,
+     size_t numitems = 0
+     );
+
     void read_cell_attribute_selection
     (
      MPI_Comm         comm,
@@ -138,6 +176,102 @@ namespace neuroh5
      size_t numitems = 0
      );
 
+    /// Same as above, with the values of each attribute stored in a
+    /// single contiguous column.
+    int scatter_read_cell_attributes
+    (
+     MPI_Comm                      all_comm,
+     const string                 &file_name,
+     const int                     io_size,
+     const string                 &attr_name_space,
+     const set<string>            &attr_mask,
+     // A vector that maps nodes to compute ranks
+     const node_rank_map_t        &node_rank_map,
+     const string                 &pop_name,
+     const CELL_IDX_T             &pop_start,
+     data::ColumnarAttrMap        &attr_map,
+     // if positive, these arguments specify offset and number of entries to read
+     // from the entries available to the current rank
+     size_t offset   = 0,
+     size_t numitems = 0
+     );
+
+    /// Reads several namespaces of a population, each with its own
+    /// attribute mask, in one collective pass. The I/O ranks read all
+    /// namespaces through one open file, and the values bound for each
+    /// rank are sent in a single message. Results are stored in attr_maps
+    /// under the namespace name.
+    int scatter_read_cell_attributes
+    (
+     MPI_Comm                      all_comm,
+     const string                 &file_name,
+     const int                     io_size,
+     const vector< pair<string, set<string> > > &attr_name_spaces,
+     // A vector that maps nodes to compute ranks
+     const node_rank_map_t        &node_rank_map,
+     const string                 &pop_name,
+     const CELL_IDX_T             &pop_start,
+     map<string, data::NamedAttrMap> &attr_maps,
+     // if positive, these arguments specify offset and number of entries to read
+     // from the entries available to the current rank
+     size_t offset   = 0,
+     size_t numitems = 0
+     );
+
+    /// @brief Reads successive blocks of the cell attributes of a
+    ///        population and scatters them as scatter_read_cell_attributes
+    ///        does.
+    ///
+    /// The I/O ranks, the I/O communicator, the open file, and the index
+    /// and pointer datasets of each attribute are set up once at
+    /// construction, so that each block read only reads a hyperslab of
+    /// the value datasets. node_rank_map is kept by reference and must
+    /// outlive the reader. Construction, read and destruction are
+    /// collective over comm.
+    class CellAttributeBlockReader
+    {
+    public:
+      CellAttributeBlockReader
+      (
+       MPI_Comm                      comm,
+       const string                 &file_name,
+       const int                     io_size,
+       const vector< pair<string, set<string> > > &attr_name_spaces,
+       const node_rank_map_t        &node_rank_map,
+       const string                 &pop_name,
+       const CELL_IDX_T             &pop_start
+       );
+      ~CellAttributeBlockReader ();
+
+      CellAttributeBlockReader (const CellAttributeBlockReader&) = delete;
+      CellAttributeBlockReader& operator= (const CellAttributeBlockReader&) = delete;
+
+      /// Reads the block of numitems entries per rank that starts at
+      /// offset, with the same meaning as the arguments of
+      /// scatter_read_cell_attributes. attr_maps receives one map per
+      /// namespace, in the order given at construction.
+      int read (size_t offset, size_t numitems, vector<data::NamedAttrMap>& attr_maps);
+      int read (size_t offset, size_t numitems, vector<data::ColumnarAttrMap>& attr_maps);
+
+      const vector< pair<string, set<string> > >& name_spaces () const { return attr_name_spaces; }
+
+    private:
+      template <class AttrMapT, class RankAttrMapT>
+      int read_impl (size_t offset, size_t numitems, vector<AttrMapT>& attr_maps);
+
+      MPI_Comm all_comm, io_comm;
+      bool     is_io_rank;
+      hid_t    file;
+      const string file_name;
+      const vector< pair<string, set<string> > > attr_name_spaces;
+      const node_rank_map_t& node_rank_map;
+      const string pop_name;
+      const CELL_IDX_T pop_start;
+      // names, types, indices and pointers of the attributes of each
+      // namespace, on the I/O ranks
+      vector< vector< tuple<string,AttrKind,vector<CELL_IDX_T>,vector<ATTR_PTR_T> > > > attr_infos;
+    };
+
     
     void bcast_cell_attributes
     (
@@ -154,6 +288,53 @@ namespace neuroh5
      );
 
     
+    /// @brief Cell attributes held in memory shared by the ranks of a
+    ///        node: for each value type, the index, pointer and value
+    ///        columns of each attribute by name.
+    struct SharedCellAttributes
+    {
+      std::tuple< std::map< std::string, hdf5::CellAttributeView<float> >,
+                  std::map< std::string, hdf5::CellAttributeView<uint8_t> >,
+                  std::map< std::string, hdf5::CellAttributeView<int8_t> >,
+                  std::map< std::string, hdf5::CellAttributeView<uint16_t> >,
+                  std::map< std::string, hdf5::CellAttributeView<int16_t> >,
+                  std::map< std::string, hdf5::CellAttributeView<uint32_t> >,
+                  std::map< std::string, hdf5::CellAttributeView<int32_t> > > views;
+
+      template <class T>
+      const std::map< std::string, hdf5::CellAttributeView<T> >& attr_views () const
+      {
+        return std::get< std::map< std::string, hdf5::CellAttributeView<T> > >(views);
+      }
+
+      template <class T>
+      std::map< std::string, hdf5::CellAttributeView<T> >& attr_views ()
+      {
+        return std::get< std::map< std::string, hdf5::CellAttributeView<T> > >(views);
+      }
+    };
+
+    /// @brief Reads the attributes of a population on rank root and
+    ///        copies them once to each shared-memory node of comm.
+    ///
+    /// Unlike bcast_cell_attributes, which gives every rank its own copy,
+    /// the index, pointer and value columns are held in a segment shared
+    /// by the ranks of a node, and every rank receives read-only views of
+    /// the node copy. The segment is freed by mpi::release_shared_segments
+    /// once the views have been destroyed on all ranks of the node.
+    void bcast_cell_attributes_shared
+    (
+     MPI_Comm               comm,
+     const int              root,
+     const std::string&           file_name,
+     const std::string&           name_space,
+     const std::set<std::string>& attr_mask,
+     const std::string&           pop_name,
+     const CELL_IDX_T&       pop_start,
+     SharedCellAttributes&   attr_values
+     );
+
+    
     void append_cell_attribute_maps (
                                      MPI_Comm                        comm,
                                      const std::string&              file_name,
@@ -173,9 +354,50 @@ namespace neuroh5
                                      const CellPtr                   ptr_type = CellPtr(PtrOwner),
                                      const size_t chunk_size = 4000,
                                      const size_t value_chunk_size = 4000,
-                                     const size_t cache_size = 1*1024*1024
+                                     const size_t cache_size = 1*1024*1024,
+                                     const hdf5::DatasetCreationPolicy& dataset_policy = hdf5::DatasetCreationPolicy()
                                      );
 
+    /// @brief Appends several attributes of a population with one fused
+    ///        write (see hdf5::append_cell_attributes), creating the
+    ///        datasets that do not exist yet in the order of attrs. The
+    ///        cell indices of attrs are cell ids. Collective on comm, the
+    ///        communicator of the file of loc.
+    void append_cell_attributes
+    (
+     MPI_Comm                                  comm,
+     const hid_t&                              loc,
+     const std::string&                        attr_namespace,
+     const std::string&                        pop_name,
+     const CELL_IDX_T&                         pop_start,
+     const std::vector<hdf5::CellAttributeAppend>& attrs,
+     const size_t chunk_size = 4000,
+     const size_t value_chunk_size = 4000,
+     const hdf5::DatasetCreationPolicy& dataset_policy = hdf5::DatasetCreationPolicy()
+     );
+
+    /// @brief Appends several attributes of a population given as flat
+    ///        arrays: for each element of attrs, the cell ids of this
+    ///        rank, an attribute pointer with one more element than the
+    ///        cell ids, and the values. The cells of every attribute are
+    ///        sent to the I/O ranks without building attribute maps, and
+    ///        appended with one fused write. Every rank of comm must pass
+    ///        the same attributes in the same order. Collective on comm.
+    void append_cell_attribute_arrays
+    (
+     MPI_Comm                                  comm,
+     const std::string&                        file_name,
+     const std::string&                        attr_namespace,
+     const std::string&                        pop_name,
+     const CELL_IDX_T&                         pop_start,
+     const std::vector<hdf5::CellAttributeAppend>& attrs,
+     const size_t io_size,
+     const size_t chunk_size = 4000,
+     const size_t value_chunk_size = 4000,
+     const size_t cache_size = 1*1024*1024,
+     const hdf5::DatasetCreationPolicy& dataset_policy = hdf5::DatasetCreationPolicy()
+     );
+
   
     template <typename T>
     void append_cell_attribute
@@ -193,7 +415,8 @@ namespace neuroh5
      const CellPtr                         ptr_type,
      const size_t chunk_size = 4000,
      const size_t value_chunk_size = 4000,
-     const size_t cache_size = 1*1024*1024
+     const size_t cache_size = 1*1024*1024,
+     const hdf5::DatasetCreationPolicy& dataset_policy = hdf5::DatasetCreationPolicy()
      )
     {
       int status;
@@ -239,7 +462,7 @@ namespace neuroh5
         {
           create_cell_attribute_datasets(file, attr_namespace, pop_name, attr_name,
                                          ftype, index_type, ptr_type,
-                                         chunk_size, value_chunk_size
+                                         chunk_size, value_chunk_size, dataset_policy
                                          );
         }
 
@@ -281,7 +504,8 @@ namespace neuroh5
      const CellPtr                         ptr_type,
      const size_t chunk_size = 4000,
      const size_t value_chunk_size = 4000,
-     const size_t cache_size = 1*1024*1024
+     const size_t cache_size = 1*1024*1024,
+     const hdf5::DatasetCreationPolicy& dataset_policy = hdf5::DatasetCreationPolicy()
      )
     {
       int status;
@@ -338,7 +562,7 @@ namespace neuroh5
             {
               create_cell_attribute_datasets(file, attr_namespace, pop_name, attr_name,
                                              ftype, index_type, ptr_type,
-                                             chunk_size, value_chunk_size
+                                             chunk_size, value_chunk_size, dataset_policy
                                              );
             }
           status = H5Fclose(file);
@@ -354,7 +578,7 @@ namespace neuroh5
       append_cell_attribute<T> (file, attr_namespace, pop_name, pop_start,
                                 attr_name, index, attr_ptr, values,
                                 data_type, index_type, ptr_type,
-                                chunk_size, value_chunk_size, cache_size);
+                                chunk_size, value_chunk_size, cache_size, dataset_policy);
          
       status = H5Fclose(file);
       throw_assert(status == 0, "append_cell_attribute: unable to close HDF5 file");
@@ -367,27 +591,21 @@ namespace neuroh5
     }
 
 
+    /// @brief Sends the values of an attribute map to the I/O ranks of
+    ///        io_rank_set, each of which receives the cells of a
+    ///        contiguous range of ranks as a cell index, an attribute
+    ///        pointer and a value vector. Collective on comm.
     template <typename T>
-    void append_cell_attribute_map
+    void exchange_cell_attribute_map
     (
      MPI_Comm                        comm,
-     const hid_t&                    loc,
-     const std::string&              attr_namespace,
-     const std::string&              pop_name,
-     const CELL_IDX_T&               pop_start,
-     const std::string&              attr_name,
      const std::map<CELL_IDX_T, deque<T>>& value_map,
-     const data::optional_hid        data_type,
      const set<size_t>&              io_rank_set,
-     const CellIndex                 index_type = IndexOwner,
-     const CellPtr                   ptr_type = CellPtr(PtrOwner),
-     const size_t chunk_size = 4000,
-     const size_t value_chunk_size = 4000,
-     const size_t cache_size = 1*1024*1024
+     vector<CELL_IDX_T>&             gid_recvbuf,
+     vector<ATTR_PTR_T>&             attr_ptr,
+     vector<T>&                      value_recvbuf
      )
     {
-
-      herr_t status;
       int ssize=0, srank=0; size_t size=0, rank=0; size_t io_size=io_rank_set.size();
       throw_assert(MPI_Comm_size(comm, &ssize) == MPI_SUCCESS, "error in MPI_Comm_size");
       throw_assert(MPI_Comm_rank(comm, &srank) == MPI_SUCCESS, "error in MPI_Comm_rank");
@@ -399,32 +617,6 @@ namespace neuroh5
 
       bool is_io_rank = (io_rank_set.find(rank) != io_rank_set.end());
 
-      hid_t fapl;
-      hid_t file;
-      MPI_Comm io_comm;
-      MPI_Info io_comm_info;
-      
-      if (is_io_rank)
-        {
-          int io_size_value=0;
-          
-          file = H5Iget_file_id(loc);
-          throw_assert(file >= 0,
-                       "append_cell_attribute_map: invalid file handle");
-
-          throw_assert((fapl = H5Fget_access_plist(file)) >= 0,
-                       "append_cell_attribute_map: error in H5Fget_access_plist");
-      
-          throw_assert(H5Pget_fapl_mpio(fapl, &io_comm, &io_comm_info) >= 0,
-                       "append_cell_attribute_map: error in H5Pget_fapl_mpio");
-          
-          throw_assert(MPI_Comm_size(io_comm, &io_size_value) == MPI_SUCCESS, "error in MPI_Comm_size");
-          throw_assert(io_size_value == io_size, "io_size mismatch");
-          
-          throw_assert(H5Pclose(fapl) == 0,
-                       "append_cell_attribute_map: error in H5Pclose");
-        }
-      
       vector< pair<hsize_t,hsize_t> > ranges;
       mpi::rank_ranges(size, io_size, ranges);
 
@@ -432,7 +624,7 @@ namespace neuroh5
       vector <size_t> io_dests(size); 
       for (size_t r=0; r<size; r++)
         {
-          for (size_t i=ranges.size()-1; i>=0; i--)
+          for (size_t i=ranges.size(); i-- > 0; )
             {
               if (ranges[i].first <= r)
                 {
@@ -442,15 +634,6 @@ namespace neuroh5
             }
         }
 
-      // Determine number of values for each rank
-      vector<uint32_t> recvbuf_num_values(size, 0);
-      {
-        vector<uint32_t> sendbuf_num_values(size, value_map.size());
-        throw_assert(MPI_Allgather(&sendbuf_num_values[0], 1, MPI_UINT32_T,
-                                   &recvbuf_num_values[0], 1, MPI_UINT32_T, comm)
-                     == MPI_SUCCESS, "append_cell_attribute_map: error in MPI_Allgather");
-      }
-
       // Determine local value size and offset
       uint32_t local_value_size=0;
       vector<ATTR_PTR_T> local_attr_size_vector;
@@ -464,32 +647,36 @@ namespace neuroh5
 	  local_attr_size_vector.push_back(v.size());
         }
       
-      vector<CELL_IDX_T> gid_recvbuf;
+      gid_recvbuf.clear();
       {
         vector<size_t> idx_sendcounts(size, 0), idx_sdispls(size, 0), idx_recvcounts(size, 0), idx_rdispls(size, 0);
         idx_sendcounts[io_dests[rank]] = local_index_vector.size();
         
+        mpi::PhaseTimer timer("alltoallv");
         throw_assert(mpi::alltoallv_vector<CELL_IDX_T>(comm, MPI_CELL_IDX_T,
                                                        idx_sendcounts, idx_sdispls, local_index_vector,
                                                        idx_recvcounts, idx_rdispls, gid_recvbuf) >= 0,
-                     "append_cell_attribute_map: error in MPI_Alltoallv");
+                     "exchange_cell_attribute_map: error in MPI_Alltoallv");
       }
 
-      vector<ATTR_PTR_T> attr_ptr;
+      attr_ptr.clear();
       {
         vector<ATTR_PTR_T> attr_size_recvbuf;
         vector<size_t> attr_size_sendcounts(size, 0), attr_size_sdispls(size, 0), attr_size_recvcounts(size, 0), attr_size_rdispls(size, 0);
         attr_size_sendcounts[io_dests[rank]] = local_attr_size_vector.size();
 
-        throw_assert(mpi::alltoallv_vector<ATTR_PTR_T>(comm, MPI_ATTR_PTR_T,
-                                                       attr_size_sendcounts, attr_size_sdispls, local_attr_size_vector,
-                                                       attr_size_recvcounts, attr_size_rdispls, attr_size_recvbuf) >= 0,
-                     "append_cell_attribute_map: error in MPI_Alltoallv");
+        {
+          mpi::PhaseTimer timer("alltoallv");
+          throw_assert(mpi::alltoallv_vector<ATTR_PTR_T>(comm, MPI_ATTR_PTR_T,
+                                                         attr_size_sendcounts, attr_size_sdispls, local_attr_size_vector,
+                                                         attr_size_recvcounts, attr_size_rdispls, attr_size_recvbuf) >= 0,
+                       "exchange_cell_attribute_map: error in MPI_Alltoallv");
+        }
         
         if ((is_io_rank) && (attr_size_recvbuf.size() > 0))
           {
             ATTR_PTR_T attr_ptr_offset = 0;
-            for (size_t s=0; s<ssize; s++)
+            for (size_t s=0; s<size; s++)
               {
                 int count = attr_size_recvcounts[s];
                 for (size_t i=attr_size_rdispls[s]; i<attr_size_rdispls[s]+count; i++)
@@ -504,16 +691,8 @@ namespace neuroh5
       }
 
       
-      vector<T> value_recvbuf;
+      value_recvbuf.clear();
       {
-        vector<uint32_t> recvbuf_size_values(size, 0);
-        vector<uint32_t> sendbuf_size_values(size, local_value_size);
-        throw_assert(MPI_Allgather(&sendbuf_size_values[0], 1, MPI_UINT32_T,
-                                   &recvbuf_size_values[0], 1, MPI_UINT32_T, comm)
-                     == MPI_SUCCESS, "append_cell_attribute_map: error in MPI_Allgather");
-        throw_assert(MPI_Barrier(comm) == MPI_SUCCESS,
-                       "append_cell_attribute_map: error in MPI_Barrier");
-        
         vector<T>  local_value_vector;
         for (auto const& element : value_map)
           {
@@ -528,22 +707,93 @@ namespace neuroh5
 
         T dummy;
         MPI_Datatype mpi_type = infer_mpi_datatype(dummy);
+        mpi::PhaseTimer timer("alltoallv");
         throw_assert(mpi::alltoallv_vector<T>(comm, mpi_type,
                                               value_sendcounts, value_sdispls, local_value_vector,
                                               value_recvcounts, value_rdispls, value_recvbuf) >= 0,
-                     "append_cell_attribute_map: error in MPI_Alltoallv");
+                     "exchange_cell_attribute_map: error in MPI_Alltoallv");
       }
       
+    }
+
+
+    template <typename T>
+    void append_cell_attribute_map
+    (
+     MPI_Comm                        comm,
+     const hid_t&                    loc,
+     const std::string&              attr_namespace,
+     const std::string&              pop_name,
+     const CELL_IDX_T&               pop_start,
+     const std::string&              attr_name,
+     const std::map<CELL_IDX_T, deque<T>>& value_map,
+     const data::optional_hid        data_type,
+     const set<size_t>&              io_rank_set,
+     const CellIndex                 index_type = IndexOwner,
+     const CellPtr                   ptr_type = CellPtr(PtrOwner),
+     const size_t chunk_size = 4000,
+     const size_t value_chunk_size = 4000,
+     const size_t cache_size = 1*1024*1024,
+     const hdf5::DatasetCreationPolicy& dataset_policy = hdf5::DatasetCreationPolicy()
+     )
+    {
+      mpi::PhaseTimer timer("append_cell_attribute_map");
+
+      herr_t status;
+      int ssize=0, srank=0; size_t size=0, rank=0; size_t io_size=io_rank_set.size();
+      throw_assert(MPI_Comm_size(comm, &ssize) == MPI_SUCCESS, "error in MPI_Comm_size");
+      throw_assert(MPI_Comm_rank(comm, &srank) == MPI_SUCCESS, "error in MPI_Comm_rank");
+      throw_assert(ssize > 0, "invalid MPI comm size");
+      throw_assert(srank >= 0, "invalid MPI rank");
+      rank = srank;
+      size = ssize;
+      throw_assert(io_size <= size, "invalid io_size");
+
+      bool is_io_rank = (io_rank_set.find(rank) != io_rank_set.end());
+
+      hid_t fapl;
+      hid_t file;
+      MPI_Comm io_comm;
+      MPI_Info io_comm_info;
+      
+      if (is_io_rank)
+        {
+          int io_size_value=0;
+          
+          file = H5Iget_file_id(loc);
+          throw_assert(file >= 0,
+                       "append_cell_attribute_map: invalid file handle");
+
+          throw_assert((fapl = H5Fget_access_plist(file)) >= 0,
+                       "append_cell_attribute_map: error in H5Fget_access_plist");
+      
+          throw_assert(H5Pget_fapl_mpio(fapl, &io_comm, &io_comm_info) >= 0,
+                       "append_cell_attribute_map: error in H5Pget_fapl_mpio");
+          
+          throw_assert(MPI_Comm_size(io_comm, &io_size_value) == MPI_SUCCESS, "error in MPI_Comm_size");
+          throw_assert(io_size_value == io_size, "io_size mismatch");
+          
+          throw_assert(H5Pclose(fapl) == 0,
+                       "append_cell_attribute_map: error in H5Pclose");
+        }
+      
+      vector<CELL_IDX_T> gid_recvbuf;
+      vector<ATTR_PTR_T> attr_ptr;
+      vector<T> value_recvbuf;
+      exchange_cell_attribute_map<T>(comm, value_map, io_rank_set,
+                                     gid_recvbuf, attr_ptr, value_recvbuf);
+
       throw_assert(MPI_Barrier(comm) == MPI_SUCCESS,
                    "append_cell_attribute_map: error in MPI_Barrier");
     
       if (is_io_rank)
         {
+          mpi::PhaseTimer timer("append_cell_attribute");
           append_cell_attribute<T>(file,
                                    attr_namespace, pop_name, pop_start, attr_name,
                                    gid_recvbuf, attr_ptr, value_recvbuf,
                                    data_type, index_type, ptr_type, 
-                                   chunk_size, value_chunk_size, cache_size);
+                                   chunk_size, value_chunk_size, cache_size, dataset_policy);
         }
 
       if (is_io_rank)
@@ -584,7 +834,8 @@ namespace neuroh5
      const CellPtr                   ptr_type = CellPtr(PtrOwner),
      const size_t chunk_size = 4000,
      const size_t value_chunk_size = 4000,
-     const size_t cache_size = 1*1024*1024
+     const size_t cache_size = 1*1024*1024,
+     const hdf5::DatasetCreationPolicy& dataset_policy = hdf5::DatasetCreationPolicy()
      )
     {
       herr_t status;
@@ -657,7 +908,7 @@ namespace neuroh5
             {
               create_cell_attribute_datasets(file, attr_namespace, pop_name, attr_name,
                                              ftype, index_type, ptr_type,
-                                             chunk_size, value_chunk_size
+                                             chunk_size, value_chunk_size, dataset_policy
                                              );
             }
           status = H5Fclose(file);
@@ -672,7 +923,7 @@ namespace neuroh5
 
       append_cell_attribute_map<T>(comm, file, attr_namespace, pop_name, pop_start, attr_name, value_map,
                                    io_size, data_type, IndexOwner, CellPtr(PtrOwner),
-                                   chunk_size, value_chunk_size, cache_size);
+                                   chunk_size, value_chunk_size, cache_size, dataset_policy);
 
       throw_assert(MPI_Barrier(comm) == MPI_SUCCESS, "error in MPI_Barrier");
       throw_assert(MPI_Comm_free(&io_comm) == MPI_SUCCESS,
@@ -694,12 +945,13 @@ namespace neuroh5
      const data::optional_hid        data_type,
      const size_t chunk_size = 4000,
      const size_t value_chunk_size = 4000,
-     const size_t cache_size = 1*1024*1024
+     const size_t cache_size = 1*1024*1024,
+     const hdf5::DatasetCreationPolicy& dataset_policy = hdf5::DatasetCreationPolicy()
      )
     {
       append_cell_attribute_map<T>(comm, file_name, attr_namespace, pop_name, pop_start, attr_name, value_map,
                                    io_size, data_type, IndexOwner, CellPtr(PtrOwner),
-                                   chunk_size, value_chunk_size, cache_size);
+                                   chunk_size, value_chunk_size, cache_size, dataset_policy);
     }
 
     template <typename T>
@@ -719,7 +971,8 @@ namespace neuroh5
      const CellPtr                   ptr_type,
      const size_t chunk_size = 4000,
      const size_t value_chunk_size = 4000,
-     const size_t cache_size = 1*1024*1024
+     const size_t cache_size = 1*1024*1024,
+     const hdf5::DatasetCreationPolicy& dataset_policy = hdf5::DatasetCreationPolicy()
      )
     {
       int status;
@@ -785,7 +1038,7 @@ namespace neuroh5
             {
               create_cell_attribute_datasets(file, attr_namespace, pop_name, attr_name,
                                              ftype, index_type, ptr_type,
-                                             chunk_size, value_chunk_size
+                                             chunk_size, value_chunk_size, dataset_policy
                                              );
             }
           status = H5Fclose(file);
@@ -832,7 +1085,8 @@ namespace neuroh5
      const CellPtr                   ptr_type = CellPtr(PtrOwner),
      const size_t chunk_size = 4000,
      const size_t value_chunk_size = 4000,
-     const size_t cache_size = 1*1024*1024
+     const size_t cache_size = 1*1024*1024,
+     const hdf5::DatasetCreationPolicy& dataset_policy = hdf5::DatasetCreationPolicy()
      )
     {
       vector<CELL_IDX_T>  index_vector;
@@ -994,7 +1248,7 @@ namespace neuroh5
                                   attr_namespace, pop_name, pop_start, attr_name,
                                   gid_recvbuf, attr_ptr, value_recvbuf,
                                   data_type, index_type, ptr_type, 
-                                  chunk_size, value_chunk_size, cache_size);
+                                  chunk_size, value_chunk_size, cache_size, dataset_policy);
         }
       
       throw_assert(MPI_Barrier(io_comm) == MPI_SUCCESS,
@@ -1020,12 +1274,13 @@ namespace neuroh5
      const data::optional_hid        data_type,
      const size_t chunk_size = 4000,
      const size_t value_chunk_size = 4000,
-     const size_t cache_size = 1*1024*1024
+     const size_t cache_size = 1*1024*1024,
+     const hdf5::DatasetCreationPolicy& dataset_policy = hdf5::DatasetCreationPolicy()
      )
     {
       write_cell_attribute_map<T>(comm, file_name, attr_namespace, pop_name, pop_start, attr_name,
                                   value_map, io_size, data_type, IndexOwner, CellPtr(PtrOwner),
-                                  chunk_size, value_chunk_size, cache_size);
+                                  chunk_size, value_chunk_size, cache_size, dataset_policy);
     }
   }
   
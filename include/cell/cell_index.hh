@@ -12,6 +12,7 @@
 #include <mpi.h>
 #include <vector>
 #include "neuroh5_types.hh"
+#include "dataset_creation.hh"
 
 namespace neuroh5
 {
@@ -23,7 +24,8 @@ namespace neuroh5
      const string&        file_name,
      const string&        pop_name,
      const string&        attr_name_space,
-     const size_t         chunk_size = 1000
+     const size_t         chunk_size = 1000,
+     const hdf5::DatasetCreationPolicy& dataset_policy = hdf5::DatasetCreationPolicy()
      );
 
     herr_t create_cell_index
@@ -32,7 +34,8 @@ namespace neuroh5
      hid_t                loc,
      const string&        pop_name,
      const string&        attr_name_space,
-     const size_t         chunk_size = 1000
+     const size_t         chunk_size = 1000,
+     const hdf5::DatasetCreationPolicy& dataset_policy = hdf5::DatasetCreationPolicy()
      );
     
     herr_t read_cell_index
@@ -51,7 +54,9 @@ namespace neuroh5
      const string&        pop_name,
      const CELL_IDX_T&    pop_start,
      const string&        attr_name_space,
-     const vector<CELL_IDX_T>&  cell_index
+     const vector<CELL_IDX_T>&  cell_index,
+     const size_t         chunk_size = 1000,
+     const hdf5::DatasetCreationPolicy& dataset_policy = hdf5::DatasetCreationPolicy()
      );
     
     herr_t append_cell_index
@@ -61,7 +66,9 @@ namespace neuroh5
      const string&        pop_name,
      const CELL_IDX_T&    pop_start,
      const string&        attr_name_space,
-     const vector<CELL_IDX_T>&  cell_index
+     const vector<CELL_IDX_T>&  cell_index,
+     const size_t         chunk_size = 1000,
+     const hdf5::DatasetCreationPolicy& dataset_policy = hdf5::DatasetCreationPolicy()
      );
 
     herr_t link_cell_index
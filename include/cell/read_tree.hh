@@ -7,6 +7,8 @@
 #include <vector>
 #include <forward_list>
 
+#include "packed_trees.hh"
+
 namespace neuroh5
 {
 
@@ -28,6 +30,18 @@ namespace neuroh5
      bool collective = true
      );
 
+    /// Same as above, with the trees stored in contiguous buffers.
+    int read_trees
+    (
+     MPI_Comm comm,
+     const std::string& file_name,
+     const std::string& pop_name,
+     const CELL_IDX_T& pop_start,
+     data::PackedTrees &trees,
+     size_t offset = 0,
+     size_t numitems = 0
+     );
+
     int read_tree_selection
     (
      MPI_Comm comm,
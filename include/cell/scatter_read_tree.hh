@@ -6,9 +6,12 @@
 
 #include <vector>
 #include <map>
+#include <memory>
 
 #include "neuroh5_types.hh"
 #include "attr_map.hh"
+#include "packed_trees.hh"
+#include "cell_attributes.hh"
 
 namespace neuroh5
 {
@@ -36,6 +39,52 @@ namespace neuroh5
      size_t numitems = 0
      );
 
+    /// Same as above, with the trees stored in contiguous buffers. The
+    /// tree attributes are exchanged in the columnar cell attribute format.
+    int scatter_read_trees
+    ( 
+     MPI_Comm                              all_comm,
+     const std::string&                    file_name,
+     const int                             io_size,
+     const std::vector<std::string>       &attr_name_spaces,
+     // A vector that maps nodes to compute ranks
+     const node_rank_map_t                &node_rank_map,
+     const string                         &pop_name,
+     const CELL_IDX_T                      pop_start,
+     data::PackedTrees                    &trees,
+     std::map<string, data::NamedAttrMap> &attr_maps,
+     size_t offset = 0,
+     size_t numitems = 0
+     );
+
+    /// @brief Reads successive blocks of trees, and of the cell
+    ///        attributes in the given namespaces, as scatter_read_trees
+    ///        does, with the metadata loaded once at construction (see
+    ///        CellAttributeBlockReader). The attributes of all namespaces
+    ///        are read in one collective pass per block.
+    class TreeBlockReader
+    {
+    public:
+      TreeBlockReader
+      (
+       MPI_Comm                        comm,
+       const std::string&              file_name,
+       const int                       io_size,
+       const std::vector<std::string> &attr_name_spaces,
+       const node_rank_map_t          &node_rank_map,
+       const string                   &pop_name,
+       const CELL_IDX_T                pop_start
+       );
+
+      int read (size_t offset, size_t numitems,
+                data::PackedTrees                    &trees,
+                std::map<string, data::NamedAttrMap> &attr_maps);
+
+    private:
+      CellAttributeBlockReader tree_reader;
+      std::unique_ptr<CellAttributeBlockReader> attr_reader;
+    };
+
     int scatter_read_tree_selection
     (
      MPI_Comm                        all_comm,
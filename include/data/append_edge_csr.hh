@@ -0,0 +1,58 @@
+// -*- mode: c++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+//==============================================================================
+///  @file append_edge_csr.hh
+///
+///  Populates flat CSR edge containers from DBS arrays.
+///
+///  Copyright (C) 2016-2025 Project NeuroH5.
+//==============================================================================
+
+#ifndef APPEND_EDGE_CSR_HH
+#define APPEND_EDGE_CSR_HH
+
+#include <vector>
+#include <map>
+
+#include "neuroh5_types.hh"
+#include "edge_csr.hh"
+
+namespace neuroh5
+{
+
+  namespace data
+  {
+    int append_edge_csr
+    (
+     const NODE_IDX_T&                       dst_start,
+     const NODE_IDX_T&                       src_start,
+     const std::vector<DST_BLK_PTR_T>&       dst_blk_ptr,
+     const std::vector<NODE_IDX_T>&          dst_idx,
+     const std::vector<DST_PTR_T>&           dst_ptr,
+     const std::vector<NODE_IDX_T>&          src_idx,
+     const std::vector<std::string>&         attr_namespaces,
+     const std::map<std::string, data::NamedAttrVal>&  edge_attr_map,
+     size_t&                                 num_edges,
+     EdgeCSR &                               edge_csr,
+     EdgeMapType                             edge_map_type
+     );
+
+    int append_rank_edge_csr
+    (
+     const size_t                                initial_rank,
+     const size_t                                num_ranks,
+     const NODE_IDX_T&                           dst_start,
+     const NODE_IDX_T&                           src_start,
+     const std::vector<DST_BLK_PTR_T>&           dst_blk_ptr,
+     const std::vector<NODE_IDX_T>&              dst_idx,
+     const std::vector<DST_PTR_T>&               dst_ptr,
+     const std::vector<NODE_IDX_T>&              src_idx,
+     const std::vector<std::string>&             attr_namespaces,
+     const std::map<std::string, data::NamedAttrVal>& edge_attr_map,
+     const node_rank_map_t&                      node_rank_map,
+     size_t&                                     num_edges,
+     rank_edge_csr_t &                           rank_edge_csr,
+     EdgeMapType                                 edge_map_type
+     );
+  }
+}
+#endif
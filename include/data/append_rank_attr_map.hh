@@ -17,6 +17,7 @@
 
 #include "neuroh5_types.hh"
 #include "attr_map.hh"
+#include "columnar_attr_map.hh"
 #include "attr_val.hh"
 
 namespace neuroh5
@@ -30,6 +31,14 @@ namespace neuroh5
      const data::NamedAttrMap   &attr_values,
      const node_rank_map_t &node_rank_map,
      map <rank_t, data::AttrMap> &rank_attr_map);
+
+    /// Partitions columnar attribute values among ranks according to
+    /// node_rank_map; rows keep their cell index order.
+    void append_rank_attr_map
+    (
+     const data::ColumnarAttrMap   &attr_values,
+     const node_rank_map_t &node_rank_map,
+     map <rank_t, data::ColumnarAttrMap> &rank_attr_map);
     
   }
   
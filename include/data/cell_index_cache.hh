@@ -0,0 +1,96 @@
+// -*- mode: c++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+//==============================================================================
+///  @file cell_index_cache.hh
+///
+///  Sorted cell attribute indices for selection reads, and a cache of the
+///  indices of each attribute namespace.
+///
+///  Copyright (C) 2016-2025 Project NeuroH5.
+//==============================================================================
+
+#ifndef CELL_INDEX_CACHE_HH
+#define CELL_INDEX_CACHE_HH
+
+#include <hdf5.h>
+
+#include <map>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "neuroh5_types.hh"
+
+namespace neuroh5
+{
+  namespace data
+  {
+
+    /// @brief Cell index and attribute pointer of a cell attribute,
+    ///        ordered by cell id for selection lookups.
+    ///
+    /// The pointer is kept in file order; if the index is not sorted, the
+    /// file position of each sorted cell id is stored as well.
+    class SortedCellIndex
+    {
+    public:
+      SortedCellIndex () {}
+      SortedCellIndex (const std::vector<CELL_IDX_T>& index,
+                       const std::vector<ATTR_PTR_T>& ptr);
+
+      /// Number of entries of the cell index
+      size_t size () const { return gids_.size(); }
+      bool empty () const { return gids_.empty(); }
+
+      /// @brief Appends the cell ids and value ranges (start, count) of
+      ///        the selected cells that are in the index. Cells with
+      ///        several index entries yield one range per entry. Ranges
+      ///        are returned in order of their start, so that they can be
+      ///        read by a single hyperslab union.
+      void select (const CELL_IDX_T pop_start,
+                   const std::vector<CELL_IDX_T>& selection,
+                   std::vector<CELL_IDX_T>& selection_index,
+                   std::vector< std::pair<hsize_t,hsize_t> >& ranges) const;
+
+    private:
+      std::vector<CELL_IDX_T> gids_;
+      std::vector<CELL_IDX_T> order_;
+      std::vector<ATTR_PTR_T> ptr_;
+    };
+
+    /// The attributes of a namespace and their sorted indices. Attributes
+    /// with a shared Cell Index share one SortedCellIndex.
+    struct CellAttributeIndex
+    {
+      std::vector< std::pair<std::string, AttrKind> > attributes;
+      std::vector< std::shared_ptr<const SortedCellIndex> > indices;
+    };
+
+    /// @brief Attribute indices of namespaces, by namespace, population and
+    ///        population start.
+    class CellIndexCache
+    {
+    public:
+      std::shared_ptr<const CellAttributeIndex> find (const std::string& name_space,
+                                                      const std::string& pop_name,
+                                                      const CELL_IDX_T pop_start) const;
+
+      void insert (const std::string& name_space,
+                   const std::string& pop_name,
+                   const CELL_IDX_T pop_start,
+                   std::shared_ptr<const CellAttributeIndex> attr_index);
+
+      void clear () { entries_.clear(); }
+
+    private:
+      static std::string key (const std::string& name_space,
+                              const std::string& pop_name,
+                              const CELL_IDX_T pop_start);
+
+      std::map<std::string, std::shared_ptr<const CellAttributeIndex> > entries_;
+    };
+
+  }
+}
+
+#endif
@@ -28,6 +28,32 @@ namespace neuroh5
     }
     const size_t CHUNK_SIZE = get_chunk_size();
 
+    // Number of destination blocks that each I/O rank reads per batch in
+    // scatter_read_projection when no batch size is given by the caller.
+    // Override via NEUROH5_SCATTER_BATCH_SIZE env var; 0 (the default)
+    // reads the whole projection in one pass. Reads of a range of blocks
+    // (offset/numitems) are never batched.
+    inline size_t get_scatter_batch_size() {
+      const char* env = std::getenv("NEUROH5_SCATTER_BATCH_SIZE");
+      if (env != nullptr) {
+        return std::strtoull(env, nullptr, 10);
+      }
+      return 0;
+    }
+
+    // Whether the scatter reads of projections, trees and cell
+    // attributes exchange their data with mpi::node_alltoallv_vector,
+    // aggregated by shared-memory node, instead of the sparse exchange.
+    // Enabled by setting NEUROH5_NODE_EXCHANGE to a nonzero value, which
+    // must be the same on all ranks.
+    inline bool get_node_exchange() {
+      const char* env = std::getenv("NEUROH5_NODE_EXCHANGE");
+      if (env != nullptr) {
+        return std::strtoull(env, nullptr, 10) > 0;
+      }
+      return false;
+    }
+
     template<typename T>
     struct ChunkInfo {
         std::vector<int> sendcounts;
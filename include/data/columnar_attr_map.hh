@@ -0,0 +1,293 @@
+// -*- mode: c++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+//==============================================================================
+///  @file columnar_attr_map.hh
+///
+///  Columnar storage of cell attributes, with one contiguous value buffer
+///  per attribute.
+///
+///  Copyright (C) 2016-2025 Project NeuroH5.
+//==============================================================================
+
+#ifndef COLUMNAR_ATTR_MAP_HH
+#define COLUMNAR_ATTR_MAP_HH
+
+#include <algorithm>
+#include <map>
+#include <string>
+#include <typeindex>
+#include <vector>
+
+#include "throw_assert.hh"
+#include "neuroh5_types.hh"
+#include "attr_map.hh"
+
+namespace neuroh5
+{
+  namespace data
+  {
+
+    /// @brief Values of one attribute for a set of cells.
+    ///
+    /// The values of cell index[i] are values[ptr[i]] .. values[ptr[i+1]-1].
+    /// Cells are sorted by index, so that the values of a cell are found
+    /// by binary search.
+    template<class T>
+    struct AttrColumn
+    {
+      // cell index of each row, sorted in ascending order
+      std::vector<CELL_IDX_T> index;
+      // start of each row in values; size is index.size()+1
+      std::vector<ATTR_PTR_T> ptr;
+      std::vector<T>          values;
+
+      AttrColumn() : ptr(1, 0) {};
+
+      size_t size () const { return index.size(); }
+      size_t row_size (size_t i) const { return ptr[i+1] - ptr[i]; }
+      const T* row_data (size_t i) const { return values.data() + ptr[i]; }
+
+      /// Returns the row of the given cell, or size() if the cell has no
+      /// values for this attribute.
+      size_t find (const CELL_IDX_T key) const
+      {
+        auto it = std::lower_bound(index.cbegin(), index.cend(), key);
+        if ((it != index.cend()) && (*it == key))
+          {
+            return std::distance(index.cbegin(), it);
+          }
+        return index.size();
+      }
+
+      /// Appends the values of a cell; if the cell is the same as that of
+      /// the last row, the values are appended to that row. Rows may be
+      /// appended in any order and put in order by sort_rows.
+      void append_row (const CELL_IDX_T key, const T* first, const size_t n)
+      {
+        if (index.empty() || (index.back() != key))
+          {
+            index.push_back(key);
+            ptr.push_back(values.size());
+          }
+        values.insert(values.end(), first, first+n);
+        ptr.back() = values.size();
+      }
+
+      /// Sorts rows by cell index; the values of rows with equal cell
+      /// index are concatenated in the order in which they were appended.
+      void sort_rows ()
+      {
+        if (std::is_sorted(index.cbegin(), index.cend()) &&
+            (std::adjacent_find(index.cbegin(), index.cend()) == index.cend()))
+          return;
+
+        std::vector<size_t> perm(index.size());
+        for (size_t i = 0; i < perm.size(); i++)
+          {
+            perm[i] = i;
+          }
+        std::stable_sort(perm.begin(), perm.end(),
+                         [&] (size_t i, size_t j) { return index[i] < index[j]; });
+
+        AttrColumn<T> unsorted(std::move(*this));
+        clear();
+        values.reserve(unsorted.values.size());
+        for (const size_t i : perm)
+          {
+            append_row(unsorted.index[i], unsorted.row_data(i), unsorted.row_size(i));
+          }
+      }
+
+      /// Adds the rows of another column to this one.
+      void merge (AttrColumn<T>&& other)
+      {
+        if (other.size() == 0)
+          return;
+        if (size() == 0)
+          {
+            *this = std::move(other);
+            return;
+          }
+        const bool ordered = index.back() < other.index.front();
+        values.reserve(values.size() + other.values.size());
+        for (size_t i = 0; i < other.size(); i++)
+          {
+            append_row(other.index[i], other.row_data(i), other.row_size(i));
+          }
+        if (!ordered)
+          {
+            sort_rows();
+          }
+      }
+
+      void clear ()
+      {
+        index.clear();
+        ptr.assign(1, 0);
+        values.clear();
+      }
+    };
+
+
+    /// @brief Named cell attributes stored in AttrColumn containers.
+    ///
+    /// Provides the same attribute type indices and name management as
+    /// NamedAttrMap. The values read from HDF5 are moved into the columns
+    /// without copying, and consumers may refer to the values of a cell
+    /// through row_data/row_size.
+    struct ColumnarAttrMap
+    {
+      // sorted cell indices of all attributes
+      std::vector<CELL_IDX_T> index;
+
+      std::vector <AttrColumn <float> >    float_columns;
+      std::vector <AttrColumn <uint8_t> >  uint8_columns;
+      std::vector <AttrColumn <int8_t> >   int8_columns;
+      std::vector <AttrColumn <uint16_t> > uint16_columns;
+      std::vector <AttrColumn <int16_t> >  int16_columns;
+      std::vector <AttrColumn <uint32_t> > uint32_columns;
+      std::vector <AttrColumn <int32_t> >  int32_columns;
+
+      std::map<std::type_index, std::map <std::string, size_t> > attr_name_map;
+
+      template<class T>
+      const std::vector< AttrColumn<T> >& columns () const;
+      template<class T>
+      std::vector< AttrColumn<T> >& columns ();
+
+      template<class T>
+      size_t num_attr () const
+      {
+        return columns<T>().size();
+      }
+
+      void num_attrs (std::vector<size_t> &v) const;
+
+      template<class T>
+      void attr_names_type (std::vector<std::string> &output) const
+      {
+        auto type_it = attr_name_map.find(std::type_index(typeid(T)));
+        if (type_it != attr_name_map.cend())
+          {
+            const std::map< std::string, size_t> &attr_names = type_it->second;
+            output.resize(attr_names.size());
+            for (auto element : attr_names)
+              {
+                output[element.second] = element.first;
+              }
+          }
+      }
+
+      void attr_names (std::vector<std::vector<std::string> > &) const;
+
+      template<class T>
+      size_t insert_name (const std::string& name)
+      {
+        std::map <std::string, size_t>& name_map = attr_name_map[std::type_index(typeid(T))];
+        std::vector< AttrColumn<T> >& attr_columns = columns<T>();
+        size_t attr_index = 0;
+        auto it = name_map.find(name);
+        if (it == name_map.end())
+          {
+            attr_index = name_map.size();
+            name_map.insert(make_pair(name, attr_index));
+            attr_columns.resize(std::max(attr_columns.size(), attr_index+1));
+          }
+        else
+          {
+            attr_index = it->second;
+          }
+        return attr_index;
+      }
+
+      /// Returns the index of the given attribute among the attributes of
+      /// type T.
+      template<class T>
+      size_t attr_index (const std::string& name) const
+      {
+        auto type_it = attr_name_map.find(std::type_index(typeid(T)));
+        throw_assert(type_it != attr_name_map.cend(),
+                     "ColumnarAttrMap::attr_index: attribute " << name << " not found");
+        auto attr_it = type_it->second.find(name);
+        throw_assert(attr_it != type_it->second.cend(),
+                     "ColumnarAttrMap::attr_index: attribute " << name << " not found");
+        return attr_it->second;
+      }
+
+      /// Adds the rows of a column to attribute attr_index of type T.
+      template<class T>
+      void insert (const size_t attr_index, AttrColumn<T>&& column)
+      {
+        std::vector< AttrColumn<T> >& attr_columns = columns<T>();
+        attr_columns.resize(std::max(attr_columns.size(), attr_index+1));
+        column.sort_rows();
+        merge_index(column.index);
+        attr_columns[attr_index].merge(std::move(column));
+      }
+
+      /// Inserts values read in (index, pointer, value) form; the vectors
+      /// are moved into the column when possible. As in AttrMap::insert,
+      /// a pointer vector with fewer than two elements assigns all values
+      /// to each cell.
+      template<class T>
+      size_t insert (const std::string& name,
+                     std::vector<CELL_IDX_T>&& cell_index,
+                     std::vector<ATTR_PTR_T>&& ptr,
+                     std::vector<T>&& value)
+      {
+        size_t attr_index = insert_name<T>(name);
+        AttrColumn<T> column;
+        if (ptr.size() > 1)
+          {
+            throw_assert(ptr.size() == cell_index.size()+1,
+                         "ColumnarAttrMap::insert: mismatch between index and pointer sizes");
+            throw_assert(ptr.back() <= value.size(),
+                         "ColumnarAttrMap::insert: pointer out of range");
+            ATTR_PTR_T ptr_base = ptr.front();
+            if (ptr_base > 0)
+              {
+                for (ATTR_PTR_T& p : ptr)
+                  {
+                    p -= ptr_base;
+                  }
+                value.erase(value.begin(), value.begin()+ptr_base);
+              }
+            value.resize(ptr.back());
+            column.index  = std::move(cell_index);
+            column.ptr    = std::move(ptr);
+            column.values = std::move(value);
+          }
+        else
+          {
+            for (const CELL_IDX_T& key : cell_index)
+              {
+                column.append_row(key, value.data(), value.size());
+              }
+          }
+        insert(attr_index, std::move(column));
+        return attr_index;
+      }
+
+      template<class T>
+      size_t insert (const std::string& name,
+                     const std::vector<CELL_IDX_T>& cell_index,
+                     const std::vector<ATTR_PTR_T>& ptr,
+                     const std::vector<T>& value)
+      {
+        return insert(name, std::vector<CELL_IDX_T>(cell_index),
+                      std::vector<ATTR_PTR_T>(ptr), std::vector<T>(value));
+      }
+
+      /// Adds cell indices to the sorted index of all attributes.
+      void merge_index (const std::vector<CELL_IDX_T>& cell_index);
+
+      void clear ();
+
+      /// Adapters for consumers of the map based NamedAttrMap.
+      void to_attr_map (NamedAttrMap& attr_map) const;
+      void from_attr_map (const NamedAttrMap& attr_map);
+    };
+
+  }
+}
+
+#endif
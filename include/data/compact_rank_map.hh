@@ -0,0 +1,461 @@
+// -*- mode: c++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+//==============================================================================
+///  @file compact_rank_map.hh
+///
+///  Compact mapping of node indices to MPI ranks.
+///
+///  Copyright (C) 2016-2025 Project NeuroH5.
+//==============================================================================
+
+#ifndef COMPACT_RANK_MAP_HH
+#define COMPACT_RANK_MAP_HH
+
+#include <algorithm>
+#include <cstdint>
+#include <iterator>
+#include <limits>
+#include <map>
+#include <set>
+#include <utility>
+#include <vector>
+
+#include "throw_assert.hh"
+
+#include "cereal/types/vector.hpp"
+#include "cereal/types/map.hpp"
+#include "cereal/types/utility.hpp"
+
+namespace neuroh5
+{
+  namespace data
+  {
+
+    /// The ranks to which one node is assigned. Almost every node has a
+    /// single rank, which is held in place; nodes with several ranks
+    /// refer to the side table of the map.
+    template <class Rank>
+    class RankRange
+    {
+    public:
+      RankRange () : first_(nullptr), last_(nullptr), single_(0), multi_(false) {}
+      explicit RankRange (const Rank rank) : first_(nullptr), last_(nullptr), single_(rank), multi_(false) {}
+      RankRange (const Rank* first, const Rank* last) : first_(first), last_(last), single_(0), multi_(true) {}
+
+      const Rank* begin () const { return multi_ ? first_ : &single_; }
+      const Rank* end () const { return multi_ ? last_ : (&single_ + 1); }
+      size_t size () const { return end() - begin(); }
+      bool empty () const { return size() == 0; }
+      size_t count (const Rank rank) const { return std::binary_search(begin(), end(), rank) ? 1 : 0; }
+
+      operator std::set<Rank> () const { return std::set<Rank>(begin(), end()); }
+
+    private:
+      const Rank* first_;
+      const Rank* last_;
+      Rank single_;
+      bool multi_;
+    };
+
+    /// @brief Mapping of node indices to sets of ranks.
+    ///
+    /// Round-robin and contiguous assignments of a range of nodes are
+    /// represented in closed form. Other assignments are stored in pages
+    /// of page_size consecutive nodes, with a side table for the few nodes
+    /// assigned to more than one rank. A page holds a sorted list of
+    /// (node, rank) pairs until more than dense_threshold of its nodes are
+    /// assigned, and a rank per node after that, so that sparse
+    /// selections cost a few bytes per node. The interface follows that
+    /// of std::map<Key, std::set<Rank>>, with node_rank_map[key].insert(rank)
+    /// to assign a node and find(key)->second to iterate over its ranks.
+    template <class Key, class Rank>
+    class CompactRankMap
+    {
+    public:
+      typedef RankRange<Rank> ranks_type;
+      typedef std::pair<Key, ranks_type> value_type;
+
+      enum Layout
+        {
+          LayoutExplicit = 0,
+          LayoutRoundRobin = 1,
+          LayoutContiguous = 2
+        };
+
+      static constexpr size_t page_bits = 10;
+      static constexpr size_t page_size = size_t(1) << page_bits;
+      static constexpr size_t dense_threshold = page_size / 8;
+
+      class const_iterator
+      {
+      public:
+        typedef std::forward_iterator_tag iterator_category;
+        typedef typename CompactRankMap::value_type value_type;
+        typedef std::ptrdiff_t difference_type;
+        typedef const value_type* pointer;
+        typedef const value_type& reference;
+
+        const_iterator () : map_(nullptr), pos_(end_pos) {}
+        const_iterator (const CompactRankMap* m, const uint64_t pos)
+          : map_(m), pos_(pos)
+        {
+          update();
+        }
+        const_iterator (const CompactRankMap* m, const uint64_t pos, const ranks_type& ranks)
+          : map_(m), pos_(pos), value_(pos, ranks)
+        {}
+
+        reference operator* () const { return value_; }
+        pointer operator-> () const { return &value_; }
+
+        const_iterator& operator++ ()
+        {
+          pos_ = map_->next_key(pos_ + 1);
+          update();
+          return *this;
+        }
+
+        const_iterator operator++ (int)
+        {
+          const_iterator result = *this;
+          ++(*this);
+          return result;
+        }
+
+        bool operator== (const const_iterator& other) const { return pos_ == other.pos_; }
+        bool operator!= (const const_iterator& other) const { return pos_ != other.pos_; }
+
+      private:
+        void update ()
+        {
+          if (pos_ != end_pos)
+            {
+              value_.first = pos_;
+              map_->lookup(pos_, value_.second);
+            }
+        }
+
+        const CompactRankMap* map_;
+        uint64_t pos_;
+        value_type value_;
+      };
+
+      typedef const_iterator iterator;
+
+      /// Proxy returned by operator[], so that nodes can be assigned with
+      /// node_rank_map[key].insert(rank).
+      class reference
+      {
+      public:
+        reference (CompactRankMap& m, const Key key) : map_(m), key_(key) {}
+        void insert (const Rank rank) { map_.insert(key_, rank); }
+      private:
+        CompactRankMap& map_;
+        const Key key_;
+      };
+
+      CompactRankMap () : layout_(LayoutExplicit), start_(0), count_(0), num_ranks_(0), size_(0) {}
+
+      /// Assigns nodes start .. start+count-1 to ranks 0 .. num_ranks-1 in turn.
+      void assign_round_robin (const Key start, const size_t count, const size_t num_ranks)
+      {
+        assign_closed_form(LayoutRoundRobin, start, count, num_ranks);
+      }
+
+      /// Assigns nodes start .. start+count-1 to ranks 0 .. num_ranks-1 in
+      /// contiguous blocks of (nearly) equal size.
+      void assign_contiguous (const Key start, const size_t count, const size_t num_ranks)
+      {
+        assign_closed_form(LayoutContiguous, start, count, num_ranks);
+      }
+
+      void insert (const Key key, const Rank rank)
+      {
+        throw_assert(rank < multi_rank,
+                     "CompactRankMap::insert: invalid rank " << rank);
+        if (layout_ != LayoutExplicit)
+          {
+            materialize();
+          }
+
+        Rank& slot = page_slot(key);
+        if (slot == no_rank)
+          {
+            slot = rank;
+            size_++;
+          }
+        else if (slot == multi_rank)
+          {
+            std::vector<Rank>& ranks = multi_ranks_[key];
+            auto it = std::lower_bound(ranks.begin(), ranks.end(), rank);
+            if ((it == ranks.end()) || (*it != rank))
+              {
+                ranks.insert(it, rank);
+              }
+          }
+        else if (slot != rank)
+          {
+            std::vector<Rank>& ranks = multi_ranks_[key];
+            ranks.push_back(std::min(slot, rank));
+            ranks.push_back(std::max(slot, rank));
+            slot = multi_rank;
+          }
+      }
+
+      reference operator[] (const Key key) { return reference(*this, key); }
+
+      const_iterator find (const Key key) const
+      {
+        ranks_type ranks;
+        if (lookup(key, ranks))
+          {
+            return const_iterator(this, key, ranks);
+          }
+        return end();
+      }
+
+      size_t count (const Key key) const
+      {
+        ranks_type ranks;
+        return lookup(key, ranks) ? 1 : 0;
+      }
+
+      const_iterator begin () const { return const_iterator(this, next_key(0)); }
+      const_iterator end () const { return const_iterator(); }
+
+      size_t size () const { return (layout_ == LayoutExplicit) ? size_ : count_; }
+      bool empty () const { return size() == 0; }
+      Layout layout () const { return (Layout)layout_; }
+
+      void clear ()
+      {
+        layout_ = LayoutExplicit;
+        start_ = 0; count_ = 0; num_ranks_ = 0; size_ = 0;
+        page_keys_.clear();
+        pages_.clear();
+        multi_ranks_.clear();
+      }
+
+      /// Sets ranks to the ranks of the given node and returns true, or
+      /// returns false if the node is not assigned.
+      bool lookup (const Key key, ranks_type& ranks) const
+      {
+        switch (layout_)
+          {
+          case LayoutRoundRobin:
+          case LayoutContiguous:
+            {
+              if ((key < start_) || (uint64_t(key) >= start_ + count_))
+                return false;
+              ranks = ranks_type(closed_form_rank(key));
+              return true;
+            }
+          default:
+            {
+              const size_t p = page_index(key);
+              if (p == pages_.size())
+                return false;
+              const Rank r = pages_[p].rank(key & (page_size - 1));
+              if (r == no_rank)
+                return false;
+              if (r == multi_rank)
+                {
+                  const std::vector<Rank>& v = multi_ranks_.find(key)->second;
+                  ranks = ranks_type(v.data(), v.data() + v.size());
+                }
+              else
+                {
+                  ranks = ranks_type(r);
+                }
+              return true;
+            }
+          }
+      }
+
+      // This method lets cereal know which data members to serialize
+      template<class Archive>
+      void serialize (Archive & archive)
+      {
+        archive(layout_, start_, count_, num_ranks_, size_, page_keys_, pages_, multi_ranks_);
+      }
+
+    private:
+      /// The ranks of the nodes of one page, by offset in the page: a
+      /// sorted list of (offset, rank) pairs while the page is sparse,
+      /// or a rank per node, no_rank if unassigned, once it is dense.
+      struct Page
+      {
+        std::vector< std::pair<uint16_t, Rank> > entries;
+        std::vector<Rank> slots;
+
+        bool dense () const { return !slots.empty(); }
+
+        Rank rank (const size_t offset) const
+        {
+          if (dense())
+            return slots[offset];
+          auto it = std::lower_bound(entries.begin(), entries.end(),
+                                     std::make_pair(uint16_t(offset), Rank(0)));
+          if ((it != entries.end()) && (it->first == offset))
+            return it->second;
+          return no_rank;
+        }
+
+        /// Returns the rank of the node at offset, which is no_rank if
+        /// the node is new and must then be assigned by the caller.
+        Rank& slot (const size_t offset)
+        {
+          if (dense())
+            return slots[offset];
+          auto it = std::lower_bound(entries.begin(), entries.end(),
+                                     std::make_pair(uint16_t(offset), Rank(0)));
+          if ((it != entries.end()) && (it->first == offset))
+            return it->second;
+          if (entries.size() < dense_threshold)
+            return entries.insert(it, std::make_pair(uint16_t(offset), no_rank))->second;
+          slots.assign(page_size, no_rank);
+          for (const auto& entry : entries)
+            {
+              slots[entry.first] = entry.second;
+            }
+          entries.clear();
+          entries.shrink_to_fit();
+          return slots[offset];
+        }
+
+        /// Returns the offset of the first node not before offset, or
+        /// page_size if there is none.
+        size_t next_offset (const size_t offset) const
+        {
+          if (dense())
+            {
+              for (size_t i = offset; i < page_size; i++)
+                {
+                  if (slots[i] != no_rank)
+                    return i;
+                }
+              return page_size;
+            }
+          auto it = std::lower_bound(entries.begin(), entries.end(),
+                                     std::make_pair(uint16_t(offset), Rank(0)));
+          return (it == entries.end()) ? page_size : it->first;
+        }
+
+        template<class Archive>
+        void serialize (Archive & archive)
+        {
+          archive(entries, slots);
+        }
+      };
+
+      static constexpr Rank no_rank = std::numeric_limits<Rank>::max();
+      static constexpr Rank multi_rank = std::numeric_limits<Rank>::max() - 1;
+      static constexpr uint64_t end_pos = std::numeric_limits<uint64_t>::max();
+
+      void assign_closed_form (const uint32_t layout, const Key start, const size_t count, const size_t num_ranks)
+      {
+        throw_assert(num_ranks > 0,
+                     "CompactRankMap: invalid number of ranks");
+        if (empty())
+          {
+            clear();
+            layout_ = layout; start_ = start; count_ = count; num_ranks_ = num_ranks;
+          }
+        else
+          {
+            // combine with the existing assignment
+            CompactRankMap other;
+            other.assign_closed_form(layout, start, count, num_ranks);
+            for (const auto& element : other)
+              {
+                for (const Rank rank : element.second)
+                  {
+                    insert(element.first, rank);
+                  }
+              }
+          }
+      }
+
+      Rank closed_form_rank (const Key key) const
+      {
+        const uint64_t j = key - start_;
+        if (layout_ == LayoutRoundRobin)
+          {
+            return j % num_ranks_;
+          }
+        // rank r holds nodes floor(r*count/num_ranks) .. floor((r+1)*count/num_ranks)-1
+        return ((j + 1) * num_ranks_ - 1) / count_;
+      }
+
+      /// Converts a closed form assignment to pages.
+      void materialize ()
+      {
+        const uint64_t start = start_, count = count_;
+        CompactRankMap closed_form(*this);
+        clear();
+        for (uint64_t key = start; key < start + count; key++)
+          {
+            page_slot(key) = closed_form.closed_form_rank(key);
+          }
+        size_ = count;
+      }
+
+      size_t page_index (const Key key) const
+      {
+        const uint64_t page_key = uint64_t(key) >> page_bits;
+        auto it = std::lower_bound(page_keys_.begin(), page_keys_.end(), page_key);
+        if ((it != page_keys_.end()) && (*it == page_key))
+          {
+            return std::distance(page_keys_.begin(), it);
+          }
+        return pages_.size();
+      }
+
+      Rank& page_slot (const Key key)
+      {
+        const uint64_t page_key = uint64_t(key) >> page_bits;
+        auto it = std::lower_bound(page_keys_.begin(), page_keys_.end(), page_key);
+        const size_t p = std::distance(page_keys_.begin(), it);
+        if ((it == page_keys_.end()) || (*it != page_key))
+          {
+            page_keys_.insert(it, page_key);
+            pages_.insert(pages_.begin() + p, Page());
+          }
+        return pages_[p].slot(key & (page_size - 1));
+      }
+
+      /// Returns the smallest assigned key not less than pos, or end_pos.
+      uint64_t next_key (const uint64_t pos) const
+      {
+        if (layout_ != LayoutExplicit)
+          {
+            if (pos >= start_ + count_)
+              return end_pos;
+            return std::max(pos, start_);
+          }
+
+        const uint64_t page_key = pos >> page_bits;
+        auto it = std::lower_bound(page_keys_.begin(), page_keys_.end(), page_key);
+        for (size_t p = std::distance(page_keys_.begin(), it); p < pages_.size(); p++)
+          {
+            const uint64_t page_start = page_keys_[p] << page_bits;
+            const size_t i = pages_[p].next_offset((page_start < pos) ? (pos - page_start) : 0);
+            if (i < page_size)
+              {
+                return page_start + i;
+              }
+          }
+        return end_pos;
+      }
+
+      uint32_t layout_;
+      uint64_t start_, count_, num_ranks_;
+      uint64_t size_;
+      std::vector<uint64_t> page_keys_;
+      std::vector<Page> pages_;
+      std::map<Key, std::vector<Rank> > multi_ranks_;
+    };
+
+  }
+}
+
+#endif
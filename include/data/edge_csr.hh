@@ -0,0 +1,120 @@
+// -*- mode: c++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+//==============================================================================
+///  @file edge_csr.hh
+///
+///  Flat compressed sparse row (CSR) container for projection edges.
+///
+///  Copyright (C) 2016-2025 Project NeuroH5.
+//==============================================================================
+
+#ifndef EDGE_CSR_HH
+#define EDGE_CSR_HH
+
+#include <map>
+#include <string>
+#include <vector>
+
+#include "neuroh5_types.hh"
+#include "attr_val.hh"
+
+namespace neuroh5
+{
+  namespace data
+  {
+
+    /// @brief Projection edges stored as flat arrays.
+    ///
+    /// Row i holds the edges of key node keys[i] (the destination node when
+    /// edge_map_type is EdgeMapDst, or the source node for EdgeMapSrc). The
+    /// adjacent nodes of row i are adj[offsets[i]] .. adj[offsets[i+1]-1],
+    /// and each edge attribute is a column in attrs with one value per
+    /// edge, in the same order as adj. Rows are sorted by key.
+    struct EdgeCSR
+    {
+      EdgeMapType edge_map_type = EdgeMapDst;
+
+      // key node of each row, sorted in ascending order
+      std::vector<NODE_IDX_T> keys;
+      // start of each row in adj; size is keys.size()+1
+      std::vector<DST_PTR_T>  offsets;
+      // adjacent node of each edge
+      std::vector<NODE_IDX_T> adj;
+      // one entry per attribute namespace, one column per attribute
+      std::vector<AttrVal>    attrs;
+
+      EdgeCSR() : offsets(1, 0) {};
+      EdgeCSR(EdgeMapType p_edge_map_type) : edge_map_type(p_edge_map_type), offsets(1, 0) {};
+
+      // This method lets cereal know which data members to serialize
+      template<class Archive>
+      void serialize(Archive & archive)
+      {
+        archive(edge_map_type, keys, offsets, adj, attrs);
+      }
+
+      size_t num_nodes () const { return keys.size(); }
+      size_t num_edges () const { return adj.size(); }
+
+      size_t row_begin (size_t i) const { return offsets[i]; }
+      size_t row_end (size_t i) const { return offsets[i+1]; }
+      size_t row_size (size_t i) const { return offsets[i+1] - offsets[i]; }
+
+      /// Returns the row index of the given key node, or num_nodes() if
+      /// the node has no edges.
+      size_t find (const NODE_IDX_T key) const;
+
+      /// Sets the number of namespaces and the number of attributes of
+      /// each type to match the given attribute values.
+      void init_attrs (const std::vector<const AttrVal*>& attr_shape);
+      void init_attrs (const std::vector<AttrVal>& attr_shape);
+
+      /// Appends a row whose adjacent nodes and attributes are a
+      /// contiguous range of edges [low, high) of the given arrays. Rows
+      /// may be appended in any key order and put in order by sort_rows.
+      void append_row (const NODE_IDX_T key,
+                       const std::vector<NODE_IDX_T>& adj_values,
+                       const std::vector<const AttrVal*>& attr_values,
+                       const size_t low, const size_t high,
+                       const NODE_IDX_T adj_offset = 0);
+
+      /// Appends the edges of row i of another container to the last row
+      /// of this container (starting a new row if the key differs).
+      void append_row (const EdgeCSR& other, const size_t i);
+
+      /// Appends a single edge to the last row, or to a new row if the
+      /// key differs from the key of the last row.
+      void push_back (const NODE_IDX_T key, const NODE_IDX_T adj_node,
+                      const std::vector<const AttrVal*>& attr_values,
+                      const size_t edge_index);
+
+      /// Sorts rows by key; rows with equal keys are concatenated in the
+      /// order in which they were appended.
+      void sort_rows ();
+
+      /// Copies row i into the tuple representation used by edge_map_t.
+      void edge_tuple (const size_t i, edge_tuple_t& et) const;
+
+      void clear ();
+
+      /// Adapters for consumers of the std::map based edge_map_t.
+      void to_edge_map (edge_map_t& edge_map) const;
+      void from_edge_map (const edge_map_t& edge_map);
+    };
+
+    typedef std::map<rank_t, EdgeCSR> rank_edge_csr_t;
+
+    /// Returns pointers to the attribute values of the given namespaces,
+    /// in the order given by attr_namespaces.
+    void edge_attr_ptrs (const std::map<std::string, NamedAttrVal>& edge_attr_map,
+                         const std::vector<std::string>& attr_namespaces,
+                         std::vector<const AttrVal*>& attr_values);
+
+    /// Merges a sequence of containers into one; edges of a key node
+    /// that occurs in several inputs are concatenated in input order.
+    void merge_edge_csr (const std::vector<EdgeCSR>& inputs,
+                         EdgeCSR& output);
+
+  }
+}
+
+#endif
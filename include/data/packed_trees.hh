@@ -0,0 +1,87 @@
+// -*- mode: c++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+//==============================================================================
+///  @file packed_trees.hh
+///
+///  Contiguous storage of tree structures.
+///
+///  Copyright (C) 2016-2025 Project NeuroH5.
+//==============================================================================
+
+#ifndef PACKED_TREES_HH
+#define PACKED_TREES_HH
+
+#include <forward_list>
+#include <map>
+#include <vector>
+
+#include "neuroh5_types.hh"
+#include "columnar_attr_map.hh"
+
+namespace neuroh5
+{
+  namespace data
+  {
+
+    /// @brief A set of trees stored with one contiguous buffer per field.
+    ///
+    /// The fields of tree i are stored in the ranges given by three
+    /// pointer arrays, as in the Trees namespace of the file:
+    /// src_sections and dst_sections by topo_ptr[i] .. topo_ptr[i+1],
+    /// sections by sec_ptr[i] .. sec_ptr[i+1], and the node attributes
+    /// (coordinates, radiuses, layers, parents, SWC types) by
+    /// attr_ptr[i] .. attr_ptr[i+1]. Trees are sorted by gid.
+    struct PackedTrees
+    {
+      std::vector<CELL_IDX_T>        gids;
+
+      std::vector<TOPO_PTR_T>        topo_ptr;
+      std::vector<SECTION_IDX_T>     src_sections;
+      std::vector<SECTION_IDX_T>     dst_sections;
+
+      std::vector<SEC_PTR_T>         sec_ptr;
+      std::vector<SECTION_IDX_T>     sections;
+
+      std::vector<ATTR_PTR_T>        attr_ptr;
+      std::vector<COORD_T>           xcoords;
+      std::vector<COORD_T>           ycoords;
+      std::vector<COORD_T>           zcoords;
+      std::vector<REALVAL_T>         radiuses;
+      std::vector<LAYER_IDX_T>       layers;
+      std::vector<PARENT_NODE_IDX_T> parents;
+      std::vector<SWC_TYPE_T>        swc_types;
+
+      PackedTrees() : topo_ptr(1, 0), sec_ptr(1, 0), attr_ptr(1, 0) {};
+
+      size_t num_trees () const { return gids.size(); }
+      size_t num_nodes (size_t i) const { return attr_ptr[i+1] - attr_ptr[i]; }
+      size_t num_topology (size_t i) const { return topo_ptr[i+1] - topo_ptr[i]; }
+      size_t num_sections (size_t i) const { return sec_ptr[i+1] - sec_ptr[i]; }
+
+      /// Returns the index of the tree with the given gid, or num_trees()
+      /// if there is no such tree.
+      size_t find (const CELL_IDX_T gid) const;
+
+      /// Appends a tree; trees may be appended in any gid order, and
+      /// must then be put in order by sort_trees.
+      void append (const neurotree_t& tree);
+
+      void sort_trees ();
+
+      /// Copies tree i into the deque based neurotree_t representation.
+      void tree (const size_t i, neurotree_t& tree) const;
+
+      void clear ();
+
+      /// Moves the columns of the Trees namespace read into a
+      /// ColumnarAttrMap; attr_values is left empty.
+      void from_attr_map (ColumnarAttrMap&& attr_values);
+
+      /// Adapters for consumers of neurotree_t.
+      void to_tree_list (std::forward_list<neurotree_t>& tree_list) const;
+      void to_tree_map (std::map<CELL_IDX_T, neurotree_t>& tree_map) const;
+    };
+
+  }
+}
+
+#endif
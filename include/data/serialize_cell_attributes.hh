@@ -18,6 +18,7 @@
 
 #include "neuroh5_types.hh"
 #include "attr_map.hh"
+#include "columnar_attr_map.hh"
 
 namespace neuroh5
 {
@@ -37,6 +38,70 @@ namespace neuroh5
                                     const std::vector<size_t>& rdispls,
                                     AttrMap& all_attr_map);
 
+    /// Same as above, for a receive buffer that is not held in a vector.
+    void deserialize_rank_attr_map (const size_t num_ranks,
+                                    const char *recvbuf,
+                                    const size_t recvbuf_size,
+                                    const std::vector<size_t>& recvcounts,
+                                    const std::vector<size_t>& rdispls,
+                                    AttrMap& all_attr_map);
+
+    /// Packs columnar attribute maps with memcpy; attribute names are not
+    /// included, and columns are identified by their type and index.
+    void serialize_rank_attr_map (const size_t num_ranks,
+                                  const size_t start_rank,
+                                  const map <rank_t, ColumnarAttrMap>& rank_attr_map,
+                                  std::vector<size_t>& sendcounts,
+                                  std::vector<char> &sendbuf,
+                                  std::vector<size_t> &sdispls);
+
+    /// Unpacks columnar attribute maps and merges them into all_attr_map.
+    void deserialize_rank_attr_map (const size_t num_ranks,
+                                    const std::vector<char> &recvbuf,
+                                    const std::vector<size_t>& recvcounts,
+                                    const std::vector<size_t>& rdispls,
+                                    ColumnarAttrMap& all_attr_map);
+
+    /// Same as above, for a receive buffer that is not held in a vector.
+    void deserialize_rank_attr_map (const size_t num_ranks,
+                                    const char *recvbuf,
+                                    const size_t recvbuf_size,
+                                    const std::vector<size_t>& recvcounts,
+                                    const std::vector<size_t>& rdispls,
+                                    ColumnarAttrMap& all_attr_map);
+
+    /// Combines the send buffers of several serialized rank attribute
+    /// maps into one message per rank. The message to each rank starts
+    /// with the size of each segment as uint64_t, followed by the
+    /// segments; ranks that receive no segment are sent nothing.
+    void pack_rank_attr_segments (const size_t num_ranks,
+                                  const std::vector< std::vector<size_t> >& segment_sendcounts,
+                                  const std::vector< std::vector<size_t> >& segment_sdispls,
+                                  const std::vector< std::vector<char> >& segment_sendbufs,
+                                  std::vector<size_t>& sendcounts,
+                                  std::vector<char> &sendbuf,
+                                  std::vector<size_t> &sdispls);
+
+    /// Returns the receive counts and displacements of each segment of
+    /// messages packed by pack_rank_attr_segments, relative to recvbuf.
+    void unpack_rank_attr_segments (const size_t num_ranks,
+                                    const size_t num_segments,
+                                    const std::vector<char> &recvbuf,
+                                    const std::vector<size_t>& recvcounts,
+                                    const std::vector<size_t>& rdispls,
+                                    std::vector< std::vector<size_t> >& segment_recvcounts,
+                                    std::vector< std::vector<size_t> >& segment_rdispls);
+
+    /// Same as above, for a receive buffer that is not held in a vector.
+    void unpack_rank_attr_segments (const size_t num_ranks,
+                                    const size_t num_segments,
+                                    const char *recvbuf,
+                                    const size_t recvbuf_size,
+                                    const std::vector<size_t>& recvcounts,
+                                    const std::vector<size_t>& rdispls,
+                                    std::vector< std::vector<size_t> >& segment_recvcounts,
+                                    std::vector< std::vector<size_t> >& segment_rdispls);
+
     
   }
 }
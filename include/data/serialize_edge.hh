@@ -17,6 +17,7 @@
 #include <string>
 
 #include "neuroh5_types.hh"
+#include "edge_csr.hh"
 
 namespace neuroh5
 {
@@ -50,6 +51,53 @@ namespace neuroh5
                                size_t& num_unpacked_edges
                                );
 
+    void serialize_edge_csr (const EdgeCSR& edge_csr,
+                             size_t &num_packed_edges,
+                             vector<char> &sendbuf);
+
+    void serialize_rank_edge_csr (const size_t num_ranks,
+                                  const size_t start_rank,
+                                  const rank_edge_csr_t& prj_rank_edge_csr,
+                                  size_t &num_packed_edges,
+                                  vector<size_t>& sendcounts,
+                                  vector<char> &sendbuf,
+                                  vector<size_t> &sdispls);
+
+    void deserialize_rank_edge_csr (const size_t num_ranks,
+                                    const vector<char> &recvbuf,
+                                    const vector<size_t>& recvcounts,
+                                    const vector<size_t>& rdispls,
+                                    EdgeCSR& prj_edge_csr,
+                                    size_t& num_unpacked_nodes,
+                                    size_t& num_unpacked_edges
+                                    );
+
+    /// Same as above, for a receive buffer that is not held in a vector.
+    void deserialize_rank_edge_csr (const size_t num_ranks,
+                                    const char *recvbuf,
+                                    const size_t recvbuf_size,
+                                    const vector<size_t>& recvcounts,
+                                    const vector<size_t>& rdispls,
+                                    EdgeCSR& prj_edge_csr,
+                                    size_t& num_unpacked_nodes,
+                                    size_t& num_unpacked_edges
+                                    );
+
+    /// Appends the containers received from each rank to rank_edge_csr,
+    /// in sender rank order, without merging them.
+    void deserialize_rank_edge_csr (const size_t num_ranks,
+                                    const vector<char> &recvbuf,
+                                    const vector<size_t>& recvcounts,
+                                    const vector<size_t>& rdispls,
+                                    vector<EdgeCSR>& rank_edge_csr
+                                    );
+
+    void deserialize_edge_csr (const vector<char> &recvbuf,
+                               EdgeCSR& prj_edge_csr,
+                               size_t& num_unpacked_nodes,
+                               size_t& num_unpacked_edges
+                               );
+
   }
 }
 #endif
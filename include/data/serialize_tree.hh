@@ -37,6 +37,15 @@ namespace neuroh5
                                     std::map<CELL_IDX_T, neurotree_t> &all_tree_map
                                     );
 
+    /// Same as above, for a receive buffer that is not held in a vector.
+    void deserialize_rank_tree_map (const size_t num_ranks,
+                                    const char *recvbuf,
+                                    const size_t recvbuf_size,
+                                    const std::vector<size_t>& recvcounts,
+                                    const std::vector<size_t>& rdispls,
+                                    std::map<CELL_IDX_T, neurotree_t> &all_tree_map
+                                    );
+
     void deserialize_rank_tree_list (const size_t num_ranks,
                                      const vector<char> &recvbuf,
                                      const vector<size_t>& recvcounts,
@@ -0,0 +1,86 @@
+// -*- mode: c++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+//==============================================================================
+///  @file shared_edge_csr.hh
+///
+///  Read-only projection edges held in memory shared by the ranks of a node.
+///
+///  Copyright (C) 2016-2025 Project NeuroH5.
+//==============================================================================
+
+#ifndef SHARED_EDGE_CSR_HH
+#define SHARED_EDGE_CSR_HH
+
+#include <mpi.h>
+
+#include <tuple>
+#include <vector>
+
+#include "neuroh5_types.hh"
+#include "edge_csr.hh"
+#include "mapped_dataset.hh"
+
+namespace neuroh5
+{
+  namespace data
+  {
+
+    /// @brief The attribute columns of one namespace, one vector of
+    ///        columns per attribute type in AttrVal index order.
+    struct SharedAttrColumns
+    {
+      std::tuple< std::vector< hdf5::DatasetView<float> >,
+                  std::vector< hdf5::DatasetView<uint8_t> >,
+                  std::vector< hdf5::DatasetView<int8_t> >,
+                  std::vector< hdf5::DatasetView<uint16_t> >,
+                  std::vector< hdf5::DatasetView<int16_t> >,
+                  std::vector< hdf5::DatasetView<uint32_t> >,
+                  std::vector< hdf5::DatasetView<int32_t> > > columns;
+
+      template <class T>
+      const std::vector< hdf5::DatasetView<T> >& attr_columns () const
+      {
+        return std::get< std::vector< hdf5::DatasetView<T> > >(columns);
+      }
+
+      template <class T>
+      std::vector< hdf5::DatasetView<T> >& attr_columns ()
+      {
+        return std::get< std::vector< hdf5::DatasetView<T> > >(columns);
+      }
+    };
+
+    /// @brief Views of the columns of an EdgeCSR container, held in a
+    ///        segment shared by the ranks of a node.
+    ///
+    /// The columns keep the segment alive; it is freed by
+    /// mpi::release_shared_segments once they have been destroyed on all
+    /// ranks of the node.
+    struct SharedEdgeCSR
+    {
+      EdgeMapType edge_map_type = EdgeMapDst;
+
+      hdf5::DatasetView<NODE_IDX_T> keys;
+      hdf5::DatasetView<DST_PTR_T>  offsets;
+      hdf5::DatasetView<NODE_IDX_T> adj;
+      // one entry per attribute namespace
+      std::vector<SharedAttrColumns> attrs;
+
+      size_t num_nodes () const { return keys.size(); }
+      size_t num_edges () const { return adj.size(); }
+    };
+
+    /// @brief Copies the edge container given on rank root into one
+    ///        segment per node, and returns views of the node copy on
+    ///        every rank. Collective on comm.
+    void bcast_shared_edge_csr
+    (
+     MPI_Comm         comm,
+     const int        root,
+     const EdgeCSR&   edge_csr,
+     SharedEdgeCSR&   shared_edge_csr
+     );
+
+  }
+}
+
+#endif
@@ -13,6 +13,8 @@
 
 #include "neuroh5_types.hh"
 #include "attr_map.hh"
+#include "edge_csr.hh"
+#include "dataset_creation.hh"
 
 #include <mpi.h>
 #include <vector>
@@ -30,7 +32,27 @@ namespace neuroh5
      const string&    dst_pop_name,
      const std::map <std::string, std::pair <size_t, data::AttrIndex > >& edge_attr_index,
      const edge_map_t&  input_edge_map,
-     const hsize_t      chunk_size = 4096
+     const hsize_t      chunk_size = 4096,
+     const hdf5::DatasetCreationPolicy& dataset_policy = hdf5::DatasetCreationPolicy(),
+     const bool         edge_index = false
+     );
+
+    /// Same as above, with the edges given as rows of flat arrays keyed
+    /// by destination, with absolute source ids and one attribute
+    /// column per edge attribute in the namespace order of
+    /// edge_attr_index.
+    int append_graph
+    (
+     MPI_Comm         all_comm,
+     const int        io_size_arg,
+     const string&    file_name,
+     const string&    src_pop_name,
+     const string&    dst_pop_name,
+     const std::map <std::string, std::pair <size_t, data::AttrIndex > >& edge_attr_index,
+     const data::EdgeCSR& input_edges,
+     const hsize_t      chunk_size = 4096,
+     const hdf5::DatasetCreationPolicy& dataset_policy = hdf5::DatasetCreationPolicy(),
+     const bool         edge_index = false
      );
 
   }
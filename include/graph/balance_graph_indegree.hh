@@ -32,7 +32,7 @@ namespace neuroh5
   ///
   /// @param prj_names     Vector of projection names to be read
   ///
-  /// @param io_size       Number of I/O ranks (those ranks that conduct I/O operations)
+  /// @param io_size       Unused; every rank reads a part of the projections
   ///
   /// @param Nparts        Number of partitions
   ///
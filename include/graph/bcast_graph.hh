@@ -13,6 +13,8 @@
 #define GRAPH_BCAST_HH
 
 #include "neuroh5_types.hh"
+#include "edge_csr.hh"
+#include "shared_edge_csr.hh"
 #include "read_graph.hh"
 
 #include <mpi.h>
@@ -41,16 +43,32 @@ namespace neuroh5
     ///
     /// @param prj_names     Vector of projection names to be read
     ///
-    /// @param prj_vector    Vector of maps where the key is destination index,
-    ///                      and the value is a vector of source indices and
-    ///                      optional edge attributes, to be filled by this
-    ///                      procedure
+    /// @param prj_vector    Vector of flat edge containers, one per
+    ///                      projection, where each row holds the source
+    ///                      indices and optional edge attributes of a
+    ///                      destination, to be filled by this procedure
     ///
     /// @param total_num_nodes  Updated with the total number of nodes
     ///                         (vertices) in the graph
     ///
     /// @return              HDF5 error code
     int bcast_graph
+    (
+     MPI_Comm                           all_comm,
+     const EdgeMapType                  edge_map_type,
+     const std::string&                 file_name,
+     const std::vector< std::string > & attr_namespaces,
+     const std::vector< std::pair<std::string,std::string> >& prj_names,
+     std::vector < data::EdgeCSR >& prj_vector,
+     std::vector < std::map < std::string, std::vector <std::vector <std::string> > > >& edge_attr_names_vector,
+     size_t                            &total_num_nodes,
+     size_t                            &local_num_edges,
+     size_t                            &total_num_edges
+     );
+
+    /// @brief Reads the edges of the given projections into edge_map_t
+    ///        containers and broadcasts to all ranks; see above.
+    int bcast_graph
     (
      MPI_Comm                           all_comm,
      const EdgeMapType                  edge_map_type,
@@ -63,6 +81,31 @@ namespace neuroh5
      size_t                            &local_num_edges,
      size_t                            &total_num_edges
      );
+
+    /// @brief Reads the edges of the given projections and copies them
+    ///        once to each shared-memory node of all_comm.
+    ///
+    /// Each projection is held in a segment shared by the ranks of a
+    /// node, in the columnar layout of data::EdgeCSR, and every rank
+    /// receives read-only views of the node copy. The segments are freed
+    /// by mpi::release_shared_segments once the views have been destroyed
+    /// on all ranks of the node.
+    ///
+    /// @param prj_vector    Vector of shared edge containers, one per
+    ///                      projection, to be filled by this procedure
+    ///
+    /// @return              HDF5 error code
+    int bcast_graph_shared
+    (
+     MPI_Comm                           all_comm,
+     const EdgeMapType                  edge_map_type,
+     const std::string&                 file_name,
+     const std::vector< std::string > & attr_namespaces,
+     const std::vector< std::pair<std::string,std::string> >& prj_names,
+     std::vector < data::SharedEdgeCSR >& prj_vector,
+     std::vector < std::map < std::string, std::vector <std::vector <std::string> > > >& edge_attr_names_vector,
+     size_t                            &total_num_nodes
+     );
   }
 }
 
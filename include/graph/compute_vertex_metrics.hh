@@ -24,7 +24,12 @@ namespace neuroh5
 {
   namespace graph
   {
-  /// @brief Computes in-degree of the vertices in the specified projections
+  /// @brief Computes in-degree and unique in-degree of the vertices in
+  ///        the specified projections, and appends them with their
+  ///        normalized values to the "Vertex Metrics" node attributes.
+  ///
+  /// The degrees are computed from the DBS pointer and source index
+  /// datasets by read_projection_degree, without reading the edges.
   ///
   /// @param comm          MPI communicator
   ///
@@ -32,24 +37,22 @@ namespace neuroh5
   ///
   /// @param prj_names     Vector of projection names to be read
   ///
-  /// @param io_size       Number of I/O ranks (those ranks that conduct I/O operations)
-  ///
   /// @return              HDF5 error code
     
     int compute_vertex_indegree
     (
      MPI_Comm comm,
      const std::string& input_file_name,
-     const std::vector< std::pair<std::string, std::string> > prj_names,
-     const size_t io_size
+     const std::vector< std::pair<std::string, std::string> > prj_names
      );
-    
+
+    /// @brief Same as compute_vertex_indegree, for out-degree and unique
+    ///        out-degree.
     int compute_vertex_outdegree
     (
      MPI_Comm comm,
      const std::string& input_file_name,
-     const std::vector< std::pair<std::string, std::string> > prj_names,
-     const size_t io_size
+     const std::vector< std::pair<std::string, std::string> > prj_names
      );
 
   }
@@ -6,7 +6,9 @@
 #include "infer_datatype.hh"
 #include "attr_kind_datatype.hh"
 #include "hdf5_edge_attributes.hh"
+#include "dataset_creation.hh"
 #include "exists_dataset.hh"
+#include "phase_stats.hh"
 
 #include <hdf5.h>
 #include <mpi.h>
@@ -175,7 +177,9 @@ namespace neuroh5
      hid_t                    loc,
      const std::string&       path,
      const std::vector<T>&    value,
-     const bool collective = true
+     const bool collective = true,
+     const size_t chunk_size = 4000,
+     const hdf5::DatasetCreationPolicy& dataset_policy = hdf5::DatasetCreationPolicy()
      )
     {
       // get a file handle and retrieve the MPI info
@@ -239,11 +243,24 @@ namespace neuroh5
       throw_assert(H5Pset_create_intermediate_group(lcpl, 1) >= 0, 
                    "error in H5Pset_create_intermediate_group");
 
+      // a chunked layout cannot be used for an empty dataset of fixed size
+      hid_t dcpl = H5P_DEFAULT;
+      if (total > 0)
+        {
+          dcpl = hdf5::create_dataset_creation_plist(dataset_policy, hdf5::DatasetValue,
+                                                     chunk_size, total);
+        }
+
       hid_t dset = H5Dcreate(loc, path.c_str(), ftype, fspace,
-                             lcpl, H5P_DEFAULT, H5P_DEFAULT);
+                             lcpl, dcpl, H5P_DEFAULT);
       throw_assert(dset >= 0, "error in H5Dcreate");
+      if (dcpl != H5P_DEFAULT)
+        {
+          throw_assert(H5Pclose(dcpl) >= 0, "error in H5Pclose");
+        }
       throw_assert(H5Dwrite(dset, mtype, mspace, fspace, wapl, &value[0])
                    >= 0, "error in H5Dwrite");
+      mpi::count_write(block * sizeof(T));
 
       throw_assert(H5Dclose(dset) >= 0, "error in H5Dclose");
       throw_assert(H5Tclose(mtype) >= 0, "error in H5Tclose");
@@ -264,7 +281,9 @@ namespace neuroh5
                                    const string &src_pop_name,
                                    const string &dst_pop_name,
                                    const map <string, data::NamedAttrVal>& edge_attr_map,
-                                   const std::map <std::string, std::pair <size_t, data::AttrIndex > >& edge_attr_index)
+                                   const std::map <std::string, std::pair <size_t, data::AttrIndex > >& edge_attr_index,
+                                   const size_t chunk_size = 4000,
+                                   const hdf5::DatasetCreationPolicy& dataset_policy = hdf5::DatasetCreationPolicy())
 
 
     {
@@ -283,7 +302,8 @@ namespace neuroh5
                 {
                   size_t i = attr_index.attr_index<T>(attr_name);
                   string path = hdf5::edge_attribute_path(src_pop_name, dst_pop_name, attr_namespace, attr_name);
-                  graph::write_edge_attribute<T>(comm, file, path, edge_attr_values.const_attr_vec<T>(i));
+                  graph::write_edge_attribute<T>(comm, file, path, edge_attr_values.const_attr_vec<T>(i),
+                                                 true, chunk_size, dataset_policy);
                 }
             }
           else
@@ -304,7 +324,8 @@ namespace neuroh5
      const std::string&       attr_name,
      const std::vector<T>&    value,
      const size_t chunk_size = 4000,
-     const bool collective = true
+     const bool collective = true,
+     const hdf5::DatasetCreationPolicy& dataset_policy = hdf5::DatasetCreationPolicy()
      )
     {
       // get a file handle and retrieve the MPI info
@@ -327,7 +348,7 @@ namespace neuroh5
         {
           hdf5::create_edge_attribute_datasets(file, src_pop_name, dst_pop_name,
                                                attr_namespace, attr_name,
-                                               ftype, chunk_size);
+                                               ftype, chunk_size, dataset_policy);
 	  throw_assert(MPI_Barrier(comm) == MPI_SUCCESS, "error in MPI_Barrier");
         }
 
@@ -349,7 +370,8 @@ namespace neuroh5
                                     const string &dst_pop_name,
                                     const map <string, data::NamedAttrVal>& edge_attr_map,
                                     const std::map <std::string, std::pair <size_t, data::AttrIndex > >& edge_attr_index,
-				    const size_t chunk_size = 4000)
+				    const size_t chunk_size = 4000,
+                                    const hdf5::DatasetCreationPolicy& dataset_policy = hdf5::DatasetCreationPolicy())
 
     {
       for (auto const& iter : edge_attr_map)
@@ -369,7 +391,7 @@ namespace neuroh5
                   graph::append_edge_attribute<T>(comm, file, src_pop_name, dst_pop_name,
                                                   attr_namespace, attr_name,
                                                   edge_attr_values.const_attr_vec<T>(i),
-						  chunk_size);
+						  chunk_size, true, dataset_policy);
                 }
             }
           else
@@ -0,0 +1,50 @@
+// -*- mode: c++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+//==============================================================================
+///  @file exchange_edge_csr.hh
+///
+///  Distribution of flat CSR projection edges to the I/O ranks that write
+///  them.
+///
+///  Copyright (C) 2016-2025 Project NeuroH5.
+//==============================================================================
+
+#ifndef EXCHANGE_EDGE_CSR_HH
+#define EXCHANGE_EDGE_CSR_HH
+
+#include <mpi.h>
+
+#include <set>
+
+#include "neuroh5_types.hh"
+#include "edge_csr.hh"
+
+namespace neuroh5
+{
+  namespace graph
+  {
+
+    /// @brief Sends the rows of input_edges, keyed by destination, to
+    ///        the I/O ranks of io_rank_set. Collective on all_comm.
+    ///
+    /// Destinations are assigned to I/O ranks as in the edge_map_t
+    /// writers. Source ids are made relative to src_start and the edges
+    /// of each row are sorted by source, with their attributes. On
+    /// return, prj_edges holds the rows received by this rank and
+    /// total_num_nodes the number of destinations over all ranks.
+    void exchange_edge_csr
+    (
+     MPI_Comm                  all_comm,
+     std::set<size_t>&         io_rank_set,
+     const NODE_IDX_T          src_start,
+     const NODE_IDX_T          src_end,
+     const NODE_IDX_T          dst_start,
+     const NODE_IDX_T          dst_end,
+     const data::EdgeCSR&      input_edges,
+     size_t&                   total_num_nodes,
+     data::EdgeCSR&            prj_edges
+     );
+
+  }
+}
+
+#endif
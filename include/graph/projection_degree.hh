@@ -0,0 +1,68 @@
+// -*- mode: c++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+//==============================================================================
+///  @file projection_degree.hh
+///
+///  Vertex degrees computed directly from the DBS datasets of a projection.
+///
+///  Copyright (C) 2016-2025 Project NeuroH5.
+//==============================================================================
+
+#ifndef PROJECTION_DEGREE_HH
+#define PROJECTION_DEGREE_HH
+
+#include <mpi.h>
+
+#include <string>
+#include <vector>
+
+#include "neuroh5_types.hh"
+
+namespace neuroh5
+{
+  namespace graph
+  {
+
+    /// Degrees of the nodes of one population in one projection. The
+    /// population is split into contiguous ranges of nearly equal size,
+    /// one per rank, and each rank holds the nodes of its range that
+    /// appear in the projection, in ascending order.
+    struct ProjectionDegree
+    {
+      std::vector<NODE_IDX_T> node_id;
+      // number of edges of each node
+      std::vector<size_t>     degree;
+      // number of distinct adjacent nodes of each node
+      std::vector<size_t>     unique_degree;
+      // sums over all ranks
+      uint64_t                total_degree = 0;
+      uint64_t                total_unique_degree = 0;
+    };
+
+    /// @brief Computes the in-degree (EdgeMapDst) or the out-degree
+    ///        (EdgeMapSrc) of the nodes of a projection without reading
+    ///        its edges into edge maps. Collective on comm.
+    ///
+    /// Every rank reads a range of destination blocks and the matching
+    /// hyperslab of SRC_IDX. In-degrees are the differences of DST_PTR,
+    /// and out-degrees a histogram of SRC_IDX. A destination whose
+    /// blocks were read by several ranks (as after append_graph) has its
+    /// sources sent to one rank, so that unique degrees count every
+    /// distinct edge once. The counts of the nodes touched by each rank
+    /// are then sent to the rank that holds their range of the
+    /// population. A destination node appears in the projection if it
+    /// is listed in a destination block, and a source node if it has at
+    /// least one edge.
+    void read_projection_degree
+    (
+     MPI_Comm              comm,
+     const std::string&    file_name,
+     const std::string&    src_pop_name,
+     const std::string&    dst_pop_name,
+     const EdgeMapType     edge_map_type,
+     ProjectionDegree&     result
+     );
+
+  }
+}
+
+#endif
@@ -12,6 +12,7 @@
 #define READ_GRAPH_HH
 
 #include "neuroh5_types.hh"
+#include "edge_csr.hh"
 
 #include <mpi.h>
 
@@ -35,8 +36,8 @@ namespace neuroh5
     ///
     /// @param prj_names     Vector of <src, dst> projections to be read
     ///
-    /// @param prj_list      Vector of projection tuples, to be filled with
-    ///                      edge information by this procedure
+    /// @param prj_vector    Vector of flat edge containers, one per
+    ///                      projection, to be filled by this procedure
     ///
     /// @param total_num_nodes  Updated with the total number of nodes
     ///                         (vertices) in the graph
@@ -49,6 +50,21 @@ namespace neuroh5
     ///
     /// @return              HDF5 error code
 
+    extern int read_graph
+    (
+     MPI_Comm                         comm,
+     const std::string&               file_name,
+     const std::vector< std::string >& edge_attr_name_spaces,
+     const std::vector< std::pair<std::string, std::string> >& prj_names,
+     std::vector<data::EdgeCSR>&     prj_vector,
+     vector < map <string, vector < vector<string> > > > & edge_attr_names_vector,
+     size_t&                          total_num_nodes,
+     size_t&                          local_prj_num_edges,
+     size_t&                          total_prj_num_edges
+     );
+
+    /// @brief Reads the edges of the given projections into edge_map_t
+    ///        containers; see above.
     extern int read_graph
     (
      MPI_Comm                         comm,
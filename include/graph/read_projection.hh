@@ -12,6 +12,7 @@
 #define READ_PROJECTION_HH
 
 #include "neuroh5_types.hh"
+#include "edge_csr.hh"
 
 #include <mpi.h>
 
@@ -58,8 +59,35 @@ namespace neuroh5
     ///
     /// @param src_idx       Source Index (source indices of edges)
     ///
+    /// @param prj_vector    Updated with the flat edge container of the
+    ///                      projection
+    ///
     /// @return              HDF5 error code
     extern herr_t read_projection
+    (
+     MPI_Comm                        comm,
+     const std::string&              file_name,
+     const pop_search_range_map_t&          pop_search_ranges,
+     const std::set< std::pair<pop_t, pop_t> >& pop_pairs,
+     const std::string&              src_pop_name,
+     const std::string&              dst_pop_name,
+     const NODE_IDX_T&               src_start,
+     const NODE_IDX_T&               dst_start,
+     const vector<string>&           edge_attr_name_spaces,
+     std::vector<data::EdgeCSR>&     prj_vector,
+     vector < map <string, vector < vector<string> > > > & edge_attr_names_vector,
+     size_t&                         local_num_nodes,
+     size_t&                         local_num_edges,
+     size_t&                         total_num_edges,
+     hsize_t&                        local_read_blocks,
+     hsize_t&                        total_read_blocks,
+     size_t                          offset = 0,
+     size_t                          numitems = 0,
+     bool collective = true
+     );
+
+    /// @brief Reads the projections into edge_map_t containers; see above.
+    extern herr_t read_projection
     (
      MPI_Comm                        comm,
      const std::string&              file_name,
@@ -13,6 +13,7 @@
 #define SCATTER_READ_GRAPH_HH
 
 #include "neuroh5_types.hh"
+#include "edge_csr.hh"
 #include "read_graph.hh"
 
 #include <mpi.h>
@@ -41,16 +42,34 @@ namespace neuroh5
     ///
     /// @param prj_names     Vector of projection names to be read
     ///
-    /// @param prj_vector    Vector of maps where the key is destination index,
-    ///                      and the value is a vector of source indices and
-    ///                      optional edge attributes, to be filled by this
-    ///                      procedure
+    /// @param prj_vector    Vector of flat edge containers, one per
+    ///                      projection, where each row holds the source
+    ///                      indices and optional edge attributes of a
+    ///                      destination, to be filled by this procedure
     ///
     /// @param total_num_nodes  Updated with the total number of nodes
     ///                         (vertices) in the graph
     ///
     /// @return              HDF5 error code
     int scatter_read_graph
+    (
+     MPI_Comm                           all_comm,
+     const EdgeMapType                  edge_map_type,
+     const std::string&                 file_name,
+     const int                          io_size,
+     const std::vector< std::string >&  attr_namespaces,
+     const std::vector< std::pair<std::string,std::string> >&    prj_names,
+     // A vector that maps nodes to compute ranks
+     const node_rank_map_t&  node_rank_map,
+     std::vector < data::EdgeCSR >& prj_vector,
+     vector < map <string, vector < vector<string> > > > & edge_attr_names_vector,
+     size_t &local_num_nodes, size_t &total_num_nodes,
+     size_t &local_num_edges, size_t &total_num_edges
+     );
+
+    /// @brief Reads the edges of the given projections into edge_map_t
+    ///        containers and scatters to all ranks; see above.
+    int scatter_read_graph
     (
      MPI_Comm                           all_comm,
      const EdgeMapType                  edge_map_type,
@@ -13,6 +13,7 @@
 #define SCATTER_READ_PROJECTION_HH
 
 #include "neuroh5_types.hh"
+#include "edge_csr.hh"
 
 #include <mpi.h>
 
@@ -24,6 +25,38 @@ namespace neuroh5
   namespace graph
   {
 
+    /// Reads a projection on the I/O ranks and distributes its edges
+    /// according to node_rank_map; the edges assigned to this rank are
+    /// appended to prj_vector as a single flat container.
+    ///
+    /// If batch_size is nonzero (or, when it is zero, the environment
+    /// variable NEUROH5_SCATTER_BATCH_SIZE is set), each I/O rank reads its
+    /// destination blocks batch_size blocks at a time, and the edges of
+    /// each batch are sent while the next batch is read. This bounds the
+    /// memory used by the I/O ranks for source indices and edge attributes
+    /// by the batch size. Batching applies only to reads of the whole
+    /// projection; a range of blocks given with offset and numitems is
+    /// read in one pass.
+    int scatter_read_projection (MPI_Comm all_comm,
+                                 const int io_size,
+                                 const EdgeMapType edge_map_type, 
+                                 const string& file_name,
+                                 const string& src_pop_name,
+                                 const string& dst_pop_name,
+                                 const NODE_IDX_T& src_start,
+                                 const NODE_IDX_T& dst_start,
+                                 const std::vector< std::string >&  attr_namespaces,
+                                 const node_rank_map_t&  node_rank_map,
+                                 const pop_search_range_map_t& pop_search_ranges,
+                                 const std::set< std::pair<pop_t, pop_t> >& pop_pairs,
+                                 std::vector < data::EdgeCSR >& prj_vector,
+                                 std::vector < map <string, std::vector < std::vector<string> > > > & edge_attr_names_vector,
+                                 size_t &local_num_nodes, size_t &local_num_edges, size_t &total_num_edges,
+                                 hsize_t &total_read_blocks,
+                                 size_t offset = 0, size_t numitems = 0,
+                                 size_t batch_size = 0);
+
+    /// Same as above, with the edges converted to edge_map_t.
     int scatter_read_projection (MPI_Comm all_comm,
                                  const int io_size,
                                  const EdgeMapType edge_map_type, 
@@ -40,7 +73,8 @@ namespace neuroh5
                                  std::vector < map <string, std::vector < std::vector<string> > > > & edge_attr_names_vector,
                                  size_t &local_num_nodes, size_t &local_num_edges, size_t &total_num_edges,
                                  hsize_t &total_read_blocks,
-                                 size_t offset = 0, size_t numitems = 0);
+                                 size_t offset = 0, size_t numitems = 0,
+                                 size_t batch_size = 0);
   }
 }
 
@@ -0,0 +1,88 @@
+// -*- mode: c++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+//==============================================================================
+///  @file dataset_creation.hh
+///
+///  Chunking and filter settings for the datasets created by the writers.
+///
+///  Copyright (C) 2016-2025 Project NeuroH5.
+//==============================================================================
+
+#ifndef DATASET_CREATION_HH
+#define DATASET_CREATION_HH
+
+#include <hdf5.h>
+
+namespace neuroh5
+{
+  namespace hdf5
+  {
+
+    /// Roles of the datasets of the DBS and cell attribute layouts, which
+    /// usually call for different chunk sizes.
+    enum DatasetRole
+      {
+        // destination block index, cell index
+        DatasetIndex,
+        // destination block/destination pointers, attribute pointers
+        DatasetPointer,
+        // source index, attribute values
+        DatasetValue
+      };
+
+    struct DatasetCreationPolicy
+    {
+      // deflate compression level (0-9), or -1 for no compression
+      int     deflate_level = 9;
+      bool    shuffle = false;
+      bool    fletcher32 = false;
+      // chunk size in elements for each dataset role; 0 uses the chunk
+      // size given to the writer
+      hsize_t index_chunk_size = 0;
+      hsize_t pointer_chunk_size = 0;
+      hsize_t value_chunk_size = 0;
+
+      /// Returns a policy with no filters.
+      static DatasetCreationPolicy uncompressed ()
+      {
+        DatasetCreationPolicy policy;
+        policy.deflate_level = -1;
+        return policy;
+      }
+
+      hsize_t chunk_size (const DatasetRole role, const hsize_t default_chunk_size) const
+      {
+        hsize_t result = 0;
+        switch (role)
+          {
+          case DatasetIndex:   result = index_chunk_size; break;
+          case DatasetPointer: result = pointer_chunk_size; break;
+          case DatasetValue:   result = value_chunk_size; break;
+          }
+        return (result > 0) ? result : default_chunk_size;
+      }
+    };
+
+    /// @brief Creates a dataset creation property list with the chunk
+    ///        size and filters given by policy for a dataset of the given
+    ///        role. The property list must be closed by the caller.
+    ///
+    /// @param policy          Chunking and filter settings
+    ///
+    /// @param role            Role of the dataset
+    ///
+    /// @param chunk_size      Chunk size used if policy does not set one for role
+    ///
+    /// @param max_chunk_size  If nonzero, the chunk size is limited to this
+    ///                        value (the size of a fixed-size dataset)
+    hid_t create_dataset_creation_plist
+    (
+     const DatasetCreationPolicy& policy,
+     const DatasetRole            role,
+     const hsize_t                chunk_size,
+     const hsize_t                max_chunk_size = 0
+     );
+
+  }
+}
+
+#endif
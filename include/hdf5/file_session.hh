@@ -0,0 +1,123 @@
+// -*- mode: c++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+//==============================================================================
+///  @file file_session.hh
+///
+///  An open NeuroH5 file shared by repeated read operations.
+///
+///  Copyright (C) 2016-2025 Project NeuroH5.
+//==============================================================================
+
+#ifndef FILE_SESSION_HH
+#define FILE_SESSION_HH
+
+#include <mpi.h>
+#include <hdf5.h>
+
+#include <map>
+#include <string>
+#include <vector>
+
+#include "serialize_data.hh"
+#include "cell_index_cache.hh"
+
+namespace neuroh5
+{
+  namespace hdf5
+  {
+
+    struct FileSessionOptions
+    {
+      // raw data chunk cache
+      size_t chunk_cache_size  = 16*1024*1024;
+      size_t chunk_cache_slots = 10007;
+      double chunk_cache_w0    = 1.0;
+      // initial and maximum size of the metadata cache
+      size_t metadata_cache_size = 32*1024*1024;
+      // all metadata reads are collective over the session communicator
+      bool   collective_metadata = true;
+      bool   rdwr = false;
+    };
+
+    /// @brief A file opened collectively once and kept open across read
+    ///        operations.
+    ///
+    /// While a session is alive, hdf5::open_file returns a new identifier
+    /// of the session file (by H5Freopen) to callers with a congruent
+    /// communicator instead of opening the file again, so that the
+    /// metadata cache is kept between operations. The population,
+    /// projection and attribute metadata broadcast by the read functions,
+    /// and the sorted cell attribute indices, are also cached in
+    /// read-only sessions. These caches are never invalidated: the file
+    /// cannot be opened for writing while a read-only session is alive,
+    /// and sessions opened for writing do not cache.
+    ///
+    /// Construction and destruction are collective over comm.
+    class FileSession
+    {
+    public:
+      FileSession (MPI_Comm comm, const std::string& file_name,
+                   const FileSessionOptions& options = FileSessionOptions());
+      ~FileSession ();
+
+      FileSession (const FileSession&) = delete;
+      FileSession& operator= (const FileSession&) = delete;
+
+      hid_t file () const { return file_; }
+      MPI_Comm comm () const { return comm_; }
+      const std::string& file_name () const { return file_name_; }
+      const FileSessionOptions& options () const { return options_; }
+
+      /// Returns a new identifier for the session file, which must be
+      /// closed by the caller.
+      hid_t reopen () const;
+
+      /// Returns the session for file_name that can be used for collective
+      /// operations over comm, or nullptr if there is none.
+      static FileSession* find (MPI_Comm comm, const std::string& file_name,
+                                const bool rdwr = false);
+
+      /// Returns any session for file_name, for operations local to the
+      /// calling rank, or nullptr if there is none.
+      static FileSession* find (const std::string& file_name);
+
+      /// Whether metadata read through this session is cached
+      bool caches_metadata () const { return !options_.rdwr; }
+
+      template <class T>
+      bool find_metadata (const std::string& key, T& value) const
+      {
+        if (!caches_metadata())
+          return false;
+        auto it = metadata_.find(key);
+        if (it == metadata_.end())
+          return false;
+        data::deserialize_data(it->second, value);
+        return true;
+      }
+
+      template <class T>
+      void insert_metadata (const std::string& key, const T& value)
+      {
+        if (!caches_metadata())
+          return;
+        std::vector<char>& buf = metadata_[key];
+        buf.clear();
+        data::serialize_data(value, buf);
+      }
+
+      /// Sorted cell attribute indices read through this session
+      data::CellIndexCache& cell_index_cache () { return cell_index_cache_; }
+
+    private:
+      MPI_Comm comm_;
+      std::string file_name_;
+      FileSessionOptions options_;
+      hid_t file_;
+      std::map<std::string, std::vector<char> > metadata_;
+      data::CellIndexCache cell_index_cache_;
+    };
+
+  }
+}
+
+#endif
@@ -15,6 +15,7 @@
 #include "read_template.hh"
 #include "write_template.hh"
 #include "sort_permutation.hh"
+#include "cell_index_cache.hh"
 #include "throw_assert.hh"
 #include "mpe_seq.hh"
 #include "debug.hh"
@@ -171,8 +172,7 @@ namespace neuroh5
      const std::string&        path,
      const CELL_IDX_T          pop_start,
      const std::vector<CELL_IDX_T>&  selection,
-     const std::vector<CELL_IDX_T>&  index,
-     const std::vector<ATTR_PTR_T>&  ptr,
+     const data::SortedCellIndex&    sorted_index,
      std::vector<CELL_IDX_T> & selection_index,
      std::vector<ATTR_PTR_T> & selection_ptr,
      std::vector<T> &          values
@@ -187,57 +187,24 @@ namespace neuroh5
       status = exists_group (loc, path.c_str());
       throw_assert(status > 0, "group " << path << " does not exist");
       
-      hsize_t dset_size = index.size();
       vector< pair<hsize_t,hsize_t> > ranges;
 
-      auto compare_idx = [](const CELL_IDX_T& a, const CELL_IDX_T& b) { return (a < b); };
-      
-      if (dset_size > 0)
+      if (!sorted_index.empty())
         {
 
           string value_path = path + "/" + ATTR_VAL;
 
           ATTR_PTR_T selection_ptr_pos = 0;
-          if (ptr.size() > 0)
-            {
-	      vector<size_t> p = data::sort_permutation(index, compare_idx);
-	      std::vector<CELL_IDX_T> sorted_index = data::apply_permutation(index, p);
+          sorted_index.select(pop_start, selection, selection_index, ranges);
 
-              for (const CELL_IDX_T& s : selection) 
-                {
-                  if (s < pop_start) continue;
-		  auto rp = std::equal_range(sorted_index.begin(), sorted_index.end(), s);
-		  for ( auto it = rp.first; it != rp.second; ++it )
-                    {
-                      ptrdiff_t spos = it - sorted_index.begin();
-		      ptrdiff_t pos = p[spos];
-                      hsize_t value_start=ptr[pos];
-                      hsize_t value_block=ptr[pos+1]-value_start;
-
-                      ranges.push_back(make_pair(value_start, value_block));
-                      selection_index.push_back(s);
-                    }
-                }
-          
+          for (const auto& range: ranges)
+            {
+              hsize_t value_block=range.second;
 
-	      auto compare_range_idx = [](const std::pair<hsize_t, hsize_t>& a, const std::pair<hsize_t, hsize_t>& b) 
-		{ return (a.first < b.first); };
-	  
-	      vector<size_t> range_sort_p = data::sort_permutation(ranges, compare_range_idx);
-	      
-	      data::apply_permutation_in_place(selection_index, range_sort_p);
-	      data::apply_permutation_in_place(ranges, range_sort_p);
-
-	      for (const auto& range: ranges)
-		{
-		  hsize_t value_start=range.first;
-		  hsize_t value_block=range.second;
-
-		  selection_ptr.push_back(selection_ptr_pos);
-		  selection_ptr_pos += value_block;
-		}
-	      selection_ptr.push_back(selection_ptr_pos);
+              selection_ptr.push_back(selection_ptr_pos);
+              selection_ptr_pos += value_block;
             }
+          selection_ptr.push_back(selection_ptr_pos);
 
           hid_t dset = H5Dopen(loc, value_path.c_str(), H5P_DEFAULT);
           throw_assert(dset >= 0, "error in H5Dopen");
@@ -264,7 +231,84 @@ namespace neuroh5
       return status;
     }
 
-   
+
+    template <typename T>
+    herr_t read_cell_attribute_selection
+    (
+     MPI_Comm                  comm,
+     const hid_t&              loc,
+     const std::string&        path,
+     const CELL_IDX_T          pop_start,
+     const std::vector<CELL_IDX_T>&  selection,
+     const std::vector<CELL_IDX_T>&  index,
+     const std::vector<ATTR_PTR_T>&  ptr,
+     std::vector<CELL_IDX_T> & selection_index,
+     std::vector<ATTR_PTR_T> & selection_ptr,
+     std::vector<T> &          values
+     )
+    {
+      data::SortedCellIndex sorted_index(index, ptr);
+      return read_cell_attribute_selection(comm, loc, path, pop_start, selection, sorted_index,
+                                           selection_index, selection_ptr, values);
+    }
+
+
+    /// One attribute of a fused append (see append_cell_attributes): the
+    /// cell index relative to the population start, the attribute
+    /// pointer and the values of this rank. The vectors are referenced,
+    /// not copied.
+    struct CellAttributeAppend
+    {
+      std::string                     attr_name;
+      hid_t                           ftype;
+      CellIndex                       index_type;
+      CellPtr                         ptr_type;
+      const std::vector<CELL_IDX_T>*  index;
+      const std::vector<ATTR_PTR_T>*  attr_ptr;
+      const void*                     values;
+      size_t                          num_values;
+      size_t                          value_size;
+    };
+
+    template <typename T>
+    CellAttributeAppend cell_attribute_append
+    (
+     const std::string&              attr_name,
+     const std::vector<CELL_IDX_T>&  index,
+     const std::vector<ATTR_PTR_T>&  attr_ptr,
+     const std::vector<T>&           value,
+     const data::optional_hid        data_type,
+     const CellIndex                 index_type,
+     const CellPtr                   ptr_type
+     )
+    {
+      T dummy;
+      CellAttributeAppend attr = { attr_name,
+                                   data_type.has_value() ? data_type.value() : infer_datatype(dummy),
+                                   index_type, ptr_type, &index, &attr_ptr,
+                                   value.data(), value.size(), sizeof(T) };
+      return attr;
+    }
+
+    /// @brief Appends several attributes of a population. Collective on
+    ///        comm.
+    ///
+    /// Same result as one append_cell_attribute per element of attrs, in
+    /// order, but the sizes of all attributes are exchanged with a single
+    /// MPI_Allgather, all datasets are extended in one pass, and all
+    /// pointers and values are written with one multi-dataset write
+    /// (H5Dwrite_multi with HDF5 1.14 or later, one H5Dwrite per dataset
+    /// otherwise). The datasets must exist.
+    void append_cell_attributes
+    (
+     MPI_Comm                        comm,
+     const hid_t&                    loc,
+     const std::string&              attr_namespace,
+     const std::string&              pop_name,
+     const std::vector<CellAttributeAppend>& attrs
+     );
+
+
     template <typename T>
     void append_cell_attribute
     (
@@ -10,6 +10,7 @@
 #include "rank_range.hh"
 #include "dataset_num_elements.hh"
 #include "create_group.hh"
+#include "dataset_creation.hh"
 #include "read_template.hh"
 #include "write_template.hh"
 #include "file_access.hh"
@@ -50,7 +51,8 @@ namespace neuroh5
      const string&  attr_namespace,
      const string&  attr_name,
      const hid_t&   ftype,
-     const size_t   chunk_size
+     const size_t   chunk_size,
+     const DatasetCreationPolicy& dataset_policy = DatasetCreationPolicy()
      );
 
     
@@ -0,0 +1,188 @@
+// -*- mode: c++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+//==============================================================================
+///  @file mapped_dataset.hh
+///
+///  Serial read access to NeuroH5 datasets by mapping their contiguous
+///  storage into memory.
+///
+///  Copyright (C) 2016-2025 Project NeuroH5.
+//==============================================================================
+
+#ifndef MAPPED_DATASET_HH
+#define MAPPED_DATASET_HH
+
+#include <hdf5.h>
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "neuroh5_types.hh"
+#include "dataset_num_elements.hh"
+#include "read_template.hh"
+#include "throw_assert.hh"
+
+namespace neuroh5
+{
+  namespace hdf5
+  {
+
+    /// @brief A read-only one-dimensional array of dataset elements.
+    ///
+    /// The elements are either part of a file mapping, if the dataset
+    /// could be mapped, part of a segment shared by the ranks of a node
+    /// (see mpi::SharedSegment), or a copy read through HDF5. Copies of a
+    /// view share the mapping, segment or copy, which lives as long as
+    /// any view.
+    template <class T>
+    class DatasetView
+    {
+    public:
+      DatasetView ()
+        : data_(nullptr), size_(0), mapped_(false) {}
+      DatasetView (std::shared_ptr<const void> owner, const T* data,
+                   const size_t size, const bool mapped)
+        : owner_(owner), data_(data), size_(size), mapped_(mapped) {}
+
+      const T* data () const { return data_; }
+      size_t size () const { return size_; }
+      bool empty () const { return size_ == 0; }
+      /// True if the elements are shared with other processes (a file
+      /// mapping or a shared segment) rather than a private copy
+      bool mapped () const { return mapped_; }
+
+      const T& operator[] (const size_t i) const { return data_[i]; }
+      const T* begin () const { return data_; }
+      const T* end () const { return data_ + size_; }
+
+      /// The mapping or copy that holds the elements
+      const std::shared_ptr<const void>& owner () const { return owner_; }
+
+    private:
+      std::shared_ptr<const void> owner_;
+      const T* data_;
+      size_t size_;
+      bool mapped_;
+    };
+
+    /// @brief A NeuroH5 file opened for serial reading, whose datasets can
+    ///        be accessed as views of the mapped file.
+    ///
+    /// A dataset is mapped if its storage is contiguous, allocated, and its
+    /// elements are stored in the native representation of the requested
+    /// type. This is not the case for the chunked datasets created by the
+    /// NeuroH5 writers, which must first be converted to a contiguous
+    /// layout (e.g. with h5repack -l CONTIG). Datasets that cannot be
+    /// mapped are read into memory through HDF5 instead.
+    ///
+    /// The file is opened with the default (serial) file driver and
+    /// without MPI, so that it can be used by single-process tools.
+    /// Mappings are read-only and shared, so that concurrent processes on
+    /// one node share the pages of the file in the page cache.
+    class MappedFile
+    {
+    public:
+      MappedFile (const std::string& file_name);
+      ~MappedFile ();
+
+      MappedFile (const MappedFile&) = delete;
+      MappedFile& operator= (const MappedFile&) = delete;
+
+      hid_t file () const { return file_; }
+      const std::string& file_name () const { return file_name_; }
+
+      /// @brief Returns a view of the one-dimensional dataset at path.
+      ///
+      /// @param ntype    Native HDF5 type of T
+      template <class T>
+      DatasetView<T> view (const std::string& path, hid_t ntype) const
+      {
+        std::shared_ptr<const void> region;
+        const void* data = nullptr;
+        size_t size = 0;
+
+        if (map_dataset(path, ntype, sizeof(T), region, data, size))
+          {
+            return DatasetView<T>(region, static_cast<const T*>(data), size, true);
+          }
+
+        auto values = std::make_shared< std::vector<T> >();
+        values->resize(dataset_num_elements(file_, path));
+        herr_t ierr = read<T>(file_, path, 0, values->size(), ntype, *values, H5P_DEFAULT);
+        throw_assert(ierr >= 0,
+                     "MappedFile::view: error reading dataset " << path);
+        return DatasetView<T>(values, values->data(), values->size(), false);
+      }
+
+    private:
+      /// Maps the dataset at path, or returns false if it cannot be
+      /// mapped. Empty datasets are mapped with a null region.
+      bool map_dataset (const std::string& path,
+                        hid_t ntype,
+                        const size_t type_size,
+                        std::shared_ptr<const void>& region,
+                        const void*& data,
+                        size_t& size) const;
+
+      std::string file_name_;
+      hid_t file_;
+      int fd_;
+    };
+
+    /// The DBS (Destination Block Sparse) datasets of a projection
+    struct ProjectionView
+    {
+      DatasetView<DST_BLK_PTR_T> dst_blk_ptr;
+      DatasetView<NODE_IDX_T>    dst_blk_idx;
+      DatasetView<DST_PTR_T>     dst_ptr;
+      DatasetView<NODE_IDX_T>    src_idx;
+    };
+
+    /// The index, pointer and value datasets of a cell attribute
+    template <class T>
+    struct CellAttributeView
+    {
+      DatasetView<CELL_IDX_T>    index;
+      DatasetView<ATTR_PTR_T>    ptr;
+      DatasetView<T>             value;
+    };
+
+    /// @brief Returns views of the DBS datasets of a projection.
+    ProjectionView view_projection
+    (
+     const MappedFile&          file,
+     const std::string&         src_pop_name,
+     const std::string&         dst_pop_name
+     );
+
+    /// @brief Returns views of the datasets of a cell attribute with
+    ///        values of type T, which must have the size of the stored
+    ///        value type.
+    template <class T>
+    CellAttributeView<T> view_cell_attribute
+    (
+     const MappedFile&          file,
+     const std::string&         name_space,
+     const std::string&         pop_name,
+     const std::string&         attr_name
+     );
+
+    extern template CellAttributeView<float> view_cell_attribute<float>
+    (const MappedFile&, const std::string&, const std::string&, const std::string&);
+    extern template CellAttributeView<uint8_t> view_cell_attribute<uint8_t>
+    (const MappedFile&, const std::string&, const std::string&, const std::string&);
+    extern template CellAttributeView<int8_t> view_cell_attribute<int8_t>
+    (const MappedFile&, const std::string&, const std::string&, const std::string&);
+    extern template CellAttributeView<uint16_t> view_cell_attribute<uint16_t>
+    (const MappedFile&, const std::string&, const std::string&, const std::string&);
+    extern template CellAttributeView<int16_t> view_cell_attribute<int16_t>
+    (const MappedFile&, const std::string&, const std::string&, const std::string&);
+    extern template CellAttributeView<uint32_t> view_cell_attribute<uint32_t>
+    (const MappedFile&, const std::string&, const std::string&, const std::string&);
+    extern template CellAttributeView<int32_t> view_cell_attribute<int32_t>
+    (const MappedFile&, const std::string&, const std::string&, const std::string&);
+
+  }
+}
+
+#endif
@@ -39,6 +39,8 @@ namespace neuroh5
     const std::string DST_BLK_IDX = "Destination Block Index";
     const std::string DST_PTR     = "Destination Pointer";
     const std::string SRC_IDX     = "Source Index";
+    const std::string DST_EDGE_START = "Destination Edge Start";
+    const std::string DST_EDGE_COUNT = "Destination Edge Count";
 
     std::string h5types_path_join(const std::string& name);
 
@@ -0,0 +1,100 @@
+// -*- mode: c++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+//==============================================================================
+///  @file projection_edge_index.hh
+///
+///  Index of the source index range of each destination of a projection in
+///  DBS (Destination Block Sparse) format.
+///
+///  Copyright (C) 2016-2025 Project NeuroH5.
+//==============================================================================
+
+#ifndef PROJECTION_EDGE_INDEX_HH
+#define PROJECTION_EDGE_INDEX_HH
+
+#include <hdf5.h>
+#include <mpi.h>
+
+#include <limits>
+#include <string>
+#include <vector>
+
+#include "neuroh5_types.hh"
+#include "dataset_creation.hh"
+
+namespace neuroh5
+{
+  namespace hdf5
+  {
+
+    /// Edge start of destinations that are not in the projection
+    const DST_PTR_T EDGE_INDEX_NONE = std::numeric_limits<DST_PTR_T>::max();
+
+    /// @brief Returns true if the projection has an edge index.
+    bool exists_projection_edge_index
+    (
+     hid_t                      file,
+     const std::string&         src_pop_name,
+     const std::string&         dst_pop_name
+     );
+
+    /// @brief Creates or updates the edge index of a projection from its
+    ///        DBS datasets. The index consists of the datasets
+    ///        DST_EDGE_START and DST_EDGE_COUNT in the Edges group of the
+    ///        projection; element i holds the offset in SRC_IDX and the
+    ///        number of edges of the destination with population-relative
+    ///        index i, or EDGE_INDEX_NONE and 0 if the destination is not
+    ///        in the projection. If a destination occurs in more than one
+    ///        block, the first block is indexed, as in
+    ///        read_projection_dataset_selection.
+    ///
+    ///        If first_block is given and the index exists, only the
+    ///        blocks from first_block on are indexed: the index is
+    ///        extended to their destinations, and the entries of
+    ///        destinations that are not yet in the index are set.
+    ///
+    ///        Collective over comm, which must be the communicator of file.
+    ///
+    /// @param comm            MPI communicator
+    ///
+    /// @param file            File opened for writing over comm
+    ///
+    /// @param chunk_size      Chunk size of the index datasets
+    ///
+    /// @param dataset_policy  Chunking and filter settings
+    ///
+    /// @param first_block     Number of blocks already in the index, e.g.
+    ///                        before an append
+    herr_t write_projection_edge_index
+    (
+     MPI_Comm                   comm,
+     hid_t                      file,
+     const std::string&         src_pop_name,
+     const std::string&         dst_pop_name,
+     const hsize_t              chunk_size = 4096,
+     const DatasetCreationPolicy& dataset_policy = DatasetCreationPolicy(),
+     const bool                 collective = true,
+     const hsize_t              first_block = 0
+     );
+
+    /// @brief Reads the edge index entries of the given destinations by
+    ///        point selection. Destinations outside the index are returned
+    ///        as EDGE_INDEX_NONE. Opens the index datasets, so with
+    ///        collective metadata operations it must be called on all ranks
+    ///        of the file, with an empty dst_idx where there is nothing to
+    ///        read.
+    ///
+    /// @param dst_idx         Population-relative destination indices
+    herr_t read_projection_edge_index
+    (
+     hid_t                      file,
+     const std::string&         src_pop_name,
+     const std::string&         dst_pop_name,
+     const std::vector<NODE_IDX_T>& dst_idx,
+     std::vector<DST_PTR_T>&    edge_start,
+     std::vector<DST_PTR_T>&    edge_count
+     );
+
+  }
+}
+
+#endif
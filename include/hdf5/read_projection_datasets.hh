@@ -41,6 +41,44 @@ namespace neuroh5
      bool collective = true
      );
 
+    /**************************************************************************
+     * Read the pointer datasets of the DBS graph structure and distribute
+     * the destination blocks among the ranks of comm. edge_base and
+     * edge_count give the range of source indices that belong to the
+     * blocks assigned to the current rank.
+     *************************************************************************/
+
+    herr_t read_projection_pointers
+    (
+     MPI_Comm                   comm,
+     const std::string&         file_name,
+     const std::string&         src_pop_name,
+     const std::string&         dst_pop_name,
+     DST_BLK_PTR_T&             block_base,
+     DST_PTR_T&                 edge_base,
+     DST_PTR_T&                 edge_count,
+     vector<DST_BLK_PTR_T>&     dst_blk_ptr,
+     vector<NODE_IDX_T>&        dst_idx,
+     vector<DST_PTR_T>&         dst_ptr,
+     size_t&                    total_num_edges,
+     hsize_t&                   total_read_blocks
+     );
+
+    /**************************************************************************
+     * Collectively read a range of source indices
+     *************************************************************************/
+
+    herr_t read_projection_src_idx
+    (
+     MPI_Comm                   comm,
+     const std::string&         file_name,
+     const std::string&         src_pop_name,
+     const std::string&         dst_pop_name,
+     const hsize_t              edge_start,
+     const hsize_t              edge_count,
+     vector<NODE_IDX_T>&        src_idx
+     );
+
     herr_t read_projection_node_datasets
     (
      MPI_Comm                   comm,
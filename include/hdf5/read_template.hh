@@ -8,6 +8,7 @@
 #include <cstdio>
 
 #include "exists_dataset.hh"
+#include "phase_stats.hh"
 #include "throw_assert.hh"
 
 
@@ -62,6 +63,7 @@ namespace neuroh5
 	  ierr = H5Dread(dset, ntype, mspace, fspace, rapl, v.data());
 	  throw_assert(ierr >= 0,
                        "hdf5::read: error in H5Dread");
+	  mpi::count_read(len * sizeof(T));
 	  
 	  throw_assert(H5Dclose(dset) >= 0,
                        "hdf5::read: error in H5Dclose");
@@ -161,6 +163,7 @@ namespace neuroh5
 	  ierr = H5Dread(dset, ntype, mspace, fspace, rapl, v.data());
 	  throw_assert(ierr >= 0,
                        "hdf5::read_selection: error in H5Dread");
+	  mpi::count_read(len * sizeof(T));
 	  
 	  throw_assert(H5Sclose(mspace) >= 0,
                        "hdf5::read_selection: error in H5Sclose");
@@ -9,6 +9,7 @@
 #include <vector>
 
 #include "file_access.hh"
+#include "phase_stats.hh"
 #include "throw_assert.hh"
 
 namespace neuroh5
@@ -81,6 +82,7 @@ namespace neuroh5
 	  }
         throw_assert(ierr >= 0, "write_template: error in H5Dwrite on dataset "
                      << name << " start: " << start << " length: " << len);
+        mpi::count_write(len * sizeof(T));
 
         ierr = H5Sclose(mspace);
         throw_assert(ierr >= 0, "error in H5Sclose");
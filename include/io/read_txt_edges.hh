@@ -0,0 +1,80 @@
+// -*- mode: c++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+//==============================================================================
+///  @file read_txt_edges.hh
+///
+///  Parallel reading of projection edges in text format.
+///
+///  Copyright (C) 2016-2025 Project NeuroH5.
+//==============================================================================
+
+#ifndef READ_TXT_EDGES_HH
+#define READ_TXT_EDGES_HH
+
+#include <mpi.h>
+
+#include <string>
+#include <vector>
+#include <map>
+
+#include "neuroh5_types.hh"
+#include "attr_val.hh"
+
+namespace neuroh5
+{
+  namespace io
+  {
+
+    /// @brief Reads the lines of a text file that start in the byte range
+    ///        of this rank. Collective on comm.
+    ///
+    /// The file is split into one byte range of equal size per rank, and
+    /// each line is read by the rank whose range contains its first byte.
+    /// The ranges are read with collective MPI-IO, and a rank whose last
+    /// line extends past its range reads the rest of that line
+    /// separately. On return, buffer holds complete lines.
+    void read_txt_byte_range
+    (
+     MPI_Comm              comm,
+     const std::string&    file_name,
+     std::vector<char>&    buffer
+     );
+
+    /// @brief Parses edge lines of the form "dst src [attr ...]" and
+    ///        appends one entry per edge to the edge columns.
+    ///
+    /// The attributes of each line are given by namespace in the order of
+    /// num_attrs, and within a namespace by type in the order float,
+    /// uint8, uint16, uint32, int8, int16, int32. Blank lines and lines
+    /// starting with '#' are skipped. Returns the number of edges parsed.
+    size_t parse_txt_edges
+    (
+     const char*           begin,
+     const char*           end,
+     const std::map <std::string, std::vector <size_t> >& num_attrs,
+     std::vector<NODE_IDX_T>& dst_idx,
+     std::vector<NODE_IDX_T>& src_idx,
+     std::map <std::string, data::AttrVal>& attrs_map
+     );
+
+    /// @brief Reads a text projection with all ranks of comm and returns
+    ///        the edges read by this rank grouped by destination, in the
+    ///        same form as read_txt_projection. Collective on comm.
+    ///
+    /// Each destination may have edges on several ranks; the edges are
+    /// brought together by destination when they are written with
+    /// graph::append_graph or graph::write_graph.
+    int read_txt_edges
+    (
+     MPI_Comm              comm,
+     const std::string&    file_name,
+     const std::map <std::string, std::vector <size_t> >& num_attrs,
+     std::vector<NODE_IDX_T>& dst_idx,
+     std::vector<DST_PTR_T>&  src_idx_ptr,
+     std::vector<NODE_IDX_T>& src_idx,
+     std::map <std::string, data::AttrVal>& attrs_map
+     );
+
+  }
+}
+
+#endif
@@ -0,0 +1,65 @@
+// -*- mode: c++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+//==============================================================================
+///  @file txt_tokenizer.hh
+///
+///  Tokenizer for blank-separated numeric text records, one per line.
+///
+///  Copyright (C) 2016-2025 Project NeuroH5.
+//==============================================================================
+
+#ifndef TXT_TOKENIZER_HH
+#define TXT_TOKENIZER_HH
+
+#include <charconv>
+#include <cstring>
+#include <system_error>
+
+namespace neuroh5
+{
+  namespace io
+  {
+
+    inline bool is_blank (const char c)
+    {
+      return (c == ' ') || (c == '\t') || (c == '\r');
+    }
+
+    /// Returns the first position at or after p that is not a blank
+    inline const char* skip_blanks (const char* p, const char* end)
+    {
+      while ((p < end) && is_blank(*p))
+        {
+          p++;
+        }
+      return p;
+    }
+
+    /// Returns the position of the newline ending the line that
+    /// contains p, or end for an unterminated last line
+    inline const char* find_line_end (const char* p, const char* end)
+    {
+      const void* q = memchr(p, '\n', end - p);
+      return (q == nullptr) ? end : static_cast<const char*>(q);
+    }
+
+    /// Parses the next blank-separated value in [p, end) with
+    /// std::from_chars, and advances p past it. Returns false if the next
+    /// token is missing or is not a complete value of type T.
+    template <class T>
+    inline bool parse_token (const char*& p, const char* end, T& value)
+    {
+      const char* q = skip_blanks(p, end);
+      std::from_chars_result result = std::from_chars(q, end, value);
+      if ((result.ec != std::errc()) ||
+          ((result.ptr < end) && !is_blank(*result.ptr)))
+        {
+          return false;
+        }
+      p = result.ptr;
+      return true;
+    }
+
+  }
+}
+
+#endif
@@ -16,6 +16,7 @@
 #include <map>
 
 #include "mpi_debug.hh"
+#include "phase_stats.hh"
 #include "throw_assert.hh"
 #include "neuroh5_types.hh"
 #include "attr_map.hh"
@@ -83,6 +84,13 @@ namespace neuroh5
 
       //assert(recvbuf_size > 0);
       recvbuf.resize(recvbuf_size, 0);
+      if (stats_enabled())
+        {
+          int myrank;
+          MPI_Comm_rank(comm, &myrank);
+          vector<size_t> sendcounts(size, sendcount);
+          count_exchange<T>(myrank, sendcounts, recvcounts);
+        }
 
       {
         int status;
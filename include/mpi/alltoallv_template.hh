@@ -18,10 +18,12 @@
 #include <cstdio>
 
 #include "mpi_debug.hh"
+#include "phase_stats.hh"
 #include "throw_assert.hh"
 #include "neuroh5_types.hh"
 #include "attr_map.hh"
 #include "chunk_info.hh"
+#include "node_topology.hh"
 
 using namespace std;
 
@@ -85,6 +87,7 @@ namespace neuroh5
         }
 
       recvbuf.resize(recvbuf_size, 0);
+      count_exchange<T>(myrank, sendcounts, recvcounts);
 
       {
         // 3. Perform the actual data exchange in chunks using point-to-point
@@ -177,6 +180,583 @@ namespace neuroh5
 
       return MPI_SUCCESS;
     }
+
+    /// @brief Exchanges the send counts of a sparse all-to-all pattern.
+    ///
+    /// Each rank obtains the number of ranks that send to it with a single
+    /// reduce-scatter, and then receives the counts by point-to-point
+    /// messages from those ranks only. A rank sends its counts only after
+    /// the reduce-scatter has completed, which requires that all ranks have
+    /// entered it; hence count messages of consecutive exchanges cannot be
+    /// confused.
+    inline void sparse_exchange_counts (MPI_Comm comm,
+                                        const vector<size_t>& sendcounts,
+                                        vector<size_t>& recvcounts)
+    {
+      int ssize; size_t size;
+      throw_assert(MPI_Comm_size(comm, &ssize) == MPI_SUCCESS,
+                   "sparse_alltoallv: unable to obtain size of MPI communicator");
+      size = ssize;
+      int myrank;
+      MPI_Comm_rank(comm, &myrank);
+
+      const int count_tag = 9879;
+
+      recvcounts.assign(size, 0);
+
+      // Determine the number of ranks that send to this rank
+      int num_senders = 0;
+      {
+        vector<int> send_flags(size, 0);
+        for (size_t i = 0; i < size; ++i)
+          {
+            if (((int)i != myrank) && (sendcounts[i] > 0))
+              send_flags[i] = 1;
+          }
+        MPI_Request request;
+        int status = MPI_Ireduce_scatter_block(&send_flags[0], &num_senders, 1, MPI_INT,
+                                               MPI_SUM, comm, &request);
+        throw_assert(status == MPI_SUCCESS,
+                     "sparse_alltoallv: error in MPI_Ireduce_scatter_block: status: " << status);
+        status = MPI_Wait(&request, MPI_STATUS_IGNORE);
+        throw_assert(status == MPI_SUCCESS,
+                     "sparse_alltoallv: error in MPI_Wait: status: " << status);
+      }
+
+      // Exchange counts with the sending ranks only
+      {
+        vector<size_t> count_recvbuf(num_senders, 0);
+        vector<MPI_Request> reqs;
+        for (int j = 0; j < num_senders; ++j)
+          {
+            MPI_Request r;
+            int status = MPI_Irecv(&count_recvbuf[j], 1, MPI_SIZE_T, MPI_ANY_SOURCE,
+                                   count_tag, comm, &r);
+            throw_assert(status == MPI_SUCCESS,
+                         "sparse_alltoallv: error in MPI_Irecv: status: " << status);
+            reqs.push_back(r);
+          }
+        for (size_t i = 0; i < size; ++i)
+          {
+            if (((int)i != myrank) && (sendcounts[i] > 0))
+              {
+                MPI_Request r;
+                int status = MPI_Isend(const_cast<size_t*>(&sendcounts[i]), 1, MPI_SIZE_T,
+                                       (int)i, count_tag, comm, &r);
+                throw_assert(status == MPI_SUCCESS,
+                             "sparse_alltoallv: error in MPI_Isend: status: " << status);
+                reqs.push_back(r);
+              }
+          }
+        vector<MPI_Status> statuses(reqs.size());
+        if (!reqs.empty())
+          {
+            int status = MPI_Waitall((int)reqs.size(), &reqs[0], &statuses[0]);
+            throw_assert(status == MPI_SUCCESS,
+                         "sparse_alltoallv: error in MPI_Waitall: status: " << status);
+          }
+        for (int j = 0; j < num_senders; ++j)
+          {
+            recvcounts[statuses[j].MPI_SOURCE] = count_recvbuf[j];
+          }
+        recvcounts[myrank] = sendcounts[myrank];
+      }
+    }
+
+    /// @brief Exchanges data in the same way as alltoallv_vector, for the
+    ///        case where only a few ranks have data to send.
+    ///
+    /// The counts are exchanged with sparse_exchange_counts instead of
+    /// an all-to-all, and the data is sent in messages of at most
+    /// NEUROH5_CHUNK_SIZE elements, without the global synchronization
+    /// between chunks that alltoallv_vector performs.
+    template<class T>
+    int sparse_alltoallv_vector (MPI_Comm comm,
+                                 const MPI_Datatype datatype,
+                                 const vector<size_t>& sendcounts,
+                                 const vector<size_t>& sdispls,
+                                 const vector<T>& sendbuf,
+                                 vector<size_t>& recvcounts,
+                                 vector<size_t>& rdispls,
+                                 vector<T>& recvbuf)
+    {
+      int ssize; size_t size;
+      throw_assert(MPI_Comm_size(comm, &ssize) == MPI_SUCCESS,
+                   "sparse_alltoallv: unable to obtain size of MPI communicator");
+      throw_assert_nomsg(ssize > 0);
+      size = ssize;
+      int myrank;
+      MPI_Comm_rank(comm, &myrank);
+
+      rdispls.assign(size,0);
+
+      const int data_tag = 9878;
+
+      sparse_exchange_counts(comm, sendcounts, recvcounts);
+
+      size_t recvbuf_size = recvcounts[0];
+      for (size_t p = 1; p < size; ++p)
+        {
+          rdispls[p] = rdispls[p-1] + recvcounts[p-1];
+          recvbuf_size += recvcounts[p];
+        }
+
+      recvbuf.resize(recvbuf_size, 0);
+      count_exchange<T>(myrank, sendcounts, recvcounts);
+
+      if (recvcounts[myrank] > 0)
+        {
+          std::memcpy(&recvbuf[rdispls[myrank]], &sendbuf[sdispls[myrank]],
+                      recvcounts[myrank] * sizeof(T));
+        }
+
+      // Point-to-point data transfer between the ranks that have
+      // nonzero counts
+      {
+        const size_t chunk_size = data::get_chunk_size();
+        vector<MPI_Request> reqs;
+        for (size_t i = 0; i < size; ++i)
+          {
+            if ((int)i == myrank) continue;
+            for (size_t pos = 0; pos < recvcounts[i]; pos += chunk_size)
+              {
+                MPI_Request r;
+                int status = MPI_Irecv(&recvbuf[rdispls[i] + pos],
+                                       (int)std::min(recvcounts[i] - pos, chunk_size), datatype,
+                                       (int)i, data_tag, comm, &r);
+                throw_assert(status == MPI_SUCCESS,
+                             "sparse_alltoallv: error in MPI_Irecv: status: " << status);
+                reqs.push_back(r);
+              }
+          }
+        for (size_t i = 0; i < size; ++i)
+          {
+            if ((int)i == myrank) continue;
+            for (size_t pos = 0; pos < sendcounts[i]; pos += chunk_size)
+              {
+                MPI_Request r;
+                const T* send_ptr = &sendbuf[sdispls[i] + pos];
+                int status = MPI_Isend(const_cast<T*>(send_ptr),
+                                       (int)std::min(sendcounts[i] - pos, chunk_size), datatype,
+                                       (int)i, data_tag, comm, &r);
+                throw_assert(status == MPI_SUCCESS,
+                             "sparse_alltoallv: error in MPI_Isend: status: " << status);
+                reqs.push_back(r);
+              }
+          }
+        if (!reqs.empty())
+          {
+            int status = MPI_Waitall((int)reqs.size(), &reqs[0], MPI_STATUSES_IGNORE);
+            throw_assert(status == MPI_SUCCESS,
+                         "sparse_alltoallv: error in MPI_Waitall: status: " << status);
+          }
+      }
+
+      return MPI_SUCCESS;
+    }
+
+    /// @brief Starts a nonblocking exchange of the same form as
+    ///        sparse_alltoallv_vector. The counts are exchanged before returning;
+    ///        the data transfers are left pending in requests, and sendbuf
+    ///        and recvbuf must not be modified until MPI_Waitall has
+    ///        completed them.
+    template<class T>
+    int ialltoallv_vector (MPI_Comm comm,
+                           const MPI_Datatype datatype,
+                           const vector<size_t>& sendcounts,
+                           const vector<size_t>& sdispls,
+                           const vector<T>& sendbuf,
+                           vector<size_t>& recvcounts,
+                           vector<size_t>& rdispls,
+                           vector<T>& recvbuf,
+                           vector<MPI_Request>& requests)
+    {
+      int ssize; size_t size;
+      throw_assert(MPI_Comm_size(comm, &ssize) == MPI_SUCCESS,
+                   "ialltoallv: unable to obtain size of MPI communicator");
+      throw_assert_nomsg(ssize > 0);
+      size = ssize;
+      int myrank;
+      MPI_Comm_rank(comm, &myrank);
+
+      rdispls.assign(size,0);
+
+      sparse_exchange_counts(comm, sendcounts, recvcounts);
+
+      size_t recvbuf_size = recvcounts[0];
+      for (size_t p = 1; p < size; ++p)
+        {
+          rdispls[p] = rdispls[p-1] + recvcounts[p-1];
+          recvbuf_size += recvcounts[p];
+        }
+
+      recvbuf.resize(recvbuf_size, 0);
+      count_exchange<T>(myrank, sendcounts, recvcounts);
+
+      if (recvcounts[myrank] > 0)
+        {
+          throw_assert(recvcounts[myrank] == sendcounts[myrank],
+                       "ialltoallv: send/receive count mismatch for current rank");
+          std::memcpy(&recvbuf[rdispls[myrank]], &sendbuf[sdispls[myrank]],
+                      recvcounts[myrank] * sizeof(T));
+        }
+
+      // Messages larger than NEUROH5_CHUNK_SIZE are split in several
+      // sends; MPI message ordering guarantees that they are matched in
+      // order.
+      const size_t chunk_size = data::get_chunk_size();
+      const int mpi_tag = 9877;
+
+      for (size_t i = 0; i < size; ++i)
+        {
+          if ((int)i == myrank) continue;
+          for (size_t pos = 0; pos < recvcounts[i]; pos += chunk_size)
+            {
+              MPI_Request r;
+              int status = MPI_Irecv(&recvbuf[rdispls[i] + pos],
+                                     (int)std::min(recvcounts[i] - pos, chunk_size), datatype,
+                                     (int)i, mpi_tag, comm, &r);
+              throw_assert(status == MPI_SUCCESS,
+                           "ialltoallv: error in MPI_Irecv: status: " << status);
+              requests.push_back(r);
+            }
+        }
+      for (size_t i = 0; i < size; ++i)
+        {
+          if ((int)i == myrank) continue;
+          for (size_t pos = 0; pos < sendcounts[i]; pos += chunk_size)
+            {
+              MPI_Request r;
+              const T* send_ptr = &sendbuf[sdispls[i] + pos];
+              int status = MPI_Isend(const_cast<T*>(send_ptr),
+                                     (int)std::min(sendcounts[i] - pos, chunk_size), datatype,
+                                     (int)i, mpi_tag, comm, &r);
+              throw_assert(status == MPI_SUCCESS,
+                           "ialltoallv: error in MPI_Isend: status: " << status);
+              requests.push_back(r);
+            }
+        }
+
+      return MPI_SUCCESS;
+    }
+
+    /// @brief Receive buffer of node_alltoallv_vector and
+    ///        scatter_alltoallv_vector.
+    ///
+    /// The buffer is either the vector values, or the part of a
+    /// shared-memory window of the node that belongs to the calling rank.
+    /// A window is released by free(), which is collective on the ranks of
+    /// the node; a buffer destroyed without free() leaves its window
+    /// allocated rather than making a collective call.
+    template<class T>
+    class RecvBuffer
+    {
+    public:
+      vector<T> values;
+
+      RecvBuffer () : win_(MPI_WIN_NULL), base_(nullptr), size_(0) {}
+
+      RecvBuffer (const RecvBuffer&) = delete;
+      RecvBuffer& operator= (const RecvBuffer&) = delete;
+
+      const T* data () const { return (win_ == MPI_WIN_NULL) ? values.data() : base_; }
+      size_t size () const { return (win_ == MPI_WIN_NULL) ? values.size() : size_; }
+      MPI_Win window () const { return win_; }
+
+      /// Allocates size elements in a shared-memory window on node_comm;
+      /// collective on node_comm.
+      T* allocate_shared (MPI_Comm node_comm, size_t size)
+      {
+        throw_assert_nomsg(win_ == MPI_WIN_NULL);
+        values.clear();
+        throw_assert(MPI_Win_allocate_shared(size * sizeof(T), sizeof(T), MPI_INFO_NULL,
+                                             node_comm, &base_, &win_) == MPI_SUCCESS,
+                     "RecvBuffer: error in MPI_Win_allocate_shared");
+        size_ = size;
+        return base_;
+      }
+
+      /// Releases the buffer; collective on the node if it is a window.
+      void free ()
+      {
+        if (win_ != MPI_WIN_NULL)
+          {
+            throw_assert(MPI_Win_free(&win_) == MPI_SUCCESS,
+                         "RecvBuffer: error in MPI_Win_free");
+            base_ = nullptr;
+            size_ = 0;
+          }
+        values.clear();
+        values.shrink_to_fit();
+      }
+
+    private:
+      MPI_Win win_;
+      T* base_;
+      size_t size_;
+    };
+
+    /// @brief Exchanges data in the same way as sparse_alltoallv_vector,
+    ///        aggregated by shared-memory node.
+    ///
+    /// The receive buffers of the ranks of a node are held in one MPI-3
+    /// shared-memory window on the node, and recvbuf is left holding the
+    /// part of the calling rank. A rank stores the data for the ranks of
+    /// its own node directly into the window. The data for the ranks of
+    /// another node is sent in a single message, described by an indexed
+    /// datatype over sendbuf, and is received by one rank of that node,
+    /// chosen by the sender rank, directly into the receive buffers of the
+    /// destination ranks. Thus only one message per sending rank and node
+    /// crosses the network, no data is packed or copied on either side,
+    /// and the receives of a node are spread over its ranks.
+    ///
+    /// Each element of datatype must occupy sizeof(T) bytes, and each
+    /// contiguous block of the message holds at most NEUROH5_CHUNK_SIZE
+    /// elements.
+    template<class T>
+    int node_alltoallv_vector (MPI_Comm comm,
+                               const NodeTopology& topology,
+                               const MPI_Datatype datatype,
+                               const vector<size_t>& sendcounts,
+                               const vector<size_t>& sdispls,
+                               const vector<T>& sendbuf,
+                               vector<size_t>& recvcounts,
+                               vector<size_t>& rdispls,
+                               RecvBuffer<T>& recvbuf)
+    {
+      int ssize; size_t size;
+      throw_assert(MPI_Comm_size(comm, &ssize) == MPI_SUCCESS,
+                   "node_alltoallv: unable to obtain size of MPI communicator");
+      throw_assert_nomsg(ssize > 0);
+      size = ssize;
+      int myrank;
+      MPI_Comm_rank(comm, &myrank);
+
+      rdispls.assign(size,0);
+
+      const int data_tag = 9880;
+
+      sparse_exchange_counts(comm, sendcounts, recvcounts);
+
+      size_t recvbuf_size = recvcounts[0];
+      for (size_t p = 1; p < size; ++p)
+        {
+          rdispls[p] = rdispls[p-1] + recvcounts[p-1];
+          recvbuf_size += recvcounts[p];
+        }
+
+      const int node_size = topology.node_size;
+      const int node_leader = topology.node_ranks[0];
+
+      // The receive counts of the ranks of this node, as (source,
+      // count) pairs in source order
+      vector<uint64_t> recv_pairs;
+      for (size_t i = 0; i < size; ++i)
+        {
+          if (recvcounts[i] > 0)
+            {
+              recv_pairs.push_back(i);
+              recv_pairs.push_back(recvcounts[i]);
+            }
+        }
+      int num_recv_pairs = recv_pairs.size();
+      vector<int> node_pair_counts(node_size, 0), node_pair_displs(node_size+1, 0);
+      throw_assert(MPI_Allgather(&num_recv_pairs, 1, MPI_INT, &node_pair_counts[0], 1, MPI_INT,
+                                 topology.node_comm) == MPI_SUCCESS,
+                   "node_alltoallv: error in MPI_Allgather");
+      for (int q = 0; q < node_size; ++q)
+        {
+          node_pair_displs[q+1] = node_pair_displs[q] + node_pair_counts[q];
+        }
+      vector<uint64_t> node_recv_pairs(std::max(node_pair_displs[node_size], 1));
+      throw_assert(MPI_Allgatherv(recv_pairs.data(), num_recv_pairs, MPI_UINT64_T,
+                                  &node_recv_pairs[0], &node_pair_counts[0], &node_pair_displs[0],
+                                  MPI_UINT64_T, topology.node_comm) == MPI_SUCCESS,
+                   "node_alltoallv: error in MPI_Allgatherv");
+
+      // The receive buffers of the node
+      recvbuf.allocate_shared(topology.node_comm, recvbuf_size);
+      vector<T*> node_bases(node_size, nullptr);
+      for (int q = 0; q < node_size; ++q)
+        {
+          MPI_Aint window_size; int disp_unit;
+          throw_assert(MPI_Win_shared_query(recvbuf.window(), q, &window_size, &disp_unit,
+                                            &node_bases[q]) == MPI_SUCCESS,
+                       "node_alltoallv: error in MPI_Win_shared_query");
+        }
+
+      // The location and count of the data from each source in the
+      // receive buffers of the ranks of this node, in rank order
+      map<int, vector< pair<T*, size_t> > > node_recv_parts;
+      for (int q = 0; q < node_size; ++q)
+        {
+          size_t offset = 0;
+          for (int k = node_pair_displs[q]; k < node_pair_displs[q+1]; k += 2)
+            {
+              const int src = node_recv_pairs[k];
+              const size_t count = node_recv_pairs[k+1];
+              node_recv_parts[src].push_back(make_pair(node_bases[q] + offset, count));
+              offset += count;
+            }
+        }
+
+      throw_assert(MPI_Win_fence(MPI_MODE_NOPRECEDE, recvbuf.window()) == MPI_SUCCESS,
+                   "node_alltoallv: error in MPI_Win_fence");
+
+      const size_t chunk_size = data::get_chunk_size();
+      vector<MPI_Request> reqs;
+      vector<MPI_Datatype> types;
+      uint64_t bytes_sent = 0, bytes_recv = 0, messages_sent = 0, messages_recv = 0;
+
+      // Creates a datatype of the blocks at the given byte displacements,
+      // split in blocks of at most chunk_size elements
+      auto create_blocks_type = [&] (const vector< pair<MPI_Aint, size_t> >& blocks)
+        {
+          vector<int> block_lengths;
+          vector<MPI_Aint> block_displs;
+          for (const auto& block : blocks)
+            {
+              for (size_t pos = 0; pos < block.second; pos += chunk_size)
+                {
+                  block_lengths.push_back((int)std::min(block.second - pos, chunk_size));
+                  block_displs.push_back(block.first + (MPI_Aint)(pos * sizeof(T)));
+                }
+            }
+          MPI_Datatype type;
+          throw_assert(MPI_Type_create_hindexed((int)block_lengths.size(), &block_lengths[0],
+                                                &block_displs[0], datatype, &type) == MPI_SUCCESS,
+                       "node_alltoallv: error in MPI_Type_create_hindexed");
+          throw_assert(MPI_Type_commit(&type) == MPI_SUCCESS,
+                       "node_alltoallv: error in MPI_Type_commit");
+          types.push_back(type);
+          return type;
+        };
+
+      // This rank receives the data of the sources of other nodes
+      // assigned to it, at their absolute addresses in the window
+      for (const auto& src_parts : node_recv_parts)
+        {
+          const int src = src_parts.first;
+          if ((topology.rank_leaders[src] == node_leader) ||
+              (topology.node_ranks[src % node_size] != myrank))
+            continue;
+          vector< pair<MPI_Aint, size_t> > blocks;
+          size_t count = 0;
+          for (const auto& part : src_parts.second)
+            {
+              MPI_Aint address;
+              throw_assert_nomsg(MPI_Get_address(part.first, &address) == MPI_SUCCESS);
+              blocks.push_back(make_pair(address, part.second));
+              count += part.second;
+            }
+          MPI_Request r;
+          int status = MPI_Irecv(MPI_BOTTOM, 1, create_blocks_type(blocks),
+                                 src, data_tag, comm, &r);
+          throw_assert(status == MPI_SUCCESS,
+                       "node_alltoallv: error in MPI_Irecv: status: " << status);
+          reqs.push_back(r);
+          bytes_recv += count * sizeof(T);
+          messages_recv++;
+        }
+
+      // The data for the ranks of each other node, in rank order, which
+      // is the order of their receive buffers in the window
+      map<int, vector< pair<MPI_Aint, size_t> > > node_send_blocks;
+      for (size_t j = 0; j < size; ++j)
+        {
+          if ((sendcounts[j] > 0) && (topology.rank_leaders[j] != node_leader))
+            {
+              node_send_blocks[topology.rank_leaders[j]].push_back
+                (make_pair((MPI_Aint)(sdispls[j] * sizeof(T)), sendcounts[j]));
+              bytes_sent += sendcounts[j] * sizeof(T);
+            }
+        }
+      for (const auto& send_blocks : node_send_blocks)
+        {
+          const vector<int>& members = topology.node_members.at(send_blocks.first);
+          const int dest = members[myrank % members.size()];
+          MPI_Request r;
+          int status = MPI_Isend(const_cast<T*>(sendbuf.data()), 1,
+                                 create_blocks_type(send_blocks.second),
+                                 dest, data_tag, comm, &r);
+          throw_assert(status == MPI_SUCCESS,
+                       "node_alltoallv: error in MPI_Isend: status: " << status);
+          reqs.push_back(r);
+          messages_sent++;
+        }
+
+      // The data for the ranks of this node is stored in the window
+      {
+        const vector< pair<T*, size_t> >& parts = node_recv_parts[myrank];
+        size_t k = 0;
+        for (int q = 0; q < node_size; ++q)
+          {
+            const int dst = topology.node_ranks[q];
+            if (sendcounts[dst] == 0)
+              continue;
+            throw_assert_nomsg((k < parts.size()) && (parts[k].second == sendcounts[dst]));
+            std::memcpy(parts[k].first, &sendbuf[sdispls[dst]], sendcounts[dst] * sizeof(T));
+            k++;
+          }
+      }
+
+      if (!reqs.empty())
+        {
+          int status = MPI_Waitall((int)reqs.size(), &reqs[0], MPI_STATUSES_IGNORE);
+          throw_assert(status == MPI_SUCCESS,
+                       "node_alltoallv: error in MPI_Waitall: status: " << status);
+        }
+      for (MPI_Datatype& type : types)
+        {
+          throw_assert_nomsg(MPI_Type_free(&type) == MPI_SUCCESS);
+        }
+      count_sent(bytes_sent, messages_sent);
+      count_recv(bytes_recv, messages_recv);
+
+      // makes the stores of all ranks of the node visible
+      throw_assert(MPI_Win_fence(MPI_MODE_NOSUCCEED, recvbuf.window()) == MPI_SUCCESS,
+                   "node_alltoallv: error in MPI_Win_fence");
+
+      return MPI_SUCCESS;
+    }
+
+    /// @brief Same as above, over the shared-memory nodes of comm, whose
+    ///        topology is cached on comm.
+    template<class T>
+    int node_alltoallv_vector (MPI_Comm comm,
+                               const MPI_Datatype datatype,
+                               const vector<size_t>& sendcounts,
+                               const vector<size_t>& sdispls,
+                               const vector<T>& sendbuf,
+                               vector<size_t>& recvcounts,
+                               vector<size_t>& rdispls,
+                               RecvBuffer<T>& recvbuf)
+    {
+      return node_alltoallv_vector<T>(comm, node_topology(comm), datatype, sendcounts, sdispls, sendbuf,
+                                      recvcounts, rdispls, recvbuf);
+    }
+
+    /// @brief Exchanges the data of a scatter read: with
+    ///        node_alltoallv_vector if NEUROH5_NODE_EXCHANGE is set, and
+    ///        otherwise with sparse_alltoallv_vector into recvbuf.values.
+    template<class T>
+    int scatter_alltoallv_vector (MPI_Comm comm,
+                                  const MPI_Datatype datatype,
+                                  const vector<size_t>& sendcounts,
+                                  const vector<size_t>& sdispls,
+                                  const vector<T>& sendbuf,
+                                  vector<size_t>& recvcounts,
+                                  vector<size_t>& rdispls,
+                                  RecvBuffer<T>& recvbuf)
+    {
+      if (data::get_node_exchange())
+        {
+          return node_alltoallv_vector<T>(comm, datatype, sendcounts, sdispls, sendbuf,
+                                          recvcounts, rdispls, recvbuf);
+        }
+      return sparse_alltoallv_vector<T>(comm, datatype, sendcounts, sdispls, sendbuf,
+                                        recvcounts, rdispls, recvbuf.values);
+    }
   }
 }
 
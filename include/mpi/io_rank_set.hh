@@ -0,0 +1,63 @@
+// -*- mode: c++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+//==============================================================================
+///  @file io_rank_set.hh
+///
+///  Selection of the ranks that perform collective I/O, spread over the
+///  shared-memory nodes of a communicator.
+///
+///  Copyright (C) 2016-2025 Project NeuroH5.
+//==============================================================================
+
+#ifndef IO_RANK_SET_HH
+#define IO_RANK_SET_HH
+
+#include <mpi.h>
+
+#include <set>
+#include <vector>
+
+namespace neuroh5
+{
+
+  namespace mpi
+  {
+
+    /// @brief Selects io_size ranks spread evenly over nodes.
+    ///
+    /// The I/O ranks are divided among the nodes as evenly as the node
+    /// sizes allow, and are evenly spaced within each node, starting with
+    /// the lowest rank of the node. If io_size is less than the number of
+    /// nodes, one rank is selected on each of io_size evenly spaced
+    /// nodes. The lowest rank is always selected.
+    ///
+    /// @param rank_nodes     Node index of each rank, in rank order
+    ///
+    /// @param io_size        Requested number of I/O ranks
+    ///
+    /// @param io_rank_set    Updated with the selected ranks
+    void node_range_sample
+    (
+     const std::vector<int>& rank_nodes,
+     size_t                  io_size,
+     std::set<size_t>&       io_rank_set
+     );
+
+    /// @brief Selects io_size ranks of comm spread evenly over its
+    ///        shared-memory nodes, as determined by
+    ///        MPI_Comm_split_type(MPI_COMM_TYPE_SHARED). Collective on comm.
+    ///
+    /// Unlike data::range_sample, which spaces the I/O ranks by rank
+    /// number only, this places at most the fair share of I/O ranks on
+    /// each node, so that the file system bandwidth of every node is
+    /// used and no node is left to receive all of its data from others.
+    void select_io_ranks
+    (
+     MPI_Comm                comm,
+     size_t                  io_size,
+     std::set<size_t>&       io_rank_set
+     );
+
+  }
+}
+
+#endif
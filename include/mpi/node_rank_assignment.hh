@@ -0,0 +1,94 @@
+// -*- mode: c++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+//==============================================================================
+///  @file node_rank_assignment.hh
+///
+///  Weight-balanced assignment of graph nodes to MPI ranks.
+///
+///  Copyright (C) 2016-2025 Project NeuroH5.
+//==============================================================================
+
+#ifndef NODE_RANK_ASSIGNMENT_HH
+#define NODE_RANK_ASSIGNMENT_HH
+
+#include <mpi.h>
+
+#include <map>
+#include <set>
+#include <string>
+#include <vector>
+
+#include "neuroh5_types.hh"
+
+namespace neuroh5
+{
+
+  namespace mpi
+  {
+
+    /// Strategies for the assignment of nodes to ranks.
+    enum NodeRankStrategy
+      {
+        // nodes in index order, dealt to ranks in turn
+        NodeRankRoundRobin,
+        // nodes in order of decreasing weight, dealt to ranks in
+        // serpentine order (greedy approximation of bin packing)
+        NodeRankGreedy,
+        // contiguous ranges of equal weight along a Hilbert curve through
+        // the node coordinates
+        NodeRankHilbert,
+        // as NodeRankHilbert (or node index order if no coordinates are
+        // given), with ranks ordered by shared-memory node so that
+        // neighboring ranges are placed on the same host
+        NodeRankHierarchical
+      };
+
+    /// Returns the strategy with the given name: "round_robin", "greedy",
+    /// "hilbert" or "hierarchical".
+    NodeRankStrategy parse_node_rank_strategy (const std::string& name);
+
+    /// A node to be assigned; weight is, for instance, the in-degree of
+    /// the node or the size of its tree, and coords are the soma
+    /// coordinates used by the space-filling curve strategies. Entries
+    /// for the same node given by several ranks are combined by summing
+    /// their weights.
+    struct NodeRankInput
+    {
+      NODE_IDX_T node;
+      double     weight;
+      float      coords[3];
+    };
+
+    /// @brief Assigns the nodes given by all ranks of comm to the ranks in
+    ///        rank_set.
+    ///
+    /// The nodes are ordered with a distributed sample sort, so that no
+    /// rank holds more than its share of the node list.
+    ///
+    /// @param comm           MPI communicator
+    ///
+    /// @param rank_set       Ranks to which nodes are assigned
+    ///
+    /// @param local_nodes    Nodes given by this rank
+    ///
+    /// @param strategy       Assignment strategy
+    ///
+    /// @param total_num_nodes Updated with the number of distinct nodes
+    ///
+    /// @param node_rank_map  Updated with the rank of each node in local_nodes
+    ///
+    /// @param assigned_nodes Updated with the sorted nodes assigned to this rank
+    void assign_node_ranks
+    (
+     MPI_Comm comm,
+     const std::set<size_t> &rank_set,
+     const std::vector<NodeRankInput> &local_nodes,
+     const NodeRankStrategy strategy,
+     size_t &total_num_nodes,
+     std::map<NODE_IDX_T, rank_t> &node_rank_map,
+     std::vector<NODE_IDX_T> &assigned_nodes
+     );
+
+  }
+}
+
+#endif
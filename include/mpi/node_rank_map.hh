@@ -29,6 +29,10 @@ namespace neuroh5
   {
 
 
+    /// Assigns the nodes in local_node_index of all ranks to the ranks in
+    /// rank_set in round-robin manner. node_rank_map is updated with the
+    /// ranks of the local nodes only. See node_rank_assignment.hh for
+    /// weight-balanced strategies.
     void compute_node_rank_map
     (
      MPI_Comm comm,
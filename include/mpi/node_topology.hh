@@ -0,0 +1,55 @@
+// -*- mode: c++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+//==============================================================================
+///  @file node_topology.hh
+///
+///  The shared-memory nodes of a communicator, as used by the
+///  node-aggregated exchange.
+///
+///  Copyright (C) 2016-2025 Project NeuroH5.
+//==============================================================================
+
+#ifndef NODE_TOPOLOGY_HH
+#define NODE_TOPOLOGY_HH
+
+#include <mpi.h>
+
+#include <map>
+#include <vector>
+
+namespace neuroh5
+{
+
+  namespace mpi
+  {
+
+    /// @brief The partition of the ranks of a communicator into nodes.
+    ///
+    /// A node is identified by its leader, its lowest rank. The ranks of
+    /// node_comm must be in the order of comm.
+    struct NodeTopology
+    {
+      /// Collective on comm; node_comm is not freed by the topology
+      NodeTopology (MPI_Comm comm, MPI_Comm node_comm);
+
+      MPI_Comm node_comm;
+      int node_rank, node_size;
+      /// ranks of comm on this node, in rank order
+      std::vector<int> node_ranks;
+      /// leader of the node of each rank of comm
+      std::vector<int> rank_leaders;
+      /// ranks of comm on each node, in rank order, by node leader
+      std::map<int, std::vector<int> > node_members;
+    };
+
+    /// @brief Returns the topology of the nodes of comm, as determined by
+    ///        MPI_Comm_split_type(MPI_COMM_TYPE_SHARED).
+    ///
+    /// The topology is computed at the first call on comm, which is
+    /// collective, and is cached as an attribute of comm; its node
+    /// communicator is freed when comm is freed.
+    const NodeTopology& node_topology (MPI_Comm comm);
+
+  }
+}
+
+#endif
@@ -0,0 +1,155 @@
+// -*- mode: c++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+//==============================================================================
+///  @file phase_stats.hh
+///
+///  Runtime instrumentation of the phases of collective reads and writes:
+///  wall time, bytes read and written, bytes and messages exchanged, and
+///  peak resident set size, aggregated over the ranks of a communicator.
+///
+///  Copyright (C) 2016-2025 Project NeuroH5.
+//==============================================================================
+
+#ifndef PHASE_STATS_HH
+#define PHASE_STATS_HH
+
+#include <mpi.h>
+
+#include <cstdint>
+#include <map>
+#include <string>
+#include <vector>
+
+namespace neuroh5
+{
+
+  namespace mpi
+  {
+
+    /// Counters of one phase on one rank
+    struct PhaseCounters
+    {
+      double   time          = 0.0;
+      uint64_t calls         = 0;
+      uint64_t bytes_read    = 0;
+      uint64_t bytes_written = 0;
+      uint64_t bytes_sent    = 0;
+      uint64_t bytes_recv    = 0;
+      uint64_t messages_sent = 0;
+      uint64_t messages_recv = 0;
+    };
+
+    /// Distribution of one counter over the ranks of a communicator;
+    /// imbalance is max / mean, and 1 if the mean is zero
+    struct StatSummary
+    {
+      double min = 0.0, mean = 0.0, max = 0.0, imbalance = 1.0;
+    };
+
+    /// Aggregated statistics, by phase name and then by counter name
+    struct StatsReport
+    {
+      int         num_ranks = 0;
+      StatSummary peak_rss_bytes;
+      std::map<std::string, std::map<std::string, StatSummary> > phases;
+    };
+
+    /// Names of the counters of PhaseCounters, in declaration order
+    extern const std::vector<std::string> phase_counter_names;
+
+    extern bool stats_enabled_flag;
+
+    /// Statistics are collected if the environment variable NEUROH5_STATS
+    /// is set to a nonzero value when the library is loaded, or after a
+    /// call to enable_stats(true). When disabled, the instrumentation
+    /// costs one branch per call.
+    inline bool stats_enabled () { return stats_enabled_flag; }
+
+    void enable_stats (bool enabled);
+
+    /// Discards the counters of all phases
+    void reset_stats ();
+
+    /// @brief Measures the wall time of a phase from construction to
+    ///        destruction.
+    ///
+    /// Phases nest: a phase started while another is running is recorded
+    /// under the name "outer/inner", and its time is also included in the
+    /// outer phase. Bytes and messages are counted in the innermost
+    /// running phase only. Phases nest per thread, and the counters of
+    /// all threads are summed per process.
+    class PhaseTimer
+    {
+    public:
+      explicit PhaseTimer (const char* name);
+      ~PhaseTimer ();
+
+      PhaseTimer (const PhaseTimer&) = delete;
+      PhaseTimer& operator= (const PhaseTimer&) = delete;
+
+    private:
+      bool   active;
+      double start;
+    };
+
+    /// Counts bytes read from or written to a file in the current phase
+    void count_read (uint64_t bytes);
+    void count_write (uint64_t bytes);
+
+    /// Counts bytes and point-to-point messages exchanged with other
+    /// ranks in the current phase
+    void count_sent (uint64_t bytes, uint64_t messages);
+    void count_recv (uint64_t bytes, uint64_t messages);
+
+    /// Counts the data exchanged by an all-to-all with the given element
+    /// counts per rank, excluding the part that stays on this rank
+    template<class T>
+    inline void count_exchange (int rank,
+                                const std::vector<size_t>& sendcounts,
+                                const std::vector<size_t>& recvcounts)
+    {
+      if (!stats_enabled())
+        return;
+      uint64_t bytes_sent = 0, bytes_recv = 0, messages_sent = 0, messages_recv = 0;
+      for (size_t i = 0; i < sendcounts.size(); i++)
+        {
+          if ((int)i == rank) continue;
+          if (sendcounts[i] > 0)
+            {
+              bytes_sent += sendcounts[i] * sizeof(T);
+              messages_sent++;
+            }
+          if (recvcounts[i] > 0)
+            {
+              bytes_recv += recvcounts[i] * sizeof(T);
+              messages_recv++;
+            }
+        }
+      count_sent(bytes_sent, messages_sent);
+      count_recv(bytes_recv, messages_recv);
+    }
+
+    /// Returns the counters of this rank, by phase name
+    const std::map<std::string, PhaseCounters>& local_stats ();
+
+    /// Returns the peak resident set size of this process in bytes
+    uint64_t peak_rss ();
+
+    /// @brief Aggregates the counters of all ranks of comm. Collective on
+    ///        comm.
+    ///
+    /// Every phase run by at least one rank is reported; ranks that did
+    /// not run a phase count as zero, so that the imbalance reflects the
+    /// ranks left idle, such as the ranks that do not perform I/O.
+    void collect_stats (MPI_Comm comm, StatsReport& report);
+
+    /// Formats a report as a JSON object
+    std::string stats_json (const StatsReport& report);
+
+    /// Aggregates the counters of all ranks of comm and writes them as
+    /// JSON to a file from rank 0. Collective on comm.
+    void write_stats (MPI_Comm comm, const std::string& file_name);
+
+  }
+}
+
+#endif
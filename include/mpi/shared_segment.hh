@@ -0,0 +1,126 @@
+// -*- mode: c++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+//==============================================================================
+///  @file shared_segment.hh
+///
+///  Memory segments shared by the ranks of each shared-memory node.
+///
+///  Copyright (C) 2016-2025 Project NeuroH5.
+//==============================================================================
+
+#ifndef SHARED_SEGMENT_HH
+#define SHARED_SEGMENT_HH
+
+#include <mpi.h>
+
+#include <array>
+#include <cstddef>
+#include <cstring>
+#include <memory>
+
+#include "mapped_dataset.hh"
+
+namespace neuroh5
+{
+
+  namespace mpi
+  {
+
+    /// @brief A segment of memory replicated once per shared-memory node
+    ///        of a communicator.
+    ///
+    /// The segment is allocated with MPI_Win_allocate_shared by the lowest
+    /// rank of each node (the root rank on its node), and every rank of
+    /// the node accesses the same memory. The root rank fills its segment,
+    /// and bcast copies it to the other nodes, one message per node.
+    ///
+    /// Freeing the segment is collective over the ranks of a node, so the
+    /// destructor does not free it: the segment is kept until a call of
+    /// release_shared_segments finds that it has been destroyed on every
+    /// rank of its node. Segment objects can therefore be destroyed at any
+    /// time and in any order, e.g. by a garbage collector.
+    class SharedSegment
+    {
+    public:
+      /// Identifies a segment across ranks: the rank in MPI_COMM_WORLD
+      /// of the root rank, the number of segments created before by the
+      /// root rank, and the rank in MPI_COMM_WORLD of the node leader.
+      typedef std::array<uint64_t, 3> key_t;
+
+      /// Allocates a segment of size bytes, the value given on rank root.
+      /// Collective on comm.
+      SharedSegment (MPI_Comm comm, size_t size, int root = 0);
+      /// Hands the segment over to release_shared_segments
+      ~SharedSegment ();
+
+      SharedSegment (const SharedSegment&) = delete;
+      SharedSegment& operator= (const SharedSegment&) = delete;
+
+      /// Start of the segment; only written by the root rank, before bcast
+      char* data () { return data_; }
+      const char* data () const { return data_; }
+      size_t size () const { return size_; }
+
+      bool is_root () const { return is_root_; }
+
+      /// Copies the segment filled by the root rank to the other nodes,
+      /// and waits until the segment of each node is complete. Collective
+      /// on comm.
+      void bcast ();
+
+      /// Alignment of the columns laid out in a segment
+      static const size_t column_alignment = 8;
+
+      /// Returns offset rounded up to the column alignment
+      static size_t align (const size_t offset)
+      {
+        return (offset + column_alignment - 1) & ~(column_alignment - 1);
+      }
+
+    private:
+      key_t    key_;
+      int      node_size_;
+      MPI_Comm node_comm_;
+      MPI_Comm leader_comm_;
+      MPI_Win  win_;
+      char*    data_;
+      size_t   size_;
+      bool     is_root_;
+    };
+
+    /// @brief Frees the shared segments that have been destroyed on all
+    ///        ranks of their node. Collective on comm, which must contain
+    ///        the nodes of the segments to be freed; segments of nodes
+    ///        with ranks outside comm are kept.
+    ///
+    /// @return              Number of segments freed on this rank
+    size_t release_shared_segments (MPI_Comm comm);
+
+    /// Copies n values to the next column of a segment, starting at the
+    /// column alignment after pos, and advances pos past the column
+    template <class T>
+    void pack_column (char* base, size_t& pos, const T* values, const size_t n)
+    {
+      pos = SharedSegment::align(pos);
+      if (n > 0)
+        {
+          memcpy(base + pos, values, n * sizeof(T));
+        }
+      pos += n * sizeof(T);
+    }
+
+    /// Returns a view of the next column of n values of a segment, and
+    /// advances pos past the column; the view keeps the segment alive
+    template <class T>
+    hdf5::DatasetView<T> view_column (const std::shared_ptr<SharedSegment>& segment,
+                                      size_t& pos, const size_t n)
+    {
+      pos = SharedSegment::align(pos);
+      hdf5::DatasetView<T> view(segment, reinterpret_cast<const T*>(segment->data() + pos), n, true);
+      pos += n * sizeof(T);
+      return view;
+    }
+
+  }
+}
+
+#endif
@@ -33,6 +33,7 @@
 #include "ngraph.hh"
 #include "attr_val.hh"
 #include "attr_index.hh"
+#include "compact_rank_map.hh"
 #include "compact_optional.hh"
 #include "optional_value.hh"
 
@@ -163,6 +164,12 @@ namespace neuroh5
     uint16_t pop;
   } pop_range_t;
 
+  template<class Archive>
+  void serialize(Archive & archive, pop_range_t & range)
+  {
+    archive(range.start, range.count, range.pop);
+  }
+
   
   typedef std::tuple< CELL_IDX_T,   // Tree id
                       std::deque<SECTION_IDX_T>,   // Section id sources
@@ -215,7 +222,7 @@ namespace neuroh5
 
   typedef rank_edge_map_t::iterator rank_edge_map_iter_t;
 
-  typedef map<CELL_IDX_T, set<rank_t> > node_rank_map_t;
+  typedef data::CompactRankMap<CELL_IDX_T, rank_t> node_rank_map_t;
   
 // In-memory HDF5 datatype of attribute pointers
 #define ATTR_PTR_H5_NATIVE_T H5T_NATIVE_UINT64
@@ -31,6 +31,10 @@
 #include <vector>
 #include <deque>
 #include <forward_list>
+#include <memory>
+#include <future>
+#include <mutex>
+#include <condition_variable>
 
 #include <hdf5.h>
 #include <mpi.h>
@@ -52,6 +56,8 @@
 #include "dataset_num_elements.hh"
 #include "num_projection_blocks.hh"
 #include "attr_map.hh"
+#include "columnar_attr_map.hh"
+#include "packed_trees.hh"
 #include "mpe_seq.hh"
 #include "read_projection.hh"
 #include "read_graph.hh"
@@ -67,6 +73,13 @@
 #include "edge_attributes.hh"
 #include "serialize_data.hh"
 #include "split_intervals.hh"
+#include "node_rank_assignment.hh"
+#include "file_session.hh"
+#include "dataset_creation.hh"
+#include "mapped_dataset.hh"
+#include "shared_segment.hh"
+#include "phase_stats.hh"
+#include "attr_kind_datatype.hh"
 #include "shared_array.hh"
 
 #if PY_MAJOR_VERSION >= 3
@@ -140,6 +153,131 @@ void throw_err(char const* err_message, int32_t task, int32_t thread)
   MPI_Abort(MPI_COMM_WORLD, 1);
 }
 
+/* Releases the GIL for the lifetime of the object; Python objects must
+ * not be accessed until it is destroyed. */
+struct ReleaseGIL
+{
+  PyThreadState *thread_state;
+  ReleaseGIL() : thread_state(PyEval_SaveThread()) {}
+  ~ReleaseGIL() { PyEval_RestoreThread(thread_state); }
+};
+
+/* Block prefetching issues collective reads from a background thread
+ * while the main thread may make MPI and HDF5 calls of its own, and
+ * therefore requires MPI_THREAD_MULTIPLE and a thread-safe HDF5
+ * library. */
+static bool prefetch_supported ()
+{
+  int provided = MPI_THREAD_SINGLE;
+  throw_assert(MPI_Query_thread(&provided) == MPI_SUCCESS,
+               "prefetch_supported: unable to query MPI thread support level");
+  hbool_t threadsafe = 0;
+  throw_assert(H5is_library_threadsafe(&threadsafe) >= 0,
+               "prefetch_supported: unable to query HDF5 thread safety");
+  return (provided == MPI_THREAD_MULTIPLE) && threadsafe;
+}
+
+/* Serializes all calls into neuroh5 and HDF5: those of the module
+ * functions, of the generators, and of the block reads started in the
+ * background. The lock is granted in ticket order. A background read
+ * takes its ticket in the thread that starts it, so that all ranks
+ * acquire the lock in the same order; its collective operations then
+ * never wait on a rank whose main thread is blocked on the lock. */
+class LibraryLock
+{
+public:
+  LibraryLock() : next_ticket(0), serving(0) {}
+
+  size_t take_ticket ()
+  {
+    std::lock_guard<std::mutex> guard(mutex);
+    return next_ticket++;
+  }
+
+  void acquire (const size_t ticket)
+  {
+    std::unique_lock<std::mutex> guard(mutex);
+    cond.wait(guard, [this, ticket] { return serving == ticket; });
+  }
+
+  void release ()
+  {
+    {
+      std::lock_guard<std::mutex> guard(mutex);
+      serving++;
+    }
+    cond.notify_all();
+  }
+
+private:
+  std::mutex              mutex;
+  std::condition_variable cond;
+  size_t                  next_ticket, serving;
+};
+
+static LibraryLock library_lock;
+// number of nested library guards held by this thread
+static thread_local size_t library_lock_depth = 0;
+
+/* Holds the library lock for its lifetime; nested guards of one thread
+ * hold it once. With ticket_arg, the guard holds the lock with a ticket
+ * taken earlier and is used by background reads, which do not hold the
+ * GIL; otherwise the GIL is released while waiting for the lock. */
+struct LibraryGuard
+{
+  LibraryGuard()
+  {
+    if (library_lock_depth++ == 0)
+      {
+        const size_t ticket = library_lock.take_ticket();
+        ReleaseGIL release;
+        library_lock.acquire(ticket);
+      }
+  }
+
+  explicit LibraryGuard(const size_t ticket)
+  {
+    throw_assert(library_lock_depth++ == 0,
+                 "LibraryGuard: background read started with the library lock held");
+    library_lock.acquire(ticket);
+  }
+
+  ~LibraryGuard()
+  {
+    if (--library_lock_depth == 0)
+      {
+        library_lock.release();
+      }
+  }
+};
+
+/* Calls a module function with the library lock held. */
+template <PyObject* (*F)(PyObject *, PyObject *, PyObject *)>
+static PyObject *py_library_call (PyObject *self, PyObject *args, PyObject *kwds)
+{
+  LibraryGuard guard;
+  return F(self, args, kwds);
+}
+
+template <PyObject* (*F)(PyObject *, PyObject *)>
+static PyObject *py_library_call_noargs (PyObject *self, PyObject *args)
+{
+  LibraryGuard guard;
+  return F(self, args);
+}
+
+/* Waits for a prefetched block with the GIL released, and rethrows any
+ * exception raised by the read. */
+template <class T>
+static T wait_prefetch (std::future<T>& f)
+{
+  {
+    ReleaseGIL release;
+    f.wait();
+  }
+  return f.get();
+}
+
                            
 void build_node_rank_map (MPI_Comm comm,
                           PyObject *py_node_allocation,
@@ -561,6 +699,76 @@ void build_selection (PyObject *py_selection, vector<NODE_IDX_T>& selection)
 }
 
 
+/// Sets the dataset creation policy from the compression argument of the
+/// writer functions: None for the default settings, False for no
+/// compression, an integer deflate level, or a dictionary with the keys
+/// "level" (integer or None), "shuffle", "fletcher32",
+/// "index_chunk_size", "pointer_chunk_size" and "value_chunk_size".
+void build_dataset_creation_policy (PyObject *py_compression, hdf5::DatasetCreationPolicy& policy)
+{
+  if ((py_compression == NULL) || (py_compression == Py_None))
+    return;
+
+  if (PyBool_Check(py_compression))
+    {
+      if (py_compression == Py_False)
+        {
+          policy.deflate_level = -1;
+        }
+    }
+  else if (PyLong_Check(py_compression))
+    {
+      policy.deflate_level = PyLong_AsLong(py_compression);
+    }
+  else
+    {
+      throw_assert(PyDict_Check(py_compression),
+                   "build_dataset_creation_policy: compression must be None, bool, int or dict");
+
+      PyObject *py_key, *py_value;
+      Py_ssize_t pos = 0;
+      while (PyDict_Next(py_compression, &pos, &py_key, &py_value))
+        {
+          throw_assert(PyStr_Check(py_key),
+                       "build_dataset_creation_policy: compression keys must be strings");
+          const string key = string(PyStr_ToCString(py_key));
+          if (key == "level")
+            {
+              policy.deflate_level = (py_value == Py_None) ? -1 : PyLong_AsLong(py_value);
+            }
+          else if (key == "shuffle")
+            {
+              policy.shuffle = PyObject_IsTrue(py_value);
+            }
+          else if (key == "fletcher32")
+            {
+              policy.fletcher32 = PyObject_IsTrue(py_value);
+            }
+          else if (key == "index_chunk_size")
+            {
+              policy.index_chunk_size = PyLong_AsUnsignedLong(py_value);
+            }
+          else if (key == "pointer_chunk_size")
+            {
+              policy.pointer_chunk_size = PyLong_AsUnsignedLong(py_value);
+            }
+          else if (key == "value_chunk_size")
+            {
+              policy.value_chunk_size = PyLong_AsUnsignedLong(py_value);
+            }
+          else
+            {
+              throw_assert(false,
+                           "build_dataset_creation_policy: unknown compression setting " << key);
+            }
+        }
+    }
+
+  throw_assert((policy.deflate_level >= -1) && (policy.deflate_level <= 9),
+               "build_dataset_creation_policy: invalid compression level " << policy.deflate_level);
+}
+
+
 void build_cell_attr_value_maps (PyObject *idx_values,
                                  map<string, map<CELL_IDX_T, deque<uint32_t>>>& all_attr_values_uint32,
                                  map<string, map<CELL_IDX_T, deque<uint16_t>>>& all_attr_values_uint16,
@@ -1036,248 +1244,543 @@ void build_edge_maps (int rank, PyObject *py_edge_dict,
 }
 
 
-PyObject* py_build_tree_value(const CELL_IDX_T key, const neurotree_t &tree,
-                              const map <string, NamedAttrMap>& attr_maps,
-                              const bool topology, const bool validate)
+/* Copies a one-dimensional array into a vector, converting its values to
+ * the given NumPy type. */
+template<class T>
+void py_array_to_vector_cast (PyObject *pyval, int npy_type, const char *name,
+                              vector<T>& value_vector)
 {
-  const CELL_IDX_T idx = get<0>(tree);
-  throw_assert(idx == key,
-               "py_build_tree_value: tree index mismatch");
+  PyArrayObject *pyarr = (PyArrayObject *)PyArray_FROMANY(pyval, npy_type, 1, 1,
+                                                          NPY_ARRAY_IN_ARRAY | NPY_ARRAY_FORCECAST);
+  throw_assert(pyarr != NULL,
+               "py_array_to_vector_cast: " << name << " must be a one-dimensional array");
+  const T *pyarr_ptr = (const T *)PyArray_DATA(pyarr);
+  value_vector.assign(pyarr_ptr, pyarr_ptr + PyArray_SIZE(pyarr));
+  Py_DECREF(pyarr);
+}
 
-  if (validate)
+
+static bool is_array_attr_type (const int npy_type)
+{
+  switch (npy_type)
     {
-      cell::validate_tree(tree);
+    case NPY_UINT32: case NPY_UINT16: case NPY_UINT8:
+    case NPY_INT32:  case NPY_INT16:  case NPY_INT8:
+    case NPY_FLOAT:
+      return true;
+    default:
+      return false;
     }
+}
 
-  const deque<SECTION_IDX_T> & src_vector=get<1>(tree);
-  const deque<SECTION_IDX_T> & dst_vector=get<2>(tree);
-  const deque<SECTION_IDX_T> & sections=get<3>(tree);
-  const deque<COORD_T> & xcoords=get<4>(tree);
-  const deque<COORD_T> & ycoords=get<5>(tree);
-  const deque<COORD_T> & zcoords=get<6>(tree);
-  const deque<REALVAL_T> & radiuses=get<7>(tree);
-  const deque<LAYER_IDX_T> & layers=get<8>(tree);
-  const deque<PARENT_NODE_IDX_T> & parents=get<9>(tree);
-  const deque<SWC_TYPE_T> & swc_types=get<10>(tree);
-                           
-  size_t num_nodes = xcoords.size();
-  npy_intp ind = 0;
 
-  PyObject *py_section_topology = NULL;
-  PyObject *py_section_vector = NULL;
-  PyObject *py_section_src = NULL;
-  PyObject *py_section_dst = NULL;
-  PyObject *py_section_loc = NULL;
-  PyObject *py_sections = NULL;
-  
-  if (topology)
+/* Throws on all ranks of comm if local_error is not empty on any rank,
+ * so that an error in the arguments of one rank does not leave the
+ * other ranks waiting in a later collective operation. */
+void check_collective_error (MPI_Comm comm, const string& fn_name, const string& local_error)
+{
+  int local_failed = local_error.empty() ? 0 : 1, failed = 0;
+  throw_assert(MPI_Allreduce(&local_failed, &failed, 1, MPI_INT, MPI_MAX, comm) == MPI_SUCCESS,
+               fn_name << ": error in MPI_Allreduce");
+  throw_assert(local_failed == 0, local_error);
+  throw_assert(failed == 0, fn_name << ": invalid arguments on another rank");
+}
+
+
+/* Agrees on the attributes { namespace: { attribute name: NumPy type } }
+ * given by the ranks of comm before any data is exchanged. The
+ * attributes of all ranks are gathered on rank 0, which merges them and
+ * broadcasts the union. Throws on all ranks if local_error is not empty
+ * on any rank, or if an attribute is given with different types. */
+void agree_attribute_types (MPI_Comm comm, const string& fn_name, const string& local_error,
+                            map<string, map<string, int> >& attr_types)
+{
+  int rank, size;
+  throw_assert(MPI_Comm_rank(comm, &rank) == MPI_SUCCESS,
+               fn_name << ": unable to obtain MPI rank");
+  throw_assert(MPI_Comm_size(comm, &size) == MPI_SUCCESS,
+               fn_name << ": unable to obtain MPI size");
+
+  typedef pair< string, map<string, map<string, int> > > attr_type_info_t;
+
+  vector<char> sendbuf;
+  data::serialize_data(attr_type_info_t(local_error, attr_types), sendbuf);
+  int sendbuf_size = sendbuf.size();
+  vector<int> recvcounts(size, 0), rdispls(size, 0);
+  throw_assert(MPI_Gather(&sendbuf_size, 1, MPI_INT, &recvcounts[0], 1, MPI_INT,
+                          0, comm) == MPI_SUCCESS,
+               fn_name << ": error in MPI_Gather");
+  vector<char> recvbuf;
+  if (rank == 0)
     {
-      npy_intp dims[1];
-      dims[0] = num_nodes;
-      py_section_topology = PyDict_New();
-      py_section_vector = create_typed_shared_array<uint16_t>(dims[0]);
-      SECTION_IDX_T *section_vector_ptr = (SECTION_IDX_T *)PyArray_GetPtr((PyArrayObject *)py_section_vector, &ind);
-      size_t sections_ptr=0;
-      SECTION_IDX_T section_idx = 0;
-      PyObject *py_section_node_map = PyDict_New();
-      PyObject *py_section_key; PyObject *py_section_nodes;
-      set<NODE_IDX_T> marked_nodes;
-      map <SECTION_IDX_T, deque<NODE_IDX_T> > section_node_map;
-      size_t num_sections = sections[sections_ptr];
-      sections_ptr++;
-      while (sections_ptr < sections.size())
+      for (int p = 1; p < size; p++)
         {
-          deque<NODE_IDX_T> section_nodes;
-          size_t num_section_nodes = sections[sections_ptr];
-          npy_intp nodes_dims[1], nodes_ind = 0;
-          nodes_dims[0]    = num_section_nodes;
-          py_section_key   = PyLong_FromLong((long)section_idx);
-          py_section_nodes = create_typed_shared_array<uint32_t>(nodes_dims[0]);
-          NODE_IDX_T *py_section_nodes_ptr = (NODE_IDX_T *)PyArray_GetPtr((PyArrayObject *)py_section_nodes, &nodes_ind);
-          sections_ptr++;
-          for (size_t p = 0; p < num_section_nodes; p++)
-            {
-              NODE_IDX_T node_idx = sections[sections_ptr];
-              throw_assert(node_idx <= num_nodes,
-                           "py_build_tree_value: invalid node index in tree");
-
-              py_section_nodes_ptr[p] = node_idx;
-              section_nodes.push_back(node_idx);
-              if (marked_nodes.find(node_idx) == marked_nodes.end())
-                {
-                  section_vector_ptr[node_idx] = section_idx;
-                  marked_nodes.insert(node_idx);
-                }
-              sections_ptr++;
-            }
-          section_node_map.insert(make_pair(section_idx, section_nodes));
-          PyDict_SetItem(py_section_node_map, py_section_key, py_section_nodes);
-          Py_DECREF(py_section_nodes);
-          Py_DECREF(py_section_key);
-          section_idx++;
+          rdispls[p] = rdispls[p-1] + recvcounts[p-1];
         }
-      throw_assert(section_idx == num_sections,
-                   "py_build_tree_value: invalid section index in tree");
-
-      npy_intp topology_dims[1];
-      topology_dims[0] = src_vector.size();
-
-      py_section_src = create_shared_array_from_deque<SECTION_IDX_T>(std::move(src_vector));
-      py_section_dst = create_shared_array_from_deque<SECTION_IDX_T>(std::move(dst_vector));
-      
-      py_section_loc = create_typed_shared_array<uint32_t>(topology_dims[0]);
-      NODE_IDX_T *section_loc_ptr = (NODE_IDX_T *)PyArray_GetPtr((PyArrayObject *)py_section_loc, &ind);
-      for (size_t s = 0; s < src_vector.size(); s++)
+      recvbuf.resize(rdispls[size-1] + recvcounts[size-1]);
+    }
+  throw_assert(MPI_Gatherv(sendbuf.data(), sendbuf_size, MPI_CHAR,
+                           recvbuf.data(), &recvcounts[0], &rdispls[0], MPI_CHAR,
+                           0, comm) == MPI_SUCCESS,
+               fn_name << ": error in MPI_Gatherv");
+
+  attr_type_info_t result;
+  sendbuf.clear();
+  if (rank == 0)
+    {
+      for (int p = 0; p < size; p++)
         {
-          auto node_map_it = section_node_map.find(src_vector[s]);
-          throw_assert (node_map_it != section_node_map.end(),
-                        "py_build_tree_value: invalid section index in tree source vector");
-          // find parent point in destination section and determine location where the two sections are located
-          deque<NODE_IDX_T>& src_section_nodes = node_map_it->second;
-          node_map_it = section_node_map.find(dst_vector[s]);
-          throw_assert (node_map_it != section_node_map.end(),
-                        "py_build_tree_value: invalid section index in tree source vector");
-          deque<NODE_IDX_T>& dst_section_nodes = node_map_it->second;
-          const NODE_IDX_T dst_start = dst_section_nodes[0];
-          const PARENT_NODE_IDX_T dst_start_parent = parents[dst_start];
-
-          auto node_it = std::find(std::begin(src_section_nodes), std::end(src_section_nodes), dst_start);
-          if (node_it != std::end(src_section_nodes))
+          attr_type_info_t info;
+          data::deserialize_data(vector<char>(recvbuf.begin() + rdispls[p],
+                                              recvbuf.begin() + rdispls[p] + recvcounts[p]),
+                                 info);
+          if (result.first.empty() && !info.first.empty())
             {
-              size_t pos = std::distance(std::begin(src_section_nodes), node_it);
-              section_loc_ptr[s] = pos;
+              result.first = "rank " + to_string(p) + ": " + info.first;
             }
-          else 
+          for (auto const& ns_it : info.second)
             {
-              if (dst_start_parent != -1)
+              map<string, int>& ns_types = result.second[ns_it.first];
+              for (auto const& attr_it : ns_it.second)
                 {
-                  auto node_it = std::find(std::begin(src_section_nodes), std::end(src_section_nodes), dst_start_parent);
-                  if (node_it != std::end(src_section_nodes))
+                  auto it = ns_types.find(attr_it.first);
+                  if (it == ns_types.end())
                     {
-                      size_t pos = std::distance(std::begin(src_section_nodes), node_it);
-                      section_loc_ptr[s] = pos;
+                      ns_types.insert(attr_it);
                     }
-                  else
+                  else if ((it->second != attr_it.second) && result.first.empty())
                     {
-                      throw_err("py_build_tree: unable to determine connection point");
+                      result.first = "attribute " + ns_it.first + "/" + attr_it.first +
+                        " has different types on different ranks";
                     }
                 }
-              else
-                {
-                  throw_err("py_build_tree: unable to determine connection point");
-                }
             }
         }
-
-      PyObject *py_num_sections = PyLong_FromUnsignedLong(num_sections);
-      PyDict_SetItemString(py_section_topology, "num_sections", py_num_sections);
-      Py_DECREF(py_num_sections);
-      PyDict_SetItemString(py_section_topology, "nodes", py_section_node_map);
-      Py_DECREF(py_section_node_map);
-      PyDict_SetItemString(py_section_topology, "src", py_section_src);
-      Py_DECREF(py_section_src);
-      PyDict_SetItemString(py_section_topology, "dst", py_section_dst);
-      Py_DECREF(py_section_dst);
-      PyDict_SetItemString(py_section_topology, "loc", py_section_loc);
-      Py_DECREF(py_section_loc);
+      data::serialize_data(result, sendbuf);
     }
-  else
-    {
-      npy_intp topology_dims[1];
-      topology_dims[0] = src_vector.size();
-      
-      py_section_src = create_shared_array_from_deque<SECTION_IDX_T>(std::move(src_vector));
-      py_section_dst = create_shared_array_from_deque<SECTION_IDX_T>(std::move(dst_vector));
 
-      npy_intp sections_dims[1];
-      sections_dims[0] = sections.size();
-      
-      py_sections = create_shared_array_from_deque<SECTION_IDX_T>(std::move(sections));
+  size_t sendbuf_bcast_size = sendbuf.size();
+  throw_assert(MPI_Bcast(&sendbuf_bcast_size, 1, MPI_SIZE_T, 0, comm) == MPI_SUCCESS,
+               fn_name << ": error in MPI_Bcast");
+  sendbuf.resize(sendbuf_bcast_size);
+  throw_assert(MPI_Bcast(sendbuf.data(), sendbuf_bcast_size, MPI_CHAR, 0, comm) == MPI_SUCCESS,
+               fn_name << ": error in MPI_Bcast");
+  if (rank != 0)
+    {
+      data::deserialize_data(sendbuf, result);
     }
-  
-                           
 
-  npy_intp dims[1];
-  dims[0] = num_nodes;
+  throw_assert(result.first.empty(), fn_name << ": " << result.first);
+  attr_types = result.second;
+}
 
-  PyObject *py_xcoords = create_shared_array_from_deque<COORD_T>(std::move(xcoords));
-  PyObject *py_ycoords = create_shared_array_from_deque<COORD_T>(std::move(ycoords));
-  PyObject *py_zcoords = create_shared_array_from_deque<COORD_T>(std::move(zcoords));
-  PyObject *py_radiuses = create_shared_array_from_deque<REALVAL_T>(std::move(radiuses));
-  PyObject *py_layers = create_shared_array_from_deque<LAYER_IDX_T>(std::move(layers));
-  PyObject *py_parents = create_shared_array_from_deque<PARENT_NODE_IDX_T>(std::move(parents));
-  PyObject *py_swc_types = create_shared_array_from_deque<SWC_TYPE_T>(std::move(swc_types));
-  
-  PyObject *py_treeval = PyDict_New();
-  PyDict_SetItemString(py_treeval, "x", py_xcoords);
-  Py_DECREF(py_xcoords);
 
-  PyDict_SetItemString(py_treeval, "y", py_ycoords);
-  Py_DECREF(py_ycoords);
-                           
-  PyDict_SetItemString(py_treeval, "z", py_zcoords);
-  Py_DECREF(py_zcoords);
+/* Records the NumPy types of a dictionary { namespace: { attribute
+ * name: array } } of edge attribute columns. */
+void get_edge_array_attr_types (PyObject *py_edge_attrs,
+                                map<string, map<string, int> >& attr_types)
+{
+  PyObject *py_attr_namespace, *py_attr_namespace_value;
+  Py_ssize_t attr_namespace_pos = 0;
+  while (PyDict_Next(py_edge_attrs, &attr_namespace_pos, &py_attr_namespace, &py_attr_namespace_value))
+    {
+      throw_assert(PyStr_Check(py_attr_namespace),
+                   "get_edge_array_attr_types: namespace is not a string");
+      throw_assert(PyDict_Check(py_attr_namespace_value),
+                   "get_edge_array_attr_types: invalid attribute dictionary");
+      map<string, int>& ns_types = attr_types[string(PyStr_ToCString (py_attr_namespace))];
 
-  PyDict_SetItemString(py_treeval, "radius", py_radiuses);
-  Py_DECREF(py_radiuses);
-                           
-  PyDict_SetItemString(py_treeval, "layer", py_layers);
-  Py_DECREF(py_layers);
-                           
-  PyDict_SetItemString(py_treeval, "parent", py_parents);
-  Py_DECREF(py_parents);
-                           
-  PyDict_SetItemString(py_treeval, "swc_type", py_swc_types);
-  Py_DECREF(py_swc_types);
+      PyObject *py_attr_key, *py_attr_values;
+      Py_ssize_t attr_pos = 0;
+      while (PyDict_Next(py_attr_namespace_value, &attr_pos, &py_attr_key, &py_attr_values))
+        {
+          throw_assert(PyStr_Check(py_attr_key) && PyArray_Check(py_attr_values),
+                       "get_edge_array_attr_types: invalid attribute dictionary");
+          string attr_name = string(PyStr_ToCString(py_attr_key));
+          const int npy_type = PyArray_TYPE((PyArrayObject *)py_attr_values);
+          throw_assert(is_array_attr_type(npy_type),
+                       "get_edge_array_attr_types: unsupported type of attribute " << attr_name);
+          ns_types[attr_name] = npy_type;
+        }
+    }
+}
 
-  if (topology)
+
+/* Builds the edge attribute index of the attributes agreed on by
+ * agree_attribute_types. */
+void get_edge_array_attr_index (const map<string, map<string, int> >& attr_types,
+                                map <string, pair <size_t, AttrIndex > >& edge_attr_index)
+{
+  size_t attr_ns_index = 0;
+  for (auto const& ns_it : attr_types)
     {
-      throw_assert(py_section_vector != NULL,
-                   "py_build_tree_value: invalid section vector in tree");
-      throw_assert(py_section_topology != NULL,
-                   "py_build_tree_value: invalid section topology in tree");
-      
-      PyDict_SetItemString(py_treeval, "section", py_section_vector);
-      Py_DECREF(py_section_vector);
+      AttrSet attr_set;
+      for (auto const& attr_it : ns_it.second)
+        {
+          const string& attr_name = attr_it.first;
+          switch (attr_it.second)
+            {
+            case NPY_UINT32: attr_set.add<uint32_t>(attr_name); break;
+            case NPY_UINT16: attr_set.add<uint16_t>(attr_name); break;
+            case NPY_UINT8:  attr_set.add<uint8_t>(attr_name); break;
+            case NPY_INT32:  attr_set.add<int32_t>(attr_name); break;
+            case NPY_INT16:  attr_set.add<int16_t>(attr_name); break;
+            case NPY_INT8:   attr_set.add<int8_t>(attr_name); break;
+            case NPY_FLOAT:  attr_set.add<float>(attr_name); break;
+            default:
+              throw runtime_error("Unsupported attribute type");
+              break;
+            }
+        }
+      edge_attr_index[ns_it.first] = make_pair(attr_ns_index++, AttrIndex(attr_set));
+    }
+}
 
-      PyDict_SetItemString(py_treeval, "section_topology", py_section_topology);
-      Py_DECREF(py_section_topology);
+
+/* Sets a column of edge attribute values; the column of an attribute
+ * not given on this rank (py_attr_values is NULL) is empty. */
+template<class T>
+void py_edge_attr_column (PyObject *py_attr_values, const int npy_type,
+                          const string& attr_name, const AttrIndex& attr_index,
+                          const size_t num_edges, data::AttrVal& edge_attr_values)
+{
+  const size_t idx = attr_index.attr_index<T>(attr_name);
+  edge_attr_values.resize<T>(attr_index.size_attr_index<T>());
+  vector<T>& column = edge_attr_values.attr_vec<T>(idx);
+  if (py_attr_values == NULL)
+    {
+      column.clear();
     }
   else
     {
-      throw_assert(py_sections != NULL,
-                   "py_build_tree_value: invalid sections in tree");
-      throw_assert(py_section_src != NULL,
-                   "py_build_tree_value: invalid source section vector in tree");
-      throw_assert(py_section_dst != NULL,
-                   "py_build_tree_value: invalid destination section vector in tree");
-
-      PyDict_SetItemString(py_treeval, "sections", py_sections);
-      Py_DECREF(py_sections);
-      PyDict_SetItemString(py_treeval, "src", py_section_src);
-      Py_DECREF(py_section_src);
-      PyDict_SetItemString(py_treeval, "dst", py_section_dst);
-      Py_DECREF(py_section_dst);
+      py_array_to_vector_cast<T>(py_attr_values, npy_type, attr_name.c_str(), column);
     }
-                           
-  for (auto const& attr_map_entry : attr_maps)
-    {
-      const string& attr_namespace  = attr_map_entry.first;
-      data::NamedAttrMap attr_map  = attr_map_entry.second;
-      vector <vector<string> > attr_names;
-
-      attr_map.attr_names(attr_names);
-                                 
-      PyObject *py_namespace_dict = PyDict_New();
+  throw_assert(column.size() == num_edges,
+               "build_edge_csr: mismatch in number of edges and number of values of attribute "
+               << attr_name);
+}
 
-      const vector <deque <float>> &float_attrs     = attr_map.find<float>(idx);
-      const vector <deque <uint8_t>> &uint8_attrs   = attr_map.find<uint8_t>(idx);
-      const vector <deque <int8_t>> &int8_attrs     = attr_map.find<int8_t>(idx);
-      const vector <deque <uint16_t>> &uint16_attrs = attr_map.find<uint16_t>(idx);
-      const vector <deque <uint32_t>> &uint32_attrs = attr_map.find<uint32_t>(idx);
-      const vector <deque <int32_t>> &int32_attrs   = attr_map.find<int32_t>(idx);
 
-      for (size_t i=0; i<float_attrs.size(); i++)
+/* Builds flat CSR edges from an array of destination ids, an array of
+ * offsets into the source ids with one more element than the
+ * destinations, an array of source ids and a dictionary { namespace: {
+ * attribute name: array } } of attribute columns with one value per
+ * edge. Every attribute of attr_types must be given unless this rank
+ * has no edges. */
+void build_edge_csr (PyObject *py_dst_gids, PyObject *py_dst_ptr, PyObject *py_src_gids,
+                     PyObject *py_edge_attrs,
+                     const map<string, map<string, int> >& attr_types,
+                     const map <string, pair <size_t, AttrIndex > >& edge_attr_index,
+                     data::EdgeCSR& edges)
+{
+  py_array_to_vector_cast<NODE_IDX_T>(py_dst_gids, NPY_UINT32, "dst_gids", edges.keys);
+  py_array_to_vector_cast<DST_PTR_T>(py_dst_ptr, NPY_UINT64, "dst_ptr", edges.offsets);
+  py_array_to_vector_cast<NODE_IDX_T>(py_src_gids, NPY_UINT32, "src_gids", edges.adj);
+  throw_assert(edges.offsets.size() == edges.keys.size() + 1,
+               "build_edge_csr: size of dst_ptr must be the size of dst_gids + 1");
+  throw_assert((edges.offsets.front() == 0) && (edges.offsets.back() == edges.adj.size()),
+               "build_edge_csr: dst_ptr must start at 0 and end at the size of src_gids");
+  const size_t num_edges = edges.adj.size();
+
+  edges.attrs.resize(edge_attr_index.size());
+  for (auto const& ns_it : attr_types)
+    {
+      const string& attr_namespace = ns_it.first;
+      auto index_it = edge_attr_index.find(attr_namespace);
+      throw_assert(index_it != edge_attr_index.end(),
+                   "build_edge_csr: namespace mismatch");
+      const AttrIndex& attr_index = index_it->second.second;
+      data::AttrVal& edge_attr_values = edges.attrs[index_it->second.first];
+
+      PyObject *py_ns_attrs = NULL;
+      if ((py_edge_attrs != NULL) && (py_edge_attrs != Py_None))
+        {
+          py_ns_attrs = PyDict_GetItemString(py_edge_attrs, attr_namespace.c_str());
+        }
+
+      for (auto const& attr_it : ns_it.second)
+        {
+          const string& attr_name = attr_it.first;
+          const int npy_type = attr_it.second;
+          PyObject *py_attr_values = NULL;
+          if (py_ns_attrs != NULL)
+            {
+              py_attr_values = PyDict_GetItemString(py_ns_attrs, attr_name.c_str());
+            }
+          throw_assert((py_attr_values != NULL) || (num_edges == 0),
+                       "build_edge_csr: attribute " << attr_namespace << "/" << attr_name
+                       << " is not given");
+          switch (npy_type)
+            {
+            case NPY_UINT32:
+              py_edge_attr_column<uint32_t>(py_attr_values, npy_type, attr_name, attr_index,
+                                            num_edges, edge_attr_values);
+              break;
+            case NPY_UINT16:
+              py_edge_attr_column<uint16_t>(py_attr_values, npy_type, attr_name, attr_index,
+                                            num_edges, edge_attr_values);
+              break;
+            case NPY_UINT8:
+              py_edge_attr_column<uint8_t>(py_attr_values, npy_type, attr_name, attr_index,
+                                           num_edges, edge_attr_values);
+              break;
+            case NPY_INT32:
+              py_edge_attr_column<int32_t>(py_attr_values, npy_type, attr_name, attr_index,
+                                           num_edges, edge_attr_values);
+              break;
+            case NPY_INT16:
+              py_edge_attr_column<int16_t>(py_attr_values, npy_type, attr_name, attr_index,
+                                           num_edges, edge_attr_values);
+              break;
+            case NPY_INT8:
+              py_edge_attr_column<int8_t>(py_attr_values, npy_type, attr_name, attr_index,
+                                          num_edges, edge_attr_values);
+              break;
+            case NPY_FLOAT:
+              py_edge_attr_column<float>(py_attr_values, npy_type, attr_name, attr_index,
+                                         num_edges, edge_attr_values);
+              break;
+            default:
+              throw runtime_error("Unsupported attribute type");
+              break;
+            }
+        }
+    }
+}
+
+
+/* Cell attribute columns given as NumPy arrays, held until the write
+ * completes so that the values are passed to the writer in place. */
+struct PyCellAttributeArrays
+{
+  deque< vector<CELL_IDX_T> > index;
+  deque< vector<ATTR_PTR_T> > attr_ptr;
+  vector<PyArrayObject*>      values;
+
+  ~PyCellAttributeArrays()
+  {
+    for (PyArrayObject *arr : values)
+      {
+        Py_XDECREF(arr);
+      }
+  }
+
+  /* Adds an attribute with the cells of py_gids and the values of
+   * py_values at the offsets of py_attr_ptr; if py_values is NULL, the
+   * attribute is added without cells. */
+  template <typename T>
+  hdf5::CellAttributeAppend column (const string& attr_name, PyObject *py_gids, PyObject *py_attr_ptr,
+                                    PyObject *py_values, const int npy_type)
+  {
+    index.emplace_back();
+    attr_ptr.emplace_back();
+    const void *values_ptr = NULL;
+    size_t num_values = 0;
+    if (py_values == NULL)
+      {
+        attr_ptr.back().push_back(0);
+      }
+    else
+      {
+        py_array_to_vector_cast<CELL_IDX_T>(py_gids, NPY_UINT32, "gids", index.back());
+        py_array_to_vector_cast<ATTR_PTR_T>(py_attr_ptr, NPY_UINT64, attr_name.c_str(), attr_ptr.back());
+
+        PyArrayObject *arr = (PyArrayObject *)PyArray_FROMANY(py_values, npy_type, 1, 1,
+                                                              NPY_ARRAY_IN_ARRAY);
+        throw_assert(arr != NULL,
+                     "py_append_cell_attribute_arrays: values of attribute " << attr_name
+                     << " must be a one-dimensional array");
+        values.push_back(arr);
+        values_ptr = PyArray_DATA(arr);
+        num_values = PyArray_SIZE(arr);
+
+        const vector<ATTR_PTR_T>& ptr = attr_ptr.back();
+        throw_assert(ptr.size() == index.back().size() + 1,
+                     "py_append_cell_attribute_arrays: attribute " << attr_name
+                     << ": size of attribute pointer must be the number of cells + 1");
+        throw_assert(std::is_sorted(ptr.begin(), ptr.end()) && (ptr.back() <= num_values),
+                     "py_append_cell_attribute_arrays: attribute " << attr_name
+                     << ": invalid attribute pointer");
+      }
+
+    T dummy;
+    hdf5::CellAttributeAppend attr = { attr_name, infer_datatype(dummy),
+                                       IndexOwner, CellPtr(PtrOwner),
+                                       &index.back(), &attr_ptr.back(),
+                                       values_ptr, num_values, sizeof(T) };
+    return attr;
+  }
+
+  hdf5::CellAttributeAppend add (const string& attr_name, const int npy_type, PyObject *py_gids,
+                                 PyObject *py_attr_ptr, PyObject *py_values)
+  {
+    switch (npy_type)
+      {
+      case NPY_UINT32: return column<uint32_t>(attr_name, py_gids, py_attr_ptr, py_values, npy_type);
+      case NPY_UINT16: return column<uint16_t>(attr_name, py_gids, py_attr_ptr, py_values, npy_type);
+      case NPY_UINT8:  return column<uint8_t>(attr_name, py_gids, py_attr_ptr, py_values, npy_type);
+      case NPY_INT32:  return column<int32_t>(attr_name, py_gids, py_attr_ptr, py_values, npy_type);
+      case NPY_INT16:  return column<int16_t>(attr_name, py_gids, py_attr_ptr, py_values, npy_type);
+      case NPY_INT8:   return column<int8_t>(attr_name, py_gids, py_attr_ptr, py_values, npy_type);
+      case NPY_FLOAT:  return column<float>(attr_name, py_gids, py_attr_ptr, py_values, npy_type);
+      default:
+        throw runtime_error("Unsupported attribute type");
+      }
+  }
+};
+
+
+/* Builds the section topology dictionary of a tree. The tree fields may
+ * be deques or views of packed trees; py_section_src and py_section_dst
+ * are the arrays of source and destination sections. */
+template <class SectionVector, class ParentVector>
+static PyObject* py_build_tree_section_topology(const SectionVector& src_vector,
+                                                const SectionVector& dst_vector,
+                                                const SectionVector& sections,
+                                                const ParentVector& parents,
+                                                const size_t num_nodes,
+                                                PyObject *py_section_src,
+                                                PyObject *py_section_dst,
+                                                PyObject *&py_section_vector)
+{
+  npy_intp ind = 0;
+  PyObject *py_section_topology = NULL;
+  PyObject *py_section_loc = NULL;
+
+  npy_intp dims[1];
+  dims[0] = num_nodes;
+  py_section_topology = PyDict_New();
+  py_section_vector = create_typed_shared_array<uint16_t>(dims[0]);
+  SECTION_IDX_T *section_vector_ptr = (SECTION_IDX_T *)PyArray_GetPtr((PyArrayObject *)py_section_vector, &ind);
+  size_t sections_ptr=0;
+  SECTION_IDX_T section_idx = 0;
+  PyObject *py_section_node_map = PyDict_New();
+  PyObject *py_section_key; PyObject *py_section_nodes;
+  set<NODE_IDX_T> marked_nodes;
+  map <SECTION_IDX_T, deque<NODE_IDX_T> > section_node_map;
+  size_t num_sections = sections[sections_ptr];
+  sections_ptr++;
+  while (sections_ptr < sections.size())
+    {
+      deque<NODE_IDX_T> section_nodes;
+      size_t num_section_nodes = sections[sections_ptr];
+      npy_intp nodes_dims[1], nodes_ind = 0;
+      nodes_dims[0]    = num_section_nodes;
+      py_section_key   = PyLong_FromLong((long)section_idx);
+      py_section_nodes = create_typed_shared_array<uint32_t>(nodes_dims[0]);
+      NODE_IDX_T *py_section_nodes_ptr = (NODE_IDX_T *)PyArray_GetPtr((PyArrayObject *)py_section_nodes, &nodes_ind);
+      sections_ptr++;
+      for (size_t p = 0; p < num_section_nodes; p++)
+        {
+          NODE_IDX_T node_idx = sections[sections_ptr];
+          throw_assert(node_idx <= num_nodes,
+                       "py_build_tree_value: invalid node index in tree");
+
+          py_section_nodes_ptr[p] = node_idx;
+          section_nodes.push_back(node_idx);
+          if (marked_nodes.find(node_idx) == marked_nodes.end())
+            {
+              section_vector_ptr[node_idx] = section_idx;
+              marked_nodes.insert(node_idx);
+            }
+          sections_ptr++;
+        }
+      section_node_map.insert(make_pair(section_idx, section_nodes));
+      PyDict_SetItem(py_section_node_map, py_section_key, py_section_nodes);
+      Py_DECREF(py_section_nodes);
+      Py_DECREF(py_section_key);
+      section_idx++;
+    }
+  throw_assert(section_idx == num_sections,
+               "py_build_tree_value: invalid section index in tree");
+
+  npy_intp topology_dims[1];
+  topology_dims[0] = src_vector.size();
+
+  py_section_loc = create_typed_shared_array<uint32_t>(topology_dims[0]);
+  NODE_IDX_T *section_loc_ptr = (NODE_IDX_T *)PyArray_GetPtr((PyArrayObject *)py_section_loc, &ind);
+  for (size_t s = 0; s < src_vector.size(); s++)
+    {
+      auto node_map_it = section_node_map.find(src_vector[s]);
+      throw_assert (node_map_it != section_node_map.end(),
+                    "py_build_tree_value: invalid section index in tree source vector");
+      // find parent point in destination section and determine location where the two sections are located
+      deque<NODE_IDX_T>& src_section_nodes = node_map_it->second;
+      node_map_it = section_node_map.find(dst_vector[s]);
+      throw_assert (node_map_it != section_node_map.end(),
+                    "py_build_tree_value: invalid section index in tree source vector");
+      deque<NODE_IDX_T>& dst_section_nodes = node_map_it->second;
+      const NODE_IDX_T dst_start = dst_section_nodes[0];
+      const PARENT_NODE_IDX_T dst_start_parent = parents[dst_start];
+
+      auto node_it = std::find(std::begin(src_section_nodes), std::end(src_section_nodes), dst_start);
+      if (node_it != std::end(src_section_nodes))
+        {
+          size_t pos = std::distance(std::begin(src_section_nodes), node_it);
+          section_loc_ptr[s] = pos;
+        }
+      else 
+        {
+          if (dst_start_parent != -1)
+            {
+              auto node_it = std::find(std::begin(src_section_nodes), std::end(src_section_nodes), dst_start_parent);
+              if (node_it != std::end(src_section_nodes))
+                {
+                  size_t pos = std::distance(std::begin(src_section_nodes), node_it);
+                  section_loc_ptr[s] = pos;
+                }
+              else
+                {
+                  throw_err("py_build_tree: unable to determine connection point");
+                }
+            }
+          else
+            {
+              throw_err("py_build_tree: unable to determine connection point");
+            }
+        }
+    }
+
+  PyObject *py_num_sections = PyLong_FromUnsignedLong(num_sections);
+  PyDict_SetItemString(py_section_topology, "num_sections", py_num_sections);
+  Py_DECREF(py_num_sections);
+  PyDict_SetItemString(py_section_topology, "nodes", py_section_node_map);
+  Py_DECREF(py_section_node_map);
+  PyDict_SetItemString(py_section_topology, "src", py_section_src);
+  Py_DECREF(py_section_src);
+  PyDict_SetItemString(py_section_topology, "dst", py_section_dst);
+  Py_DECREF(py_section_dst);
+  PyDict_SetItemString(py_section_topology, "loc", py_section_loc);
+  Py_DECREF(py_section_loc);
+
+  return py_section_topology;
+}
+
+
+static void py_build_tree_attr_namespaces(const CELL_IDX_T idx,
+                                          const map <string, NamedAttrMap>& attr_maps,
+                                          PyObject *py_treeval)
+{
+  npy_intp dims[1];
+
+  for (auto const& attr_map_entry : attr_maps)
+    {
+      const string& attr_namespace  = attr_map_entry.first;
+      const data::NamedAttrMap& attr_map  = attr_map_entry.second;
+      vector <vector<string> > attr_names;
+
+      attr_map.attr_names(attr_names);
+                                 
+      PyObject *py_namespace_dict = PyDict_New();
+
+      const vector <deque <float>> &float_attrs     = attr_map.find<float>(idx);
+      const vector <deque <uint8_t>> &uint8_attrs   = attr_map.find<uint8_t>(idx);
+      const vector <deque <int8_t>> &int8_attrs     = attr_map.find<int8_t>(idx);
+      const vector <deque <uint16_t>> &uint16_attrs = attr_map.find<uint16_t>(idx);
+      const vector <deque <uint32_t>> &uint32_attrs = attr_map.find<uint32_t>(idx);
+      const vector <deque <int32_t>> &int32_attrs   = attr_map.find<int32_t>(idx);
+
+      for (size_t i=0; i<float_attrs.size(); i++)
         {
           const deque<float> &attr_value = float_attrs[i];
           dims[0] = attr_value.size();
@@ -1350,81 +1853,356 @@ PyObject* py_build_tree_value(const CELL_IDX_T key, const neurotree_t &tree,
                            py_namespace_dict);
       Py_DECREF(py_namespace_dict);
     }
-                           
-
-  return py_treeval;
 }
 
-/* NeuroH5TreeIterState - in-memory tree iterator instance.
- *
- * seq_index: index of the next id in the sequence to yield
- *
- */
-typedef struct {
-  Py_ssize_t seq_index, count;
+
+PyObject* py_build_tree_value(const CELL_IDX_T key, const neurotree_t &tree,
+                              const map <string, NamedAttrMap>& attr_maps,
+                              const bool topology, const bool validate)
+{
+  const CELL_IDX_T idx = get<0>(tree);
+  throw_assert(idx == key,
+               "py_build_tree_value: tree index mismatch");
+
+  if (validate)
+    {
+      cell::validate_tree(tree);
+    }
+
+  const deque<SECTION_IDX_T> & src_vector=get<1>(tree);
+  const deque<SECTION_IDX_T> & dst_vector=get<2>(tree);
+  const deque<SECTION_IDX_T> & sections=get<3>(tree);
+  const deque<COORD_T> & xcoords=get<4>(tree);
+  const deque<COORD_T> & ycoords=get<5>(tree);
+  const deque<COORD_T> & zcoords=get<6>(tree);
+  const deque<REALVAL_T> & radiuses=get<7>(tree);
+  const deque<LAYER_IDX_T> & layers=get<8>(tree);
+  const deque<PARENT_NODE_IDX_T> & parents=get<9>(tree);
+  const deque<SWC_TYPE_T> & swc_types=get<10>(tree);
                            
-  forward_list <neurotree_t> tree_list;
-  vector<string> attr_name_spaces;
-  map <string, NamedAttrMap> attr_maps;
-  forward_list<neurotree_t>::const_iterator it_tree;
-  bool topology_flag;
-  bool validate_flag;
+  size_t num_nodes = xcoords.size();
+
+  PyObject *py_section_topology = NULL;
+  PyObject *py_section_vector = NULL;
+  PyObject *py_section_src = NULL;
+  PyObject *py_section_dst = NULL;
+  PyObject *py_sections = NULL;
   
-} NeuroH5TreeIterState;
+  if (topology)
+    {
+      py_section_src = create_shared_array_from_deque<SECTION_IDX_T>(std::move(src_vector));
+      py_section_dst = create_shared_array_from_deque<SECTION_IDX_T>(std::move(dst_vector));
+      py_section_topology = py_build_tree_section_topology(src_vector, dst_vector, sections, parents,
+                                                           num_nodes, py_section_src, py_section_dst,
+                                                           py_section_vector);
+    }
+  else
+    {
+      npy_intp topology_dims[1];
+      topology_dims[0] = src_vector.size();
+      
+      py_section_src = create_shared_array_from_deque<SECTION_IDX_T>(std::move(src_vector));
+      py_section_dst = create_shared_array_from_deque<SECTION_IDX_T>(std::move(dst_vector));
 
-typedef struct {
-  PyObject_HEAD
-  NeuroH5TreeIterState *state;
-} PyNeuroH5TreeIterState;
+      npy_intp sections_dims[1];
+      sections_dims[0] = sections.size();
+      
+      py_sections = create_shared_array_from_deque<SECTION_IDX_T>(std::move(sections));
+    }
+  
+                           
 
+  npy_intp dims[1];
+  dims[0] = num_nodes;
 
-PyObject* NeuroH5TreeIter_iter(PyObject *self)
-{
-  Py_INCREF(self);
-  return self;
-}
+  PyObject *py_xcoords = create_shared_array_from_deque<COORD_T>(std::move(xcoords));
+  PyObject *py_ycoords = create_shared_array_from_deque<COORD_T>(std::move(ycoords));
+  PyObject *py_zcoords = create_shared_array_from_deque<COORD_T>(std::move(zcoords));
+  PyObject *py_radiuses = create_shared_array_from_deque<REALVAL_T>(std::move(radiuses));
+  PyObject *py_layers = create_shared_array_from_deque<LAYER_IDX_T>(std::move(layers));
+  PyObject *py_parents = create_shared_array_from_deque<PARENT_NODE_IDX_T>(std::move(parents));
+  PyObject *py_swc_types = create_shared_array_from_deque<SWC_TYPE_T>(std::move(swc_types));
+  
+  PyObject *py_treeval = PyDict_New();
+  PyDict_SetItemString(py_treeval, "x", py_xcoords);
+  Py_DECREF(py_xcoords);
 
-static void NeuroH5TreeIter_dealloc(PyNeuroH5TreeIterState *py_state)
-{
-  delete py_state->state;
-  Py_TYPE(py_state)->tp_free(py_state);
-}
+  PyDict_SetItemString(py_treeval, "y", py_ycoords);
+  Py_DECREF(py_ycoords);
+                           
+  PyDict_SetItemString(py_treeval, "z", py_zcoords);
+  Py_DECREF(py_zcoords);
 
+  PyDict_SetItemString(py_treeval, "radius", py_radiuses);
+  Py_DECREF(py_radiuses);
+                           
+  PyDict_SetItemString(py_treeval, "layer", py_layers);
+  Py_DECREF(py_layers);
+                           
+  PyDict_SetItemString(py_treeval, "parent", py_parents);
+  Py_DECREF(py_parents);
+                           
+  PyDict_SetItemString(py_treeval, "swc_type", py_swc_types);
+  Py_DECREF(py_swc_types);
 
-PyObject* NeuroH5TreeIter_iternext(PyObject *self)
-{
-  PyNeuroH5TreeIterState *py_state = (PyNeuroH5TreeIterState *)self;
-  if (py_state->state->it_tree != py_state->state->tree_list.cend())
+  if (topology)
     {
-      const neurotree_t &tree = *(py_state->state->it_tree);
-      const CELL_IDX_T key = get<0>(tree);
-      const map <string, NamedAttrMap>& attr_maps = py_state->state->attr_maps;
-
-      PyObject *treeval = py_build_tree_value(key, tree, attr_maps,
-                                              py_state->state->topology_flag,
-                                              py_state->state->validate_flag);
-      throw_assert(treeval != NULL,
-                   "NeuroH5TreeIter: invalid tree value");
+      throw_assert(py_section_vector != NULL,
+                   "py_build_tree_value: invalid section vector in tree");
+      throw_assert(py_section_topology != NULL,
+                   "py_build_tree_value: invalid section topology in tree");
       
-      py_state->state->it_tree++;
-      py_state->state->seq_index++;
+      PyDict_SetItemString(py_treeval, "section", py_section_vector);
+      Py_DECREF(py_section_vector);
 
-      PyObject *result = Py_BuildValue("lN", key, treeval);
-                               
-      return result;
+      PyDict_SetItemString(py_treeval, "section_topology", py_section_topology);
+      Py_DECREF(py_section_topology);
     }
   else
     {
-      /* Raising of standard StopIteration exception with empty value. */
-      PyErr_SetNone(PyExc_StopIteration);
-      return NULL;
-    }
-}
-
-
-static PyTypeObject PyNeuroH5TreeIter_Type = {
-  PyVarObject_HEAD_INIT(&PyType_Type, 0)
-  "NeuroH5TreeIter",         /*tp_name*/
+      throw_assert(py_sections != NULL,
+                   "py_build_tree_value: invalid sections in tree");
+      throw_assert(py_section_src != NULL,
+                   "py_build_tree_value: invalid source section vector in tree");
+      throw_assert(py_section_dst != NULL,
+                   "py_build_tree_value: invalid destination section vector in tree");
+
+      PyDict_SetItemString(py_treeval, "sections", py_sections);
+      Py_DECREF(py_sections);
+      PyDict_SetItemString(py_treeval, "src", py_section_src);
+      Py_DECREF(py_section_src);
+      PyDict_SetItemString(py_treeval, "dst", py_section_dst);
+      Py_DECREF(py_section_dst);
+    }
+                           
+  py_build_tree_attr_namespaces(idx, attr_maps, py_treeval);
+
+  return py_treeval;
+}
+
+/* The fields of tree i in a PackedTrees buffer, as used by
+ * py_build_tree_section_topology. */
+template <class T>
+struct packed_tree_field
+{
+  const T* data;
+  size_t n;
+
+  template <class P>
+  packed_tree_field(const vector<T>& values, const vector<P>& ptr, const size_t i) :
+    data(values.data() + ptr[i]), n(ptr[i+1] - ptr[i]) {};
+
+  size_t size() const { return n; }
+  const T& operator[] (size_t k) const { return data[k]; }
+};
+
+template <class T, class P>
+static PyObject* py_packed_tree_field(const std::shared_ptr<PackedTrees>& trees,
+                                      const vector<T>& values, const vector<P>& ptr,
+                                      const size_t i)
+{
+  packed_tree_field<T> field(values, ptr, i);
+  return create_shared_array_view<T, PackedTrees>(trees, field.data, field.n);
+}
+
+/* Builds the value of tree i of a PackedTrees buffer; the arrays of the
+ * tree fields are views into the buffer. */
+PyObject* py_build_tree_value(const CELL_IDX_T key, const std::shared_ptr<PackedTrees>& trees,
+                              const size_t i,
+                              const map <string, NamedAttrMap>& attr_maps,
+                              const bool topology, const bool validate)
+{
+  const CELL_IDX_T idx = trees->gids[i];
+  throw_assert(idx == key,
+               "py_build_tree_value: tree index mismatch");
+
+  if (validate)
+    {
+      neurotree_t tree;
+      trees->tree(i, tree);
+      cell::validate_tree(tree);
+    }
+
+  size_t num_nodes = trees->num_nodes(i);
+
+  PyObject *py_section_topology = NULL;
+  PyObject *py_section_vector = NULL;
+  PyObject *py_sections = NULL;
+  PyObject *py_section_src = py_packed_tree_field(trees, trees->src_sections, trees->topo_ptr, i);
+  PyObject *py_section_dst = py_packed_tree_field(trees, trees->dst_sections, trees->topo_ptr, i);
+
+  if (topology)
+    {
+      py_section_topology =
+        py_build_tree_section_topology(packed_tree_field<SECTION_IDX_T>(trees->src_sections, trees->topo_ptr, i),
+                                       packed_tree_field<SECTION_IDX_T>(trees->dst_sections, trees->topo_ptr, i),
+                                       packed_tree_field<SECTION_IDX_T>(trees->sections, trees->sec_ptr, i),
+                                       packed_tree_field<PARENT_NODE_IDX_T>(trees->parents, trees->attr_ptr, i),
+                                       num_nodes, py_section_src, py_section_dst,
+                                       py_section_vector);
+    }
+  else
+    {
+      py_sections = py_packed_tree_field(trees, trees->sections, trees->sec_ptr, i);
+    }
+
+  PyObject *py_xcoords = py_packed_tree_field(trees, trees->xcoords, trees->attr_ptr, i);
+  PyObject *py_ycoords = py_packed_tree_field(trees, trees->ycoords, trees->attr_ptr, i);
+  PyObject *py_zcoords = py_packed_tree_field(trees, trees->zcoords, trees->attr_ptr, i);
+  PyObject *py_radiuses = py_packed_tree_field(trees, trees->radiuses, trees->attr_ptr, i);
+  PyObject *py_layers = py_packed_tree_field(trees, trees->layers, trees->attr_ptr, i);
+  PyObject *py_parents = py_packed_tree_field(trees, trees->parents, trees->attr_ptr, i);
+  PyObject *py_swc_types = py_packed_tree_field(trees, trees->swc_types, trees->attr_ptr, i);
+
+  PyObject *py_treeval = PyDict_New();
+  PyDict_SetItemString(py_treeval, "x", py_xcoords);
+  Py_DECREF(py_xcoords);
+
+  PyDict_SetItemString(py_treeval, "y", py_ycoords);
+  Py_DECREF(py_ycoords);
+                           
+  PyDict_SetItemString(py_treeval, "z", py_zcoords);
+  Py_DECREF(py_zcoords);
+
+  PyDict_SetItemString(py_treeval, "radius", py_radiuses);
+  Py_DECREF(py_radiuses);
+                           
+  PyDict_SetItemString(py_treeval, "layer", py_layers);
+  Py_DECREF(py_layers);
+                           
+  PyDict_SetItemString(py_treeval, "parent", py_parents);
+  Py_DECREF(py_parents);
+                           
+  PyDict_SetItemString(py_treeval, "swc_type", py_swc_types);
+  Py_DECREF(py_swc_types);
+
+  if (topology)
+    {
+      throw_assert(py_section_vector != NULL,
+                   "py_build_tree_value: invalid section vector in tree");
+      throw_assert(py_section_topology != NULL,
+                   "py_build_tree_value: invalid section topology in tree");
+      
+      PyDict_SetItemString(py_treeval, "section", py_section_vector);
+      Py_DECREF(py_section_vector);
+
+      PyDict_SetItemString(py_treeval, "section_topology", py_section_topology);
+      Py_DECREF(py_section_topology);
+    }
+  else
+    {
+      throw_assert(py_sections != NULL,
+                   "py_build_tree_value: invalid sections in tree");
+
+      PyDict_SetItemString(py_treeval, "sections", py_sections);
+      Py_DECREF(py_sections);
+      PyDict_SetItemString(py_treeval, "src", py_section_src);
+      Py_DECREF(py_section_src);
+      PyDict_SetItemString(py_treeval, "dst", py_section_dst);
+      Py_DECREF(py_section_dst);
+    }
+
+  py_build_tree_attr_namespaces(idx, attr_maps, py_treeval);
+
+  return py_treeval;
+}
+
+/* NeuroH5TreeIterState - in-memory tree iterator instance.
+ *
+ * seq_index: index of the next id in the sequence to yield
+ *
+ */
+typedef struct {
+  Py_ssize_t seq_index, count;
+                           
+  forward_list <neurotree_t> tree_list;
+  vector<string> attr_name_spaces;
+  map <string, NamedAttrMap> attr_maps;
+  forward_list<neurotree_t>::const_iterator it_tree;
+  // if set, trees are read from packed_trees in the order of it_packed
+  std::shared_ptr<PackedTrees> packed_trees;
+  size_t it_packed;
+  bool topology_flag;
+  bool validate_flag;
+  
+} NeuroH5TreeIterState;
+
+typedef struct {
+  PyObject_HEAD
+  NeuroH5TreeIterState *state;
+} PyNeuroH5TreeIterState;
+
+
+PyObject* NeuroH5TreeIter_iter(PyObject *self)
+{
+  Py_INCREF(self);
+  return self;
+}
+
+static void NeuroH5TreeIter_dealloc(PyNeuroH5TreeIterState *py_state)
+{
+  delete py_state->state;
+  Py_TYPE(py_state)->tp_free(py_state);
+}
+
+
+PyObject* NeuroH5TreeIter_iternext(PyObject *self)
+{
+  PyNeuroH5TreeIterState *py_state = (PyNeuroH5TreeIterState *)self;
+  if (py_state->state->packed_trees)
+    {
+      if (py_state->state->it_packed == 0)
+        {
+          PyErr_SetNone(PyExc_StopIteration);
+          return NULL;
+        }
+      // packed trees are returned in descending gid order, as with
+      // the tree lists built by read_trees
+      const size_t i = --(py_state->state->it_packed);
+      const CELL_IDX_T key = py_state->state->packed_trees->gids[i];
+
+      PyObject *treeval = py_build_tree_value(key, py_state->state->packed_trees, i,
+                                              py_state->state->attr_maps,
+                                              py_state->state->topology_flag,
+                                              py_state->state->validate_flag);
+      throw_assert(treeval != NULL,
+                   "NeuroH5TreeIter: invalid tree value");
+
+      py_state->state->seq_index++;
+
+      return Py_BuildValue("lN", key, treeval);
+    }
+  else if (py_state->state->it_tree != py_state->state->tree_list.cend())
+    {
+      const neurotree_t &tree = *(py_state->state->it_tree);
+      const CELL_IDX_T key = get<0>(tree);
+      const map <string, NamedAttrMap>& attr_maps = py_state->state->attr_maps;
+
+      PyObject *treeval = py_build_tree_value(key, tree, attr_maps,
+                                              py_state->state->topology_flag,
+                                              py_state->state->validate_flag);
+      throw_assert(treeval != NULL,
+                   "NeuroH5TreeIter: invalid tree value");
+      
+      py_state->state->it_tree++;
+      py_state->state->seq_index++;
+
+      PyObject *result = Py_BuildValue("lN", key, treeval);
+                               
+      return result;
+    }
+  else
+    {
+      /* Raising of standard StopIteration exception with empty value. */
+      PyErr_SetNone(PyExc_StopIteration);
+      return NULL;
+    }
+}
+
+
+static PyTypeObject PyNeuroH5TreeIter_Type = {
+  PyVarObject_HEAD_INIT(&PyType_Type, 0)
+  "NeuroH5TreeIter",         /*tp_name*/
   sizeof(PyNeuroH5TreeIterState), /*tp_basicsize*/
   0,                         /*tp_itemsize*/
   (destructor)NeuroH5TreeIter_dealloc, /* tp_dealloc */
@@ -1489,6 +2267,39 @@ NeuroH5TreeIter_FromList(const forward_list <neurotree_t>& tree_list,
 
 
 
+static PyObject *
+NeuroH5TreeIter_FromPackedTrees(const std::shared_ptr<PackedTrees>& packed_trees,
+                                const vector<string>& attr_name_spaces,
+                                const map <string, NamedAttrMap>& attr_maps,
+                                const bool topology_flag, const bool validate_flag)
+{
+
+  PyNeuroH5TreeIterState *p = PyObject_New(PyNeuroH5TreeIterState, &PyNeuroH5TreeIter_Type);
+  if (!p) return NULL;
+
+  if (!PyObject_Init((PyObject *)p, &PyNeuroH5TreeIter_Type))
+    {
+      Py_DECREF(p);
+      return NULL;
+    }
+
+  p->state = new NeuroH5TreeIterState();
+
+  p->state->seq_index     = 0;
+  p->state->count         = packed_trees->num_trees();
+  p->state->packed_trees  = packed_trees;
+  p->state->it_packed     = packed_trees->num_trees();
+  p->state->attr_name_spaces = attr_name_spaces;
+  p->state->attr_maps  = attr_maps;
+  p->state->it_tree    = p->state->tree_list.cbegin();
+  p->state->topology_flag = topology_flag;
+  p->state->validate_flag = validate_flag;
+
+  return (PyObject *)p;
+}
+
+
+
 static PyObject *
 NeuroH5TreeIter_FromMap(const map<CELL_IDX_T, neurotree_t>& tree_map,
                         const vector<string>& attr_name_spaces,
@@ -1979,51 +2790,273 @@ PyObject* py_build_cell_attr_values_struct(const CELL_IDX_T key,
 }
 
 
-/* NeuroH5CellAttrIterState - in-memory cell attribute iterator instance.
- *
- * seq_index: index of the next id in the sequence to yield
- *
- */
-struct NeuroH5CellAttrIterState {
-                           
-  NamedAttrMap attr_map;
-  set<CELL_IDX_T>::const_iterator it_idx;
-  string attr_namespace;
-  vector< vector <string> > attr_names;
-  return_type return_tp;
-  Py_ssize_t seq_index, count;
-#if HAS_STRUCT_SEQUENCE
-  PyTypeObject* struct_type;
-  vector<PyStructSequence_Field> struct_descr_fields;
-  
-  explicit NeuroH5CellAttrIterState(NamedAttrMap&& attr_map,
-                                    const string& attr_namespace,
-                                    const vector< vector <string> >& attr_names,
-                                    const return_type& return_tp,
-                                    PyTypeObject* struct_type,
-                                    vector<PyStructSequence_Field>& struct_descr_fields
-                                    ) : attr_map(std::forward<NamedAttrMap>(attr_map)),
-                                        attr_namespace(attr_namespace),
-                                        attr_names(attr_names),
-                                        return_tp(return_tp),
-                                        struct_type(struct_type),
-                                        struct_descr_fields(struct_descr_fields)
-  {
-    this->it_idx = this->attr_map.index_set.cbegin();
-    this->count = this->attr_map.index_set.size();
-  }
-#else
-  
-  explicit NeuroH5CellAttrIterState(NamedAttrMap&& attr_map,
-                                    const string& attr_namespace,
-                                    const vector< vector <string> >& attr_names,
-                                    const return_type& return_tp
-                                    ) : attr_map(std::forward<NamedAttrMap>(attr_map)),
-                                        attr_namespace(attr_namespace),
-                                        attr_names(attr_names),
-                                        return_tp(return_tp),
-                                        seq_index(0)
-  {
+/* Cell attribute values held in a ColumnarAttrMap. The arrays returned
+ * for a cell are views into the attribute columns, which are kept alive
+ * by the shared pointer to the map. */
+
+template <class T>
+static void py_cell_attr_columns_find(const ColumnarAttrMap& attr_map,
+                                      const CELL_IDX_T key,
+                                      const size_t attr_type_index,
+                                      vector< pair<size_t, size_t> >& attr_columns)
+{
+  const vector< AttrColumn<T> >& columns = attr_map.columns<T>();
+  for (size_t i=0; i<columns.size(); i++)
+    {
+      if (columns[i].find(key) < columns[i].size())
+        {
+          attr_columns.push_back(make_pair(attr_type_index, i));
+        }
+    }
+}
+
+/* Returns the type index and attribute index of each attribute that has
+ * values for the given cell, in the order used by the NamedAttrMap
+ * builders above. */
+static void py_cell_attr_columns_find(const ColumnarAttrMap& attr_map,
+                                      const CELL_IDX_T key,
+                                      vector< pair<size_t, size_t> >& attr_columns)
+{
+  py_cell_attr_columns_find<float>(attr_map, key, AttrMap::attr_index_float, attr_columns);
+  py_cell_attr_columns_find<uint8_t>(attr_map, key, AttrMap::attr_index_uint8, attr_columns);
+  py_cell_attr_columns_find<int8_t>(attr_map, key, AttrMap::attr_index_int8, attr_columns);
+  py_cell_attr_columns_find<uint16_t>(attr_map, key, AttrMap::attr_index_uint16, attr_columns);
+  py_cell_attr_columns_find<int16_t>(attr_map, key, AttrMap::attr_index_int16, attr_columns);
+  py_cell_attr_columns_find<uint32_t>(attr_map, key, AttrMap::attr_index_uint32, attr_columns);
+  py_cell_attr_columns_find<int32_t>(attr_map, key, AttrMap::attr_index_int32, attr_columns);
+}
+
+static const char* py_cell_attr_type_name(const size_t attr_type_index)
+{
+  switch (attr_type_index)
+    {
+    case AttrMap::attr_index_float:  return "float";
+    case AttrMap::attr_index_uint8:  return "uint8";
+    case AttrMap::attr_index_int8:   return "int8";
+    case AttrMap::attr_index_uint16: return "uint16";
+    case AttrMap::attr_index_int16:  return "int16";
+    case AttrMap::attr_index_uint32: return "uint32";
+    case AttrMap::attr_index_int32:  return "int32";
+    default:
+      throw_err("py_cell_attr_type_name: unknown attribute type");
+    }
+  return NULL;
+}
+
+template <class T>
+static PyObject* py_cell_attr_column_view(const std::shared_ptr<ColumnarAttrMap>& attr_map,
+                                          const size_t attr_index,
+                                          const CELL_IDX_T key)
+{
+  const AttrColumn<T>& column = attr_map->columns<T>()[attr_index];
+  const size_t row = column.find(key);
+  return create_shared_array_view<T, ColumnarAttrMap>(attr_map, column.row_data(row),
+                                                      column.row_size(row));
+}
+
+static PyObject* py_cell_attr_column_view(const std::shared_ptr<ColumnarAttrMap>& attr_map,
+                                          const pair<size_t, size_t>& attr_column,
+                                          const CELL_IDX_T key)
+{
+  switch (attr_column.first)
+    {
+    case AttrMap::attr_index_float:
+      return py_cell_attr_column_view<float>(attr_map, attr_column.second, key);
+    case AttrMap::attr_index_uint8:
+      return py_cell_attr_column_view<uint8_t>(attr_map, attr_column.second, key);
+    case AttrMap::attr_index_int8:
+      return py_cell_attr_column_view<int8_t>(attr_map, attr_column.second, key);
+    case AttrMap::attr_index_uint16:
+      return py_cell_attr_column_view<uint16_t>(attr_map, attr_column.second, key);
+    case AttrMap::attr_index_int16:
+      return py_cell_attr_column_view<int16_t>(attr_map, attr_column.second, key);
+    case AttrMap::attr_index_uint32:
+      return py_cell_attr_column_view<uint32_t>(attr_map, attr_column.second, key);
+    case AttrMap::attr_index_int32:
+      return py_cell_attr_column_view<int32_t>(attr_map, attr_column.second, key);
+    default:
+      throw_err("py_cell_attr_column_view: unknown attribute type");
+    }
+  return NULL;
+}
+
+
+PyObject* py_build_cell_attr_values_dict(const CELL_IDX_T key, 
+                                         const std::shared_ptr<ColumnarAttrMap>& attr_map,
+                                         const vector <vector<string> >& attr_names)
+{
+  PyObject *py_attrval = PyDict_New();
+
+  vector< pair<size_t, size_t> > attr_columns;
+  py_cell_attr_columns_find(*attr_map, key, attr_columns);
+
+  for (const auto& attr_column : attr_columns)
+    {
+      PyObject *py_value = py_cell_attr_column_view(attr_map, attr_column, key);
+      PyDict_SetItemString(py_attrval,
+                           (attr_names[attr_column.first][attr_column.second]).c_str(),
+                           py_value);
+      Py_DECREF(py_value);
+    }
+
+  return py_attrval;
+}
+
+
+PyObject* py_build_cell_attr_tuple_info(const ColumnarAttrMap& attr_map,
+                                        const vector <vector<string> >& attr_names)
+{
+    PyObject* py_tuple_fields_dict = PyDict_New();
+    
+    if (attr_map.index.size() > 0)
+      {
+        vector< pair<size_t, size_t> > attr_columns;
+        py_cell_attr_columns_find(attr_map, attr_map.index.front(), attr_columns);
+
+        size_t attr_pos = 0;
+        for (const auto& attr_column : attr_columns)
+          {
+            char *attr_name = attr_name_intern.add(attr_names[attr_column.first][attr_column.second]);
+            PyObject *py_attr_index = PyLong_FromLong(attr_pos++);
+            PyDict_SetItemString(py_tuple_fields_dict, attr_name, py_attr_index);
+          }
+      }
+
+    return py_tuple_fields_dict;
+}
+
+
+PyObject* py_build_cell_attr_values_tuple(const CELL_IDX_T key, 
+                                          const std::shared_ptr<ColumnarAttrMap>& attr_map,
+                                          const vector <vector<string> >& attr_names)
+{
+  size_t n_elements = 0;
+  for (size_t i=0; i<attr_names.size(); i++)
+    {
+      n_elements += attr_names[i].size();
+    }
+  
+  PyObject* py_attrval = PyTuple_New(n_elements);
+  throw_assert_nomsg(py_attrval != NULL);
+
+  vector< pair<size_t, size_t> > attr_columns;
+  py_cell_attr_columns_find(*attr_map, key, attr_columns);
+
+  size_t attr_pos = 0;
+  for (const auto& attr_column : attr_columns)
+    {
+      PyObject *py_value = py_cell_attr_column_view(attr_map, attr_column, key);
+      PyTuple_SetItem(py_attrval, attr_pos++, py_value);
+    }
+
+  return py_attrval;
+}
+
+
+PyTypeObject* py_build_cell_attr_struct_type(const ColumnarAttrMap& attr_map,
+                                             const vector <vector<string> >& attr_names,
+                                             vector<PyStructSequence_Field> struct_descr_fields)
+{
+    PyStructSequence_Desc descr;
+    
+    PyTypeObject* structseq_type = NULL;
+
+    if (attr_map.index.size() > 0)
+      {
+        vector< pair<size_t, size_t> > attr_columns;
+        py_cell_attr_columns_find(attr_map, attr_map.index.front(), attr_columns);
+
+        for (const auto& attr_column : attr_columns)
+          {
+            char *attr_name = attr_name_intern.add(attr_names[attr_column.first][attr_column.second]);
+            char *attr_type = attr_name_intern.add(string(py_cell_attr_type_name(attr_column.first)));
+            struct_descr_fields.push_back((PyStructSequence_Field){attr_name, attr_type});
+          }
+
+        struct_descr_fields.push_back((PyStructSequence_Field){NULL, NULL});
+        
+        descr.name = attr_name_intern.add("neuroh5_cell_attributes");
+        descr.doc = "NeuroH5 cell attributes";
+        descr.fields = &struct_descr_fields[0];
+        descr.n_in_sequence = struct_descr_fields.size()-1;
+        
+        structseq_type = PyStructSequence_NewType(&descr);
+        throw_assert_nomsg(structseq_type != NULL);
+        throw_assert_nomsg(PyType_Check(structseq_type));
+        throw_assert_nomsg(PyType_FastSubclass(structseq_type, Py_TPFLAGS_TUPLE_SUBCLASS));
+      }
+
+    return structseq_type;
+}
+
+
+PyObject* py_build_cell_attr_values_struct(const CELL_IDX_T key, 
+                                           const std::shared_ptr<ColumnarAttrMap>& attr_map,
+                                           const vector <vector<string> >& attr_names,
+                                           PyTypeObject* struct_type)
+{
+  PyObject* py_attrval = PyStructSequence_New(struct_type);
+  throw_assert_nomsg(py_attrval != NULL);
+
+  vector< pair<size_t, size_t> > attr_columns;
+  py_cell_attr_columns_find(*attr_map, key, attr_columns);
+
+  size_t attr_pos = 0;
+  for (const auto& attr_column : attr_columns)
+    {
+      PyObject *py_value = py_cell_attr_column_view(attr_map, attr_column, key);
+      PyStructSequence_SetItem(py_attrval, attr_pos++, py_value);
+    }
+
+  return py_attrval;
+}
+
+
+/* NeuroH5CellAttrIterState - in-memory cell attribute iterator instance.
+ *
+ * seq_index: index of the next id in the sequence to yield
+ *
+ */
+struct NeuroH5CellAttrIterState {
+                           
+  NamedAttrMap attr_map;
+  set<CELL_IDX_T>::const_iterator it_idx;
+  string attr_namespace;
+  vector< vector <string> > attr_names;
+  return_type return_tp;
+  Py_ssize_t seq_index, count;
+#if HAS_STRUCT_SEQUENCE
+  PyTypeObject* struct_type;
+  vector<PyStructSequence_Field> struct_descr_fields;
+  
+  explicit NeuroH5CellAttrIterState(NamedAttrMap&& attr_map,
+                                    const string& attr_namespace,
+                                    const vector< vector <string> >& attr_names,
+                                    const return_type& return_tp,
+                                    PyTypeObject* struct_type,
+                                    vector<PyStructSequence_Field>& struct_descr_fields
+                                    ) : attr_map(std::forward<NamedAttrMap>(attr_map)),
+                                        attr_namespace(attr_namespace),
+                                        attr_names(attr_names),
+                                        return_tp(return_tp),
+                                        struct_type(struct_type),
+                                        struct_descr_fields(struct_descr_fields)
+  {
+    this->it_idx = this->attr_map.index_set.cbegin();
+    this->count = this->attr_map.index_set.size();
+  }
+#else
+  
+  explicit NeuroH5CellAttrIterState(NamedAttrMap&& attr_map,
+                                    const string& attr_namespace,
+                                    const vector< vector <string> >& attr_names,
+                                    const return_type& return_tp
+                                    ) : attr_map(std::forward<NamedAttrMap>(attr_map)),
+                                        attr_namespace(attr_namespace),
+                                        attr_names(attr_names),
+                                        return_tp(return_tp),
+                                        seq_index(0)
+  {
     this->it_idx = this->attr_map.index_set.cbegin();
     this->count = this->attr_map.index_set.size();
   }
@@ -2502,6 +3535,71 @@ PyObject* py_build_edge_array_dict_value (const NODE_IDX_T key,
 
 }
 
+template <class T>
+void py_set_edge_csr_attr_views (PyObject *py_attrvalmap,
+                                 const std::shared_ptr<EdgeCSR>& edge_csr,
+                                 const size_t namespace_index,
+                                 const size_t low, const size_t high,
+                                 const vector<string>& attr_names)
+{
+  const AttrVal& edge_attr_values = edge_csr->attrs[namespace_index];
+  for (size_t i = 0; i < edge_attr_values.size_attr_vec<T>(); i++)
+    {
+      const vector<T>& attr_vec = edge_attr_values.const_attr_vec<T>(i);
+      PyObject *py_arr = create_shared_array_view<T>(edge_csr, attr_vec.data()+low, high-low);
+      int status = PyDict_SetItemString(py_attrvalmap, attr_names[i].c_str(), py_arr);
+      throw_assert(status == 0,
+                   "py_build_edge_array_dict_value: unable to set dictionary item");
+      Py_DECREF(py_arr);
+    }
+}
+
+
+/* Builds the (adjacency, attributes) value of row i of a flat edge
+ * container; the arrays are views into the container and are not
+ * copied. */
+PyObject* py_build_edge_array_dict_value (const std::shared_ptr<EdgeCSR>& edge_csr,
+                                          const size_t i,
+                                          const vector<string>& edge_attr_name_spaces,
+                                          const map <string, vector <vector<string> > >& attr_names)
+{
+  const size_t low = edge_csr->row_begin(i), high = edge_csr->row_end(i);
+                
+  PyObject *adj_arr = create_shared_array_view<NODE_IDX_T>(edge_csr, edge_csr->adj.data()+low, high-low);
+
+  PyObject *py_attrmap  = PyDict_New();
+  for (size_t namespace_index = 0; namespace_index < edge_csr->attrs.size(); namespace_index++)
+    {
+      PyObject *py_attrvalmap  = PyDict_New();
+      const string& attr_namespace = edge_attr_name_spaces[namespace_index];
+      const vector <vector<string> >& ns_attr_names = attr_names.at(attr_namespace);
+
+      py_set_edge_csr_attr_views<float>(py_attrvalmap, edge_csr, namespace_index, low, high,
+                                        ns_attr_names[AttrVal::attr_index_float]);
+      py_set_edge_csr_attr_views<uint8_t>(py_attrvalmap, edge_csr, namespace_index, low, high,
+                                          ns_attr_names[AttrVal::attr_index_uint8]);
+      py_set_edge_csr_attr_views<uint16_t>(py_attrvalmap, edge_csr, namespace_index, low, high,
+                                           ns_attr_names[AttrVal::attr_index_uint16]);
+      py_set_edge_csr_attr_views<uint32_t>(py_attrvalmap, edge_csr, namespace_index, low, high,
+                                           ns_attr_names[AttrVal::attr_index_uint32]);
+      py_set_edge_csr_attr_views<int8_t>(py_attrvalmap, edge_csr, namespace_index, low, high,
+                                         ns_attr_names[AttrVal::attr_index_int8]);
+      py_set_edge_csr_attr_views<int16_t>(py_attrvalmap, edge_csr, namespace_index, low, high,
+                                          ns_attr_names[AttrVal::attr_index_int16]);
+      py_set_edge_csr_attr_views<int32_t>(py_attrvalmap, edge_csr, namespace_index, low, high,
+                                          ns_attr_names[AttrVal::attr_index_int32]);
+          
+      PyDict_SetItemString(py_attrmap, attr_namespace.c_str(), py_attrvalmap);
+      Py_DECREF(py_attrvalmap);
+    }
+                
+  PyObject *py_edgeval  = PyTuple_New(2);
+  PyTuple_SetItem(py_edgeval, 0, adj_arr);
+  PyTuple_SetItem(py_edgeval, 1, py_attrmap);
+
+  return py_edgeval;
+}
+
 /* NeuroH5EdgeIterState - in-memory edge iterator instance.
  *
  * seq_index: index of the next id in the sequence to yield
@@ -2625,6 +3723,121 @@ NeuroH5EdgeIter_FromMap(const edge_map_t& prj_edge_map,
 }
 
 
+// Returns a read-only array that refers to the elements of a dataset view
+template <class T>
+static PyObject *py_dataset_view_array (const hdf5::DatasetView<T>& view)
+{
+  if (view.empty())
+    {
+      npy_intp dims[1] = { 0 };
+      return PyArray_SimpleNew(1, dims, NumpyTypeMap<T>::type_num);
+    }
+
+  PyObject *py_array = create_shared_array_view<T, const void>(view.owner(), view.data(), view.size());
+  throw_assert(py_array != NULL,
+               "py_dataset_view_array: unable to create array");
+  PyArray_CLEARFLAGS((PyArrayObject *)py_array, NPY_ARRAY_WRITEABLE);
+  return py_array;
+}
+
+// Returns a dictionary with the index, pointer and value arrays of a cell
+// attribute view
+template <class T>
+static PyObject *py_cell_attribute_view_dict (const hdf5::CellAttributeView<T>& attr_view)
+{
+  PyObject *py_result = PyDict_New();
+  PyObject *py_index = py_dataset_view_array(attr_view.index);
+  PyObject *py_ptr = py_dataset_view_array(attr_view.ptr);
+  PyObject *py_value = py_dataset_view_array(attr_view.value);
+  PyDict_SetItemString(py_result, hdf5::CELL_INDEX.c_str(), py_index);
+  PyDict_SetItemString(py_result, hdf5::ATTR_PTR.c_str(), py_ptr);
+  PyDict_SetItemString(py_result, hdf5::ATTR_VAL.c_str(), py_value);
+  Py_DECREF(py_index);
+  Py_DECREF(py_ptr);
+  Py_DECREF(py_value);
+
+  return py_result;
+}
+
+template <class T>
+static PyObject *py_cell_attribute_view_dict (const hdf5::MappedFile& mapped_file,
+                                              const string& attr_namespace,
+                                              const string& pop_name,
+                                              const string& attr_name)
+{
+  return py_cell_attribute_view_dict
+    (hdf5::view_cell_attribute<T>(mapped_file, attr_namespace, pop_name, attr_name));
+}
+
+// Adds the views of the shared cell attributes of type T to py_attr_dict
+template <class T>
+static void py_shared_cell_attribute_dicts (const cell::SharedCellAttributes& attr_values,
+                                            PyObject *py_attr_dict)
+{
+  for (auto const& it : attr_values.attr_views<T>())
+    {
+      PyObject *py_attr_view = py_cell_attribute_view_dict(it.second);
+      PyDict_SetItemString(py_attr_dict, it.first.c_str(), py_attr_view);
+      Py_DECREF(py_attr_view);
+    }
+}
+
+// Adds the shared edge attribute columns of type T to py_ns_dict, by
+// attribute name
+template <class T>
+static void py_shared_attr_columns (const data::SharedAttrColumns& attr_columns,
+                                    const vector<string>& attr_names,
+                                    PyObject *py_ns_dict)
+{
+  const vector< hdf5::DatasetView<T> >& columns = attr_columns.attr_columns<T>();
+  throw_assert(columns.size() == attr_names.size(),
+               "py_shared_attr_columns: mismatch between attribute names and columns");
+  for (size_t k = 0; k < columns.size(); k++)
+    {
+      PyObject *py_column = py_dataset_view_array(columns[k]);
+      PyDict_SetItemString(py_ns_dict, attr_names[k].c_str(), py_column);
+      Py_DECREF(py_column);
+    }
+}
+
+// Returns a dictionary with the arrays of a shared projection
+static PyObject *py_shared_edge_csr_dict (const data::SharedEdgeCSR& prj_edge_csr,
+                                          const vector<string>& attr_namespaces,
+                                          const map <string, vector < vector <string> > >& edge_attr_names)
+{
+  PyObject *py_result = PyDict_New();
+  PyObject *py_keys = py_dataset_view_array(prj_edge_csr.keys);
+  PyObject *py_offsets = py_dataset_view_array(prj_edge_csr.offsets);
+  PyObject *py_adj = py_dataset_view_array(prj_edge_csr.adj);
+  PyDict_SetItemString(py_result, "keys", py_keys);
+  PyDict_SetItemString(py_result, "offsets", py_offsets);
+  PyDict_SetItemString(py_result, "adj", py_adj);
+  Py_DECREF(py_keys);
+  Py_DECREF(py_offsets);
+  Py_DECREF(py_adj);
+
+  PyObject *py_attrs = PyDict_New();
+  for (size_t ns = 0; ns < prj_edge_csr.attrs.size(); ns++)
+    {
+      const data::SharedAttrColumns& attr_columns = prj_edge_csr.attrs[ns];
+      const vector < vector <string> >& attr_names = edge_attr_names.at(attr_namespaces[ns]);
+      PyObject *py_ns_dict = PyDict_New();
+      py_shared_attr_columns<float>(attr_columns, attr_names[AttrVal::attr_index_float], py_ns_dict);
+      py_shared_attr_columns<uint8_t>(attr_columns, attr_names[AttrVal::attr_index_uint8], py_ns_dict);
+      py_shared_attr_columns<int8_t>(attr_columns, attr_names[AttrVal::attr_index_int8], py_ns_dict);
+      py_shared_attr_columns<uint16_t>(attr_columns, attr_names[AttrVal::attr_index_uint16], py_ns_dict);
+      py_shared_attr_columns<int16_t>(attr_columns, attr_names[AttrVal::attr_index_int16], py_ns_dict);
+      py_shared_attr_columns<uint32_t>(attr_columns, attr_names[AttrVal::attr_index_uint32], py_ns_dict);
+      py_shared_attr_columns<int32_t>(attr_columns, attr_names[AttrVal::attr_index_int32], py_ns_dict);
+      PyDict_SetItemString(py_attrs, attr_namespaces[ns].c_str(), py_ns_dict);
+      Py_DECREF(py_ns_dict);
+    }
+  PyDict_SetItemString(py_result, "attrs", py_attrs);
+  Py_DECREF(py_attrs);
+
+  return py_result;
+}
+
 
 extern "C"
 {
@@ -2854,11 +4067,8 @@ extern "C"
       }
     else
       {
-        // round-robin node to rank assignment from file
-        for (size_t i = 0; i < total_num_nodes; i++)
-          {
-            node_rank_map[i].insert(i%size);
-          }
+        // round-robin node to rank assignment
+        node_rank_map.assign_round_robin(0, total_num_nodes, size);
       }
 
     graph::scatter_read_graph(comm, edge_map_type, std::string(input_file_name),
@@ -2922,17 +4132,21 @@ extern "C"
     MPI_Comm *comm_ptr  = NULL;
     PyObject *py_attr_name_spaces=NULL;
     size_t total_num_nodes, total_num_edges = 0, local_num_edges = 0;
+    int opt_shared = 0;
+    vector < data::SharedEdgeCSR > shared_prj_vector;
     
     static const char *kwlist[] = {
                                    "file_name",
                                    "comm",
                                    "namespaces",
                                    "map_type",
+                                   "shared",
                                    NULL};
 
-    if (!PyArg_ParseTupleAndKeywords(args, kwds, "s|OOi", (char **)kwlist,
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "s|OOip", (char **)kwlist,
                                      &input_file_name, &py_comm, 
-                                     &py_attr_name_spaces, &opt_edge_map_type))
+                                     &py_attr_name_spaces, &opt_edge_map_type,
+                                     &opt_shared))
       return NULL;
 
     MPI_Comm comm;
@@ -2985,9 +4199,19 @@ extern "C"
     throw_assert(status >= 0,
                  "py_bcast_graph: unable to read population ranges");
 
-    graph::bcast_graph(comm, edge_map_type, std::string(input_file_name),
-                       edge_attr_name_spaces, prj_names, prj_vector, edge_attr_name_vector, 
-                       total_num_nodes, local_num_edges, total_num_edges);
+    if (opt_shared)
+      {
+        // one copy of each projection per node, returned as arrays
+        graph::bcast_graph_shared(comm, edge_map_type, std::string(input_file_name),
+                                  edge_attr_name_spaces, prj_names, shared_prj_vector,
+                                  edge_attr_name_vector, total_num_nodes);
+      }
+    else
+      {
+        graph::bcast_graph(comm, edge_map_type, std::string(input_file_name),
+                           edge_attr_name_spaces, prj_names, prj_vector, edge_attr_name_vector, 
+                           total_num_nodes, local_num_edges, total_num_edges);
+      }
     status = MPI_Comm_free(&comm);
     throw_assert(status == MPI_SUCCESS,
                  "py_bcast_graph: unable to free MPI communicator");
@@ -3025,10 +4249,20 @@ extern "C"
         Py_DECREF(py_prj_attr_info);
       }
 
-    for (size_t i = 0; i < prj_vector.size(); i++)
+    for (size_t i = 0; i < std::max(prj_vector.size(), shared_prj_vector.size()); i++)
       {
-        PyObject *py_edge_dict = PyDict_New();
-        edge_map_t prj_edge_map = prj_vector[i];
+        PyObject *py_edge_dict;
+        edge_map_t prj_edge_map;
+        if (opt_shared)
+          {
+            py_edge_dict = py_shared_edge_csr_dict(shared_prj_vector[i], edge_attr_name_spaces,
+                                                   edge_attr_name_vector[i]);
+          }
+        else
+          {
+            py_edge_dict = PyDict_New();
+            prj_edge_map = prj_vector[i];
+          }
         
         if (prj_edge_map.size() > 0)
           {
@@ -3352,6 +4586,8 @@ extern "C"
     unsigned long io_size = 0;
     const unsigned long default_chunk_size = 4000;
     unsigned long chunk_size = default_chunk_size;
+    PyObject *py_compression = NULL;
+    int edge_index = 0;
     
     static const char *kwlist[] = {
                                    "file_name",
@@ -3361,12 +4597,18 @@ extern "C"
                                    "comm",
                                    "io_size",
                                    "chunk_size",
+                                   "compression",
+                                   "edge_index",
                                    NULL};
 
-    if (!PyArg_ParseTupleAndKeywords(args, kwds, "sssO|Okk", (char **)kwlist,
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "sssO|OkkOp", (char **)kwlist,
                                      &file_name_arg, &src_pop_name_arg, &dst_pop_name_arg,
-                                     &edge_values, &py_comm, &io_size, &chunk_size))
+                                     &edge_values, &py_comm, &io_size, &chunk_size,
+                                     &py_compression, &edge_index))
       return NULL;
+    hdf5::DatasetCreationPolicy dataset_policy;
+    build_dataset_creation_policy(py_compression, dataset_policy);
+
     MPI_Comm comm;
 
     if ((py_comm != NULL) && (py_comm != Py_None))
@@ -3432,7 +4674,8 @@ extern "C"
         build_edge_map(edge_values, edge_attr_index, edge_map);
         
         status = graph::write_graph(data_comm, io_size, file_name, src_pop_name, dst_pop_name,
-                                    edge_attr_index, edge_map, chunk_size);
+                                    edge_attr_index, edge_map, chunk_size, dataset_policy,
+                                    edge_index > 0);
         throw_assert(status >= 0,
                      "py_write_graph: unable to write graph");
       }
@@ -3465,6 +4708,8 @@ extern "C"
     unsigned long io_size = 0;
     const unsigned long default_chunk_size = 4000;
     unsigned long chunk_size = default_chunk_size;
+    PyObject *py_compression = NULL;
+    int edge_index = 0;
         
     static const char *kwlist[] = {
                                    "file_name",
@@ -3472,13 +4717,19 @@ extern "C"
                                    "comm",
                                    "io_size",
                                    "chunk_size",
+                                   "compression",
+                                   "edge_index",
                                    NULL};
 
-    if (!PyArg_ParseTupleAndKeywords(args, kwds, "sO|Okk", (char **)kwlist,
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "sO|OkkOp", (char **)kwlist,
                                      &file_name_arg, &py_edge_dict,
-                                     &py_comm, &io_size, &chunk_size))
+                                     &py_comm, &io_size, &chunk_size, &py_compression,
+                                     &edge_index))
       return NULL;
 
+    hdf5::DatasetCreationPolicy dataset_policy;
+    build_dataset_creation_policy(py_compression, dataset_policy);
+
     MPI_Comm comm;
 
     if ((py_comm != NULL) && (py_comm != Py_None))
@@ -3548,7 +4799,8 @@ extern "C"
                 const edge_map_t & edge_map = edge_map_item.second.second; 
 
                 status = graph::append_graph(data_comm, io_size, file_name, src_pop_name, dst_pop_name,
-                                             edge_attr_index, edge_map, chunk_size);
+                                             edge_attr_index, edge_map, chunk_size,
+                                             dataset_policy, edge_index > 0);
                 throw_assert(status >= 0,
                              "py_append_graph: unable to append projection");
                 
@@ -3573,6 +4825,154 @@ extern "C"
     Py_INCREF(Py_None);
     return Py_None;
   }
+
+
+  // Writes (append=false) or appends (append=true) a projection given as
+  // NumPy arrays in CSR layout, without building edge maps
+  static PyObject *py_write_graph_arrays_mode (PyObject *args, PyObject *kwds,
+                                               const bool append, const char *fn_name)
+  {
+    int status;
+    PyObject *py_dst_gids, *py_dst_ptr, *py_src_gids;
+    PyObject *py_edge_attrs = NULL;
+    PyObject *py_comm  = NULL;
+    MPI_Comm *comm_ptr = NULL;
+    char *file_name_arg, *src_pop_name_arg, *dst_pop_name_arg;
+    unsigned long io_size = 0;
+    const unsigned long default_chunk_size = 4000;
+    unsigned long chunk_size = default_chunk_size;
+    PyObject *py_compression = NULL;
+    int edge_index = 0;
+    
+    static const char *kwlist[] = {
+                                   "file_name",
+                                   "src_pop_name",
+                                   "dst_pop_name",
+                                   "dst_gids",
+                                   "dst_ptr",
+                                   "src_gids",
+                                   "edge_attrs",
+                                   "comm",
+                                   "io_size",
+                                   "chunk_size",
+                                   "compression",
+                                   "edge_index",
+                                   NULL};
+
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "sssOOO|OOkkOp", (char **)kwlist,
+                                     &file_name_arg, &src_pop_name_arg, &dst_pop_name_arg,
+                                     &py_dst_gids, &py_dst_ptr, &py_src_gids, &py_edge_attrs,
+                                     &py_comm, &io_size, &chunk_size,
+                                     &py_compression, &edge_index))
+      return NULL;
+    hdf5::DatasetCreationPolicy dataset_policy;
+    build_dataset_creation_policy(py_compression, dataset_policy);
+
+    MPI_Comm comm;
+
+    if ((py_comm != NULL) && (py_comm != Py_None))
+      {
+        comm_ptr = PyMPIComm_Get(py_comm);
+        throw_assert(comm_ptr != NULL,
+                     fn_name << ": invalid MPI communicator");
+        throw_assert(*comm_ptr != MPI_COMM_NULL,
+                     fn_name << ": invalid MPI communicator");
+        status = MPI_Comm_dup(*comm_ptr, &comm);
+        throw_assert(status == MPI_SUCCESS,
+                     fn_name << ": unable to duplicate MPI communicator");
+      }
+    else
+      {
+        status = MPI_Comm_dup(MPI_COMM_WORLD, &comm);
+        throw_assert(status == MPI_SUCCESS,
+                     fn_name << ": unable to duplicate MPI communicator");
+      }
+
+    int size;
+    status = MPI_Comm_size(comm, &size);
+    throw_assert(status == MPI_SUCCESS,
+                 fn_name << ": unable to obtain size of MPI communicator");
+    if (io_size == 0)
+      {
+        io_size = size;
+      }
+
+    // every rank takes part, including ranks without edges; the ranks
+    // agree on the attribute names and types before any exchange, so
+    // that invalid arguments raise an error on all ranks
+    map<string, map<string, int> > attr_types;
+    string local_error;
+    try
+      {
+        if ((py_edge_attrs != NULL) && (py_edge_attrs != Py_None))
+          {
+            throw_assert(PyDict_Check(py_edge_attrs),
+                         fn_name << ": edge_attrs must be a dictionary");
+            get_edge_array_attr_types (py_edge_attrs, attr_types);
+          }
+      }
+    catch (const std::exception& e)
+      {
+        local_error = e.what();
+      }
+    agree_attribute_types(comm, fn_name, local_error, attr_types);
+
+    map <string, pair <size_t, AttrIndex > > edge_attr_index;
+    get_edge_array_attr_index (attr_types, edge_attr_index);
+
+    data::EdgeCSR edges;
+    try
+      {
+        build_edge_csr (py_dst_gids, py_dst_ptr, py_src_gids, py_edge_attrs,
+                        attr_types, edge_attr_index, edges);
+      }
+    catch (const std::exception& e)
+      {
+        local_error = e.what();
+      }
+    check_collective_error(comm, fn_name, local_error);
+
+    string file_name = string(file_name_arg);
+    string src_pop_name = string(src_pop_name_arg);
+    string dst_pop_name = string(dst_pop_name_arg);
+
+    if (append)
+      {
+        status = graph::append_graph(comm, io_size, file_name, src_pop_name, dst_pop_name,
+                                     edge_attr_index, edges, chunk_size,
+                                     dataset_policy, edge_index > 0);
+      }
+    else
+      {
+        status = graph::write_graph(comm, io_size, file_name, src_pop_name, dst_pop_name,
+                                    edge_attr_index, edges, chunk_size,
+                                    dataset_policy, edge_index > 0);
+      }
+    throw_assert(status >= 0,
+                 fn_name << ": unable to write projection");
+
+    status = MPI_Barrier(comm);
+    throw_assert(status == MPI_SUCCESS,
+                 fn_name << ": barrier error");
+    status = MPI_Comm_free(&comm);
+    throw_assert(status == MPI_SUCCESS,
+                 fn_name << ": unable to free MPI communicator");
+
+    Py_INCREF(Py_None);
+    return Py_None;
+  }
+
+
+  static PyObject *py_write_graph_arrays (PyObject *self, PyObject *args, PyObject *kwds)
+  {
+    return py_write_graph_arrays_mode(args, kwds, false, "py_write_graph_arrays");
+  }
+
+
+  static PyObject *py_append_graph_arrays (PyObject *self, PyObject *args, PyObject *kwds)
+  {
+    return py_write_graph_arrays_mode(args, kwds, true, "py_append_graph_arrays");
+  }
   
   PyDoc_STRVAR(
     read_population_names_doc,
@@ -3661,10 +5061,599 @@ extern "C"
         PyList_Append(py_population_names, name);
         Py_DECREF(name);
       }
-    
-    return py_population_names;
+    
+    return py_population_names;
+  }
+  
+  // File sessions opened from Python, by file name
+  static map<string, std::unique_ptr<hdf5::FileSession> > py_file_sessions;
+
+  PyDoc_STRVAR(
+    open_file_session_doc,
+    "open_file_session(file_name, comm=None, chunk_cache_size=16777216, metadata_cache_size=33554432, collective_metadata=True)\n"
+    "--\n"
+    "\n"
+    "Opens the given file collectively and keeps it open until close_file_session is called.\n"
+    "While the session is open, read functions called with the same communicator use\n"
+    "the open file instead of opening it again, and population, projection and attribute\n"
+    "metadata are read once and cached.\n"
+    "Parameters\n"
+    "----------\n"
+    "file_name : string\n"
+    "    The NeuroH5 file to open.\n"
+    "\n"
+    "comm : MPI communicator\n"
+    "    Optional MPI communicator. If None, the world communicator will be used.\n"
+    "\n"
+    "chunk_cache_size : int\n"
+    "    Size in bytes of the raw data chunk cache.\n"
+    "\n"
+    "metadata_cache_size : int\n"
+    "    Initial size in bytes of the metadata cache.\n"
+    "\n"
+    "collective_metadata : bool\n"
+    "    Whether metadata reads are collective over the communicator.\n"
+    "\n");
+
+  static PyObject *py_open_file_session (PyObject *self, PyObject *args, PyObject *kwds)
+  {
+    char *file_name;
+    PyObject *py_comm = NULL;
+    unsigned long chunk_cache_size = 16*1024*1024, metadata_cache_size = 32*1024*1024;
+    int collective_metadata = 1;
+    MPI_Comm *comm_ptr  = NULL;
+
+    static const char *kwlist[] = {
+                                   "file_name",
+                                   "comm",
+                                   "chunk_cache_size",
+                                   "metadata_cache_size",
+                                   "collective_metadata",
+                                   NULL};
+
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "s|Okkp", (char **)kwlist,
+                                     &file_name, &py_comm, &chunk_cache_size,
+                                     &metadata_cache_size, &collective_metadata))
+      return NULL;
+
+    MPI_Comm comm = MPI_COMM_WORLD;
+    if ((py_comm != NULL) && (py_comm != Py_None))
+      {
+        comm_ptr = PyMPIComm_Get(py_comm);
+        throw_assert(comm_ptr != NULL,
+                     "py_open_file_session: invalid MPI communicator");
+        throw_assert(*comm_ptr != MPI_COMM_NULL,
+                     "py_open_file_session: invalid MPI communicator");
+        comm = *comm_ptr;
+      }
+
+    throw_assert(py_file_sessions.find(string(file_name)) == py_file_sessions.end(),
+                 "py_open_file_session: a session is already open for file " << file_name);
+
+    hdf5::FileSessionOptions options;
+    options.chunk_cache_size = chunk_cache_size;
+    options.metadata_cache_size = metadata_cache_size;
+    options.collective_metadata = collective_metadata > 0;
+
+    py_file_sessions[string(file_name)] =
+      std::unique_ptr<hdf5::FileSession>(new hdf5::FileSession(comm, string(file_name), options));
+
+    Py_INCREF(Py_None);
+    return Py_None;
+  }
+
+  PyDoc_STRVAR(
+    close_file_session_doc,
+    "close_file_session(file_name)\n"
+    "--\n"
+    "\n"
+    "Closes the session opened for the given file by open_file_session.\n"
+    "This function is collective over the communicator of the session.\n"
+    "\n");
+
+  static PyObject *py_close_file_session (PyObject *self, PyObject *args, PyObject *kwds)
+  {
+    char *file_name;
+
+    static const char *kwlist[] = {
+                                   "file_name",
+                                   NULL};
+
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "s", (char **)kwlist, &file_name))
+      return NULL;
+
+    auto it = py_file_sessions.find(string(file_name));
+    throw_assert(it != py_file_sessions.end(),
+                 "py_close_file_session: no session is open for file " << file_name);
+    py_file_sessions.erase(it);
+
+    Py_INCREF(Py_None);
+    return Py_None;
+  }
+
+  PyDoc_STRVAR(
+    enable_stats_doc,
+    "enable_stats(enabled=True)\n"
+    "--\n"
+    "\n"
+    "Enables or disables the collection of phase statistics by the collective\n"
+    "read and write functions. Collection is also enabled by setting the\n"
+    "environment variable NEUROH5_STATS to a nonzero value.\n"
+    "\n");
+
+  static PyObject *py_enable_stats (PyObject *self, PyObject *args, PyObject *kwds)
+  {
+    int enabled = 1;
+
+    static const char *kwlist[] = {
+                                   "enabled",
+                                   NULL};
+
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "|p", (char **)kwlist, &enabled))
+      return NULL;
+
+    mpi::enable_stats(enabled > 0);
+
+    Py_INCREF(Py_None);
+    return Py_None;
+  }
+
+  PyDoc_STRVAR(
+    reset_stats_doc,
+    "reset_stats()\n"
+    "--\n"
+    "\n"
+    "Discards the phase statistics collected so far by this process.\n"
+    "\n");
+
+  static PyObject *py_reset_stats (PyObject *self, PyObject *args)
+  {
+    mpi::reset_stats();
+
+    Py_INCREF(Py_None);
+    return Py_None;
+  }
+
+  static PyObject* py_stat_summary (const mpi::StatSummary& summary)
+  {
+    PyObject *py_summary = PyDict_New();
+    const pair<const char*, double> values[] = {
+      { "min", summary.min }, { "mean", summary.mean },
+      { "max", summary.max }, { "imbalance", summary.imbalance } };
+    for (const auto& value : values)
+      {
+        PyObject *py_value = PyFloat_FromDouble(value.second);
+        PyDict_SetItemString(py_summary, value.first, py_value);
+        Py_DECREF(py_value);
+      }
+    return py_summary;
+  }
+
+  PyDoc_STRVAR(
+    get_stats_doc,
+    "get_stats(comm=None)\n"
+    "--\n"
+    "\n"
+    "Returns the phase statistics collected by all ranks of the communicator.\n"
+    "This function is collective over the communicator.\n"
+    "\n"
+    "The result is a dictionary with the number of ranks, the peak resident\n"
+    "set size, and a dictionary of phases. Phases are named by the function\n"
+    "that runs them, nested phases as \"outer/inner\". For each phase, the\n"
+    "counters time, calls, bytes_read, bytes_written, bytes_sent, bytes_recv,\n"
+    "messages_sent and messages_recv are given as dictionaries of their min,\n"
+    "mean and max over ranks and of their imbalance (max / mean).\n"
+    "\n");
+
+  static PyObject *py_get_stats (PyObject *self, PyObject *args, PyObject *kwds)
+  {
+    PyObject *py_comm = NULL;
+    MPI_Comm *comm_ptr  = NULL;
+
+    static const char *kwlist[] = {
+                                   "comm",
+                                   NULL};
+
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "|O", (char **)kwlist, &py_comm))
+      return NULL;
+
+    MPI_Comm comm = MPI_COMM_WORLD;
+    if ((py_comm != NULL) && (py_comm != Py_None))
+      {
+        comm_ptr = PyMPIComm_Get(py_comm);
+        throw_assert(comm_ptr != NULL,
+                     "py_get_stats: invalid MPI communicator");
+        throw_assert(*comm_ptr != MPI_COMM_NULL,
+                     "py_get_stats: invalid MPI communicator");
+        comm = *comm_ptr;
+      }
+
+    mpi::StatsReport report;
+    mpi::collect_stats(comm, report);
+
+    PyObject *py_stats = PyDict_New();
+    PyObject *py_num_ranks = PyLong_FromLong(report.num_ranks);
+    PyDict_SetItemString(py_stats, "ranks", py_num_ranks);
+    Py_DECREF(py_num_ranks);
+    PyObject *py_peak_rss = py_stat_summary(report.peak_rss_bytes);
+    PyDict_SetItemString(py_stats, "peak_rss_bytes", py_peak_rss);
+    Py_DECREF(py_peak_rss);
+
+    PyObject *py_phases = PyDict_New();
+    for (const auto& phase_iter : report.phases)
+      {
+        PyObject *py_phase = PyDict_New();
+        for (const auto& counter_iter : phase_iter.second)
+          {
+            PyObject *py_summary = py_stat_summary(counter_iter.second);
+            PyDict_SetItemString(py_phase, counter_iter.first.c_str(), py_summary);
+            Py_DECREF(py_summary);
+          }
+        PyDict_SetItemString(py_phases, phase_iter.first.c_str(), py_phase);
+        Py_DECREF(py_phase);
+      }
+    PyDict_SetItemString(py_stats, "phases", py_phases);
+    Py_DECREF(py_phases);
+
+    return py_stats;
+  }
+
+  PyDoc_STRVAR(
+    release_shared_doc,
+    "release_shared(comm=None)\n"
+    "--\n"
+    "\n"
+    "Frees the node-shared memory of the arrays returned with shared=True\n"
+    "that have been garbage-collected on all ranks of their node, and returns\n"
+    "the number of segments freed on this rank. This function is collective\n"
+    "over the communicator, which must contain all ranks of the nodes whose\n"
+    "segments are to be freed. Collecting the arrays alone does not free the\n"
+    "memory.\n"
+    "\n");
+
+  static PyObject *py_release_shared (PyObject *self, PyObject *args, PyObject *kwds)
+  {
+    PyObject *py_comm = NULL;
+    MPI_Comm *comm_ptr  = NULL;
+
+    static const char *kwlist[] = {
+                                   "comm",
+                                   NULL};
+
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "|O", (char **)kwlist, &py_comm))
+      return NULL;
+
+    MPI_Comm comm = MPI_COMM_WORLD;
+    if ((py_comm != NULL) && (py_comm != Py_None))
+      {
+        comm_ptr = PyMPIComm_Get(py_comm);
+        throw_assert(comm_ptr != NULL,
+                     "py_release_shared: invalid MPI communicator");
+        throw_assert(*comm_ptr != MPI_COMM_NULL,
+                     "py_release_shared: invalid MPI communicator");
+        comm = *comm_ptr;
+      }
+
+    size_t num_freed = mpi::release_shared_segments(comm);
+
+    return PyLong_FromSize_t(num_freed);
+  }
+
+  PyDoc_STRVAR(
+    read_projection_arrays_doc,
+    "read_projection_arrays(file_name, src_pop_name, dst_pop_name)\n"
+    "--\n"
+    "\n"
+    "Reads the Destination Block Sparse datasets of a projection in the calling process, without MPI.\n"
+    "Datasets with contiguous storage are mapped into memory and returned as read-only\n"
+    "arrays that refer to the mapping; other datasets, such as the chunked datasets\n"
+    "created by write_graph, are read into memory.\n"
+    "Parameters\n"
+    "----------\n"
+    "file_name : string\n"
+    "    The NeuroH5 file to read.\n"
+    "\n"
+    "src_pop_name : string\n"
+    "    Source population of the projection.\n"
+    "\n"
+    "dst_pop_name : string\n"
+    "    Destination population of the projection.\n"
+    "\n"
+    "Returns\n"
+    "-------\n"
+    "arrays : dict\n"
+    "   A dictionary of the arrays 'Destination Block Pointer', 'Destination Block Index',\n"
+    "   'Destination Pointer' and 'Source Index'.\n"
+    "\n");
+
+  static PyObject *py_read_projection_arrays (PyObject *self, PyObject *args, PyObject *kwds)
+  {
+    char *file_name, *src_pop_name, *dst_pop_name;
+
+    static const char *kwlist[] = {
+                                   "file_name",
+                                   "src_pop_name",
+                                   "dst_pop_name",
+                                   NULL};
+
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "sss", (char **)kwlist,
+                                     &file_name, &src_pop_name, &dst_pop_name))
+      return NULL;
+
+    hdf5::MappedFile mapped_file(file_name);
+    hdf5::ProjectionView prj_view =
+      hdf5::view_projection(mapped_file, string(src_pop_name), string(dst_pop_name));
+
+    PyObject *py_result = PyDict_New();
+    PyObject *py_dst_blk_ptr = py_dataset_view_array(prj_view.dst_blk_ptr);
+    PyObject *py_dst_blk_idx = py_dataset_view_array(prj_view.dst_blk_idx);
+    PyObject *py_dst_ptr = py_dataset_view_array(prj_view.dst_ptr);
+    PyObject *py_src_idx = py_dataset_view_array(prj_view.src_idx);
+    PyDict_SetItemString(py_result, hdf5::DST_BLK_PTR.c_str(), py_dst_blk_ptr);
+    PyDict_SetItemString(py_result, hdf5::DST_BLK_IDX.c_str(), py_dst_blk_idx);
+    PyDict_SetItemString(py_result, hdf5::DST_PTR.c_str(), py_dst_ptr);
+    PyDict_SetItemString(py_result, hdf5::SRC_IDX.c_str(), py_src_idx);
+    Py_DECREF(py_dst_blk_ptr);
+    Py_DECREF(py_dst_blk_idx);
+    Py_DECREF(py_dst_ptr);
+    Py_DECREF(py_src_idx);
+
+    return py_result;
+  }
+
+  PyDoc_STRVAR(
+    read_cell_attribute_arrays_doc,
+    "read_cell_attribute_arrays(file_name, pop_name, attr_name, namespace='Attributes')\n"
+    "--\n"
+    "\n"
+    "Reads the index, pointer and value datasets of a cell attribute in the calling process,\n"
+    "without MPI. Datasets with contiguous storage are mapped into memory and returned as\n"
+    "read-only arrays that refer to the mapping; other datasets are read into memory.\n"
+    "Parameters\n"
+    "----------\n"
+    "file_name : string\n"
+    "    The NeuroH5 file to read.\n"
+    "\n"
+    "pop_name : string\n"
+    "    Population of the attribute.\n"
+    "\n"
+    "attr_name : string\n"
+    "    Name of the attribute.\n"
+    "\n"
+    "namespace : string\n"
+    "    Optional namespace of the attribute.\n"
+    "\n"
+    "Returns\n"
+    "-------\n"
+    "arrays : dict\n"
+    "   A dictionary of the arrays 'Cell Index', 'Attribute Pointer' and 'Attribute Value'.\n"
+    "\n");
+
+  static PyObject *py_read_cell_attribute_arrays (PyObject *self, PyObject *args, PyObject *kwds)
+  {
+    const string default_namespace = "Attributes";
+    char *file_name, *pop_name, *attr_name, *attr_namespace = (char *)default_namespace.c_str();
+
+    static const char *kwlist[] = {
+                                   "file_name",
+                                   "pop_name",
+                                   "attr_name",
+                                   "namespace",
+                                   NULL};
+
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "sss|s", (char **)kwlist,
+                                     &file_name, &pop_name, &attr_name, &attr_namespace))
+      return NULL;
+
+    hdf5::MappedFile mapped_file(file_name);
+
+    string value_path = hdf5::cell_attribute_path(string(attr_namespace), string(pop_name),
+                                                  string(attr_name)) + "/" + hdf5::ATTR_VAL;
+    hid_t dset = H5Dopen2(mapped_file.file(), value_path.c_str(), H5P_DEFAULT);
+    throw_assert(dset >= 0,
+                 "py_read_cell_attribute_arrays: unable to open dataset " << value_path);
+    hid_t ftype = H5Dget_type(dset);
+    throw_assert(ftype >= 0,
+                 "py_read_cell_attribute_arrays: error in H5Dget_type");
+    AttrKind attr_kind = hdf5::h5type_attr_kind(ftype);
+    throw_assert(H5Tclose(ftype) >= 0,
+                 "py_read_cell_attribute_arrays: error in H5Tclose");
+    throw_assert(H5Dclose(dset) >= 0,
+                 "py_read_cell_attribute_arrays: error in H5Dclose");
+
+    PyObject *py_result = NULL;
+    switch (attr_kind.type)
+      {
+      case UIntVal:
+        if (attr_kind.size == 4)
+          py_result = py_cell_attribute_view_dict<uint32_t>(mapped_file, attr_namespace, pop_name, attr_name);
+        else if (attr_kind.size == 2)
+          py_result = py_cell_attribute_view_dict<uint16_t>(mapped_file, attr_namespace, pop_name, attr_name);
+        else if (attr_kind.size == 1)
+          py_result = py_cell_attribute_view_dict<uint8_t>(mapped_file, attr_namespace, pop_name, attr_name);
+        break;
+      case SIntVal:
+        if (attr_kind.size == 4)
+          py_result = py_cell_attribute_view_dict<int32_t>(mapped_file, attr_namespace, pop_name, attr_name);
+        else if (attr_kind.size == 2)
+          py_result = py_cell_attribute_view_dict<int16_t>(mapped_file, attr_namespace, pop_name, attr_name);
+        else if (attr_kind.size == 1)
+          py_result = py_cell_attribute_view_dict<int8_t>(mapped_file, attr_namespace, pop_name, attr_name);
+        break;
+      case FloatVal:
+        if (attr_kind.size == 4)
+          py_result = py_cell_attribute_view_dict<float>(mapped_file, attr_namespace, pop_name, attr_name);
+        break;
+      case EnumVal:
+        if (attr_kind.size == 1)
+          py_result = py_cell_attribute_view_dict<uint8_t>(mapped_file, attr_namespace, pop_name, attr_name);
+        break;
+      default:
+        break;
+      }
+    throw_assert(py_result != NULL,
+                 "py_read_cell_attribute_arrays: unsupported type of attribute " << attr_name);
+
+    return py_result;
+  }
+
+  PyDoc_STRVAR(
+    compute_node_allocation_doc,
+    "compute_node_allocation(node_ids, weights=None, coords=None, strategy='round_robin', comm=None, io_size=0)\n"
+    "--\n"
+    "\n"
+    "Assigns the given nodes to ranks and returns the nodes assigned to this rank.\n"
+    "Parameters\n"
+    "----------\n"
+    "node_ids : numpy.ndarray of uint32\n"
+    "    The nodes given by this rank. Nodes given by several ranks are assigned once.\n"
+    "\n"
+    "weights : numpy.ndarray of float64\n"
+    "    Optional node weights, e.g. in-degree or tree size. Defaults to 1.\n"
+    "\n"
+    "coords : numpy.ndarray of float32\n"
+    "    Optional array of shape (len(node_ids), 3) with node coordinates,\n"
+    "    used by the 'hilbert' and 'hierarchical' strategies.\n"
+    "\n"
+    "strategy : string\n"
+    "    One of 'round_robin', 'greedy', 'hilbert' or 'hierarchical'.\n"
+    "\n"
+    "comm : MPI communicator\n"
+    "    Optional MPI communicator. If None, the world communicator will be used.\n"
+    "\n"
+    "io_size : \n"
+    "    Optional number of ranks to which nodes are assigned. If 0, all ranks are used.\n"
+    "\n"
+    "Returns\n"
+    "-------\n"
+    "node_allocation : numpy.ndarray of uint32\n"
+    "    The sorted nodes assigned to this rank, suitable as the node_allocation\n"
+    "    argument of the scatter_read functions.\n"
+    "\n");
+
+  static PyObject *py_compute_node_allocation (PyObject *self, PyObject *args, PyObject *kwds)
+  {
+    int status;
+    PyObject *py_node_ids = NULL, *py_weights = NULL, *py_coords = NULL;
+    char *strategy_name = (char *)"round_robin";
+    PyObject *py_comm = NULL;
+    MPI_Comm *comm_ptr  = NULL;
+    unsigned long io_size = 0;
+
+    static const char *kwlist[] = {
+                                   "node_ids",
+                                   "weights",
+                                   "coords",
+                                   "strategy",
+                                   "comm",
+                                   "io_size",
+                                   NULL};
+
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "O|OOsOk", (char **)kwlist,
+                                     &py_node_ids, &py_weights, &py_coords,
+                                     &strategy_name, &py_comm, &io_size))
+      return NULL;
+
+    mpi::NodeRankStrategy strategy = mpi::parse_node_rank_strategy(string(strategy_name));
+
+    PyArrayObject *node_ids_arr = (PyArrayObject *)PyArray_FROMANY(py_node_ids, NPY_UINT32, 1, 1,
+                                                                   NPY_ARRAY_IN_ARRAY | NPY_ARRAY_FORCECAST);
+    throw_assert(node_ids_arr != NULL,
+                 "py_compute_node_allocation: node_ids must be a one-dimensional array");
+    const size_t num_nodes = PyArray_SIZE(node_ids_arr);
+    const NODE_IDX_T *node_ids = (const NODE_IDX_T *)PyArray_DATA(node_ids_arr);
+
+    PyArrayObject *weights_arr = NULL, *coords_arr = NULL;
+    if ((py_weights != NULL) && (py_weights != Py_None))
+      {
+        weights_arr = (PyArrayObject *)PyArray_FROMANY(py_weights, NPY_FLOAT64, 1, 1,
+                                                       NPY_ARRAY_IN_ARRAY | NPY_ARRAY_FORCECAST);
+        throw_assert((weights_arr != NULL) && ((size_t)PyArray_SIZE(weights_arr) == num_nodes),
+                     "py_compute_node_allocation: weights must be a one-dimensional array of the same size as node_ids");
+      }
+    if ((py_coords != NULL) && (py_coords != Py_None))
+      {
+        coords_arr = (PyArrayObject *)PyArray_FROMANY(py_coords, NPY_FLOAT32, 2, 2,
+                                                      NPY_ARRAY_IN_ARRAY | NPY_ARRAY_FORCECAST);
+        throw_assert((coords_arr != NULL) &&
+                     ((size_t)PyArray_DIM(coords_arr, 0) == num_nodes) &&
+                     (PyArray_DIM(coords_arr, 1) == 3),
+                     "py_compute_node_allocation: coords must be an array of shape (len(node_ids), 3)");
+      }
+
+    vector<mpi::NodeRankInput> local_nodes(num_nodes);
+    for (size_t i = 0; i < num_nodes; i++)
+      {
+        mpi::NodeRankInput& input = local_nodes[i];
+        input.node = node_ids[i];
+        input.weight = (weights_arr != NULL) ? ((const double *)PyArray_DATA(weights_arr))[i] : 1.0;
+        for (size_t d = 0; d < 3; d++)
+          {
+            input.coords[d] = (coords_arr != NULL) ? ((const float *)PyArray_DATA(coords_arr))[i*3 + d] : 0.0;
+          }
+      }
+    Py_DECREF(node_ids_arr);
+    Py_XDECREF(weights_arr);
+    Py_XDECREF(coords_arr);
+
+    MPI_Comm comm;
+
+    if ((py_comm != NULL) && (py_comm != Py_None))
+      {
+        comm_ptr = PyMPIComm_Get(py_comm);
+        throw_assert(comm_ptr != NULL,
+                     "py_compute_node_allocation: invalid MPI communicator");
+        throw_assert(*comm_ptr != MPI_COMM_NULL,
+                     "py_compute_node_allocation: invalid MPI communicator");
+        status = MPI_Comm_dup(*comm_ptr, &comm);
+        throw_assert(status == MPI_SUCCESS,
+                     "py_compute_node_allocation: unable to duplicate MPI communicator");
+      }
+    else
+      {
+        status = MPI_Comm_dup(MPI_COMM_WORLD, &comm);
+        throw_assert(status == MPI_SUCCESS,
+                     "py_compute_node_allocation: unable to duplicate MPI communicator");
+      }
+
+    int size;
+    status = MPI_Comm_size(comm, &size);
+    throw_assert(status == MPI_SUCCESS,
+                 "py_compute_node_allocation: unable to obtain size of MPI communicator");
+    if ((io_size == 0) || (io_size > (unsigned long)size))
+      {
+        io_size = size;
+      }
+
+    set<size_t> rank_set;
+    for (size_t i = 0; i < io_size; i++)
+      {
+        rank_set.insert(i);
+      }
+
+    size_t total_num_nodes = 0;
+    map<NODE_IDX_T, rank_t> node_rank_map;
+    vector<NODE_IDX_T> assigned_nodes;
+    mpi::assign_node_ranks(comm, rank_set, local_nodes, strategy,
+                           total_num_nodes, node_rank_map, assigned_nodes);
+
+    status = MPI_Comm_free(&comm);
+    throw_assert(status == MPI_SUCCESS,
+                 "py_compute_node_allocation: unable to free MPI communicator");
+
+    npy_intp dims[1];
+    dims[0] = assigned_nodes.size();
+    PyObject *py_assigned_nodes = (PyObject *)PyArray_SimpleNew(1, dims, NPY_UINT32);
+    if (assigned_nodes.size() > 0)
+      {
+        std::copy(assigned_nodes.begin(), assigned_nodes.end(),
+                  (NODE_IDX_T *)PyArray_DATA((PyArrayObject *)py_assigned_nodes));
+      }
+
+    return py_assigned_nodes;
   }
-  
+
+
   PyDoc_STRVAR(
     read_cell_attribute_info_doc,
     "read_cell_attribute_info(file_name, populations, read_cell_index=False, comm=None)\n"
@@ -4590,11 +6579,11 @@ extern "C"
     }
 
     
-    forward_list<neurotree_t> tree_list;
+    std::shared_ptr<PackedTrees> trees = std::make_shared<PackedTrees>();
 
     status = cell::read_trees (comm, string(file_name),
                                string(pop_name), pop_start,
-                               tree_list);
+                               *trees);
     throw_assert (status >= 0,
                  "py_read_trees: unable to read trees");
 
@@ -4614,11 +6603,11 @@ extern "C"
                  "py_read_trees: unable to free MPI communicator");
 
 
-    PyObject* py_tree_iter = NeuroH5TreeIter_FromList(tree_list,
-                                                      attr_name_spaces,
-                                                      attr_maps,
-                                                      topology_flag>0,
-                                                      validate_flag>0);
+    PyObject* py_tree_iter = NeuroH5TreeIter_FromPackedTrees(trees,
+                                                             attr_name_spaces,
+                                                             attr_maps,
+                                                             topology_flag>0,
+                                                             validate_flag>0);
 
     PyObject *py_result_tuple = PyTuple_New(2);
     PyTuple_SetItem(py_result_tuple, 0, py_tree_iter);
@@ -4842,23 +6831,23 @@ extern "C"
       }
     
 
-    map<CELL_IDX_T, neurotree_t> tree_map;
+    std::shared_ptr<PackedTrees> trees = std::make_shared<PackedTrees>();
     map<string, NamedAttrMap> attr_maps;
     
     status = cell::scatter_read_trees (comm, string(file_name),
                                        io_size, attr_name_spaces,
                                        node_rank_map, string(pop_name),
                                        pop_start,
-                                       tree_map, attr_maps);
+                                       *trees, attr_maps);
     throw_assert (status >= 0,
                  "py_scatter_read_trees: unable to read trees");
 
 
-    PyObject* py_tree_iter = NeuroH5TreeIter_FromMap(tree_map,
-                                                     attr_name_spaces,
-                                                     attr_maps,
-                                                     topology_flag>0,
-                                                     validate_flag>0);
+    PyObject* py_tree_iter = NeuroH5TreeIter_FromPackedTrees(trees,
+                                                             attr_name_spaces,
+                                                             attr_maps,
+                                                             topology_flag>0,
+                                                             validate_flag>0);
 
     PyObject *py_result_tuple = PyTuple_New(2);
     PyTuple_SetItem(py_result_tuple, 0, py_tree_iter);
@@ -5279,27 +7268,306 @@ extern "C"
   }
 
 
+  /// Reads the given namespaces and masks of a population with a single
+  /// batched scatter read, and returns a dictionary of namespaces.
+  static PyObject *scatter_read_cell_attribute_name_spaces (MPI_Comm comm,
+                                                            const string& file_name,
+                                                            const string& pop_name,
+                                                            const vector< pair<string, set<string> > >& attr_name_spaces,
+                                                            PyObject *py_node_allocation,
+                                                            const size_t io_size,
+                                                            const return_type return_tp)
+  {
+    int status;
+    node_rank_map_t node_rank_map;
+
+    pop_label_map_t pop_labels;
+    status = cell::read_population_labels(comm, file_name, pop_labels);
+    throw_assert (status >= 0,
+                  "scatter_read_cell_attribute_name_spaces: unable to read population labels");
+
+    // Determine index of population to be read
+    pop_t pop_idx=0; bool pop_idx_set=false;
+    for (auto& x: pop_labels) 
+      {
+        if (get<1>(x) == pop_name)
+          {
+            pop_idx = get<0>(x);
+            pop_idx_set = true;
+          }
+      }
+    if (!pop_idx_set)
+      {
+        throw_err(std::string("scatter_read_cell_attribute_name_spaces: ") + "Population " + pop_name + " not found");
+      }
+
+    
+    size_t n_nodes;
+    pop_range_map_t pop_ranges;
+
+    status = cell::read_population_ranges(comm, file_name, pop_ranges, n_nodes);
+    throw_assert(status >= 0,
+                 "scatter_read_cell_attribute_name_spaces: unable to read population ranges");
+    CELL_IDX_T pop_start = 0;
+    size_t pop_count = 0;
+    {
+        auto it = pop_ranges.find(pop_idx);
+        throw_assert(it != pop_ranges.end(),
+                     "scatter_read_cell_attribute_name_spaces: invalid population index");
+        pop_start = it->second.start;
+        pop_count = it->second.count;
+    }
+
+    vector<string> attr_name_space_names;
+    for (auto& attr_name_space_mask : attr_name_spaces)
+      {
+        attr_name_space_names.push_back(attr_name_space_mask.first);
+      }
+    ldbal_cell_attr (comm, file_name,
+                     pop_ranges, pop_name, pop_idx, 
+                     attr_name_space_names, py_node_allocation,
+                     node_rank_map);
+
+    map<string, data::NamedAttrMap> attr_maps;
+    status = cell::scatter_read_cell_attributes (comm,
+                                                 file_name,
+                                                 io_size,
+                                                 attr_name_spaces,
+                                                 node_rank_map,
+                                                 pop_name,
+                                                 pop_start,
+                                                 attr_maps);
+    throw_assert (status >= 0,
+                  "scatter_read_cell_attribute_name_spaces: unable to read cell attributes");
+
+    PyObject *py_namespace_dict = PyDict_New();
+    for (auto& attr_name_space_mask : attr_name_spaces)
+      {
+        const string& attr_name_space = attr_name_space_mask.first;
+        data::NamedAttrMap& attr_map = attr_maps[attr_name_space];
+
+        vector<vector<string>> attr_names;
+        attr_map.attr_names(attr_names);
+
+
+        if (return_tp == return_tuple)
+          {
+            PyObject *py_tuple_index_info = py_build_cell_attr_tuple_info(attr_map, attr_names);
+            PyObject *py_result_tuple = PyTuple_New(2);
+            PyObject *py_cell_attr_iter = NeuroH5CellAttrIter_FromMap(attr_name_space,
+                                                                      attr_names,
+                                                                      std::move(attr_map),
+                                                                      return_tp);
+            PyTuple_SetItem(py_result_tuple, 0, py_cell_attr_iter);
+            PyTuple_SetItem(py_result_tuple, 1, py_tuple_index_info);
+            PyDict_SetItemString(py_namespace_dict, attr_name_space.c_str(), py_result_tuple);
+            Py_DECREF(py_result_tuple);
+          }
+        else
+          {
+            PyObject *py_cell_attr_iter = NeuroH5CellAttrIter_FromMap(attr_name_space,
+                                                                      attr_names,
+                                                                      std::move(attr_map),
+                                                                      return_tp);
+            PyDict_SetItemString(py_namespace_dict, attr_name_space.c_str(), py_cell_attr_iter);
+            Py_DECREF(py_cell_attr_iter);
+          }
+      }
+    return py_namespace_dict;
+  }
+
   PyDoc_STRVAR(
     scatter_read_cell_attributes_doc,
     "scatter_read_cell_attributes(file_name, population_name, namespaces, node_allocation=None, comm=None, io_size=0)\n"
     "--\n"
     "\n"
-    "Reads cell attributes for all cell gids contained in the given file and namespaces, using scalable parallel read/scatter."
-    "Each rank will be assigned an equal number of cell gids, with the exception of the last rank if the number of cells is not evenly divisible by the number of ranks. \n"
+    "Reads cell attributes for all cell gids contained in the given file and namespaces, using scalable parallel read/scatter."
+    "Each rank will be assigned an equal number of cell gids, with the exception of the last rank if the number of cells is not evenly divisible by the number of ranks. \n"
+    "\n"
+    "Parameters\n"
+    "----------\n"
+    "file_name : string\n"
+    "    The NeuroH5 file to read.\n"
+    "    \n"
+    "    .. warning::\n"
+    "       The given file must be a valid HDF5 file that contains /H5Types and /Populations groups.\n"
+    "\n"
+    "population_name : string\n"
+    "    Name of population from which to read.\n"
+    "\n"
+    "namespaces : string list\n"
+    "    The namespaces for which cell attributes will be read.\n"
+    "\n"
+    "comm : MPI communicator\n"
+    "    Optional MPI communicator. If None, the world communicator will be used.\n"
+    "\n"
+    "io_size : \n"
+    "    Optional number of ranks performing I/O operations. If 0, this number will be equal to the size of the MPI communicator.\n"
+    "\n"
+    "node_allocation : \n"
+    "    Optional iterable that with gids assigned to rank. If None, round-robin assignment will be used.\n"
+    "\n"
+    "mask : set of string\n"
+    "    Optional set of attributes to be read. If not set, all attributes in the namespace will be read.\n"
+    "\n"
+    "Returns\n"
+    "-------\n"
+    "Dictionary of the form { namespace: cell_iter }, where: \n"
+    "cell_iter : iterator\n"
+    "   An iterator that returns pairs (gid, attr_dict) where gid is the cell id and attr_dict is a dictionary with attribute key-value pairs. \n"
+    "\n");
+
+  static PyObject *py_scatter_read_cell_attributes (PyObject *self, PyObject *args, PyObject *kwds)
+  {
+    int status;
+    PyObject *py_comm = NULL;
+    PyObject *py_mask = NULL;
+    MPI_Comm *comm_ptr  = NULL;
+    unsigned long io_size = 0;
+    char *file_name, *pop_name;
+    PyObject *py_node_allocation=NULL;
+    PyObject *py_attr_name_spaces=NULL;
+    vector <string> attr_name_spaces;
+    char *return_type_arg = NULL;
+    return_type return_tp = return_dict;
+    
+    static const char *kwlist[] = {
+                                   "file_name",
+                                   "pop_name",
+                                   "comm",
+                                   "mask",
+                                   "node_allocation",
+                                   "namespaces",
+                                   "io_size",
+                                   "return_type",
+                                   NULL};
+
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "ss|OOOOks", (char **)kwlist,
+                                     &file_name, &pop_name, &py_comm, &py_mask, 
+                                     &py_node_allocation, &py_attr_name_spaces,
+                                     &io_size, &return_type_arg))
+      return NULL;
+
+    if (return_type_arg != NULL)
+      {
+        string return_type_str = string(return_type_arg);
+        if (return_type_str == "dict")
+          return_tp = return_dict;
+        if (return_type_str == "tuple")
+          return_tp = return_tuple;
+#if HAS_STRUCT_SEQUENCE
+        if (return_type_str == "struct")
+          return_tp = return_struct;
+#endif
+      }
+
+    set<string> attr_mask;
+    
+    if (py_mask != NULL)
+      {
+        throw_assert(PySet_Check(py_mask),
+                     "py_scatter_read_cell_attributes: argument mask must be a set of strings");
+        
+        PyObject *py_iter = PyObject_GetIter(py_mask);
+        if (py_iter != NULL)
+          {
+            PyObject *pyval;
+            while((pyval = PyIter_Next(py_iter)))
+              {
+                const char* str = PyStr_ToCString (pyval);
+                attr_mask.insert(string(str));
+                Py_DECREF(pyval);
+              }
+          }
+
+        Py_DECREF(py_iter);
+      }
+
+    MPI_Comm comm;
+
+    if ((py_comm != NULL) && (py_comm != Py_None))
+      {
+        comm_ptr = PyMPIComm_Get(py_comm);
+        throw_assert(comm_ptr != NULL,
+                     "py_scatter_read_cell_attributes: invalid MPI communicator");
+        throw_assert(*comm_ptr != MPI_COMM_NULL,
+                     "py_scatter_read_cell_attributes: invalid MPI communicator");
+        status = MPI_Comm_dup(*comm_ptr, &comm);
+        throw_assert(status == MPI_SUCCESS,
+                     "py_scatter_read_cell_attributes: unable to duplicate MPI communicator");
+      }
+    else
+      {
+        status = MPI_Comm_dup(MPI_COMM_WORLD, &comm);
+        throw_assert(status == MPI_SUCCESS,
+                     "py_scatter_read_cell_attributes: unable to duplicate MPI communicator");
+      }
+
+    int rank, size;
+    status = MPI_Comm_size(comm, &size);
+    throw_assert(status == MPI_SUCCESS,
+                 "py_scatter_read_cell_attributes: unable to obtain size of MPI communicator");
+    status = MPI_Comm_rank(comm, &rank);
+    throw_assert(status == MPI_SUCCESS,
+                 "py_scatter_read_cell_attributes: unable to obtain rank of MPI communicator");
+
+    if (io_size == 0)
+      {
+        io_size = size > 0 ? size : 1;
+      }
+
+    // Create C++ vector of namespace strings:
+    if (py_attr_name_spaces != NULL)
+      {
+        for (size_t i = 0; (Py_ssize_t)i < PyList_Size(py_attr_name_spaces); i++)
+          {
+            PyObject *pyval = PyList_GetItem(py_attr_name_spaces, (Py_ssize_t)i);
+            const char *str = PyStr_ToCString (pyval);
+            if (str != NULL)
+              {
+                attr_name_spaces.push_back(string(str));
+              }
+          }
+      }
+
+    vector< pair<string, set<string> > > attr_name_space_masks;
+    for (const string& attr_name_space : attr_name_spaces)
+      {
+        attr_name_space_masks.push_back(make_pair(attr_name_space, attr_mask));
+      }
+    PyObject *py_namespace_dict =
+      scatter_read_cell_attribute_name_spaces(comm, string(file_name), string(pop_name),
+                                              attr_name_space_masks, py_node_allocation,
+                                              io_size, return_tp);
+
+    status = MPI_Comm_free(&comm);
+    throw_assert(status == MPI_SUCCESS,
+                 "py_scatter_read_cell_attributes: unable to free MPI communicator");
+
+    
+    return py_namespace_dict;
+  }
+
+
+  PyDoc_STRVAR(
+    scatter_read_cell_attribute_namespaces_doc,
+    "scatter_read_cell_attribute_namespaces(file_name, population_name, namespaces, node_allocation=None, comm=None, io_size=0)\n"
+    "--\n"
+    "\n"
+    "Reads cell attributes of several namespaces, each with its own attribute mask, using a single parallel read/scatter. "
+    "All namespaces are read through one open file, and the attributes assigned to each rank are sent in one message. \n"
     "\n"
     "Parameters\n"
     "----------\n"
     "file_name : string\n"
     "    The NeuroH5 file to read.\n"
-    "    \n"
-    "    .. warning::\n"
-    "       The given file must be a valid HDF5 file that contains /H5Types and /Populations groups.\n"
     "\n"
     "population_name : string\n"
     "    Name of population from which to read.\n"
     "\n"
-    "namespaces : string list\n"
-    "    The namespaces for which cell attributes will be read.\n"
+    "namespaces : list\n"
+    "    The namespaces to read. Each element is either a namespace name, or a pair (namespace, mask) where mask is\n"
+    "    a set of attribute names to be read, or None to read all attributes in the namespace.\n"
     "\n"
     "comm : MPI communicator\n"
     "    Optional MPI communicator. If None, the world communicator will be used.\n"
@@ -5310,46 +7578,36 @@ extern "C"
     "node_allocation : \n"
     "    Optional iterable that with gids assigned to rank. If None, round-robin assignment will be used.\n"
     "\n"
-    "mask : set of string\n"
-    "    Optional set of attributes to be read. If not set, all attributes in the namespace will be read.\n"
-    "\n"
     "Returns\n"
     "-------\n"
-    "Dictionary of the form { namespace: cell_iter }, where: \n"
-    "cell_iter : iterator\n"
-    "   An iterator that returns pairs (gid, attr_dict) where gid is the cell id and attr_dict is a dictionary with attribute key-value pairs. \n"
+    "Dictionary of the form { namespace: cell_iter }, as returned by scatter_read_cell_attributes.\n"
     "\n");
 
-  static PyObject *py_scatter_read_cell_attributes (PyObject *self, PyObject *args, PyObject *kwds)
+  static PyObject *py_scatter_read_cell_attribute_namespaces (PyObject *self, PyObject *args, PyObject *kwds)
   {
     int status;
     PyObject *py_comm = NULL;
-    PyObject *py_mask = NULL;
     MPI_Comm *comm_ptr  = NULL;
     unsigned long io_size = 0;
     char *file_name, *pop_name;
     PyObject *py_node_allocation=NULL;
     PyObject *py_attr_name_spaces=NULL;
-    node_rank_map_t node_rank_map;
-    vector <string> attr_name_spaces;
     char *return_type_arg = NULL;
     return_type return_tp = return_dict;
     
     static const char *kwlist[] = {
                                    "file_name",
                                    "pop_name",
+                                   "namespaces",
                                    "comm",
-                                   "mask",
                                    "node_allocation",
-                                   "namespaces",
                                    "io_size",
                                    "return_type",
                                    NULL};
 
-    if (!PyArg_ParseTupleAndKeywords(args, kwds, "ss|OOOOks", (char **)kwlist,
-                                     &file_name, &pop_name, &py_comm, &py_mask, 
-                                     &py_node_allocation, &py_attr_name_spaces,
-                                     &io_size, &return_type_arg))
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "ssO|OOks", (char **)kwlist,
+                                     &file_name, &pop_name, &py_attr_name_spaces, &py_comm,
+                                     &py_node_allocation, &io_size, &return_type_arg))
       return NULL;
 
     if (return_type_arg != NULL)
@@ -5365,26 +7623,44 @@ extern "C"
 #endif
       }
 
-    set<string> attr_mask;
-    
-    if (py_mask != NULL)
+    // Create C++ vector of namespace names and masks
+    vector< pair<string, set<string> > > attr_name_spaces;
+    throw_assert(PyList_Check(py_attr_name_spaces),
+                 "py_scatter_read_cell_attribute_namespaces: argument namespaces must be a list");
+    for (Py_ssize_t i = 0; i < PyList_Size(py_attr_name_spaces); i++)
       {
-        throw_assert(PySet_Check(py_mask),
-                     "py_scatter_read_cell_attributes: argument mask must be a set of strings");
-        
-        PyObject *py_iter = PyObject_GetIter(py_mask);
-        if (py_iter != NULL)
+        PyObject *pyval = PyList_GetItem(py_attr_name_spaces, i);
+        PyObject *py_name = pyval;
+        PyObject *py_mask = NULL;
+        if (PyTuple_Check(pyval))
           {
-            PyObject *pyval;
-            while((pyval = PyIter_Next(py_iter)))
+            throw_assert(PyTuple_Size(pyval) == 2,
+                         "py_scatter_read_cell_attribute_namespaces: namespace entries must be pairs (namespace, mask)");
+            py_name = PyTuple_GetItem(pyval, 0);
+            py_mask = PyTuple_GetItem(pyval, 1);
+          }
+        const char *str = PyStr_ToCString (py_name);
+        throw_assert(str != NULL,
+                     "py_scatter_read_cell_attribute_namespaces: namespace must be a string");
+
+        set<string> attr_mask;
+        if ((py_mask != NULL) && (py_mask != Py_None))
+          {
+            throw_assert(PySet_Check(py_mask),
+                         "py_scatter_read_cell_attribute_namespaces: mask must be a set of strings");
+            PyObject *py_iter = PyObject_GetIter(py_mask);
+            if (py_iter != NULL)
               {
-                const char* str = PyStr_ToCString (pyval);
-                attr_mask.insert(string(str));
-                Py_DECREF(pyval);
+                PyObject *py_attr_name;
+                while((py_attr_name = PyIter_Next(py_iter)))
+                  {
+                    attr_mask.insert(string(PyStr_ToCString (py_attr_name)));
+                    Py_DECREF(py_attr_name);
+                  }
+                Py_DECREF(py_iter);
               }
           }
-
-        Py_DECREF(py_iter);
+        attr_name_spaces.push_back(make_pair(string(str), attr_mask));
       }
 
     MPI_Comm comm;
@@ -5393,140 +7669,39 @@ extern "C"
       {
         comm_ptr = PyMPIComm_Get(py_comm);
         throw_assert(comm_ptr != NULL,
-                     "py_scatter_read_cell_attributes: invalid MPI communicator");
+                     "py_scatter_read_cell_attribute_namespaces: invalid MPI communicator");
         throw_assert(*comm_ptr != MPI_COMM_NULL,
-                     "py_scatter_read_cell_attributes: invalid MPI communicator");
+                     "py_scatter_read_cell_attribute_namespaces: invalid MPI communicator");
         status = MPI_Comm_dup(*comm_ptr, &comm);
         throw_assert(status == MPI_SUCCESS,
-                     "py_scatter_read_cell_attributes: unable to duplicate MPI communicator");
+                     "py_scatter_read_cell_attribute_namespaces: unable to duplicate MPI communicator");
       }
     else
       {
         status = MPI_Comm_dup(MPI_COMM_WORLD, &comm);
         throw_assert(status == MPI_SUCCESS,
-                     "py_scatter_read_cell_attributes: unable to duplicate MPI communicator");
+                     "py_scatter_read_cell_attribute_namespaces: unable to duplicate MPI communicator");
       }
 
-    int rank, size;
+    int size;
     status = MPI_Comm_size(comm, &size);
     throw_assert(status == MPI_SUCCESS,
-                 "py_scatter_read_cell_attributes: unable to obtain size of MPI communicator");
-    status = MPI_Comm_rank(comm, &rank);
-    throw_assert(status == MPI_SUCCESS,
-                 "py_scatter_read_cell_attributes: unable to obtain rank of MPI communicator");
+                 "py_scatter_read_cell_attribute_namespaces: unable to obtain size of MPI communicator");
 
     if (io_size == 0)
       {
         io_size = size > 0 ? size : 1;
       }
 
-    // Create C++ vector of namespace strings:
-    if (py_attr_name_spaces != NULL)
-      {
-        for (size_t i = 0; (Py_ssize_t)i < PyList_Size(py_attr_name_spaces); i++)
-          {
-            PyObject *pyval = PyList_GetItem(py_attr_name_spaces, (Py_ssize_t)i);
-            const char *str = PyStr_ToCString (pyval);
-            if (str != NULL)
-              {
-                attr_name_spaces.push_back(string(str));
-              }
-          }
-      }
-
-    pop_label_map_t pop_labels;
-    status = cell::read_population_labels(comm, string(file_name), pop_labels);
-    throw_assert (status >= 0,
-                  "py_scatter_read_cell_attributes: unable to read population labels");
-
-    // Determine index of population to be read
-    pop_t pop_idx=0; bool pop_idx_set=false;
-    for (auto& x: pop_labels) 
-      {
-        if (get<1>(x) == pop_name)
-          {
-            pop_idx = get<0>(x);
-            pop_idx_set = true;
-          }
-      }
-    if (!pop_idx_set)
-      {
-        throw_err(std::string("py_scatter_read_cell_attributes: ") + "Population " + pop_name + " not found");
-      }
-
-    
-    size_t n_nodes;
-    pop_range_map_t pop_ranges;
-
-    status = cell::read_population_ranges(comm, string(file_name), pop_ranges, n_nodes);
-    throw_assert(status >= 0,
-                 "py_scatter_read_cell_attributes: unable to read population ranges");
-    CELL_IDX_T pop_start = 0;
-    size_t pop_count = 0;
-    {
-        auto it = pop_ranges.find(pop_idx);
-        throw_assert(it != pop_ranges.end(),
-                     "py_scatter_read_cell_attributes: invalid population index");
-        pop_start = it->second.start;
-        pop_count = it->second.count;
-    }
-
-    ldbal_cell_attr (comm, string(file_name),
-                     pop_ranges, pop_name, pop_idx, 
-                     attr_name_spaces, py_node_allocation,
-                     node_rank_map);
-
-    PyObject *py_namespace_dict = PyDict_New();
-    for (string attr_name_space : attr_name_spaces)
-      {
-        data::NamedAttrMap attr_map;
-        
-        status = cell::scatter_read_cell_attributes (comm,
-                                                     string(file_name),
-                                                     io_size,
-                                                     attr_name_space,
-                                                     attr_mask,
-                                                     node_rank_map,
-                                                     string(pop_name),
-                                                     pop_start,
-                                                     attr_map);
-        throw_assert (status >= 0,
-                      "py_scatter_read_cell_attributes: unable to read cell attributes");
-                      
-
+    PyObject *py_namespace_dict =
+      scatter_read_cell_attribute_name_spaces(comm, string(file_name), string(pop_name),
+                                              attr_name_spaces, py_node_allocation,
+                                              io_size, return_tp);
 
-        vector<vector<string>> attr_names;
-        attr_map.attr_names(attr_names);
-
-
-        if (return_tp == return_tuple)
-          {
-            PyObject *py_tuple_index_info = py_build_cell_attr_tuple_info(attr_map, attr_names);
-            PyObject *py_result_tuple = PyTuple_New(2);
-            PyObject *py_cell_attr_iter = NeuroH5CellAttrIter_FromMap(attr_name_space,
-                                                                      attr_names,
-                                                                      std::move(attr_map),
-                                                                      return_tp);
-            PyTuple_SetItem(py_result_tuple, 0, py_cell_attr_iter);
-            PyTuple_SetItem(py_result_tuple, 1, py_tuple_index_info);
-            PyDict_SetItemString(py_namespace_dict, attr_name_space.c_str(), py_result_tuple);
-            Py_DECREF(py_result_tuple);
-          }
-        else
-          {
-            PyObject *py_cell_attr_iter = NeuroH5CellAttrIter_FromMap(attr_name_space,
-                                                                      attr_names,
-                                                                      std::move(attr_map),
-                                                                      return_tp);
-            PyDict_SetItemString(py_namespace_dict, attr_name_space.c_str(), py_cell_attr_iter);
-            Py_DECREF(py_cell_attr_iter);
-          }
-      }
     status = MPI_Comm_free(&comm);
     throw_assert(status == MPI_SUCCESS,
-                 "py_scatter_read_cell_attributes: unable to free MPI communicator");
+                 "py_scatter_read_cell_attribute_namespaces: unable to free MPI communicator");
 
-    
     return py_namespace_dict;
   }
 
@@ -6152,6 +8327,8 @@ extern "C"
     return_type return_tp = return_dict;
 
     
+    int opt_shared = 0;
+
     static const char *kwlist[] = {"file_name",
                                    "pop_name",
                                    "root",
@@ -6159,11 +8336,12 @@ extern "C"
                                    "comm",
                                    "mask",
                                    "return_type",
+                                   "shared",
                                    NULL};
 
-    if (!PyArg_ParseTupleAndKeywords(args, kwds, "ssk|sOOs", (char **)kwlist,
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "ssk|sOOsp", (char **)kwlist,
                                      &file_name_arg, &pop_name_arg, &root, &attr_namespace_arg, 
-                                     &py_comm, &py_mask, &return_type_arg))
+                                     &py_comm, &py_mask, &return_type_arg, &opt_shared))
       return NULL;
 
     if (return_type_arg != NULL)
@@ -6272,6 +8450,29 @@ extern "C"
         pop_count = it->second.count;
     }
 
+    if (opt_shared)
+      {
+        // one copy of the attributes per node, returned as arrays by
+        // attribute name
+        cell::SharedCellAttributes shared_attr_values;
+        cell::bcast_cell_attributes_shared (comm, (int)root,
+                                            file_name, attr_namespace, attr_mask, 
+                                            pop_name, pop_start,
+                                            shared_attr_values);
+        throw_assert(MPI_Comm_free(&comm) == MPI_SUCCESS,
+                     "py_bcast_cell_attributes: unable to free MPI communicator");
+
+        PyObject *py_attr_dict = PyDict_New();
+        py_shared_cell_attribute_dicts<float>(shared_attr_values, py_attr_dict);
+        py_shared_cell_attribute_dicts<uint8_t>(shared_attr_values, py_attr_dict);
+        py_shared_cell_attribute_dicts<int8_t>(shared_attr_values, py_attr_dict);
+        py_shared_cell_attribute_dicts<uint16_t>(shared_attr_values, py_attr_dict);
+        py_shared_cell_attribute_dicts<int16_t>(shared_attr_values, py_attr_dict);
+        py_shared_cell_attribute_dicts<uint32_t>(shared_attr_values, py_attr_dict);
+        py_shared_cell_attribute_dicts<int32_t>(shared_attr_values, py_attr_dict);
+        return py_attr_dict;
+      }
+
     cell::bcast_cell_attributes (comm, (int)root,
                                  file_name, attr_namespace, attr_mask, 
                                  pop_name, pop_start,
@@ -6321,6 +8522,7 @@ extern "C"
     unsigned long chunk_size = default_chunk_size;
     unsigned long value_chunk_size = default_value_chunk_size;
     unsigned long cache_size = default_cache_size;
+    PyObject *py_compression = NULL;
     herr_t status;
     
     static const char *kwlist[] = {
@@ -6333,19 +8535,24 @@ extern "C"
                                    "chunk_size",
                                    "value_chunk_size",
                                    "cache_size",
+                                   "compression",
                                    NULL};
 
 
-    if (!PyArg_ParseTupleAndKeywords(args, kwds, "ssO|sOkkkk", (char **)kwlist,
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "ssO|sOkkkkO", (char **)kwlist,
                                      &file_name_arg, &pop_name_arg, &idx_values,
                                      &namespace_arg, &py_comm, 
-                                     &io_size, &chunk_size, &value_chunk_size, &cache_size))
+                                     &io_size, &chunk_size, &value_chunk_size, &cache_size,
+                                     &py_compression))
       return NULL;
 
     string file_name = string(file_name_arg);
     string pop_name = string(pop_name_arg);
     string attr_namespace = string(namespace_arg);
 
+    hdf5::DatasetCreationPolicy dataset_policy;
+    build_dataset_creation_policy(py_compression, dataset_policy);
+
     MPI_Comm comm;
 
     if ((py_comm != NULL) && (py_comm != Py_None))
@@ -6466,49 +8673,49 @@ extern "C"
             const string& attr_name = it->first;
             cell::write_cell_attribute_map<float> (data_comm, file_name, attr_namespace, pop_name, pop_start,
                                                    attr_name, it->second, io_size, dflt_data_type,
-                                                   chunk_size, value_chunk_size, cache_size);
+                                                   chunk_size, value_chunk_size, cache_size, dataset_policy);
           }
         for(auto it = all_attr_values_uint32.cbegin(); it != all_attr_values_uint32.cend(); ++it)
           {
             const string& attr_name = it->first;
             cell::write_cell_attribute_map<uint32_t> (data_comm, file_name, attr_namespace, pop_name, pop_start,
                                                       attr_name, it->second, io_size, dflt_data_type,
-                                                      chunk_size, value_chunk_size, cache_size);
+                                                      chunk_size, value_chunk_size, cache_size, dataset_policy);
           }
         for(auto it = all_attr_values_uint16.cbegin(); it != all_attr_values_uint16.cend(); ++it)
           {
             const string& attr_name = it->first;
             cell::write_cell_attribute_map<uint16_t> (data_comm, file_name, attr_namespace, pop_name, pop_start,
                                                       attr_name, it->second, io_size, dflt_data_type,
-                                                      chunk_size, value_chunk_size, cache_size);
+                                                      chunk_size, value_chunk_size, cache_size, dataset_policy);
           }
         for(auto it = all_attr_values_uint8.cbegin(); it != all_attr_values_uint8.cend(); ++it)
           {
             const string& attr_name = it->first;
             cell::write_cell_attribute_map<uint8_t> (data_comm, file_name, attr_namespace, pop_name, pop_start,
                                                      attr_name, it->second, io_size, dflt_data_type,
-                                                     chunk_size, value_chunk_size, cache_size);
+                                                     chunk_size, value_chunk_size, cache_size, dataset_policy);
           }
         for(auto it = all_attr_values_int32.cbegin(); it != all_attr_values_int32.cend(); ++it)
           {
             const string& attr_name = it->first;
             cell::write_cell_attribute_map<int32_t> (data_comm, file_name, attr_namespace, pop_name, pop_start,
                                                      attr_name, it->second, io_size, dflt_data_type,
-                                                     chunk_size, value_chunk_size, cache_size);
+                                                     chunk_size, value_chunk_size, cache_size, dataset_policy);
           }
         for(auto it = all_attr_values_int16.cbegin(); it != all_attr_values_int16.cend(); ++it)
           {
             const string& attr_name = it->first;
             cell::write_cell_attribute_map<int16_t> (data_comm, file_name, attr_namespace, pop_name, pop_start,
                                                      attr_name, it->second, io_size, dflt_data_type,
-                                                     chunk_size, value_chunk_size, cache_size);
+                                                     chunk_size, value_chunk_size, cache_size, dataset_policy);
           }
         for(auto it = all_attr_values_int8.cbegin(); it != all_attr_values_int8.cend(); ++it)
           {
             const string& attr_name = it->first;
             cell::write_cell_attribute_map<int8_t> (data_comm, file_name, attr_namespace, pop_name, pop_start,
                                                     attr_name, it->second, io_size, dflt_data_type,
-                                                    chunk_size, value_chunk_size, cache_size);
+                                                    chunk_size, value_chunk_size, cache_size, dataset_policy);
           }
 
         
@@ -6542,6 +8749,7 @@ extern "C"
     unsigned long chunk_size = default_chunk_size;
     unsigned long value_chunk_size = default_value_chunk_size;
     unsigned long cache_size = default_cache_size;
+    PyObject *py_compression = NULL;
     char *file_name_arg, *pop_name_arg, *namespace_arg = (char *)default_namespace.c_str();
     herr_t status;
     
@@ -6555,14 +8763,19 @@ extern "C"
                                    "chunk_size",
                                    "value_chunk_size",
                                    "cache_size",
+                                   "compression",
                                    NULL};
 
 
-    if (!PyArg_ParseTupleAndKeywords(args, kwds, "ssO|sOkkkk", (char **)kwlist,
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "ssO|sOkkkkO", (char **)kwlist,
                                      &file_name_arg, &pop_name_arg, &idx_values,
                                      &namespace_arg, &py_comm, 
-                                     &io_size, &chunk_size, &value_chunk_size, &cache_size))
+                                     &io_size, &chunk_size, &value_chunk_size, &cache_size,
+                                     &py_compression))
       return NULL;
+    hdf5::DatasetCreationPolicy dataset_policy;
+    build_dataset_creation_policy(py_compression, dataset_policy);
+
     MPI_Comm comm;
 
     if ((py_comm != NULL) && (py_comm != Py_None))
@@ -6661,54 +8874,229 @@ extern "C"
         }
 
     
-    
-        int npy_type=0;
-    
-        vector<string> attr_names;
-        vector<int> attr_types;
+    
+        int npy_type=0;
+    
+        vector<string> attr_names;
+        vector<int> attr_types;
+        
+        map<string, map<CELL_IDX_T, deque<uint32_t> >> all_attr_values_uint32;
+        map<string, map<CELL_IDX_T, deque<int32_t> >> all_attr_values_int32;
+        map<string, map<CELL_IDX_T, deque<uint16_t> >> all_attr_values_uint16;
+        map<string, map<CELL_IDX_T, deque<int16_t> >> all_attr_values_int16;
+        map<string, map<CELL_IDX_T, deque<uint8_t> >>  all_attr_values_uint8;
+        map<string, map<CELL_IDX_T, deque<int8_t> >>  all_attr_values_int8;
+        map<string, map<CELL_IDX_T, deque<float> >>  all_attr_values_float;
+
+        const data::optional_hid dflt_data_type;
+
+        build_cell_attr_value_maps(idx_values,
+                                   all_attr_values_uint32,
+                                   all_attr_values_uint16,
+                                   all_attr_values_uint8,
+                                   all_attr_values_int32,
+                                   all_attr_values_int16,
+                                   all_attr_values_int8,
+                                   all_attr_values_float);
+
+        cell::append_cell_attribute_maps (data_comm, file_name,
+                                          attr_namespace, pop_name, pop_start,
+                                          all_attr_values_uint32,
+                                          all_attr_values_int32,
+                                          all_attr_values_uint16,
+                                          all_attr_values_int16,
+                                          all_attr_values_uint8,
+                                          all_attr_values_int8,
+                                          all_attr_values_float,
+                                          io_size, dflt_data_type,
+                                          IndexOwner, CellPtr(PtrOwner),
+                                          chunk_size, value_chunk_size, cache_size, dataset_policy);
+      }
+    
+    throw_assert(MPI_Barrier(data_comm) == MPI_SUCCESS,
+                 "py_append_cell_attributes: error in MPI barrier on data communicator");
+    throw_assert(MPI_Barrier(comm) == MPI_SUCCESS,
+                 "py_append_cell_attributes: error in MPI barrier");
+
+    throw_assert(MPI_Comm_free(&data_comm) == MPI_SUCCESS,
+                 "py_append_cell_attributes: unable to free data MPI communicator");
+    throw_assert(MPI_Comm_free(&comm) == MPI_SUCCESS,
+                 "py_append_cell_attributes: unable to free MPI communicator");
+    
+    Py_INCREF(Py_None);
+    return Py_None;
+  }
+
+
+  static PyObject *py_append_cell_attribute_arrays (PyObject *self, PyObject *args, PyObject *kwds)
+  {
+    PyObject *py_gids, *py_attr_values;
+    const unsigned long default_cache_size = 4*1024*1024;
+    const unsigned long default_chunk_size = 4000;
+    const unsigned long default_value_chunk_size = 4000;
+    const string default_namespace = "Attributes";
+    PyObject *py_comm = NULL;
+    MPI_Comm *comm_ptr  = NULL;
+    unsigned long io_size = 0;
+    unsigned long chunk_size = default_chunk_size;
+    unsigned long value_chunk_size = default_value_chunk_size;
+    unsigned long cache_size = default_cache_size;
+    PyObject *py_compression = NULL;
+    char *file_name_arg, *pop_name_arg, *namespace_arg = (char *)default_namespace.c_str();
+    herr_t status;
+    
+    static const char *kwlist[] = {
+                                   "file_name",
+                                   "pop_name",
+                                   "gids",
+                                   "values",
+                                   "namespace",
+                                   "comm",
+                                   "io_size",
+                                   "chunk_size",
+                                   "value_chunk_size",
+                                   "cache_size",
+                                   "compression",
+                                   NULL};
+
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "ssOO|sOkkkkO", (char **)kwlist,
+                                     &file_name_arg, &pop_name_arg, &py_gids, &py_attr_values,
+                                     &namespace_arg, &py_comm, 
+                                     &io_size, &chunk_size, &value_chunk_size, &cache_size,
+                                     &py_compression))
+      return NULL;
+    throw_assert(PyDict_Check(py_attr_values),
+                 "py_append_cell_attribute_arrays: values must be a dictionary");
+    hdf5::DatasetCreationPolicy dataset_policy;
+    build_dataset_creation_policy(py_compression, dataset_policy);
+
+    MPI_Comm comm;
+
+    if ((py_comm != NULL) && (py_comm != Py_None))
+      {
+        comm_ptr = PyMPIComm_Get(py_comm);
+        throw_assert(comm_ptr != NULL, 
+                     "py_append_cell_attribute_arrays: pointer to MPI communicator is null");
+        throw_assert(*comm_ptr != MPI_COMM_NULL,
+                     "py_append_cell_attribute_arrays: MPI communicator is null");
+        status = MPI_Comm_dup(*comm_ptr, &comm);
+        throw_assert(status == MPI_SUCCESS,
+                     "py_append_cell_attribute_arrays: unable to duplicate MPI communicator");
+      }
+    else
+      {
+        status = MPI_Comm_dup(MPI_COMM_WORLD, &comm);
+        throw_assert(status == MPI_SUCCESS,
+                     "py_append_cell_attribute_arrays: unable to duplicate MPI communicator");
+      }
+
+    int ssize; size_t size;
+    throw_assert(MPI_Comm_size(comm, &ssize) == MPI_SUCCESS,
+                 "py_append_cell_attribute_arrays: unable to obtain communicator size");
+    size = ssize;
+    if ((io_size == 0) || (io_size > size))
+      {
+        io_size = size;
+      }
+
+    string file_name      = string(file_name_arg);
+    string pop_name       = string(pop_name_arg);
+    string attr_namespace = string(namespace_arg);
+
+    pop_label_map_t pop_labels;
+    status = cell::read_population_labels(comm, file_name, pop_labels);
+    throw_assert (status >= 0,
+                  "py_append_cell_attribute_arrays: unable to read population labels");
+    
+    pop_t pop_idx=0; bool pop_idx_set=false;
+    for (auto& x: pop_labels) 
+      {
+        if (get<1>(x) == pop_name)
+          {
+            pop_idx = get<0>(x);
+            pop_idx_set = true;
+          }
+      }
+    if (!pop_idx_set)
+      {
+        throw_err(std::string("py_append_cell_attribute_arrays: ") + "Population " + pop_name + " not found");
+      }
         
-        map<string, map<CELL_IDX_T, deque<uint32_t> >> all_attr_values_uint32;
-        map<string, map<CELL_IDX_T, deque<int32_t> >> all_attr_values_int32;
-        map<string, map<CELL_IDX_T, deque<uint16_t> >> all_attr_values_uint16;
-        map<string, map<CELL_IDX_T, deque<int16_t> >> all_attr_values_int16;
-        map<string, map<CELL_IDX_T, deque<uint8_t> >>  all_attr_values_uint8;
-        map<string, map<CELL_IDX_T, deque<int8_t> >>  all_attr_values_int8;
-        map<string, map<CELL_IDX_T, deque<float> >>  all_attr_values_float;
+    pop_range_map_t pop_ranges;
+    size_t n_nodes;
+    throw_assert(cell::read_population_ranges(comm, file_name, pop_ranges, n_nodes) >= 0,
+                 "py_append_cell_attribute_arrays: unable to read population ranges");
 
-        const data::optional_hid dflt_data_type;
+    CELL_IDX_T pop_start = 0;
+    {
+      auto it = pop_ranges.find(pop_idx);
+      throw_assert(it != pop_ranges.end(),
+                   "py_append_cell_attribute_arrays: invalid population index");
+      pop_start = it->second.start;
+    }
 
-        build_cell_attr_value_maps(idx_values,
-                                   all_attr_values_uint32,
-                                   all_attr_values_uint16,
-                                   all_attr_values_uint8,
-                                   all_attr_values_int32,
-                                   all_attr_values_int16,
-                                   all_attr_values_int8,
-                                   all_attr_values_float);
+    // the attributes of this rank are converted first, and the ranks
+    // agree on the attribute names and types before any exchange, so
+    // that invalid arguments raise an error on all ranks; attributes
+    // not given on this rank are appended without cells
+    PyCellAttributeArrays attr_arrays;
+    map<string, hdf5::CellAttributeAppend> local_attrs;
+    map<string, map<string, int> > attr_types;
+    string local_error;
+    try
+      {
+        PyObject *py_attr_key, *py_attr_item;
+        Py_ssize_t attr_pos = 0;
+        while (PyDict_Next(py_attr_values, &attr_pos, &py_attr_key, &py_attr_item))
+          {
+            throw_assert(PyStr_Check(py_attr_key),
+                         "py_append_cell_attribute_arrays: attribute name is not a string");
+            const string attr_name = string(PyStr_ToCString(py_attr_key));
+            throw_assert(PyTuple_Check(py_attr_item) && (PyTuple_GET_SIZE(py_attr_item) == 2),
+                         "py_append_cell_attribute_arrays: attribute " << attr_name
+                         << " must be a tuple (attr_ptr, values)");
+            PyObject *py_attr_ptr = PyTuple_GET_ITEM(py_attr_item, 0);
+            PyObject *py_values = PyTuple_GET_ITEM(py_attr_item, 1);
+            throw_assert(PyArray_Check(py_values),
+                         "py_append_cell_attribute_arrays: values of attribute " << attr_name
+                         << " must be an array");
+            const int npy_type = PyArray_TYPE((PyArrayObject *)py_values);
+            throw_assert(is_array_attr_type(npy_type),
+                         "py_append_cell_attribute_arrays: unsupported type of attribute " << attr_name);
+            local_attrs.emplace(attr_name, attr_arrays.add(attr_name, npy_type, py_gids, py_attr_ptr, py_values));
+            attr_types[attr_namespace][attr_name] = npy_type;
+          }
+      }
+    catch (const std::exception& e)
+      {
+        local_error = e.what();
+      }
+    agree_attribute_types(comm, "py_append_cell_attribute_arrays", local_error, attr_types);
 
-        cell::append_cell_attribute_maps (data_comm, file_name,
-                                          attr_namespace, pop_name, pop_start,
-                                          all_attr_values_uint32,
-                                          all_attr_values_int32,
-                                          all_attr_values_uint16,
-                                          all_attr_values_int16,
-                                          all_attr_values_uint8,
-                                          all_attr_values_int8,
-                                          all_attr_values_float,
-                                          io_size, dflt_data_type,
-                                          IndexOwner, CellPtr(PtrOwner),
-                                          chunk_size, value_chunk_size, cache_size);
+    // attributes in name order, so that all ranks append them in the
+    // same order
+    vector<hdf5::CellAttributeAppend> attrs;
+    for (auto const& attr_type : attr_types[attr_namespace])
+      {
+        auto it = local_attrs.find(attr_type.first);
+        if (it != local_attrs.end())
+          {
+            attrs.push_back(it->second);
+          }
+        else
+          {
+            attrs.push_back(attr_arrays.add(attr_type.first, attr_type.second, NULL, NULL, NULL));
+          }
       }
-    
-    throw_assert(MPI_Barrier(data_comm) == MPI_SUCCESS,
-                 "py_append_cell_attributes: error in MPI barrier on data communicator");
-    throw_assert(MPI_Barrier(comm) == MPI_SUCCESS,
-                 "py_append_cell_attributes: error in MPI barrier");
 
-    throw_assert(MPI_Comm_free(&data_comm) == MPI_SUCCESS,
-                 "py_append_cell_attributes: unable to free data MPI communicator");
+    cell::append_cell_attribute_arrays (comm, file_name, attr_namespace, pop_name, pop_start,
+                                        attrs, io_size, chunk_size, value_chunk_size,
+                                        cache_size, dataset_policy);
+
+    throw_assert(MPI_Barrier(comm) == MPI_SUCCESS,
+                 "py_append_cell_attribute_arrays: error in MPI barrier");
     throw_assert(MPI_Comm_free(&comm) == MPI_SUCCESS,
-                 "py_append_cell_attributes: unable to free MPI communicator");
+                 "py_append_cell_attribute_arrays: unable to free MPI communicator");
     
     Py_INCREF(Py_None);
     return Py_None;
@@ -6728,6 +9116,7 @@ extern "C"
     unsigned long chunk_size = default_chunk_size;
     unsigned long value_chunk_size = default_value_chunk_size;
     unsigned long cache_size = default_cache_size;
+    PyObject *py_compression = NULL;
     char *file_name_arg, *pop_name_arg;
     herr_t status;
     
@@ -6740,14 +9129,19 @@ extern "C"
                                    "chunk_size",
                                    "value_chunk_size",
                                    "cache_size",
+                                   "compression",
                                    NULL};
 
-    if (!PyArg_ParseTupleAndKeywords(args, kwds, "ssO|Okkkk", (char **)kwlist,
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "ssO|OkkkkO", (char **)kwlist,
                                      &file_name_arg, &pop_name_arg, &idx_values,
                                      &py_comm, &io_size,
-                                     &chunk_size, &value_chunk_size, &cache_size))
+                                     &chunk_size, &value_chunk_size, &cache_size,
+                                     &py_compression))
       return NULL;
 
+    hdf5::DatasetCreationPolicy dataset_policy;
+    build_dataset_creation_policy(py_compression, dataset_policy);
+
     MPI_Comm comm;
 
     if ((py_comm != NULL) && (py_comm != Py_None))
@@ -6948,7 +9342,8 @@ extern "C"
           }
     
         throw_assert(cell::append_trees (data_comm, file_name, pop_name, pop_start, tree_list,
-                                         io_size, chunk_size, value_chunk_size) >= 0,
+                                         io_size, chunk_size, value_chunk_size,
+                                         dataset_policy) >= 0,
                      "py_append_cell_trees: unable to append trees");
       }
     throw_assert(MPI_Barrier(data_comm) == MPI_SUCCESS,
@@ -6967,6 +9362,14 @@ extern "C"
   
   enum seq_pos {seq_next, seq_last, seq_empty, seq_done};
   
+  /* One edge block read and exchanged by scatter_read_projection */
+  struct NeuroH5ProjectionBlock {
+    std::shared_ptr<EdgeCSR> edge_csr;
+    vector < map <string, vector < vector<string> > > > edge_attr_name_vector;
+    size_t local_num_nodes=0, local_num_edges=0, total_num_edges=0, max_local_num_nodes=0;
+    hsize_t total_read_blocks=0;
+  };
+
   /* NeuroH5ProjectionGenState - neurograph generator instance.
    *
    * file_name: input file name
@@ -6976,8 +9379,10 @@ extern "C"
    * seq_index: index of the next edge in the sequence to yield
    * start_index: starting index of the next batch of edges to read from file
    * cache_size: how many edge blocks to read from file at at time
+   * prefetch: whether the next edge block is read in the background
    *
    */
+
   typedef struct {
     Py_ssize_t node_index, node_count, block_index, block_count, cache_index, cache_size, io_size, comm_size;
 
@@ -6991,14 +9396,17 @@ extern "C"
     pop_label_map_t pop_labels;
     vector<pair<string,string> > prj_names;
     node_rank_map_t node_rank_map;
-    edge_map_t edge_map;
-    edge_map_iter_t edge_map_iter;
+    std::shared_ptr<EdgeCSR> edge_csr;
+    size_t edge_csr_index;
     map <string, vector< vector<string> > > edge_attr_names;
     vector<string> edge_attr_name_spaces;
     string src_pop_name, dst_pop_name;
     size_t total_num_nodes, local_num_nodes, total_num_edges, local_num_edges;
     hsize_t total_read_blocks;
     NODE_IDX_T dst_start, src_start;
+    bool prefetch;
+    std::future<void> prefetch_read;
+    NeuroH5ProjectionBlock prefetch_block;
 
   } NeuroH5ProjectionGenState;
 
@@ -7016,6 +9424,8 @@ extern "C"
    * seq_index: index of the next tree in the sequence to yield
    * start_index: starting index of the next batch of trees to read from file
    * cache_size: how many trees to read from file at at time
+   * prefetch: whether the next block of trees is read in the background
+   * reader: block reader that keeps the index and I/O ranks between blocks
    *
    */
   typedef struct {
@@ -7029,14 +9439,19 @@ extern "C"
     string file_name;
     MPI_Comm comm;
     pop_range_map_t pop_ranges;
-    map<CELL_IDX_T, neurotree_t> tree_map;
+    std::shared_ptr<PackedTrees> trees;
     vector<string> attr_name_spaces;
     map <string, NamedAttrMap> attr_maps;
     map <string, vector< vector <string> > > attr_names;
-    map<CELL_IDX_T, neurotree_t>::const_iterator it_tree;
+    size_t it_tree;
     node_rank_map_t node_rank_map;
     bool topology_flag;
     bool validate_flag;
+    bool prefetch;
+    std::future<void> prefetch_read;
+    std::shared_ptr<PackedTrees> prefetch_trees;
+    map <string, NamedAttrMap> prefetch_attr_maps;
+    std::shared_ptr<cell::TreeBlockReader> reader;
     
   } NeuroH5TreeGenState;
 
@@ -7056,6 +9471,8 @@ extern "C"
    * seq_index: index of the next id in the sequence to yield
    * start_index: starting index of the next batch of trees to read from file
    * cache_size: how many trees to read from file at at time
+   * prefetch: whether the next block of attributes is read in the background
+   * reader: block reader that keeps the index and I/O ranks between blocks
    *
    */
   typedef struct {
@@ -7072,14 +9489,18 @@ extern "C"
     pop_range_map_t pop_ranges;
     string attr_namespace;
     set <string> attr_mask;
-    NamedAttrMap attr_map;
+    std::shared_ptr<ColumnarAttrMap> attr_map;
     vector< vector <string> > attr_names;
-    set<CELL_IDX_T>::const_iterator it_idx;
+    size_t it_idx;
     node_rank_map_t node_rank_map;
     PyTypeObject* struct_type;
     vector<PyStructSequence_Field> struct_descr_fields;
     PyObject *tuple_index_info;
     return_type return_tp;
+    bool prefetch;
+    std::future<void> prefetch_read;
+    std::shared_ptr<ColumnarAttrMap> prefetch_attr_map;
+    std::shared_ptr<cell::CellAttributeBlockReader> reader;
     
   } NeuroH5CellAttrGenState;
   
@@ -7088,12 +9509,241 @@ extern "C"
     NeuroH5CellAttrGenState *state;
   } PyNeuroH5CellAttrGenState;
 
+
+  /* Reads and exchanges the edge block that starts at block_index.
+   * Collective on the communicator of the generator. */
+  static void neuroh5_prj_gen_read_block(NeuroH5ProjectionGenState *state,
+                                         size_t block_index,
+                                         NeuroH5ProjectionBlock& block)
+  {
+    LibraryGuard guard;
+    vector <EdgeCSR> prj_vector;
+
+    int status = MPI_Barrier(state->comm);
+    throw_assert(status == MPI_SUCCESS, "NeuroH5ProjectionGen: MPI_Barrier error");
+
+    status = graph::scatter_read_projection(state->comm,
+                                            state->io_size,
+                                            state->edge_map_type,
+                                            state->file_name,
+                                            state->src_pop_name,
+                                            state->dst_pop_name,
+                                            state->src_start,
+                                            state->dst_start,
+                                            state->edge_attr_name_spaces,
+                                            state->node_rank_map,
+                                            state->pop_search_ranges,
+                                            state->pop_pairs,
+                                            prj_vector,
+                                            block.edge_attr_name_vector,
+                                            block.local_num_nodes,
+                                            block.local_num_edges,
+                                            block.total_num_edges,
+                                            block.total_read_blocks,
+                                            block_index,
+                                            state->cache_size);
+
+    throw_assert (status >= 0, "NeuroH5ProjectionGen: read_projection error");
+    throw_assert(prj_vector.size() > 0, "NeuroH5ProjectionGen: empty projection");
+
+    block.edge_csr = std::make_shared<EdgeCSR>(std::move(prj_vector[0]));
+
+    status = MPI_Barrier(state->comm);
+    throw_assert(status == MPI_SUCCESS, "NeuroH5ProjectionGen: MPI_Barrier error");
+
+    status = MPI_Allreduce(&(block.local_num_nodes), &(block.max_local_num_nodes), 1,
+                           MPI_SIZE_T, MPI_MAX, state->comm);
+    throw_assert(status == MPI_SUCCESS, "NeuroH5ProjectionGen: MPI_Allreduce error");
+
+    status = MPI_Barrier(state->comm);
+    throw_assert(status == MPI_SUCCESS, "NeuroH5ProjectionGen: MPI_Barrier error");
+  }
+
+  /* Starts reading the next edge block in the background. All ranks
+   * start the same reads in the same order, so the collectives issued
+   * by the background threads match. */
+  static void neuroh5_prj_gen_prefetch(NeuroH5ProjectionGenState *state)
+  {
+    if (state->prefetch && (state->block_index < state->block_count))
+      {
+        const size_t block_index = state->block_index;
+        const size_t ticket = library_lock.take_ticket();
+        state->prefetch_block = NeuroH5ProjectionBlock();
+        state->prefetch_read = std::async(std::launch::async, [state, block_index, ticket] () {
+            LibraryGuard guard(ticket);
+            neuroh5_prj_gen_read_block(state, block_index, state->prefetch_block);
+          });
+      }
+  }
+
+  /* Reads the block of trees that starts at offset. Collective on the
+   * communicator of the generator. */
+  static void neuroh5_tree_gen_read_block(NeuroH5TreeGenState *state,
+                                          size_t offset,
+                                          PackedTrees& trees,
+                                          map <string, NamedAttrMap>& attr_maps)
+  {
+    LibraryGuard guard;
+    throw_assert(MPI_Barrier(state->comm) == MPI_SUCCESS, "NeuroH5TreeGen: MPI_Barrier error");
+
+    int status = state->reader->read (offset, state->cache_size, trees, attr_maps);
+    throw_assert (status >= 0,
+                  "NeuroH5TreeGen: error in call to cell::TreeBlockReader::read");
+
+    throw_assert(MPI_Barrier(state->comm) == MPI_SUCCESS, "NeuroH5TreeGen: MPI_Barrier error");
+  }
+
+  static void neuroh5_tree_gen_prefetch(NeuroH5TreeGenState *state)
+  {
+    if (state->prefetch && (state->cache_index < state->count))
+      {
+        const size_t offset = state->cache_index;
+        const size_t ticket = library_lock.take_ticket();
+        state->prefetch_trees = std::make_shared<PackedTrees>();
+        state->prefetch_attr_maps.clear();
+        state->prefetch_read = std::async(std::launch::async, [state, offset, ticket] () {
+            LibraryGuard guard(ticket);
+            neuroh5_tree_gen_read_block(state, offset, *(state->prefetch_trees),
+                                        state->prefetch_attr_maps);
+          });
+      }
+  }
+
+  /* Reads the block of cell attributes that starts at offset. Collective
+   * on the communicator of the generator. */
+  static void neuroh5_cell_attr_gen_read_block(NeuroH5CellAttrGenState *state,
+                                               size_t offset,
+                                               ColumnarAttrMap& attr_map)
+  {
+    LibraryGuard guard;
+    throw_assert(MPI_Barrier(state->comm) == MPI_SUCCESS, "NeuroH5CellAttrGen: MPI_Barrier error");
+
+    vector<ColumnarAttrMap> attr_maps;
+    int status = state->reader->read (offset, state->cache_size, attr_maps);
+    throw_assert (status >= 0,
+                  "NeuroH5CellAttrGen: error in call to cell::CellAttributeBlockReader::read");
+    attr_map = std::move(attr_maps[0]);
+
+    throw_assert(MPI_Barrier(state->comm) == MPI_SUCCESS, "NeuroH5CellAttrGen: MPI_Barrier error");
+  }
+
+  static void neuroh5_cell_attr_gen_prefetch(NeuroH5CellAttrGenState *state)
+  {
+    if (state->prefetch && (state->cache_index < state->count))
+      {
+        const size_t offset = state->cache_index;
+        const size_t ticket = library_lock.take_ticket();
+        state->prefetch_attr_map = std::make_shared<ColumnarAttrMap>();
+        state->prefetch_read = std::async(std::launch::async, [state, offset, ticket] () {
+            LibraryGuard guard(ticket);
+            neuroh5_cell_attr_gen_read_block(state, offset, *(state->prefetch_attr_map));
+          });
+      }
+  }
+
+  /* Waits for a block read that is still running, so that the
+   * communicator of a generator can be freed. */
+  static void neuroh5_gen_finish_prefetch(std::future<void>& prefetch_read)
+  {
+    if (prefetch_read.valid())
+      {
+        ReleaseGIL release;
+        prefetch_read.wait();
+      }
+  }
+
+  /* Readers of generators that were destroyed before they were closed or
+   * exhausted. Closing their files and communicators is collective, and
+   * garbage collection need not happen at the same point on all ranks, so
+   * they are kept open until the process exits. */
+  static vector< std::shared_ptr<void> > *unclosed_gen_readers = new vector< std::shared_ptr<void> >();
+
+  /* Called by the deallocation of a generator that still holds its
+   * communicator; keeps its reader and communicator, and emits a
+   * ResourceWarning. Makes no MPI calls. */
+  static void neuroh5_gen_abandon(PyObject *self, const char *type_name,
+                                  std::shared_ptr<void> reader, MPI_Comm& comm)
+  {
+    if (reader)
+      {
+        unclosed_gen_readers->push_back(reader);
+      }
+    comm = MPI_COMM_NULL;
+
+    PyObject *error_type, *error_value, *error_traceback;
+    PyErr_Fetch(&error_type, &error_value, &error_traceback);
+    if (PyErr_WarnFormat(PyExc_ResourceWarning, 1,
+                         "%s was destroyed before it was exhausted or closed; "
+                         "call close() on all ranks to release its file and communicator",
+                         type_name) < 0)
+      {
+        PyErr_WriteUnraisable(self);
+      }
+    PyErr_Restore(error_type, error_value, error_traceback);
+  }
+
+  /* Releases the block reader and the communicator of a tree generator.
+   * Collective on the communicator of the generator. */
+  static void neuroh5_tree_gen_close_state(NeuroH5TreeGenState *state)
+  {
+    neuroh5_gen_finish_prefetch(state->prefetch_read);
+    if (state->comm != MPI_COMM_NULL)
+      {
+        int status = MPI_Barrier(state->comm);
+        throw_assert(status == MPI_SUCCESS, "NeuroH5TreeGen: MPI_Barrier error");
+        {
+          LibraryGuard guard;
+          state->reader.reset();
+        }
+        status = MPI_Comm_free(&(state->comm));
+        throw_assert(status == MPI_SUCCESS,
+                     "NeuroH5TreeGen: unable to free MPI communicator");
+      }
+  }
+
+  /* Releases the block reader and the communicator of a cell attribute
+   * generator. Collective on the communicator of the generator. */
+  static void neuroh5_cell_attr_gen_close_state(NeuroH5CellAttrGenState *state)
+  {
+    neuroh5_gen_finish_prefetch(state->prefetch_read);
+    if (state->comm != MPI_COMM_NULL)
+      {
+        int status = MPI_Barrier(state->comm);
+        throw_assert(status == MPI_SUCCESS, "NeuroH5CellAttrGen: MPI_Barrier error");
+        {
+          LibraryGuard guard;
+          state->reader.reset();
+        }
+        status = MPI_Comm_free(&(state->comm));
+        throw_assert(status == MPI_SUCCESS,
+                     "NeuroH5CellAttrGen: unable to free MPI communicator");
+      }
+  }
+
+  /* Releases the communicator of a projection generator. Collective on
+   * the communicator of the generator. */
+  static void neuroh5_prj_gen_close_state(NeuroH5ProjectionGenState *state)
+  {
+    neuroh5_gen_finish_prefetch(state->prefetch_read);
+    if (state->comm != MPI_COMM_NULL)
+      {
+        int status = MPI_Barrier(state->comm);
+        throw_assert(status == MPI_SUCCESS, "NeuroH5ProjectionGen: MPI_Barrier error");
+        status = MPI_Comm_free(&(state->comm));
+        throw_assert(status == MPI_SUCCESS,
+                     "NeuroH5ProjectionGen: unable to free MPI communicator");
+      }
+  }
+
   
   static PyObject *
   neuroh5_prj_gen_new(PyTypeObject *type, PyObject *args, PyObject *kwargs)
   {
+    // a block read started at the end is run after the guard is released
+    LibraryGuard guard;
     int status;
     int opt_edge_map_type=0;
+    int prefetch_flag=0;
     EdgeMapType edge_map_type = EdgeMapDst;
     PyObject *py_comm = NULL;
     MPI_Comm *comm_ptr  = NULL;
@@ -7115,14 +9765,23 @@ extern "C"
                                    "comm",
                                    "io_size",
                                    "cache_size",
+                                   "prefetch",
                                    NULL};
 
-    if (!PyArg_ParseTupleAndKeywords(args, kwargs, "sss|OiOii", (char **)kwlist,
+    if (!PyArg_ParseTupleAndKeywords(args, kwargs, "sss|OiOiii", (char **)kwlist,
                                      &file_name, &src_pop_name, &dst_pop_name, 
                                      &py_attr_name_spaces, &opt_edge_map_type,
-                                     &py_comm, &io_size, &cache_size))
+                                     &py_comm, &io_size, &cache_size, &prefetch_flag))
       return NULL;
 
+    if (prefetch_flag && !prefetch_supported())
+      {
+        if (PyErr_WarnEx(PyExc_RuntimeWarning,
+                         "NeuroH5ProjectionGen: prefetch requires MPI_THREAD_MULTIPLE and a thread-safe HDF5 library; blocks will be read synchronously", 1) < 0)
+          return NULL;
+        prefetch_flag = 0;
+      }
+
     MPI_Comm comm;
 
     if ((py_comm != NULL) && (py_comm != Py_None))
@@ -7219,7 +9878,8 @@ extern "C"
     py_ngg->state->pop_search_ranges  = pop_search_ranges;
     py_ngg->state->pop_pairs       = pop_pairs;
     py_ngg->state->pop_labels      = pop_labels;
-    py_ngg->state->edge_map_iter   = py_ngg->state->edge_map.begin();
+    py_ngg->state->edge_csr        = std::make_shared<EdgeCSR>(edge_map_type);
+    py_ngg->state->edge_csr_index  = 0;
     py_ngg->state->edge_map_type   = edge_map_type;
     py_ngg->state->edge_attr_name_spaces = attr_name_spaces;
     py_ngg->state->total_num_nodes = total_num_nodes;
@@ -7264,6 +9924,9 @@ extern "C"
 
     py_ngg->state->dst_start = dst_start;
     py_ngg->state->src_start = src_start;
+    py_ngg->state->prefetch  = prefetch_flag;
+
+    neuroh5_prj_gen_prefetch(py_ngg->state);
     
     return (PyObject *)py_ngg;
     
@@ -7272,9 +9935,12 @@ extern "C"
   static PyObject *
   neuroh5_tree_gen_new(PyTypeObject *type, PyObject *args, PyObject *kwargs)
   {
+    // a block read started at the end is run after the guard is released
+    LibraryGuard guard;
     int status;
     int topology_flag=1;
     int validate_flag=1;
+    int prefetch_flag=0;
     PyObject *py_node_allocation = NULL;
     PyObject *py_comm = NULL;
     MPI_Comm *comm_ptr  = NULL;
@@ -7293,14 +9959,24 @@ extern "C"
                                    "node_allocation",
                                    "io_size",
                                    "cache_size",
+                                   "prefetch",
                                    NULL};
 
-    if (!PyArg_ParseTupleAndKeywords(args, kwargs, "ss|OiiOOii", (char **)kwlist,
+    if (!PyArg_ParseTupleAndKeywords(args, kwargs, "ss|OiiOOiii", (char **)kwlist,
                                      &file_name, &pop_name, 
                                      &py_attr_name_spaces, &topology_flag, &validate_flag,
-                                     &py_comm, &py_node_allocation, &io_size, &cache_size))
+                                     &py_comm, &py_node_allocation, &io_size, &cache_size,
+                                     &prefetch_flag))
       return NULL;
 
+    if (prefetch_flag && !prefetch_supported())
+      {
+        if (PyErr_WarnEx(PyExc_RuntimeWarning,
+                         "NeuroH5TreeGen: prefetch requires MPI_THREAD_MULTIPLE and a thread-safe HDF5 library; blocks will be read synchronously", 1) < 0)
+          return NULL;
+        prefetch_flag = 0;
+      }
+
     MPI_Comm comm;
 
     if ((py_comm != NULL) && (py_comm != Py_None))
@@ -7323,7 +9999,7 @@ extern "C"
     throw_assert(MPI_Comm_rank(comm, &rank) == MPI_SUCCESS,
                  "NeuroH5TreeGen: unable to obtain MPI communicator rank");
     
-    if ((size > 0) && (io_size > (unsigned int)size))
+    if ((size > 0) && ((io_size == 0) || (io_size > (unsigned int)size)))
       io_size = size;
     
     // Create C++ vector of namespace strings:
@@ -7424,9 +10100,20 @@ extern "C"
     py_ntrg->state->topology_flag  = topology_flag;
     py_ntrg->state->validate_flag  = validate_flag;
 
-    map<CELL_IDX_T, neurotree_t> tree_map;
-    py_ntrg->state->tree_map = tree_map;
-    py_ntrg->state->it_tree  = py_ntrg->state->tree_map.cbegin();
+    py_ntrg->state->prefetch       = prefetch_flag;
+
+    py_ntrg->state->trees    = std::make_shared<PackedTrees>();
+    py_ntrg->state->it_tree  = 0;
+
+    py_ntrg->state->reader = std::make_shared<cell::TreeBlockReader>(py_ntrg->state->comm,
+                                                                     py_ntrg->state->file_name,
+                                                                     io_size,
+                                                                     attr_name_spaces,
+                                                                     py_ntrg->state->node_rank_map,
+                                                                     py_ntrg->state->pop_name,
+                                                                     pop_start);
+
+    neuroh5_tree_gen_prefetch(py_ntrg->state);
 
     return (PyObject *)py_ntrg;
   }
@@ -7435,7 +10122,10 @@ extern "C"
   static PyObject *
   neuroh5_cell_attr_gen_new(PyTypeObject *type, PyObject *args, PyObject *kwargs)
   {
+    // a block read started at the end is run after the guard is released
+    LibraryGuard guard;
     int status;
+    int prefetch_flag=0;
     PyObject *py_comm = NULL;
     PyObject *py_mask = NULL;
     PyObject *py_tuple_index_dict = NULL;
@@ -7458,15 +10148,25 @@ extern "C"
                                    "cache_size",
                                    "return_type",
                                    "tuple_index_dict",
+                                   "prefetch",
                                    NULL};
 
-    if (!PyArg_ParseTupleAndKeywords(args, kwargs, "sss|OOOkisO", (char **)kwlist,
+    if (!PyArg_ParseTupleAndKeywords(args, kwargs, "sss|OOOkisOi", (char **)kwlist,
                                      &file_name, &pop_name, &attr_namespace, 
                                      &py_comm, &py_node_allocation, &py_mask, 
                                      &io_size, &cache_size,
-                                     &return_type_arg, &py_tuple_index_dict))
+                                     &return_type_arg, &py_tuple_index_dict,
+                                     &prefetch_flag))
       return NULL;
 
+    if (prefetch_flag && !prefetch_supported())
+      {
+        if (PyErr_WarnEx(PyExc_RuntimeWarning,
+                         "NeuroH5CellAttrGen: prefetch requires MPI_THREAD_MULTIPLE and a thread-safe HDF5 library; blocks will be read synchronously", 1) < 0)
+          return NULL;
+        prefetch_flag = 0;
+      }
+
     if (return_type_arg != NULL)
       {
         string return_type_str = string(return_type_arg);
@@ -7601,23 +10301,41 @@ extern "C"
     py_ntrg->state->return_tp      = return_tp;
     py_ntrg->state->tuple_index_info = NULL;
     
-    NamedAttrMap attr_map;
-    py_ntrg->state->attr_map  = attr_map;
-    py_ntrg->state->it_idx = py_ntrg->state->attr_map.index_set.cbegin();
+    py_ntrg->state->prefetch       = prefetch_flag;
+    
+    py_ntrg->state->attr_map  = std::make_shared<ColumnarAttrMap>();
+    py_ntrg->state->it_idx = 0;
+
+    py_ntrg->state->reader =
+      std::make_shared<cell::CellAttributeBlockReader>(py_ntrg->state->comm,
+                                                       py_ntrg->state->file_name,
+                                                       io_size,
+                                                       vector< pair<string, set<string> > >
+                                                       (1, make_pair(string(attr_namespace), attr_mask)),
+                                                       py_ntrg->state->node_rank_map,
+                                                       py_ntrg->state->pop_name,
+                                                       pop_start);
+
+    neuroh5_cell_attr_gen_prefetch(py_ntrg->state);
 
     return (PyObject *)py_ntrg;
   }
 
+  /* Deallocation frees local resources only; a generator that has not
+   * been exhausted or closed keeps its reader and communicator. */
   static void
   neuroh5_tree_gen_dealloc(PyNeuroH5TreeGenState *py_ntrg)
   {
+    neuroh5_gen_finish_prefetch(py_ntrg->state->prefetch_read);
     if (py_ntrg->state->comm != MPI_COMM_NULL)
       {
-        int status = MPI_Comm_free(&(py_ntrg->state->comm));
-        throw_assert(status == MPI_SUCCESS,
-                     "NeuroH5TreeGen: unable to free MPI communicator");
+        neuroh5_gen_abandon((PyObject *)py_ntrg, "NeuroH5TreeGen",
+                            std::move(py_ntrg->state->reader), py_ntrg->state->comm);
       }
-    delete py_ntrg->state;
+    {
+      LibraryGuard guard;
+      delete py_ntrg->state;
+    }
     Py_TYPE(py_ntrg)->tp_free(py_ntrg);
   }
 
@@ -7628,27 +10346,32 @@ extern "C"
     Py_XDECREF(py_ntrg->state->struct_type);
 #endif
     Py_XDECREF(py_ntrg->state->tuple_index_info);
+    neuroh5_gen_finish_prefetch(py_ntrg->state->prefetch_read);
     if (py_ntrg->state->comm != MPI_COMM_NULL)
       {
-        int status = MPI_Comm_free(&(py_ntrg->state->comm));
-        throw_assert(status == MPI_SUCCESS,
-                     "NeuroH5CellAttrGen: unable to free MPI communicator");
-        py_ntrg->state->comm = MPI_COMM_NULL;
+        neuroh5_gen_abandon((PyObject *)py_ntrg, "NeuroH5CellAttrGen",
+                            std::move(py_ntrg->state->reader), py_ntrg->state->comm);
       }
-    delete py_ntrg->state;
+    {
+      LibraryGuard guard;
+      delete py_ntrg->state;
+    }
     Py_TYPE(py_ntrg)->tp_free(py_ntrg);
   }
 
   static void
   neuroh5_prj_gen_dealloc(PyNeuroH5ProjectionGenState *py_ngg)
   {
+    neuroh5_gen_finish_prefetch(py_ngg->state->prefetch_read);
     if (py_ngg->state->comm != MPI_COMM_NULL)
       {
-        int status = MPI_Comm_free(&(py_ngg->state->comm));
-        throw_assert(status == MPI_SUCCESS, 
-                     "NeuroH5ProjectionGen: unable to free MPI communicator");
+        neuroh5_gen_abandon((PyObject *)py_ngg, "NeuroH5ProjectionGen",
+                            std::shared_ptr<void>(), py_ngg->state->comm);
       }
-    delete py_ngg->state;
+    {
+      LibraryGuard guard;
+      delete py_ngg->state;
+    }
     Py_TYPE(py_ngg)->tp_free(py_ngg);
   }
 
@@ -7675,49 +10398,38 @@ extern "C"
           // If the end of the current cache block has been reached,
           // and the iterator has not exceed its locally assigned elements,
           // read the next block
-          if ((py_ntrg->state->it_tree == py_ntrg->state->tree_map.cend()) &&
+          if ((py_ntrg->state->it_tree == py_ntrg->state->trees->num_trees()) &&
               (py_ntrg->state->cache_index < py_ntrg->state->count))
             {
-              int status;
-              py_ntrg->state->tree_map.clear();
-              py_ntrg->state->attr_maps.clear();
-
-              throw_assert(MPI_Barrier(py_ntrg->state->comm) == MPI_SUCCESS, "NeuroH5TreeGen: MPI_Barrier error");
-
-              status = cell::scatter_read_trees (py_ntrg->state->comm,
-                                                 py_ntrg->state->file_name,
-                                                 py_ntrg->state->io_size,
-                                                 py_ntrg->state->attr_name_spaces,
-                                                 py_ntrg->state->node_rank_map,
-                                                 py_ntrg->state->pop_name,
-                                                 py_ntrg->state->pop_start,
-                                                 py_ntrg->state->tree_map,
-                                                 py_ntrg->state->attr_maps,
-                                                 py_ntrg->state->cache_index,
-                                                 py_ntrg->state->cache_size);
-              throw_assert (status >= 0,
-                            "NeuroH5TreeGen: error in call to cell::scatter_read_trees");
-
-              throw_assert(MPI_Barrier(py_ntrg->state->comm) == MPI_SUCCESS, "NeuroH5TreeGen: MPI_Barrier error");
-
-              if (py_ntrg->state->cache_index < py_ntrg->state->count)
+              // the arrays returned for the previous block refer to the
+              // previous trees
+              if (py_ntrg->state->prefetch_read.valid())
+                {
+                  wait_prefetch(py_ntrg->state->prefetch_read);
+                  py_ntrg->state->trees = py_ntrg->state->prefetch_trees;
+                  py_ntrg->state->attr_maps = std::move(py_ntrg->state->prefetch_attr_maps);
+                }
+              else
                 {
-                  py_ntrg->state->cache_index += py_ntrg->state->comm_size * py_ntrg->state->cache_size;
+                  py_ntrg->state->trees = std::make_shared<PackedTrees>();
+                  py_ntrg->state->attr_maps.clear();
+                  neuroh5_tree_gen_read_block(py_ntrg->state, py_ntrg->state->cache_index,
+                                              *(py_ntrg->state->trees),
+                                              py_ntrg->state->attr_maps);
                 }
-              py_ntrg->state->it_tree = py_ntrg->state->tree_map.cbegin();
+
+              py_ntrg->state->cache_index += py_ntrg->state->comm_size * py_ntrg->state->cache_size;
+              py_ntrg->state->it_tree = 0;
+
+              // read the next block while this one is consumed
+              neuroh5_tree_gen_prefetch(py_ntrg->state);
             }
 
-          if (py_ntrg->state->it_tree == py_ntrg->state->tree_map.cend())
+          if (py_ntrg->state->it_tree == py_ntrg->state->trees->num_trees())
             {
               if (py_ntrg->state->seq_index == py_ntrg->state->max_local_count)
                 {
-                  int status = MPI_Barrier(py_ntrg->state->comm);
-                  throw_assert(status == MPI_SUCCESS, "NeuroH5TreeGen: MPI_Barrier error");
-
-                  status = MPI_Comm_free(&(py_ntrg->state->comm));
-                  throw_assert(status == MPI_SUCCESS,
-                               "NeuroH5TreeGen: unable to free MPI communicator");
-
+                  neuroh5_tree_gen_close_state(py_ntrg->state);
                   py_ntrg->state->pos = seq_last;
                 }
               else
@@ -7732,9 +10444,10 @@ extern "C"
             }
           else
             {
-              CELL_IDX_T key = py_ntrg->state->it_tree->first;
-              const neurotree_t &tree = py_ntrg->state->it_tree->second;
-              PyObject *elem = py_build_tree_value(key, tree, py_ntrg->state->attr_maps,
+              CELL_IDX_T key = py_ntrg->state->trees->gids[py_ntrg->state->it_tree];
+              PyObject *elem = py_build_tree_value(key, py_ntrg->state->trees,
+                                                   py_ntrg->state->it_tree,
+                                                   py_ntrg->state->attr_maps,
                                                    py_ntrg->state->topology_flag,
                                                    py_ntrg->state->validate_flag);
               throw_assert(elem != NULL,
@@ -7754,13 +10467,7 @@ extern "C"
         {
           if (py_ntrg->state->seq_index == py_ntrg->state->max_local_count)
             {
-              int status = MPI_Barrier(py_ntrg->state->comm);
-              throw_assert(status == MPI_SUCCESS, "NeuroH5CellTreeGen: MPI_Barrier error");
-
-              status = MPI_Comm_free(&(py_ntrg->state->comm));
-              throw_assert(status == MPI_SUCCESS,
-                           "NeuroH5TreeGen: unable to free MPI communicator");
-
+              neuroh5_tree_gen_close_state(py_ntrg->state);
               py_ntrg->state->pos = seq_last;
             }
           else
@@ -7803,7 +10510,7 @@ extern "C"
         {
           
 
-          if ((py_ntrg->state->it_idx == py_ntrg->state->attr_map.index_set.cend()) &&
+          if ((py_ntrg->state->it_idx == py_ntrg->state->attr_map->index.size()) &&
               (py_ntrg->state->cache_index < py_ntrg->state->count))
             {
               int size, rank;
@@ -7813,34 +10520,31 @@ extern "C"
                            "NeuroH5CellAttrGen: unable to obtain MPI communicator rank");
 
               // If the end of the current cache block has been reached,
-              // read the next block
-              py_ntrg->state->attr_map.clear();
-
-              throw_assert(MPI_Barrier(py_ntrg->state->comm) == MPI_SUCCESS, "NeuroH5CellAttrGen: MPI_Barrier error");
-              int status = cell::scatter_read_cell_attributes (py_ntrg->state->comm,
-                                                               py_ntrg->state->file_name,
-                                                               py_ntrg->state->io_size,
-                                                               py_ntrg->state->attr_namespace,
-                                                               py_ntrg->state->attr_mask,
-                                                               py_ntrg->state->node_rank_map,
-                                                               py_ntrg->state->pop_name,
-                                                               py_ntrg->state->pop_start,
-                                                               py_ntrg->state->attr_map,
-                                                               py_ntrg->state->cache_index,
-                                                               py_ntrg->state->cache_size);
-             
-              throw_assert (status >= 0,
-                            "NeuroH5CellAttrGen: error in call to cell::scatter_read_cell_attributes");
-              throw_assert(MPI_Barrier(py_ntrg->state->comm) == MPI_SUCCESS, "NeuroH5CellAttrGen: MPI_Barrier error");
-
-              py_ntrg->state->attr_map.attr_names(py_ntrg->state->attr_names);
-              py_ntrg->state->it_idx = py_ntrg->state->attr_map.index_set.cbegin();
+              // read the next block into a new map; the arrays returned
+              // for the previous block refer to the previous map
+              if (py_ntrg->state->prefetch_read.valid())
+                {
+                  wait_prefetch(py_ntrg->state->prefetch_read);
+                  py_ntrg->state->attr_map = py_ntrg->state->prefetch_attr_map;
+                }
+              else
+                {
+                  py_ntrg->state->attr_map = std::make_shared<ColumnarAttrMap>();
+                  neuroh5_cell_attr_gen_read_block(py_ntrg->state, py_ntrg->state->cache_index,
+                                                   *(py_ntrg->state->attr_map));
+                }
+
+              py_ntrg->state->attr_map->attr_names(py_ntrg->state->attr_names);
+              py_ntrg->state->it_idx = 0;
               py_ntrg->state->cache_index += size * py_ntrg->state->cache_size;
+
+              // read the next block while this one is consumed
+              neuroh5_cell_attr_gen_prefetch(py_ntrg->state);
               if ((py_ntrg->state->return_tp == return_tuple) && (py_ntrg->state->tuple_index_info == NULL))
                 {
-                  if (py_ntrg->state->attr_map.index_set.size() > 0)
+                  if (py_ntrg->state->attr_map->index.size() > 0)
                     {
-                      py_ntrg->state->tuple_index_info = py_build_cell_attr_tuple_info(py_ntrg->state->attr_map,
+                      py_ntrg->state->tuple_index_info = py_build_cell_attr_tuple_info(*(py_ntrg->state->attr_map),
                                                                                        py_ntrg->state->attr_names);
                       Py_INCREF(py_ntrg->state->tuple_index_info);
                     }
@@ -7849,7 +10553,7 @@ extern "C"
 #if HAS_STRUCT_SEQUENCE
               if ((py_ntrg->state->return_tp == return_struct) && (py_ntrg->state->struct_type == NULL))
                 {
-                  py_ntrg->state->struct_type = py_build_cell_attr_struct_type(py_ntrg->state->attr_map,
+                  py_ntrg->state->struct_type = py_build_cell_attr_struct_type(*(py_ntrg->state->attr_map),
                                                                                py_ntrg->state->attr_names,
                                                                                py_ntrg->state->struct_descr_fields);
                 }
@@ -7857,18 +10561,12 @@ extern "C"
             }
 
 
-          if (py_ntrg->state->it_idx == py_ntrg->state->attr_map.index_set.cend())
+          if (py_ntrg->state->it_idx == py_ntrg->state->attr_map->index.size())
             {
               if (py_ntrg->state->seq_index == py_ntrg->state->max_local_count)
                 {
-                  int status = MPI_Barrier(py_ntrg->state->comm);
-                  throw_assert(status == MPI_SUCCESS, "NeuroH5CellAttrGen: MPI_Barrier error");
-
-                  status = MPI_Comm_free(&(py_ntrg->state->comm));
-                  throw_assert(status == MPI_SUCCESS,
-                               "NeuroH5CellAttrGen: unable to free MPI communicator");
-                  py_ntrg->state->comm = MPI_COMM_NULL;
-                  py_ntrg->state->attr_map.clear();
+                  neuroh5_cell_attr_gen_close_state(py_ntrg->state);
+                  py_ntrg->state->attr_map = std::make_shared<ColumnarAttrMap>();
                   py_ntrg->state->pos = seq_last;
                 }
               else
@@ -7882,7 +10580,7 @@ extern "C"
             }
           else
             {
-              const CELL_IDX_T key = *(py_ntrg->state->it_idx);
+              const CELL_IDX_T key = py_ntrg->state->attr_map->index[py_ntrg->state->it_idx];
               PyObject *elem = NULL;
 
               switch (py_ntrg->state->return_tp)
@@ -7904,7 +10602,7 @@ extern "C"
                                                                                   py_ntrg->state->attr_names);
                     if (py_ntrg->state->tuple_index_info == NULL)
                       {
-                        py_ntrg->state->tuple_index_info = py_build_cell_attr_tuple_info(py_ntrg->state->attr_map,
+                        py_ntrg->state->tuple_index_info = py_build_cell_attr_tuple_info(*(py_ntrg->state->attr_map),
                                                                                          py_ntrg->state->attr_names);
                         Py_INCREF(py_ntrg->state->tuple_index_info);
                       }
@@ -7928,17 +10626,10 @@ extern "C"
         }
       case seq_empty:
         {
-          py_ntrg->state->attr_map.clear();
+          py_ntrg->state->attr_map = std::make_shared<ColumnarAttrMap>();
           if (py_ntrg->state->seq_index == py_ntrg->state->max_local_count)
             {
-              int status = MPI_Barrier(py_ntrg->state->comm);
-              throw_assert(status == MPI_SUCCESS, "NeuroH5CellAttrGen: MPI_Barrier error");
-
-              status = MPI_Comm_free(&(py_ntrg->state->comm));
-              throw_assert(status == MPI_SUCCESS,
-                           "NeuroH5CellAttrGen: unable to free MPI communicator");
-              py_ntrg->state->comm = MPI_COMM_NULL;
-
+              neuroh5_cell_attr_gen_close_state(py_ntrg->state);
               py_ntrg->state->pos = seq_last;
             }
           else
@@ -7972,73 +10663,42 @@ extern "C"
   
   static int neuroh5_prj_gen_next_block(PyNeuroH5ProjectionGenState *py_ngg)
   {
-    int status = 0;
-    int size, rank;
-
-    throw_assert(MPI_Comm_size(py_ngg->state->comm, &size) == MPI_SUCCESS,
-                 "NeuroH5ProjectionGen: invalid MPI communicator");
-    throw_assert(MPI_Comm_rank(py_ngg->state->comm, &rank) == MPI_SUCCESS,
-                 "NeuroH5ProjectionGen: invalid MPI communicator");
-    
     if (!(py_ngg->state->block_index < py_ngg->state->block_count))
       return 0;
 
-    // If the end of the current edge map has been reached,
-    // read the next block
-    py_ngg->state->edge_map.clear();
-
-    vector < map <string, vector < vector<string> > > > edge_attr_name_vector;
-    vector <edge_map_t> prj_vector;
-
-    status = MPI_Barrier(py_ngg->state->comm);
-    
-    status = graph::scatter_read_projection(py_ngg->state->comm,
-                                            py_ngg->state->io_size,
-                                            py_ngg->state->edge_map_type,
-                                            py_ngg->state->file_name,
-                                            py_ngg->state->src_pop_name,
-                                            py_ngg->state->dst_pop_name,
-                                            py_ngg->state->src_start,
-                                            py_ngg->state->dst_start,
-                                            py_ngg->state->edge_attr_name_spaces,
-                                            py_ngg->state->node_rank_map,
-                                            py_ngg->state->pop_search_ranges,
-                                            py_ngg->state->pop_pairs,
-                                            prj_vector,
-                                            edge_attr_name_vector,
-                                            py_ngg->state->local_num_nodes,
-                                            py_ngg->state->local_num_edges,
-                                            py_ngg->state->total_num_edges,
-                                            py_ngg->state->total_read_blocks,
-                                            py_ngg->state->block_index,
-                                            py_ngg->state->cache_size);
-
-    throw_assert (status >= 0, "NeuroH5ProjectionGen: read_projection error");
-    throw_assert(prj_vector.size() > 0, "NeuroH5ProjectionGen: empty projection");
+    // If the end of the current edge block has been reached,
+    // read the next block; Python arrays that still refer to the
+    // previous block keep it alive through their own reference
+    NeuroH5ProjectionBlock block;
+    if (py_ngg->state->prefetch_read.valid())
+      {
+        wait_prefetch(py_ngg->state->prefetch_read);
+        block = std::move(py_ngg->state->prefetch_block);
+      }
+    else
+      {
+        neuroh5_prj_gen_read_block(py_ngg->state, py_ngg->state->block_index, block);
+      }
 
-    if (edge_attr_name_vector.size() > 0)
+    if (block.edge_attr_name_vector.size() > 0)
       {
-        py_ngg->state->edge_attr_names = edge_attr_name_vector[0];
+        py_ngg->state->edge_attr_names = block.edge_attr_name_vector[0];
       }
     
-    py_ngg->state->edge_map = prj_vector[0];
-    //throw_assert(py_ngg->state->edge_map.size() > 0);
-    py_ngg->state->edge_map_iter = py_ngg->state->edge_map.begin();
+    py_ngg->state->edge_csr = block.edge_csr;
+    py_ngg->state->edge_csr_index = 0;
+    py_ngg->state->local_num_nodes = block.local_num_nodes;
+    py_ngg->state->local_num_edges = block.local_num_edges;
+    py_ngg->state->total_num_edges = block.total_num_edges;
+    py_ngg->state->total_read_blocks = block.total_read_blocks;
     
-    py_ngg->state->block_index += py_ngg->state->total_read_blocks;
-    status = MPI_Barrier(py_ngg->state->comm);
-    throw_assert(status == MPI_SUCCESS, "NeuroH5ProjectionGen: MPI_Barrier error");
-
-    size_t max_local_num_nodes=0;
-    status = MPI_Allreduce(&(py_ngg->state->local_num_nodes), &max_local_num_nodes, 1,
-                           MPI_SIZE_T, MPI_MAX, py_ngg->state->comm);
-    throw_assert(status == MPI_SUCCESS, "NeuroH5ProjectionGen: MPI_Allreduce error");
-    py_ngg->state->node_count += max_local_num_nodes;
+    py_ngg->state->block_index += block.total_read_blocks;
+    py_ngg->state->node_count += block.max_local_num_nodes;
 
-    status = MPI_Barrier(py_ngg->state->comm);
-    throw_assert(status == MPI_SUCCESS, "NeuroH5ProjectionGen: MPI_Barrier error");
+    // read the next block while this one is consumed
+    neuroh5_prj_gen_prefetch(py_ngg->state);
 
-    return status;
+    return 0;
   }
 
   
@@ -8062,7 +10722,7 @@ extern "C"
           throw_assert(MPI_Comm_rank(py_ngg->state->comm, &rank) == MPI_SUCCESS,
                        "NeuroH5ProjectionGen: invalid MPI communicator");
 
-          if ((py_ngg->state->edge_map_iter == py_ngg->state->edge_map.cend()) &&
+          if ((py_ngg->state->edge_csr_index == py_ngg->state->edge_csr->num_nodes()) &&
               (py_ngg->state->node_index == py_ngg->state->node_count))
             {
               if (py_ngg->state->block_index < py_ngg->state->block_count)
@@ -8073,13 +10733,7 @@ extern "C"
                 {
                   if (py_ngg->state->node_index == py_ngg->state->node_count)
                     {
-                      int status = MPI_Barrier(py_ngg->state->comm);
-                      throw_assert(status == MPI_SUCCESS, "NeuroH5ProjectionGen: MPI_Barrier error");
-
-                      status = MPI_Comm_free(&(py_ngg->state->comm));
-                      throw_assert(status == MPI_SUCCESS,
-                                   "NeuroH5ProjectionGen: unable to free MPI communicator");
-
+                      neuroh5_prj_gen_close_state(py_ngg->state);
                       py_ngg->state->pos = seq_last;
                     }
                   else
@@ -8096,18 +10750,20 @@ extern "C"
 
           
 
-          if ((py_ngg->state->edge_map_iter != py_ngg->state->edge_map.cend()))
+          if (py_ngg->state->edge_csr_index < py_ngg->state->edge_csr->num_nodes())
             {
-              const NODE_IDX_T key = py_ngg->state->edge_map_iter->first;
-              PyObject *py_edge = py_build_edge_array_dict_value(key,
-                                                                 py_ngg->state->edge_map_iter->second,
+              const size_t i = py_ngg->state->edge_csr_index;
+              const NODE_IDX_T key = py_ngg->state->edge_csr->keys[i];
+              PyObject *py_edge = py_build_edge_array_dict_value(py_ngg->state->edge_csr, i,
                                                                  py_ngg->state->edge_attr_name_spaces,
                                                                  py_ngg->state->edge_attr_names
                                                                  );
               PyObject *py_key = PyLong_FromLong(key);
               result = PyTuple_Pack(2, py_key, py_edge);
+              Py_DECREF(py_key);
+              Py_DECREF(py_edge);
               
-              py_ngg->state->edge_map_iter = next(py_ngg->state->edge_map_iter);
+              py_ngg->state->edge_csr_index++;
             }
           else
             {
@@ -8118,12 +10774,7 @@ extern "C"
 
           if (py_ngg->state->node_index == py_ngg->state->node_count)
             {
-              int status = MPI_Barrier(py_ngg->state->comm);
-              throw_assert(status == MPI_SUCCESS, "NeuroH5ProjectionGen: MPI_Barrier error");
-
-              status = MPI_Comm_free(&(py_ngg->state->comm));
-              throw_assert(status == MPI_SUCCESS,
-                     "NeuroH5ProjectionGen: unable to free MPI communicator");
+              neuroh5_prj_gen_close_state(py_ngg->state);
               py_ngg->state->pos = seq_last;
             }
           else
@@ -8137,11 +10788,7 @@ extern "C"
         {
           if (py_ngg->state->node_index == py_ngg->state->node_count)
             {
-              int status = MPI_Barrier(py_ngg->state->comm);
-              throw_assert(status == MPI_SUCCESS, "NeuroH5ProjectionGen: MPI_Barrier error");
-
-              status = MPI_Comm_free(&(py_ngg->state->comm));
-              throw_assert(status == MPI_SUCCESS, "NeuroH5ProjectionGen: unable to free MPI communicator");
+              neuroh5_prj_gen_close_state(py_ngg->state);
               py_ngg->state->pos = seq_last;
             }
           else
@@ -8177,6 +10824,53 @@ extern "C"
 
   
   
+  /* close() methods of the generators: release the reader and the
+   * communicator of a generator that is abandoned before it is exhausted.
+   * Collective on the communicator of the generator. They are not run
+   * under the library lock, so that a block read running in the
+   * background can complete. */
+  static PyObject *
+  neuroh5_tree_gen_close(PyNeuroH5TreeGenState *py_ntrg, PyObject *args)
+  {
+    neuroh5_tree_gen_close_state(py_ntrg->state);
+    py_ntrg->state->pos = seq_done;
+    Py_RETURN_NONE;
+  }
+
+  static PyObject *
+  neuroh5_cell_attr_gen_close(PyNeuroH5CellAttrGenState *py_ntrg, PyObject *args)
+  {
+    neuroh5_cell_attr_gen_close_state(py_ntrg->state);
+    py_ntrg->state->pos = seq_done;
+    Py_RETURN_NONE;
+  }
+
+  static PyObject *
+  neuroh5_prj_gen_close(PyNeuroH5ProjectionGenState *py_ngg, PyObject *args)
+  {
+    neuroh5_prj_gen_close_state(py_ngg->state);
+    py_ngg->state->pos = seq_done;
+    Py_RETURN_NONE;
+  }
+
+  static PyMethodDef neuroh5_tree_gen_methods[] = {
+    { "close", (PyCFunction)neuroh5_tree_gen_close, METH_NOARGS,
+      "Releases the file and communicator of the generator; must be called on all ranks." },
+    { NULL, NULL, 0, NULL }
+  };
+
+  static PyMethodDef neuroh5_cell_attr_gen_methods[] = {
+    { "close", (PyCFunction)neuroh5_cell_attr_gen_close, METH_NOARGS,
+      "Releases the file and communicator of the generator; must be called on all ranks." },
+    { NULL, NULL, 0, NULL }
+  };
+
+  static PyMethodDef neuroh5_prj_gen_methods[] = {
+    { "close", (PyCFunction)neuroh5_prj_gen_close, METH_NOARGS,
+      "Releases the communicator of the generator; must be called on all ranks." },
+    { NULL, NULL, 0, NULL }
+  };
+
   // NeuroH5 tree read generator
   PyTypeObject PyNeuroH5TreeGen_Type = {
     PyVarObject_HEAD_INIT(&PyType_Type, 0)
@@ -8206,7 +10900,7 @@ extern "C"
     0,                              /* tp_weaklistoffset */
     PyObject_SelfIter,              /* tp_iter */
     (iternextfunc)neuroh5_tree_gen_next, /* tp_iternext */
-    0,                              /* tp_methods */
+    neuroh5_tree_gen_methods,     /* tp_methods */
     0,                              /* tp_members */
     0,                              /* tp_getset */
     0,                              /* tp_base */
@@ -8249,7 +10943,7 @@ extern "C"
     0,                              /* tp_weaklistoffset */
     PyObject_SelfIter,              /* tp_iter */
     (iternextfunc)neuroh5_cell_attr_gen_next, /* tp_iternext */
-    0,                              /* tp_methods */
+    neuroh5_cell_attr_gen_methods, /* tp_methods */
     0,                              /* tp_members */
     0,                              /* tp_getset */
     0,                              /* tp_base */
@@ -8291,7 +10985,7 @@ extern "C"
     0,                              /* tp_weaklistoffset */
     PyObject_SelfIter,              /* tp_iter */
     (iternextfunc)neuroh5_prj_gen_next, /* tp_iternext */
-    0,                              /* tp_methods */
+    neuroh5_prj_gen_methods,      /* tp_methods */
     0,                              /* tp_members */
     0,                              /* tp_getset */
     0,                              /* tp_base */
@@ -8306,54 +11000,90 @@ extern "C"
 
   
   static PyMethodDef module_methods[] = {
-    { "read_population_ranges", (PyCFunction)py_read_population_ranges, METH_VARARGS | METH_KEYWORDS,
+    { "read_population_ranges", (PyCFunction)py_library_call<py_read_population_ranges>, METH_VARARGS | METH_KEYWORDS,
        read_population_ranges_doc },
-    { "read_population_names", (PyCFunction)py_read_population_names, METH_VARARGS | METH_KEYWORDS,
+    { "read_population_names", (PyCFunction)py_library_call<py_read_population_names>, METH_VARARGS | METH_KEYWORDS,
       read_population_names_doc },
-    { "read_projection_names", (PyCFunction)py_read_projection_names, METH_VARARGS | METH_KEYWORDS,
+    { "compute_node_allocation", (PyCFunction)py_library_call<py_compute_node_allocation>, METH_VARARGS | METH_KEYWORDS,
+      compute_node_allocation_doc },
+    { "open_file_session", (PyCFunction)py_library_call<py_open_file_session>, METH_VARARGS | METH_KEYWORDS,
+      open_file_session_doc },
+    { "close_file_session", (PyCFunction)py_library_call<py_close_file_session>, METH_VARARGS | METH_KEYWORDS,
+      close_file_session_doc },
+    { "enable_stats", (PyCFunction)py_library_call<py_enable_stats>, METH_VARARGS | METH_KEYWORDS,
+      enable_stats_doc },
+    { "reset_stats", (PyCFunction)py_library_call_noargs<py_reset_stats>, METH_NOARGS,
+      reset_stats_doc },
+    { "get_stats", (PyCFunction)py_library_call<py_get_stats>, METH_VARARGS | METH_KEYWORDS,
+      get_stats_doc },
+    { "release_shared", (PyCFunction)py_library_call<py_release_shared>, METH_VARARGS | METH_KEYWORDS,
+      release_shared_doc },
+    { "read_projection_arrays", (PyCFunction)py_library_call<py_read_projection_arrays>, METH_VARARGS | METH_KEYWORDS,
+      read_projection_arrays_doc },
+    { "read_cell_attribute_arrays", (PyCFunction)py_library_call<py_read_cell_attribute_arrays>, METH_VARARGS | METH_KEYWORDS,
+      read_cell_attribute_arrays_doc },
+    { "read_projection_names", (PyCFunction)py_library_call<py_read_projection_names>, METH_VARARGS | METH_KEYWORDS,
       read_projection_names_doc },
-    { "read_graph_info", (PyCFunction)py_read_graph_info, METH_VARARGS | METH_KEYWORDS,
+    { "read_graph_info", (PyCFunction)py_library_call<py_read_graph_info>, METH_VARARGS | METH_KEYWORDS,
       read_graph_info_doc },
-    { "read_trees", (PyCFunction)py_read_trees, METH_VARARGS | METH_KEYWORDS,
+    { "read_trees", (PyCFunction)py_library_call<py_read_trees>, METH_VARARGS | METH_KEYWORDS,
       read_trees_doc },
-    { "read_tree_selection", (PyCFunction)py_read_tree_selection, METH_VARARGS | METH_KEYWORDS,
+    { "read_tree_selection", (PyCFunction)py_library_call<py_read_tree_selection>, METH_VARARGS | METH_KEYWORDS,
       read_tree_selection_doc },
-    { "scatter_read_trees", (PyCFunction)py_scatter_read_trees, METH_VARARGS | METH_KEYWORDS,
+    { "scatter_read_trees", (PyCFunction)py_library_call<py_scatter_read_trees>, METH_VARARGS | METH_KEYWORDS,
       scatter_read_trees_doc },
-    { "scatter_read_tree_selection", (PyCFunction)py_scatter_read_tree_selection, METH_VARARGS | METH_KEYWORDS,
+    { "scatter_read_tree_selection", (PyCFunction)py_library_call<py_scatter_read_tree_selection>, METH_VARARGS | METH_KEYWORDS,
       scatter_read_trees_doc },
-    { "read_cell_attribute_info", (PyCFunction)py_read_cell_attribute_info, METH_VARARGS | METH_KEYWORDS,
+    { "read_cell_attribute_info", (PyCFunction)py_library_call<py_read_cell_attribute_info>, METH_VARARGS | METH_KEYWORDS,
       read_cell_attribute_info_doc },
-    { "read_cell_attribute_selection", (PyCFunction)py_read_cell_attribute_selection, METH_VARARGS | METH_KEYWORDS,
+    { "read_cell_attribute_selection", (PyCFunction)py_library_call<py_read_cell_attribute_selection>, METH_VARARGS | METH_KEYWORDS,
        read_cell_attribute_selection_doc },
-    { "scatter_read_cell_attribute_selection", (PyCFunction)py_scatter_read_cell_attribute_selection, METH_VARARGS | METH_KEYWORDS,
+    { "scatter_read_cell_attribute_selection", (PyCFunction)py_library_call<py_scatter_read_cell_attribute_selection>, METH_VARARGS | METH_KEYWORDS,
        scatter_read_cell_attribute_selection_doc },
-    { "read_cell_attributes", (PyCFunction)py_read_cell_attributes, METH_VARARGS | METH_KEYWORDS,
+    { "read_cell_attributes", (PyCFunction)py_library_call<py_read_cell_attributes>, METH_VARARGS | METH_KEYWORDS,
       read_cell_attributes_doc },
-    { "scatter_read_cell_attributes", (PyCFunction)py_scatter_read_cell_attributes, METH_VARARGS | METH_KEYWORDS,
+    { "scatter_read_cell_attributes", (PyCFunction)py_library_call<py_scatter_read_cell_attributes>, METH_VARARGS | METH_KEYWORDS,
       scatter_read_cell_attributes_doc },
-    { "bcast_cell_attributes", (PyCFunction)py_bcast_cell_attributes, METH_VARARGS | METH_KEYWORDS,
-      "Reads attributes for the given range of cells and broadcasts to all ranks." },
-    { "write_cell_attributes", (PyCFunction)py_write_cell_attributes, METH_VARARGS | METH_KEYWORDS,
+    { "scatter_read_cell_attribute_namespaces", (PyCFunction)py_library_call<py_scatter_read_cell_attribute_namespaces>, METH_VARARGS | METH_KEYWORDS,
+      scatter_read_cell_attribute_namespaces_doc },
+    { "bcast_cell_attributes", (PyCFunction)py_library_call<py_bcast_cell_attributes>, METH_VARARGS | METH_KEYWORDS,
+      "Reads attributes for the given range of cells and broadcasts to all ranks. "
+      "With shared=True, the attributes are held once per node and returned as read-only arrays, "
+      "whose memory is freed by release_shared." },
+    { "write_cell_attributes", (PyCFunction)py_library_call<py_write_cell_attributes>, METH_VARARGS | METH_KEYWORDS,
       "Writes attributes for the given range of cells." },
-    { "append_cell_attributes", (PyCFunction)py_append_cell_attributes, METH_VARARGS | METH_KEYWORDS,
+    { "append_cell_attributes", (PyCFunction)py_library_call<py_append_cell_attributes>, METH_VARARGS | METH_KEYWORDS,
       "Appends additional attributes for the given range of cells." },
-    { "append_cell_trees", (PyCFunction)py_append_cell_trees, METH_VARARGS | METH_KEYWORDS,
+    { "append_cell_attribute_arrays", (PyCFunction)py_library_call<py_append_cell_attribute_arrays>, METH_VARARGS | METH_KEYWORDS,
+      "Appends attributes given as arrays: gids, and a dictionary of attribute names to "
+      "tuples (attr_ptr, values), where attr_ptr has one more element than gids. "
+      "An attribute must have the same type on all ranks; ranks that do not give an "
+      "attribute append no cells to it." },
+    { "append_cell_trees", (PyCFunction)py_library_call<py_append_cell_trees>, METH_VARARGS | METH_KEYWORDS,
       "Appends tree morphologies." },
-    { "read_graph", (PyCFunction)py_read_graph, METH_VARARGS | METH_KEYWORDS,
+    { "read_graph", (PyCFunction)py_library_call<py_read_graph>, METH_VARARGS | METH_KEYWORDS,
       "Reads graph connectivity in Destination Block Sparse format." },
-    { "scatter_read_graph", (PyCFunction)py_scatter_read_graph, METH_VARARGS | METH_KEYWORDS,
+    { "scatter_read_graph", (PyCFunction)py_library_call<py_scatter_read_graph>, METH_VARARGS | METH_KEYWORDS,
       "Reads and scatters graph connectivity in Destination Block Sparse format." },
-    { "bcast_graph", (PyCFunction)py_bcast_graph, METH_VARARGS | METH_KEYWORDS,
-      "Reads and broadcasts graph connectivity in Destination Block Sparse format." },
-    { "read_graph_selection", (PyCFunction)py_read_graph_selection, METH_VARARGS | METH_KEYWORDS,
+    { "bcast_graph", (PyCFunction)py_library_call<py_bcast_graph>, METH_VARARGS | METH_KEYWORDS,
+      "Reads and broadcasts graph connectivity in Destination Block Sparse format. "
+      "With shared=True, each projection is held once per node and returned as read-only arrays, "
+      "whose memory is freed by release_shared." },
+    { "read_graph_selection", (PyCFunction)py_library_call<py_read_graph_selection>, METH_VARARGS | METH_KEYWORDS,
       "Reads subset of graph connectivity in Destination Block Sparse format." },
-    { "scatter_read_graph_selection", (PyCFunction)py_scatter_read_graph_selection, METH_VARARGS | METH_KEYWORDS,
+    { "scatter_read_graph_selection", (PyCFunction)py_library_call<py_scatter_read_graph_selection>, METH_VARARGS | METH_KEYWORDS,
       "Reads subset of graph connectivity in Destination Block Sparse format." },
-    { "write_graph", (PyCFunction)py_write_graph, METH_VARARGS | METH_KEYWORDS,
+    { "write_graph", (PyCFunction)py_library_call<py_write_graph>, METH_VARARGS | METH_KEYWORDS,
       "Writes graph connectivity in Destination Block Sparse format." },
-    { "append_graph", (PyCFunction)py_append_graph, METH_VARARGS | METH_KEYWORDS,
+    { "append_graph", (PyCFunction)py_library_call<py_append_graph>, METH_VARARGS | METH_KEYWORDS,
       "Appends graph connectivity in Destination Block Sparse format." },
+    { "write_graph_arrays", (PyCFunction)py_library_call<py_write_graph_arrays>, METH_VARARGS | METH_KEYWORDS,
+      "Writes a projection given as arrays: dst_gids, dst_ptr (offsets into src_gids, "
+      "one more element than dst_gids), src_gids, and edge_attrs, a dictionary of "
+      "namespaces to dictionaries of attribute names to arrays with one value per edge. "
+      "Ranks without edges may omit edge_attrs." },
+    { "append_graph_arrays", (PyCFunction)py_library_call<py_append_graph_arrays>, METH_VARARGS | METH_KEYWORDS,
+      "Appends a projection given as arrays, with the arguments of write_graph_arrays." },
     { NULL, NULL, 0, NULL }
   };
 }
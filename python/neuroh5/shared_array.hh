@@ -29,6 +29,7 @@ template<> struct NumpyTypeMap<int8_t> { static constexpr int type_num = NPY_INT
 template<> struct NumpyTypeMap<uint32_t> { static constexpr int type_num = NPY_UINT32; };
 template<> struct NumpyTypeMap<uint16_t> { static constexpr int type_num = NPY_UINT16; };
 template<> struct NumpyTypeMap<uint8_t> { static constexpr int type_num = NPY_UINT8; };
+template<> struct NumpyTypeMap<uint64_t> { static constexpr int type_num = NPY_UINT64; };
 
 // Structure to hold type information
 struct TypeInfo {
@@ -375,5 +376,67 @@ static PyObject* create_shared_array_from_vector(const std::vector<T>& vec)
     return array;
 }
 
-#endif
 
+// Holder that keeps the owner of a buffer alive for as long as a NumPy
+// array refers to it
+template<typename Owner>
+struct SharedOwnerHolder {
+  std::shared_ptr<Owner> owner;
+  explicit SharedOwnerHolder(const std::shared_ptr<Owner>& p) : owner(p) {}
+};
+
+template<typename Owner>
+static void shared_owner_dealloc(PyObject* capsule) {
+    auto* holder = static_cast<SharedOwnerHolder<Owner>*>(
+        PyCapsule_GetPointer(capsule, "array_owner")
+    );
+    delete holder;
+}
+
+// Function to create a numpy array that views n elements of a buffer
+// owned by another object, without copying
+template<typename T, typename Owner>
+static PyObject* create_shared_array_view(const std::shared_ptr<Owner>& owner,
+                                          const T* ptr, size_t n)
+{
+    auto holder = new SharedOwnerHolder<Owner>(owner);
+
+    npy_intp dims[1] = {static_cast<npy_intp>(n)};
+
+    PyObject* capsule = PyCapsule_New(
+        holder,
+        "array_owner",
+        shared_owner_dealloc<Owner>
+    );
+
+    if (!capsule) {
+        delete holder;
+        return nullptr;
+    }
+
+    PyObject* array = PyArray_NewFromDescr(
+        &PyArray_Type,
+        PyArray_DescrFromType(NumpyTypeMap<T>::type_num),
+        1,
+        dims,
+        nullptr,
+        const_cast<T*>(ptr),
+        NPY_ARRAY_WRITEABLE,
+        nullptr
+    );
+
+    if (!array) {
+        Py_DECREF(capsule);
+        return nullptr;
+    }
+
+    if (PyArray_SetBaseObject((PyArrayObject*)array, capsule) < 0) {
+        Py_DECREF(capsule);
+        Py_DECREF(array);
+        return nullptr;
+    }
+
+    return array;
+}
+
+#endif
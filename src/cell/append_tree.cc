@@ -30,6 +30,7 @@
 #include "create_file_toplevel.hh"
 #include "compact_optional.hh"
 #include "optional_value.hh"
+#include "phase_stats.hh"
 #include "throw_assert.hh"
 
 
@@ -289,9 +290,12 @@ namespace neuroh5
      const set<size_t>              &io_rank_set,
      CellPtr                        ptr_type,
      const size_t                   chunk_size,
-     const size_t                   value_chunk_size
+     const size_t                   value_chunk_size,
+     const hdf5::DatasetCreationPolicy& dataset_policy
      )
     {
+      mpi::PhaseTimer timer("append_trees");
+
       herr_t status=0; 
       size_t io_size=0;
 
@@ -351,13 +355,20 @@ namespace neuroh5
                    tree_map.insert(make_pair(gid, tree));
                  });
           
-        data::serialize_rank_tree_map (size, rank, rank_tree_map, sendcounts, sendbuf, sdispls);
+        {
+          mpi::PhaseTimer timer("serialize_trees");
+          data::serialize_rank_tree_map (size, rank, rank_tree_map, sendcounts, sendbuf, sdispls);
+        }
         
-        throw_assert_nomsg(mpi::alltoallv_vector<char>(comm, MPI_CHAR, sendcounts, sdispls, sendbuf,
-                                                       recvcounts, rdispls, recvbuf) >= 0);
+        {
+          mpi::PhaseTimer timer("alltoallv");
+          throw_assert_nomsg(mpi::alltoallv_vector<char>(comm, MPI_CHAR, sendcounts, sdispls, sendbuf,
+                                                         recvcounts, rdispls, recvbuf) >= 0);
+        }
         sendbuf.clear();
         sendbuf.shrink_to_fit();
         
+        mpi::PhaseTimer timer("deserialize_trees");
         data::deserialize_rank_tree_list (size, recvbuf, recvcounts, rdispls,
                                           local_tree_list);
       }
@@ -377,6 +388,7 @@ namespace neuroh5
 
       if (is_io_rank)
         {
+          mpi::PhaseTimer timer("build_tree_datasets");
           if (ptr_type.type == PtrNone)
             {
               status = build_singleton_tree_datasets(io_comm,
@@ -417,67 +429,45 @@ namespace neuroh5
 
       if (is_io_rank)
         {
+          mpi::PhaseTimer timer("append_tree_datasets");
 
           hid_t file = H5Iget_file_id(loc);
           throw_assert(file >= 0,
                        "append_trees: invalid file handle");
           
           append_cell_index (io_comm, file, pop_name, pop_start,
-                             hdf5::TREES, all_index_vector);
+                             hdf5::TREES, all_index_vector,
+                             chunk_size, dataset_policy);
           
-          append_cell_attribute (file, hdf5::TREES, pop_name, pop_start, hdf5::X_COORD,
-                                 all_index_vector, attr_ptr, all_xcoords,
-                                 coord_data_type, IndexShared,
-                                 CellPtr (PtrOwner, hdf5::ATTR_PTR),
-                                 chunk_size, value_chunk_size);
-          append_cell_attribute (file, hdf5::TREES, pop_name, pop_start, hdf5::Y_COORD,
-                                 all_index_vector, attr_ptr, all_ycoords,
-                                 coord_data_type, IndexShared,
-                                 CellPtr (PtrShared, attr_ptr_owner_path),
-                                 chunk_size, value_chunk_size);
-          append_cell_attribute (file, hdf5::TREES, pop_name, pop_start, hdf5::Z_COORD,
-                                 all_index_vector, attr_ptr, all_zcoords,
-                                 coord_data_type, IndexShared,
-                                 CellPtr (PtrShared, attr_ptr_owner_path),
-                                 chunk_size, value_chunk_size);
-          append_cell_attribute (file, hdf5::TREES, pop_name, pop_start, hdf5::RADIUS,
-                                 all_index_vector, attr_ptr, all_radiuses,
-                                 dflt_data_type, IndexShared,
-                                 CellPtr (PtrShared, attr_ptr_owner_path),
-                                 chunk_size, value_chunk_size);
-          append_cell_attribute (file, hdf5::TREES, pop_name, pop_start, hdf5::LAYER,
-                                 all_index_vector, attr_ptr, all_layers,
-                                 layer_data_type, IndexShared,
-                                 CellPtr (PtrShared, attr_ptr_owner_path),
-                                 chunk_size, value_chunk_size);
-          append_cell_attribute (file, hdf5::TREES, pop_name, pop_start, hdf5::PARENT,
-                                 all_index_vector, attr_ptr, all_parents,
-                                 parent_node_data_type, IndexShared,
-                                 CellPtr (PtrShared, attr_ptr_owner_path),
-                                 chunk_size, value_chunk_size);
-          
-          append_cell_attribute (file, hdf5::TREES, pop_name, pop_start, hdf5::SWCTYPE,
-                                 all_index_vector, attr_ptr, all_swc_types,
-                                 swc_data_type, IndexShared,
-                                 CellPtr (PtrShared, attr_ptr_owner_path),
-                                 chunk_size, value_chunk_size);
-          append_cell_attribute (file, hdf5::TREES, pop_name, pop_start, hdf5::SRCSEC,
-                                 all_index_vector, topo_ptr, all_src_vector,
-                                 section_data_type, IndexShared,
-                                 CellPtr (PtrOwner, hdf5::SEC_PTR),
-                                 chunk_size, value_chunk_size);
-          append_cell_attribute (file, hdf5::TREES, pop_name, pop_start, hdf5::DSTSEC,
-                                 all_index_vector, topo_ptr, all_dst_vector,
-                                 section_data_type, IndexShared,
-                                 CellPtr (PtrShared, sec_ptr_owner_path),
-                                 chunk_size, value_chunk_size);
-          
-          append_cell_attribute (file, hdf5::TREES, pop_name, pop_start, hdf5::SECTION,
-                                 all_index_vector, sec_ptr, all_sections,
-                                 section_data_type, IndexShared,
-                                 CellPtr (PtrOwner, hdf5::SEC_PTR),
-                                 chunk_size, value_chunk_size);
-
+          const CellPtr attr_ptr_shared (PtrShared, attr_ptr_owner_path);
+          const CellPtr sec_ptr_shared (PtrShared, sec_ptr_owner_path);
+          vector<hdf5::CellAttributeAppend> attrs =
+            {
+              hdf5::cell_attribute_append(hdf5::X_COORD, all_index_vector, attr_ptr, all_xcoords,
+                                          coord_data_type, IndexShared, CellPtr (PtrOwner, hdf5::ATTR_PTR)),
+              hdf5::cell_attribute_append(hdf5::Y_COORD, all_index_vector, attr_ptr, all_ycoords,
+                                          coord_data_type, IndexShared, attr_ptr_shared),
+              hdf5::cell_attribute_append(hdf5::Z_COORD, all_index_vector, attr_ptr, all_zcoords,
+                                          coord_data_type, IndexShared, attr_ptr_shared),
+              hdf5::cell_attribute_append(hdf5::RADIUS, all_index_vector, attr_ptr, all_radiuses,
+                                          dflt_data_type, IndexShared, attr_ptr_shared),
+              hdf5::cell_attribute_append(hdf5::LAYER, all_index_vector, attr_ptr, all_layers,
+                                          layer_data_type, IndexShared, attr_ptr_shared),
+              hdf5::cell_attribute_append(hdf5::PARENT, all_index_vector, attr_ptr, all_parents,
+                                          parent_node_data_type, IndexShared, attr_ptr_shared),
+              hdf5::cell_attribute_append(hdf5::SWCTYPE, all_index_vector, attr_ptr, all_swc_types,
+                                          swc_data_type, IndexShared, attr_ptr_shared),
+              hdf5::cell_attribute_append(hdf5::SRCSEC, all_index_vector, topo_ptr, all_src_vector,
+                                          section_data_type, IndexShared, CellPtr (PtrOwner, hdf5::SEC_PTR)),
+              hdf5::cell_attribute_append(hdf5::DSTSEC, all_index_vector, topo_ptr, all_dst_vector,
+                                          section_data_type, IndexShared, sec_ptr_shared),
+              hdf5::cell_attribute_append(hdf5::SECTION, all_index_vector, sec_ptr, all_sections,
+                                          section_data_type, IndexShared, CellPtr (PtrOwner, hdf5::SEC_PTR))
+            };
+          // the pointers and values of all tree attributes are written
+          // with one fused append
+          append_cell_attributes (io_comm, file, hdf5::TREES, pop_name, pop_start, attrs,
+                                  chunk_size, value_chunk_size, dataset_policy);
 
           status = H5Fclose(file);
           throw_assert(status == 0, "append_trees: unable to close HDF5 file");
@@ -499,7 +489,8 @@ namespace neuroh5
      std::forward_list<neurotree_t> &tree_list,
      size_t                         io_size,
      const size_t                   chunk_size,
-     const size_t                   value_chunk_size
+     const size_t                   value_chunk_size,
+     const hdf5::DatasetCreationPolicy& dataset_policy
      )
     {
       herr_t status;
@@ -554,7 +545,8 @@ namespace neuroh5
         }
       
       status = append_trees(comm, io_comm, file, pop_name, pop_start, tree_list,
-                            io_rank_set,  CellPtr(PtrOwner), chunk_size, value_chunk_size);
+                            io_rank_set,  CellPtr(PtrOwner), chunk_size, value_chunk_size,
+                            dataset_policy);
       throw_assert_nomsg(status >= 0);
 
       if (is_io_rank)
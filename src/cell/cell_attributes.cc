@@ -12,20 +12,26 @@
 #include "read_template.hh"
 #include "write_template.hh"
 #include "file_access.hh"
+#include "file_session.hh"
 #include "cell_attributes.hh"
 #include "hdf5_cell_attributes.hh"
 #include "create_file_toplevel.hh"
 #include "exists_dataset.hh"
 #include "dataset_num_elements.hh"
 #include "create_group.hh"
+#include "dataset_creation.hh"
 #include "append_rank_attr_map.hh"
 #include "attr_map.hh"
+#include "columnar_attr_map.hh"
 #include "infer_datatype.hh"
 #include "attr_kind_datatype.hh"
 #include "alltoallv_template.hh"
 #include "serialize_data.hh"
 #include "serialize_cell_attributes.hh"
+#include "phase_stats.hh"
 #include "range_sample.hh"
+#include "io_rank_set.hh"
+#include "shared_segment.hh"
 #include "mpe_seq.hh"
 #include "debug.hh"
 #include "throw_assert.hh"
@@ -34,6 +40,8 @@
 #include <mpi.h>
 
 #include <cstdint>
+#include <deque>
+#include <memory>
 #include <unistd.h>
 #include <string>
 #include <type_traits>
@@ -91,6 +99,224 @@ namespace neuroh5
       index_size = hdf5::dataset_num_elements(loc, path + "/" + hdf5::CELL_INDEX);
       value_size = hdf5::dataset_num_elements(loc, path + "/" + hdf5::ATTR_VAL);
     }
+
+    void append_cell_attributes
+    (
+     MPI_Comm                        comm,
+     const hid_t&                    loc,
+     const string&                   attr_namespace,
+     const string&                   pop_name,
+     const vector<CellAttributeAppend>& attrs
+     )
+    {
+      mpi::PhaseTimer timer("append_cell_attributes");
+
+      int ssize, srank;
+      throw_assert(MPI_Comm_size(comm, &ssize) == MPI_SUCCESS, "error in MPI_Comm_size");
+      throw_assert(MPI_Comm_rank(comm, &srank) == MPI_SUCCESS, "error in MPI_Comm_rank");
+      const size_t size = ssize, rank = srank;
+      const size_t num_attrs = attrs.size();
+
+      // index, pointer and value sizes of all attributes on all ranks
+      const size_t num_sizes = 3;
+      vector<uint64_t> local_sizes(num_sizes * num_attrs, 0);
+      for (size_t k = 0; k < num_attrs; k++)
+        {
+          const CellAttributeAppend& attr = attrs[k];
+          throw_assert(attr.attr_ptr->empty() || (attr.index->size() == attr.attr_ptr->size()-1),
+                       "append_cell_attributes: mismatch of sizes of cell index and attribute pointer "
+                       "of attribute " << attr.attr_name);
+          local_sizes[num_sizes*k]   = attr.index->size();
+          local_sizes[num_sizes*k+1] = attr.attr_ptr->size();
+          local_sizes[num_sizes*k+2] = attr.num_values;
+        }
+      vector<uint64_t> all_sizes(size * local_sizes.size(), 0);
+      {
+        mpi::PhaseTimer timer("allgather_sizes");
+        throw_assert(MPI_Allgather(local_sizes.data(), local_sizes.size(), MPI_UINT64_T,
+                                   all_sizes.data(), local_sizes.size(), MPI_UINT64_T,
+                                   comm) == MPI_SUCCESS,
+                     "append_cell_attributes: error in MPI_Allgather");
+      }
+
+      // one write per dataset, in the order of attrs
+      struct DatasetWrite
+      {
+        string             path;
+        hsize_t            newsize, start, len;
+        hid_t              mtype;
+        const void*        buf;
+        size_t             elem_size;
+      };
+      vector<DatasetWrite> writes;
+      deque< vector<ATTR_PTR_T> > local_attr_ptrs;
+      vector<hid_t> value_mtypes;
+
+      for (size_t k = 0; k < num_attrs; k++)
+        {
+          const CellAttributeAppend& attr = attrs[k];
+          const string path = cell_attribute_path(attr_namespace, pop_name, attr.attr_name);
+
+          // the last rank with data also writes the final pointer
+          size_t last_rank = size-1;
+          for (size_t r = size; r > 0; r--)
+            {
+              if (all_sizes[(r-1) * local_sizes.size() + num_sizes*k] > 0)
+                {
+                  last_rank = r-1;
+                  break;
+                }
+            }
+          vector<uint64_t> index_sizes(size), ptr_sizes(size), value_sizes(size);
+          for (size_t r = 0; r < size; r++)
+            {
+              const uint64_t* r_sizes = &all_sizes[r * local_sizes.size() + num_sizes*k];
+              index_sizes[r] = r_sizes[0];
+              ptr_sizes[r]   = (r_sizes[1] > 0) ? ((r == last_rank) ? r_sizes[1] : r_sizes[1]-1) : 0;
+              value_sizes[r] = r_sizes[2];
+            }
+
+          hsize_t ptr_size=0, index_size=0, value_size=0;
+          size_cell_attributes(comm, loc, path, attr.ptr_type, ptr_size, index_size, value_size);
+
+          hsize_t ptr_start = (ptr_size > 0) ? ptr_size-1 : 0;
+          hsize_t local_index_start=index_size, local_value_start=value_size, local_ptr_start=ptr_start;
+          hsize_t global_index_size=index_size, global_value_size=value_size, global_ptr_size=ptr_start;
+          for (size_t r = 0; r < size; r++)
+            {
+              if (r < rank)
+                {
+                  local_index_start += index_sizes[r];
+                  local_value_start += value_sizes[r];
+                  local_ptr_start   += ptr_sizes[r];
+                }
+              global_index_size += index_sizes[r];
+              global_value_size += value_sizes[r];
+              global_ptr_size   += ptr_sizes[r];
+            }
+
+          // add local value offset to attr_ptr
+          local_attr_ptrs.emplace_back(ptr_sizes[rank], 0);
+          vector<ATTR_PTR_T>& local_attr_ptr = local_attr_ptrs.back();
+          for (size_t i = 0; i < local_attr_ptr.size(); i++)
+            {
+              local_attr_ptr[i] = (*attr.attr_ptr)[i] + local_value_start;
+              throw_assert(local_attr_ptr[i] <= global_value_size,
+                           "append_cell_attributes: path " << path <<
+                           ": attribute pointer value " << local_attr_ptr[i] <<
+                           " exceeds global value size " << global_value_size);
+            }
+
+          if (attr.index_type == IndexOwner)
+            {
+              writes.push_back({ path + "/" + CELL_INDEX, global_index_size,
+                                 local_index_start, index_sizes[rank],
+                                 CELL_IDX_H5_NATIVE_T, attr.index->data(), sizeof(CELL_IDX_T) });
+            }
+          if (attr.ptr_type.type == PtrOwner)
+            {
+              string ptr_name = attr.ptr_type.shared_ptr_name.has_value() ?
+                attr.ptr_type.shared_ptr_name.value() : string(ATTR_PTR);
+              writes.push_back({ path + "/" + ptr_name, global_ptr_size,
+                                 local_ptr_start, ptr_sizes[rank],
+                                 ATTR_PTR_H5_NATIVE_T, local_attr_ptr.data(), sizeof(ATTR_PTR_T) });
+            }
+          if (global_value_size > 0)
+            {
+              hid_t mtype = H5Tget_native_type(attr.ftype, H5T_DIR_ASCEND);
+              throw_assert(mtype >= 0, "append_cell_attributes: unable to obtain native HDF5 datatype");
+              value_mtypes.push_back(mtype);
+              writes.push_back({ path + "/" + ATTR_VAL, global_value_size,
+                                 local_value_start, attr.num_values,
+                                 mtype, attr.values, attr.value_size });
+            }
+        }
+
+      // extend all datasets and select the part of this rank
+      const size_t num_writes = writes.size();
+      vector<hid_t> dsets(num_writes), mtypes(num_writes), mspaces(num_writes), fspaces(num_writes);
+      vector<const void*> bufs(num_writes);
+      static const char empty_buf = 0;
+      {
+        mpi::PhaseTimer timer("extend_datasets");
+        for (size_t i = 0; i < num_writes; i++)
+          {
+            const DatasetWrite& w = writes[i];
+            dsets[i] = H5Dopen2(loc, w.path.c_str(), H5P_DEFAULT);
+            throw_assert(dsets[i] >= 0, "append_cell_attributes: unable to open dataset " << w.path);
+            if (w.newsize > 0)
+              {
+                throw_assert(H5Dset_extent(dsets[i], &w.newsize) >= 0,
+                             "append_cell_attributes: unable to set extent on dataset "
+                             << w.path << " to " << w.newsize);
+              }
+            fspaces[i] = H5Dget_space(dsets[i]);
+            throw_assert(fspaces[i] >= 0, "append_cell_attributes: error in H5Dget_space");
+            mspaces[i] = H5Screate_simple(1, &w.len, NULL);
+            throw_assert(mspaces[i] >= 0, "append_cell_attributes: error in H5Screate_simple");
+            if (w.len > 0)
+              {
+                hsize_t one = 1;
+                throw_assert(H5Sselect_hyperslab(fspaces[i], H5S_SELECT_SET, &w.start, NULL,
+                                                 &one, &w.len) >= 0,
+                             "append_cell_attributes: unable to select hyperslab "
+                             << w.start << ":" << w.len << " from dataset " << w.path);
+              }
+            else
+              {
+                throw_assert(H5Sselect_none(fspaces[i]) >= 0,
+                             "append_cell_attributes: error in H5Sselect_none");
+                throw_assert(H5Sselect_none(mspaces[i]) >= 0,
+                             "append_cell_attributes: error in H5Sselect_none");
+              }
+            mtypes[i] = w.mtype;
+            bufs[i] = (w.len > 0) ? w.buf : &empty_buf;
+          }
+      }
+
+      /* Create property list for collective dataset write. */
+      hid_t wapl = H5Pcreate (H5P_DATASET_XFER);
+      throw_assert(H5Pset_dxpl_mpio (wapl, H5FD_MPIO_COLLECTIVE) >= 0,
+                   "append_cell_attributes: error in H5Pset_dxpl_mpio");
+
+      {
+        mpi::PhaseTimer timer("write_datasets");
+#if H5_VERSION_GE(1,14,0)
+        if (num_writes > 0)
+          {
+            throw_assert(H5Dwrite_multi(num_writes, dsets.data(), mtypes.data(), mspaces.data(),
+                                        fspaces.data(), wapl, bufs.data()) >= 0,
+                         "append_cell_attributes: error in H5Dwrite_multi");
+          }
+#else
+        for (size_t i = 0; i < num_writes; i++)
+          {
+            throw_assert(H5Dwrite(dsets[i], mtypes[i], mspaces[i], fspaces[i], wapl, bufs[i]) >= 0,
+                         "append_cell_attributes: error in H5Dwrite on dataset " << writes[i].path
+                         << " start: " << writes[i].start << " length: " << writes[i].len);
+          }
+#endif
+        for (const DatasetWrite& w : writes)
+          {
+            mpi::count_write(w.len * w.elem_size);
+          }
+      }
+
+      for (size_t i = 0; i < num_writes; i++)
+        {
+          throw_assert(H5Sclose(mspaces[i]) >= 0, "error in H5Sclose");
+          throw_assert(H5Sclose(fspaces[i]) >= 0, "error in H5Sclose");
+          throw_assert(H5Dclose(dsets[i]) >= 0, "error in H5Dclose");
+        }
+      for (hid_t mtype : value_mtypes)
+        {
+          throw_assert(H5Tclose(mtype) >= 0, "error in H5Tclose");
+        }
+      throw_assert(H5Pclose(wapl) == 0, "error in H5Pclose");
+
+      throw_assert(MPI_Barrier(comm) == MPI_SUCCESS,
+                   "append_cell_attributes: error in MPI_Barrier");
+    }
   }
   
   namespace cell
@@ -120,7 +346,14 @@ namespace neuroh5
       hid_t in_file;
       herr_t ierr;
     
-      in_file = H5Fopen(file_name.c_str(), H5F_ACC_RDONLY, H5P_DEFAULT);
+      hdf5::FileSession* session = hdf5::FileSession::find(file_name);
+      const string metadata_key = "cell_attribute_name_spaces/" + pop_name;
+      if ((session != nullptr) && session->find_metadata(metadata_key, out_name_spaces))
+        {
+          return 0;
+        }
+
+      in_file = hdf5::open_file(MPI_COMM_SELF, file_name);
       throw_assert(in_file >= 0,
                    "get_cell_attribute_name_spaces: unable to open file " << file_name);
       out_name_spaces.clear();
@@ -141,7 +374,12 @@ namespace neuroh5
                        "get_cell_attribute_name_spaces: unable to close group " << path);
         }
 
-      ierr = H5Fclose(in_file);
+      ierr = hdf5::close_file(in_file);
+
+      if (session != nullptr)
+        {
+          session->insert_metadata(metadata_key, out_name_spaces);
+        }
     
       return ierr;
     }
@@ -324,7 +562,14 @@ namespace neuroh5
       hid_t in_file;
       herr_t ierr;
     
-      in_file = H5Fopen(file_name.c_str(), H5F_ACC_RDONLY, H5P_DEFAULT);
+      hdf5::FileSession* session = hdf5::FileSession::find(file_name);
+      const string metadata_key = "cell_attributes/" + name_space + "/" + pop_name;
+      if ((session != nullptr) && session->find_metadata(metadata_key, out_attributes))
+        {
+          return 0;
+        }
+
+      in_file = hdf5::open_file(MPI_COMM_SELF, file_name);
       throw_assert(in_file >= 0, "get_cell_attributes unable to open file " << file_name);
       out_attributes.clear();
     
@@ -345,7 +590,12 @@ namespace neuroh5
           throw_assert(ierr >= 0,
                        "get_cell_attributes: unable to close group " << path);
         }
-      ierr = H5Fclose(in_file);
+      ierr = hdf5::close_file(in_file);
+
+      if (session != nullptr)
+        {
+          session->insert_metadata(metadata_key, out_attributes);
+        }
 
       return ierr;
     }
@@ -412,7 +662,15 @@ namespace neuroh5
       hid_t in_file;
       herr_t ierr;
     
-      in_file = H5Fopen(file_name.c_str(), H5F_ACC_RDONLY, H5P_DEFAULT);
+      hdf5::FileSession* session = hdf5::FileSession::find(file_name);
+      const string metadata_key = "cell_attribute_index_ptr/" + name_space + "/" + pop_name +
+        "/" + std::to_string(pop_start);
+      if ((session != nullptr) && session->find_metadata(metadata_key, out_attributes))
+        {
+          return 0;
+        }
+
+      in_file = hdf5::open_file(MPI_COMM_SELF, file_name);
       throw_assert(in_file >= 0, "get_call_attributes_index_ptr: unable to open file " << file_name);
       out_attributes.clear();
     
@@ -444,9 +702,118 @@ namespace neuroh5
                        "get_cell_attribute_index_ptr: unable to close group " << path);
         }
       
-      ierr = H5Fclose(in_file);
+      ierr = hdf5::close_file(in_file);
+
+      if (session != nullptr)
+        {
+          session->insert_metadata(metadata_key, out_attributes);
+        }
       return ierr;
     }
+
+
+    shared_ptr<const data::CellAttributeIndex> get_cell_attribute_sorted_index
+    (
+     MPI_Comm                      comm,
+     const string&                 file_name,
+     const string&                 name_space,
+     const string&                 pop_name,
+     const CELL_IDX_T&             pop_start
+     )
+    {
+      unsigned int rank;
+      throw_assert_nomsg(MPI_Comm_rank(comm, (int*)&rank) == MPI_SUCCESS);
+
+      hdf5::FileSession* session = hdf5::FileSession::find(comm, file_name);
+      if ((session != nullptr) && !session->caches_metadata())
+        {
+          session = nullptr;
+        }
+      if (session != nullptr)
+        {
+          shared_ptr<const data::CellAttributeIndex> cached =
+            session->cell_index_cache().find(name_space, pop_name, pop_start);
+          if (cached)
+            {
+              return cached;
+            }
+        }
+
+      // attribute names and types, the position of the index of each
+      // attribute, and the distinct indices and pointers
+      vector< pair<string,AttrKind> > attributes;
+      vector<size_t> attr_index_pos;
+      vector< pair< vector<CELL_IDX_T>, vector<ATTR_PTR_T> > > index_ptrs;
+
+      if (rank == 0)
+        {
+          vector< tuple<string,AttrKind,vector<CELL_IDX_T>,vector<ATTR_PTR_T> > > attr_info;
+          throw_assert(get_cell_attribute_index_ptr (file_name, name_space, pop_name, pop_start, attr_info) == 0,
+                       "get_cell_attribute_sorted_index: error in get_cell_attribute_index_ptr");
+
+          for (auto& info : attr_info)
+            {
+              vector<CELL_IDX_T>& index = get<2>(info);
+              vector<ATTR_PTR_T>& ptr = get<3>(info);
+              size_t pos = 0;
+              while ((pos < index_ptrs.size()) &&
+                     !((index_ptrs[pos].first == index) && (index_ptrs[pos].second == ptr)))
+                {
+                  pos++;
+                }
+              if (pos == index_ptrs.size())
+                {
+                  index_ptrs.push_back(make_pair(std::move(index), std::move(ptr)));
+                }
+              attributes.push_back(make_pair(get<0>(info), get<1>(info)));
+              attr_index_pos.push_back(pos);
+            }
+        }
+
+      {
+        vector<char> sendbuf; size_t sendbuf_size=0;
+        if (rank == 0)
+          {
+            data::serialize_data(make_tuple(attributes, attr_index_pos, index_ptrs), sendbuf);
+            sendbuf_size = sendbuf.size();
+          }
+
+        throw_assert(MPI_Bcast(&sendbuf_size, 1, MPI_SIZE_T, 0, comm) == MPI_SUCCESS,
+                     "get_cell_attribute_sorted_index: error in MPI_Bcast");
+        sendbuf.resize(sendbuf_size);
+        throw_assert(MPI_Bcast(&sendbuf[0], sendbuf_size, MPI_CHAR, 0, comm) == MPI_SUCCESS,
+                     "get_cell_attribute_sorted_index: error in MPI_Bcast");
+        
+        if (rank != 0)
+          {
+            auto info = make_tuple(attributes, attr_index_pos, index_ptrs);
+            data::deserialize_data(sendbuf, info);
+            attributes = std::move(get<0>(info));
+            attr_index_pos = std::move(get<1>(info));
+            index_ptrs = std::move(get<2>(info));
+          }
+      }
+
+      vector< shared_ptr<const data::SortedCellIndex> > sorted_indices;
+      for (const auto& index_ptr : index_ptrs)
+        {
+          sorted_indices.push_back(make_shared<data::SortedCellIndex>(index_ptr.first, index_ptr.second));
+        }
+
+      shared_ptr<data::CellAttributeIndex> result = make_shared<data::CellAttributeIndex>();
+      result->attributes = attributes;
+      for (size_t pos : attr_index_pos)
+        {
+          result->indices.push_back(sorted_indices[pos]);
+        }
+
+      if (session != nullptr)
+        {
+          session->cell_index_cache().insert(name_space, pop_name, pop_start, result);
+        }
+
+      return result;
+    }
     
 
     herr_t num_cell_attributes
@@ -534,46 +901,31 @@ namespace neuroh5
      const CellIndex& index_type,
      const CellPtr&   ptr_type,
      const size_t     chunk_size,
-     const size_t     value_chunk_size
+     const size_t     value_chunk_size,
+     const hdf5::DatasetCreationPolicy& dataset_policy
      )
     {
       herr_t status;
       hsize_t maxdims[1] = {H5S_UNLIMITED};
-      hsize_t cdims[1]   = {chunk_size}; /* chunking dimensions */		
       hsize_t initial_size = 0;
     
-      hid_t plist  = H5Pcreate (H5P_DATASET_CREATE);
-      status = H5Pset_layout(plist, H5D_CHUNKED);
-      throw_assert(status == 0, "create_cell_attribute_datasets: unable to set chunked layout");
-      status = H5Pset_chunk(plist, 1, cdims);
+      hid_t index_plist = hdf5::create_dataset_creation_plist(dataset_policy, hdf5::DatasetIndex,
+                                                              chunk_size);
+      status = H5Pset_alloc_time(index_plist, H5D_ALLOC_TIME_EARLY);
       throw_assert(status == 0,
-                   "create_cell_attribute_datasets: unable to set chunk size");
+                   "create_cell_attribute_datasets: unable to set allocation time");
+
+      hid_t plist = hdf5::create_dataset_creation_plist(dataset_policy, hdf5::DatasetPointer,
+                                                        chunk_size);
       status = H5Pset_alloc_time(plist, H5D_ALLOC_TIME_EARLY);
       throw_assert(status == 0,
                    "create_cell_attribute_datasets: unable to set allocation time");
-#ifdef H5_HAS_PARALLEL_DEFLATE
-      status = H5Pset_deflate(plist, 9);
-      throw_assert(status == 0,
-                   "create_cell_attribute_datasets: unable to add deflate filter");
-#endif
 
-      
-      hsize_t value_cdims[1]   = {value_chunk_size}; /* chunking dimensions for value dataset */		
-      hid_t value_plist = H5Pcreate (H5P_DATASET_CREATE);
-      status = H5Pset_layout(value_plist, H5D_CHUNKED);
-      throw_assert(status == 0,
-                   "create_cell_attribute_datasets: unable to set chunked layout");
-      status = H5Pset_chunk(value_plist, 1, value_cdims);
-      throw_assert(status == 0,
-                   "create_cell_attribute_datasets: unable to set chunk size");
+      hid_t value_plist = hdf5::create_dataset_creation_plist(dataset_policy, hdf5::DatasetValue,
+                                                              value_chunk_size);
       status = H5Pset_alloc_time(value_plist, H5D_ALLOC_TIME_EARLY);
       throw_assert(status == 0,
                    "create_cell_attribute_datasets: unable to set allocation time");
-#ifdef H5_HAS_PARALLEL_DEFLATE
-      status = H5Pset_deflate(value_plist, 9);
-      throw_assert(status == 0,
-                   "create_cell_attribute_datasets: unable to add deflate filter");
-#endif
       
       hid_t lcpl = H5Pcreate(H5P_LINK_CREATE);
       throw_assert(lcpl >= 0,
@@ -615,7 +967,7 @@ namespace neuroh5
 
             dset = H5Dcreate2(file, (attr_path + "/" + hdf5::CELL_INDEX).c_str(),
                               CELL_IDX_H5_FILE_T,
-                              mspace, lcpl, plist, H5P_DEFAULT);
+                              mspace, lcpl, index_plist, H5P_DEFAULT);
             throw_assert(H5Dclose(dset) >= 0,
                          "create_cell_attribute_datasets: unable to create data set");
             throw_assert(H5Sclose(mspace) >= 0,
@@ -704,6 +1056,9 @@ namespace neuroh5
     throw_assert(H5Pclose(lcpl) >= 0,
                  "create_cell_attribute_datasets: unable to close link creation property list");
     
+    status = H5Pclose(index_plist);
+    throw_assert(status == 0,
+                 "create_cell_attribute_datasets: unable to close index property list");
     status = H5Pclose(plist);
     throw_assert(status == 0,
                  "create_cell_attribute_datasets: unable to close property list");
@@ -715,98 +1070,66 @@ namespace neuroh5
   }
 
   
-    void read_cell_attributes
+    /// Reads the attribute names, types, indices, and pointers of a
+    /// namespace on rank 0 and broadcasts them to all ranks of comm.
+    static void bcast_cell_attribute_index_ptr
     (
      MPI_Comm      comm,
      const string& file_name,
      const string& name_space,
-     const set<string>& attr_mask,
      const string& pop_name,
      const CELL_IDX_T& pop_start,
-     data::NamedAttrMap& attr_values,
-     size_t offset,
-     size_t numitems
+     vector< tuple<string,AttrKind,vector<CELL_IDX_T>,vector<ATTR_PTR_T> > >& attr_info
      )
     {
-      herr_t status; 
-
-      unsigned int rank, size;
-      throw_assert(MPI_Comm_size(comm, (int*)&size) >= 0, "read_cell_attributes: error in MPI_Comm_size");
+      unsigned int rank;
       throw_assert(MPI_Comm_rank(comm, (int*)&rank) >= 0, "read_cell_attributes: error in MPI_Comm_rank");
 
-      vector< tuple<string,AttrKind,vector<CELL_IDX_T>,vector<ATTR_PTR_T> > > attr_info;
-      node_rank_map_t node_rank_map;
-
       if (rank == 0)
         {
-          status = get_cell_attribute_index_ptr (file_name, name_space, pop_name, pop_start, attr_info);
+          herr_t status = get_cell_attribute_index_ptr (file_name, name_space, pop_name, pop_start, attr_info);
           throw_assert(status == 0,
                        "read_cell_attributes: error in get_cell_attribute_index_ptr");
-          // round-robin node to rank assignment from file
-          if (attr_info.size() > 0)
-            {
-              const vector<CELL_IDX_T>& index  = get<2>(attr_info[0]);
-              for (size_t i = 0; i < index.size(); i++)
-                {
-                  auto it = node_rank_map.find(index[i]);
-                  if (it == node_rank_map.end())
-                    {
-                      node_rank_map[index[i]].insert(i%size);
-                    }
-                }
-            }
         }
-      // Broadcast the attribute names, types, indices, and pointers
-      {
-        vector<char> sendbuf; size_t sendbuf_size=0;
-        if (rank == 0)
-          {
-            data::serialize_data(attr_info, sendbuf);
-            sendbuf_size = sendbuf.size();
-          }
 
-        throw_assert(MPI_Bcast(&sendbuf_size, 1, MPI_SIZE_T, 0, comm) == MPI_SUCCESS,
-                     "read_cell_attributes: error in MPI_Bcast");
-        sendbuf.resize(sendbuf_size);
-        throw_assert(MPI_Bcast(&sendbuf[0], sendbuf_size, MPI_CHAR, 0, comm) == MPI_SUCCESS,
-                     "read_cell_attributes: error in MPI_Bcast");
-        
-        if (rank != 0)
-          {
-            data::deserialize_data(sendbuf, attr_info);
-          }
-      }
-      // Broadcast the node rank map
-      {
-        vector<char> sendbuf; size_t sendbuf_size=0;
-        if (rank == 0)
-          {
-            data::serialize_data(node_rank_map, sendbuf);
-            sendbuf_size = sendbuf.size();
-          }
+      vector<char> sendbuf; size_t sendbuf_size=0;
+      if (rank == 0)
+        {
+          data::serialize_data(attr_info, sendbuf);
+          sendbuf_size = sendbuf.size();
+        }
 
-        throw_assert(MPI_Bcast(&sendbuf_size, 1, MPI_SIZE_T, 0, comm) == MPI_SUCCESS,
-                     "read_cell_attributes: error in MPI_Bcast");
-        sendbuf.resize(sendbuf_size);
-        throw_assert(MPI_Bcast(&sendbuf[0], sendbuf_size, MPI_CHAR, 0, comm) == MPI_SUCCESS,
-                     "read_cell_attributes: error in MPI_Bcast");
+      throw_assert(MPI_Bcast(&sendbuf_size, 1, MPI_SIZE_T, 0, comm) == MPI_SUCCESS,
+                   "read_cell_attributes: error in MPI_Bcast");
+      sendbuf.resize(sendbuf_size);
+      throw_assert(MPI_Bcast(&sendbuf[0], sendbuf_size, MPI_CHAR, 0, comm) == MPI_SUCCESS,
+                   "read_cell_attributes: error in MPI_Bcast");
         
-        if (rank != 0)
-          {
-            data::deserialize_data(sendbuf, node_rank_map);
-          }
-      }
+      if (rank != 0)
+        {
+          data::deserialize_data(sendbuf, attr_info);
+        }
+    }
 
-      // get a file handle and retrieve the MPI info
-      hid_t fapl = H5Pcreate(H5P_FILE_ACCESS);
-#ifdef HDF5_IS_PARALLEL
-      throw_assert_nomsg(H5Pset_fapl_mpio(fapl, comm, MPI_INFO_NULL) >= 0);
-#endif
-      // TODO: configurable elink cache
-      // throw_assert_nomsg(H5Pset_elink_file_cache_size(fapl, 10) >= 0);
-      hid_t file = H5Fopen(file_name.c_str(), H5F_ACC_RDONLY, fapl);
-      throw_assert_nomsg(file >= 0);
 
+    /// Reads the values of the unmasked attributes of a namespace for the
+    /// cells in the given range of the index, using indices and pointers
+    /// obtained with bcast_cell_attribute_index_ptr.
+    template <class AttrMapT>
+    static void read_cell_attribute_values
+    (
+     MPI_Comm      comm,
+     hid_t         file,
+     const string& name_space,
+     const set<string>& attr_mask,
+     const string& pop_name,
+     const CELL_IDX_T& pop_start,
+     const vector< tuple<string,AttrKind,vector<CELL_IDX_T>,vector<ATTR_PTR_T> > >& attr_info,
+     AttrMapT& attr_values,
+     size_t offset,
+     size_t numitems
+     )
+    {
       for (size_t i=0; i<attr_info.size(); i++)
         {
           vector<CELL_IDX_T>  value_index;
@@ -823,6 +1146,7 @@ namespace neuroh5
           if ((attr_mask.size() > 0) && (attr_mask.count(attr_name) == 0))
             continue;
           
+          herr_t status = 0;
           switch (attr_kind.type)
             {
             case UIntVal:
@@ -833,7 +1157,7 @@ namespace neuroh5
                                                      index, ptr, value_index, value_ptr,
                                                      attr_values_uint32,
                                                      offset, numitems);
-                  attr_values.insert(attr_name, value_index, value_ptr, attr_values_uint32);
+                  attr_values.insert(attr_name, std::move(value_index), std::move(value_ptr), std::move(attr_values_uint32));
                 }
               else if (attr_size == 2)
                 {
@@ -841,7 +1165,7 @@ namespace neuroh5
                   status = hdf5::read_cell_attribute(comm, file, attr_path, pop_start,
                                                      index, ptr, value_index, value_ptr, attr_values_uint16,
                                                      offset, numitems);
-                  attr_values.insert(attr_name, value_index, value_ptr, attr_values_uint16);
+                  attr_values.insert(attr_name, std::move(value_index), std::move(value_ptr), std::move(attr_values_uint16));
                 }
               else if (attr_size == 1)
                 {
@@ -849,7 +1173,7 @@ namespace neuroh5
                   status = hdf5::read_cell_attribute(comm, file, attr_path, pop_start,
                                                      index, ptr, value_index, value_ptr, attr_values_uint8,
                                                      offset, numitems);
-                  attr_values.insert(attr_name, value_index, value_ptr, attr_values_uint8);
+                  attr_values.insert(attr_name, std::move(value_index), std::move(value_ptr), std::move(attr_values_uint8));
                 }
               else
                 {
@@ -864,7 +1188,7 @@ namespace neuroh5
                     status = hdf5::read_cell_attribute(comm, file, attr_path, pop_start,
                                                        index, ptr, value_index, value_ptr, attr_values_int32,
                                                        offset, numitems);
-                    attr_values.insert(attr_name, value_index, value_ptr, attr_values_int32);
+                    attr_values.insert(attr_name, std::move(value_index), std::move(value_ptr), std::move(attr_values_int32));
                   }
                 else if (attr_size == 2)
                   {
@@ -872,7 +1196,7 @@ namespace neuroh5
                     status = hdf5::read_cell_attribute(comm, file, attr_path, pop_start,
                                                        index, ptr, value_index, value_ptr, attr_values_int16,
                                                        offset, numitems);
-                    attr_values.insert(attr_name, value_index, value_ptr, attr_values_int16);
+                    attr_values.insert(attr_name, std::move(value_index), std::move(value_ptr), std::move(attr_values_int16));
                   }
                 else if (attr_size == 1)
                   {
@@ -880,7 +1204,7 @@ namespace neuroh5
                     status = hdf5::read_cell_attribute(comm, file, attr_path, pop_start,
                                                        index, ptr, value_index, value_ptr, attr_values_int8,
                                                        offset, numitems);
-                    attr_values.insert(attr_name, value_index, value_ptr, attr_values_int8);
+                    attr_values.insert(attr_name, std::move(value_index), std::move(value_ptr), std::move(attr_values_int8));
                   }
                 else
                   {
@@ -894,7 +1218,7 @@ namespace neuroh5
                 status = hdf5::read_cell_attribute(comm, file, attr_path, pop_start,
                                                    index, ptr, value_index, value_ptr, attr_values_float,
                                                    offset, numitems);
-                attr_values.insert(attr_name, value_index, value_ptr, attr_values_float);
+                attr_values.insert(attr_name, std::move(value_index), std::move(value_ptr), std::move(attr_values_float));
               }
               break;
             case EnumVal:
@@ -905,7 +1229,7 @@ namespace neuroh5
                     status = hdf5::read_cell_attribute(comm, file, attr_path, pop_start,
                                                        index, ptr, value_index, value_ptr, attr_values_uint8,
                                                        offset, numitems);
-                    attr_values.insert(attr_name, value_index, value_ptr, attr_values_uint8);
+                    attr_values.insert(attr_name, std::move(value_index), std::move(value_ptr), std::move(attr_values_uint8));
                   }
                 else
                   {
@@ -917,106 +1241,193 @@ namespace neuroh5
               throw runtime_error("Unsupported attribute type");
               break;
             }
+          throw_assert(status >= 0,
+                       "read_cell_attribute_values: error reading attribute " << attr_name);
         }
-
-      status = H5Fclose(file);
-      throw_assert_nomsg(status == 0);
-      status = H5Pclose(fapl);
-      throw_assert_nomsg(status == 0);
-      
     }
 
 
-    int scatter_read_cell_attributes
+    template <class AttrMapT>
+    static void read_cell_attributes_impl
     (
-     MPI_Comm                      all_comm,
-     const string                 &file_name,
-     const int                     io_size,
-     const string                 &attr_name_space,
-     const set<string>            &attr_mask,
-     // A vector that maps nodes to compute ranks
-     const node_rank_map_t        &node_rank_map,
-     const string                 &pop_name,
-     const CELL_IDX_T             &pop_start,
-     data::NamedAttrMap           &attr_map,
-     // if positive, these arguments specify offset and number of entries to read
-     // from the entries available to the current rank
+     MPI_Comm      comm,
+     const string& file_name,
+     const string& name_space,
+     const set<string>& attr_mask,
+     const string& pop_name,
+     const CELL_IDX_T& pop_start,
+     AttrMapT& attr_values,
      size_t offset,
      size_t numitems
      )
     {
-      int srank, ssize; size_t rank, size;
-      throw_assert_nomsg(MPI_Comm_size(all_comm, &ssize) >= 0);
-      throw_assert_nomsg(MPI_Comm_rank(all_comm, &srank) >= 0);
-      throw_assert_nomsg(ssize > 0);
-      throw_assert_nomsg(srank >= 0);
-      size = ssize;
-      rank = srank;
+      vector< tuple<string,AttrKind,vector<CELL_IDX_T>,vector<ATTR_PTR_T> > > attr_info;
+      bcast_cell_attribute_index_ptr(comm, file_name, name_space, pop_name, pop_start, attr_info);
 
-      vector< size_t > num_attrs(data::AttrMap::num_attr_types, 0);
-      vector< vector<string> > attr_names;
+      // get a file handle (the file of a session if one is open)
+      hid_t file = hdf5::open_file(comm, file_name, true);
+      throw_assert_nomsg(file >= 0);
 
-      // MPI Communicator for I/O ranks
-      MPI_Comm io_comm;
-      // MPI group color value used for I/O ranks
-      int io_color = 1;
+      read_cell_attribute_values(comm, file, name_space, attr_mask, pop_name, pop_start,
+                                 attr_info, attr_values, offset, numitems);
 
-      throw_assert_nomsg(io_size > 0);
-    
-      vector<char> sendbuf; 
-      vector<size_t> sendcounts(size,0), sdispls(size,0), recvcounts(size,0), rdispls(size,0);
+      herr_t status = hdf5::close_file(file);
+      throw_assert_nomsg(status == 0);
+    }
 
-      set<size_t> io_rank_set;
-      data::range_sample(size, io_size, io_rank_set);
-      bool is_io_rank = (io_rank_set.find(rank) != io_rank_set.end());
-
-      if (is_io_rank)
-        {
-          // Am I an I/O rank?
-          MPI_Comm_split(all_comm,io_color,rank,&io_comm);
-          MPI_Comm_set_errhandler(io_comm, MPI_ERRORS_RETURN);
 
+    void read_cell_attributes
+    (
+     MPI_Comm      comm,
+     const string& file_name,
+     const string& name_space,
+     const set<string>& attr_mask,
+     const string& pop_name,
+     const CELL_IDX_T& pop_start,
+     data::NamedAttrMap& attr_values,
+     size_t offset,
+     size_t numitems
+     )
+    {
+      read_cell_attributes_impl(comm, file_name, name_space, attr_mask, pop_name, pop_start,
+                                attr_values, offset, numitems);
+    }
 
+    
+    void read_cell_attributes
+    (
+     MPI_Comm      comm,
+     const string& file_name,
+     const string& name_space,
+     const set<string>& attr_mask,
+     const string& pop_name,
+     const CELL_IDX_T& pop_start,
+     data::ColumnarAttrMap& attr_values,
+     size_t offset,
+     size_t numitems
+     )
+    {
+      read_cell_attributes_impl(comm, file_name, name_space, attr_mask, pop_name, pop_start,
+                                attr_values, offset, numitems);
+    }
 
-          map <rank_t, data::AttrMap > rank_attr_map;
-          {
-            data::NamedAttrMap  attr_values;
-            read_cell_attributes(io_comm, file_name, attr_name_space, attr_mask, pop_name, pop_start,
-                                 attr_values, offset, numitems * size);
-            data::append_rank_attr_map(attr_values, node_rank_map, rank_attr_map);
-            attr_values.num_attrs(num_attrs);
-            attr_values.attr_names(attr_names);
-          }
 
-          data::serialize_rank_attr_map (size, rank, rank_attr_map, sendcounts, sendbuf, sdispls);
+    template <class AttrMapT>
+    static void insert_attr_names
+    (
+     const vector< size_t >& num_attrs,
+     const vector< vector<string> >& attr_names,
+     AttrMapT& attr_map
+     )
+    {
+      for (size_t i=0; i<num_attrs[data::AttrMap::attr_index_float]; i++)
+        {
+          attr_map.template insert_name<float>(attr_names[data::AttrMap::attr_index_float][i]);
         }
-      else
+      for (size_t i=0; i<num_attrs[data::AttrMap::attr_index_uint8]; i++)
         {
-
-          MPI_Comm_split(all_comm,0,rank,&io_comm);
+          attr_map.template insert_name<uint8_t>(attr_names[data::AttrMap::attr_index_uint8][i]);
         }
-      throw_assert_nomsg(MPI_Barrier(io_comm) == MPI_SUCCESS);
-      throw_assert_nomsg(MPI_Comm_free(&io_comm) == MPI_SUCCESS);
-      throw_assert_nomsg(MPI_Barrier(all_comm) == MPI_SUCCESS);
-    
-      vector<size_t> num_attrs_bcast(num_attrs.size());
-      for (size_t i=0; i<num_attrs.size(); i++)
+      for (size_t i=0; i<num_attrs[data::AttrMap::attr_index_int8]; i++)
         {
-          num_attrs_bcast[i] = num_attrs[i];
+          attr_map.template insert_name<int8_t>(attr_names[data::AttrMap::attr_index_int8][i]);
         }
-      // 4. Broadcast the number of attributes of each type to all ranks
-      throw_assert_nomsg(MPI_Bcast(&num_attrs_bcast[0], num_attrs_bcast.size(), MPI_SIZE_T, 0, all_comm) >= 0);
-      for (size_t i=0; i<num_attrs.size(); i++)
+      for (size_t i=0; i<num_attrs[data::AttrMap::attr_index_uint16]; i++)
         {
-          num_attrs[i] = num_attrs_bcast[i];
+          attr_map.template insert_name<uint16_t>(attr_names[data::AttrMap::attr_index_uint16][i]);
+        }
+      for (size_t i=0; i<num_attrs[data::AttrMap::attr_index_int16]; i++)
+        {
+          attr_map.template insert_name<int16_t>(attr_names[data::AttrMap::attr_index_int16][i]);
+        }
+      for (size_t i=0; i<num_attrs[data::AttrMap::attr_index_uint32]; i++)
+        {
+          attr_map.template insert_name<uint32_t>(attr_names[data::AttrMap::attr_index_uint32][i]);
+        }
+      for (size_t i=0; i<num_attrs[data::AttrMap::attr_index_int32]; i++)
+        {
+          attr_map.template insert_name<int32_t>(attr_names[data::AttrMap::attr_index_int32][i]);
+        }
+    }
+
+    
+    /// On an I/O rank, reads the attributes of each namespace with
+    /// read_name_space(k, attr_values) and serializes them by destination
+    /// rank, with the values of all namespaces bound for one rank packed
+    /// in a single segment.
+    template <class AttrMapT, class RankAttrMapT, class ReadNameSpace>
+    static void serialize_io_rank_attributes
+    (
+     const size_t                  size,
+     const size_t                  rank,
+     const size_t                  num_name_spaces,
+     const node_rank_map_t        &node_rank_map,
+     ReadNameSpace                 read_name_space,
+     vector< vector< size_t > >   &num_attrs,
+     vector< vector< vector<string> > > &attr_names,
+     vector<size_t>               &sendcounts,
+     vector<char>                 &sendbuf,
+     vector<size_t>               &sdispls
+     )
+    {
+      vector< vector<size_t> > segment_sendcounts(num_name_spaces), segment_sdispls(num_name_spaces);
+      vector< vector<char> > segment_sendbufs(num_name_spaces);
+      for (size_t k=0; k<num_name_spaces; k++)
+        {
+          map <rank_t, RankAttrMapT > rank_attr_map;
+          {
+            AttrMapT  attr_values;
+            {
+              mpi::PhaseTimer timer("read_cell_attributes");
+              read_name_space(k, attr_values);
+            }
+            mpi::PhaseTimer timer("append_rank_attr_map");
+            data::append_rank_attr_map(attr_values, node_rank_map, rank_attr_map);
+            attr_values.num_attrs(num_attrs[k]);
+            attr_values.attr_names(attr_names[k]);
+          }
+
+          mpi::PhaseTimer timer("serialize_attributes");
+          data::serialize_rank_attr_map (size, rank, rank_attr_map, segment_sendcounts[k],
+                                         segment_sendbufs[k], segment_sdispls[k]);
         }
 
-      // 5. Broadcast the names of each attributes of each type to all ranks
+      data::pack_rank_attr_segments (size, segment_sendcounts, segment_sdispls, segment_sendbufs,
+                                     sendcounts, sendbuf, sdispls);
+    }
+
+
+    /// Sends the attributes serialized by the I/O ranks to their
+    /// destination ranks, after broadcasting the attribute names of each
+    /// namespace from rank 0. Collective over all_comm.
+    template <class AttrMapT>
+    static void exchange_cell_attributes
+    (
+     MPI_Comm                      all_comm,
+     vector< vector< size_t > >   &num_attrs,
+     vector< vector< vector<string> > > &attr_names,
+     vector<size_t>               &sendcounts,
+     vector<size_t>               &sdispls,
+     vector<char>                 &sendbuf,
+     vector<AttrMapT>             &attr_maps
+     )
+    {
+      int srank, ssize; size_t rank, size;
+      throw_assert_nomsg(MPI_Comm_size(all_comm, &ssize) >= 0);
+      throw_assert_nomsg(MPI_Comm_rank(all_comm, &srank) >= 0);
+      size = ssize;
+      rank = srank;
+
+      const size_t num_name_spaces = attr_maps.size();
+      vector<size_t> recvcounts(size,0), rdispls(size,0);
+
+      // 4. Broadcast the number and names of the attributes of each type
+      //    in each namespace to all ranks
       {
         vector<char> sendbuf; size_t sendbuf_size=0;
         if (rank == 0)
           {
-            data::serialize_data(attr_names, sendbuf);
+            data::serialize_data(make_pair(num_attrs, attr_names), sendbuf);
             sendbuf_size = sendbuf.size();
           }
 
@@ -1026,60 +1437,351 @@ namespace neuroh5
         
         if (rank != 0)
           {
-            data::deserialize_data(sendbuf, attr_names);
+            auto attr_info = make_pair(num_attrs, attr_names);
+            data::deserialize_data(sendbuf, attr_info);
+            num_attrs = std::move(attr_info.first);
+            attr_names = std::move(attr_info.second);
           }
       }
-      
-      for (size_t i=0; i<num_attrs[data::AttrMap::attr_index_float]; i++)
+
+      for (size_t k=0; k<num_name_spaces; k++)
         {
-          attr_map.insert_name<float>(attr_names[data::AttrMap::attr_index_float][i]);
+          insert_attr_names(num_attrs[k], attr_names[k], attr_maps[k]);
         }
-      for (size_t i=0; i<num_attrs[data::AttrMap::attr_index_uint8]; i++)
+    
+      // 7. Each ALL_COMM rank accumulates the vector sizes and allocates
+      //    a receive buffer, recvcounts, and rdispls
+      mpi::RecvBuffer<char> recvbuf;
+
+      // 8. Each ALL_COMM rank participates in the exchange; only the I/O
+      //    ranks have data to send, one message per rank for all namespaces
+      {
+        mpi::PhaseTimer timer("alltoallv");
+        throw_assert_nomsg(mpi::scatter_alltoallv_vector<char>(all_comm, MPI_CHAR, sendcounts, sdispls, sendbuf,
+                                                               recvcounts, rdispls, recvbuf) >= 0);
+      }
+      sendbuf.clear();
+      sendbuf.shrink_to_fit();
+
+      if (recvbuf.size() > 0)
         {
-          attr_map.insert_name<uint8_t>(attr_names[data::AttrMap::attr_index_uint8][i]);
+          mpi::PhaseTimer timer("deserialize_attributes");
+          vector< vector<size_t> > segment_recvcounts, segment_rdispls;
+          data::unpack_rank_attr_segments (size, num_name_spaces, recvbuf.data(), recvbuf.size(),
+                                           recvcounts, rdispls, segment_recvcounts, segment_rdispls);
+          for (size_t k=0; k<num_name_spaces; k++)
+            {
+              data::deserialize_rank_attr_map (size, recvbuf.data(), recvbuf.size(),
+                                               segment_recvcounts[k], segment_rdispls[k],
+                                               attr_maps[k]);
+            }
         }
-      for (size_t i=0; i<num_attrs[data::AttrMap::attr_index_int8]; i++)
+      recvbuf.free();
+    }
+
+    
+    template <class AttrMapT, class RankAttrMapT>
+    static int scatter_read_cell_attributes_impl
+    (
+     MPI_Comm                      all_comm,
+     const string                 &file_name,
+     const int                     io_size,
+     const vector< pair<string, set<string> > > &attr_name_spaces,
+     // A vector that maps nodes to compute ranks
+     const node_rank_map_t        &node_rank_map,
+     const string                 &pop_name,
+     const CELL_IDX_T             &pop_start,
+     vector<AttrMapT>             &attr_maps,
+     // if positive, these arguments specify offset and number of entries to read
+     // from the entries available to the current rank
+     size_t offset,
+     size_t numitems
+     )
+    {
+      mpi::PhaseTimer timer("scatter_read_cell_attributes");
+
+      int srank, ssize; size_t rank, size;
+      throw_assert_nomsg(MPI_Comm_size(all_comm, &ssize) >= 0);
+      throw_assert_nomsg(MPI_Comm_rank(all_comm, &srank) >= 0);
+      throw_assert_nomsg(ssize > 0);
+      throw_assert_nomsg(srank >= 0);
+      size = ssize;
+      rank = srank;
+
+      const size_t num_name_spaces = attr_name_spaces.size();
+      attr_maps.resize(num_name_spaces);
+      
+      vector< vector< size_t > > num_attrs(num_name_spaces, vector<size_t>(data::AttrMap::num_attr_types, 0));
+      vector< vector< vector<string> > > attr_names(num_name_spaces);
+
+      // MPI Communicator for I/O ranks
+      MPI_Comm io_comm;
+      // MPI group color value used for I/O ranks
+      int io_color = 1;
+
+      throw_assert_nomsg(io_size > 0);
+    
+      vector<char> sendbuf; 
+      vector<size_t> sendcounts(size,0), sdispls(size,0);
+
+      set<size_t> io_rank_set;
+      mpi::select_io_ranks(all_comm, io_size, io_rank_set);
+      bool is_io_rank = (io_rank_set.find(rank) != io_rank_set.end());
+
+      if (is_io_rank)
         {
-          attr_map.insert_name<int8_t>(attr_names[data::AttrMap::attr_index_int8][i]);
+          // Am I an I/O rank?
+          MPI_Comm_split(all_comm,io_color,rank,&io_comm);
+          MPI_Comm_set_errhandler(io_comm, MPI_ERRORS_RETURN);
+
+          // all namespaces are read through one open file
+          unique_ptr<hdf5::FileSession> session;
+          if (num_name_spaces > 1)
+            {
+              session.reset(new hdf5::FileSession(io_comm, file_name));
+            }
+
+          serialize_io_rank_attributes<AttrMapT, RankAttrMapT>
+            (size, rank, num_name_spaces, node_rank_map,
+             [&] (size_t k, AttrMapT& attr_values)
+             {
+               read_cell_attributes(io_comm, file_name, attr_name_spaces[k].first, attr_name_spaces[k].second,
+                                    pop_name, pop_start, attr_values, offset, numitems * size);
+             },
+             num_attrs, attr_names, sendcounts, sendbuf, sdispls);
+          session.reset();
         }
-      for (size_t i=0; i<num_attrs[data::AttrMap::attr_index_uint16]; i++)
+      else
         {
-          attr_map.insert_name<uint16_t>(attr_names[data::AttrMap::attr_index_uint16][i]);
+
+          MPI_Comm_split(all_comm,0,rank,&io_comm);
         }
-      for (size_t i=0; i<num_attrs[data::AttrMap::attr_index_int16]; i++)
+      throw_assert_nomsg(MPI_Barrier(io_comm) == MPI_SUCCESS);
+      throw_assert_nomsg(MPI_Comm_free(&io_comm) == MPI_SUCCESS);
+      throw_assert_nomsg(MPI_Barrier(all_comm) == MPI_SUCCESS);
+    
+      exchange_cell_attributes(all_comm, num_attrs, attr_names, sendcounts, sdispls, sendbuf, attr_maps);
+
+      return 0;
+    }
+
+
+    template <class AttrMapT, class RankAttrMapT>
+    static int scatter_read_cell_attributes_single
+    (
+     MPI_Comm                      all_comm,
+     const string                 &file_name,
+     const int                     io_size,
+     const string                 &attr_name_space,
+     const set<string>            &attr_mask,
+     const node_rank_map_t        &node_rank_map,
+     const string                 &pop_name,
+     const CELL_IDX_T             &pop_start,
+     AttrMapT                     &attr_map,
+     size_t offset,
+     size_t numitems
+     )
+    {
+      vector< pair<string, set<string> > > attr_name_spaces(1, make_pair(attr_name_space, attr_mask));
+      vector<AttrMapT> attr_maps;
+      attr_maps.push_back(std::move(attr_map));
+      int status = scatter_read_cell_attributes_impl<AttrMapT, RankAttrMapT>
+        (all_comm, file_name, io_size, attr_name_spaces, node_rank_map,
+         pop_name, pop_start, attr_maps, offset, numitems);
+      attr_map = std::move(attr_maps[0]);
+      return status;
+    }
+
+
+    int scatter_read_cell_attributes
+    (
+     MPI_Comm                      all_comm,
+     const string                 &file_name,
+     const int                     io_size,
+     const string                 &attr_name_space,
+     const set<string>            &attr_mask,
+     // A vector that maps nodes to compute ranks
+     const node_rank_map_t        &node_rank_map,
+     const string                 &pop_name,
+     const CELL_IDX_T             &pop_start,
+     data::NamedAttrMap           &attr_map,
+     // if positive, these arguments specify offset and number of entries to read
+     // from the entries available to the current rank
+     size_t offset,
+     size_t numitems
+     )
+    {
+      return scatter_read_cell_attributes_single<data::NamedAttrMap, data::AttrMap>
+        (all_comm, file_name, io_size, attr_name_space, attr_mask, node_rank_map,
+         pop_name, pop_start, attr_map, offset, numitems);
+    }
+
+    
+    int scatter_read_cell_attributes
+    (
+     MPI_Comm                      all_comm,
+     const string                 &file_name,
+     const int                     io_size,
+     const string                 &attr_name_space,
+     const set<string>            &attr_mask,
+     // A vector that maps nodes to compute ranks
+     const node_rank_map_t        &node_rank_map,
+     const string                 &pop_name,
+     const CELL_IDX_T             &pop_start,
+     data::ColumnarAttrMap        &attr_map,
+     // if positive, these arguments specify offset and number of entries to read
+     // from the entries available to the current rank
+     size_t offset,
+     size_t numitems
+     )
+    {
+      return scatter_read_cell_attributes_single<data::ColumnarAttrMap, data::ColumnarAttrMap>
+        (all_comm, file_name, io_size, attr_name_space, attr_mask, node_rank_map,
+         pop_name, pop_start, attr_map, offset, numitems);
+    }
+
+
+    int scatter_read_cell_attributes
+    (
+     MPI_Comm                      all_comm,
+     const string                 &file_name,
+     const int                     io_size,
+     const vector< pair<string, set<string> > > &attr_name_spaces,
+     const node_rank_map_t        &node_rank_map,
+     const string                 &pop_name,
+     const CELL_IDX_T             &pop_start,
+     map<string, data::NamedAttrMap> &attr_maps,
+     size_t offset,
+     size_t numitems
+     )
+    {
+      vector<data::NamedAttrMap> attr_map_vector(attr_name_spaces.size());
+      for (size_t k=0; k<attr_name_spaces.size(); k++)
         {
-          attr_map.insert_name<int16_t>(attr_names[data::AttrMap::attr_index_int16][i]);
+          auto it = attr_maps.find(attr_name_spaces[k].first);
+          if (it != attr_maps.end())
+            {
+              attr_map_vector[k] = std::move(it->second);
+            }
         }
-      for (size_t i=0; i<num_attrs[data::AttrMap::attr_index_uint32]; i++)
+      int status = scatter_read_cell_attributes_impl<data::NamedAttrMap, data::AttrMap>
+        (all_comm, file_name, io_size, attr_name_spaces, node_rank_map,
+         pop_name, pop_start, attr_map_vector, offset, numitems);
+      for (size_t k=0; k<attr_name_spaces.size(); k++)
         {
-          attr_map.insert_name<uint32_t>(attr_names[data::AttrMap::attr_index_uint32][i]);
+          attr_maps[attr_name_spaces[k].first] = std::move(attr_map_vector[k]);
         }
-      for (size_t i=0; i<num_attrs[data::AttrMap::attr_index_int32]; i++)
+      return status;
+    }
+
+
+    CellAttributeBlockReader::CellAttributeBlockReader
+    (
+     MPI_Comm                      comm,
+     const string                 &file_name,
+     const int                     io_size,
+     const vector< pair<string, set<string> > > &attr_name_spaces,
+     const node_rank_map_t        &node_rank_map,
+     const string                 &pop_name,
+     const CELL_IDX_T             &pop_start
+     )
+      : io_comm(MPI_COMM_NULL), is_io_rank(false), file(-1),
+        file_name(file_name), attr_name_spaces(attr_name_spaces),
+        node_rank_map(node_rank_map), pop_name(pop_name), pop_start(pop_start)
+    {
+      throw_assert_nomsg(io_size > 0);
+      throw_assert(MPI_Comm_dup(comm, &all_comm) == MPI_SUCCESS,
+                   "CellAttributeBlockReader: unable to duplicate MPI communicator");
+
+      int rank;
+      throw_assert_nomsg(MPI_Comm_rank(all_comm, &rank) == MPI_SUCCESS);
+
+      set<size_t> io_rank_set;
+      mpi::select_io_ranks(all_comm, io_size, io_rank_set);
+      is_io_rank = (io_rank_set.find(rank) != io_rank_set.end());
+
+      throw_assert(MPI_Comm_split(all_comm, is_io_rank ? 1 : 0, rank, &io_comm) == MPI_SUCCESS,
+                   "CellAttributeBlockReader: error in MPI_Comm_split");
+      if (is_io_rank)
         {
-          attr_map.insert_name<int32_t>(attr_names[data::AttrMap::attr_index_int32][i]);
+          MPI_Comm_set_errhandler(io_comm, MPI_ERRORS_RETURN);
+
+          attr_infos.resize(attr_name_spaces.size());
+          for (size_t k=0; k<attr_name_spaces.size(); k++)
+            {
+              bcast_cell_attribute_index_ptr(io_comm, file_name, attr_name_spaces[k].first,
+                                             pop_name, pop_start, attr_infos[k]);
+            }
+
+          file = hdf5::open_file(io_comm, file_name, true);
+          throw_assert(file >= 0, "CellAttributeBlockReader: unable to open file " << file_name);
         }
-    
-      // 7. Each ALL_COMM rank accumulates the vector sizes and allocates
-      //    a receive buffer, recvcounts, and rdispls
-      vector<char> recvbuf;
+    }
 
-      // 8. Each ALL_COMM rank participates in the MPI_Alltoallv
-      throw_assert_nomsg(mpi::alltoallv_vector<char>(all_comm, MPI_CHAR, sendcounts, sdispls, sendbuf,
-                                                     recvcounts, rdispls, recvbuf) >= 0);
-      sendbuf.clear();
-      sendbuf.shrink_to_fit();
 
-      if (recvbuf.size() > 0)
+    CellAttributeBlockReader::~CellAttributeBlockReader ()
+    {
+      if (file >= 0)
         {
-          data::deserialize_rank_attr_map (size, recvbuf, recvcounts, rdispls, attr_map);
+          hdf5::close_file(file);
         }
-      recvbuf.clear();
-      recvbuf.shrink_to_fit();
-      
+      MPI_Comm_free(&io_comm);
+      MPI_Comm_free(&all_comm);
+    }
+
+
+    template <class AttrMapT, class RankAttrMapT>
+    int CellAttributeBlockReader::read_impl (size_t offset, size_t numitems, vector<AttrMapT>& attr_maps)
+    {
+      mpi::PhaseTimer timer("scatter_read_cell_attributes");
+
+      int srank, ssize; size_t rank, size;
+      throw_assert_nomsg(MPI_Comm_size(all_comm, &ssize) == MPI_SUCCESS);
+      throw_assert_nomsg(MPI_Comm_rank(all_comm, &srank) == MPI_SUCCESS);
+      size = ssize;
+      rank = srank;
+
+      const size_t num_name_spaces = attr_name_spaces.size();
+      attr_maps.resize(num_name_spaces);
+
+      vector< vector< size_t > > num_attrs(num_name_spaces, vector<size_t>(data::AttrMap::num_attr_types, 0));
+      vector< vector< vector<string> > > attr_names(num_name_spaces);
+
+      vector<char> sendbuf; 
+      vector<size_t> sendcounts(size,0), sdispls(size,0);
+
+      if (is_io_rank)
+        {
+          serialize_io_rank_attributes<AttrMapT, RankAttrMapT>
+            (size, rank, num_name_spaces, node_rank_map,
+             [&] (size_t k, AttrMapT& attr_values)
+             {
+               read_cell_attribute_values(io_comm, file, attr_name_spaces[k].first,
+                                          attr_name_spaces[k].second, pop_name, pop_start,
+                                          attr_infos[k], attr_values, offset, numitems * size);
+             },
+             num_attrs, attr_names, sendcounts, sendbuf, sdispls);
+        }
+
+      exchange_cell_attributes(all_comm, num_attrs, attr_names, sendcounts, sdispls, sendbuf, attr_maps);
 
       return 0;
     }
 
+
+    int CellAttributeBlockReader::read (size_t offset, size_t numitems,
+                                        vector<data::NamedAttrMap>& attr_maps)
+    {
+      return read_impl<data::NamedAttrMap, data::AttrMap>(offset, numitems, attr_maps);
+    }
+
+
+    int CellAttributeBlockReader::read (size_t offset, size_t numitems,
+                                        vector<data::ColumnarAttrMap>& attr_maps)
+    {
+      return read_impl<data::ColumnarAttrMap, data::ColumnarAttrMap>(offset, numitems, attr_maps);
+    }
+
   
     void bcast_cell_attributes
     (
@@ -1285,72 +1987,352 @@ namespace neuroh5
           num_attrs[i] = num_attrs_bcast[i];
         }
 
-      
-      throw_assert_nomsg(MPI_Barrier(comm) == MPI_SUCCESS);
-
-      // Broadcast the names of each attributes of each type to all ranks
+      
+      throw_assert_nomsg(MPI_Barrier(comm) == MPI_SUCCESS);
+
+      // Broadcast the names of each attributes of each type to all ranks
+      {
+        vector<char> sendbuf;
+        size_t sendbuf_size=0;
+        if (rank == (unsigned int)root)
+          {
+            data::serialize_data(attr_names, sendbuf);
+            sendbuf_size = sendbuf.size();
+          }
+        
+        throw_assert_nomsg(MPI_Bcast(&sendbuf_size, 1, MPI_SIZE_T, root, comm) >= 0);
+        
+        sendbuf.resize(sendbuf_size);
+        throw_assert_nomsg(MPI_Bcast(&sendbuf[0], sendbuf.size(), MPI_CHAR, root, comm) >= 0);
+        
+        if (rank != (unsigned int)root)
+          {
+            data::deserialize_data(sendbuf, attr_names);
+          }
+      }
+          
+      
+      for (size_t i=0; i<num_attrs[data::AttrMap::attr_index_float]; i++)
+        {
+          attr_map.insert_name<float>(attr_names[data::AttrMap::attr_index_float][i]);
+        }
+      for (size_t i=0; i<num_attrs[data::AttrMap::attr_index_uint8]; i++)
+        {
+          attr_map.insert_name<uint8_t>(attr_names[data::AttrMap::attr_index_uint8][i]);
+        }
+      for (size_t i=0; i<num_attrs[data::AttrMap::attr_index_int8]; i++)
+        {
+          attr_map.insert_name<int8_t>(attr_names[data::AttrMap::attr_index_int8][i]);
+        }
+      for (size_t i=0; i<num_attrs[data::AttrMap::attr_index_uint16]; i++)
+        {
+          attr_map.insert_name<uint16_t>(attr_names[data::AttrMap::attr_index_uint16][i]);
+        }
+      for (size_t i=0; i<num_attrs[data::AttrMap::attr_index_int16]; i++)
+        {
+          attr_map.insert_name<int16_t>(attr_names[data::AttrMap::attr_index_int16][i]);
+        }
+      for (size_t i=0; i<num_attrs[data::AttrMap::attr_index_uint32]; i++)
+        {
+          attr_map.insert_name<uint32_t>(attr_names[data::AttrMap::attr_index_uint32][i]);
+        }
+      for (size_t i=0; i<num_attrs[data::AttrMap::attr_index_int32]; i++)
+        {
+          attr_map.insert_name<int32_t>(attr_names[data::AttrMap::attr_index_int32][i]);
+        }
+
+      size_t sendrecvbuf_size = sendrecvbuf.size();
+      throw_assert_nomsg(MPI_Bcast(&sendrecvbuf_size, 1, MPI_SIZE_T, root, comm) == MPI_SUCCESS);
+      throw_assert_nomsg(MPI_Barrier(comm) == MPI_SUCCESS);
+      sendrecvbuf.resize(sendrecvbuf_size);
+      throw_assert_nomsg(MPI_Bcast(&sendrecvbuf[0], sendrecvbuf_size, MPI_CHAR, root, comm) == MPI_SUCCESS);
+
+
+      if (rank != (unsigned int)root)
+        {
+          data::deserialize_data(sendrecvbuf, attr_map);
+        }
+      throw_assert_nomsg(MPI_Barrier(comm) == MPI_SUCCESS);
+    }
+
+
+    /*
+     * Shared cell attribute layout
+     *
+     * For each attribute, in the order of the attribute list broadcast
+     * from the root rank, the columns
+     *
+     *   index [num_index] (CELL_IDX_T), ptr [num_ptr] (ATTR_PTR_T),
+     *   value [num_value]
+     *
+     * each starting at a multiple of SharedSegment::column_alignment.
+     */
+    typedef tuple<string, uint32_t, uint64_t, uint64_t, uint64_t> shared_attr_shape_t;
+
+    // Reads an attribute on the root rank into the given containers, and
+    // returns its shape
+    template <class T>
+    static shared_attr_shape_t read_shared_cell_attribute
+    (
+     hid_t file,
+     const string& attr_path,
+     const string& attr_name,
+     const CELL_IDX_T& pop_start,
+     const vector<CELL_IDX_T>& index,
+     const vector<ATTR_PTR_T>& ptr,
+     vector< vector<CELL_IDX_T> >& value_indexes,
+     vector< vector<ATTR_PTR_T> >& value_ptrs,
+     data::AttrVal& values
+     )
+    {
+      value_indexes.emplace_back();
+      value_ptrs.emplace_back();
+      vector<T> attr_values;
+      herr_t status = hdf5::read_cell_attribute(MPI_COMM_SELF, file, attr_path, pop_start,
+                                                index, ptr, value_indexes.back(), value_ptrs.back(),
+                                                attr_values);
+      throw_assert(status >= 0,
+                   "bcast_cell_attributes_shared: error reading attribute " << attr_path);
+      shared_attr_shape_t shape(attr_name, data::AttrVal::attr_type_index<T>(),
+                                value_indexes.back().size(), value_ptrs.back().size(),
+                                attr_values.size());
+      values.insert(attr_values);
+      return shape;
+    }
+
+    template <class T>
+    static void view_shared_cell_attribute (const shared_ptr<mpi::SharedSegment>& segment, size_t& pos,
+                                            const shared_attr_shape_t& shape,
+                                            SharedCellAttributes& attr_values)
+    {
+      hdf5::CellAttributeView<T>& attr_view = attr_values.attr_views<T>()[get<0>(shape)];
+      attr_view.index = mpi::view_column<CELL_IDX_T>(segment, pos, get<2>(shape));
+      attr_view.ptr   = mpi::view_column<ATTR_PTR_T>(segment, pos, get<3>(shape));
+      attr_view.value = mpi::view_column<T>(segment, pos, get<4>(shape));
+    }
+
+    static size_t attr_type_size (const size_t type_index)
+    {
+      switch (type_index)
+        {
+        case data::AttrVal::attr_index_float:  return sizeof(float);
+        case data::AttrVal::attr_index_uint8:  return sizeof(uint8_t);
+        case data::AttrVal::attr_index_int8:   return sizeof(int8_t);
+        case data::AttrVal::attr_index_uint16: return sizeof(uint16_t);
+        case data::AttrVal::attr_index_int16:  return sizeof(int16_t);
+        case data::AttrVal::attr_index_uint32: return sizeof(uint32_t);
+        case data::AttrVal::attr_index_int32:  return sizeof(int32_t);
+        default:
+          throw runtime_error("Unsupported attribute type");
+        }
+    }
+
+    
+    void bcast_cell_attributes_shared
+    (
+     MPI_Comm      comm,
+     const int     root,
+     const string& file_name,
+     const string& name_space,
+     const set<string>& attr_mask,
+     const string& pop_name,
+     const CELL_IDX_T& pop_start,
+     SharedCellAttributes& attr_values
+     )
+    {
+      int rank;
+      throw_assert_nomsg(MPI_Comm_rank(comm, &rank) == MPI_SUCCESS);
+
+      vector<shared_attr_shape_t> attr_shapes;
+      vector< vector<CELL_IDX_T> > value_indexes;
+      vector< vector<ATTR_PTR_T> > value_ptrs;
+      data::AttrVal values;
+
+      if (rank == root)
+        {
+          vector< tuple<string,AttrKind,vector<CELL_IDX_T>,vector<ATTR_PTR_T> > > attr_info;
+          herr_t status = get_cell_attribute_index_ptr (file_name, name_space, pop_name, pop_start, attr_info);
+          throw_assert(status == 0,
+                       "bcast_cell_attributes_shared: error in get_cell_attribute_index_ptr");
+
+          // the root rank reads by itself, also if the file is open in a
+          // session over comm
+          hid_t fapl = H5Pcreate(H5P_FILE_ACCESS);
+#ifdef HDF5_IS_PARALLEL
+          throw_assert_nomsg(H5Pset_fapl_mpio(fapl, MPI_COMM_SELF, MPI_INFO_NULL) >= 0);
+#endif
+          hid_t file = H5Fopen(file_name.c_str(), H5F_ACC_RDONLY, fapl);
+          throw_assert(file >= 0,
+                       "bcast_cell_attributes_shared: unable to open file " << file_name);
+          throw_assert_nomsg(H5Pclose(fapl) >= 0);
+        
+          for (size_t i=0; i<attr_info.size(); i++)
+            {
+              const string& attr_name  = get<0>(attr_info[i]);
+              const AttrKind& attr_kind = get<1>(attr_info[i]);
+              const vector<CELL_IDX_T>& index  = get<2>(attr_info[i]);
+              const vector<ATTR_PTR_T>& ptr  = get<3>(attr_info[i]);
+
+              if ((attr_mask.size() > 0) && (attr_mask.count(attr_name) == 0))
+                continue;
+
+              string attr_path  = hdf5::cell_attribute_path (name_space, pop_name, attr_name);
+              
+              switch (attr_kind.type)
+                {
+                case UIntVal:
+                  if (attr_kind.size == 4)
+                    attr_shapes.push_back(read_shared_cell_attribute<uint32_t>
+                                          (file, attr_path, attr_name, pop_start, index, ptr,
+                                           value_indexes, value_ptrs, values));
+                  else if (attr_kind.size == 2)
+                    attr_shapes.push_back(read_shared_cell_attribute<uint16_t>
+                                          (file, attr_path, attr_name, pop_start, index, ptr,
+                                           value_indexes, value_ptrs, values));
+                  else if (attr_kind.size == 1)
+                    attr_shapes.push_back(read_shared_cell_attribute<uint8_t>
+                                          (file, attr_path, attr_name, pop_start, index, ptr,
+                                           value_indexes, value_ptrs, values));
+                  else
+                    throw runtime_error("Unsupported integer attribute size");
+                  break;
+                case SIntVal:
+                  if (attr_kind.size == 4)
+                    attr_shapes.push_back(read_shared_cell_attribute<int32_t>
+                                          (file, attr_path, attr_name, pop_start, index, ptr,
+                                           value_indexes, value_ptrs, values));
+                  else if (attr_kind.size == 2)
+                    attr_shapes.push_back(read_shared_cell_attribute<int16_t>
+                                          (file, attr_path, attr_name, pop_start, index, ptr,
+                                           value_indexes, value_ptrs, values));
+                  else if (attr_kind.size == 1)
+                    attr_shapes.push_back(read_shared_cell_attribute<int8_t>
+                                          (file, attr_path, attr_name, pop_start, index, ptr,
+                                           value_indexes, value_ptrs, values));
+                  else
+                    throw runtime_error("Unsupported integer attribute size");
+                  break;
+                case FloatVal:
+                  attr_shapes.push_back(read_shared_cell_attribute<float>
+                                        (file, attr_path, attr_name, pop_start, index, ptr,
+                                         value_indexes, value_ptrs, values));
+                  break;
+                case EnumVal:
+                  if (attr_kind.size == 1)
+                    attr_shapes.push_back(read_shared_cell_attribute<uint8_t>
+                                          (file, attr_path, attr_name, pop_start, index, ptr,
+                                           value_indexes, value_ptrs, values));
+                  else
+                    throw runtime_error("Unsupported enumerated attribute size");
+                  break;
+                default:
+                  throw runtime_error("Unsupported attribute type");
+                  break;
+                }
+            }
+          
+          throw_assert_nomsg(H5Fclose(file) >= 0);
+        }
+
+      // Broadcast the names and shapes of the attributes
       {
         vector<char> sendbuf;
-        size_t sendbuf_size=0;
-        if (rank == (unsigned int)root)
+        uint64_t sendbuf_size = 0;
+        if (rank == root)
           {
-            data::serialize_data(attr_names, sendbuf);
+            data::serialize_data(attr_shapes, sendbuf);
             sendbuf_size = sendbuf.size();
           }
-        
-        throw_assert_nomsg(MPI_Bcast(&sendbuf_size, 1, MPI_SIZE_T, root, comm) >= 0);
-        
+        throw_assert_nomsg(MPI_Bcast(&sendbuf_size, 1, MPI_UINT64_T, root, comm) == MPI_SUCCESS);
         sendbuf.resize(sendbuf_size);
-        throw_assert_nomsg(MPI_Bcast(&sendbuf[0], sendbuf.size(), MPI_CHAR, root, comm) >= 0);
-        
-        if (rank != (unsigned int)root)
+        throw_assert_nomsg(MPI_Bcast(&sendbuf[0], sendbuf_size, MPI_CHAR, root, comm) == MPI_SUCCESS);
+        if (rank != root)
           {
-            data::deserialize_data(sendbuf, attr_names);
+            data::deserialize_data(sendbuf, attr_shapes);
           }
       }
-          
-      
-      for (size_t i=0; i<num_attrs[data::AttrMap::attr_index_float]; i++)
-        {
-          attr_map.insert_name<float>(attr_names[data::AttrMap::attr_index_float][i]);
-        }
-      for (size_t i=0; i<num_attrs[data::AttrMap::attr_index_uint8]; i++)
-        {
-          attr_map.insert_name<uint8_t>(attr_names[data::AttrMap::attr_index_uint8][i]);
-        }
-      for (size_t i=0; i<num_attrs[data::AttrMap::attr_index_int8]; i++)
-        {
-          attr_map.insert_name<int8_t>(attr_names[data::AttrMap::attr_index_int8][i]);
-        }
-      for (size_t i=0; i<num_attrs[data::AttrMap::attr_index_uint16]; i++)
-        {
-          attr_map.insert_name<uint16_t>(attr_names[data::AttrMap::attr_index_uint16][i]);
-        }
-      for (size_t i=0; i<num_attrs[data::AttrMap::attr_index_int16]; i++)
-        {
-          attr_map.insert_name<int16_t>(attr_names[data::AttrMap::attr_index_int16][i]);
-        }
-      for (size_t i=0; i<num_attrs[data::AttrMap::attr_index_uint32]; i++)
+
+      size_t segment_size = 0;
+      for (const shared_attr_shape_t& shape : attr_shapes)
         {
-          attr_map.insert_name<uint32_t>(attr_names[data::AttrMap::attr_index_uint32][i]);
+          segment_size = mpi::SharedSegment::align(segment_size) + get<2>(shape) * sizeof(CELL_IDX_T);
+          segment_size = mpi::SharedSegment::align(segment_size) + get<3>(shape) * sizeof(ATTR_PTR_T);
+          segment_size = mpi::SharedSegment::align(segment_size) + get<4>(shape) * attr_type_size(get<1>(shape));
         }
-      for (size_t i=0; i<num_attrs[data::AttrMap::attr_index_int32]; i++)
+      auto segment = make_shared<mpi::SharedSegment>(comm, segment_size, root);
+
+      if (segment->is_root())
         {
-          attr_map.insert_name<int32_t>(attr_names[data::AttrMap::attr_index_int32][i]);
-        }
+          char* base = segment->data();
+          size_t pos = 0;
+          // position of the values of each type in values
+          vector<size_t> type_pos(data::AttrVal::num_attr_types, 0);
+          for (size_t i=0; i<attr_shapes.size(); i++)
+            {
+              mpi::pack_column(base, pos, value_indexes[i].data(), value_indexes[i].size());
+              mpi::pack_column(base, pos, value_ptrs[i].data(), value_ptrs[i].size());
 
-      size_t sendrecvbuf_size = sendrecvbuf.size();
-      throw_assert_nomsg(MPI_Bcast(&sendrecvbuf_size, 1, MPI_SIZE_T, root, comm) == MPI_SUCCESS);
-      throw_assert_nomsg(MPI_Barrier(comm) == MPI_SUCCESS);
-      sendrecvbuf.resize(sendrecvbuf_size);
-      throw_assert_nomsg(MPI_Bcast(&sendrecvbuf[0], sendrecvbuf_size, MPI_CHAR, root, comm) == MPI_SUCCESS);
+              size_t type_index = get<1>(attr_shapes[i]);
+              size_t k = type_pos[type_index]++;
+              switch (type_index)
+                {
+                case data::AttrVal::attr_index_float:
+                  mpi::pack_column(base, pos, values.const_attr_vec<float>(k).data(), get<4>(attr_shapes[i]));
+                  break;
+                case data::AttrVal::attr_index_uint8:
+                  mpi::pack_column(base, pos, values.const_attr_vec<uint8_t>(k).data(), get<4>(attr_shapes[i]));
+                  break;
+                case data::AttrVal::attr_index_int8:
+                  mpi::pack_column(base, pos, values.const_attr_vec<int8_t>(k).data(), get<4>(attr_shapes[i]));
+                  break;
+                case data::AttrVal::attr_index_uint16:
+                  mpi::pack_column(base, pos, values.const_attr_vec<uint16_t>(k).data(), get<4>(attr_shapes[i]));
+                  break;
+                case data::AttrVal::attr_index_int16:
+                  mpi::pack_column(base, pos, values.const_attr_vec<int16_t>(k).data(), get<4>(attr_shapes[i]));
+                  break;
+                case data::AttrVal::attr_index_uint32:
+                  mpi::pack_column(base, pos, values.const_attr_vec<uint32_t>(k).data(), get<4>(attr_shapes[i]));
+                  break;
+                case data::AttrVal::attr_index_int32:
+                  mpi::pack_column(base, pos, values.const_attr_vec<int32_t>(k).data(), get<4>(attr_shapes[i]));
+                  break;
+                }
+            }
+          throw_assert(pos == segment->size(),
+                       "bcast_cell_attributes_shared: packed size mismatch");
+        }
 
+      segment->bcast();
 
-      if (rank != (unsigned int)root)
+      size_t pos = 0;
+      for (const shared_attr_shape_t& shape : attr_shapes)
         {
-          data::deserialize_data(sendrecvbuf, attr_map);
+          switch (get<1>(shape))
+            {
+            case data::AttrVal::attr_index_float:
+              view_shared_cell_attribute<float>(segment, pos, shape, attr_values);
+              break;
+            case data::AttrVal::attr_index_uint8:
+              view_shared_cell_attribute<uint8_t>(segment, pos, shape, attr_values);
+              break;
+            case data::AttrVal::attr_index_int8:
+              view_shared_cell_attribute<int8_t>(segment, pos, shape, attr_values);
+              break;
+            case data::AttrVal::attr_index_uint16:
+              view_shared_cell_attribute<uint16_t>(segment, pos, shape, attr_values);
+              break;
+            case data::AttrVal::attr_index_int16:
+              view_shared_cell_attribute<int16_t>(segment, pos, shape, attr_values);
+              break;
+            case data::AttrVal::attr_index_uint32:
+              view_shared_cell_attribute<uint32_t>(segment, pos, shape, attr_values);
+              break;
+            case data::AttrVal::attr_index_int32:
+              view_shared_cell_attribute<int32_t>(segment, pos, shape, attr_values);
+              break;
+            }
         }
-      throw_assert_nomsg(MPI_Barrier(comm) == MPI_SUCCESS);
     }
 
       
@@ -1371,60 +2353,23 @@ namespace neuroh5
       throw_assert_nomsg(MPI_Comm_size(comm, (int*)&size) >= 0);
       throw_assert_nomsg(MPI_Comm_rank(comm, (int*)&rank) >= 0);
 
-      vector< tuple<string,AttrKind,vector<CELL_IDX_T>,vector<ATTR_PTR_T> > > attr_info;
-
-      if (rank == 0)
-        {
-          status = get_cell_attribute_index_ptr (file_name, name_space, pop_name, pop_start, attr_info);
-          throw_assert(status == 0,
-                       "read_cell_attributes: error in get_cell_attribute_index_ptr");
-        }
-      // Broadcast the attribute names, types, indices, and pointers
-      {
-        vector<char> sendbuf; size_t sendbuf_size=0;
-        if (rank == 0)
-          {
-            data::serialize_data(attr_info, sendbuf);
-            sendbuf_size = sendbuf.size();
-          }
-
-        throw_assert(MPI_Bcast(&sendbuf_size, 1, MPI_SIZE_T, 0, comm) == MPI_SUCCESS,
-                     "read_cell_attributes: error in MPI_Bcast");
-        sendbuf.resize(sendbuf_size);
-        throw_assert(MPI_Bcast(&sendbuf[0], sendbuf_size, MPI_CHAR, 0, comm) == MPI_SUCCESS,
-                     "read_cell_attributes: error in MPI_Bcast");
-        
-        if (rank != 0)
-          {
-            data::deserialize_data(sendbuf, attr_info);
-          }
-      }
+      shared_ptr<const data::CellAttributeIndex> attr_index =
+        get_cell_attribute_sorted_index(comm, file_name, name_space, pop_name, pop_start);
 
-      // get a file handle and retrieve the MPI info
-      hid_t fapl = H5Pcreate(H5P_FILE_ACCESS);
-#ifdef HDF5_IS_PARALLEL
-      throw_assert(H5Pset_fapl_mpio(fapl, comm, MPI_INFO_NULL) >= 0,
-                   "read_cell_attribute_selection: error setting MPI driver for file access");
-#endif
-      
-      hid_t file = H5Fopen(file_name.c_str(), H5F_ACC_RDONLY, fapl);
+      // get a file handle (the file of a session if one is open)
+      hid_t file = hdf5::open_file(comm, file_name, true);
       throw_assert(file >= 0,
                    "read_cell_attribute_selection: unable to open file " << file_name);
       
-      status = H5Pclose(fapl);
-      throw_assert(status == 0,
-                   "read_cell_attribute_selection: unable to close file access property list");
-      
-      for (size_t i=0; i<attr_info.size(); i++)
+      for (size_t i=0; i<attr_index->attributes.size(); i++)
         {
           vector<ATTR_PTR_T> value_ptr;
           vector<CELL_IDX_T> value_index;
           
-          string attr_name  = get<0>(attr_info[i]);
-          AttrKind attr_kind = get<1>(attr_info[i]);
+          string attr_name  = attr_index->attributes[i].first;
+          AttrKind attr_kind = attr_index->attributes[i].second;
           size_t attr_size  = attr_kind.size;
-          const vector<CELL_IDX_T>& index  = get<2>(attr_info[i]);
-          const vector<ATTR_PTR_T>& ptr  = get<3>(attr_info[i]);
+          const data::SortedCellIndex& sorted_index = *(attr_index->indices[i]);
           string attr_path  = hdf5::cell_attribute_path (name_space, pop_name, attr_name);
           if ((attr_mask.size() > 0) && (attr_mask.count(attr_name) == 0))
             continue;
@@ -1437,7 +2382,7 @@ namespace neuroh5
                   {
                     vector<uint32_t> attr_values_uint32;
                     status = hdf5::read_cell_attribute_selection(comm, file, attr_path, pop_start,
-                                                                 selection, index, ptr, value_index, value_ptr,
+                                                                 selection, sorted_index, value_index, value_ptr,
                                                                  attr_values_uint32);
                     attr_values.insert(attr_name, value_index, value_ptr, attr_values_uint32);
                   }
@@ -1445,7 +2390,7 @@ namespace neuroh5
                   {
                     vector<uint16_t> attr_values_uint16;
                     status = hdf5::read_cell_attribute_selection(comm, file, attr_path, pop_start,
-                                                                 selection, index, ptr, value_index, value_ptr,
+                                                                 selection, sorted_index, value_index, value_ptr,
                                                                  attr_values_uint16);
                     attr_values.insert(attr_name, value_index, value_ptr, attr_values_uint16);
                   }
@@ -1453,7 +2398,7 @@ namespace neuroh5
                   {
                     vector<uint8_t> attr_values_uint8;
                     status = hdf5::read_cell_attribute_selection(comm, file, attr_path, pop_start,
-                                                                 selection, index, ptr, value_index, value_ptr,
+                                                                 selection, sorted_index, value_index, value_ptr,
                                                                  attr_values_uint8);
                     attr_values.insert(attr_name, value_index, value_ptr, attr_values_uint8);
                   }
@@ -1469,7 +2414,7 @@ namespace neuroh5
                   {
                     vector<int32_t> attr_values_int32;
                     status = hdf5::read_cell_attribute_selection(comm, file, attr_path, pop_start,
-                                                                 selection, index, ptr, value_index, value_ptr,
+                                                                 selection, sorted_index, value_index, value_ptr,
                                                                  attr_values_int32);
                     attr_values.insert(attr_name, value_index, value_ptr, attr_values_int32);
                   }
@@ -1477,7 +2422,7 @@ namespace neuroh5
                   {
                     vector<int16_t> attr_values_int16;
                     status = hdf5::read_cell_attribute_selection(comm, file, attr_path, pop_start,
-                                                                 selection, index, ptr, value_index, value_ptr,
+                                                                 selection, sorted_index, value_index, value_ptr,
                                                                  attr_values_int16);
                     attr_values.insert(attr_name, value_index, value_ptr, attr_values_int16);
                   }
@@ -1485,7 +2430,7 @@ namespace neuroh5
                   {
                     vector<int8_t> attr_values_int8;
                     status = hdf5::read_cell_attribute_selection(comm, file, attr_path, pop_start,
-                                                                 selection, index, ptr, value_index, value_ptr,
+                                                                 selection, sorted_index, value_index, value_ptr,
                                                                  attr_values_int8);
                     attr_values.insert(attr_name, value_index, value_ptr, attr_values_int8);
                   }
@@ -1499,7 +2444,7 @@ namespace neuroh5
               {
                 vector<float> attr_values_float;
                 status = hdf5::read_cell_attribute_selection(comm, file, attr_path, pop_start,
-                                                             selection, index, ptr, value_index, value_ptr,
+                                                             selection, sorted_index, value_index, value_ptr,
                                                              attr_values_float);
                 attr_values.insert(attr_name, value_index, value_ptr, attr_values_float);
               }
@@ -1510,7 +2455,7 @@ namespace neuroh5
                   {
                     vector<uint8_t> attr_values_uint8;
                     status = hdf5::read_cell_attribute_selection(comm, file, attr_path, pop_start,
-                                                                 selection, index, ptr, value_index, value_ptr,
+                                                                 selection, sorted_index, value_index, value_ptr,
                                                                  attr_values_uint8);
                     attr_values.insert(attr_name, value_index, value_ptr, attr_values_uint8);
                   }
@@ -1527,7 +2472,7 @@ namespace neuroh5
           
         }
       
-      status = H5Fclose(file);
+      status = hdf5::close_file(file);
       throw_assert(status == 0,
                    "read_cell_attribute_selection: unable to close file " << file_name);
     }
@@ -1616,7 +2561,7 @@ namespace neuroh5
         io_data_size = size;
       
       set<size_t> io_rank_set;
-      data::range_sample(size, io_data_size, io_rank_set);
+      mpi::select_io_ranks(comm, io_data_size, io_rank_set);
       bool is_io_rank = (io_rank_set.find(rank) != io_rank_set.end());
       
       // I/O rank with lowest data rank 
@@ -1752,6 +2697,303 @@ namespace neuroh5
       recvbuf.clear();
     }
 
+    // Attribute maps of one value type received by an I/O rank, with
+    // stable storage for the vectors referenced by CellAttributeAppend
+    template <typename T>
+    struct AttributeMapExchange
+    {
+      deque< vector<CELL_IDX_T> > index;
+      deque< vector<ATTR_PTR_T> > attr_ptr;
+      deque< vector<T> >          values;
+
+      void exchange (MPI_Comm comm,
+                     const map<string, map<CELL_IDX_T, deque<T> >>& attr_values,
+                     const set<size_t>& io_rank_set,
+                     const data::optional_hid data_type,
+                     const CellIndex index_type,
+                     const CellPtr ptr_type,
+                     vector<hdf5::CellAttributeAppend>& attrs)
+      {
+        for (auto it = attr_values.cbegin(); it != attr_values.cend(); ++it)
+          {
+            index.emplace_back();
+            attr_ptr.emplace_back();
+            values.emplace_back();
+            exchange_cell_attribute_map<T>(comm, it->second, io_rank_set,
+                                           index.back(), attr_ptr.back(), values.back());
+            attrs.push_back(hdf5::cell_attribute_append<T>(it->first, index.back(), attr_ptr.back(),
+                                                           values.back(), data_type,
+                                                           index_type, ptr_type));
+          }
+      }
+    };
+
+    void append_cell_attributes
+    (
+     MPI_Comm                                  comm,
+     const hid_t&                              loc,
+     const std::string&                        attr_namespace,
+     const std::string&                        pop_name,
+     const CELL_IDX_T&                         pop_start,
+     const std::vector<hdf5::CellAttributeAppend>& attrs,
+     const size_t chunk_size,
+     const size_t value_chunk_size,
+     const hdf5::DatasetCreationPolicy& dataset_policy
+     )
+    {
+      hid_t file = H5Iget_file_id(loc);
+      throw_assert(file >= 0,
+                   "append_cell_attributes: invalid file handle");
+
+      // cell ids relative to the population start
+      deque< vector<CELL_IDX_T> > rindexes;
+      vector<hdf5::CellAttributeAppend> rattrs;
+      for (const hdf5::CellAttributeAppend& attr : attrs)
+        {
+          string attr_path = hdf5::cell_attribute_path(attr_namespace, pop_name, attr.attr_name);
+          if (!(hdf5::exists_dataset (file, attr_path) > 0))
+            {
+              create_cell_attribute_datasets(file, attr_namespace, pop_name, attr.attr_name,
+                                             attr.ftype, attr.index_type, attr.ptr_type,
+                                             chunk_size, value_chunk_size, dataset_policy);
+            }
+
+          rindexes.emplace_back();
+          vector<CELL_IDX_T>& rindex = rindexes.back();
+          rindex.reserve(attr.index->size());
+          for (const CELL_IDX_T& gid: *attr.index)
+            {
+              throw_assert(gid >= pop_start,
+                           "append_cell_attributes: invalid gid");
+              rindex.push_back(gid - pop_start);
+            }
+          rattrs.push_back(attr);
+          rattrs.back().index = &rindex;
+        }
+
+      hdf5::append_cell_attributes(comm, file, attr_namespace, pop_name, rattrs);
+
+      throw_assert(H5Fclose(file) == 0,
+                   "append_cell_attributes: unable to close HDF5 file");
+    }
+
+
+    // Sends the cells of a flat attribute to the I/O ranks of
+    // io_rank_set, as exchange_cell_attribute_map does with an
+    // attribute map; the values are exchanged as raw bytes
+    static void exchange_cell_attribute_array
+    (
+     MPI_Comm                           comm,
+     const hdf5::CellAttributeAppend&   attr,
+     const set<size_t>&                 io_rank_set,
+     vector<CELL_IDX_T>&                gid_recvbuf,
+     vector<ATTR_PTR_T>&                attr_ptr,
+     vector<char>&                      value_recvbuf
+     )
+    {
+      int ssize=0, srank=0; size_t size=0, rank=0; size_t io_size=io_rank_set.size();
+      throw_assert(MPI_Comm_size(comm, &ssize) == MPI_SUCCESS, "error in MPI_Comm_size");
+      throw_assert(MPI_Comm_rank(comm, &srank) == MPI_SUCCESS, "error in MPI_Comm_rank");
+      rank = srank;
+      size = ssize;
+      throw_assert(io_size <= size, "invalid io_size");
+
+      const vector<CELL_IDX_T>& local_index_vector = *attr.index;
+      const vector<ATTR_PTR_T>& local_attr_ptr = *attr.attr_ptr;
+      throw_assert(local_attr_ptr.size() == local_index_vector.size() + 1,
+                   "exchange_cell_attribute_array: attribute " << attr.attr_name
+                   << ": size of attribute pointer must be the number of cells + 1");
+      throw_assert(local_attr_ptr.back() <= attr.num_values,
+                   "exchange_cell_attribute_array: attribute " << attr.attr_name
+                   << ": attribute pointer out of range");
+
+      vector< pair<hsize_t,hsize_t> > ranges;
+      mpi::rank_ranges(size, io_size, ranges);
+
+      // Determine the I/O rank to which to send the values
+      size_t io_dest = 0;
+      for (size_t i=ranges.size(); i-- > 0; )
+        {
+          if (ranges[i].first <= rank)
+            {
+              io_dest = *std::next(io_rank_set.begin(), i);
+              break;
+            }
+        }
+
+      vector<ATTR_PTR_T> local_attr_size_vector;
+      local_attr_size_vector.reserve(local_index_vector.size());
+      for (size_t i=0; i<local_index_vector.size(); i++)
+        {
+          throw_assert(local_attr_ptr[i] <= local_attr_ptr[i+1],
+                       "exchange_cell_attribute_array: attribute " << attr.attr_name
+                       << ": attribute pointer must be non-decreasing");
+          local_attr_size_vector.push_back(local_attr_ptr[i+1] - local_attr_ptr[i]);
+        }
+
+      gid_recvbuf.clear();
+      {
+        vector<size_t> idx_sendcounts(size, 0), idx_sdispls(size, 0), idx_recvcounts(size, 0), idx_rdispls(size, 0);
+        idx_sendcounts[io_dest] = local_index_vector.size();
+
+        mpi::PhaseTimer timer("alltoallv");
+        throw_assert(mpi::alltoallv_vector<CELL_IDX_T>(comm, MPI_CELL_IDX_T,
+                                                       idx_sendcounts, idx_sdispls, local_index_vector,
+                                                       idx_recvcounts, idx_rdispls, gid_recvbuf) >= 0,
+                     "exchange_cell_attribute_array: error in MPI_Alltoallv");
+      }
+
+      attr_ptr.clear();
+      {
+        vector<ATTR_PTR_T> attr_size_recvbuf;
+        vector<size_t> attr_size_sendcounts(size, 0), attr_size_sdispls(size, 0), attr_size_recvcounts(size, 0), attr_size_rdispls(size, 0);
+        attr_size_sendcounts[io_dest] = local_attr_size_vector.size();
+
+        {
+          mpi::PhaseTimer timer("alltoallv");
+          throw_assert(mpi::alltoallv_vector<ATTR_PTR_T>(comm, MPI_ATTR_PTR_T,
+                                                         attr_size_sendcounts, attr_size_sdispls, local_attr_size_vector,
+                                                         attr_size_recvcounts, attr_size_rdispls, attr_size_recvbuf) >= 0,
+                       "exchange_cell_attribute_array: error in MPI_Alltoallv");
+        }
+
+        if (attr_size_recvbuf.size() > 0)
+          {
+            ATTR_PTR_T attr_ptr_offset = 0;
+            attr_ptr.reserve(attr_size_recvbuf.size() + 1);
+            for (const ATTR_PTR_T this_attr_size : attr_size_recvbuf)
+              {
+                attr_ptr.push_back(attr_ptr_offset);
+                attr_ptr_offset += this_attr_size;
+              }
+            attr_ptr.push_back(attr_ptr_offset);
+          }
+      }
+
+      value_recvbuf.clear();
+      {
+        const char* values = static_cast<const char*>(attr.values);
+        vector<char> local_value_vector(values + local_attr_ptr.front() * attr.value_size,
+                                        values + local_attr_ptr.back() * attr.value_size);
+
+        vector<size_t> value_sendcounts(size, 0), value_sdispls(size, 0), value_recvcounts(size, 0), value_rdispls(size, 0);
+        value_sendcounts[io_dest] = local_value_vector.size();
+
+        mpi::PhaseTimer timer("alltoallv");
+        throw_assert(mpi::alltoallv_vector<char>(comm, MPI_CHAR,
+                                                 value_sendcounts, value_sdispls, local_value_vector,
+                                                 value_recvcounts, value_rdispls, value_recvbuf) >= 0,
+                     "exchange_cell_attribute_array: error in MPI_Alltoallv");
+      }
+    }
+
+
+    void append_cell_attribute_arrays
+    (
+     MPI_Comm                                  comm,
+     const std::string&                        file_name,
+     const std::string&                        attr_namespace,
+     const std::string&                        pop_name,
+     const CELL_IDX_T&                         pop_start,
+     const std::vector<hdf5::CellAttributeAppend>& attrs,
+     const size_t io_size,
+     const size_t chunk_size,
+     const size_t value_chunk_size,
+     const size_t cache_size,
+     const hdf5::DatasetCreationPolicy& dataset_policy
+     )
+    {
+      mpi::PhaseTimer timer("append_cell_attribute_arrays");
+
+      herr_t status;
+      int ssize, srank; size_t size, rank; size_t io_size_value=0;
+      throw_assert(MPI_Comm_size(comm, &ssize) == MPI_SUCCESS, "error in MPI_Comm_size");
+      throw_assert(MPI_Comm_rank(comm, &srank) == MPI_SUCCESS, "error in MPI_Comm_rank");
+      throw_assert(ssize > 0, "invalid MPI comm size");
+      throw_assert(srank >= 0, "invalid MPI comm rank");
+      rank = srank;
+      size = ssize;
+
+      if (size < io_size)
+        {
+          io_size_value = size;
+        }
+      else
+        {
+          io_size_value = io_size;
+        }
+
+      set<size_t> io_rank_set;
+      data::range_sample(size, io_size_value, io_rank_set);
+      bool is_io_rank = (io_rank_set.find(rank) != io_rank_set.end());
+      throw_assert(io_rank_set.size() > 0, "invalid I/O rank set");
+
+      // MPI Communicator for I/O ranks
+      MPI_Comm io_comm;
+      MPI_Comm_split(comm,is_io_rank ? 1 : 0,rank,&io_comm);
+      MPI_Comm_set_errhandler(io_comm, MPI_ERRORS_RETURN);
+
+      if (is_io_rank)
+        {
+          if (access( file_name.c_str(), F_OK ) != 0)
+            {
+              vector <string> groups;
+              groups.push_back (hdf5::POPULATIONS);
+              status = hdf5::create_file_toplevel (io_comm, file_name, groups);
+            }
+          else
+            {
+              status = 0;
+            }
+          throw_assert(status == 0,
+                       "append_cell_attribute_arrays: unable to create toplevel groups in file");
+        }
+
+      throw_assert(MPI_Barrier(comm) == MPI_SUCCESS, "error in MPI_Barrier");
+
+      hid_t file;
+      if (is_io_rank)
+        {
+          file = hdf5::open_file(io_comm, file_name, true, true, cache_size);
+        }
+
+      // exchange every attribute to the I/O ranks, then append all of
+      // them with one fused write
+      deque< vector<CELL_IDX_T> > index;
+      deque< vector<ATTR_PTR_T> > attr_ptr;
+      deque< vector<char> >       values;
+      vector<hdf5::CellAttributeAppend> io_attrs;
+      {
+        mpi::PhaseTimer timer("exchange_cell_attribute_arrays");
+        for (const hdf5::CellAttributeAppend& attr : attrs)
+          {
+            index.emplace_back();
+            attr_ptr.emplace_back();
+            values.emplace_back();
+            exchange_cell_attribute_array(comm, attr, io_rank_set,
+                                          index.back(), attr_ptr.back(), values.back());
+            hdf5::CellAttributeAppend io_attr = attr;
+            io_attr.index = &index.back();
+            io_attr.attr_ptr = &attr_ptr.back();
+            io_attr.values = values.back().data();
+            io_attr.num_values = values.back().size() / attr.value_size;
+            io_attrs.push_back(io_attr);
+          }
+      }
+
+      if (is_io_rank)
+        {
+          cell::append_cell_attributes(io_comm, file, attr_namespace, pop_name, pop_start, io_attrs,
+                                       chunk_size, value_chunk_size, dataset_policy);
+          hdf5::close_file(file);
+        }
+
+      throw_assert(MPI_Barrier(comm) == MPI_SUCCESS, "error in MPI_Barrier");
+      throw_assert(MPI_Comm_free(&io_comm) == MPI_SUCCESS,
+                   "append_cell_attribute_arrays: error in MPI_Comm_free");
+    }
+
+
     void append_cell_attribute_maps (
                                      MPI_Comm                        comm,
                                      const std::string&              file_name,
@@ -1771,9 +3013,12 @@ namespace neuroh5
                                      const CellPtr                   ptr_type,
                                      const size_t chunk_size,
                                      const size_t value_chunk_size,
-                                     const size_t cache_size
+                                     const size_t cache_size,
+                                     const hdf5::DatasetCreationPolicy& dataset_policy
                                      )
     {
+      mpi::PhaseTimer timer("append_cell_attribute_maps");
+
       herr_t status;
       int ssize, srank; size_t size, rank; size_t io_size_value=0;
       throw_assert(MPI_Comm_size(comm, &ssize) == MPI_SUCCESS, "error in MPI_Comm_size");
@@ -1840,62 +3085,32 @@ namespace neuroh5
         file = hdf5::open_file(io_comm, file_name, true, true, cache_size);
       }
       
-      for(auto it = attr_values_float.cbegin(); it != attr_values_float.cend(); ++it)
-        {
-          const string& attr_name = it->first;
-          cell::append_cell_attribute_map<float> (comm, file, attr_namespace, pop_name, pop_start,
-                                                  attr_name, it->second, data_type, io_rank_set,
-                                                  index_type, ptr_type,
-                                                  chunk_size, value_chunk_size, cache_size);
-        }
-      for(auto it = attr_values_uint32.cbegin(); it != attr_values_uint32.cend(); ++it)
-        {
-          const string& attr_name = it->first;
-          cell::append_cell_attribute_map<uint32_t> (comm, file, attr_namespace, pop_name, pop_start,
-                                                     attr_name, it->second, data_type, io_rank_set,
-                                                     index_type, ptr_type,
-                                                     chunk_size, value_chunk_size, cache_size);
-        }
-      for(auto it = attr_values_uint16.cbegin(); it != attr_values_uint16.cend(); ++it)
+      // exchange every attribute to the I/O ranks, then append all of
+      // them with one fused write
+      AttributeMapExchange<float> float_values;
+      AttributeMapExchange<uint32_t> uint32_values;
+      AttributeMapExchange<uint16_t> uint16_values;
+      AttributeMapExchange<uint8_t> uint8_values;
+      AttributeMapExchange<int32_t> int32_values;
+      AttributeMapExchange<int16_t> int16_values;
+      AttributeMapExchange<int8_t> int8_values;
+      vector<hdf5::CellAttributeAppend> attrs;
+      {
+        mpi::PhaseTimer timer("exchange_cell_attribute_maps");
+        float_values.exchange(comm, attr_values_float, io_rank_set, data_type, index_type, ptr_type, attrs);
+        uint32_values.exchange(comm, attr_values_uint32, io_rank_set, data_type, index_type, ptr_type, attrs);
+        uint16_values.exchange(comm, attr_values_uint16, io_rank_set, data_type, index_type, ptr_type, attrs);
+        uint8_values.exchange(comm, attr_values_uint8, io_rank_set, data_type, index_type, ptr_type, attrs);
+        int32_values.exchange(comm, attr_values_int32, io_rank_set, data_type, index_type, ptr_type, attrs);
+        int16_values.exchange(comm, attr_values_int16, io_rank_set, data_type, index_type, ptr_type, attrs);
+        int8_values.exchange(comm, attr_values_int8, io_rank_set, data_type, index_type, ptr_type, attrs);
+      }
+
+      if (is_io_rank)
         {
-          const string& attr_name = it->first;
-          cell::append_cell_attribute_map<uint16_t> (comm, file, attr_namespace, pop_name, pop_start,
-                                                     attr_name, it->second, data_type, io_rank_set,
-                                                     index_type, ptr_type,
-                                                     chunk_size, value_chunk_size, cache_size);
+          cell::append_cell_attributes(io_comm, file, attr_namespace, pop_name, pop_start, attrs,
+                                       chunk_size, value_chunk_size, dataset_policy);
         }
-      for(auto it = attr_values_uint8.cbegin(); it != attr_values_uint8.cend(); ++it)
-        {
-          const string& attr_name = it->first;
-          cell::append_cell_attribute_map<uint8_t> (comm, file, attr_namespace, pop_name, pop_start,
-                                                    attr_name, it->second, data_type, io_rank_set,
-                                                    index_type, ptr_type,
-                                                    chunk_size, value_chunk_size, cache_size);
-          }
-        for(auto it = attr_values_int32.cbegin(); it != attr_values_int32.cend(); ++it)
-          {
-            const string& attr_name = it->first;
-            cell::append_cell_attribute_map<int32_t> (comm, file, attr_namespace, pop_name, pop_start,
-                                                      attr_name, it->second, data_type, io_rank_set,
-                                                      index_type, ptr_type,
-                                                      chunk_size, value_chunk_size, cache_size);
-          }
-        for(auto it = attr_values_int16.cbegin(); it != attr_values_int16.cend(); ++it)
-          {
-            const string& attr_name = it->first;
-            cell::append_cell_attribute_map<int16_t> (comm, file, attr_namespace, pop_name, pop_start,
-                                                      attr_name, it->second, data_type, io_rank_set,
-                                                      index_type, ptr_type,
-                                                      chunk_size, value_chunk_size, cache_size);
-          }
-        for(auto it = attr_values_int8.cbegin(); it != attr_values_int8.cend(); ++it)
-          {
-            const string& attr_name = it->first;
-            cell::append_cell_attribute_map<int8_t> (comm, file, attr_namespace, pop_name, pop_start,
-                                                     attr_name, it->second, data_type, io_rank_set,
-                                                     index_type, ptr_type,
-                                                     chunk_size, value_chunk_size, cache_size);
-          }
 
         if (is_io_rank)
           {
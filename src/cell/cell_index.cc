@@ -19,6 +19,7 @@
 #include "cell_index.hh"
 #include "file_access.hh"
 #include "create_group.hh"
+#include "dataset_creation.hh"
 #include "path_names.hh"
 #include "read_template.hh"
 #include "write_template.hh"
@@ -39,7 +40,8 @@ namespace neuroh5
      const string&        file_name,
      const string&        pop_name,
      const string&        attr_name_space,
-     const size_t         chunk_size
+     const size_t         chunk_size,
+     const hdf5::DatasetCreationPolicy& dataset_policy
      )
     {
       herr_t ierr = 0;
@@ -78,20 +80,14 @@ namespace neuroh5
             {
               
               hsize_t maxdims[1] = {H5S_UNLIMITED};
-              hsize_t cdims[1]   = {chunk_size}; /* chunking dimensions */		
               hsize_t initial_size = 0;
               
-              hid_t plist  = H5Pcreate (H5P_DATASET_CREATE);
-              ierr = H5Pset_chunk(plist, 1, cdims);
-              throw_assert_nomsg(ierr == 0);
+              hid_t plist  = hdf5::create_dataset_creation_plist(dataset_policy, hdf5::DatasetIndex,
+                                                                 chunk_size);
 
               ierr = H5Pset_alloc_time(plist, H5D_ALLOC_TIME_EARLY);
               throw_assert_nomsg(ierr == 0);
 
-#ifdef H5_HAS_PARALLEL_DEFLATE
-              ierr = H5Pset_deflate(plist, 9);
-              throw_assert_nomsg(ierr == 0);
-#endif
               
               hid_t lcpl = H5Pcreate(H5P_LINK_CREATE);
               throw_assert_nomsg(lcpl >= 0);
@@ -103,6 +99,8 @@ namespace neuroh5
                                       mspace, lcpl, plist, H5P_DEFAULT);
               throw_assert_nomsg(H5Dclose(dset) >= 0);
               throw_assert_nomsg(H5Sclose(mspace) >= 0);
+              throw_assert_nomsg(H5Pclose(lcpl) >= 0);
+              throw_assert_nomsg(H5Pclose(plist) >= 0);
             }
               
           ierr = H5Fclose (file);
@@ -121,7 +119,8 @@ namespace neuroh5
      hid_t                loc,
      const string&        pop_name,
      const string&        attr_name_space,
-     const size_t         chunk_size
+     const size_t         chunk_size,
+     const hdf5::DatasetCreationPolicy& dataset_policy
      )
     {
       herr_t ierr = 0;
@@ -159,20 +158,14 @@ namespace neuroh5
         {
           
           hsize_t maxdims[1] = {H5S_UNLIMITED};
-          hsize_t cdims[1]   = {chunk_size}; /* chunking dimensions */		
           hsize_t initial_size = 0;
           
-          hid_t plist  = H5Pcreate (H5P_DATASET_CREATE);
-          ierr = H5Pset_chunk(plist, 1, cdims);
-          throw_assert_nomsg(ierr == 0);
+          hid_t plist  = hdf5::create_dataset_creation_plist(dataset_policy, hdf5::DatasetIndex,
+                                                             chunk_size);
           
           ierr = H5Pset_alloc_time(plist, H5D_ALLOC_TIME_EARLY);
           throw_assert_nomsg(ierr == 0);
           
-#ifdef H5_HAS_PARALLEL_DEFLATE
-          ierr = H5Pset_deflate(plist, 9);
-          throw_assert_nomsg(ierr == 0);
-#endif
           
           hid_t lcpl = H5Pcreate(H5P_LINK_CREATE);
           throw_assert_nomsg(lcpl >= 0);
@@ -184,6 +177,8 @@ namespace neuroh5
                                   mspace, lcpl, plist, H5P_DEFAULT);
           throw_assert_nomsg(H5Dclose(dset) >= 0);
           throw_assert_nomsg(H5Sclose(mspace) >= 0);
+          throw_assert_nomsg(H5Pclose(lcpl) >= 0);
+          throw_assert_nomsg(H5Pclose(plist) >= 0);
         }
       
       ierr = H5Fclose (file);
@@ -258,7 +253,9 @@ namespace neuroh5
      const string&        pop_name,
      const CELL_IDX_T&    pop_start,
      const string&        attr_name_space,
-     const vector<CELL_IDX_T>&  cell_index
+     const vector<CELL_IDX_T>&  cell_index,
+     const size_t         chunk_size,
+     const hdf5::DatasetCreationPolicy& dataset_policy
      )
     {
       herr_t ierr = 0;
@@ -275,7 +272,8 @@ namespace neuroh5
       hid_t file = hdf5::open_file(comm, file_name, true, true);
       throw_assert_nomsg(file >= 0);
 
-      ierr = append_cell_index(comm, file, pop_name, pop_start, attr_name_space, cell_index);
+      ierr = append_cell_index(comm, file, pop_name, pop_start, attr_name_space, cell_index,
+                               chunk_size, dataset_policy);
       throw_assert_nomsg(ierr == 0);
       hdf5::close_file(file);
 
@@ -290,7 +288,9 @@ namespace neuroh5
      const string&        pop_name,
      const CELL_IDX_T&    pop_start,
      const string&        attr_name_space,
-     const vector<CELL_IDX_T>&  cell_index
+     const vector<CELL_IDX_T>&  cell_index,
+     const size_t         chunk_size,
+     const hdf5::DatasetCreationPolicy& dataset_policy
      )
     {
       herr_t ierr = 0;
@@ -334,7 +334,8 @@ namespace neuroh5
           global_index_size = global_index_size + index_size_vector[i];
         }
 
-      ierr = create_cell_index(comm, file, pop_name, attr_name_space);
+      ierr = create_cell_index(comm, file, pop_name, attr_name_space,
+                               chunk_size, dataset_policy);
 #ifdef NEUROH5_DEBUG
       throw_assert_nomsg(MPI_Barrier(comm) == MPI_SUCCESS);
 #endif      
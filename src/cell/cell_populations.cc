@@ -20,6 +20,8 @@
 #include "path_names.hh"
 #include "throw_assert.hh"
 #include "exists_group.hh"
+#include "file_access.hh"
+#include "file_session.hh"
 
 #define MAX_POP_NAME_LEN 1024
 
@@ -64,57 +66,65 @@ namespace neuroh5
       // MPI rank 0 reads and broadcasts the names of populations
       hid_t grp = -1;
 
-      // Rank 0 reads the names of populations and broadcasts
-      if (rank == 0)
+      hdf5::FileSession* session = hdf5::FileSession::find(comm, file_name);
+      if ((session == nullptr) || !session->find_metadata("population_names", pop_names))
         {
+          // Rank 0 reads the names of populations and broadcasts
+          if (rank == 0)
+            {
           
-          hid_t file = H5Fopen(file_name.c_str(), H5F_ACC_RDONLY, H5P_DEFAULT);
-          throw_assert_nomsg(file >= 0);
+              hid_t file = hdf5::open_file(comm, file_name);
+              throw_assert_nomsg(file >= 0);
           
-          hsize_t num_populations;
-          if (hdf5::exists_group(file, hdf5::POPULATIONS.c_str()))
-            {
-              grp = H5Gopen(file, hdf5::POPULATIONS.c_str(), H5P_DEFAULT);
-              throw_assert_nomsg(grp >= 0);
-              throw_assert_nomsg(H5Gget_num_objs(grp, &num_populations)>=0);
+              hsize_t num_populations;
+              if (hdf5::exists_group(file, hdf5::POPULATIONS.c_str()))
+                {
+                  grp = H5Gopen(file, hdf5::POPULATIONS.c_str(), H5P_DEFAULT);
+                  throw_assert_nomsg(grp >= 0);
+                  throw_assert_nomsg(H5Gget_num_objs(grp, &num_populations)>=0);
               
-              hsize_t idx = 0;
-              vector<string> op_data;
-              throw_assert_nomsg(H5Literate(grp, H5_INDEX_NAME, H5_ITER_NATIVE, &idx,
-                                            &iterate_cb, (void*)&op_data ) >= 0);
+                  hsize_t idx = 0;
+                  vector<string> op_data;
+                  throw_assert_nomsg(H5Literate(grp, H5_INDEX_NAME, H5_ITER_NATIVE, &idx,
+                                                &iterate_cb, (void*)&op_data ) >= 0);
               
-              throw_assert_nomsg(op_data.size() == num_populations);
+                  throw_assert_nomsg(op_data.size() == num_populations);
               
-              for (size_t i = 0; i < op_data.size(); ++i)
-                {
-                  pop_names.push_back(op_data[i]);
-                }
+                  for (size_t i = 0; i < op_data.size(); ++i)
+                    {
+                      pop_names.push_back(op_data[i]);
+                    }
         
-              throw_assert_nomsg(H5Gclose(grp) >= 0);
-            }
+                  throw_assert_nomsg(H5Gclose(grp) >= 0);
+                }
           
-          throw_assert_nomsg(H5Fclose(file) >= 0);
-        }
+              throw_assert_nomsg(hdf5::close_file(file) >= 0);
+            }
 
-      {
-        vector<char> sendbuf;
-        if (rank == 0)
           {
-            data::serialize_data(pop_names, sendbuf);
-            throw_assert_nomsg(sendbuf.size() > 0);
-          }
-
-        size_t sendbuf_size = sendbuf.size();
-        throw_assert_nomsg(MPI_Bcast(&sendbuf_size, 1, MPI_SIZE_T, 0, comm) == MPI_SUCCESS);
-        sendbuf.resize(sendbuf_size);
+            vector<char> sendbuf;
+            if (rank == 0)
+              {
+                data::serialize_data(pop_names, sendbuf);
+                throw_assert_nomsg(sendbuf.size() > 0);
+              }
+
+            size_t sendbuf_size = sendbuf.size();
+            throw_assert_nomsg(MPI_Bcast(&sendbuf_size, 1, MPI_SIZE_T, 0, comm) == MPI_SUCCESS);
+            sendbuf.resize(sendbuf_size);
         
-        throw_assert_nomsg(MPI_Bcast(&sendbuf[0], sendbuf.size(), MPI_CHAR, 0, comm) == MPI_SUCCESS);
+            throw_assert_nomsg(MPI_Bcast(&sendbuf[0], sendbuf.size(), MPI_CHAR, 0, comm) == MPI_SUCCESS);
         
-        if (rank != 0)
-          {
-            data::deserialize_data(sendbuf, pop_names);
+            if (rank != 0)
+              {
+                data::deserialize_data(sendbuf, pop_names);
+              }
           }
-      }
+          if (session != nullptr)
+            {
+              session->insert_metadata("population_names", pop_names);
+            }
+        }
 
       return ierr;
     }
@@ -143,51 +153,59 @@ namespace neuroh5
       size_t num_pairs = 0;
 
 
-      // process 0 reads the population pairs and broadcasts
-      if (rank == 0)
+      hdf5::FileSession* session = hdf5::FileSession::find(comm, file_name);
+      if ((session == nullptr) || !session->find_metadata("population_combos", v))
         {
-          hid_t file = -1, dset = -1;
+          // process 0 reads the population pairs and broadcasts
+          if (rank == 0)
+            {
+              hid_t file = -1, dset = -1;
 
-          file = H5Fopen(file_name.c_str(), H5F_ACC_RDONLY, H5P_DEFAULT);
-          throw_assert_nomsg(file >= 0);
+              file = hdf5::open_file(comm, file_name);
+              throw_assert_nomsg(file >= 0);
 
-          dset = H5Dopen2(file, hdf5::h5types_path_join(hdf5::POP_COMBS).c_str(),
-                          H5P_DEFAULT);
-          throw_assert_nomsg(dset >= 0);
+              dset = H5Dopen2(file, hdf5::h5types_path_join(hdf5::POP_COMBS).c_str(),
+                              H5P_DEFAULT);
+              throw_assert_nomsg(dset >= 0);
 
-          hid_t fspace = H5Dget_space(dset);
-          throw_assert_nomsg(fspace >= 0);
+              hid_t fspace = H5Dget_space(dset);
+              throw_assert_nomsg(fspace >= 0);
 
-          num_pairs = (size_t) H5Sget_simple_extent_npoints(fspace);
-          throw_assert_nomsg(num_pairs > 0);
-          throw_assert_nomsg(H5Sclose(fspace) >= 0);
+              num_pairs = (size_t) H5Sget_simple_extent_npoints(fspace);
+              throw_assert_nomsg(num_pairs > 0);
+              throw_assert_nomsg(H5Sclose(fspace) >= 0);
 
 
-          vector<pop_comb_t> vpp(num_pairs);
-          hid_t ftype = H5Dget_type(dset);
-          throw_assert_nomsg(ftype >= 0);
-          hid_t mtype = H5Tget_native_type(ftype, H5T_DIR_ASCEND);
+              vector<pop_comb_t> vpp(num_pairs);
+              hid_t ftype = H5Dget_type(dset);
+              throw_assert_nomsg(ftype >= 0);
+              hid_t mtype = H5Tget_native_type(ftype, H5T_DIR_ASCEND);
 
-          throw_assert_nomsg(H5Dread(dset, mtype, H5S_ALL, H5S_ALL, H5P_DEFAULT,
-                         &vpp[0]) >= 0);
+              throw_assert_nomsg(H5Dread(dset, mtype, H5S_ALL, H5S_ALL, H5P_DEFAULT,
+                             &vpp[0]) >= 0);
+              v.resize(2*num_pairs);
+              for (size_t i = 0; i < vpp.size(); ++i)
+                {
+                  v[2*i]   = vpp[i].src;
+                  v[2*i+1] = vpp[i].dst;
+                }
+
+              throw_assert_nomsg(H5Tclose(mtype) >= 0);
+              throw_assert_nomsg(H5Tclose(ftype) >= 0);
+
+              throw_assert_nomsg(H5Dclose(dset) >= 0);
+              throw_assert_nomsg(hdf5::close_file(file) >= 0);
+            }
+
+          throw_assert_nomsg(MPI_Bcast(&num_pairs, 1, MPI_SIZE_T, 0, comm) == MPI_SUCCESS);
           v.resize(2*num_pairs);
-          for (size_t i = 0; i < vpp.size(); ++i)
+          throw_assert_nomsg(MPI_Bcast(&v[0], (int)2*num_pairs, MPI_UINT16_T, 0, comm) == MPI_SUCCESS);
+          if (session != nullptr)
             {
-              v[2*i]   = vpp[i].src;
-              v[2*i+1] = vpp[i].dst;
+              session->insert_metadata("population_combos", v);
             }
-
-          throw_assert_nomsg(H5Tclose(mtype) >= 0);
-          throw_assert_nomsg(H5Tclose(ftype) >= 0);
-
-          throw_assert_nomsg(H5Dclose(dset) >= 0);
-          throw_assert_nomsg(H5Fclose(file) >= 0);
         }
 
-      throw_assert_nomsg(MPI_Bcast(&num_pairs, 1, MPI_SIZE_T, 0, comm) == MPI_SUCCESS);
-      v.resize(2*num_pairs);
-      throw_assert_nomsg(MPI_Bcast(&v[0], (int)2*num_pairs, MPI_UINT16_T, 0, comm) == MPI_SUCCESS);
-
       // populate the set
       pop_pairs.clear();
       for (size_t i = 0; i < v.size(); i += 2)
@@ -225,45 +243,53 @@ namespace neuroh5
 
       hid_t file = -1, dset = -1;
 
-      // process 0 reads the number of ranges and broadcasts
-      if (rank == 0)
+      hdf5::FileSession* session = hdf5::FileSession::find(comm, file_name);
+      if ((session == nullptr) || !session->find_metadata("population_ranges", pop_vector))
         {
-          file = H5Fopen(file_name.c_str(), H5F_ACC_RDONLY, H5P_DEFAULT);
-          throw_assert_nomsg(file >= 0);
-          dset = H5Dopen2(file, hdf5::h5types_path_join(hdf5::POPULATIONS).c_str(), H5P_DEFAULT);
-          throw_assert_nomsg(dset >= 0);
-
-          hid_t fspace = H5Dget_space(dset);
-          throw_assert_nomsg(fspace >= 0);
-          num_ranges = (size_t) H5Sget_simple_extent_npoints(fspace);
-          throw_assert_nomsg(num_ranges > 0);
-          throw_assert_nomsg(H5Sclose(fspace) >= 0);
+          // process 0 reads the number of ranges and broadcasts
+          if (rank == 0)
+            {
+              file = hdf5::open_file(comm, file_name);
+              throw_assert_nomsg(file >= 0);
+              dset = H5Dopen2(file, hdf5::h5types_path_join(hdf5::POPULATIONS).c_str(), H5P_DEFAULT);
+              throw_assert_nomsg(dset >= 0);
+
+              hid_t fspace = H5Dget_space(dset);
+              throw_assert_nomsg(fspace >= 0);
+              num_ranges = (size_t) H5Sget_simple_extent_npoints(fspace);
+              throw_assert_nomsg(num_ranges > 0);
+              throw_assert_nomsg(H5Sclose(fspace) >= 0);
+
+              hid_t ftype = H5Dget_type(dset);
+              throw_assert_nomsg(ftype >= 0);
+
+              pop_vector.resize(num_ranges);
+              hid_t mtype = H5Tget_native_type(ftype, H5T_DIR_ASCEND);
+              throw_assert_nomsg(H5Dread(dset, mtype, H5S_ALL, H5S_ALL, H5P_DEFAULT,
+                             &pop_vector[0]) >= 0);
+
+              throw_assert_nomsg(H5Tclose(mtype) >= 0);
+              throw_assert_nomsg(H5Tclose(ftype) >= 0);
+
+              throw_assert_nomsg(H5Dclose(dset) >= 0);
+              throw_assert_nomsg(hdf5::close_file(file) >= 0);
+            }
 
-          hid_t ftype = H5Dget_type(dset);
-          throw_assert_nomsg(ftype >= 0);
+          throw_assert_nomsg(MPI_Bcast(&num_ranges, 1, MPI_SIZE_T, 0, comm) == MPI_SUCCESS);
+          throw_assert_nomsg(num_ranges > 0);
 
+          // allocate buffers
           pop_vector.resize(num_ranges);
-          hid_t mtype = H5Tget_native_type(ftype, H5T_DIR_ASCEND);
-          throw_assert_nomsg(H5Dread(dset, mtype, H5S_ALL, H5S_ALL, H5P_DEFAULT,
-                         &pop_vector[0]) >= 0);
 
-          throw_assert_nomsg(H5Tclose(mtype) >= 0);
-          throw_assert_nomsg(H5Tclose(ftype) >= 0);
-
-          throw_assert_nomsg(H5Dclose(dset) >= 0);
-          throw_assert_nomsg(H5Fclose(file) >= 0);
+          // MPI rank 0 reads and broadcasts the population ranges
+          throw_assert_nomsg(MPI_Bcast(&pop_vector[0], (int)num_ranges*sizeof(pop_range_t),
+                           MPI_BYTE, 0, comm) == MPI_SUCCESS);
+          if (session != nullptr)
+            {
+              session->insert_metadata("population_ranges", pop_vector);
+            }
         }
 
-      throw_assert_nomsg(MPI_Bcast(&num_ranges, 1, MPI_SIZE_T, 0, comm) == MPI_SUCCESS);
-      throw_assert_nomsg(num_ranges > 0);
-
-      // allocate buffers
-      pop_vector.resize(num_ranges);
-
-      // MPI rank 0 reads and broadcasts the population ranges
-      throw_assert_nomsg(MPI_Bcast(&pop_vector[0], (int)num_ranges*sizeof(pop_range_t),
-                       MPI_BYTE, 0, comm) == MPI_SUCCESS);
-
       n_nodes = 0;
       for(size_t i = 0; i < pop_vector.size(); ++i)
         {
@@ -293,63 +319,71 @@ namespace neuroh5
       throw_assert_nomsg(MPI_Comm_size(comm, &size) == MPI_SUCCESS);
       throw_assert_nomsg(MPI_Comm_rank(comm, &rank) == MPI_SUCCESS);
 
-      // MPI rank 0 reads and broadcasts the names of populations
-
-      // process 0 reads the number of populations and broadcasts
-      if (rank == 0)
+      hdf5::FileSession* session = hdf5::FileSession::find(comm, file_name);
+      if ((session == nullptr) || !session->find_metadata("population_labels", pop_labels))
         {
-          hid_t file = -1, pop_labels_type = -1, grp_h5types = -1;
-            
-          file = H5Fopen(file_name.c_str(), H5F_ACC_RDONLY, H5P_DEFAULT);
-          throw_assert_nomsg(file >= 0);
+          // MPI rank 0 reads and broadcasts the names of populations
 
-          if (hdf5::exists_group(file, hdf5::H5_TYPES.c_str()))
+          // process 0 reads the number of populations and broadcasts
+          if (rank == 0)
             {
-              grp_h5types = H5Gopen2(file, hdf5::H5_TYPES.c_str(), H5P_DEFAULT);
-              throw_assert_nomsg(grp_h5types >= 0);
+              hid_t file = -1, pop_labels_type = -1, grp_h5types = -1;
+            
+              file = hdf5::open_file(comm, file_name);
+              throw_assert_nomsg(file >= 0);
+
+              if (hdf5::exists_group(file, hdf5::H5_TYPES.c_str()))
+                {
+                  grp_h5types = H5Gopen2(file, hdf5::H5_TYPES.c_str(), H5P_DEFAULT);
+                  throw_assert_nomsg(grp_h5types >= 0);
               
-              pop_labels_type = H5Topen(grp_h5types, hdf5::POP_LABELS.c_str(), H5P_DEFAULT);
-              throw_assert_nomsg(pop_labels_type >= 0);
+                  pop_labels_type = H5Topen(grp_h5types, hdf5::POP_LABELS.c_str(), H5P_DEFAULT);
+                  throw_assert_nomsg(pop_labels_type >= 0);
               
-              size_t num_labels = H5Tget_nmembers(pop_labels_type);
-              throw_assert_nomsg(num_labels > 0);
+                  size_t num_labels = H5Tget_nmembers(pop_labels_type);
+                  throw_assert_nomsg(num_labels > 0);
               
-              for (size_t i=0; i<num_labels; i++)
-                {
-                  char namebuf[MAX_POP_NAME_LEN];
-                  int member_val;
-                  ierr = H5Tget_member_value(pop_labels_type, i, &member_val);
-                  throw_assert_nomsg(ierr >= 0);
-                  ierr = H5Tenum_nameof(pop_labels_type, &member_val, namebuf, MAX_POP_NAME_LEN);
-                  throw_assert_nomsg(ierr >= 0);
-                  pop_labels.insert ( make_pair((pop_t)member_val, string(namebuf)) );
-                }
+                  for (size_t i=0; i<num_labels; i++)
+                    {
+                      char namebuf[MAX_POP_NAME_LEN];
+                      int member_val;
+                      ierr = H5Tget_member_value(pop_labels_type, i, &member_val);
+                      throw_assert_nomsg(ierr >= 0);
+                      ierr = H5Tenum_nameof(pop_labels_type, &member_val, namebuf, MAX_POP_NAME_LEN);
+                      throw_assert_nomsg(ierr >= 0);
+                      pop_labels.insert ( make_pair((pop_t)member_val, string(namebuf)) );
+                    }
               
-              throw_assert_nomsg(H5Tclose(pop_labels_type) >= 0);
-              throw_assert_nomsg(H5Gclose(grp_h5types) >= 0);
-            }
+                  throw_assert_nomsg(H5Tclose(pop_labels_type) >= 0);
+                  throw_assert_nomsg(H5Gclose(grp_h5types) >= 0);
+                }
 
-          throw_assert_nomsg(H5Fclose(file) >= 0);
-        }
+              throw_assert_nomsg(hdf5::close_file(file) >= 0);
+            }
 
-      {
-        vector<char> sendbuf; size_t sendbuf_size=0;
-        if (rank == 0)
           {
-            data::serialize_data(pop_labels, sendbuf);
-            sendbuf_size = sendbuf.size();
-          }
-
-        throw_assert_nomsg(MPI_Bcast(&sendbuf_size, 1, MPI_SIZE_T, 0, comm) == MPI_SUCCESS);
-        throw_assert_nomsg(sendbuf_size > 0);
-        sendbuf.resize(sendbuf_size);
-        throw_assert_nomsg(MPI_Bcast(&sendbuf[0], sendbuf_size, MPI_CHAR, 0, comm) == MPI_SUCCESS);
+            vector<char> sendbuf; size_t sendbuf_size=0;
+            if (rank == 0)
+              {
+                data::serialize_data(pop_labels, sendbuf);
+                sendbuf_size = sendbuf.size();
+              }
+
+            throw_assert_nomsg(MPI_Bcast(&sendbuf_size, 1, MPI_SIZE_T, 0, comm) == MPI_SUCCESS);
+            throw_assert_nomsg(sendbuf_size > 0);
+            sendbuf.resize(sendbuf_size);
+            throw_assert_nomsg(MPI_Bcast(&sendbuf[0], sendbuf_size, MPI_CHAR, 0, comm) == MPI_SUCCESS);
         
-        if (rank != 0)
-          {
-            data::deserialize_data(sendbuf, pop_labels);
+            if (rank != 0)
+              {
+                data::deserialize_data(sendbuf, pop_labels);
+              }
           }
-      }
+          if (session != nullptr)
+            {
+              session->insert_metadata("population_labels", pop_labels);
+            }
+        }
 
       return ierr;
     }
@@ -17,6 +17,8 @@
 #include "neuroh5_types.hh"
 #include "cell_attributes.hh"
 #include "attr_map.hh"
+#include "columnar_attr_map.hh"
+#include "packed_trees.hh"
 #include "throw_assert.hh"
 
 namespace neuroh5
@@ -90,6 +92,30 @@ namespace neuroh5
     }
 
 
+    int read_trees
+    (
+     MPI_Comm comm,
+     const std::string& file_name,
+     const std::string& pop_name,
+     const CELL_IDX_T& pop_start,
+     data::PackedTrees &trees,
+     size_t offset,
+     size_t numitems
+     )
+    {
+      data::ColumnarAttrMap attr_values;
+      set<string> attr_mask;
+      
+      read_cell_attributes (comm, file_name, hdf5::TREES, attr_mask,
+                            pop_name, pop_start, attr_values,
+                            offset, numitems);
+
+      trees.from_attr_map(std::move(attr_values));
+    
+      return 0;
+    }
+
+
     /*****************************************************************************
      * Load tree data structures from HDF5
      *****************************************************************************/
@@ -16,9 +16,12 @@
 
 #include "neuroh5_types.hh"
 #include "attr_map.hh"
+#include "columnar_attr_map.hh"
+#include "packed_trees.hh"
 #include "cell_attributes.hh"
+#include "scatter_read_tree.hh"
 #include "rank_range.hh"
-#include "range_sample.hh"
+#include "io_rank_set.hh"
 #include "append_tree_map.hh"
 #include "append_rank_tree_map.hh"
 #include "append_rank_attr_map.hh"
@@ -28,6 +31,7 @@
 #include "dataset_num_elements.hh"
 #include "path_names.hh"
 #include "read_template.hh"
+#include "phase_stats.hh"
 #include "throw_assert.hh"
 #include "debug.hh"
 
@@ -58,6 +62,8 @@ namespace neuroh5
      size_t numitems
      )
     {
+      mpi::PhaseTimer timer("scatter_read_trees");
+
       std::vector<char> sendbuf; 
       std::vector<size_t> sendcounts, sdispls;
     
@@ -81,7 +87,7 @@ namespace neuroh5
       size = ssize;
 
       set<size_t> io_rank_set;
-      data::range_sample(size, io_size, io_rank_set);
+      mpi::select_io_ranks(all_comm, io_size, io_rank_set);
       bool is_io_rank = (io_rank_set.find(rank) != io_rank_set.end());
 
       // Am I an I/O rank?
@@ -113,12 +119,17 @@ namespace neuroh5
             data::NamedAttrMap attr_values;
             set <string> attr_mask;
             
-            read_cell_attributes (io_comm, file_name, hdf5::TREES, attr_mask,
-                                  pop_name, pop_start, attr_values,
-                                  offset, numitems * size);
+            {
+              mpi::PhaseTimer timer("read_cell_attributes");
+              read_cell_attributes (io_comm, file_name, hdf5::TREES, attr_mask,
+                                    pop_name, pop_start, attr_values,
+                                    offset, numitems * size);
+            }
 
+            mpi::PhaseTimer timer("append_rank_tree_map");
             data::append_rank_tree_map(attr_values, node_rank_map, rank_tree_map);
           }
+          mpi::PhaseTimer timer("serialize_trees");
           data::serialize_rank_tree_map (size, rank, rank_tree_map, sendcounts, sendbuf, sdispls);
         }
 
@@ -132,19 +143,24 @@ namespace neuroh5
 
       {
         vector<size_t> recvcounts, rdispls;
-        vector<char> recvbuf;
+        mpi::RecvBuffer<char> recvbuf;
 
-        throw_assert_nomsg(mpi::alltoallv_vector<char>(all_comm, MPI_CHAR, sendcounts, sdispls, sendbuf,
-                                                       recvcounts, rdispls, recvbuf) >= 0);
+        // only the I/O ranks have data to send
+        {
+          mpi::PhaseTimer timer("alltoallv");
+          throw_assert_nomsg(mpi::scatter_alltoallv_vector<char>(all_comm, MPI_CHAR, sendcounts, sdispls, sendbuf,
+                                                                 recvcounts, rdispls, recvbuf) >= 0);
+        }
         sendbuf.clear();
         sendbuf.shrink_to_fit();
 
         if (recvbuf.size() > 0)
           {
-            data::deserialize_rank_tree_map (size, recvbuf, recvcounts, rdispls, tree_map);
+            mpi::PhaseTimer timer("deserialize_trees");
+            data::deserialize_rank_tree_map (size, recvbuf.data(), recvbuf.size(), recvcounts, rdispls,
+                                             tree_map);
           }
-        recvbuf.clear();
-        recvbuf.shrink_to_fit();
+        recvbuf.free();
       }
 
       for (string attr_name_space : attr_name_spaces)
@@ -165,6 +181,118 @@ namespace neuroh5
     }
 
 
+    int scatter_read_trees
+    (
+     MPI_Comm                        all_comm,
+     const string                   &file_name,
+     const int                       io_size,
+     const vector<string>           &attr_name_spaces,
+     // A vector that maps nodes to compute ranks
+     const node_rank_map_t           &node_rank_map,
+     const string                    &pop_name,
+     const CELL_IDX_T                 pop_start,
+     data::PackedTrees               &trees,
+     map<string, data::NamedAttrMap> &attr_maps,
+     size_t offset,
+     size_t numitems
+     )
+    {
+      mpi::PhaseTimer timer("scatter_read_trees");
+
+      {
+        data::ColumnarAttrMap attr_values;
+        set <string> attr_mask;
+
+        throw_assert(scatter_read_cell_attributes(all_comm, file_name, io_size,
+                                                  hdf5::TREES, attr_mask, node_rank_map,
+                                                  pop_name, pop_start, attr_values,
+                                                  offset, numitems) >= 0,
+                     "scatter_read_trees: error in scatter_read_cell_attributes");
+        trees.from_attr_map(std::move(attr_values));
+      }
+
+      for (string attr_name_space : attr_name_spaces)
+        {
+          data::NamedAttrMap attr_map;
+          set <string> attr_mask;
+
+          scatter_read_cell_attributes(all_comm, file_name, io_size,
+                                       attr_name_space, attr_mask, node_rank_map,
+                                       pop_name, pop_start, attr_map,
+                                       offset, numitems);
+          attr_maps.insert(make_pair(attr_name_space, attr_map));
+        }
+
+      return 0;
+    }
+
+
+    static vector< pair<string, set<string> > > unmasked_name_spaces (const vector<string>& name_spaces)
+    {
+      vector< pair<string, set<string> > > result;
+      for (const string& name_space : name_spaces)
+        {
+          result.push_back(make_pair(name_space, set<string>()));
+        }
+      return result;
+    }
+
+    
+    TreeBlockReader::TreeBlockReader
+    (
+     MPI_Comm                        comm,
+     const string                   &file_name,
+     const int                       io_size,
+     const vector<string>           &attr_name_spaces,
+     const node_rank_map_t          &node_rank_map,
+     const string                   &pop_name,
+     const CELL_IDX_T                pop_start
+     )
+      : tree_reader(comm, file_name, io_size, unmasked_name_spaces(vector<string>(1, hdf5::TREES)),
+                    node_rank_map, pop_name, pop_start)
+    {
+      if (attr_name_spaces.size() > 0)
+        {
+          attr_reader.reset(new CellAttributeBlockReader(comm, file_name, io_size,
+                                                         unmasked_name_spaces(attr_name_spaces),
+                                                         node_rank_map, pop_name, pop_start));
+        }
+    }
+
+
+    int TreeBlockReader::read
+    (
+     size_t                           offset,
+     size_t                           numitems,
+     data::PackedTrees               &trees,
+     map<string, data::NamedAttrMap> &attr_maps
+     )
+    {
+      mpi::PhaseTimer timer("scatter_read_trees");
+
+      {
+        vector<data::ColumnarAttrMap> tree_attr_maps;
+        throw_assert(tree_reader.read(offset, numitems, tree_attr_maps) >= 0,
+                     "TreeBlockReader: error in reading trees");
+        trees.from_attr_map(std::move(tree_attr_maps[0]));
+      }
+
+      if (attr_reader)
+        {
+          vector<data::NamedAttrMap> attr_map_vector;
+          throw_assert(attr_reader->read(offset, numitems, attr_map_vector) >= 0,
+                       "TreeBlockReader: error in reading cell attributes");
+          const auto& name_spaces = attr_reader->name_spaces();
+          for (size_t k=0; k<name_spaces.size(); k++)
+            {
+              attr_maps[name_spaces[k].first] = std::move(attr_map_vector[k]);
+            }
+        }
+
+      return 0;
+    }
+
+    
     int scatter_read_tree_selection
     (
      MPI_Comm                        all_comm,
@@ -0,0 +1,227 @@
+// -*- mode: c++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+//==============================================================================
+///  @file append_edge_csr.cc
+///
+///  Populates flat CSR edge containers from DBS arrays.
+///
+///  Copyright (C) 2016-2025 Project NeuroH5.
+//==============================================================================
+
+#include <vector>
+#include <map>
+#include <set>
+
+#include "neuroh5_types.hh"
+#include "edge_csr.hh"
+#include "append_edge_csr.hh"
+
+using namespace std;
+
+namespace neuroh5
+{
+
+  namespace data
+  {
+    /**************************************************************************
+     * Append src/dst node pairs to a flat edge container
+     **************************************************************************/
+    int append_edge_csr
+    (
+     const NODE_IDX_T&                 dst_start,
+     const NODE_IDX_T&                 src_start,
+     const vector<DST_BLK_PTR_T>&      dst_blk_ptr,
+     const vector<NODE_IDX_T>&         dst_idx,
+     const vector<DST_PTR_T>&          dst_ptr,
+     const vector<NODE_IDX_T>&         src_idx,
+     const vector<string>&             attr_namespaces,
+     const map<string, NamedAttrVal>&  edge_attr_map,
+     size_t&                           num_edges,
+     EdgeCSR &                         edge_csr,
+     EdgeMapType                       edge_map_type
+     )
+    {
+      int ierr = 0; size_t dst_ptr_size;
+
+      vector<const AttrVal*> attr_values;
+      edge_attr_ptrs(edge_attr_map, attr_namespaces, attr_values);
+
+      edge_csr.edge_map_type = edge_map_type;
+      edge_csr.init_attrs(attr_values);
+      
+      // Ensure we have data to process
+      if (dst_blk_ptr.empty() || dst_idx.empty() || dst_ptr.empty() || src_idx.empty())
+        {
+          return ierr;
+        };
+
+      dst_ptr_size = dst_ptr.size();
+      edge_csr.adj.reserve(edge_csr.adj.size() + src_idx.size());
+      for (size_t b = 0; b < dst_idx.size(); ++b)
+        {
+          size_t low_dst_ptr = dst_blk_ptr[b],
+            high_dst_ptr = dst_blk_ptr[b+1];
+
+          NODE_IDX_T dst_base = dst_idx[b];
+          for (size_t i = low_dst_ptr, ii = 0; i < high_dst_ptr; ++i, ++ii)
+            {
+              if (i < dst_ptr_size-1)
+                {
+                  NODE_IDX_T dst = dst_base + ii + dst_start;
+                  size_t low = dst_ptr[i], high = dst_ptr[i+1];
+                      
+                  if (high > low)
+                    {
+                      switch (edge_map_type)
+                        {
+                        case EdgeMapDst:
+                          {
+                            edge_csr.append_row(dst, src_idx, attr_values, low, high, src_start);
+                            num_edges += high - low;
+                          }
+                          break;
+                        case EdgeMapSrc:
+                          {
+                            for (size_t j = low; j < high; ++j)
+                              {
+                                NODE_IDX_T src = src_idx[j] + src_start;
+                                edge_csr.push_back(src, dst, attr_values, j);
+                                num_edges++;
+                              }
+                          }
+                          break;
+                        }
+                    }
+                }
+            }
+        }
+
+      edge_csr.sort_rows();
+
+      return ierr;
+    }
+
+    
+    /**************************************************************************
+     * Append src/dst node pairs to a map of ranks and flat edge containers
+     **************************************************************************/
+    int append_rank_edge_csr
+    (
+     const size_t                     initial_rank,
+     const size_t                     num_ranks,
+     const NODE_IDX_T&                dst_start,
+     const NODE_IDX_T&                src_start,
+     const vector<DST_BLK_PTR_T>&     dst_blk_ptr,
+     const vector<NODE_IDX_T>&        dst_idx,
+     const vector<DST_PTR_T>&         dst_ptr,
+     const vector<NODE_IDX_T>&        src_idx,
+     const vector<string>&            attr_namespaces,
+     const map<string, NamedAttrVal>& edge_attr_map,
+     const node_rank_map_t&           node_rank_map,
+     size_t&                          num_edges,
+     rank_edge_csr_t &                rank_edge_csr,
+     EdgeMapType                      edge_map_type
+     )
+    {
+      int ierr = 0; size_t dst_ptr_size;
+      NODE_IDX_T dst_base = 0;
+
+      vector<const AttrVal*> attr_values;
+      edge_attr_ptrs(edge_attr_map, attr_namespaces, attr_values);
+
+      auto rank_csr = [&] (const rank_t r) -> EdgeCSR&
+        {
+          auto it = rank_edge_csr.find(r);
+          if (it == rank_edge_csr.end())
+            {
+              EdgeCSR& edge_csr = rank_edge_csr[r];
+              edge_csr.edge_map_type = edge_map_type;
+              edge_csr.init_attrs(attr_values);
+              return edge_csr;
+            }
+          return it->second;
+        };
+      
+      if (dst_blk_ptr.size() > 0)
+        {
+          dst_ptr_size = dst_ptr.size();
+          size_t num_dst = 0;
+          for (size_t b = 0; b < dst_blk_ptr.size(); ++b)
+            {
+              size_t low_dst_ptr = dst_blk_ptr[b], high_dst_ptr = 0;
+              if (b < dst_blk_ptr.size()-1)
+                high_dst_ptr = dst_blk_ptr[b+1];
+              else
+                high_dst_ptr = dst_ptr_size;
+              
+              if (b < dst_idx.size())
+                dst_base = dst_idx[b];
+              for (size_t i = low_dst_ptr, ii = 0; i < high_dst_ptr; ++i, ++ii)
+                {
+                  NODE_IDX_T dst = dst_base + ii + dst_start;
+                  size_t low = dst_ptr[i], high = 0;
+                  if (i < dst_ptr_size-1)
+                    high = dst_ptr[i+1];
+                  else
+                    high = src_idx.size();
+
+                  if (high > low)
+                    {
+                      switch (edge_map_type)
+                        {
+                        case EdgeMapDst:
+                          {
+                            auto it = node_rank_map.find(dst);
+                            if (it == node_rank_map.end())
+                              {
+                                rank_csr((initial_rank + num_dst) % num_ranks).
+                                  append_row(dst, src_idx, attr_values, low, high, src_start);
+                                num_edges += high - low;
+                              }
+                            else
+                              {
+                                for (auto dst_rank : it->second)
+                                  {
+                                    rank_csr(dst_rank).append_row(dst, src_idx, attr_values, low, high, src_start);
+                                    num_edges += high - low;
+                                  }
+                              }
+                          }
+                          break;
+                        case EdgeMapSrc:
+                          {
+                            for (size_t j = low; j < high; ++j)
+                              {
+                                NODE_IDX_T src = src_idx[j] + src_start;
+                                auto it = node_rank_map.find(src);
+                                if (it == node_rank_map.end())
+                                  {
+                                    rank_csr(j % num_ranks).push_back(src, dst, attr_values, j);
+                                  }
+                                else
+                                  {
+                                    for (auto dst_rank : it->second)
+                                      {
+                                        rank_csr(dst_rank).push_back(src, dst, attr_values, j);
+                                      }
+                                  }
+                                num_edges++;
+                              }
+                          }
+                          break;
+                        }
+                    }
+                  num_dst++;
+                }
+            }
+        }
+
+      for (auto& it : rank_edge_csr)
+        {
+          it.second.sort_rows();
+        }
+
+      return ierr;
+    }
+    
+  }
+}
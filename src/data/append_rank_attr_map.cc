@@ -16,6 +16,7 @@
 #include "neuroh5_types.hh"
 #include "attr_val.hh"
 #include "attr_map.hh"
+#include "columnar_attr_map.hh"
 #include "rank_range.hh"
 #include "throw_assert.hh"
 
@@ -170,5 +171,64 @@ namespace neuroh5
     }
 
 
+    template<class T>
+    static void append_rank_attr_columns
+    (
+     const data::ColumnarAttrMap   &attr_values,
+     const node_rank_map_t &node_rank_map,
+     map <rank_t, data::ColumnarAttrMap> &rank_attr_map)
+    {
+      const vector< AttrColumn<T> >& all_columns = attr_values.columns<T>();
+      for (size_t i=0; i<all_columns.size(); i++)
+        {
+          const AttrColumn<T>& column = all_columns[i];
+          for (size_t r=0; r<column.size(); r++)
+            {
+              const CELL_IDX_T index = column.index[r];
+              auto it = node_rank_map.find(index);
+              throw_assert(it != node_rank_map.end(),
+                           "append_rank_attr_map: index not found in node rank map");
+              for (const rank_t& dst_rank : it->second)
+                {
+                  vector< AttrColumn<T> >& dst_columns = rank_attr_map[dst_rank].columns<T>();
+                  dst_columns.resize(all_columns.size());
+                  dst_columns[i].append_row(index, column.row_data(r), column.row_size(r));
+                }
+            }
+        }
+    }
+
+    
+    void append_rank_attr_map
+    (
+     const data::ColumnarAttrMap   &attr_values,
+     const node_rank_map_t &node_rank_map,
+     map <rank_t, data::ColumnarAttrMap> &rank_attr_map)
+    {
+      append_rank_attr_columns<float>(attr_values, node_rank_map, rank_attr_map);
+      append_rank_attr_columns<uint8_t>(attr_values, node_rank_map, rank_attr_map);
+      append_rank_attr_columns<int8_t>(attr_values, node_rank_map, rank_attr_map);
+      append_rank_attr_columns<uint16_t>(attr_values, node_rank_map, rank_attr_map);
+      append_rank_attr_columns<int16_t>(attr_values, node_rank_map, rank_attr_map);
+      append_rank_attr_columns<uint32_t>(attr_values, node_rank_map, rank_attr_map);
+      append_rank_attr_columns<int32_t>(attr_values, node_rank_map, rank_attr_map);
+
+      // rows are appended in cell index order, so that only the index of
+      // all attributes needs to be rebuilt
+      for (auto& it : rank_attr_map)
+        {
+          ColumnarAttrMap& attr_map = it.second;
+          attr_map.index.clear();
+          for (const auto& column : attr_map.float_columns)  attr_map.merge_index(column.index);
+          for (const auto& column : attr_map.uint8_columns)  attr_map.merge_index(column.index);
+          for (const auto& column : attr_map.int8_columns)   attr_map.merge_index(column.index);
+          for (const auto& column : attr_map.uint16_columns) attr_map.merge_index(column.index);
+          for (const auto& column : attr_map.int16_columns)  attr_map.merge_index(column.index);
+          for (const auto& column : attr_map.uint32_columns) attr_map.merge_index(column.index);
+          for (const auto& column : attr_map.int32_columns)  attr_map.merge_index(column.index);
+        }
+    }
+
+
   }
 }
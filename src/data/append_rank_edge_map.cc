@@ -78,14 +78,14 @@ namespace neuroh5
                             {
                             case EdgeMapDst:
                               {
-                                set<rank_t> dst_rank_set;
+                                node_rank_map_t::ranks_type dst_ranks;
                                 auto it = node_rank_map.find(dst);
                                 if (it == node_rank_map.end())
-                                  { dst_rank_set.insert((initial_rank + num_dst) % num_ranks); }
+                                  { dst_ranks = node_rank_map_t::ranks_type((initial_rank + num_dst) % num_ranks); }
                                 else
-                                  { dst_rank_set = it->second; }
+                                  { dst_ranks = it->second; }
 
-                                for (auto dst_rank : dst_rank_set)
+                                for (auto dst_rank : dst_ranks)
                                   {
                                     edge_tuple_t& et = rank_edge_map[dst_rank][dst];
                                     vector<NODE_IDX_T> &my_srcs = get<0>(et);
@@ -114,14 +114,14 @@ namespace neuroh5
                                 for (size_t j = low, jj=0; j < high; ++j, ++jj)
                                   {
                                     NODE_IDX_T src = src_idx[j] + src_start;
-                                    set <rank_t> dst_rank_set;
+                                    node_rank_map_t::ranks_type dst_ranks;
                                     auto it = node_rank_map.find(src);
                                     if (it == node_rank_map.end())
-                                      { dst_rank_set.insert(j % num_ranks); }
+                                      { dst_ranks = node_rank_map_t::ranks_type(j % num_ranks); }
                                     else
-                                      { dst_rank_set = it->second; }
+                                      { dst_ranks = it->second; }
 
-                                    for (auto dst_rank : dst_rank_set)
+                                    for (auto dst_rank : dst_ranks)
                                       {
                                         edge_tuple_t& et = rank_edge_map[dst_rank][src];
                                         
@@ -61,13 +61,13 @@ namespace neuroh5
                 case EdgeMapDst:
                   {
                     auto it = node_rank_map.find(dst);
-                    set <rank_t> dst_rank_set;
+                    node_rank_map_t::ranks_type dst_ranks;
                     if (it == node_rank_map.end())
-                      { dst_rank_set.insert(num_dst % num_ranks); }
+                      { dst_ranks = node_rank_map_t::ranks_type(num_dst % num_ranks); }
                     else
-                      { dst_rank_set = it->second; }
+                      { dst_ranks = it->second; }
 
-                    for (auto dst_rank : dst_rank_set)
+                    for (auto dst_rank : dst_ranks)
                       {
                         edge_tuple_t& et = rank_edge_map[dst_rank][dst];
                         vector<NODE_IDX_T> &my_srcs = get<0>(et);
@@ -97,14 +97,14 @@ namespace neuroh5
                     for (size_t j = low; j < high; ++j)
                       {
                         NODE_IDX_T src = src_idx[j] + src_start;
-                        set <rank_t> dst_rank_set;
+                        node_rank_map_t::ranks_type dst_ranks;
                         auto it = node_rank_map.find(src);
                         if (it == node_rank_map.end())
-                          { dst_rank_set.insert(src % num_ranks); }
+                          { dst_ranks = node_rank_map_t::ranks_type(src % num_ranks); }
                         else
-                          { dst_rank_set = it->second; }
+                          { dst_ranks = it->second; }
 
-                        for (auto dst_rank : dst_rank_set)
+                        for (auto dst_rank : dst_ranks)
                           {
                             edge_tuple_t& et = rank_edge_map[dst_rank][src];
                             
@@ -47,7 +47,7 @@ namespace neuroh5
           const deque<PARENT_NODE_IDX_T>& parents = attr_values.find_name<PARENT_NODE_IDX_T>(hdf5::PARENT, gid);
           const deque<SWC_TYPE_T> swc_types   = attr_values.find_name<SWC_TYPE_T>(hdf5::SWCTYPE, gid);
 
-          set <rank_t> dst_rank_set;
+          node_rank_map_t::ranks_type dst_ranks;
           auto it = node_rank_map.find(gid);
           if (it == node_rank_map.end())
             {
@@ -56,14 +56,14 @@ namespace neuroh5
           throw_assert(it != node_rank_map.end(),
                        "append_rank_tree_map: index not found in node rank map");
 
-          dst_rank_set = it->second;
+          dst_ranks = it->second;
           
           neurotree_t tree = make_tuple(gid, src_vector, dst_vector, sections,
                                         xcoords, ycoords, zcoords,
                                         radiuses, layers, parents,
                                         swc_types);
 
-          for (auto dst_rank : dst_rank_set)
+          for (auto dst_rank : dst_ranks)
             {
               map<CELL_IDX_T, neurotree_t> &tree_map = rank_tree_map[dst_rank];
               tree_map.insert(make_pair(gid, tree));
@@ -0,0 +1,112 @@
+// -*- mode: c++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+//==============================================================================
+///  @file cell_index_cache.cc
+///
+///  Sorted cell attribute indices for selection reads, and a cache of the
+///  indices of each attribute namespace.
+///
+///  Copyright (C) 2016-2025 Project NeuroH5.
+//==============================================================================
+
+#include <algorithm>
+#include <numeric>
+#include <string>
+#include <vector>
+
+#include "cell_index_cache.hh"
+#include "throw_assert.hh"
+
+using namespace std;
+
+namespace neuroh5
+{
+  namespace data
+  {
+
+    SortedCellIndex::SortedCellIndex (const vector<CELL_IDX_T>& index,
+                                      const vector<ATTR_PTR_T>& ptr)
+      : gids_(index), ptr_(ptr)
+    {
+      throw_assert(ptr.empty() || (ptr.size() == index.size()+1),
+                   "SortedCellIndex: mismatch of sizes of cell index and attribute pointer");
+
+      if (!std::is_sorted(gids_.begin(), gids_.end()))
+        {
+          order_.resize(gids_.size());
+          std::iota(order_.begin(), order_.end(), 0);
+          std::stable_sort(order_.begin(), order_.end(),
+                           [&](CELL_IDX_T a, CELL_IDX_T b) { return index[a] < index[b]; });
+          for (size_t i = 0; i < order_.size(); i++)
+            {
+              gids_[i] = index[order_[i]];
+            }
+        }
+    }
+
+
+    void SortedCellIndex::select (const CELL_IDX_T pop_start,
+                                  const vector<CELL_IDX_T>& selection,
+                                  vector<CELL_IDX_T>& selection_index,
+                                  vector< pair<hsize_t,hsize_t> >& ranges) const
+    {
+      if (ptr_.empty())
+        return;
+
+      vector<CELL_IDX_T> result_index;
+      vector< pair<hsize_t,hsize_t> > result_ranges;
+      for (const CELL_IDX_T& s : selection)
+        {
+          if (s < pop_start) continue;
+          auto rp = std::equal_range(gids_.begin(), gids_.end(), s);
+          for (auto it = rp.first; it != rp.second; ++it)
+            {
+              size_t spos = it - gids_.begin();
+              size_t pos = order_.empty() ? spos : order_[spos];
+              hsize_t value_start = ptr_[pos];
+              hsize_t value_block = ptr_[pos+1] - value_start;
+              result_ranges.push_back(make_pair(value_start, value_block));
+              result_index.push_back(s);
+            }
+        }
+
+      // ties keep the selection order
+      vector<size_t> range_sort_p(result_ranges.size());
+      std::iota(range_sort_p.begin(), range_sort_p.end(), 0);
+      std::stable_sort(range_sort_p.begin(), range_sort_p.end(),
+                       [&](size_t a, size_t b) { return result_ranges[a].first < result_ranges[b].first; });
+
+      for (size_t i : range_sort_p)
+        {
+          selection_index.push_back(result_index[i]);
+          ranges.push_back(result_ranges[i]);
+        }
+    }
+
+
+    string CellIndexCache::key (const string& name_space,
+                                const string& pop_name,
+                                const CELL_IDX_T pop_start)
+    {
+      return name_space + "/" + pop_name + "/" + std::to_string(pop_start);
+    }
+
+    shared_ptr<const CellAttributeIndex> CellIndexCache::find (const string& name_space,
+                                                               const string& pop_name,
+                                                               const CELL_IDX_T pop_start) const
+    {
+      auto it = entries_.find(key(name_space, pop_name, pop_start));
+      if (it == entries_.end())
+        return nullptr;
+      return it->second;
+    }
+
+    void CellIndexCache::insert (const string& name_space,
+                                 const string& pop_name,
+                                 const CELL_IDX_T pop_start,
+                                 shared_ptr<const CellAttributeIndex> attr_index)
+    {
+      entries_[key(name_space, pop_name, pop_start)] = attr_index;
+    }
+
+  }
+}
@@ -0,0 +1,235 @@
+// -*- mode: c++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+//==============================================================================
+///  @file columnar_attr_map.cc
+///
+///  Columnar storage of cell attributes.
+///
+///  Copyright (C) 2016-2025 Project NeuroH5.
+//==============================================================================
+
+#include <algorithm>
+#include <deque>
+#include <iterator>
+#include <map>
+#include <string>
+#include <vector>
+
+#include "columnar_attr_map.hh"
+#include "throw_assert.hh"
+
+using namespace std;
+
+namespace neuroh5
+{
+  namespace data
+  {
+
+    template<>
+    const vector< AttrColumn<float> >& ColumnarAttrMap::columns<float> () const
+    {
+      return float_columns;
+    }
+    template<>
+    const vector< AttrColumn<uint8_t> >& ColumnarAttrMap::columns<uint8_t> () const
+    {
+      return uint8_columns;
+    }
+    template<>
+    const vector< AttrColumn<int8_t> >& ColumnarAttrMap::columns<int8_t> () const
+    {
+      return int8_columns;
+    }
+    template<>
+    const vector< AttrColumn<uint16_t> >& ColumnarAttrMap::columns<uint16_t> () const
+    {
+      return uint16_columns;
+    }
+    template<>
+    const vector< AttrColumn<int16_t> >& ColumnarAttrMap::columns<int16_t> () const
+    {
+      return int16_columns;
+    }
+    template<>
+    const vector< AttrColumn<uint32_t> >& ColumnarAttrMap::columns<uint32_t> () const
+    {
+      return uint32_columns;
+    }
+    template<>
+    const vector< AttrColumn<int32_t> >& ColumnarAttrMap::columns<int32_t> () const
+    {
+      return int32_columns;
+    }
+
+    template<>
+    vector< AttrColumn<float> >& ColumnarAttrMap::columns<float> ()
+    {
+      return float_columns;
+    }
+    template<>
+    vector< AttrColumn<uint8_t> >& ColumnarAttrMap::columns<uint8_t> ()
+    {
+      return uint8_columns;
+    }
+    template<>
+    vector< AttrColumn<int8_t> >& ColumnarAttrMap::columns<int8_t> ()
+    {
+      return int8_columns;
+    }
+    template<>
+    vector< AttrColumn<uint16_t> >& ColumnarAttrMap::columns<uint16_t> ()
+    {
+      return uint16_columns;
+    }
+    template<>
+    vector< AttrColumn<int16_t> >& ColumnarAttrMap::columns<int16_t> ()
+    {
+      return int16_columns;
+    }
+    template<>
+    vector< AttrColumn<uint32_t> >& ColumnarAttrMap::columns<uint32_t> ()
+    {
+      return uint32_columns;
+    }
+    template<>
+    vector< AttrColumn<int32_t> >& ColumnarAttrMap::columns<int32_t> ()
+    {
+      return int32_columns;
+    }
+
+
+    void ColumnarAttrMap::num_attrs (vector<size_t> &v) const
+    {
+      v.resize(AttrMap::num_attr_types);
+      v[AttrMap::attr_index_float]=num_attr<float>();
+      v[AttrMap::attr_index_uint8]=num_attr<uint8_t>();
+      v[AttrMap::attr_index_int8]=num_attr<int8_t>();
+      v[AttrMap::attr_index_uint16]=num_attr<uint16_t>();
+      v[AttrMap::attr_index_int16]=num_attr<int16_t>();
+      v[AttrMap::attr_index_uint32]=num_attr<uint32_t>();
+      v[AttrMap::attr_index_int32]=num_attr<int32_t>();
+    }
+
+
+    void ColumnarAttrMap::attr_names (vector<vector<string>> &attr_names) const
+    {
+      attr_names.resize(AttrMap::num_attr_types);
+      attr_names_type<float>(attr_names[AttrMap::attr_index_float]);
+      attr_names_type<int8_t>(attr_names[AttrMap::attr_index_int8]);
+      attr_names_type<int16_t>(attr_names[AttrMap::attr_index_int16]);
+      attr_names_type<int32_t>(attr_names[AttrMap::attr_index_int32]);
+      attr_names_type<uint8_t>(attr_names[AttrMap::attr_index_uint8]);
+      attr_names_type<uint16_t>(attr_names[AttrMap::attr_index_uint16]);
+      attr_names_type<uint32_t>(attr_names[AttrMap::attr_index_uint32]);
+    }
+
+
+    void ColumnarAttrMap::merge_index (const vector<CELL_IDX_T>& cell_index)
+    {
+      if (cell_index.empty())
+        return;
+      if (index.empty() || (index.back() < cell_index.front()))
+        {
+          index.insert(index.end(), cell_index.begin(), cell_index.end());
+          return;
+        }
+      vector<CELL_IDX_T> merged_index;
+      merged_index.reserve(index.size() + cell_index.size());
+      std::set_union(index.begin(), index.end(),
+                     cell_index.begin(), cell_index.end(),
+                     back_inserter(merged_index));
+      index = std::move(merged_index);
+    }
+
+
+    void ColumnarAttrMap::clear ()
+    {
+      index.clear();
+      float_columns.clear();
+      uint8_columns.clear();
+      int8_columns.clear();
+      uint16_columns.clear();
+      int16_columns.clear();
+      uint32_columns.clear();
+      int32_columns.clear();
+      attr_name_map.clear();
+    }
+
+
+    template<class T>
+    static void columns_to_attr_map (const ColumnarAttrMap& columnar_attr_map,
+                                     const vector<string>& attr_names,
+                                     NamedAttrMap& attr_map)
+    {
+      const vector< AttrColumn<T> >& attr_columns = columnar_attr_map.columns<T>();
+      for (size_t i = 0; i < attr_columns.size(); i++)
+        {
+          size_t attr_index = i;
+          if (i < attr_names.size())
+            {
+              attr_index = attr_map.insert_name<T>(attr_names[i]);
+            }
+          const AttrColumn<T>& column = attr_columns[i];
+          for (size_t r = 0; r < column.size(); r++)
+            {
+              const T* first = column.row_data(r);
+              attr_map.AttrMap::insert(attr_index, column.index[r],
+                                       deque<T>(first, first + column.row_size(r)));
+            }
+        }
+    }
+
+    void ColumnarAttrMap::to_attr_map (NamedAttrMap& attr_map) const
+    {
+      vector<vector<string>> names;
+      attr_names(names);
+      columns_to_attr_map<float>(*this, names[AttrMap::attr_index_float], attr_map);
+      columns_to_attr_map<uint8_t>(*this, names[AttrMap::attr_index_uint8], attr_map);
+      columns_to_attr_map<int8_t>(*this, names[AttrMap::attr_index_int8], attr_map);
+      columns_to_attr_map<uint16_t>(*this, names[AttrMap::attr_index_uint16], attr_map);
+      columns_to_attr_map<int16_t>(*this, names[AttrMap::attr_index_int16], attr_map);
+      columns_to_attr_map<uint32_t>(*this, names[AttrMap::attr_index_uint32], attr_map);
+      columns_to_attr_map<int32_t>(*this, names[AttrMap::attr_index_int32], attr_map);
+    }
+
+
+    template<class T>
+    static void attr_map_to_columns (const NamedAttrMap& attr_map,
+                                     const vector<string>& attr_names,
+                                     ColumnarAttrMap& columnar_attr_map)
+    {
+      const vector< map< CELL_IDX_T, deque<T> > >& value_maps = attr_map.attr_maps<T>();
+      for (size_t i = 0; i < value_maps.size(); i++)
+        {
+          size_t attr_index = i;
+          if (i < attr_names.size())
+            {
+              attr_index = columnar_attr_map.insert_name<T>(attr_names[i]);
+            }
+          AttrColumn<T> column;
+          for (auto const& element : value_maps[i])
+            {
+              const deque<T>& v = element.second;
+              column.index.push_back(element.first);
+              column.values.insert(column.values.end(), v.begin(), v.end());
+              column.ptr.push_back(column.values.size());
+            }
+          columnar_attr_map.insert(attr_index, std::move(column));
+        }
+    }
+
+    void ColumnarAttrMap::from_attr_map (const NamedAttrMap& attr_map)
+    {
+      clear();
+      vector<vector<string>> names;
+      attr_map.attr_names(names);
+      attr_map_to_columns<float>(attr_map, names[AttrMap::attr_index_float], *this);
+      attr_map_to_columns<uint8_t>(attr_map, names[AttrMap::attr_index_uint8], *this);
+      attr_map_to_columns<int8_t>(attr_map, names[AttrMap::attr_index_int8], *this);
+      attr_map_to_columns<uint16_t>(attr_map, names[AttrMap::attr_index_uint16], *this);
+      attr_map_to_columns<int16_t>(attr_map, names[AttrMap::attr_index_int16], *this);
+      attr_map_to_columns<uint32_t>(attr_map, names[AttrMap::attr_index_uint32], *this);
+      attr_map_to_columns<int32_t>(attr_map, names[AttrMap::attr_index_int32], *this);
+    }
+
+  }
+}
@@ -0,0 +1,361 @@
+// -*- mode: c++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+//==============================================================================
+///  @file edge_csr.cc
+///
+///  Flat compressed sparse row (CSR) container for projection edges.
+///
+///  Copyright (C) 2016-2025 Project NeuroH5.
+//==============================================================================
+
+#include <algorithm>
+#include <functional>
+#include <map>
+#include <queue>
+#include <string>
+#include <vector>
+
+#include "edge_csr.hh"
+#include "throw_assert.hh"
+
+using namespace std;
+
+namespace neuroh5
+{
+  namespace data
+  {
+
+    template <class T>
+    static void resize_attr_columns (AttrVal& dst, const AttrVal& shape)
+    {
+      if (dst.size_attr_vec<T>() < shape.size_attr_vec<T>())
+        {
+          dst.resize<T>(shape.size_attr_vec<T>());
+        }
+    }
+
+    template <class T>
+    static void append_attr_columns (AttrVal& dst, const AttrVal& src,
+                                     const size_t low, const size_t high)
+    {
+      for (size_t k = 0; k < src.size_attr_vec<T>(); k++)
+        {
+          const vector<T>& src_col = src.const_attr_vec<T>(k);
+          vector<T>& dst_col = dst.attr_vec<T>(k);
+          dst_col.insert(dst_col.end(), src_col.begin()+low, src_col.begin()+high);
+        }
+    }
+
+    template <class T>
+    static void copy_attr_columns (AttrVal& dst, const AttrVal& src,
+                                   const size_t low, const size_t high)
+    {
+      dst.resize<T>(src.size_attr_vec<T>());
+      for (size_t k = 0; k < src.size_attr_vec<T>(); k++)
+        {
+          const vector<T>& src_col = src.const_attr_vec<T>(k);
+          dst.attr_vec<T>(k).assign(src_col.begin()+low, src_col.begin()+high);
+        }
+    }
+
+    static void resize_attrs (AttrVal& dst, const AttrVal& shape)
+    {
+      resize_attr_columns<float>(dst, shape);
+      resize_attr_columns<uint8_t>(dst, shape);
+      resize_attr_columns<uint16_t>(dst, shape);
+      resize_attr_columns<uint32_t>(dst, shape);
+      resize_attr_columns<int8_t>(dst, shape);
+      resize_attr_columns<int16_t>(dst, shape);
+      resize_attr_columns<int32_t>(dst, shape);
+    }
+
+    static void append_attrs (AttrVal& dst, const AttrVal& src,
+                              const size_t low, const size_t high)
+    {
+      append_attr_columns<float>(dst, src, low, high);
+      append_attr_columns<uint8_t>(dst, src, low, high);
+      append_attr_columns<uint16_t>(dst, src, low, high);
+      append_attr_columns<uint32_t>(dst, src, low, high);
+      append_attr_columns<int8_t>(dst, src, low, high);
+      append_attr_columns<int16_t>(dst, src, low, high);
+      append_attr_columns<int32_t>(dst, src, low, high);
+    }
+
+    static void copy_attrs (AttrVal& dst, const AttrVal& src,
+                            const size_t low, const size_t high)
+    {
+      copy_attr_columns<float>(dst, src, low, high);
+      copy_attr_columns<uint8_t>(dst, src, low, high);
+      copy_attr_columns<uint16_t>(dst, src, low, high);
+      copy_attr_columns<uint32_t>(dst, src, low, high);
+      copy_attr_columns<int8_t>(dst, src, low, high);
+      copy_attr_columns<int16_t>(dst, src, low, high);
+      copy_attr_columns<int32_t>(dst, src, low, high);
+    }
+
+
+    size_t EdgeCSR::find (const NODE_IDX_T key) const
+    {
+      auto it = std::lower_bound(keys.cbegin(), keys.cend(), key);
+      if ((it != keys.cend()) && (*it == key))
+        {
+          return std::distance(keys.cbegin(), it);
+        }
+      return keys.size();
+    }
+
+    void EdgeCSR::init_attrs (const vector<const AttrVal*>& attr_shape)
+    {
+      attrs.resize(attr_shape.size());
+      for (size_t i = 0; i < attr_shape.size(); i++)
+        {
+          resize_attrs(attrs[i], *(attr_shape[i]));
+        }
+    }
+
+    void EdgeCSR::init_attrs (const vector<AttrVal>& attr_shape)
+    {
+      attrs.resize(attr_shape.size());
+      for (size_t i = 0; i < attr_shape.size(); i++)
+        {
+          resize_attrs(attrs[i], attr_shape[i]);
+        }
+    }
+
+    void EdgeCSR::append_row (const NODE_IDX_T key,
+                              const vector<NODE_IDX_T>& adj_values,
+                              const vector<const AttrVal*>& attr_values,
+                              const size_t low, const size_t high,
+                              const NODE_IDX_T adj_offset)
+    {
+      throw_assert(attrs.size() == attr_values.size(),
+                   "EdgeCSR::append_row: mismatch in number of attribute namespaces");
+
+      keys.push_back(key);
+      adj.reserve(adj.size() + (high - low));
+      for (size_t j = low; j < high; ++j)
+        {
+          adj.push_back(adj_values[j] + adj_offset);
+        }
+      offsets.push_back(adj.size());
+
+      for (size_t i = 0; i < attr_values.size(); i++)
+        {
+          append_attrs(attrs[i], *(attr_values[i]), low, high);
+        }
+    }
+
+    void EdgeCSR::append_row (const EdgeCSR& other, const size_t i)
+    {
+      const NODE_IDX_T key = other.keys[i];
+      const size_t low = other.offsets[i], high = other.offsets[i+1];
+
+      if (attrs.size() < other.attrs.size())
+        {
+          init_attrs(other.attrs);
+        }
+
+      if (keys.empty() || (keys.back() != key))
+        {
+          throw_assert(keys.empty() || (keys.back() < key),
+                       "EdgeCSR::append_row: rows must be appended in ascending key order");
+          keys.push_back(key);
+          offsets.push_back(adj.size());
+        }
+
+      adj.insert(adj.end(), other.adj.begin()+low, other.adj.begin()+high);
+      offsets.back() = adj.size();
+
+      for (size_t ns = 0; ns < other.attrs.size(); ns++)
+        {
+          append_attrs(attrs[ns], other.attrs[ns], low, high);
+        }
+    }
+
+    void EdgeCSR::push_back (const NODE_IDX_T key, const NODE_IDX_T adj_node,
+                             const vector<const AttrVal*>& attr_values,
+                             const size_t edge_index)
+    {
+      if (keys.empty() || (keys.back() != key))
+        {
+          keys.push_back(key);
+          offsets.push_back(adj.size());
+        }
+      adj.push_back(adj_node);
+      offsets.back() = adj.size();
+
+      for (size_t i = 0; i < attr_values.size(); i++)
+        {
+          append_attrs(attrs[i], *(attr_values[i]), edge_index, edge_index+1);
+        }
+    }
+
+    void EdgeCSR::sort_rows ()
+    {
+      bool sorted = true;
+      for (size_t i = 1; i < keys.size(); i++)
+        {
+          if (!(keys[i-1] < keys[i]))
+            {
+              sorted = false;
+              break;
+            }
+        }
+      if (sorted)
+        return;
+
+      vector<size_t> perm(keys.size());
+      for (size_t i = 0; i < perm.size(); i++)
+        {
+          perm[i] = i;
+        }
+      std::stable_sort(perm.begin(), perm.end(),
+                       [&] (size_t i, size_t j) { return keys[i] < keys[j]; });
+
+      EdgeCSR unsorted(std::move(*this));
+      clear();
+      edge_map_type = unsorted.edge_map_type;
+      init_attrs(unsorted.attrs);
+      adj.reserve(unsorted.adj.size());
+      for (const size_t i : perm)
+        {
+          append_row(unsorted, i);
+        }
+    }
+
+    void EdgeCSR::edge_tuple (const size_t i, edge_tuple_t& et) const
+    {
+      const size_t low = offsets[i], high = offsets[i+1];
+      vector<NODE_IDX_T>& adj_vector = get<0>(et);
+      vector<AttrVal>& edge_attr_vector = get<1>(et);
+
+      adj_vector.assign(adj.begin()+low, adj.begin()+high);
+      edge_attr_vector.resize(attrs.size());
+      for (size_t ns = 0; ns < attrs.size(); ns++)
+        {
+          copy_attrs(edge_attr_vector[ns], attrs[ns], low, high);
+        }
+    }
+
+    void EdgeCSR::clear ()
+    {
+      keys.clear();
+      offsets.assign(1, 0);
+      adj.clear();
+      attrs.clear();
+    }
+
+    void EdgeCSR::to_edge_map (edge_map_t& edge_map) const
+    {
+      for (size_t i = 0; i < keys.size(); i++)
+        {
+          edge_tuple_t& et = edge_map[keys[i]];
+          if (get<0>(et).empty())
+            {
+              edge_tuple(i, et);
+            }
+          else
+            {
+              edge_tuple_t row;
+              edge_tuple(i, row);
+              vector<NODE_IDX_T>& v = get<0>(et);
+              v.insert(v.end(), get<0>(row).begin(), get<0>(row).end());
+              vector<AttrVal>& va = get<1>(et);
+              for (size_t ns = 0; ns < va.size(); ns++)
+                {
+                  va[ns].append(get<1>(row)[ns]);
+                }
+            }
+        }
+    }
+
+    void EdgeCSR::from_edge_map (const edge_map_t& edge_map)
+    {
+      clear();
+
+      for (auto it = edge_map.cbegin(); it != edge_map.cend(); ++it)
+        {
+          const vector<NODE_IDX_T>& adj_vector = get<0>(it->second);
+          const vector<AttrVal>& edge_attr_vector = get<1>(it->second);
+
+          if (attrs.size() < edge_attr_vector.size())
+            {
+              init_attrs(edge_attr_vector);
+            }
+
+          keys.push_back(it->first);
+          adj.insert(adj.end(), adj_vector.begin(), adj_vector.end());
+          offsets.push_back(adj.size());
+
+          for (size_t ns = 0; ns < edge_attr_vector.size(); ns++)
+            {
+              resize_attrs(attrs[ns], edge_attr_vector[ns]);
+              append_attrs(attrs[ns], edge_attr_vector[ns], 0, adj_vector.size());
+            }
+        }
+    }
+
+
+    void edge_attr_ptrs (const map<string, NamedAttrVal>& edge_attr_map,
+                         const vector<string>& attr_namespaces,
+                         vector<const AttrVal*>& attr_values)
+    {
+      attr_values.clear();
+      for (const string& attr_namespace : attr_namespaces)
+        {
+          auto it = edge_attr_map.find(attr_namespace);
+          throw_assert(it != edge_attr_map.cend(),
+                       "edge_attr_ptrs: unable to find namespace " << attr_namespace);
+          attr_values.push_back(&(it->second));
+        }
+    }
+
+
+    void merge_edge_csr (const vector<EdgeCSR>& inputs,
+                         EdgeCSR& output)
+    {
+      output.clear();
+
+      size_t total_num_nodes = 0, total_num_edges = 0;
+      for (const EdgeCSR& input : inputs)
+        {
+          total_num_nodes += input.num_nodes();
+          total_num_edges += input.num_edges();
+          if (output.attrs.size() < input.attrs.size())
+            {
+              output.init_attrs(input.attrs);
+            }
+          if (input.num_nodes() > 0)
+            {
+              output.edge_map_type = input.edge_map_type;
+            }
+        }
+
+      output.keys.reserve(total_num_nodes);
+      output.offsets.reserve(total_num_nodes+1);
+      output.adj.reserve(total_num_edges);
+
+      // k-way merge of the sorted key sequences with a heap of input
+      // cursors; ties are resolved in input order so that edges of a key
+      // node keep their read order
+      typedef pair<NODE_IDX_T, size_t> cursor_t;
+      priority_queue<cursor_t, vector<cursor_t>, std::greater<cursor_t> > heap;
+      vector<size_t> pos(inputs.size(), 0);
+      for (size_t k = 0; k < inputs.size(); k++)
+        {
+          if (inputs[k].num_nodes() > 0)
+            heap.push(make_pair(inputs[k].keys[0], k));
+        }
+
+      while (!heap.empty())
+        {
+          const size_t k = heap.top().second;
+          heap.pop();
+          output.append_row(inputs[k], pos[k]);
+          pos[k]++;
+          if (pos[k] < inputs[k].num_nodes())
+            heap.push(make_pair(inputs[k].keys[pos[k]], k));
+        }
+    }
+
+  }
+}
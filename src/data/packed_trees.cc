@@ -0,0 +1,244 @@
+// -*- mode: c++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+//==============================================================================
+///  @file packed_trees.cc
+///
+///  Contiguous storage of tree structures.
+///
+///  Copyright (C) 2016-2025 Project NeuroH5.
+//==============================================================================
+
+#include <algorithm>
+#include <deque>
+#include <forward_list>
+#include <map>
+#include <string>
+#include <vector>
+
+#include "packed_trees.hh"
+#include "path_names.hh"
+#include "throw_assert.hh"
+
+using namespace std;
+
+namespace neuroh5
+{
+  namespace data
+  {
+
+    template <class T, class Input>
+    static void append_field (vector<T>& values, const Input& input)
+    {
+      values.insert(values.end(), input.begin(), input.end());
+    }
+
+    template <class T>
+    static void append_range (vector<T>& values, const vector<T>& input,
+                              const size_t low, const size_t high)
+    {
+      values.insert(values.end(), input.begin()+low, input.begin()+high);
+    }
+
+    template <class T, class P>
+    static void copy_range (deque<T>& output, const vector<T>& input,
+                            const vector<P>& ptr, const size_t i)
+    {
+      output.assign(input.begin()+ptr[i], input.begin()+ptr[i+1]);
+    }
+
+    /// Moves the values of one attribute of the Trees namespace into
+    /// values; the pointer of the attribute becomes ptr, or is checked
+    /// against ptr if ptr has already been set by another attribute that
+    /// shares it.
+    template <class T, class P>
+    static void move_tree_column (ColumnarAttrMap& attr_values,
+                                  const string& attr_name,
+                                  const vector<CELL_IDX_T>& gids,
+                                  vector<P>& ptr,
+                                  vector<T>& values)
+    {
+      AttrColumn<T>& column = attr_values.columns<T>()[attr_values.attr_index<T>(attr_name)];
+      if (column.index != gids)
+        {
+          // align rows with the gids of all trees; trees without values
+          // for this attribute get empty rows
+          AttrColumn<T> aligned;
+          for (const CELL_IDX_T gid : gids)
+            {
+              const size_t row = column.find(gid);
+              if (row < column.size())
+                {
+                  aligned.append_row(gid, column.row_data(row), column.row_size(row));
+                }
+              else
+                {
+                  aligned.append_row(gid, aligned.values.data(), 0);
+                }
+            }
+          column = std::move(aligned);
+        }
+
+      if (ptr.size() > 1)
+        {
+          throw_assert(std::equal(ptr.begin(), ptr.end(), column.ptr.begin(), column.ptr.end()),
+                       "PackedTrees::from_attr_map: inconsistent pointer for attribute " << attr_name);
+        }
+      else
+        {
+          ptr.assign(column.ptr.begin(), column.ptr.end());
+        }
+      values = std::move(column.values);
+      column.clear();
+    }
+
+
+    size_t PackedTrees::find (const CELL_IDX_T gid) const
+    {
+      auto it = std::lower_bound(gids.cbegin(), gids.cend(), gid);
+      if ((it != gids.cend()) && (*it == gid))
+        {
+          return std::distance(gids.cbegin(), it);
+        }
+      return gids.size();
+    }
+
+    void PackedTrees::append (const neurotree_t& tree)
+    {
+      gids.push_back(get<0>(tree));
+
+      append_field(src_sections, get<1>(tree));
+      append_field(dst_sections, get<2>(tree));
+      topo_ptr.push_back(src_sections.size());
+
+      append_field(sections, get<3>(tree));
+      sec_ptr.push_back(sections.size());
+
+      append_field(xcoords, get<4>(tree));
+      append_field(ycoords, get<5>(tree));
+      append_field(zcoords, get<6>(tree));
+      append_field(radiuses, get<7>(tree));
+      append_field(layers, get<8>(tree));
+      append_field(parents, get<9>(tree));
+      append_field(swc_types, get<10>(tree));
+      attr_ptr.push_back(xcoords.size());
+    }
+
+    void PackedTrees::sort_trees ()
+    {
+      if (std::is_sorted(gids.cbegin(), gids.cend()))
+        return;
+
+      vector<size_t> perm(gids.size());
+      for (size_t i = 0; i < perm.size(); i++)
+        {
+          perm[i] = i;
+        }
+      std::stable_sort(perm.begin(), perm.end(),
+                       [&] (size_t i, size_t j) { return gids[i] < gids[j]; });
+
+      PackedTrees unsorted(std::move(*this));
+      clear();
+      for (const size_t i : perm)
+        {
+          gids.push_back(unsorted.gids[i]);
+
+          append_range(src_sections, unsorted.src_sections, unsorted.topo_ptr[i], unsorted.topo_ptr[i+1]);
+          append_range(dst_sections, unsorted.dst_sections, unsorted.topo_ptr[i], unsorted.topo_ptr[i+1]);
+          topo_ptr.push_back(src_sections.size());
+
+          append_range(sections, unsorted.sections, unsorted.sec_ptr[i], unsorted.sec_ptr[i+1]);
+          sec_ptr.push_back(sections.size());
+
+          const size_t low = unsorted.attr_ptr[i], high = unsorted.attr_ptr[i+1];
+          append_range(xcoords, unsorted.xcoords, low, high);
+          append_range(ycoords, unsorted.ycoords, low, high);
+          append_range(zcoords, unsorted.zcoords, low, high);
+          append_range(radiuses, unsorted.radiuses, low, high);
+          append_range(layers, unsorted.layers, low, high);
+          append_range(parents, unsorted.parents, low, high);
+          append_range(swc_types, unsorted.swc_types, low, high);
+          attr_ptr.push_back(xcoords.size());
+        }
+    }
+
+    void PackedTrees::tree (const size_t i, neurotree_t& tree) const
+    {
+      get<0>(tree) = gids[i];
+      copy_range(get<1>(tree), src_sections, topo_ptr, i);
+      copy_range(get<2>(tree), dst_sections, topo_ptr, i);
+      copy_range(get<3>(tree), sections, sec_ptr, i);
+      copy_range(get<4>(tree), xcoords, attr_ptr, i);
+      copy_range(get<5>(tree), ycoords, attr_ptr, i);
+      copy_range(get<6>(tree), zcoords, attr_ptr, i);
+      copy_range(get<7>(tree), radiuses, attr_ptr, i);
+      copy_range(get<8>(tree), layers, attr_ptr, i);
+      copy_range(get<9>(tree), parents, attr_ptr, i);
+      copy_range(get<10>(tree), swc_types, attr_ptr, i);
+    }
+
+    void PackedTrees::clear ()
+    {
+      gids.clear();
+      topo_ptr.assign(1, 0);
+      src_sections.clear();
+      dst_sections.clear();
+      sec_ptr.assign(1, 0);
+      sections.clear();
+      attr_ptr.assign(1, 0);
+      xcoords.clear();
+      ycoords.clear();
+      zcoords.clear();
+      radiuses.clear();
+      layers.clear();
+      parents.clear();
+      swc_types.clear();
+    }
+
+    void PackedTrees::from_attr_map (ColumnarAttrMap&& attr_values)
+    {
+      clear();
+      gids = attr_values.index;
+      if (gids.empty())
+        {
+          attr_values.clear();
+          return;
+        }
+
+      topo_ptr.clear();
+      move_tree_column(attr_values, hdf5::SRCSEC, gids, topo_ptr, src_sections);
+      move_tree_column(attr_values, hdf5::DSTSEC, gids, topo_ptr, dst_sections);
+
+      sec_ptr.clear();
+      move_tree_column(attr_values, hdf5::SECTION, gids, sec_ptr, sections);
+
+      attr_ptr.clear();
+      move_tree_column(attr_values, hdf5::X_COORD, gids, attr_ptr, xcoords);
+      move_tree_column(attr_values, hdf5::Y_COORD, gids, attr_ptr, ycoords);
+      move_tree_column(attr_values, hdf5::Z_COORD, gids, attr_ptr, zcoords);
+      move_tree_column(attr_values, hdf5::RADIUS, gids, attr_ptr, radiuses);
+      move_tree_column(attr_values, hdf5::LAYER, gids, attr_ptr, layers);
+      move_tree_column(attr_values, hdf5::PARENT, gids, attr_ptr, parents);
+      move_tree_column(attr_values, hdf5::SWCTYPE, gids, attr_ptr, swc_types);
+
+      attr_values.clear();
+    }
+
+    void PackedTrees::to_tree_list (forward_list<neurotree_t>& tree_list) const
+    {
+      for (size_t i = 0; i < gids.size(); i++)
+        {
+          neurotree_t t;
+          tree(i, t);
+          tree_list.push_front(std::move(t));
+        }
+    }
+
+    void PackedTrees::to_tree_map (map<CELL_IDX_T, neurotree_t>& tree_map) const
+    {
+      for (size_t i = 0; i < gids.size(); i++)
+        {
+          tree(i, tree_map[gids[i]]);
+        }
+    }
+
+  }
+}
@@ -98,7 +98,18 @@ namespace neuroh5
                                     const vector<size_t>& rdispls,
                                     AttrMap& all_attr_map)
     {
-      const size_t recvbuf_size = recvbuf.size();
+      deserialize_rank_attr_map(num_ranks, recvbuf.data(), recvbuf.size(), recvcounts, rdispls,
+                                all_attr_map);
+    }
+
+
+    void deserialize_rank_attr_map (const size_t num_ranks,
+                                    const char *recvbuf,
+                                    const size_t recvbuf_size,
+                                    const vector<size_t>& recvcounts,
+                                    const vector<size_t>& rdispls,
+                                    AttrMap& all_attr_map)
+    {
 
       for (rank_t ridx = 0; ridx < num_ranks; ridx++)
         {
@@ -114,8 +125,8 @@ namespace neuroh5
 
               
               {
-                const string& s = string(recvbuf.begin()+startpos,
-                                         recvbuf.begin()+startpos+recvsize);
+                const string& s = string(recvbuf+startpos,
+                                         recvbuf+startpos+recvsize);
                 stringstream ss(s, ios::in | ios::out | ios::binary);
 
                 cereal::BinaryInputArchive iarchive(ss); // Create an input archive
@@ -130,5 +141,324 @@ namespace neuroh5
         }
     }
 
+
+    /*
+     * Wire format of a columnar attribute map:
+     *
+     * uint64_t  packed size in bytes, including this field
+     * uint32_t  number of columns of each type, in AttrMap type index order
+     * for each type and column:
+     *   uint64_t      number of rows, number of values
+     *   CELL_IDX_T    index of each row
+     *   ATTR_PTR_T    pointer of each row, plus the end pointer
+     *   T             values
+     */
+
+    template <class T>
+    static inline void pack_values (char*& pos, const T* values, const size_t n)
+    {
+      if (n > 0)
+        {
+          memcpy(pos, values, n*sizeof(T));
+          pos += n*sizeof(T);
+        }
+    }
+
+    template <class T>
+    static inline void unpack_values (const char*& pos, const char* end, T* values, const size_t n)
+    {
+      throw_assert(pos + n*sizeof(T) <= end,
+                   "deserialize_rank_attr_map: buffer is too short");
+      if (n > 0)
+        {
+          memcpy(values, pos, n*sizeof(T));
+          pos += n*sizeof(T);
+        }
+    }
+
+    template <class T>
+    static size_t attr_columns_packed_size (const ColumnarAttrMap& attr_map)
+    {
+      size_t size = 0;
+      for (const AttrColumn<T>& column : attr_map.columns<T>())
+        {
+          size += 2*sizeof(uint64_t) + column.size()*sizeof(CELL_IDX_T) +
+            (column.size()+1)*sizeof(ATTR_PTR_T) + column.values.size()*sizeof(T);
+        }
+      return size;
+    }
+
+    static size_t attr_map_packed_size (const ColumnarAttrMap& attr_map)
+    {
+      return sizeof(uint64_t) + AttrMap::num_attr_types*sizeof(uint32_t) +
+        attr_columns_packed_size<float>(attr_map) +
+        attr_columns_packed_size<uint8_t>(attr_map) +
+        attr_columns_packed_size<int8_t>(attr_map) +
+        attr_columns_packed_size<uint16_t>(attr_map) +
+        attr_columns_packed_size<int16_t>(attr_map) +
+        attr_columns_packed_size<uint32_t>(attr_map) +
+        attr_columns_packed_size<int32_t>(attr_map);
+    }
+
+    template <class T>
+    static void pack_attr_columns (char*& pos, const ColumnarAttrMap& attr_map)
+    {
+      for (const AttrColumn<T>& column : attr_map.columns<T>())
+        {
+          uint64_t counts[2] = { column.size(), column.values.size() };
+          pack_values(pos, counts, 2);
+          pack_values(pos, column.index.data(), column.size());
+          pack_values(pos, column.ptr.data(), column.size()+1);
+          pack_values(pos, column.values.data(), column.values.size());
+        }
+    }
+
+    static void pack_attr_map (const ColumnarAttrMap& attr_map, const size_t size, char* buf)
+    {
+      char* pos = buf;
+      uint64_t packed_size = size;
+      pack_values(pos, &packed_size, 1);
+
+      vector<size_t> num_attrs;
+      attr_map.num_attrs(num_attrs);
+      uint32_t num_columns[AttrMap::num_attr_types];
+      for (size_t t = 0; t < AttrMap::num_attr_types; t++)
+        {
+          num_columns[t] = num_attrs[t];
+        }
+      pack_values(pos, num_columns, AttrMap::num_attr_types);
+
+      pack_attr_columns<float>(pos, attr_map);
+      pack_attr_columns<uint8_t>(pos, attr_map);
+      pack_attr_columns<int8_t>(pos, attr_map);
+      pack_attr_columns<uint16_t>(pos, attr_map);
+      pack_attr_columns<int16_t>(pos, attr_map);
+      pack_attr_columns<uint32_t>(pos, attr_map);
+      pack_attr_columns<int32_t>(pos, attr_map);
+
+      throw_assert(pos == buf + size,
+                   "serialize_rank_attr_map: packed size mismatch");
+    }
+
+    template <class T>
+    static void unpack_attr_columns (const char*& pos, const char* end, const uint32_t num_columns,
+                                     ColumnarAttrMap& attr_map)
+    {
+      for (size_t i = 0; i < num_columns; i++)
+        {
+          uint64_t counts[2];
+          unpack_values(pos, end, counts, 2);
+          AttrColumn<T> column;
+          column.index.resize(counts[0]);
+          column.ptr.resize(counts[0]+1);
+          column.values.resize(counts[1]);
+          unpack_values(pos, end, column.index.data(), counts[0]);
+          unpack_values(pos, end, column.ptr.data(), counts[0]+1);
+          unpack_values(pos, end, column.values.data(), counts[1]);
+          attr_map.insert(i, std::move(column));
+        }
+    }
+
+    
+    void serialize_rank_attr_map (const size_t num_ranks,
+                                  const size_t start_rank,
+                                  const map <rank_t, ColumnarAttrMap>& rank_attr_map,
+                                  vector<size_t>& sendcounts,
+                                  vector<char> &sendbuf,
+                                  vector<size_t> &sdispls)
+    {
+      sdispls.resize(num_ranks);
+      sendcounts.resize(num_ranks);
+
+      throw_assert(start_rank < num_ranks, "serialize_rank_attr_map: invalid start rank");
+
+      // Recommended all-to-all communication pattern: start at the current rank, then wrap around;
+      // (as opposed to starting at rank 0)
+      vector<rank_t> rank_sequence;
+      for (rank_t key_rank = start_rank; key_rank < num_ranks; key_rank++)
+        {
+          rank_sequence.push_back(key_rank);
+        }
+      for (rank_t key_rank = 0; key_rank < start_rank; key_rank++)
+        {
+          rank_sequence.push_back(key_rank);
+        }
+
+      size_t sendpos = sendbuf.size();
+      for (const rank_t& key_rank : rank_sequence)
+        {
+          sdispls[key_rank] = sendpos;
+          auto it = rank_attr_map.find(key_rank);
+          sendcounts[key_rank] = (it != rank_attr_map.end()) ? attr_map_packed_size(it->second) : 0;
+          sendpos += sendcounts[key_rank];
+        }
+
+      sendbuf.resize(sendpos);
+      for (const rank_t& key_rank : rank_sequence)
+        {
+          auto it = rank_attr_map.find(key_rank);
+          if (it != rank_attr_map.end())
+            {
+              pack_attr_map(it->second, sendcounts[key_rank], &sendbuf[sdispls[key_rank]]);
+            }
+        }
+    }
+
+
+    void deserialize_rank_attr_map (const size_t num_ranks,
+                                    const vector<char> &recvbuf,
+                                    const vector<size_t>& recvcounts,
+                                    const vector<size_t>& rdispls,
+                                    ColumnarAttrMap& all_attr_map)
+    {
+      deserialize_rank_attr_map(num_ranks, recvbuf.data(), recvbuf.size(), recvcounts, rdispls,
+                                all_attr_map);
+    }
+
+
+    void deserialize_rank_attr_map (const size_t num_ranks,
+                                    const char *recvbuf,
+                                    const size_t recvbuf_size,
+                                    const vector<size_t>& recvcounts,
+                                    const vector<size_t>& rdispls,
+                                    ColumnarAttrMap& all_attr_map)
+    {
+
+      for (rank_t ridx = 0; ridx < num_ranks; ridx++)
+        {
+          if (recvcounts[ridx] > 0)
+            {
+              throw_assert((rdispls[ridx] < recvbuf_size) &&
+                           (rdispls[ridx] + recvcounts[ridx] <= recvbuf_size),
+                           "deserialize_rank_attr_map: invalid buffer displacement");
+
+              const char* pos = &recvbuf[rdispls[ridx]];
+              const char* end = pos + recvcounts[ridx];
+
+              uint64_t packed_size;
+              unpack_values(pos, end, &packed_size, 1);
+              throw_assert(packed_size == recvcounts[ridx],
+                           "deserialize_rank_attr_map: packed size mismatch");
+
+              uint32_t num_columns[AttrMap::num_attr_types];
+              unpack_values(pos, end, num_columns, AttrMap::num_attr_types);
+
+              unpack_attr_columns<float>(pos, end, num_columns[AttrMap::attr_index_float], all_attr_map);
+              unpack_attr_columns<uint8_t>(pos, end, num_columns[AttrMap::attr_index_uint8], all_attr_map);
+              unpack_attr_columns<int8_t>(pos, end, num_columns[AttrMap::attr_index_int8], all_attr_map);
+              unpack_attr_columns<uint16_t>(pos, end, num_columns[AttrMap::attr_index_uint16], all_attr_map);
+              unpack_attr_columns<int16_t>(pos, end, num_columns[AttrMap::attr_index_int16], all_attr_map);
+              unpack_attr_columns<uint32_t>(pos, end, num_columns[AttrMap::attr_index_uint32], all_attr_map);
+              unpack_attr_columns<int32_t>(pos, end, num_columns[AttrMap::attr_index_int32], all_attr_map);
+            }
+        }
+    }
+
+
+    void pack_rank_attr_segments (const size_t num_ranks,
+                                  const vector< vector<size_t> >& segment_sendcounts,
+                                  const vector< vector<size_t> >& segment_sdispls,
+                                  const vector< vector<char> >& segment_sendbufs,
+                                  vector<size_t>& sendcounts,
+                                  vector<char> &sendbuf,
+                                  vector<size_t> &sdispls)
+    {
+      const size_t num_segments = segment_sendbufs.size();
+
+      sendcounts.assign(num_ranks, 0);
+      sdispls.assign(num_ranks, 0);
+
+      size_t total_size = 0;
+      for (size_t ridx = 0; ridx < num_ranks; ridx++)
+        {
+          size_t rank_size = 0;
+          for (size_t k = 0; k < num_segments; k++)
+            {
+              if (segment_sendcounts[k].size() > 0)
+                rank_size += segment_sendcounts[k][ridx];
+            }
+          if (rank_size > 0)
+            {
+              rank_size += num_segments*sizeof(uint64_t);
+            }
+          sdispls[ridx] = total_size;
+          sendcounts[ridx] = rank_size;
+          total_size += rank_size;
+        }
+
+      sendbuf.resize(total_size);
+      for (size_t ridx = 0; ridx < num_ranks; ridx++)
+        {
+          if (sendcounts[ridx] == 0)
+            continue;
+          char* pos = &sendbuf[sdispls[ridx]];
+          for (size_t k = 0; k < num_segments; k++)
+            {
+              uint64_t segment_size = (segment_sendcounts[k].size() > 0) ? segment_sendcounts[k][ridx] : 0;
+              memcpy(pos, &segment_size, sizeof(uint64_t));
+              pos += sizeof(uint64_t);
+            }
+          for (size_t k = 0; k < num_segments; k++)
+            {
+              if ((segment_sendcounts[k].size() > 0) && (segment_sendcounts[k][ridx] > 0))
+                {
+                  memcpy(pos, &segment_sendbufs[k][segment_sdispls[k][ridx]], segment_sendcounts[k][ridx]);
+                  pos += segment_sendcounts[k][ridx];
+                }
+            }
+        }
+    }
+
+
+    void unpack_rank_attr_segments (const size_t num_ranks,
+                                    const size_t num_segments,
+                                    const vector<char> &recvbuf,
+                                    const vector<size_t>& recvcounts,
+                                    const vector<size_t>& rdispls,
+                                    vector< vector<size_t> >& segment_recvcounts,
+                                    vector< vector<size_t> >& segment_rdispls)
+    {
+      unpack_rank_attr_segments(num_ranks, num_segments, recvbuf.data(), recvbuf.size(),
+                                recvcounts, rdispls, segment_recvcounts, segment_rdispls);
+    }
+
+
+    void unpack_rank_attr_segments (const size_t num_ranks,
+                                    const size_t num_segments,
+                                    const char *recvbuf,
+                                    const size_t recvbuf_size,
+                                    const vector<size_t>& recvcounts,
+                                    const vector<size_t>& rdispls,
+                                    vector< vector<size_t> >& segment_recvcounts,
+                                    vector< vector<size_t> >& segment_rdispls)
+    {
+      segment_recvcounts.assign(num_segments, vector<size_t>(num_ranks, 0));
+      segment_rdispls.assign(num_segments, vector<size_t>(num_ranks, 0));
+
+      for (size_t ridx = 0; ridx < num_ranks; ridx++)
+        {
+          if (recvcounts[ridx] == 0)
+            continue;
+
+          throw_assert(rdispls[ridx] + recvcounts[ridx] <= recvbuf_size,
+                       "unpack_rank_attr_segments: invalid buffer displacement");
+          throw_assert(recvcounts[ridx] >= num_segments*sizeof(uint64_t),
+                       "unpack_rank_attr_segments: message is too short");
+
+          const char* header = &recvbuf[rdispls[ridx]];
+          size_t pos = rdispls[ridx] + num_segments*sizeof(uint64_t);
+          for (size_t k = 0; k < num_segments; k++)
+            {
+              uint64_t segment_size;
+              memcpy(&segment_size, header + k*sizeof(uint64_t), sizeof(uint64_t));
+              segment_recvcounts[k][ridx] = segment_size;
+              segment_rdispls[k][ridx] = pos;
+              pos += segment_size;
+            }
+          throw_assert(pos == rdispls[ridx] + recvcounts[ridx],
+                       "unpack_rank_attr_segments: segment sizes do not match message size");
+        }
+    }
+
   }
 }
@@ -4,7 +4,7 @@
 ///
 ///  Top-level functions for serializing/deserializing graphs edges.
 ///
-///  Copyright (C) 2016-2024 Project NeuroH5.
+///  Copyright (C) 2016-2025 Project NeuroH5.
 //==============================================================================
 
 #include "debug.hh"
@@ -21,9 +21,15 @@
 #include <bitset>
 #include <climits>
 #include <map>
+#include <queue>
 #include <vector>
+#include <algorithm>
+#include <exception>
+#include <functional>
 
-#include "cereal/archives/binary.hpp"
+#ifdef _OPENMP
+#include <omp.h>
+#endif
 
 #include "throw_assert.hh"
 
@@ -35,91 +41,624 @@ namespace neuroh5
   namespace data
   {
 
-    void serialize_rank_edge_map (const size_t num_ranks,
-                                  const size_t start_rank,
-                                  const rank_edge_map_t& prj_rank_edge_map, 
-                                  size_t &num_packed_edges,
-                                  vector<size_t>& sendcounts,
-                                  vector<char> &sendbuf,
-                                  vector<size_t> &sdispls)
+    /*
+     * Edge wire format
+     *
+     * Each container is packed as a length-prefixed sequence of flat
+     * columns in native byte order:
+     *
+     *   EdgeWireHeader
+     *   column counts   [num_namespaces * AttrVal::num_attr_types] (uint32_t)
+     *   keys            [num_nodes]   (NODE_IDX_T)
+     *   offsets         [num_nodes+1] (DST_PTR_T)
+     *   adj             [num_edges]   (NODE_IDX_T)
+     *   attribute values, for each namespace, each attribute type in
+     *   AttrVal index order and each column: [num_edges] values
+     *
+     * Buffers are sized in advance and filled with memcpy, and the
+     * receiving side resizes the target containers from the header
+     * before copying the columns out.
+     */
+    struct EdgeWireHeader
     {
-      vector<rank_t> rank_sequence;
+      uint64_t packed_size;
+      uint64_t num_nodes;
+      uint64_t num_edges;
+      uint32_t edge_map_type;
+      uint32_t num_namespaces;
+    };
 
-      sendcounts.resize(num_ranks);
-      sdispls.resize(num_ranks);
+    template <class T>
+    static inline void pack_values (char*& pos, const T* values, const size_t n)
+    {
+      if (n > 0)
+        {
+          memcpy(pos, values, n*sizeof(T));
+          pos += n*sizeof(T);
+        }
+    }
+
+    template <class T>
+    static inline void unpack_values (const char*& pos, const char* end, T* values, const size_t n)
+    {
+      throw_assert(pos + n*sizeof(T) <= end,
+                   "unpack_edge_csr: buffer is too short");
+      if (n > 0)
+        {
+          memcpy(values, pos, n*sizeof(T));
+          pos += n*sizeof(T);
+        }
+    }
+
+    template <class T>
+    static inline void get_column_counts (const AttrVal& attr_val, uint32_t* column_counts)
+    {
+      column_counts[AttrVal::attr_type_index<T>()] = attr_val.size_attr_vec<T>();
+    }
+    
+    static void get_column_counts (const AttrVal& attr_val, uint32_t* column_counts)
+    {
+      get_column_counts<float>(attr_val, column_counts);
+      get_column_counts<uint8_t>(attr_val, column_counts);
+      get_column_counts<int8_t>(attr_val, column_counts);
+      get_column_counts<uint16_t>(attr_val, column_counts);
+      get_column_counts<int16_t>(attr_val, column_counts);
+      get_column_counts<uint32_t>(attr_val, column_counts);
+      get_column_counts<int32_t>(attr_val, column_counts);
+    }
+
+    static size_t column_value_size (const uint32_t* column_counts)
+    {
+      return
+        column_counts[AttrVal::attr_index_float]  * sizeof(float) +
+        column_counts[AttrVal::attr_index_uint8]  * sizeof(uint8_t) +
+        column_counts[AttrVal::attr_index_int8]   * sizeof(int8_t) +
+        column_counts[AttrVal::attr_index_uint16] * sizeof(uint16_t) +
+        column_counts[AttrVal::attr_index_int16]  * sizeof(int16_t) +
+        column_counts[AttrVal::attr_index_uint32] * sizeof(uint32_t) +
+        column_counts[AttrVal::attr_index_int32]  * sizeof(int32_t);
+    }
+
+    static size_t packed_size (const size_t num_nodes, const size_t num_edges,
+                               const vector<uint32_t>& column_counts)
+    {
+      size_t size = sizeof(EdgeWireHeader) +
+        column_counts.size() * sizeof(uint32_t) +
+        num_nodes * sizeof(NODE_IDX_T) +
+        (num_nodes+1) * sizeof(DST_PTR_T) +
+        num_edges * sizeof(NODE_IDX_T);
+      for (size_t i = 0; i < column_counts.size(); i += AttrVal::num_attr_types)
+        {
+          size += num_edges * column_value_size(&column_counts[i]);
+        }
+      return size;
+    }
+
+    
+    /*************************************************************************
+     * Packing of flat edge containers
+     *************************************************************************/
+
+    template <class T>
+    static void pack_columns (char*& pos, const AttrVal& attr_val)
+    {
+      for (size_t k = 0; k < attr_val.size_attr_vec<T>(); k++)
+        {
+          const vector<T>& values = attr_val.const_attr_vec<T>(k);
+          pack_values(pos, values.data(), values.size());
+        }
+    }
 
-      size_t end_rank = num_ranks;
-      throw_assert(start_rank < end_rank, "serialize_rank_edge_map: invalid start rank");
+    static size_t edge_csr_packed_size (const EdgeCSR& edge_csr)
+    {
+      vector<uint32_t> column_counts(edge_csr.attrs.size() * AttrVal::num_attr_types, 0);
+      for (size_t ns = 0; ns < edge_csr.attrs.size(); ns++)
+        {
+          get_column_counts(edge_csr.attrs[ns], &column_counts[ns * AttrVal::num_attr_types]);
+        }
+      return packed_size(edge_csr.num_nodes(), edge_csr.num_edges(), column_counts);
+    }
+    
+    static void pack_edge_csr (const EdgeCSR& edge_csr, const size_t size, char* buf)
+    {
+      char* pos = buf;
       
-      // Recommended all-to-all communication pattern: start at the current rank, then wrap around;
-      // (as opposed to starting at rank 0)
-      for (rank_t key_rank = start_rank; key_rank < end_rank; key_rank++)
+      EdgeWireHeader header;
+      header.packed_size    = size;
+      header.num_nodes      = edge_csr.num_nodes();
+      header.num_edges      = edge_csr.num_edges();
+      header.edge_map_type  = edge_csr.edge_map_type;
+      header.num_namespaces = edge_csr.attrs.size();
+      pack_values(pos, &header, 1);
+      
+      vector<uint32_t> column_counts(AttrVal::num_attr_types, 0);
+      for (const AttrVal& attr_val : edge_csr.attrs)
         {
-          rank_sequence.push_back(key_rank);
+          get_column_counts(attr_val, &column_counts[0]);
+          pack_values(pos, column_counts.data(), column_counts.size());
         }
-      for (rank_t key_rank = 0; key_rank < start_rank; key_rank++)
+
+      throw_assert(edge_csr.offsets.size() == edge_csr.num_nodes()+1,
+                   "pack_edge_csr: invalid offsets array");
+      pack_values(pos, edge_csr.keys.data(), edge_csr.keys.size());
+      pack_values(pos, edge_csr.offsets.data(), edge_csr.offsets.size());
+      pack_values(pos, edge_csr.adj.data(), edge_csr.adj.size());
+
+      for (const AttrVal& attr_val : edge_csr.attrs)
         {
-          rank_sequence.push_back(key_rank);
+          pack_columns<float>(pos, attr_val);
+          pack_columns<uint8_t>(pos, attr_val);
+          pack_columns<int8_t>(pos, attr_val);
+          pack_columns<uint16_t>(pos, attr_val);
+          pack_columns<int16_t>(pos, attr_val);
+          pack_columns<uint32_t>(pos, attr_val);
+          pack_columns<int32_t>(pos, attr_val);
         }
 
-      size_t sendpos = 0;
-      std::stringstream ss(ios::in | ios::out | ios::binary); 
-      for (const rank_t& key_rank : rank_sequence)
+      throw_assert(pos == buf + size,
+                   "pack_edge_csr: packed size mismatch");
+    }
+
+    
+    /*************************************************************************
+     * Packing of edge maps; the edge map must have the same number of
+     * attribute namespaces and columns for every node
+     *************************************************************************/
+
+    template <class T>
+    static void pack_edge_map_columns (char*& pos, const edge_map_t& edge_map,
+                                       const size_t ns, const size_t num_columns)
+    {
+      for (size_t k = 0; k < num_columns; k++)
         {
-          sdispls[key_rank] = sendpos;
+          for (auto it = edge_map.cbegin(); it != edge_map.cend(); ++it)
+            {
+              const vector<NODE_IDX_T>& adj_vector = get<0>(it->second);
+              if (adj_vector.empty())
+                continue;
+              const vector<T>& values = get<1>(it->second)[ns].const_attr_vec<T>(k);
+              throw_assert(values.size() == adj_vector.size(),
+                           "pack_edge_map: mismatch between number of edges and attribute values");
+              pack_values(pos, values.data(), values.size());
+            }
+        }
+    }
+
+    static void edge_map_column_counts (const edge_map_t& edge_map,
+                                        size_t& num_edges,
+                                        size_t& num_namespaces,
+                                        vector<uint32_t>& column_counts)
+    {
+      num_edges = 0;
+      num_namespaces = 0;
+      bool first = true;
+      for (auto it = edge_map.cbegin(); it != edge_map.cend(); ++it)
+        {
+          const vector<NODE_IDX_T>& adj_vector = get<0>(it->second);
+          const vector<AttrVal>& edge_attr_values = get<1>(it->second);
+          num_edges += adj_vector.size();
+          if (adj_vector.empty())
+            continue;
           
-          auto it1 = prj_rank_edge_map.find(key_rank);
-          if (it1 != prj_rank_edge_map.end())
+          vector<uint32_t> node_column_counts(edge_attr_values.size() * AttrVal::num_attr_types, 0);
+          for (size_t ns = 0; ns < edge_attr_values.size(); ns++)
             {
-              const edge_map_t edge_map = it1->second;
-              
-              {
-                
-                cereal::BinaryOutputArchive oarchive(ss); // Create an output archive
-                oarchive(edge_map); // Write the data to the archive
-                
-              } // archive goes out of scope, ensuring all contents are flushed
-              ss.seekg(0, ios::end);
-              sendpos = ss.tellg();
+              get_column_counts(edge_attr_values[ns], &node_column_counts[ns * AttrVal::num_attr_types]);
+            }
+          if (first)
+            {
+              column_counts = node_column_counts;
+              num_namespaces = edge_attr_values.size();
+              first = false;
+            }
+          else
+            {
+              throw_assert(column_counts == node_column_counts,
+                           "pack_edge_map: edge attributes differ between nodes");
+            }
+        }
+    }
+
+    static size_t pack_edge_map (const edge_map_t& edge_map, vector<char>& sendbuf)
+    {
+      size_t num_edges = 0, num_namespaces = 0;
+      vector<uint32_t> column_counts;
+      edge_map_column_counts(edge_map, num_edges, num_namespaces, column_counts);
+
+      const size_t size = packed_size(edge_map.size(), num_edges, column_counts);
+      const size_t start = sendbuf.size();
+      sendbuf.resize(start + size);
+      char* buf = &sendbuf[start];
+      char* pos = buf;
+      
+      EdgeWireHeader header;
+      header.packed_size    = size;
+      header.num_nodes      = edge_map.size();
+      header.num_edges      = num_edges;
+      header.edge_map_type  = EdgeMapDst;
+      header.num_namespaces = num_namespaces;
+      pack_values(pos, &header, 1);
+      pack_values(pos, column_counts.data(), column_counts.size());
+
+      for (auto it = edge_map.cbegin(); it != edge_map.cend(); ++it)
+        {
+          pack_values(pos, &(it->first), 1);
+        }
+      DST_PTR_T offset = 0;
+      pack_values(pos, &offset, 1);
+      for (auto it = edge_map.cbegin(); it != edge_map.cend(); ++it)
+        {
+          offset += get<0>(it->second).size();
+          pack_values(pos, &offset, 1);
+        }
+      for (auto it = edge_map.cbegin(); it != edge_map.cend(); ++it)
+        {
+          const vector<NODE_IDX_T>& adj_vector = get<0>(it->second);
+          pack_values(pos, adj_vector.data(), adj_vector.size());
+        }
+
+      for (size_t ns = 0; ns < num_namespaces; ns++)
+        {
+          const uint32_t* ns_column_counts = &column_counts[ns * AttrVal::num_attr_types];
+          pack_edge_map_columns<float>(pos, edge_map, ns, ns_column_counts[AttrVal::attr_index_float]);
+          pack_edge_map_columns<uint8_t>(pos, edge_map, ns, ns_column_counts[AttrVal::attr_index_uint8]);
+          pack_edge_map_columns<int8_t>(pos, edge_map, ns, ns_column_counts[AttrVal::attr_index_int8]);
+          pack_edge_map_columns<uint16_t>(pos, edge_map, ns, ns_column_counts[AttrVal::attr_index_uint16]);
+          pack_edge_map_columns<int16_t>(pos, edge_map, ns, ns_column_counts[AttrVal::attr_index_int16]);
+          pack_edge_map_columns<uint32_t>(pos, edge_map, ns, ns_column_counts[AttrVal::attr_index_uint32]);
+          pack_edge_map_columns<int32_t>(pos, edge_map, ns, ns_column_counts[AttrVal::attr_index_int32]);
+        }
+      
+      throw_assert(pos == buf + size,
+                   "pack_edge_map: packed size mismatch");
+      return num_edges;
+    }
+
+    
+    /*************************************************************************
+     * Unpacking
+     *************************************************************************/
+
+    template <class T>
+    static void unpack_columns (const char*& pos, const char* end, AttrVal& attr_val,
+                                const uint32_t* column_counts, const size_t num_edges)
+    {
+      const size_t num_columns = column_counts[AttrVal::attr_type_index<T>()];
+      attr_val.resize<T>(num_columns);
+      for (size_t k = 0; k < num_columns; k++)
+        {
+          vector<T>& values = attr_val.attr_vec<T>(k);
+          values.resize(num_edges);
+          unpack_values(pos, end, values.data(), num_edges);
+        }
+    }
+
+    /// Unpacks one container from buf and returns the number of bytes consumed
+    static size_t unpack_edge_csr (const char* buf, const size_t buf_size, EdgeCSR& edge_csr)
+    {
+      const char* pos = buf;
+      const char* end = buf + buf_size;
+      
+      EdgeWireHeader header;
+      unpack_values(pos, end, &header, 1);
+      throw_assert(header.packed_size <= buf_size,
+                   "unpack_edge_csr: buffer is too short");
+      end = buf + header.packed_size;
+      
+      vector<uint32_t> column_counts(header.num_namespaces * AttrVal::num_attr_types);
+      unpack_values(pos, end, column_counts.data(), column_counts.size());
+
+      edge_csr.edge_map_type = (EdgeMapType)header.edge_map_type;
+      edge_csr.keys.resize(header.num_nodes);
+      edge_csr.offsets.resize(header.num_nodes+1);
+      edge_csr.adj.resize(header.num_edges);
+      unpack_values(pos, end, edge_csr.keys.data(), edge_csr.keys.size());
+      unpack_values(pos, end, edge_csr.offsets.data(), edge_csr.offsets.size());
+      unpack_values(pos, end, edge_csr.adj.data(), edge_csr.adj.size());
+      throw_assert(edge_csr.offsets.back() == header.num_edges,
+                   "unpack_edge_csr: invalid offsets array");
+
+      edge_csr.attrs.resize(header.num_namespaces);
+      for (size_t ns = 0; ns < header.num_namespaces; ns++)
+        {
+          const uint32_t* ns_column_counts = &column_counts[ns * AttrVal::num_attr_types];
+          AttrVal& attr_val = edge_csr.attrs[ns];
+          unpack_columns<float>(pos, end, attr_val, ns_column_counts, header.num_edges);
+          unpack_columns<uint8_t>(pos, end, attr_val, ns_column_counts, header.num_edges);
+          unpack_columns<int8_t>(pos, end, attr_val, ns_column_counts, header.num_edges);
+          unpack_columns<uint16_t>(pos, end, attr_val, ns_column_counts, header.num_edges);
+          unpack_columns<int16_t>(pos, end, attr_val, ns_column_counts, header.num_edges);
+          unpack_columns<uint32_t>(pos, end, attr_val, ns_column_counts, header.num_edges);
+          unpack_columns<int32_t>(pos, end, attr_val, ns_column_counts, header.num_edges);
+        }
+
+      throw_assert(pos == end,
+                   "unpack_edge_csr: packed size mismatch");
+      return header.packed_size;
+    }
+
+    /// Minimum number of received bytes for which the received
+    /// containers are unpacked and merged by several threads
+    static const size_t parallel_unpack_min_size = 1024*1024;
+
+    /// Returns the number of threads used to unpack num_bytes received
+    /// bytes. With OpenMP, this is the OpenMP thread count (as set by
+    /// OMP_NUM_THREADS); the threads do not make MPI calls, so that
+    /// MPI_THREAD_FUNNELED is sufficient.
+    static int unpack_num_threads (const size_t num_bytes)
+    {
+#ifdef _OPENMP
+      if (num_bytes >= parallel_unpack_min_size)
+        {
+          return omp_get_max_threads();
+        }
+#endif
+      return 1;
+    }
+
+    /// Unpacks the containers sent by each rank, in rank order
+    static void unpack_rank_edge_csr (const size_t num_ranks,
+                                      const char *recvbuf,
+                                      const size_t recvbuf_size,
+                                      const vector<size_t>& recvcounts,
+                                      const vector<size_t>& rdispls,
+                                      vector<EdgeCSR>& rank_edge_csr)
+    {
+
+      // locate the containers from the packed size in their headers, so
+      // that they can be unpacked independently
+      vector< pair<size_t, size_t> > segments;
+      size_t num_bytes = 0;
+      for (size_t ridx = 0; ridx < num_ranks; ridx++)
+        {
+          if (recvcounts[ridx] > 0)
+            {
+              size_t recvpos = rdispls[ridx];
+              const size_t recvend = recvpos + recvcounts[ridx];
               
-              for (auto it = edge_map.cbegin(); it != edge_map.cend(); ++it)
+              throw_assert((recvpos < recvbuf_size) && (recvend <= recvbuf_size),
+                           "unpack_rank_edge_csr: invalid buffer displacement");
+
+              while (recvpos < recvend)
                 {
-                  const vector<NODE_IDX_T>&  adj_vector = get<0>(it->second);
-                  
-                  num_packed_edges += adj_vector.size();
+                  const char* pos = &recvbuf[recvpos];
+                  EdgeWireHeader header;
+                  unpack_values(pos, recvbuf + recvend, &header, 1);
+                  throw_assert((header.packed_size >= sizeof(EdgeWireHeader)) &&
+                               (header.packed_size <= recvend - recvpos),
+                               "unpack_rank_edge_csr: invalid container size");
+                  segments.push_back(make_pair(recvpos, header.packed_size));
+                  recvpos += header.packed_size;
                 }
+              num_bytes += recvcounts[ridx];
             }
-          sendcounts[key_rank] = sendpos - sdispls[key_rank];
+        }
+
+      const size_t first = rank_edge_csr.size();
+      rank_edge_csr.resize(first + segments.size());
 
+      const int num_threads = unpack_num_threads(num_bytes);
+      std::exception_ptr error;
+#pragma omp parallel for schedule(dynamic) num_threads(num_threads) if (num_threads > 1)
+      for (size_t i = 0; i < segments.size(); i++)
+        {
+          try
+            {
+              unpack_edge_csr(&recvbuf[segments[i].first], segments[i].second,
+                              rank_edge_csr[first + i]);
+            }
+          catch (...)
+            {
+#pragma omp critical
+              error = std::current_exception();
+            }
         }
+      if (error)
+        {
+          std::rethrow_exception(error);
+        }
+    }
 
-      ss.seekg(0, ios::beg);
-      const string& sstr = ss.str();
-      copy(sstr.begin(), sstr.end(), back_inserter(sendbuf));
-      
+    
+    /*************************************************************************
+     * Merging of unpacked containers into an edge map
+     *************************************************************************/
+
+    /// Appends the edges and attributes of src to dst
+    static void append_edge_tuple (const edge_tuple_t& src, edge_tuple_t& dst)
+    {
+      vector<NODE_IDX_T>& v = get<0>(dst);
+      v.insert(v.end(), get<0>(src).begin(), get<0>(src).end());
+      vector<AttrVal>& va = get<1>(dst);
+      for (size_t ns = 0; ns < va.size(); ns++)
+        {
+          va[ns].append(get<1>(src)[ns]);
+        }
     }
 
-    void serialize_edge_map (const edge_map_t& edge_map, 
-                             size_t &num_packed_edges,
-                             vector<char> &sendbuf)
+    typedef vector< pair<NODE_IDX_T, edge_tuple_t> > edge_tuple_vector_t;
+
+    /// Merges the rows [lower[i], upper[i]) of each input, which are sorted
+    /// by key, into a sequence of edge tuples sorted by key. Rows with
+    /// equal keys are concatenated in input order.
+    static void merge_edge_csr_rows (const vector<EdgeCSR>& inputs,
+                                     const vector<size_t>& lower,
+                                     const vector<size_t>& upper,
+                                     edge_tuple_vector_t& output)
     {
-      for (auto it = edge_map.cbegin(); it != edge_map.cend(); ++it)
+      typedef pair<NODE_IDX_T, size_t> cursor_t;
+      priority_queue<cursor_t, vector<cursor_t>, std::greater<cursor_t> > heap;
+      vector<size_t> pos(lower);
+      for (size_t i = 0; i < inputs.size(); i++)
         {
-          const vector<NODE_IDX_T>&  adj_vector = get<0>(it->second);
-          
-          num_packed_edges += adj_vector.size();
+          if (pos[i] < upper[i])
+            heap.push(make_pair(inputs[i].keys[pos[i]], i));
+        }
+
+      edge_tuple_t row;
+      while (!heap.empty())
+        {
+          const cursor_t top = heap.top();
+          heap.pop();
+          const size_t i = top.second;
+          if (output.empty() || (output.back().first != top.first))
+            {
+              output.emplace_back();
+              output.back().first = top.first;
+              inputs[i].edge_tuple(pos[i], output.back().second);
+            }
+          else
+            {
+              inputs[i].edge_tuple(pos[i], row);
+              append_edge_tuple(row, output.back().second);
+            }
+          pos[i]++;
+          if (pos[i] < upper[i])
+            heap.push(make_pair(inputs[i].keys[pos[i]], i));
+        }
+    }
+
+    /// Converts the unpacked containers to edge map entries. The key range
+    /// is divided into parts by sampling the keys of the containers; each
+    /// part is merged by one thread, and the parts are inserted into the
+    /// edge map in key order.
+    static void merge_rank_edge_csr (const vector<EdgeCSR>& rank_edge_csr,
+                                     const int num_threads,
+                                     edge_map_t& prj_edge_map)
+    {
+      const size_t num_inputs = rank_edge_csr.size();
+      const size_t samples_per_input = num_threads * 4;
+
+      vector<NODE_IDX_T> samples;
+      for (const EdgeCSR& edge_csr : rank_edge_csr)
+        {
+          const size_t n = edge_csr.num_nodes();
+          for (size_t j = 0; (n > 0) && (j < samples_per_input); j++)
+            {
+              samples.push_back(edge_csr.keys[(j * n) / samples_per_input]);
+            }
+        }
+      std::sort(samples.begin(), samples.end());
+
+      vector<NODE_IDX_T> splitters;
+      for (int p = 1; p < num_threads; p++)
+        {
+          if (samples.empty())
+            break;
+          NODE_IDX_T splitter = samples[(p * samples.size()) / num_threads];
+          if (splitters.empty() || (splitters.back() < splitter))
+            splitters.push_back(splitter);
         }
       
-      std::stringstream ss(ios::in | ios::out | ios::binary);
-      {
-        cereal::BinaryOutputArchive oarchive(ss); // Create an output archive
-        oarchive(edge_map); // Write the data to the archive
-        
-      } // archive goes out of scope, ensuring all contents are flushed
+      // row bounds of each part in each input
+      const size_t num_parts = splitters.size() + 1;
+      vector< vector<size_t> > bounds(num_parts+1, vector<size_t>(num_inputs, 0));
+      for (size_t i = 0; i < num_inputs; i++)
+        {
+          const vector<NODE_IDX_T>& keys = rank_edge_csr[i].keys;
+          for (size_t p = 0; p < splitters.size(); p++)
+            {
+              bounds[p+1][i] = std::lower_bound(keys.begin(), keys.end(), splitters[p]) - keys.begin();
+            }
+          bounds[num_parts][i] = keys.size();
+        }
+
+      vector<edge_tuple_vector_t> parts(num_parts);
+      std::exception_ptr error;
+#pragma omp parallel for schedule(dynamic) num_threads(num_threads)
+      for (size_t p = 0; p < num_parts; p++)
+        {
+          try
+            {
+              merge_edge_csr_rows(rank_edge_csr, bounds[p], bounds[p+1], parts[p]);
+            }
+          catch (...)
+            {
+#pragma omp critical
+              error = std::current_exception();
+            }
+        }
+      if (error)
+        {
+          std::rethrow_exception(error);
+        }
+
+      // entries already in the edge map come before the received edges
+      for (edge_tuple_vector_t& part : parts)
+        {
+          for (auto& entry : part)
+            {
+              auto it = prj_edge_map.lower_bound(entry.first);
+              if ((it != prj_edge_map.end()) && (it->first == entry.first))
+                {
+                  if (get<0>(it->second).empty())
+                    it->second = std::move(entry.second);
+                  else
+                    append_edge_tuple(entry.second, it->second);
+                }
+              else
+                {
+                  prj_edge_map.emplace_hint(it, entry.first, std::move(entry.second));
+                }
+            }
+          edge_tuple_vector_t().swap(part);
+        }
+    }
+
+    
+    static void rank_sequence (const size_t num_ranks,
+                               const size_t start_rank,
+                               vector<rank_t>& ranks)
+    {
+      throw_assert(start_rank < num_ranks, "serialize_rank_edge_map: invalid start rank");
       
-      const string& sstr = ss.str();
-      copy(sstr.begin(), sstr.end(), back_inserter(sendbuf));
+      // Recommended all-to-all communication pattern: start at the current rank, then wrap around;
+      // (as opposed to starting at rank 0)
+      ranks.resize(num_ranks);
+      for (size_t i = 0; i < num_ranks; i++)
+        {
+          ranks[i] = (start_rank + i) % num_ranks;
+        }
+    }
 
+    
+    /*************************************************************************
+     * Edge maps
+     *************************************************************************/
+
+    void serialize_rank_edge_map (const size_t num_ranks,
+                                  const size_t start_rank,
+                                  const rank_edge_map_t& prj_rank_edge_map, 
+                                  size_t &num_packed_edges,
+                                  vector<size_t>& sendcounts,
+                                  vector<char> &sendbuf,
+                                  vector<size_t> &sdispls)
+    {
+      vector<rank_t> ranks;
+      rank_sequence(num_ranks, start_rank, ranks);
+
+      sendcounts.resize(num_ranks);
+      sdispls.resize(num_ranks);
+
+      for (const rank_t& key_rank : ranks)
+        {
+          const size_t sendpos = sendbuf.size();
+          sdispls[key_rank] = sendpos;
+          
+          auto it = prj_rank_edge_map.find(key_rank);
+          if (it != prj_rank_edge_map.end())
+            {
+              num_packed_edges += pack_edge_map(it->second, sendbuf);
+            }
+          sendcounts[key_rank] = sendbuf.size() - sendpos;
+        }
+    }
+
+    void serialize_edge_map (const edge_map_t& edge_map, 
+                             size_t &num_packed_edges,
+                             vector<char> &sendbuf)
+    {
+      num_packed_edges += pack_edge_map(edge_map, sendbuf);
     }
 
 
@@ -132,59 +671,33 @@ namespace neuroh5
                                     size_t& num_unpacked_edges
                                     )
     {
-      const size_t recvbuf_size = recvbuf.size();
+      vector<EdgeCSR> rank_edge_csr;
+      unpack_rank_edge_csr(num_ranks, recvbuf.data(), recvbuf.size(), recvcounts, rdispls, rank_edge_csr);
 
+      size_t num_bytes = 0;
       for (size_t ridx = 0; ridx < num_ranks; ridx++)
         {
-          if (recvcounts[ridx] > 0)
+          num_bytes += recvcounts[ridx];
+        }
+      const int num_threads = unpack_num_threads(num_bytes);
+      
+      const size_t num_nodes_before = prj_edge_map.size();
+      if (num_threads > 1)
+        {
+          merge_rank_edge_csr(rank_edge_csr, num_threads, prj_edge_map);
+        }
+      else
+        {
+          for (const EdgeCSR& edge_csr : rank_edge_csr)
             {
-              size_t recvsize  = recvcounts[ridx];
-              size_t recvpos   = rdispls[ridx];
-              size_t startpos  = recvpos;
-              edge_map_t edge_map;
-
-              throw_assert(recvpos < recvbuf_size,
-                           "deserialize_rank_edge_map: invalid buffer displacement");
-
-
-              {
-                const string& s = string(recvbuf.begin()+startpos, recvbuf.begin()+startpos+recvsize);
-                stringstream ss(s, ios::in | ios::out | ios::binary);
-
-                cereal::BinaryInputArchive iarchive(ss); // Create an input archive
-                
-                iarchive(edge_map); // Read the data from the archive
-              }
-              
-              for (auto it = edge_map.cbegin(); it != edge_map.cend(); ++it)
-                {
-                  NODE_IDX_T key_node = it->first;
-                  const vector<NODE_IDX_T>&  adj_vector = get<0>(it->second);
-                  const vector<data::AttrVal>&    edge_attr_values = get<1>(it->second);
-                  num_unpacked_edges += adj_vector.size();
-                  
-                  if (prj_edge_map.find(key_node) == prj_edge_map.end())
-                    {
-                      num_unpacked_nodes ++;
-                      prj_edge_map.insert(make_pair(key_node,make_tuple(adj_vector, edge_attr_values)));
-                    }
-                  else
-                    {
-                      edge_tuple_t et = prj_edge_map[key_node];
-                      vector<NODE_IDX_T> &v = get<0>(et);
-                      vector <data::AttrVal> &va = get<1>(et);
-                      v.insert(v.end(),adj_vector.begin(),adj_vector.end());
-                      size_t ni=0;
-                      for (auto & a : va)
-                        {
-                          a.append(edge_attr_values[ni]);
-                          ni++;
-                        }
-                      prj_edge_map[key_node] = make_tuple(v,va);
-                    }
-                }
+              edge_csr.to_edge_map(prj_edge_map);
             }
         }
+      for (const EdgeCSR& edge_csr : rank_edge_csr)
+        {
+          num_unpacked_edges += edge_csr.num_edges();
+        }
+      num_unpacked_nodes += prj_edge_map.size() - num_nodes_before;
     }
 
     
@@ -194,46 +707,144 @@ namespace neuroh5
                                size_t& num_unpacked_edges
                                )
     {
-      edge_map_t edge_map;
       num_unpacked_nodes = 0;
       num_unpacked_edges = 0;
+
+      vector<EdgeCSR> rank_edge_csr;
+      vector<size_t> recvcounts(1, recvbuf.size()), rdispls(1, 0);
+      unpack_rank_edge_csr(1, recvbuf.data(), recvbuf.size(), recvcounts, rdispls, rank_edge_csr);
       
-      {
-        const string& s = string(recvbuf.begin(), recvbuf.end());
-        stringstream ss(s, ios::in | ios::out | ios::binary);
-        
-        cereal::BinaryInputArchive iarchive(ss); // Create an input archive
-        
-        iarchive(edge_map); // Read the data from the archive
-      }
-      
-      for (auto it = edge_map.cbegin(); it != edge_map.cend(); ++it)
+      for (const EdgeCSR& edge_csr : rank_edge_csr)
         {
-          NODE_IDX_T key_node = it->first;
-          const vector<NODE_IDX_T>&  adj_vector = get<0>(it->second);
-          const vector <data::AttrVal>&  edge_attr_values = get<1>(it->second);
-          num_unpacked_edges += adj_vector.size();
-          num_unpacked_nodes ++;
-          
-          if (prj_edge_map.find(key_node) == prj_edge_map.end())
-            {
-              prj_edge_map.insert(make_pair(key_node,make_tuple(adj_vector, edge_attr_values)));
-            }
-          else
+          edge_csr.to_edge_map(prj_edge_map);
+          num_unpacked_nodes += edge_csr.num_nodes();
+          num_unpacked_edges += edge_csr.num_edges();
+        }
+    }
+
+    
+    /*************************************************************************
+     * Flat edge containers
+     *************************************************************************/
+
+    void serialize_edge_csr (const EdgeCSR& edge_csr,
+                             size_t &num_packed_edges,
+                             vector<char> &sendbuf)
+    {
+      const size_t size = edge_csr_packed_size(edge_csr);
+      const size_t start = sendbuf.size();
+      sendbuf.resize(start + size);
+      pack_edge_csr(edge_csr, size, &sendbuf[start]);
+      num_packed_edges += edge_csr.num_edges();
+    }
+
+    
+    void serialize_rank_edge_csr (const size_t num_ranks,
+                                  const size_t start_rank,
+                                  const rank_edge_csr_t& prj_rank_edge_csr,
+                                  size_t &num_packed_edges,
+                                  vector<size_t>& sendcounts,
+                                  vector<char> &sendbuf,
+                                  vector<size_t> &sdispls)
+    {
+      vector<rank_t> ranks;
+      rank_sequence(num_ranks, start_rank, ranks);
+
+      sendcounts.assign(num_ranks, 0);
+      sdispls.assign(num_ranks, 0);
+
+      // compute all packed sizes first, so that the send buffer is
+      // allocated once and each container is packed in place
+      size_t sendpos = sendbuf.size();
+      for (const rank_t& key_rank : ranks)
+        {
+          sdispls[key_rank] = sendpos;
+          auto it = prj_rank_edge_csr.find(key_rank);
+          if (it != prj_rank_edge_csr.end())
             {
-              edge_tuple_t et = prj_edge_map[key_node];
-              vector<NODE_IDX_T> &v = get<0>(et);
-              vector <data::AttrVal> &va = get<1>(et);
-              v.insert(v.end(),adj_vector.begin(),adj_vector.end());
-              size_t ni=0;
-              for (auto & a : va)
-                {
-                  a.append(edge_attr_values[ni]);
-                  ni++;
-                }
-              prj_edge_map[key_node] = make_tuple(v,va);
+              sendcounts[key_rank] = edge_csr_packed_size(it->second);
             }
+          sendpos += sendcounts[key_rank];
+        }
+      sendbuf.resize(sendpos);
+
+      for (auto it = prj_rank_edge_csr.cbegin(); it != prj_rank_edge_csr.cend(); ++it)
+        {
+          const rank_t key_rank = it->first;
+          throw_assert(key_rank < num_ranks, "serialize_rank_edge_csr: invalid rank");
+          pack_edge_csr(it->second, sendcounts[key_rank], &sendbuf[sdispls[key_rank]]);
+          num_packed_edges += it->second.num_edges();
+        }
+    }
+
+    
+    void deserialize_rank_edge_csr (const size_t num_ranks,
+                                    const vector<char> &recvbuf,
+                                    const vector<size_t>& recvcounts,
+                                    const vector<size_t>& rdispls,
+                                    EdgeCSR& prj_edge_csr,
+                                    size_t& num_unpacked_nodes,
+                                    size_t& num_unpacked_edges
+                                    )
+    {
+      deserialize_rank_edge_csr(num_ranks, recvbuf.data(), recvbuf.size(), recvcounts, rdispls,
+                                prj_edge_csr, num_unpacked_nodes, num_unpacked_edges);
+    }
+
+
+    void deserialize_rank_edge_csr (const size_t num_ranks,
+                                    const char *recvbuf,
+                                    const size_t recvbuf_size,
+                                    const vector<size_t>& recvcounts,
+                                    const vector<size_t>& rdispls,
+                                    EdgeCSR& prj_edge_csr,
+                                    size_t& num_unpacked_nodes,
+                                    size_t& num_unpacked_edges
+                                    )
+    {
+      vector<EdgeCSR> rank_edge_csr;
+      if (prj_edge_csr.num_nodes() > 0)
+        {
+          rank_edge_csr.push_back(std::move(prj_edge_csr));
         }
+      unpack_rank_edge_csr(num_ranks, recvbuf, recvbuf_size, recvcounts, rdispls, rank_edge_csr);
+
+      // edges of a node received from several ranks are concatenated
+      // in sender rank order
+      if (rank_edge_csr.size() == 1)
+        {
+          prj_edge_csr = std::move(rank_edge_csr[0]);
+        }
+      else
+        {
+          merge_edge_csr(rank_edge_csr, prj_edge_csr);
+        }
+
+      num_unpacked_nodes = prj_edge_csr.num_nodes();
+      num_unpacked_edges = prj_edge_csr.num_edges();
+    }
+
+
+    void deserialize_rank_edge_csr (const size_t num_ranks,
+                                    const vector<char> &recvbuf,
+                                    const vector<size_t>& recvcounts,
+                                    const vector<size_t>& rdispls,
+                                    vector<EdgeCSR>& rank_edge_csr
+                                    )
+    {
+      unpack_rank_edge_csr(num_ranks, recvbuf.data(), recvbuf.size(), recvcounts, rdispls, rank_edge_csr);
+    }
+
+    
+    void deserialize_edge_csr (const vector<char> &recvbuf,
+                               EdgeCSR& prj_edge_csr,
+                               size_t& num_unpacked_nodes,
+                               size_t& num_unpacked_edges
+                               )
+    {
+      vector<size_t> recvcounts(1, recvbuf.size()), rdispls(1, 0);
+      deserialize_rank_edge_csr(1, recvbuf, recvcounts, rdispls, prj_edge_csr,
+                                num_unpacked_nodes, num_unpacked_edges);
     }
 
   }
@@ -102,7 +102,18 @@ namespace neuroh5
                                     map<CELL_IDX_T, neurotree_t> &all_tree_map
                                     )
     {
-      const size_t recvbuf_size = recvbuf.size();
+      deserialize_rank_tree_map(num_ranks, recvbuf.data(), recvbuf.size(), recvcounts, rdispls,
+                                all_tree_map);
+    }
+
+    void deserialize_rank_tree_map (const size_t num_ranks,
+                                    const char *recvbuf,
+                                    const size_t recvbuf_size,
+                                    const vector<size_t>& recvcounts,
+                                    const vector<size_t>& rdispls,
+                                    map<CELL_IDX_T, neurotree_t> &all_tree_map
+                                    )
+    {
 
       for (size_t ridx = 0; ridx < num_ranks; ridx++)
         {
@@ -117,7 +128,7 @@ namespace neuroh5
                            "deserialize_rank_tree_map: invalid buffer displacement");
 
               {
-                const string& s = string(recvbuf.begin()+startpos, recvbuf.begin()+startpos+recvsize);
+                const string& s = string(recvbuf+startpos, recvbuf+startpos+recvsize);
                 stringstream ss(s, ios::in | ios::out | ios::binary);
 
                 cereal::BinaryInputArchive iarchive(ss); // Create an input archive
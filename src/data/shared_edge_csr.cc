@@ -0,0 +1,194 @@
+// -*- mode: c++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+//==============================================================================
+///  @file shared_edge_csr.cc
+///
+///  Read-only projection edges held in memory shared by the ranks of a node.
+///
+///  Copyright (C) 2016-2025 Project NeuroH5.
+//==============================================================================
+
+#include <mpi.h>
+
+#include <memory>
+#include <vector>
+
+#include "shared_edge_csr.hh"
+#include "shared_segment.hh"
+#include "throw_assert.hh"
+
+using namespace std;
+
+namespace neuroh5
+{
+  namespace data
+  {
+
+    /*
+     * Segment layout
+     *
+     * The columns of the container follow each other in the order
+     *
+     *   keys [num_nodes], offsets [num_nodes+1], adj [num_edges],
+     *   for each namespace, each attribute type in AttrVal index order
+     *   and each column: values [num_edges]
+     *
+     * each starting at a multiple of SharedSegment::column_alignment.
+     * All ranks compute the same layout from the shape of the container,
+     * which is broadcast from the root rank.
+     */
+    enum SharedEdgeShape
+      {
+        shape_edge_map_type = 0,
+        shape_num_nodes,
+        shape_num_edges,
+        shape_num_namespaces,
+        shape_column_counts
+      };
+
+    template <class T>
+    static void add_column (size_t& pos, const size_t n)
+    {
+      pos = mpi::SharedSegment::align(pos) + n * sizeof(T);
+    }
+
+    template <class T>
+    static void add_attr_columns (size_t& pos, const vector<uint64_t>& shape, const size_t ns)
+    {
+      size_t num_columns = shape[shape_column_counts + ns * AttrVal::num_attr_types +
+                                 AttrVal::attr_type_index<T>()];
+      for (size_t k = 0; k < num_columns; k++)
+        {
+          add_column<T>(pos, shape[shape_num_edges]);
+        }
+    }
+
+    template <class T>
+    static void pack_attr_columns (char* base, size_t& pos, const AttrVal& attr_val)
+    {
+      for (size_t k = 0; k < attr_val.size_attr_vec<T>(); k++)
+        {
+          const vector<T>& values = attr_val.const_attr_vec<T>(k);
+          mpi::pack_column(base, pos, values.data(), values.size());
+        }
+    }
+
+    template <class T>
+    static void view_attr_columns (const shared_ptr<mpi::SharedSegment>& segment, size_t& pos,
+                                   const vector<uint64_t>& shape, const size_t ns,
+                                   SharedAttrColumns& attr_columns)
+    {
+      size_t num_columns = shape[shape_column_counts + ns * AttrVal::num_attr_types +
+                                 AttrVal::attr_type_index<T>()];
+      for (size_t k = 0; k < num_columns; k++)
+        {
+          attr_columns.attr_columns<T>().push_back
+            (mpi::view_column<T>(segment, pos, shape[shape_num_edges]));
+        }
+    }
+
+    static size_t segment_size (const vector<uint64_t>& shape)
+    {
+      size_t pos = 0;
+      add_column<NODE_IDX_T>(pos, shape[shape_num_nodes]);
+      add_column<DST_PTR_T>(pos, shape[shape_num_nodes] + 1);
+      add_column<NODE_IDX_T>(pos, shape[shape_num_edges]);
+      for (size_t ns = 0; ns < shape[shape_num_namespaces]; ns++)
+        {
+          add_attr_columns<float>(pos, shape, ns);
+          add_attr_columns<uint8_t>(pos, shape, ns);
+          add_attr_columns<int8_t>(pos, shape, ns);
+          add_attr_columns<uint16_t>(pos, shape, ns);
+          add_attr_columns<int16_t>(pos, shape, ns);
+          add_attr_columns<uint32_t>(pos, shape, ns);
+          add_attr_columns<int32_t>(pos, shape, ns);
+        }
+      return pos;
+    }
+
+
+    void bcast_shared_edge_csr
+    (
+     MPI_Comm         comm,
+     const int        root,
+     const EdgeCSR&   edge_csr,
+     SharedEdgeCSR&   shared_edge_csr
+     )
+    {
+      int rank;
+      throw_assert_nomsg(MPI_Comm_rank(comm, &rank) == MPI_SUCCESS);
+
+      vector<uint64_t> shape;
+      uint64_t shape_size = 0;
+      if (rank == root)
+        {
+          throw_assert(edge_csr.offsets.size() == edge_csr.num_nodes()+1,
+                       "bcast_shared_edge_csr: invalid offsets array");
+          shape.push_back(edge_csr.edge_map_type);
+          shape.push_back(edge_csr.num_nodes());
+          shape.push_back(edge_csr.num_edges());
+          shape.push_back(edge_csr.attrs.size());
+          for (const AttrVal& attr_val : edge_csr.attrs)
+            {
+              shape.push_back(attr_val.size_attr_vec<float>());
+              shape.push_back(attr_val.size_attr_vec<uint8_t>());
+              shape.push_back(attr_val.size_attr_vec<int8_t>());
+              shape.push_back(attr_val.size_attr_vec<uint16_t>());
+              shape.push_back(attr_val.size_attr_vec<int16_t>());
+              shape.push_back(attr_val.size_attr_vec<uint32_t>());
+              shape.push_back(attr_val.size_attr_vec<int32_t>());
+            }
+          shape_size = shape.size();
+        }
+      throw_assert(MPI_Bcast(&shape_size, 1, MPI_UINT64_T, root, comm) == MPI_SUCCESS,
+                   "bcast_shared_edge_csr: error in MPI_Bcast");
+      shape.resize(shape_size);
+      throw_assert(MPI_Bcast(&shape[0], shape_size, MPI_UINT64_T, root, comm) == MPI_SUCCESS,
+                   "bcast_shared_edge_csr: error in MPI_Bcast");
+
+      auto segment = make_shared<mpi::SharedSegment>(comm, segment_size(shape), root);
+
+      if (segment->is_root())
+        {
+          char* base = segment->data();
+          size_t pos = 0;
+          mpi::pack_column(base, pos, edge_csr.keys.data(), edge_csr.keys.size());
+          mpi::pack_column(base, pos, edge_csr.offsets.data(), edge_csr.offsets.size());
+          mpi::pack_column(base, pos, edge_csr.adj.data(), edge_csr.adj.size());
+          for (const AttrVal& attr_val : edge_csr.attrs)
+            {
+              pack_attr_columns<float>(base, pos, attr_val);
+              pack_attr_columns<uint8_t>(base, pos, attr_val);
+              pack_attr_columns<int8_t>(base, pos, attr_val);
+              pack_attr_columns<uint16_t>(base, pos, attr_val);
+              pack_attr_columns<int16_t>(base, pos, attr_val);
+              pack_attr_columns<uint32_t>(base, pos, attr_val);
+              pack_attr_columns<int32_t>(base, pos, attr_val);
+            }
+          throw_assert(pos == segment->size(),
+                       "bcast_shared_edge_csr: packed size mismatch");
+        }
+
+      segment->bcast();
+
+      size_t pos = 0;
+      shared_edge_csr.edge_map_type = (EdgeMapType)shape[shape_edge_map_type];
+      shared_edge_csr.keys = mpi::view_column<NODE_IDX_T>(segment, pos, shape[shape_num_nodes]);
+      shared_edge_csr.offsets = mpi::view_column<DST_PTR_T>(segment, pos, shape[shape_num_nodes] + 1);
+      shared_edge_csr.adj = mpi::view_column<NODE_IDX_T>(segment, pos, shape[shape_num_edges]);
+      shared_edge_csr.attrs.clear();
+      shared_edge_csr.attrs.resize(shape[shape_num_namespaces]);
+      for (size_t ns = 0; ns < shape[shape_num_namespaces]; ns++)
+        {
+          SharedAttrColumns& attr_columns = shared_edge_csr.attrs[ns];
+          view_attr_columns<float>(segment, pos, shape, ns, attr_columns);
+          view_attr_columns<uint8_t>(segment, pos, shape, ns, attr_columns);
+          view_attr_columns<int8_t>(segment, pos, shape, ns, attr_columns);
+          view_attr_columns<uint16_t>(segment, pos, shape, ns, attr_columns);
+          view_attr_columns<int16_t>(segment, pos, shape, ns, attr_columns);
+          view_attr_columns<uint32_t>(segment, pos, shape, ns, attr_columns);
+          view_attr_columns<int32_t>(segment, pos, shape, ns, attr_columns);
+        }
+    }
+
+  }
+}
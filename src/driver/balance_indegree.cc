@@ -69,7 +69,9 @@ int main(int argc, char** argv)
   std::string input_file_name, output;
   size_t nparts = 0, iosize = 0;
   
-  throw_assert(MPI_Init(&argc, &argv) >= 0,
+  // received edges may be unpacked by OpenMP threads, which make no MPI calls
+  int thread_level;
+  throw_assert(MPI_Init_thread(&argc, &argv, MPI_THREAD_FUNNELED, &thread_level) >= 0,
                "balance_indegree: error in MPI initialization");
 
   int rank, size;
@@ -14,9 +14,9 @@
 #include "cell_populations.hh"
 #include "projection_names.hh"
 #include "read_syn_projection.hh"
-#include "read_txt_projection.hh"
-#include "rank_range.hh"
+#include "read_txt_edges.hh"
 #include "write_graph.hh"
+#include "append_graph.hh"
 #include "attr_map.hh"
 #include "attr_val.hh"
 #include "tokenize.hh"
@@ -292,7 +292,9 @@ int main(int argc, char** argv)
   MPI_Comm all_comm;
 
   
-  throw_assert(MPI_Init(&argc, &argv) >= 0,
+  // received edges may be unpacked by OpenMP threads, which make no MPI calls
+  int thread_level;
+  throw_assert(MPI_Init_thread(&argc, &argv, MPI_THREAD_FUNNELED, &thread_level) >= 0,
                "neurograph_import: error in MPI initialization");
 
   MPI_Comm_dup(MPI_COMM_WORLD,&all_comm);
@@ -619,28 +621,25 @@ int main(int argc, char** argv)
             }
         }
   
+  edge_map_t edge_map;
+  size_t num_edges;
+
   map <string, data::AttrVal> edge_attrs;
   if (opt_txt)
     {
-      // determine which connection files are read by which rank
-      vector< pair<hsize_t,hsize_t> > ranges;
-      mpi::rank_ranges(txt_input_file_names.size(), size, ranges);
-      
-      hsize_t start=ranges[rank].first, end=ranges[rank].first+ranges[rank].second;
-
-      for (size_t i=start; i<end; i++)
+      // each connection file is read by all ranks, in byte ranges
+      // aligned to line boundaries
+      for (const string& txt_input_file_name : txt_input_file_names)
         {
-          string txt_input_file_name = txt_input_file_names[i];
-          
-          status = io::read_txt_projection (txt_input_file_name, num_edge_attrs,
-                                            dst_idx, src_idx_ptr, src_idx,
-                                            edge_attrs);
+          status = io::read_txt_edges (all_comm, txt_input_file_name, num_edge_attrs,
+                                       dst_idx, src_idx_ptr, src_idx,
+                                       edge_attrs);
+          status = append_adj_map (src_range, src_offset, dst_offset,
+                                   dst_idx, src_idx_ptr, src_idx,
+                                   edge_attrs, num_edges, edge_map);
         }
     }
 
-  edge_map_t edge_map;
-  size_t num_edges;
-
   /*
   model::NamedAttrMap edge_attr_map:
   edge_attr_map.uint32_values.resize(1);
@@ -664,24 +663,34 @@ int main(int argc, char** argv)
     }
   
 
-  if (syn_idx.size() > 0)
+  if (opt_txt)
     {
-      status = append_syn_adj_map (src_range, src_offset, dst_offset,
-                                   dst_idx, src_idx_ptr, src_idx,
-                                   syn_idx_ptr, syn_idx,
-                                   num_edges, edge_map);
+      // the edges are redistributed to the I/O ranks by destination and
+      // appended to the projection, which is created if necessary
+      status = graph::append_graph (all_comm, io_size, output_file_name,
+                                    src_pop_name, dst_pop_name,
+                                    edge_attr_index, edge_map);
     }
   else
     {
-      status = append_adj_map (src_range, src_offset, dst_offset,
-                               dst_idx, src_idx_ptr, src_idx,
-                               edge_attrs, num_edges, edge_map);
-    }
-
+      if (syn_idx.size() > 0)
+        {
+          status = append_syn_adj_map (src_range, src_offset, dst_offset,
+                                       dst_idx, src_idx_ptr, src_idx,
+                                       syn_idx_ptr, syn_idx,
+                                       num_edges, edge_map);
+        }
+      else
+        {
+          status = append_adj_map (src_range, src_offset, dst_offset,
+                                   dst_idx, src_idx_ptr, src_idx,
+                                   edge_attrs, num_edges, edge_map);
+        }
 
-  status = graph::write_graph (all_comm, io_size, output_file_name,
-                               src_pop_name, dst_pop_name,
-                               edge_attr_index, edge_map);
+      status = graph::write_graph (all_comm, io_size, output_file_name,
+                                   src_pop_name, dst_pop_name,
+                                   edge_attr_index, edge_map);
+    }
 
   MPI_Comm_free(&all_comm);
   
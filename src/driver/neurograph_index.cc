@@ -0,0 +1,168 @@
+// -*- mode: c++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+//==============================================================================
+///  @file neurograph_index.cc
+///
+///  Driver program for creating the destination edge index of projections.
+///
+///  Copyright (C) 2016-2025 Project NeuroH5.
+//==============================================================================
+
+
+#include "debug.hh"
+
+#include "neuroh5_types.hh"
+#include "projection_names.hh"
+#include "projection_edge_index.hh"
+#include "file_access.hh"
+#include "throw_assert.hh"
+
+#include <execinfo.h>
+#include <unistd.h>
+
+#include <getopt.h>
+#include <cstdio>
+#include <cstdlib>
+#include <csignal>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <mpi.h>
+
+using namespace std;
+using namespace neuroh5;
+
+void segv_handler(int sig)
+{
+  void *array[10];
+  size_t size;
+
+  // get void*'s for all entries on the stack
+  size = backtrace(array, 10);
+
+  // print out all the frames to stderr
+  fprintf(stderr, "Error: signal %d:\n", sig);
+  backtrace_symbols_fd(array, size, STDERR_FILENO);
+  exit(1);
+}
+
+
+void throw_err(char const* err_message)
+{
+  fprintf(stderr, "Error: %s\n", err_message);
+  MPI_Abort(MPI_COMM_WORLD, 1);
+}
+
+
+void print_usage_full(char** argv)
+{
+  printf("Usage: %s [graphfile] [source destination]... [options]\n\n", argv[0]);
+  printf("Creates or updates the destination edge index of the given projections, "
+         "or of all projections in the file.\n\n");
+  printf("Options:\n");
+  printf("\t-c SIZE, --chunksize SIZE:\n");
+  printf("\t\tChunk size of the index datasets\n");
+}
+
+
+/*****************************************************************************
+ * Main driver
+ *****************************************************************************/
+
+int main(int argc, char** argv)
+{
+  std::string input_file_name;
+  hsize_t chunk_size = 4096;
+
+  signal(SIGSEGV, segv_handler);
+
+  throw_assert(MPI_Init(&argc, &argv) >= 0,
+               "neurograph_index: error in MPI initialization");
+
+  int rank, size;
+  throw_assert(MPI_Comm_size(MPI_COMM_WORLD, &size) == MPI_SUCCESS,
+               "neurograph_index: error in MPI_Comm_size");
+
+  throw_assert(MPI_Comm_rank(MPI_COMM_WORLD, &rank) == MPI_SUCCESS,
+               "neurograph_index: error in MPI_Comm_rank");
+
+  debug_enabled = false;
+
+  // parse arguments
+  static struct option long_options[] = {
+    {"chunksize", required_argument, 0, 'c' },
+    {0,         0,                 0,  0 }
+  };
+  int c;
+  int option_index = 0;
+  while ((c = getopt_long (argc, argv, "hc:",
+                           long_options, &option_index)) != -1)
+    {
+      stringstream ss;
+      switch (c)
+        {
+        case 'c':
+          ss << string(optarg);
+          ss >> chunk_size;
+          break;
+        case 'h':
+          print_usage_full(argv);
+          exit(0);
+          break;
+        default:
+          throw_err("Input argument format error");
+        }
+    }
+
+  if (optind < argc)
+    {
+      input_file_name = std::string(argv[optind]);
+    }
+  else
+    {
+      print_usage_full(argv);
+      exit(1);
+    }
+
+  vector<pair<string, string>> prj_names;
+  if (optind+1 < argc)
+    {
+      if ((argc - optind - 1) % 2 != 0)
+        {
+          throw_err("Projections must be given as source and destination population pairs");
+        }
+      for (int i = optind+1; i < argc; i += 2)
+        {
+          prj_names.push_back(make_pair(string(argv[i]), string(argv[i+1])));
+        }
+    }
+  else
+    {
+      throw_assert(graph::read_projection_names(MPI_COMM_WORLD, input_file_name, prj_names) >= 0,
+                   "neurograph_index: error in reading projection names");
+    }
+
+  hid_t file = hdf5::open_file(MPI_COMM_WORLD, input_file_name, true, true);
+  throw_assert(file >= 0,
+               "neurograph_index: unable to open file " << input_file_name);
+
+  for (const auto& prj : prj_names)
+    {
+      if (rank == 0)
+        {
+          printf("neurograph_index: indexing projection %s -> %s\n",
+                 prj.first.c_str(), prj.second.c_str());
+        }
+      throw_assert(hdf5::write_projection_edge_index(MPI_COMM_WORLD, file, prj.first, prj.second,
+                                                     chunk_size) >= 0,
+                   "neurograph_index: error in creating edge index for projection "
+                   << prj.first << " -> " << prj.second);
+    }
+
+  throw_assert(hdf5::close_file(file) >= 0,
+               "neurograph_index: unable to close file " << input_file_name);
+
+  MPI_Finalize();
+  return 0;
+}
@@ -124,7 +124,9 @@ int main(int argc, char** argv)
   string input_file_name;
   vector< string > edge_attr_name_spaces;
 
-  throw_assert(MPI_Init(&argc, &argv) >= 0,
+  // received edges may be unpacked by OpenMP threads, which make no MPI calls
+  int thread_level;
+  throw_assert(MPI_Init_thread(&argc, &argv, MPI_THREAD_FUNNELED, &thread_level) >= 0,
                "neurograph_reader: error in MPI initialization");
 
   int rank, size;
@@ -72,7 +72,9 @@ int main(int argc, char** argv)
   vector <string> edge_attr_name_spaces;
   stringstream ss;
 
-  throw_assert(MPI_Init(&argc, &argv) >= 0,
+  // received edges may be unpacked by OpenMP threads, which make no MPI calls
+  int thread_level;
+  throw_assert(MPI_Init_thread(&argc, &argv, MPI_THREAD_FUNNELED, &thread_level) >= 0,
                "neurograph_scatter_read: error in MPI initialization");
 
   EdgeMapType edge_map_type = EdgeMapDst;
@@ -219,11 +221,8 @@ int main(int argc, char** argv)
   // Determine which nodes are assigned to which compute ranks
   if (!opt_rankfile)
     {
-      // round-robin node to rank assignment from file
-      for (size_t i = 0; i < n_nodes; i++)
-        {
-          node_rank_map[i].insert(i%size);
-        }
+      // round-robin node to rank assignment
+      node_rank_map.assign_round_robin(0, n_nodes, size);
     }
   else
     {
@@ -0,0 +1,876 @@
+// -*- mode: c++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+//==============================================================================
+///  @file neuroh5_bench.cc
+///
+///  Benchmark of the collective read and write routines on a synthetic
+///  NeuroH5 file.
+///
+///  Copyright (C) 2016-2025 Project NeuroH5.
+//==============================================================================
+
+#include "debug.hh"
+
+#include "neuroh5_types.hh"
+#include "path_names.hh"
+#include "rank_range.hh"
+#include "attr_val.hh"
+#include "attr_index.hh"
+#include "edge_csr.hh"
+#include "append_graph.hh"
+#include "scatter_read_graph.hh"
+#include "projection_degree.hh"
+#include "append_tree.hh"
+#include "scatter_read_tree.hh"
+#include "cell_attributes.hh"
+#include "serialize_edge.hh"
+#include "serialize_tree.hh"
+#include "phase_stats.hh"
+#include "throw_assert.hh"
+
+#include <mpi.h>
+#include <hdf5.h>
+#include <getopt.h>
+
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <deque>
+#include <forward_list>
+#include <map>
+#include <random>
+#include <set>
+#include <sstream>
+#include <string>
+#include <vector>
+
+using namespace std;
+using namespace neuroh5;
+
+
+void throw_err(char const* err_message)
+{
+  fprintf(stderr, "Error: %s\n", err_message);
+  MPI_Abort(MPI_COMM_WORLD, 1);
+}
+
+void print_usage_full(char** argv)
+{
+  printf("Usage: %s [<OPTIONS>] <FILE>\n\n", argv[0]);
+  printf("Generates a synthetic NeuroH5 file and times the collective read and write routines.\n\n");
+  printf("Options:\n");
+  printf("\t-c <N>, --cells=<N>:\n");
+  printf("\t\tNumber of cells per population (strong scaling; default 10000)\n");
+  printf("\t-w <N>, --cells-per-rank=<N>:\n");
+  printf("\t\tNumber of cells per population and rank (weak scaling)\n");
+  printf("\t-d <N>, --degree=<N>:\n");
+  printf("\t\tMean in-degree of the destination cells (default 100)\n");
+  printf("\t-D <DIST>, --degree-dist=<DIST>:\n");
+  printf("\t\tIn-degree distribution: fixed, uniform, poisson or lognormal (default poisson)\n");
+  printf("\t-n <N>, --edge-namespaces=<N>:\n");
+  printf("\t\tNumber of edge attribute namespaces (default 1)\n");
+  printf("\t-a <N>, --cell-attributes=<N>:\n");
+  printf("\t\tNumber of cell attributes (default 2)\n");
+  printf("\t-v <N>, --attribute-values=<N>:\n");
+  printf("\t\tNumber of values of each cell attribute per cell (default 10)\n");
+  printf("\t-t <N>, --tree-points=<N>:\n");
+  printf("\t\tNumber of points per tree; 0 disables the tree phases (default 50)\n");
+  printf("\t-i <N>, --io-size=<N>:\n");
+  printf("\t\tNumber of I/O ranks (default 1)\n");
+  printf("\t-b <N>, --block-size=<N>:\n");
+  printf("\t\tNumber of cells per rank in each block of the block read phases; 0 disables them (default 0)\n");
+  printf("\t-r <N>, --repeat=<N>:\n");
+  printf("\t\tNumber of repetitions of the read phases (default 3)\n");
+  printf("\t-f <FORMAT>, --format=<FORMAT>:\n");
+  printf("\t\tResult format: csv or json (one object per line; default csv)\n");
+  printf("\t-o <FILE>, --output=<FILE>:\n");
+  printf("\t\tAppend results to the given file instead of standard output\n");
+  printf("\t-S <FILE>, --stats=<FILE>:\n");
+  printf("\t\tAppend the internal phase statistics of the library to the given file as JSON\n");
+  printf("\t-s <SEED>, --seed=<SEED>:\n");
+  printf("\t\tSeed of the generator (default 17)\n");
+  printf("\t-k, --keep:\n");
+  printf("\t\tKeep the generated file\n");
+}
+
+
+struct BenchConfig
+{
+  string file_name;
+  size_t num_cells      = 10000;
+  bool   weak_scaling   = false;
+  size_t degree         = 100;
+  string degree_dist    = "poisson";
+  size_t num_edge_namespaces = 1;
+  size_t num_cell_attrs = 2;
+  size_t num_attr_values = 10;
+  size_t tree_points    = 50;
+  size_t io_size        = 1;
+  size_t block_size     = 0;
+  size_t repeat         = 3;
+  string format         = "csv";
+  string output_file_name;
+  string stats_file_name;
+  uint64_t seed         = 17;
+  bool   keep           = false;
+};
+
+
+struct PhaseResult
+{
+  string   phase;
+  size_t   iteration;
+  uint64_t items;
+  double   t_min, t_mean, t_max;
+};
+
+
+const string src_pop_name = "SRC", dst_pop_name = "DST";
+const string cell_attr_namespace = "Bench Attributes";
+
+static string edge_attr_namespace (const size_t i)
+{
+  stringstream ss;
+  ss << "Synapses " << i;
+  return ss.str();
+}
+
+
+/*****************************************************************************
+ * Synthetic file generator
+ *
+ * The generated content only depends on the cell gids and the seed, so
+ * that the same file is produced with any number of ranks.
+ *****************************************************************************/
+
+static void create_bench_file (MPI_Comm comm, const BenchConfig& config)
+{
+  int rank;
+  throw_assert_nomsg(MPI_Comm_rank(comm, &rank) == MPI_SUCCESS);
+
+  if (rank == 0)
+    {
+      hid_t file = H5Fcreate(config.file_name.c_str(), H5F_ACC_TRUNC, H5P_DEFAULT, H5P_DEFAULT);
+      throw_assert(file >= 0, "neuroh5_bench: unable to create file " << config.file_name);
+      hid_t grp = H5Gcreate2(file, hdf5::H5_TYPES.c_str(), H5P_DEFAULT, H5P_DEFAULT, H5P_DEFAULT);
+      throw_assert_nomsg(grp >= 0);
+
+      hid_t pop_labels_type = H5Tenum_create(H5T_NATIVE_UINT16);
+      throw_assert_nomsg(pop_labels_type >= 0);
+      const pop_t src_pop = 0, dst_pop = 1;
+      throw_assert_nomsg(H5Tenum_insert(pop_labels_type, src_pop_name.c_str(), &src_pop) >= 0);
+      throw_assert_nomsg(H5Tenum_insert(pop_labels_type, dst_pop_name.c_str(), &dst_pop) >= 0);
+      throw_assert_nomsg(H5Tcommit2(grp, hdf5::POP_LABELS.c_str(), pop_labels_type,
+                                    H5P_DEFAULT, H5P_DEFAULT, H5P_DEFAULT) >= 0);
+
+      hid_t pop_range_type = H5Tcreate(H5T_COMPOUND, sizeof(pop_range_t));
+      throw_assert_nomsg(pop_range_type >= 0);
+      throw_assert_nomsg(H5Tinsert(pop_range_type, "Start", HOFFSET(pop_range_t, start),
+                                   H5T_NATIVE_UINT64) >= 0);
+      throw_assert_nomsg(H5Tinsert(pop_range_type, "Count", HOFFSET(pop_range_t, count),
+                                   H5T_NATIVE_UINT32) >= 0);
+      throw_assert_nomsg(H5Tinsert(pop_range_type, "Population", HOFFSET(pop_range_t, pop),
+                                   pop_labels_type) >= 0);
+      vector<pop_range_t> pop_ranges(2);
+      pop_ranges[0].start = 0;
+      pop_ranges[0].count = config.num_cells;
+      pop_ranges[0].pop   = src_pop;
+      pop_ranges[1].start = config.num_cells;
+      pop_ranges[1].count = config.num_cells;
+      pop_ranges[1].pop   = dst_pop;
+      hsize_t dims = pop_ranges.size();
+      hid_t fspace = H5Screate_simple(1, &dims, &dims);
+      hid_t dset = H5Dcreate2(grp, hdf5::POPULATIONS.c_str(), pop_range_type, fspace,
+                              H5P_DEFAULT, H5P_DEFAULT, H5P_DEFAULT);
+      throw_assert_nomsg(dset >= 0);
+      throw_assert_nomsg(H5Dwrite(dset, pop_range_type, H5S_ALL, H5S_ALL, H5P_DEFAULT,
+                                  &pop_ranges[0]) >= 0);
+      throw_assert_nomsg(H5Dclose(dset) >= 0);
+      throw_assert_nomsg(H5Sclose(fspace) >= 0);
+
+      hid_t pop_comb_type = H5Tcreate(H5T_COMPOUND, sizeof(pop_comb_t));
+      throw_assert_nomsg(pop_comb_type >= 0);
+      throw_assert_nomsg(H5Tinsert(pop_comb_type, "Source", HOFFSET(pop_comb_t, src),
+                                   pop_labels_type) >= 0);
+      throw_assert_nomsg(H5Tinsert(pop_comb_type, "Destination", HOFFSET(pop_comb_t, dst),
+                                   pop_labels_type) >= 0);
+      pop_comb_t pop_comb;
+      pop_comb.src = src_pop;
+      pop_comb.dst = dst_pop;
+      dims = 1;
+      fspace = H5Screate_simple(1, &dims, &dims);
+      dset = H5Dcreate2(grp, hdf5::POP_COMBS.c_str(), pop_comb_type, fspace,
+                        H5P_DEFAULT, H5P_DEFAULT, H5P_DEFAULT);
+      throw_assert_nomsg(dset >= 0);
+      throw_assert_nomsg(H5Dwrite(dset, pop_comb_type, H5S_ALL, H5S_ALL, H5P_DEFAULT,
+                                  &pop_comb) >= 0);
+      throw_assert_nomsg(H5Dclose(dset) >= 0);
+      throw_assert_nomsg(H5Sclose(fspace) >= 0);
+
+      throw_assert_nomsg(H5Tclose(pop_comb_type) >= 0);
+      throw_assert_nomsg(H5Tclose(pop_range_type) >= 0);
+      throw_assert_nomsg(H5Tclose(pop_labels_type) >= 0);
+      throw_assert_nomsg(H5Gclose(grp) >= 0);
+      throw_assert_nomsg(H5Fclose(file) >= 0);
+    }
+  throw_assert_nomsg(MPI_Barrier(comm) == MPI_SUCCESS);
+}
+
+
+static size_t sample_degree (const BenchConfig& config, mt19937_64& rng)
+{
+  if (config.degree_dist == "fixed")
+    {
+      return config.degree;
+    }
+  if (config.degree_dist == "uniform")
+    {
+      uniform_int_distribution<size_t> dist(0, 2 * config.degree);
+      return dist(rng);
+    }
+  if (config.degree_dist == "lognormal")
+    {
+      // heavy-tailed, with the given mean
+      const double sigma = 1.0;
+      lognormal_distribution<double> dist(log((double)config.degree) - 0.5 * sigma * sigma, sigma);
+      return (size_t)llround(dist(rng));
+    }
+  poisson_distribution<size_t> dist(config.degree);
+  return dist(rng);
+}
+
+
+static void generate_edges (const BenchConfig& config, const size_t dst_start, const size_t dst_end,
+                            edge_map_t& edge_map)
+{
+  const size_t num_cells = config.num_cells;
+  uniform_int_distribution<NODE_IDX_T> src_dist(0, num_cells - 1);
+  uniform_real_distribution<float> distance_dist(0.f, 1000.f);
+  for (size_t gid = dst_start; gid < dst_end; gid++)
+    {
+      mt19937_64 rng(config.seed * 1000003 + gid);
+      size_t degree = sample_degree(config, rng);
+      vector<NODE_IDX_T> adj(degree);
+      for (size_t j = 0; j < degree; j++)
+        {
+          adj[j] = src_dist(rng);
+        }
+      vector<data::AttrVal> edge_attrs(config.num_edge_namespaces);
+      for (auto& attr_val : edge_attrs)
+        {
+          vector<float> distances(degree);
+          vector<uint8_t> layers(degree);
+          for (size_t j = 0; j < degree; j++)
+            {
+              distances[j] = distance_dist(rng);
+              layers[j] = j % 4;
+            }
+          attr_val.insert(distances);
+          attr_val.insert(layers);
+        }
+      edge_map.insert(make_pair(gid, make_tuple(adj, edge_attrs)));
+    }
+}
+
+
+static void generate_cell_attributes (const BenchConfig& config, const size_t start, const size_t end,
+                                      map<string, map<CELL_IDX_T, deque<float> > >& attr_values)
+{
+  for (size_t a = 0; a < config.num_cell_attrs; a++)
+    {
+      stringstream ss;
+      ss << "attr" << a;
+      map<CELL_IDX_T, deque<float> >& value_map = attr_values[ss.str()];
+      for (size_t gid = start; gid < end; gid++)
+        {
+          mt19937_64 rng(config.seed * 1000033 + gid * config.num_cell_attrs + a);
+          normal_distribution<float> dist;
+          deque<float>& values = value_map[gid];
+          for (size_t j = 0; j < config.num_attr_values; j++)
+            {
+              values.push_back(dist(rng));
+            }
+        }
+    }
+}
+
+
+/// Unbranched trees with sections of up to section_points points
+static void generate_trees (const BenchConfig& config, const size_t start, const size_t end,
+                            forward_list<neurotree_t>& tree_list)
+{
+  const size_t num_points = config.tree_points, section_points = 10;
+  const size_t num_sections = (num_points + section_points - 1) / section_points;
+  for (size_t gid = start; gid < end; gid++)
+    {
+      mt19937_64 rng(config.seed * 1000037 + gid);
+      normal_distribution<COORD_T> step_dist(0.f, 1.f);
+      deque<SECTION_IDX_T> src_vector, dst_vector, sec_vector;
+      deque<COORD_T> xs, ys, zs;
+      deque<REALVAL_T> radiuses;
+      deque<LAYER_IDX_T> layers;
+      deque<PARENT_NODE_IDX_T> parents;
+      deque<SWC_TYPE_T> swc_types;
+
+      sec_vector.push_back(num_sections);
+      for (size_t s = 0; s < num_sections; s++)
+        {
+          size_t p_start = s * section_points, p_end = min(num_points, p_start + section_points);
+          sec_vector.push_back(p_end - p_start);
+          for (size_t p = p_start; p < p_end; p++)
+            {
+              sec_vector.push_back(p);
+            }
+          if (s > 0)
+            {
+              src_vector.push_back(s-1);
+              dst_vector.push_back(s);
+            }
+        }
+      COORD_T x = 0.f, y = 0.f, z = 0.f;
+      for (size_t p = 0; p < num_points; p++)
+        {
+          x += step_dist(rng); y += step_dist(rng); z += step_dist(rng);
+          xs.push_back(x); ys.push_back(y); zs.push_back(z);
+          radiuses.push_back(1.f);
+          layers.push_back(p * 4 / num_points);
+          parents.push_back((PARENT_NODE_IDX_T)p - 1);
+          swc_types.push_back((p == 0) ? 1 : 3);
+        }
+      tree_list.push_front(make_tuple(gid, src_vector, dst_vector, sec_vector,
+                                      xs, ys, zs, radiuses, layers, parents, swc_types));
+    }
+}
+
+
+/*****************************************************************************
+ * Timing and results
+ *****************************************************************************/
+
+static void record_phase (MPI_Comm comm, const string& phase, const size_t iteration,
+                          const double elapsed, const uint64_t local_items,
+                          vector<PhaseResult>& results)
+{
+  int size;
+  throw_assert_nomsg(MPI_Comm_size(comm, &size) == MPI_SUCCESS);
+
+  PhaseResult result;
+  result.phase = phase;
+  result.iteration = iteration;
+  double t_sum = 0.;
+  throw_assert_nomsg(MPI_Allreduce(&elapsed, &result.t_min, 1, MPI_DOUBLE, MPI_MIN, comm) == MPI_SUCCESS);
+  throw_assert_nomsg(MPI_Allreduce(&elapsed, &result.t_max, 1, MPI_DOUBLE, MPI_MAX, comm) == MPI_SUCCESS);
+  throw_assert_nomsg(MPI_Allreduce(&elapsed, &t_sum, 1, MPI_DOUBLE, MPI_SUM, comm) == MPI_SUCCESS);
+  throw_assert_nomsg(MPI_Allreduce(&local_items, &result.items, 1, MPI_UINT64_T, MPI_SUM, comm) == MPI_SUCCESS);
+  result.t_mean = t_sum / size;
+  results.push_back(result);
+}
+
+
+/// Runs op on all ranks between barriers and records its wall time
+template <class Op>
+static void time_phase (MPI_Comm comm, const string& phase, const size_t iteration,
+                        vector<PhaseResult>& results, Op op)
+{
+  throw_assert_nomsg(MPI_Barrier(comm) == MPI_SUCCESS);
+  double t0 = MPI_Wtime();
+  uint64_t local_items = op();
+  double elapsed = MPI_Wtime() - t0;
+  record_phase(comm, phase, iteration, elapsed, local_items, results);
+}
+
+
+static void write_results (const BenchConfig& config, const int size,
+                           const vector<PhaseResult>& results)
+{
+  FILE* out = stdout;
+  bool header = (config.format == "csv");
+  if (config.output_file_name.size() > 0)
+    {
+      out = fopen(config.output_file_name.c_str(), "a");
+      throw_assert(out != nullptr, "neuroh5_bench: unable to open " << config.output_file_name);
+      header = header && (ftell(out) == 0);
+    }
+
+  const char* scaling = config.weak_scaling ? "weak" : "strong";
+  if (header)
+    {
+      fprintf(out, "phase,iteration,ranks,io_size,scaling,cells,degree,degree_dist,"
+              "edge_namespaces,cell_attributes,tree_points,items,t_min,t_mean,t_max,imbalance\n");
+    }
+  for (const PhaseResult& r : results)
+    {
+      double imbalance = (r.t_mean > 0.) ? r.t_max / r.t_mean : 1.;
+      if (config.format == "json")
+        {
+          fprintf(out, "{\"phase\": \"%s\", \"iteration\": %zu, \"ranks\": %d, \"io_size\": %zu, "
+                  "\"scaling\": \"%s\", \"cells\": %zu, \"degree\": %zu, \"degree_dist\": \"%s\", "
+                  "\"edge_namespaces\": %zu, \"cell_attributes\": %zu, \"tree_points\": %zu, "
+                  "\"items\": %llu, \"t_min\": %.6f, \"t_mean\": %.6f, \"t_max\": %.6f, "
+                  "\"imbalance\": %.4f}\n",
+                  r.phase.c_str(), r.iteration, size, config.io_size, scaling, config.num_cells,
+                  config.degree, config.degree_dist.c_str(), config.num_edge_namespaces,
+                  config.num_cell_attrs, config.tree_points, (unsigned long long)r.items,
+                  r.t_min, r.t_mean, r.t_max, imbalance);
+        }
+      else
+        {
+          fprintf(out, "%s,%zu,%d,%zu,%s,%zu,%zu,%s,%zu,%zu,%zu,%llu,%.6f,%.6f,%.6f,%.4f\n",
+                  r.phase.c_str(), r.iteration, size, config.io_size, scaling, config.num_cells,
+                  config.degree, config.degree_dist.c_str(), config.num_edge_namespaces,
+                  config.num_cell_attrs, config.tree_points, (unsigned long long)r.items,
+                  r.t_min, r.t_mean, r.t_max, imbalance);
+        }
+    }
+
+  if (out != stdout)
+    {
+      fclose(out);
+    }
+}
+
+
+static uint64_t edge_map_num_edges (const edge_map_t& edge_map)
+{
+  uint64_t num_edges = 0;
+  for (auto const& iter : edge_map)
+    {
+      num_edges += get<0>(iter.second).size();
+    }
+  return num_edges;
+}
+
+
+/*****************************************************************************
+ * Main driver
+ *****************************************************************************/
+
+int main(int argc, char** argv)
+{
+  BenchConfig config;
+  MPI_Comm all_comm;
+
+  // received edges may be unpacked by OpenMP threads, which make no MPI calls
+  int thread_level;
+  throw_assert(MPI_Init_thread(&argc, &argv, MPI_THREAD_FUNNELED, &thread_level) >= 0,
+               "neuroh5_bench: error in MPI initialization");
+  MPI_Comm_dup(MPI_COMM_WORLD, &all_comm);
+
+  int rank, size;
+  throw_assert(MPI_Comm_size(all_comm, &size) == MPI_SUCCESS,
+               "neuroh5_bench: error in MPI_Comm_size");
+  throw_assert(MPI_Comm_rank(all_comm, &rank) == MPI_SUCCESS,
+               "neuroh5_bench: error in MPI_Comm_rank");
+
+  static struct option long_options[] = {
+    {"cells",            required_argument, 0, 'c' },
+    {"cells-per-rank",   required_argument, 0, 'w' },
+    {"degree",           required_argument, 0, 'd' },
+    {"degree-dist",      required_argument, 0, 'D' },
+    {"edge-namespaces",  required_argument, 0, 'n' },
+    {"cell-attributes",  required_argument, 0, 'a' },
+    {"attribute-values", required_argument, 0, 'v' },
+    {"tree-points",      required_argument, 0, 't' },
+    {"io-size",          required_argument, 0, 'i' },
+    {"block-size",       required_argument, 0, 'b' },
+    {"repeat",           required_argument, 0, 'r' },
+    {"format",           required_argument, 0, 'f' },
+    {"output",           required_argument, 0, 'o' },
+    {"seed",             required_argument, 0, 's' },
+    {"stats",            required_argument, 0, 'S' },
+    {"keep",             no_argument,       0, 'k' },
+    {"help",             no_argument,       0, 'h' },
+    {0,         0,                 0,  0 }
+  };
+  int c;
+  int option_index = 0;
+  while ((c = getopt_long (argc, argv, "a:b:c:d:D:f:hi:kn:o:r:s:S:t:v:w:",
+                           long_options, &option_index)) != -1)
+    {
+      switch (c)
+        {
+        case 'a':
+          config.num_cell_attrs = strtoull(optarg, nullptr, 10);
+          break;
+        case 'b':
+          config.block_size = strtoull(optarg, nullptr, 10);
+          break;
+        case 'c':
+          config.num_cells = strtoull(optarg, nullptr, 10);
+          break;
+        case 'w':
+          config.weak_scaling = true;
+          config.num_cells = strtoull(optarg, nullptr, 10) * size;
+          break;
+        case 'd':
+          config.degree = strtoull(optarg, nullptr, 10);
+          break;
+        case 'D':
+          config.degree_dist = string(optarg);
+          if ((config.degree_dist != "fixed") && (config.degree_dist != "uniform") &&
+              (config.degree_dist != "poisson") && (config.degree_dist != "lognormal"))
+            {
+              throw_err("Unknown degree distribution");
+            }
+          break;
+        case 'n':
+          config.num_edge_namespaces = strtoull(optarg, nullptr, 10);
+          break;
+        case 'v':
+          config.num_attr_values = strtoull(optarg, nullptr, 10);
+          break;
+        case 't':
+          config.tree_points = strtoull(optarg, nullptr, 10);
+          break;
+        case 'i':
+          config.io_size = strtoull(optarg, nullptr, 10);
+          break;
+        case 'r':
+          config.repeat = strtoull(optarg, nullptr, 10);
+          break;
+        case 'f':
+          config.format = string(optarg);
+          if ((config.format != "csv") && (config.format != "json"))
+            {
+              throw_err("Unknown result format");
+            }
+          break;
+        case 'o':
+          config.output_file_name = string(optarg);
+          break;
+        case 's':
+          config.seed = strtoull(optarg, nullptr, 10);
+          break;
+        case 'S':
+          config.stats_file_name = string(optarg);
+          mpi::enable_stats(true);
+          break;
+        case 'k':
+          config.keep = true;
+          break;
+        case 'h':
+          if (rank == 0)
+            {
+              print_usage_full(argv);
+            }
+          MPI_Finalize();
+          exit(0);
+          break;
+        default:
+          throw_err("Input argument format error");
+        }
+    }
+
+  if (optind < argc)
+    {
+      config.file_name = string(argv[optind]);
+    }
+  else
+    {
+      if (rank == 0)
+        {
+          print_usage_full(argv);
+        }
+      MPI_Finalize();
+      exit(1);
+    }
+  throw_assert(config.num_cells > 0, "neuroh5_bench: number of cells must be positive");
+  config.io_size = max((size_t)1, min(config.io_size, (size_t)size));
+
+  const CELL_IDX_T dst_pop_start = config.num_cells;
+  const size_t total_num_nodes = 2 * config.num_cells;
+
+  // each rank generates a contiguous range of destination cells
+  vector< pair<hsize_t,hsize_t> > ranges;
+  mpi::rank_ranges(config.num_cells, size, ranges);
+  const size_t local_start = dst_pop_start + ranges[rank].first;
+  const size_t local_end   = local_start + ranges[rank].second;
+
+  vector<string> edge_attr_namespaces;
+  map <string, pair <size_t, data::AttrIndex > > edge_attr_index;
+  for (size_t i = 0; i < config.num_edge_namespaces; i++)
+    {
+      string attr_namespace = edge_attr_namespace(i);
+      data::AttrSet attr_set;
+      attr_set.add<float>("distance");
+      attr_set.add<uint8_t>("layer");
+      edge_attr_namespaces.push_back(attr_namespace);
+      edge_attr_index[attr_namespace] = make_pair(i, data::AttrIndex(attr_set));
+    }
+
+  node_rank_map_t node_rank_map;
+  node_rank_map.assign_round_robin(0, total_num_nodes, size);
+
+  vector<PhaseResult> results;
+
+  time_phase(all_comm, "create_file", 0, results, [&] () -> uint64_t
+             {
+               create_bench_file(all_comm, config);
+               return 0;
+             });
+
+  /*
+   * Write phases
+   */
+
+  edge_map_t edge_map;
+  time_phase(all_comm, "generate_edges", 0, results, [&] () -> uint64_t
+             {
+               generate_edges(config, local_start, local_end, edge_map);
+               return edge_map_num_edges(edge_map);
+             });
+
+  // serialization of the edges for a scatter to all ranks, without the
+  // exchange itself
+  {
+    rank_edge_map_t rank_edge_map;
+    vector<char> sendbuf;
+    vector<size_t> sendcounts(size, 0), sdispls(size, 0);
+    for (size_t iteration = 0; iteration < config.repeat; iteration++)
+      {
+        time_phase(all_comm, "serialize_rank_edge_map", iteration, results, [&] () -> uint64_t
+                   {
+                     rank_edge_map.clear();
+                     for (auto const& iter : edge_map)
+                       {
+                         rank_edge_map[iter.first % size].insert(iter);
+                       }
+                     size_t num_packed_edges = 0;
+                     sendbuf.clear();
+                     data::serialize_rank_edge_map(size, 0, rank_edge_map, num_packed_edges,
+                                                   sendcounts, sendbuf, sdispls);
+                     return sendbuf.size();
+                   });
+        time_phase(all_comm, "deserialize_rank_edge_map", iteration, results, [&] () -> uint64_t
+                   {
+                     edge_map_t unpacked_edge_map;
+                     size_t num_unpacked_nodes = 0, num_unpacked_edges = 0;
+                     data::deserialize_rank_edge_map(size, sendbuf, sendcounts, sdispls,
+                                                     unpacked_edge_map, num_unpacked_nodes,
+                                                     num_unpacked_edges);
+                     return sendbuf.size();
+                   });
+      }
+  }
+
+  time_phase(all_comm, "append_graph", 0, results, [&] () -> uint64_t
+             {
+               uint64_t num_edges = edge_map_num_edges(edge_map);
+               throw_assert(graph::append_graph(all_comm, config.io_size, config.file_name,
+                                                src_pop_name, dst_pop_name,
+                                                edge_attr_index, edge_map) >= 0,
+                            "neuroh5_bench: error in append_graph");
+               return num_edges;
+             });
+  edge_map.clear();
+
+  if (config.num_cell_attrs > 0)
+    {
+      map<string, map<CELL_IDX_T, deque<float> > > attr_values;
+      generate_cell_attributes(config, local_start, local_end, attr_values);
+      time_phase(all_comm, "append_cell_attributes", 0, results, [&] () -> uint64_t
+                 {
+                   const data::optional_hid dflt_data_type;
+                   cell::append_cell_attribute_maps(all_comm, config.file_name, cell_attr_namespace,
+                                                    dst_pop_name, dst_pop_start,
+                                                    {}, {}, {}, {}, {}, {}, attr_values,
+                                                    config.io_size, dflt_data_type);
+                   return (local_end - local_start) * attr_values.size();
+                 });
+    }
+
+  if (config.tree_points > 0)
+    {
+      forward_list<neurotree_t> tree_list;
+      generate_trees(config, local_start, local_end, tree_list);
+
+      for (size_t iteration = 0; iteration < config.repeat; iteration++)
+        {
+          vector<char> sendbuf;
+          vector<size_t> sendcounts(size, 0), sdispls(size, 0);
+          time_phase(all_comm, "serialize_rank_tree_map", iteration, results, [&] () -> uint64_t
+                     {
+                       map <rank_t, map<CELL_IDX_T, neurotree_t> > rank_tree_map;
+                       for (const neurotree_t& tree : tree_list)
+                         {
+                           CELL_IDX_T gid = get<0>(tree);
+                           rank_tree_map[gid % size].insert(make_pair(gid, tree));
+                         }
+                       data::serialize_rank_tree_map(size, 0, rank_tree_map, sendcounts, sendbuf, sdispls);
+                       return sendbuf.size();
+                     });
+          time_phase(all_comm, "deserialize_rank_tree_map", iteration, results, [&] () -> uint64_t
+                     {
+                       map<CELL_IDX_T, neurotree_t> tree_map;
+                       data::deserialize_rank_tree_map(size, sendbuf, sendcounts, sdispls, tree_map);
+                       return sendbuf.size();
+                     });
+        }
+
+      time_phase(all_comm, "append_trees", 0, results, [&] () -> uint64_t
+                 {
+                   throw_assert(cell::append_trees(all_comm, config.file_name, dst_pop_name,
+                                                   dst_pop_start, tree_list, config.io_size) >= 0,
+                                "neuroh5_bench: error in append_trees");
+                   return local_end - local_start;
+                 });
+    }
+
+  /*
+   * Read phases
+   */
+
+  for (size_t iteration = 0; iteration < config.repeat; iteration++)
+    {
+      time_phase(all_comm, "scatter_read_graph", iteration, results, [&] () -> uint64_t
+                 {
+                   vector< pair<string,string> > prj_names({ make_pair(src_pop_name, dst_pop_name) });
+                   vector<data::EdgeCSR> prj_vector;
+                   vector < map <string, vector < vector<string> > > > edge_attr_names_vector;
+                   size_t local_num_nodes = 0, num_nodes = 0, local_num_edges = 0, total_num_edges = 0;
+                   throw_assert(graph::scatter_read_graph(all_comm, EdgeMapDst, config.file_name,
+                                                          config.io_size, edge_attr_namespaces,
+                                                          prj_names, node_rank_map, prj_vector,
+                                                          edge_attr_names_vector,
+                                                          local_num_nodes, num_nodes,
+                                                          local_num_edges, total_num_edges) >= 0,
+                                "neuroh5_bench: error in scatter_read_graph");
+                   return local_num_edges;
+                 });
+      time_phase(all_comm, "read_projection_degree", iteration, results, [&] () -> uint64_t
+                 {
+                   graph::ProjectionDegree prj_degree;
+                   graph::read_projection_degree(all_comm, config.file_name, src_pop_name, dst_pop_name,
+                                                 EdgeMapDst, prj_degree);
+                   uint64_t local_degree = 0;
+                   for (size_t degree : prj_degree.degree)
+                     {
+                       local_degree += degree;
+                     }
+                   return local_degree;
+                 });
+
+      if (config.num_cell_attrs > 0)
+        {
+          time_phase(all_comm, "scatter_read_cell_attributes", iteration, results, [&] () -> uint64_t
+                     {
+                       data::NamedAttrMap attr_map;
+                       throw_assert(cell::scatter_read_cell_attributes(all_comm, config.file_name,
+                                                                       config.io_size, cell_attr_namespace,
+                                                                       set<string>(), node_rank_map,
+                                                                       dst_pop_name, dst_pop_start,
+                                                                       attr_map) >= 0,
+                                    "neuroh5_bench: error in scatter_read_cell_attributes");
+                       return attr_map.index_set.size();
+                     });
+        }
+
+      if (config.tree_points > 0)
+        {
+          time_phase(all_comm, "scatter_read_trees", iteration, results, [&] () -> uint64_t
+                     {
+                       map<CELL_IDX_T, neurotree_t> tree_map;
+                       map<string, data::NamedAttrMap> attr_maps;
+                       throw_assert(cell::scatter_read_trees(all_comm, config.file_name, config.io_size,
+                                                             vector<string>(), node_rank_map,
+                                                             dst_pop_name, dst_pop_start,
+                                                             tree_map, attr_maps) >= 0,
+                                    "neuroh5_bench: error in scatter_read_trees");
+                       return tree_map.size();
+                     });
+        }
+
+      // successive blocks, as read by the Python generators
+      if ((config.block_size > 0) && (config.num_cell_attrs > 0))
+        {
+          const vector< pair<string, set<string> > > attr_name_spaces(1, make_pair(cell_attr_namespace, set<string>()));
+          time_phase(all_comm, "scatter_read_cell_attribute_blocks", iteration, results, [&] () -> uint64_t
+                     {
+                       uint64_t num_cells = 0;
+                       for (size_t offset = 0; offset < config.num_cells; offset += size * config.block_size)
+                         {
+                           data::ColumnarAttrMap attr_map;
+                           throw_assert(cell::scatter_read_cell_attributes(all_comm, config.file_name,
+                                                                           config.io_size, cell_attr_namespace,
+                                                                           set<string>(), node_rank_map,
+                                                                           dst_pop_name, dst_pop_start,
+                                                                           attr_map, offset, config.block_size) >= 0,
+                                        "neuroh5_bench: error in scatter_read_cell_attributes");
+                           num_cells += attr_map.index.size();
+                         }
+                       return num_cells;
+                     });
+          time_phase(all_comm, "block_read_cell_attributes", iteration, results, [&] () -> uint64_t
+                     {
+                       uint64_t num_cells = 0;
+                       cell::CellAttributeBlockReader reader(all_comm, config.file_name, config.io_size,
+                                                             attr_name_spaces, node_rank_map,
+                                                             dst_pop_name, dst_pop_start);
+                       for (size_t offset = 0; offset < config.num_cells; offset += size * config.block_size)
+                         {
+                           vector<data::ColumnarAttrMap> attr_maps;
+                           throw_assert(reader.read(offset, config.block_size, attr_maps) >= 0,
+                                        "neuroh5_bench: error in CellAttributeBlockReader::read");
+                           num_cells += attr_maps[0].index.size();
+                         }
+                       return num_cells;
+                     });
+        }
+
+      if ((config.block_size > 0) && (config.tree_points > 0))
+        {
+          time_phase(all_comm, "scatter_read_tree_blocks", iteration, results, [&] () -> uint64_t
+                     {
+                       uint64_t num_trees = 0;
+                       for (size_t offset = 0; offset < config.num_cells; offset += size * config.block_size)
+                         {
+                           data::PackedTrees trees;
+                           map<string, data::NamedAttrMap> attr_maps;
+                           throw_assert(cell::scatter_read_trees(all_comm, config.file_name, config.io_size,
+                                                                 vector<string>(), node_rank_map,
+                                                                 dst_pop_name, dst_pop_start,
+                                                                 trees, attr_maps,
+                                                                 offset, config.block_size) >= 0,
+                                        "neuroh5_bench: error in scatter_read_trees");
+                           num_trees += trees.num_trees();
+                         }
+                       return num_trees;
+                     });
+          time_phase(all_comm, "block_read_trees", iteration, results, [&] () -> uint64_t
+                     {
+                       uint64_t num_trees = 0;
+                       cell::TreeBlockReader reader(all_comm, config.file_name, config.io_size,
+                                                    vector<string>(), node_rank_map,
+                                                    dst_pop_name, dst_pop_start);
+                       for (size_t offset = 0; offset < config.num_cells; offset += size * config.block_size)
+                         {
+                           data::PackedTrees trees;
+                           map<string, data::NamedAttrMap> attr_maps;
+                           throw_assert(reader.read(offset, config.block_size, trees, attr_maps) >= 0,
+                                        "neuroh5_bench: error in TreeBlockReader::read");
+                           num_trees += trees.num_trees();
+                         }
+                       return num_trees;
+                     });
+        }
+    }
+
+  if (config.stats_file_name.size() > 0)
+    {
+      mpi::write_stats(all_comm, config.stats_file_name);
+    }
+
+  if (rank == 0)
+    {
+      write_results(config, size, results);
+      if (!config.keep)
+        {
+          remove(config.file_name.c_str());
+        }
+    }
+
+  MPI_Comm_free(&all_comm);
+  MPI_Finalize();
+
+  return 0;
+}
@@ -238,7 +238,7 @@ int main(int argc, char** argv)
   std::string input_file_name, rank_file_name;
   vector<string> attr_name_spaces;
   size_t n_nodes;
-  map<CELL_IDX_T, set<rank_t>> node_rank_map;
+  node_rank_map_t node_rank_map;
   stringstream ss;
 
   throw_assert(MPI_Init(&argc, &argv) >= 0,
@@ -366,11 +366,8 @@ int main(int argc, char** argv)
   // Determine which nodes are assigned to which compute ranks
   if (!opt_rankfile)
     {
-      // round-robin node to rank assignment from file
-      for (size_t i = 0; i < n_nodes; i++)
-        {
-          node_rank_map[i].insert(i%size);
-        }
+      // round-robin node to rank assignment
+      node_rank_map.assign_round_robin(0, n_nodes, size);
     }
   else
     {
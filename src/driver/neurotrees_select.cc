@@ -320,11 +320,8 @@ int main(int argc, char** argv)
   // Determine which nodes are assigned to which compute ranks
   if (!opt_rankfile)
     {
-      // round-robin node to rank assignment from file
-      for (size_t i = 0; i < n_nodes; i++)
-        {
-          node_rank_map[i].insert(i%size);
-        }
+      // round-robin node to rank assignment
+      node_rank_map.assign_round_robin(0, n_nodes, size);
     }
   else
     {
@@ -517,8 +514,7 @@ int main(int argc, char** argv)
       throw_assert(it != subset_node_rank_map.end(),
                    "neurotrees_select: tree index not found in node rank assignment"); 
 
-      set<rank_t> tree_ranks = it->second;
-      for (rank_t tree_rank : tree_ranks)
+      for (rank_t tree_rank : it->second)
         {
           tree_subset_rank_map[tree_rank].insert(make_pair(idx, tree));
         }
@@ -87,11 +87,12 @@ void print_usage_full(char** argv)
 int main(int argc, char** argv)
 {
   std::string input_file_name, output;
-  size_t iosize = 0;
 
   signal(SIGSEGV, segv_handler);  
   
-  throw_assert(MPI_Init(&argc, &argv) >= 0,
+  // received edges may be unpacked by OpenMP threads, which make no MPI calls
+  int thread_level;
+  throw_assert(MPI_Init_thread(&argc, &argv, MPI_THREAD_FUNNELED, &thread_level) >= 0,
                "vertex_metrics: error in MPI initialization"); 
 
   int rank, size;
@@ -104,36 +105,27 @@ int main(int argc, char** argv)
   debug_enabled = false;
   
   // parse arguments
-  int optflag_iosize = 0;
   int optflag_output = 0;
   int optflag_indegree = 0;
   int optflag_outdegree = 0;
-  bool opt_iosize    = false,
-    opt_indegree     = false,
+  bool opt_indegree = false,
     opt_outdegree    = false,
     opt_output       = false;
 
   static struct option long_options[] = {
     {"output",    required_argument, &optflag_output,  1 },
-    {"iosize",    required_argument, &optflag_iosize,  1 },
     {"indegree",  no_argument, &optflag_indegree,  1 },
     {"outdegree", no_argument, &optflag_outdegree,  1 },
     {0,         0,                 0,  0 }
   };
   int c;
   int option_index = 0;
-  while ((c = getopt_long (argc, argv, "hi:o:",
+  while ((c = getopt_long (argc, argv, "ho:",
                            long_options, &option_index)) != -1)
     {
-      stringstream ss;
       switch (c)
         {
         case 0:
-          if (optflag_iosize == 1) {
-            opt_iosize = true;
-            ss << string(optarg);
-            ss >> iosize;
-          }
           if (optflag_output == 1) {
             opt_output = true;
             output = string(optarg);
@@ -149,11 +141,6 @@ int main(int argc, char** argv)
           opt_output = true;
           output = string(optarg);
           break;
-        case 'i':
-          opt_iosize = true;
-          ss << string(optarg);
-          ss >> iosize;
-          break;
         case 'h':
           print_usage_full(argv);
           exit(0);
@@ -178,8 +165,6 @@ int main(int argc, char** argv)
       exit(1);
     }
 
-  if (!opt_iosize) iosize = 4;
-
   vector<pair<string, string>> prj_names;
   throw_assert(graph::read_projection_names(MPI_COMM_WORLD, input_file_name, prj_names) >= 0,
                "vertex_metrics: error in reading projection names"); 
@@ -196,8 +181,7 @@ int main(int argc, char** argv)
         (
          MPI_COMM_WORLD,
          input_file_name,
-         prj_names,
-         iosize
+         prj_names
          );
     }
 
@@ -207,8 +191,7 @@ int main(int argc, char** argv)
         (
          MPI_COMM_WORLD,
          input_file_name,
-         prj_names,
-         iosize
+         prj_names
          );
     }
 
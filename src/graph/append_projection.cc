@@ -5,7 +5,10 @@
 #include "create_group.hh"
 #include "exists_dataset.hh"
 #include "append_projection.hh"
+#include "edge_csr.hh"
+#include "dataset_creation.hh"
 #include "write_template.hh"
+#include "phase_stats.hh"
 #include "edge_attributes.hh"
 #include "mpe_seq.hh"
 #include "mpi_debug.hh"
@@ -40,6 +43,7 @@ namespace neuroh5
      const hsize_t             chunk_size,
      const hsize_t             block_size,
      const bool                collective,
+     const hdf5::DatasetCreationPolicy& dataset_policy,
      vector<size_t>&           recvbuf_num_blocks,
      vector<NODE_IDX_T>&       dst_blk_idx
      )
@@ -47,8 +51,8 @@ namespace neuroh5
       hid_t lcpl = H5Pcreate(H5P_LINK_CREATE);
       throw_assert_nomsg(lcpl >= 0);
       throw_assert_nomsg(H5Pset_create_intermediate_group(lcpl, 1) >= 0);
-      hid_t dcpl = H5Pcreate(H5P_DATASET_CREATE);
-      throw_assert_nomsg(H5Pset_layout(dcpl, H5D_CHUNKED) >= 0);
+      hid_t dcpl = hdf5::create_dataset_creation_plist(dataset_policy, hdf5::DatasetIndex,
+                                                       chunk_size);
       hid_t wapl = H5P_DEFAULT;
 #ifdef HDF5_IS_PARALLEL
       if (collective)
@@ -59,7 +63,6 @@ namespace neuroh5
 	}
 #endif
       
-      hsize_t chunk = chunk_size;
       hsize_t maxdims[1] = {H5S_UNLIMITED};
       hsize_t zerodims[1] = {0};
 
@@ -77,10 +80,6 @@ namespace neuroh5
         {
           fspace = H5Screate_simple(1, zerodims, maxdims);
           throw_assert_nomsg(fspace >= 0);
-	  throw_assert_nomsg(H5Pset_chunk(dcpl, 1, &chunk ) >= 0);
-#ifdef H5_HAS_PARALLEL_DEFLATE
-          throw_assert_nomsg(H5Pset_deflate(dcpl, 9) >= 0);
-#endif
 
           dset = H5Dcreate2(file, path.c_str(), NODE_IDX_H5_FILE_T, fspace,
                             lcpl, dcpl, H5P_DEFAULT);
@@ -128,6 +127,7 @@ namespace neuroh5
 	}
       throw_assert_nomsg(H5Dwrite(dset, NODE_IDX_H5_NATIVE_T, mspace, fspace,
 		      wapl, &dst_blk_idx[0]) >= 0);
+      mpi::count_write(block * sizeof(dst_blk_idx[0]));
 
       // clean-up
       throw_assert_nomsg(H5Dclose(dset) >= 0);
@@ -157,6 +157,7 @@ namespace neuroh5
      const hsize_t             chunk_size,
      const hsize_t             block_size,
      const bool                collective,
+     const hdf5::DatasetCreationPolicy& dataset_policy,
      vector<size_t>&           recvbuf_num_blocks,
      vector<DST_BLK_PTR_T>&    dst_blk_ptr
      )
@@ -164,8 +165,8 @@ namespace neuroh5
       hid_t lcpl = H5Pcreate(H5P_LINK_CREATE);
       throw_assert_nomsg(lcpl >= 0);
       throw_assert_nomsg(H5Pset_create_intermediate_group(lcpl, 1) >= 0);
-      hid_t dcpl = H5Pcreate(H5P_DATASET_CREATE);
-      throw_assert_nomsg(H5Pset_layout(dcpl, H5D_CHUNKED) >= 0);
+      hid_t dcpl = hdf5::create_dataset_creation_plist(dataset_policy, hdf5::DatasetPointer,
+                                                       chunk_size);
       hid_t wapl = H5P_DEFAULT;
 #ifdef HDF5_IS_PARALLEL
       if (collective)
@@ -176,7 +177,6 @@ namespace neuroh5
 	}
 #endif
       
-      hsize_t chunk = chunk_size;
       hsize_t maxdims[1] = {H5S_UNLIMITED};
       hsize_t zerodims[1] = {0};
 
@@ -197,10 +197,6 @@ namespace neuroh5
           fspace = H5Screate_simple(1, zerodims, maxdims);
           throw_assert_nomsg(fspace >= 0);
 
-	  throw_assert_nomsg(H5Pset_chunk(dcpl, 1, &chunk ) >= 0);
-#ifdef H5_HAS_PARALLEL_DEFLATE
-          throw_assert_nomsg(H5Pset_deflate(dcpl, 9) >= 0);
-#endif
           dset = H5Dcreate2 (file, path.c_str(), DST_BLK_PTR_H5_FILE_T,
                              fspace, lcpl, dcpl, H5P_DEFAULT);
           throw_assert_nomsg(H5Sclose(fspace) >= 0);
@@ -243,6 +239,7 @@ namespace neuroh5
         }
       throw_assert_nomsg(H5Dwrite(dset, DST_BLK_PTR_H5_NATIVE_T, mspace, fspace,
                       wapl, &dst_blk_ptr[0]) >= 0);
+      mpi::count_write(block * sizeof(dst_blk_ptr[0]));
 
       throw_assert_nomsg(H5Dclose(dset) >= 0);
       throw_assert_nomsg(H5Sclose(mspace) >= 0);
@@ -269,6 +266,7 @@ namespace neuroh5
      const hsize_t             chunk_size,
      const hsize_t             block_size,
      const bool                collective,
+     const hdf5::DatasetCreationPolicy& dataset_policy,
      vector<size_t>&           recvbuf_num_dest,
      vector<DST_PTR_T>&    dst_ptr
      )
@@ -277,8 +275,8 @@ namespace neuroh5
       hid_t lcpl = H5Pcreate(H5P_LINK_CREATE);
       throw_assert_nomsg(lcpl >= 0);
       throw_assert_nomsg(H5Pset_create_intermediate_group(lcpl, 1) >= 0);
-      hid_t dcpl = H5Pcreate(H5P_DATASET_CREATE);
-      throw_assert_nomsg(H5Pset_layout(dcpl, H5D_CHUNKED) >= 0);
+      hid_t dcpl = hdf5::create_dataset_creation_plist(dataset_policy, hdf5::DatasetPointer,
+                                                       chunk_size);
       hid_t wapl = H5P_DEFAULT;
 #ifdef HDF5_IS_PARALLEL
       if (collective)
@@ -289,7 +287,6 @@ namespace neuroh5
 	}
 #endif
       
-      hsize_t chunk = chunk_size;
       hsize_t maxdims[1] = {H5S_UNLIMITED};
       hsize_t zerodims[1] = {0};
 
@@ -303,10 +300,6 @@ namespace neuroh5
           fspace = H5Screate_simple(1, zerodims, maxdims);
           throw_assert_nomsg(fspace >= 0);
 
-	  throw_assert_nomsg(H5Pset_chunk(dcpl, 1, &chunk ) >= 0);
-#ifdef H5_HAS_PARALLEL_DEFLATE
-          throw_assert_nomsg(H5Pset_deflate(dcpl, 9) >= 0);
-#endif
           dset = H5Dcreate2 (file, path.c_str(), DST_PTR_H5_FILE_T,
                              fspace, lcpl, dcpl, H5P_DEFAULT);
           throw_assert_nomsg(dset >= 0);
@@ -363,6 +356,7 @@ namespace neuroh5
 
       throw_assert_nomsg(H5Dwrite(dset, DST_PTR_H5_NATIVE_T, mspace, fspace,
                       wapl, &dst_ptr[0]) >= 0);
+      mpi::count_write(block * sizeof(dst_ptr[0]));
 
       throw_assert_nomsg(H5Dclose(dset) >= 0);
       throw_assert_nomsg(H5Sclose(mspace) >= 0);
@@ -390,16 +384,17 @@ namespace neuroh5
      const hsize_t             chunk_size,
      const hsize_t             block_size,
      const bool                collective,
+     const hdf5::DatasetCreationPolicy& dataset_policy,
      vector<size_t>&           recvbuf_num_edge,
-     vector<NODE_IDX_T>        src_idx
+     const vector<NODE_IDX_T>& src_idx
      )
     {
 
       hid_t lcpl = H5Pcreate(H5P_LINK_CREATE);
       throw_assert_nomsg(lcpl >= 0);
       throw_assert_nomsg(H5Pset_create_intermediate_group(lcpl, 1) >= 0);
-      hid_t dcpl = H5Pcreate(H5P_DATASET_CREATE);
-      throw_assert_nomsg(H5Pset_layout(dcpl, H5D_CHUNKED) >= 0);
+      hid_t dcpl = hdf5::create_dataset_creation_plist(dataset_policy, hdf5::DatasetValue,
+                                                       chunk_size);
       hid_t wapl = H5P_DEFAULT;
 #ifdef HDF5_IS_PARALLEL
       if (collective)
@@ -410,7 +405,6 @@ namespace neuroh5
 	}
 #endif
       
-      hsize_t chunk = chunk_size;
       hsize_t maxdims[1] = {H5S_UNLIMITED};
       hsize_t zerodims[1] = {0};
     
@@ -425,10 +419,6 @@ namespace neuroh5
           fspace = H5Screate_simple(1, zerodims, maxdims);
           throw_assert_nomsg(fspace >= 0);
 
-	  throw_assert_nomsg(H5Pset_chunk(dcpl, 1, &chunk ) >= 0);
-#ifdef H5_HAS_PARALLEL_DEFLATE
-          throw_assert_nomsg(H5Pset_deflate(dcpl, 9) >= 0);
-#endif
           
           dset = H5Dcreate2 (file, path.c_str(), NODE_IDX_H5_FILE_T,
                              fspace, lcpl, dcpl, H5P_DEFAULT);
@@ -477,6 +467,7 @@ namespace neuroh5
         }
       throw_assert_nomsg(H5Dwrite(dset, NODE_IDX_H5_NATIVE_T, mspace, fspace,
                       wapl, &src_idx[0]) >= 0);
+      mpi::count_write(block * sizeof(src_idx[0]));
 
       throw_assert_nomsg(H5Dclose(dset) >= 0);
       throw_assert_nomsg(H5Sclose(mspace) >= 0);
@@ -503,7 +494,36 @@ namespace neuroh5
      const std::map <std::string, std::pair <size_t, data::AttrIndex > >& edge_attr_index,
      const hsize_t             chunk_size,
      const hsize_t             block_size,
-     const bool collective
+     const bool collective,
+     const hdf5::DatasetCreationPolicy& dataset_policy
+     )
+    {
+      data::EdgeCSR prj_edges;
+      prj_edges.from_edge_map(prj_edge_map);
+      append_projection(comm, file, src_pop_name, dst_pop_name,
+                        src_start, src_end, dst_start, dst_end,
+                        num_edges, prj_edges, edge_attr_index,
+                        chunk_size, block_size, collective, dataset_policy);
+    }
+
+
+    void append_projection
+    (
+     MPI_Comm                  comm,
+     hid_t                     file,
+     const string&             src_pop_name,
+     const string&             dst_pop_name,
+     const NODE_IDX_T&         src_start,
+     const NODE_IDX_T&         src_end,
+     const NODE_IDX_T&         dst_start,
+     const NODE_IDX_T&         dst_end,
+     const size_t&             num_edges,
+     const data::EdgeCSR&      prj_edges,
+     const std::map <std::string, std::pair <size_t, data::AttrIndex > >& edge_attr_index,
+     const hsize_t             chunk_size,
+     const hsize_t             block_size,
+     const bool collective,
+     const hdf5::DatasetCreationPolicy& dataset_policy
      )
     {
       MPI_Request request;
@@ -520,26 +540,25 @@ namespace neuroh5
       rank = (size_t)srank;
 
         
-      size_t num_dest = prj_edge_map.size();
+      size_t num_dest = prj_edges.num_nodes();
       size_t num_blocks = num_dest > 0 ? 1 : 0;
 
-      // create relative destination pointers and source index
+      // create relative destination pointers; the source index is the
+      // adjacency array of the rows
       vector<DST_BLK_PTR_T> dst_blk_ptr; 
       vector<DST_PTR_T> dst_ptr;
-      vector<NODE_IDX_T> dst_blk_idx, src_idx;
-      NODE_IDX_T first_idx = 0, last_idx = 0;
-      hsize_t num_block_edges = 0, num_prj_edges = 0;
-      if (!prj_edge_map.empty())
-        {
-          first_idx = (prj_edge_map.begin())->first;
-          last_idx  = first_idx;
-          dst_blk_idx.push_back(first_idx - dst_start);
+      vector<NODE_IDX_T> dst_blk_idx;
+      const vector<NODE_IDX_T>& src_idx = prj_edges.adj;
+      NODE_IDX_T last_idx = 0;
+      hsize_t num_block_edges = 0, num_prj_edges = prj_edges.num_edges();
+      if (num_dest > 0)
+        {
+          last_idx = prj_edges.keys[0];
+          dst_blk_idx.push_back(last_idx - dst_start);
           dst_blk_ptr.push_back(0);
-          for (auto iter = prj_edge_map.begin(); iter != prj_edge_map.end(); ++iter)
+          for (size_t i = 0; i < num_dest; i++)
             {
-              NODE_IDX_T dst = iter->first;
-              edge_tuple_t et = iter->second;
-              vector<NODE_IDX_T> &v = get<0>(et);
+              NODE_IDX_T dst = prj_edges.keys[i];
               
               // creates new block if non-contiguous dst indices
               if (((dst > 0) && ((dst-1) > last_idx)) || (num_block_edges > block_size))
@@ -551,10 +570,8 @@ namespace neuroh5
                 }
               last_idx = dst;
               
-              copy(v.begin(), v.end(), back_inserter(src_idx));
-              dst_ptr.push_back(num_prj_edges);
-              num_prj_edges += v.size();
-              num_block_edges += v.size();
+              dst_ptr.push_back(prj_edges.row_begin(i));
+              num_block_edges += prj_edges.row_size(i);
             }
         }
       throw_assert_nomsg(num_edges == src_idx.size());
@@ -712,7 +729,7 @@ namespace neuroh5
          src_pop_name, dst_pop_name,
          src_start, src_end, dst_start, dst_end,
          num_blocks, total_num_blocks, dst_blk_idx_size,
-         chunk_size, block_size, collective,
+         chunk_size, block_size, collective, dataset_policy,
          recvbuf_num_blocks,
          dst_blk_idx
          );
@@ -728,7 +745,7 @@ namespace neuroh5
          src_pop_name, dst_pop_name,
          src_start, src_end, dst_start, dst_end,
          num_blocks, total_num_blocks, dst_blk_ptr_size,
-         chunk_size, block_size, collective,
+         chunk_size, block_size, collective, dataset_policy,
          recvbuf_num_blocks,
          dst_blk_ptr
          );
@@ -744,7 +761,7 @@ namespace neuroh5
          dst_start, dst_end,
          total_num_dests, dst_ptr_size,
          chunk_size, block_size, 
-         collective,
+         collective, dataset_policy,
          recvbuf_num_dest,
          dst_ptr
          );
@@ -760,7 +777,7 @@ namespace neuroh5
          dst_start, dst_end,
          total_num_edges, src_idx_size,
          chunk_size, block_size, 
-         collective,
+         collective, dataset_policy,
          recvbuf_num_edge,
          src_idx
          );
@@ -786,36 +803,34 @@ namespace neuroh5
           edge_attr_name_spaces.push_back(attr_namespace);
         }
         
-      for (auto const& iter : prj_edge_map)
-	{
-	  const edge_tuple_t& et = iter.second;
-          //const vector<NODE_IDX_T>& v = get<0>(et);
-          const vector<data::AttrVal>& va = get<1>(et);
-          size_t ni=0;
-          for (auto const& a : va)
-            {
-              const string & attr_namespace = edge_attr_name_spaces[ni];
-              auto & edge_attr = edge_attr_map[attr_namespace];
-              edge_attr.append(a);
-              ni++;
-            }
-	}
+      for (size_t ni = 0; ni < prj_edges.attrs.size(); ni++)
+        {
+          throw_assert_nomsg(ni < edge_attr_name_spaces.size());
+          edge_attr_map[edge_attr_name_spaces[ni]].append(prj_edges.attrs[ni]);
+        }
       throw_assert_nomsg(MPI_Barrier(comm) == MPI_SUCCESS);
 
       append_edge_attribute_map<float>(comm, file, src_pop_name, dst_pop_name,
-                                       edge_attr_map, edge_attr_index, chunk_size);
+                                       edge_attr_map, edge_attr_index, chunk_size,
+                                       dataset_policy);
       append_edge_attribute_map<uint8_t>(comm, file, src_pop_name, dst_pop_name,
-                                         edge_attr_map, edge_attr_index, chunk_size);
+                                         edge_attr_map, edge_attr_index, chunk_size,
+                                         dataset_policy);
       append_edge_attribute_map<uint16_t>(comm, file, src_pop_name, dst_pop_name,
-                                          edge_attr_map, edge_attr_index, chunk_size);
+                                          edge_attr_map, edge_attr_index, chunk_size,
+                                          dataset_policy);
       append_edge_attribute_map<uint32_t>(comm, file, src_pop_name, dst_pop_name,
-                                          edge_attr_map, edge_attr_index, chunk_size);
+                                          edge_attr_map, edge_attr_index, chunk_size,
+                                          dataset_policy);
       append_edge_attribute_map<int8_t>(comm, file, src_pop_name, dst_pop_name,
-                                        edge_attr_map, edge_attr_index, chunk_size);
+                                        edge_attr_map, edge_attr_index, chunk_size,
+                                        dataset_policy);
       append_edge_attribute_map<int16_t>(comm, file, src_pop_name, dst_pop_name,
-                                         edge_attr_map, edge_attr_index, chunk_size);
+                                         edge_attr_map, edge_attr_index, chunk_size,
+                                         dataset_policy);
       append_edge_attribute_map<int32_t>(comm, file, src_pop_name, dst_pop_name,
-                                         edge_attr_map, edge_attr_index, chunk_size);
+                                         edge_attr_map, edge_attr_index, chunk_size,
+                                         dataset_policy);
         
       // clean-up
       throw_assert_nomsg(MPI_Barrier(comm) == MPI_SUCCESS);
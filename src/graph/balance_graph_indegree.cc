@@ -4,19 +4,15 @@
 ///
 ///  Partition graph vertices according to their degree.
 ///
-///  Copyright (C) 2016-2021 Project NeuroH5.
+///  Copyright (C) 2016-2025 Project NeuroH5.
 //==============================================================================
 
 
 #include "debug.hh"
 
 #include "neuroh5_types.hh"
-#include "read_projection.hh"
 #include "cell_populations.hh"
-#include "scatter_read_graph.hh"
-#include "merge_edge_map.hh"
-#include "vertex_degree.hh"
-#include "validate_edge_list.hh"
+#include "projection_degree.hh"
 #include "throw_assert.hh"
 
 #include <getopt.h>
@@ -58,28 +54,6 @@ namespace neuroh5
       MPI_Abort(MPI_COMM_WORLD, 1);
     }
 
-    // Assign each node to a rank 
-    static void compute_node_rank_map
-    (
-     size_t num_ranks,
-     size_t num_nodes,
-     node_rank_map_t &node_rank_map
-     )
-    {
-      hsize_t remainder=0, offset=0, buckets=0;
-    
-      for (size_t i=0; i<num_ranks; i++)
-        {
-          remainder  = num_nodes - offset;
-          buckets    = num_ranks - i;
-          for (size_t j = 0; j < remainder / buckets; j++)
-            {
-              node_rank_map[offset+j].insert(i);
-            }
-          offset    += remainder / buckets;
-        }
-    }
-
     void compute_part_nums
     (
      const size_t&     num_blocks,
@@ -123,55 +97,28 @@ namespace neuroh5
 
     
       // Read population info to determine total_num_nodes
-      size_t local_num_nodes, total_num_nodes, local_num_edges, total_num_edges;
-
-      vector <string> edge_attr_name_spaces;
+      size_t total_num_nodes;
       pop_range_map_t pop_ranges;
       throw_assert_nomsg(cell::read_population_ranges(comm, input_file_name, pop_ranges, total_num_nodes) >= 0);
 
-      // A vector that maps nodes to compute ranks
-      node_rank_map_t node_rank_map;
-      compute_node_rank_map(size, total_num_nodes, node_rank_map);
-    
-      // read the edges
-      vector < edge_map_t > prj_vector;
-      vector < map <string, vector <vector<string> > > > edge_attr_name_vector;
-      scatter_read_graph (comm,
-                          EdgeMapDst,
-                          input_file_name,
-                          io_size,
-                          edge_attr_name_spaces,
-                          prj_names,
-                          node_rank_map,
-                          prj_vector,
-                          edge_attr_name_vector,
-                          local_num_nodes,
-                          total_num_nodes,
-                          local_num_edges,
-                          total_num_edges);
-      
-      vector < std::map<NODE_IDX_T, size_t> > vertex_indegree_maps;
-      vertex_degree (prj_vector, false, vertex_indegree_maps);
-
+      // in-degrees computed from the projection pointers; each rank
+      // adds the normalized in-degrees of its nodes, and the sum gives
+      // every rank the in-degrees of all nodes
       std::vector<double> vertex_norm_indegrees(total_num_nodes, 0.0);
-
-      for (const map< NODE_IDX_T, size_t >& vertex_indegree_map : vertex_indegree_maps)
+      for (const pair<string, string>& prj_name : prj_names)
         {
-          uint64_t sum_indegree=0, nz_indegree=0;
-          
-          for (auto it = vertex_indegree_map.begin(); it != vertex_indegree_map.end(); it++)
-            {
-              size_t degree = it->second;
-              sum_indegree = sum_indegree + degree;
-              if (degree > 0) nz_indegree++;
-            }
-          for (auto it = vertex_indegree_map.begin(); it != vertex_indegree_map.end(); it++)
+          ProjectionDegree prj_degree;
+          read_projection_degree(comm, input_file_name, prj_name.first, prj_name.second,
+                                 EdgeMapDst, prj_degree);
+          for (size_t i = 0; i < prj_degree.node_id.size(); i++)
             {
-              double norm_indegree = (double)it->second / (double)sum_indegree;
-              vertex_norm_indegrees[it->first] += norm_indegree;
+              double norm_indegree = (double)prj_degree.degree[i] / (double)prj_degree.total_degree;
+              vertex_norm_indegrees[prj_degree.node_id[i]] += norm_indegree;
             }
-          
         }
+      throw_assert(MPI_Allreduce(MPI_IN_PLACE, vertex_norm_indegrees.data(), total_num_nodes,
+                                 MPI_DOUBLE, MPI_SUM, comm) == MPI_SUCCESS,
+                   "balance_graph_indegree: error in MPI_Allreduce");
 
 
       vector<NODE_IDX_T> node_idx_vector(total_num_nodes, 0);
@@ -5,7 +5,7 @@
 ///  Top-level functions for reading graphs in DBS (Destination Block Sparse)
 ///  format.
 ///
-///  Copyright (C) 2016-2021 Project NeuroH5.
+///  Copyright (C) 2016-2025 Project NeuroH5.
 //==============================================================================
 
 
@@ -14,9 +14,10 @@
 #include "edge_attributes.hh"
 #include "cell_populations.hh"
 #include "validate_edge_list.hh"
-#include "append_edge_map.hh"
+#include "append_edge_csr.hh"
 #include "serialize_edge.hh"
 #include "serialize_data.hh"
+#include "shared_edge_csr.hh"
 #include "throw_assert.hh"
 #include "debug.hh"
 
@@ -41,6 +42,91 @@ namespace neuroh5
      * Load and broadcast edge data structures 
      *****************************************************************************/
 
+    // Reads the edges of a projection on the I/O rank
+    static void read_projection_edge_csr (MPI_Comm io_comm,
+                                          const EdgeMapType edge_map_type,
+                                          const string& file_name,
+                                          const string& src_pop_name, 
+                                          const string& dst_pop_name, 
+                                          const NODE_IDX_T src_start,
+                                          const NODE_IDX_T dst_start, 
+                                          const vector< string >& attr_namespaces,
+                                          const pop_search_range_map_t& pop_search_ranges,
+                                          const set< pair<pop_t, pop_t> >& pop_pairs,
+                                          data::EdgeCSR& prj_edge_csr,
+                                          map <string, vector < vector <string> > >& edge_attr_names)
+    {
+      DST_BLK_PTR_T block_base;
+      DST_PTR_T edge_base, edge_count;
+      vector<DST_BLK_PTR_T> dst_blk_ptr;
+      vector<NODE_IDX_T> dst_idx;
+      vector<DST_PTR_T> dst_ptr;
+      vector<NODE_IDX_T> src_idx;
+      map <string, data::NamedAttrVal> edge_attr_map;
+      size_t num_edges = 0, total_prj_num_edges = 0;
+      hsize_t local_read_blocks;
+      hsize_t total_read_blocks;
+
+      throw_assert_nomsg(hdf5::read_projection_datasets(io_comm, file_name, src_pop_name, dst_pop_name,
+                                                        block_base, edge_base,
+                                                        dst_blk_ptr, dst_idx, dst_ptr, src_idx,
+                                                        total_prj_num_edges,
+                                                        total_read_blocks, local_read_blocks) >= 0);
+          
+      // validate the edges
+      throw_assert_nomsg(validate_edge_list(dst_start, src_start, dst_blk_ptr, dst_idx, dst_ptr, src_idx,
+                                            pop_search_ranges, pop_pairs) == true);
+          
+          
+      edge_count = src_idx.size();
+
+      for (string attr_namespace : attr_namespaces) 
+        {
+          vector< pair<string,AttrKind> > edge_attr_info;
+          throw_assert_nomsg(graph::get_edge_attributes(io_comm, file_name, src_pop_name, dst_pop_name,
+                                                        attr_namespace, edge_attr_info) >= 0);
+          throw_assert_nomsg(graph::read_all_edge_attributes(io_comm, file_name,
+                                                             src_pop_name, dst_pop_name, attr_namespace,
+                                                             edge_base, edge_count, edge_attr_info,
+                                                             edge_attr_map[attr_namespace]) >= 0);
+          edge_attr_map[attr_namespace].attr_names(edge_attr_names[attr_namespace]);
+        }
+
+      // append to the edge map
+          
+      throw_assert_nomsg(data::append_edge_csr(dst_start, src_start, dst_blk_ptr, dst_idx, dst_ptr, src_idx,
+                                               attr_namespaces, edge_attr_map, num_edges, prj_edge_csr, edge_map_type) >= 0);
+          
+      // ensure that all edges in the projection have been read and appended to edge_list
+      throw_assert_nomsg(num_edges == src_idx.size());
+    }
+
+    
+    // Broadcasts the names of the edge attributes from rank 0
+    static void bcast_edge_attr_names (MPI_Comm all_comm,
+                                       map <string, vector < vector <string> > >& edge_attr_names)
+    {
+      int rank;
+      throw_assert_nomsg(MPI_Comm_rank(all_comm, &rank) == MPI_SUCCESS);
+
+      vector<char> names_sendbuf; uint32_t names_sendbuf_size=0;
+      if (rank == 0)
+        {
+          data::serialize_data(edge_attr_names, names_sendbuf);
+          names_sendbuf_size = names_sendbuf.size();
+        }
+
+      throw_assert_nomsg(MPI_Bcast(&names_sendbuf_size, 1, MPI_UINT32_T, 0, all_comm) == MPI_SUCCESS);
+      names_sendbuf.resize(names_sendbuf_size);
+      throw_assert_nomsg(MPI_Bcast(&names_sendbuf[0], names_sendbuf_size, MPI_CHAR, 0, all_comm) == MPI_SUCCESS);
+        
+      if (rank != 0)
+        {
+          data::deserialize_data(names_sendbuf, edge_attr_names);
+        }
+    }
+
+    
     int bcast_projection (MPI_Comm all_comm, MPI_Comm io_comm,
                           const EdgeMapType edge_map_type,
                           const string& file_name,
@@ -51,7 +137,7 @@ namespace neuroh5
                           const vector< string >& attr_namespaces,
                           const pop_search_range_map_t& pop_search_ranges,
                           const set< pair<pop_t, pop_t> >& pop_pairs,
-                          vector < edge_map_t >& prj_vector,
+                          vector < data::EdgeCSR >& prj_vector,
                           vector < map <string, vector < vector<string> > > > & edge_attr_names_vector)
                           
     {
@@ -61,84 +147,25 @@ namespace neuroh5
       throw_assert_nomsg(MPI_Comm_rank(all_comm, &rank) == MPI_SUCCESS);
 
       vector<char> sendbuf; 
-      vector<NODE_IDX_T> send_edges, recv_edges, total_recv_edges;
-      edge_map_t prj_edge_map;
+      data::EdgeCSR prj_edge_csr(edge_map_type);
       map <string, vector < vector <string> > > edge_attr_names;
-      size_t num_edges = 0, total_prj_num_edges = 0;
-      hsize_t local_read_blocks;
-      hsize_t total_read_blocks;
 
       if (rank == 0)
         {
-          DST_BLK_PTR_T block_base;
-          DST_PTR_T edge_base, edge_count;
-          vector<DST_BLK_PTR_T> dst_blk_ptr;
-          vector<NODE_IDX_T> dst_idx;
-          vector<DST_PTR_T> dst_ptr;
-          vector<NODE_IDX_T> src_idx;
-          vector< pair<string,hid_t> > edge_attr_info;
-          map <string, data::NamedAttrVal> edge_attr_map;
-          
-
-          throw_assert_nomsg(hdf5::read_projection_datasets(io_comm, file_name, src_pop_name, dst_pop_name,
-                                                            block_base, edge_base,
-                                                            dst_blk_ptr, dst_idx, dst_ptr, src_idx,
-                                                            total_prj_num_edges,
-                                                            total_read_blocks, local_read_blocks) >= 0);
-          
-          // validate the edges
-          throw_assert_nomsg(validate_edge_list(dst_start, src_start, dst_blk_ptr, dst_idx, dst_ptr, src_idx,
-                                                pop_search_ranges, pop_pairs) == true);
-          
-          
-          edge_count = src_idx.size();
-
-          for (string attr_namespace : attr_namespaces) 
-            {
-              vector< pair<string,AttrKind> > edge_attr_info;
-              throw_assert_nomsg(graph::get_edge_attributes(io_comm, file_name, src_pop_name, dst_pop_name,
-                                                attr_namespace, edge_attr_info) >= 0);
-              throw_assert_nomsg(graph::read_all_edge_attributes(io_comm, file_name,
-                                                     src_pop_name, dst_pop_name, attr_namespace,
-                                                     edge_base, edge_count, edge_attr_info,
-                                                     edge_attr_map[attr_namespace]) >= 0);
-              edge_attr_map[attr_namespace].attr_names(edge_attr_names[attr_namespace]);
-            }
-
-          // append to the edge map
-          
-          throw_assert_nomsg(data::append_edge_map(dst_start, src_start, dst_blk_ptr, dst_idx, dst_ptr, src_idx,
-                                       attr_namespaces, edge_attr_map, num_edges, prj_edge_map, edge_map_type) >= 0);
-          
-          // ensure that all edges in the projection have been read and appended to edge_list
-          throw_assert_nomsg(num_edges == src_idx.size());
+          read_projection_edge_csr(io_comm, edge_map_type, file_name, src_pop_name, dst_pop_name,
+                                   src_start, dst_start, attr_namespaces, pop_search_ranges, pop_pairs,
+                                   prj_edge_csr, edge_attr_names);
           
           size_t num_packed_edges = 0; 
-          data::serialize_edge_map (prj_edge_map, num_packed_edges, sendbuf);
+          data::serialize_edge_csr (prj_edge_csr, num_packed_edges, sendbuf);
 
           // ensure the correct number of edges is being packed
-          throw_assert_nomsg(num_packed_edges == num_edges);
+          throw_assert_nomsg(num_packed_edges == prj_edge_csr.num_edges());
 
         } // rank == 0
     
       // 0. Broadcast the number of attributes of each type to all ranks
-      {
-        vector<char> names_sendbuf; uint32_t names_sendbuf_size=0;
-        if (rank == 0)
-          {
-            data::serialize_data(edge_attr_names, names_sendbuf);
-            names_sendbuf_size = sendbuf.size();
-          }
-
-        throw_assert_nomsg(MPI_Bcast(&names_sendbuf_size, 1, MPI_UINT32_T, 0, all_comm) == MPI_SUCCESS);
-        names_sendbuf.resize(names_sendbuf_size);
-        throw_assert_nomsg(MPI_Bcast(&names_sendbuf[0], names_sendbuf_size, MPI_CHAR, 0, all_comm) == MPI_SUCCESS);
-        
-        if (rank != 0)
-          {
-            data::deserialize_data(names_sendbuf, edge_attr_names);
-          }
-      }
+      bcast_edge_attr_names(all_comm, edge_attr_names);
       
       uint32_t sendbuf_size = sendbuf.size();
       throw_assert_nomsg(MPI_Bcast(&sendbuf_size, 1, MPI_UINT32_T, 0, all_comm) == MPI_SUCCESS);
@@ -148,12 +175,12 @@ namespace neuroh5
       size_t num_unpacked_edges = 0, num_unpacked_nodes = 0; 
       if (rank > 0)
         {
-          data::deserialize_edge_map (sendbuf, prj_edge_map,
+          data::deserialize_edge_csr (sendbuf, prj_edge_csr,
                                       num_unpacked_nodes, num_unpacked_edges);
       
         }
       
-      prj_vector.push_back(prj_edge_map);
+      prj_vector.push_back(std::move(prj_edge_csr));
       edge_attr_names_vector.push_back(edge_attr_names);
 #ifdef NEUROH5_DEBUG
       throw_assert_nomsg(MPI_Barrier(all_comm) == MPI_SUCCESS);
@@ -163,18 +190,66 @@ namespace neuroh5
     }
 
 
-    int bcast_graph
+    int bcast_projection_shared (MPI_Comm all_comm, MPI_Comm io_comm,
+                                 const EdgeMapType edge_map_type,
+                                 const string& file_name,
+                                 const string& src_pop_name, 
+                                 const string& dst_pop_name, 
+                                 const NODE_IDX_T src_start,
+                                 const NODE_IDX_T dst_start, 
+                                 const vector< string >& attr_namespaces,
+                                 const pop_search_range_map_t& pop_search_ranges,
+                                 const set< pair<pop_t, pop_t> >& pop_pairs,
+                                 vector < data::SharedEdgeCSR >& prj_vector,
+                                 vector < map <string, vector < vector<string> > > > & edge_attr_names_vector)
+    {
+      int rank;
+      throw_assert_nomsg(MPI_Comm_rank(all_comm, &rank) == MPI_SUCCESS);
+
+      data::EdgeCSR prj_edge_csr(edge_map_type);
+      map <string, vector < vector <string> > > edge_attr_names;
+
+      if (rank == 0)
+        {
+          read_projection_edge_csr(io_comm, edge_map_type, file_name, src_pop_name, dst_pop_name,
+                                   src_start, dst_start, attr_namespaces, pop_search_ranges, pop_pairs,
+                                   prj_edge_csr, edge_attr_names);
+        }
+
+      bcast_edge_attr_names(all_comm, edge_attr_names);
+
+      // the columns are copied once to each node, and the private copy
+      // on rank 0 is released
+      prj_vector.emplace_back();
+      data::bcast_shared_edge_csr(all_comm, 0, prj_edge_csr, prj_vector.back());
+      prj_edge_csr.clear();
+
+      edge_attr_names_vector.push_back(edge_attr_names);
+#ifdef NEUROH5_DEBUG
+      throw_assert_nomsg(MPI_Barrier(all_comm) == MPI_SUCCESS);
+#endif
+
+      return 0;
+    }
+
+    // Reads the population info on rank 0 and broadcasts each projection
+    // with bcast_prj
+    template <class ProjectionT>
+    static int bcast_graph_projections
     (
      MPI_Comm                      all_comm,
      const EdgeMapType             edge_map_type,
      const std::string&            file_name,
      const vector< string >&       attr_namespaces,
      const vector< pair<string,string> >& prj_names,
-     vector < edge_map_t >& prj_vector,
+     vector < ProjectionT >& prj_vector,
      vector < map <string, vector < vector <string> > > >& edge_attr_names_vector,
      size_t                       &total_num_nodes,
-     size_t                       &local_num_edges,
-     size_t                       &total_num_edges
+     int (*bcast_prj) (MPI_Comm, MPI_Comm, const EdgeMapType, const string&,
+                       const string&, const string&, const NODE_IDX_T, const NODE_IDX_T,
+                       const vector< string >&, const pop_search_range_map_t&,
+                       const set< pair<pop_t, pop_t> >&, vector < ProjectionT >&,
+                       vector < map <string, vector < vector<string> > > >&)
      )
     {
       int ierr = 0;
@@ -260,11 +335,11 @@ namespace neuroh5
           throw_assert_nomsg(MPI_Bcast(&src_start, 1, MPI_NODE_IDX_T, 0, all_comm) == MPI_SUCCESS);
           throw_assert_nomsg(MPI_Bcast(&dst_start, 1, MPI_NODE_IDX_T, 0, all_comm) == MPI_SUCCESS);
 
-          bcast_projection(all_comm, io_comm, edge_map_type, file_name,
-                           src_pop_name, dst_pop_name,
-                           src_start, dst_start,
-                           attr_namespaces, pop_search_ranges, pop_pairs, 
-                           prj_vector, edge_attr_names_vector);
+          bcast_prj(all_comm, io_comm, edge_map_type, file_name,
+                    src_pop_name, dst_pop_name,
+                    src_start, dst_start,
+                    attr_namespaces, pop_search_ranges, pop_pairs, 
+                    prj_vector, edge_attr_names_vector);
                              
         }
       throw_assert_nomsg(MPI_Barrier(io_comm) == MPI_SUCCESS);
@@ -272,7 +347,71 @@ namespace neuroh5
 
       return ierr;
     }
+
+
+    int bcast_graph
+    (
+     MPI_Comm                      all_comm,
+     const EdgeMapType             edge_map_type,
+     const std::string&            file_name,
+     const vector< string >&       attr_namespaces,
+     const vector< pair<string,string> >& prj_names,
+     vector < data::EdgeCSR >& prj_vector,
+     vector < map <string, vector < vector <string> > > >& edge_attr_names_vector,
+     size_t                       &total_num_nodes,
+     size_t                       &local_num_edges,
+     size_t                       &total_num_edges
+     )
+    {
+      return bcast_graph_projections(all_comm, edge_map_type, file_name, attr_namespaces, prj_names,
+                                     prj_vector, edge_attr_names_vector, total_num_nodes,
+                                     bcast_projection);
+    }
+
+
+    int bcast_graph_shared
+    (
+     MPI_Comm                      all_comm,
+     const EdgeMapType             edge_map_type,
+     const std::string&            file_name,
+     const vector< string >&       attr_namespaces,
+     const vector< pair<string,string> >& prj_names,
+     vector < data::SharedEdgeCSR >& prj_vector,
+     vector < map <string, vector < vector <string> > > >& edge_attr_names_vector,
+     size_t                       &total_num_nodes
+     )
+    {
+      return bcast_graph_projections(all_comm, edge_map_type, file_name, attr_namespaces, prj_names,
+                                     prj_vector, edge_attr_names_vector, total_num_nodes,
+                                     bcast_projection_shared);
+    }
+
+
+    int bcast_graph
+    (
+     MPI_Comm                      all_comm,
+     const EdgeMapType             edge_map_type,
+     const std::string&            file_name,
+     const vector< string >&       attr_namespaces,
+     const vector< pair<string,string> >& prj_names,
+     vector < edge_map_t >& prj_vector,
+     vector < map <string, vector < vector <string> > > >& edge_attr_names_vector,
+     size_t                       &total_num_nodes,
+     size_t                       &local_num_edges,
+     size_t                       &total_num_edges
+     )
+    {
+      vector < data::EdgeCSR > prj_csr_vector;
+      int ierr = bcast_graph(all_comm, edge_map_type, file_name, attr_namespaces, prj_names,
+                             prj_csr_vector, edge_attr_names_vector,
+                             total_num_nodes, local_num_edges, total_num_edges);
+      for (const data::EdgeCSR& prj_edge_csr : prj_csr_vector)
+        {
+          prj_vector.emplace_back();
+          prj_edge_csr.to_edge_map(prj_vector.back());
+        }
+      return ierr;
+    }
     
   }
 }
-
@@ -4,18 +4,14 @@
 ///
 ///  Computes vertex metrics in the graph,
 ///
-///  Copyright (C) 2016-2021 Project NeuroH5.
+///  Copyright (C) 2016-2025 Project NeuroH5.
 //==============================================================================
 
 
 #include "debug.hh"
 
 #include "neuroh5_types.hh"
-#include "read_projection.hh"
-#include "cell_populations.hh"
-#include "scatter_read_graph.hh"
-#include "vertex_degree.hh"
-#include "validate_edge_list.hh"
+#include "projection_degree.hh"
 #include "node_attributes.hh"
 #include "throw_assert.hh"
 
@@ -40,159 +36,75 @@ namespace neuroh5
 {
   namespace graph
   {
-    // Assign each node to a rank 
-    static void compute_node_rank_map
-    (
-     size_t num_ranks,
-     size_t num_nodes,
-     node_rank_map_t &node_rank_map
-     )
+
+    static void append_vertex_degree (MPI_Comm comm,
+                                      const pair<string, string>& prj_name,
+                                      const vector<NODE_IDX_T>& node_id,
+                                      const vector<size_t>& degree,
+                                      const uint64_t total_degree,
+                                      const string& label, const string& norm_label,
+                                      const string& output_file_name)
     {
-      // round-robin node to rank assignment from file
-      for (size_t i = 0; i < num_nodes; i++)
+      vector <ATTR_PTR_T> attr_ptr(node_id.size() + 1, 0);
+      vector <float> norm_degree(node_id.size(), 0.0);
+      for (size_t i = 0; i < node_id.size(); i++)
         {
-            node_rank_map[i].insert(i%num_ranks);
+          attr_ptr[i+1] = attr_ptr[i] + 1;
+          norm_degree[i] = (total_degree > 0) ? ((float)degree[i] / (float)total_degree) : 0.0;
         }
+
+      const string& src_pop_name = prj_name.first;
+      const string& dst_pop_name = prj_name.second;
+      graph::append_node_attribute (comm, output_file_name, "Vertex Metrics",
+                                    label + " " + src_pop_name + " -> " + dst_pop_name,
+                                    node_id, attr_ptr, degree);
+      graph::append_node_attribute (comm, output_file_name, "Vertex Metrics",
+                                    norm_label + " " + src_pop_name + " -> " + dst_pop_name,
+                                    node_id, attr_ptr, norm_degree);
     }
 
 
-    void append_vertex_degree_map (MPI_Comm comm, const node_rank_map_t& node_rank_map,
-                                   const std::vector< std::pair<std::string, std::string> >& prj_names,
-                                   size_t total_num_nodes,
-                                   const std::vector < map< NODE_IDX_T, size_t> > & vertex_degree_maps,
-                                   const string& label, const string& norm_label,
-                                   const string& output_file_name)
+    static int compute_vertex_degree
+    (
+     MPI_Comm comm,
+     const std::string& file_name,
+     const std::vector< std::pair<std::string, std::string> > prj_names,
+     const EdgeMapType edge_map_type
+     )
     {
-      int srank, ssize;
-      throw_assert_nomsg(MPI_Comm_size(comm, &ssize) == MPI_SUCCESS);
-      throw_assert_nomsg(MPI_Comm_rank(comm, &srank) == MPI_SUCCESS);
-
-      size_t rank, size;
-      rank = (size_t)srank;
-      size = (size_t)ssize;
+      int status=0;
 
-      size_t prj_index=0;
-      for (const map< NODE_IDX_T, size_t>& vertex_degree_map : vertex_degree_maps)
+      const bool indegree = (edge_map_type == EdgeMapDst);
+      for (const pair<string, string>& prj_name : prj_names)
         {
-          uint64_t sum_degree=0, nz_degree=0;
-          
-          for (auto it = vertex_degree_map.begin(); it != vertex_degree_map.end(); it++)
-            {
-              size_t degree = it->second;
-              sum_degree = sum_degree + degree;
-              if (degree > 0) nz_degree++;
-            }
-          
-          std::vector<float> vertex_norm_degrees;
-          vertex_norm_degrees.resize(total_num_nodes);
-          for (auto it = vertex_degree_map.begin(); it != vertex_degree_map.end(); it++)
-            {
-              float norm_degree = (float)(it->second) / (float)sum_degree;
-              vertex_norm_degrees[it->first] += norm_degree;
-            }
-          
-          vector <NODE_IDX_T> node_id;
-          vector <ATTR_PTR_T> attr_ptr;
-          vector <size_t> vertex_degree_value;
-          vector <float> vertex_norm_degree_value;
-          
-          attr_ptr.push_back(0);
-          for (auto it=node_rank_map.begin(); it != node_rank_map.end(); it++)
-            {
-              if (it->second.count(rank) > 0)
-                {
-                  const auto it_degree_value = vertex_degree_map.find(it->first);
-                  if (it_degree_value != vertex_degree_map.cend())
-                    {
-                      node_id.push_back(it->first);
-                      attr_ptr.push_back(attr_ptr.back() + 1);
-                      vertex_degree_value.push_back(it_degree_value->second);
-                      vertex_norm_degree_value.push_back(vertex_norm_degrees[it->first]);
-                    }
-                }
-            }
-
-          string src_pop_name = prj_names[prj_index].first;
-          string dst_pop_name = prj_names[prj_index].second;
-          
-          graph::append_node_attribute (comm, output_file_name, "Vertex Metrics",
-                                        label + " " + src_pop_name + " -> " + dst_pop_name,
-                                        node_id, attr_ptr, vertex_degree_value);
-          graph::append_node_attribute (comm, output_file_name, "Vertex Metrics",
-                                        norm_label + " " + src_pop_name + " -> " + dst_pop_name,
-                                        node_id, attr_ptr, vertex_norm_degree_value);
-
-          prj_index++;
+          ProjectionDegree prj_degree;
+          read_projection_degree(comm, file_name, prj_name.first, prj_name.second,
+                                 edge_map_type, prj_degree);
+
+          append_vertex_degree (comm, prj_name, prj_degree.node_id,
+                                prj_degree.degree, prj_degree.total_degree,
+                                indegree ? "Indegree" : "Outdegree",
+                                indegree ? "Norm indegree" : "Norm outdegree",
+                                file_name);
+          append_vertex_degree (comm, prj_name, prj_degree.node_id,
+                                prj_degree.unique_degree, prj_degree.total_unique_degree,
+                                indegree ? "Unique indegree" : "Unique outdegree",
+                                indegree ? "Norm unique indegree" : "Norm unique outdegree",
+                                file_name);
         }
+
+      return status;
     }
-    
+
     
     int compute_vertex_indegree
     (
      MPI_Comm comm,
      const std::string& file_name,
-     const std::vector< std::pair<std::string, std::string> > prj_names,
-     const size_t io_size
+     const std::vector< std::pair<std::string, std::string> > prj_names
      )
     {
-      int status=0;
-    
-      int srank, ssize;
-      throw_assert_nomsg(MPI_Comm_size(comm, &ssize) == MPI_SUCCESS);
-      throw_assert_nomsg(MPI_Comm_rank(comm, &srank) == MPI_SUCCESS);
-
-      size_t rank, size;
-      rank = (size_t)srank;
-      size = (size_t)ssize;
-    
-      // Read population info to determine total_num_nodes
-      size_t local_num_nodes, total_num_nodes, local_num_edges, total_num_edges;
-
-      vector<string> edge_attr_name_spaces;
-      pop_range_map_t pop_ranges;
-      throw_assert_nomsg(cell::read_population_ranges(comm, file_name, pop_ranges, total_num_nodes) >= 0);
-
-      // A vector that maps nodes to compute ranks
-      node_rank_map_t node_rank_map;
-      compute_node_rank_map(size, total_num_nodes, node_rank_map);
-    
-      // read the edges
-      vector < map <string, vector <vector<string> > > > edge_attr_name_vector;
-      vector < edge_map_t > prj_vector;
-      scatter_read_graph (comm,
-                          EdgeMapDst,
-                          file_name,
-                          io_size,
-                          edge_attr_name_spaces,
-                          prj_names,
-                          node_rank_map,
-                          prj_vector,
-                          edge_attr_name_vector,
-                          local_num_nodes,
-                          total_num_nodes,
-                          local_num_edges,
-                          total_num_edges);
-
-      {
-        vector < std::map< NODE_IDX_T, size_t> > vertex_indegree_maps; 
-        vertex_degree (prj_vector, false, vertex_indegree_maps);
-        append_vertex_degree_map (comm, node_rank_map, prj_names,
-                                  total_num_nodes, vertex_indegree_maps,
-                                  "Indegree", "Norm indegree",
-                                  file_name);
-      }
-
-      {
-        vector < std::map< NODE_IDX_T, size_t> > vertex_unique_indegree_maps;
-        vertex_degree (prj_vector, true, vertex_unique_indegree_maps);
-        append_vertex_degree_map (comm, node_rank_map, prj_names,
-                                  total_num_nodes, vertex_unique_indegree_maps,
-                                  "Unique indegree", "Norm unique indegree",
-                                  file_name);
-      }
-
-      
-      return status;
+      return compute_vertex_degree(comm, file_name, prj_names, EdgeMapDst);
     }
 
     
@@ -200,68 +112,10 @@ namespace neuroh5
     (
      MPI_Comm comm,
      const std::string& file_name,
-     const std::vector< std::pair<std::string, std::string> > prj_names,
-     const size_t io_size
+     const std::vector< std::pair<std::string, std::string> > prj_names
      )
     {
-      int status=0;
-    
-      int srank, ssize;
-      throw_assert_nomsg(MPI_Comm_size(comm, &ssize) == MPI_SUCCESS);
-      throw_assert_nomsg(MPI_Comm_rank(comm, &srank) == MPI_SUCCESS);
-
-      size_t rank, size;
-      rank = (size_t)srank;
-      size = (size_t)ssize;
-    
-      // Read population info to determine total_num_nodes
-      size_t local_num_nodes, total_num_nodes,
-        local_num_edges, total_num_edges;
-
-      vector<string> edge_attr_name_spaces;
-      pop_range_map_t pop_ranges;
-      throw_assert_nomsg(cell::read_population_ranges(comm, file_name, pop_ranges, total_num_nodes) >= 0);
-
-      // A vector that maps nodes to compute ranks
-      node_rank_map_t node_rank_map;
-      compute_node_rank_map(size, total_num_nodes, node_rank_map);
-    
-      // read the edges
-      vector < map <string, vector <vector<string> > > > edge_attr_name_vector;
-      vector < edge_map_t > prj_vector;
-      scatter_read_graph (comm,
-                          EdgeMapSrc,
-                          file_name,
-                          io_size,
-                          edge_attr_name_spaces,
-                          prj_names,
-                          node_rank_map,
-                          prj_vector,
-                          edge_attr_name_vector,
-                          local_num_nodes,
-                          total_num_nodes,
-                          local_num_edges,
-                          total_num_edges);
-      
-      {
-        vector < std::map< NODE_IDX_T, size_t> > vertex_outdegree_maps; 
-        vertex_degree (prj_vector, false, vertex_outdegree_maps);
-        append_vertex_degree_map (comm, node_rank_map, prj_names,
-                                  total_num_nodes, vertex_outdegree_maps,
-                                  "Outdegree", "Norm outdegree",
-                                  file_name);
-      }
-
-      {
-        vector < std::map< NODE_IDX_T, size_t> > vertex_unique_outdegree_maps;
-        vertex_degree (prj_vector, true, vertex_unique_outdegree_maps);
-        append_vertex_degree_map (comm, node_rank_map, prj_names,
-                                  total_num_nodes, vertex_unique_outdegree_maps,
-                                  "Unique outdegree", "Norm unique outdegree",
-                                  file_name);
-      }
-      
-      return status;
+      return compute_vertex_degree(comm, file_name, prj_names, EdgeMapSrc);
     }
 
 
@@ -12,9 +12,12 @@
 #include "edge_attributes.hh"
 #include "exists_dataset.hh"
 #include "exists_group.hh"
+#include "file_access.hh"
+#include "file_session.hh"
 #include "path_names.hh"
 #include "serialize_data.hh"
 #include "read_template.hh"
+#include "phase_stats.hh"
 #include "mpi_debug.hh"
 #include "throw_assert.hh"
 
@@ -80,21 +83,15 @@ namespace neuroh5
      const string&  attr_namespace,
      const string&  attr_name,
      const hid_t&   ftype,
-     const size_t   chunk_size
+     const size_t   chunk_size,
+     const DatasetCreationPolicy& dataset_policy
      )
     {
       herr_t status;
       hsize_t maxdims[1] = {H5S_UNLIMITED};
-      hsize_t cdims[1]   = {chunk_size}; /* chunking dimensions */		
       hsize_t initial_size = 0;
     
-      hid_t plist  = H5Pcreate (H5P_DATASET_CREATE);
-      status = H5Pset_chunk(plist, 1, cdims);
-      throw_assert_nomsg(status == 0);
-#ifdef H5_HAS_PARALLEL_DEFLATE
-      status = H5Pset_deflate(plist, 9);
-      throw_assert_nomsg(status == 0);
-#endif
+      hid_t plist  = create_dataset_creation_plist(dataset_policy, DatasetValue, chunk_size);
       
       hid_t lcpl = H5Pcreate(H5P_LINK_CREATE);
       throw_assert_nomsg(lcpl >= 0);
@@ -171,9 +168,17 @@ namespace neuroh5
       throw_assert_nomsg(MPI_Comm_rank(comm, &rank) == MPI_SUCCESS);
       uint8_t has_namespace_flag = 0;
 
+      hdf5::FileSession* session = hdf5::FileSession::find(comm, file_name);
+      const string metadata_key = "has_edge_attribute_namespace/" + src_pop_name + "/" +
+        dst_pop_name + "/" + name_space;
+      if ((session != nullptr) && session->find_metadata(metadata_key, has_namespace))
+        {
+          return ierr;
+        }
+
       if (rank == root)
         {
-          hid_t in_file = H5Fopen(file_name.c_str(), H5F_ACC_RDONLY, H5P_DEFAULT);
+          hid_t in_file = hdf5::open_file(comm, file_name);
           throw_assert_nomsg(in_file >= 0);
           
           string path = hdf5::edge_attribute_prefix(src_pop_name, dst_pop_name, name_space);
@@ -187,7 +192,7 @@ namespace neuroh5
             {
               has_namespace_flag = 0;
             }
-          ierr = H5Fclose(in_file);
+          ierr = hdf5::close_file(in_file);
         }
 
       throw_assert_nomsg(MPI_Bcast(&has_namespace_flag, 1, MPI_UINT8_T, root, comm) == MPI_SUCCESS);
@@ -200,6 +205,10 @@ namespace neuroh5
         {
           has_namespace = false;
         }
+      if (session != nullptr)
+        {
+          session->insert_metadata(metadata_key, has_namespace);
+        }
       return ierr;
     }
 
@@ -221,9 +230,17 @@ namespace neuroh5
       throw_assert_nomsg(MPI_Comm_size(comm, &size) == MPI_SUCCESS);
       throw_assert_nomsg(MPI_Comm_rank(comm, &rank) == MPI_SUCCESS);
 
+      hdf5::FileSession* session = hdf5::FileSession::find(comm, file_name);
+      const string metadata_key = "edge_attributes/" + src_pop_name + "/" +
+        dst_pop_name + "/" + name_space;
+      if ((session != nullptr) && session->find_metadata(metadata_key, out_attributes))
+        {
+          return ierr;
+        }
+
       if (rank == root)
         {
-          hid_t in_file = H5Fopen(file_name.c_str(), H5F_ACC_RDONLY, H5P_DEFAULT);
+          hid_t in_file = hdf5::open_file(comm, file_name);
           throw_assert_nomsg(in_file >= 0);
           out_attributes.clear();
           
@@ -242,7 +259,7 @@ namespace neuroh5
                   throw_assert_nomsg(H5Gclose(grp) >= 0);
                 }
             }
-          ierr = H5Fclose(in_file);
+          ierr = hdf5::close_file(in_file);
         }
 
       vector<char> edge_attributes_sendbuf;  size_t edge_attributes_sendbuf_size=0;
@@ -263,6 +280,10 @@ namespace neuroh5
 
       data::deserialize_data(edge_attributes_sendbuf, out_attributes);
 
+      if (session != nullptr)
+        {
+          session->insert_metadata(metadata_key, out_attributes);
+        }
       return ierr;
     }
     
@@ -361,13 +382,9 @@ namespace neuroh5
       herr_t ierr = 0;
       hsize_t block = edge_count, base = edge_base;
 
-      hid_t fapl = H5Pcreate(H5P_FILE_ACCESS);
-      throw_assert_nomsg(fapl >= 0);
-      throw_assert_nomsg(H5Pset_fapl_mpio(fapl, comm, MPI_INFO_NULL) >= 0);
-      
       throw_assert_nomsg(MPI_Barrier(comm) == MPI_SUCCESS);
 
-      file = H5Fopen(file_name.c_str(), H5F_ACC_RDONLY, fapl);
+      file = hdf5::open_file(comm, file_name, true);
       throw_assert_nomsg(file >= 0);
 
       /* Create property list for collective dataset operations. */
@@ -506,14 +523,14 @@ namespace neuroh5
             }
           
           throw_assert_nomsg(ierr >= 0);
+          mpi::count_read(block * attr_size);
           
           throw_assert_nomsg(H5Sclose(fspace) >= 0);
           throw_assert_nomsg(H5Dclose(dset) >= 0);
           throw_assert_nomsg(H5Sclose(mspace) >= 0);
         }
 
-      throw_assert_nomsg(H5Fclose(file) >= 0);
-      throw_assert_nomsg(H5Pclose(fapl) >= 0);
+      throw_assert_nomsg(hdf5::close_file(file) >= 0);
       throw_assert_nomsg(H5Pclose(rapl) >= 0);
 
       return ierr;
@@ -574,11 +591,8 @@ namespace neuroh5
       hid_t file;
       herr_t ierr = 0;
       hsize_t block = 0;
-      hid_t fapl = H5Pcreate(H5P_FILE_ACCESS);
-      throw_assert_nomsg(fapl >= 0);
-      throw_assert_nomsg(H5Pset_fapl_mpio(fapl, comm, MPI_INFO_NULL) >= 0);
 
-      file = H5Fopen(file_name.c_str(), H5F_ACC_RDONLY, fapl);
+      file = hdf5::open_file(comm, file_name, true);
       throw_assert_nomsg(file >= 0);
 
       /* Create property list for collective dataset operations. */
@@ -693,8 +707,7 @@ namespace neuroh5
           
         }
 
-      throw_assert_nomsg(H5Fclose(file) >= 0);
-      throw_assert_nomsg(H5Pclose(fapl) >= 0);
+      throw_assert_nomsg(hdf5::close_file(file) >= 0);
       throw_assert_nomsg(H5Pclose(rapl) >= 0);
 
       return ierr;
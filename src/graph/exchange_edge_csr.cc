@@ -0,0 +1,158 @@
+// -*- mode: c++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+//==============================================================================
+///  @file exchange_edge_csr.cc
+///
+///  Distribution of flat CSR projection edges to the I/O ranks that write
+///  them.
+///
+///  Copyright (C) 2016-2025 Project NeuroH5.
+//==============================================================================
+
+#include <algorithm>
+#include <map>
+#include <numeric>
+#include <vector>
+
+#include "neuroh5_types.hh"
+#include "exchange_edge_csr.hh"
+#include "alltoallv_template.hh"
+#include "serialize_edge.hh"
+#include "node_rank_map.hh"
+#include "phase_stats.hh"
+#include "throw_assert.hh"
+
+using namespace std;
+
+namespace neuroh5
+{
+  namespace graph
+  {
+
+    void exchange_edge_csr
+    (
+     MPI_Comm                  all_comm,
+     set<size_t>&              io_rank_set,
+     const NODE_IDX_T          src_start,
+     const NODE_IDX_T          src_end,
+     const NODE_IDX_T          dst_start,
+     const NODE_IDX_T          dst_end,
+     const data::EdgeCSR&      input_edges,
+     size_t&                   total_num_nodes,
+     data::EdgeCSR&            prj_edges
+     )
+    {
+      int ssize, srank;
+      throw_assert_nomsg(MPI_Comm_size(all_comm, &ssize) == MPI_SUCCESS);
+      throw_assert_nomsg(MPI_Comm_rank(all_comm, &srank) == MPI_SUCCESS);
+      const size_t size = ssize, rank = srank;
+
+      throw_assert(input_edges.offsets.size() == input_edges.keys.size() + 1,
+                   "exchange_edge_csr: size of offsets must be the number of destinations + 1");
+      throw_assert(input_edges.offsets.back() == input_edges.adj.size(),
+                   "exchange_edge_csr: last offset must be the number of edges");
+
+      // Map nodes to compute ranks
+      vector<NODE_IDX_T> local_node_index(input_edges.keys);
+      map<NODE_IDX_T, rank_t> node_rank_map;
+      total_num_nodes = 0;
+      mpi::compute_node_rank_map(all_comm, io_rank_set, local_node_index,
+                                 total_num_nodes, node_rank_map);
+      if (total_num_nodes == 0)
+        {
+          return;
+        }
+
+      vector<const data::AttrVal*> attr_values;
+      for (const data::AttrVal& a : input_edges.attrs)
+        {
+          attr_values.push_back(&a);
+        }
+
+      // arrange the rows by destination I/O rank, with relative source
+      // ids in ascending order
+      data::rank_edge_csr_t rank_edge_csr;
+      vector<size_t> p;
+      for (size_t i = 0; i < input_edges.num_nodes(); i++)
+        {
+          const NODE_IDX_T dst = input_edges.keys[i];
+          throw_assert(dst_start <= dst && dst < dst_end,
+                       "exchange_edge_csr: destination " << dst << " out of range");
+          const size_t low = input_edges.row_begin(i), high = input_edges.row_end(i);
+          throw_assert(low <= high, "exchange_edge_csr: offsets must be non-decreasing");
+
+          bool sorted = true;
+          for (size_t j = low; j < high; j++)
+            {
+              const NODE_IDX_T src = input_edges.adj[j];
+              throw_assert(src_start <= src && src < src_end,
+                           "exchange_edge_csr: source " << src << " out of range");
+              if ((j > low) && (src < input_edges.adj[j-1]))
+                {
+                  sorted = false;
+                }
+            }
+
+          auto it = node_rank_map.find(dst);
+          throw_assert_nomsg(it != node_rank_map.end());
+          data::EdgeCSR& rank_edges = rank_edge_csr[it->second];
+          if (rank_edges.attrs.size() < attr_values.size())
+            {
+              rank_edges.init_attrs(attr_values);
+            }
+
+          if (sorted)
+            {
+              const size_t start = rank_edges.adj.size();
+              rank_edges.append_row(dst, input_edges.adj, attr_values, low, high);
+              for (size_t j = start; j < rank_edges.adj.size(); j++)
+                {
+                  rank_edges.adj[j] -= src_start;
+                }
+            }
+          else
+            {
+              p.resize(high - low);
+              iota(p.begin(), p.end(), low);
+              stable_sort(p.begin(), p.end(),
+                          [&] (size_t a, size_t b) { return input_edges.adj[a] < input_edges.adj[b]; });
+              for (const size_t j : p)
+                {
+                  rank_edges.push_back(dst, input_edges.adj[j] - src_start, attr_values, j);
+                }
+            }
+        }
+      for (auto& rank_edges : rank_edge_csr)
+        {
+          rank_edges.second.sort_rows();
+        }
+
+      vector<char> sendbuf, recvbuf;
+      vector<size_t> sendcounts(size,0), sdispls(size,0), recvcounts(size,0), rdispls(size,0);
+      size_t num_packed_edges = 0;
+      {
+        mpi::PhaseTimer timer("serialize_edges");
+        data::serialize_rank_edge_csr (size, rank, rank_edge_csr, num_packed_edges,
+                                       sendcounts, sendbuf, sdispls);
+      }
+      rank_edge_csr.clear();
+
+      {
+        mpi::PhaseTimer timer("alltoallv");
+        throw_assert_nomsg(mpi::alltoallv_vector<char>(all_comm, MPI_CHAR, sendcounts, sdispls, sendbuf,
+                                                       recvcounts, rdispls, recvbuf) >= 0);
+      }
+      sendbuf.clear();
+      sendbuf.shrink_to_fit();
+
+      prj_edges.clear();
+      if (recvbuf.size() > 0)
+        {
+          mpi::PhaseTimer timer("deserialize_edges");
+          size_t num_unpacked_nodes = 0, num_unpacked_edges = 0;
+          data::deserialize_rank_edge_csr (size, recvbuf, recvcounts, rdispls,
+                                           prj_edges, num_unpacked_nodes, num_unpacked_edges);
+        }
+    }
+
+  }
+}
@@ -0,0 +1,352 @@
+// -*- mode: c++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+//==============================================================================
+///  @file projection_degree.cc
+///
+///  Vertex degrees computed directly from the DBS datasets of a projection.
+///
+///  Copyright (C) 2016-2025 Project NeuroH5.
+//==============================================================================
+
+#include <algorithm>
+#include <array>
+#include <map>
+#include <vector>
+
+#include "neuroh5_types.hh"
+#include "projection_degree.hh"
+#include "cell_populations.hh"
+#include "read_projection_datasets.hh"
+#include "alltoallv_template.hh"
+#include "phase_stats.hh"
+#include "throw_assert.hh"
+
+using namespace std;
+
+namespace neuroh5
+{
+  namespace graph
+  {
+
+    // counters per node in the reduction buffer: presence in the
+    // projection, degree and unique degree
+    static const size_t num_degree_counters = 3;
+
+    // Nodes [0, num_nodes) are split into contiguous ranges of nearly
+    // equal size, one per rank; returns the rank of the range of a node
+    static size_t node_owner (const size_t node, const size_t num_nodes, const size_t size)
+    {
+      const size_t q = num_nodes / size, r = num_nodes % size;
+      const size_t split = r * (q + 1);
+      return (node < split) ? (node / (q + 1)) : (r + (node - split) / q);
+    }
+
+    static size_t range_start (const size_t rank, const size_t num_nodes, const size_t size)
+    {
+      const size_t q = num_nodes / size, r = num_nodes % size;
+      return rank * q + std::min(rank, r);
+    }
+
+    // Sends the values of sendbuf, grouped by destination rank in
+    // ascending order with counts sendcounts, and returns the values
+    // received from each rank in recvbuf
+    template <class T>
+    static void exchange_values
+    (
+     MPI_Comm comm,
+     const MPI_Datatype datatype,
+     const vector<size_t>& sendcounts,
+     const vector<T>& sendbuf,
+     vector<size_t>& recvcounts,
+     vector<size_t>& rdispls,
+     vector<T>& recvbuf
+     )
+    {
+      const size_t size = sendcounts.size();
+      vector<size_t> sdispls(size, 0);
+      for (size_t r = 1; r < size; r++)
+        {
+          sdispls[r] = sdispls[r-1] + sendcounts[r-1];
+        }
+      recvcounts.assign(size, 0);
+      rdispls.assign(size, 0);
+      recvbuf.clear();
+      throw_assert(mpi::alltoallv_vector<T>(comm, datatype, sendcounts, sdispls, sendbuf,
+                                            recvcounts, rdispls, recvbuf) >= 0,
+                   "read_projection_degree: error in MPI_Alltoallv");
+    }
+
+    void read_projection_degree
+    (
+     MPI_Comm              comm,
+     const std::string&    file_name,
+     const std::string&    src_pop_name,
+     const std::string&    dst_pop_name,
+     const EdgeMapType     edge_map_type,
+     ProjectionDegree&     result
+     )
+    {
+      mpi::PhaseTimer timer("read_projection_degree");
+
+      int srank, ssize;
+      throw_assert_nomsg(MPI_Comm_size(comm, &ssize) == MPI_SUCCESS);
+      throw_assert_nomsg(MPI_Comm_rank(comm, &srank) == MPI_SUCCESS);
+      const size_t size = ssize, rank = srank;
+
+      pop_range_map_t pop_ranges;
+      pop_label_map_t pop_labels;
+      size_t total_num_nodes;
+      throw_assert_nomsg(cell::read_population_ranges(comm, file_name, pop_ranges, total_num_nodes) >= 0);
+      throw_assert_nomsg(cell::read_population_labels(comm, file_name, pop_labels) >= 0);
+
+      pop_range_t src_range = { 0, 0, 0 }, dst_range = { 0, 0, 0 };
+      bool src_pop_set = false, dst_pop_set = false;
+      for (auto &x : pop_labels)
+        {
+          if (src_pop_name == get<1>(x))
+            {
+              src_range = pop_ranges[get<0>(x)];
+              src_pop_set = true;
+            }
+          if (dst_pop_name == get<1>(x))
+            {
+              dst_range = pop_ranges[get<0>(x)];
+              dst_pop_set = true;
+            }
+        }
+      throw_assert(src_pop_set, "read_projection_degree: unknown population " << src_pop_name);
+      throw_assert(dst_pop_set, "read_projection_degree: unknown population " << dst_pop_name);
+      const pop_range_t& node_range = (edge_map_type == EdgeMapDst) ? dst_range : src_range;
+
+      DST_BLK_PTR_T block_base;
+      DST_PTR_T edge_base;
+      vector<DST_BLK_PTR_T> dst_blk_ptr;
+      vector<NODE_IDX_T> dst_idx;
+      vector<DST_PTR_T> dst_ptr;
+      vector<NODE_IDX_T> src_idx;
+      size_t total_num_edges = 0;
+      hsize_t total_read_blocks = 0, local_read_blocks = 0;
+      {
+        mpi::PhaseTimer timer("read_projection_datasets");
+        throw_assert(hdf5::read_projection_datasets(comm, file_name, src_pop_name, dst_pop_name,
+                                                    block_base, edge_base,
+                                                    dst_blk_ptr, dst_idx, dst_ptr, src_idx,
+                                                    total_num_edges, total_read_blocks,
+                                                    local_read_blocks) >= 0,
+                     "read_projection_degree: error in read_projection_datasets");
+      }
+
+      // ranges of SRC_IDX of each destination read by this rank; a
+      // destination appended more than once has several blocks
+      const size_t num_dst = dst_range.count;
+      map<NODE_IDX_T, vector< pair<size_t,size_t> > > dst_edge_ranges;
+      const size_t dst_ptr_size = dst_ptr.size();
+      for (size_t b = 0; b < dst_idx.size(); ++b)
+        {
+          const NODE_IDX_T dst_base = dst_idx[b];
+          for (size_t i = dst_blk_ptr[b], ii = 0; i < dst_blk_ptr[b+1]; ++i, ++ii)
+            {
+              if (i + 1 >= dst_ptr_size)
+                break;
+              const size_t dst = dst_base + ii;
+              const size_t low = dst_ptr[i], high = dst_ptr[i+1];
+              throw_assert((low <= high) && (high <= src_idx.size()),
+                           "read_projection_degree: invalid destination pointer in projection "
+                           << src_pop_name << " -> " << dst_pop_name);
+              throw_assert(dst < num_dst,
+                           "read_projection_degree: destination " << dst
+                           << " out of range in projection "
+                           << src_pop_name << " -> " << dst_pop_name);
+              dst_edge_ranges[dst].push_back(make_pair(low, high));
+            }
+        }
+
+      // The blocks of a destination may be read by different ranks
+      // after append_graph. Such destinations are found by the owner of
+      // their range, and their sources are sent to the owner, so that
+      // every destination is counted by exactly one rank.
+      map<NODE_IDX_T, vector<NODE_IDX_T> > merged_dst_edges;
+      {
+        mpi::PhaseTimer timer("merge_split_destinations");
+
+        vector<size_t> sendcounts(size, 0), recvcounts, rdispls;
+        vector<NODE_IDX_T> sendbuf, recvbuf;
+        sendbuf.reserve(dst_edge_ranges.size());
+        for (auto const& it : dst_edge_ranges)
+          {
+            sendcounts[node_owner(it.first, num_dst, size)]++;
+            sendbuf.push_back(it.first);
+          }
+        exchange_values<NODE_IDX_T>(comm, MPI_NODE_IDX_T, sendcounts, sendbuf,
+                                    recvcounts, rdispls, recvbuf);
+
+        // destinations reported by more than one rank, returned to each
+        // of these ranks
+        map<NODE_IDX_T, size_t> num_reports;
+        for (const NODE_IDX_T dst : recvbuf)
+          {
+            num_reports[dst]++;
+          }
+        sendcounts.assign(size, 0);
+        sendbuf.clear();
+        for (size_t r = 0; r < size; r++)
+          {
+            for (size_t i = rdispls[r]; i < rdispls[r] + recvcounts[r]; i++)
+              {
+                if (num_reports[recvbuf[i]] > 1)
+                  {
+                    sendbuf.push_back(recvbuf[i]);
+                    sendcounts[r]++;
+                  }
+              }
+          }
+        vector<NODE_IDX_T> split_dsts;
+        exchange_values<NODE_IDX_T>(comm, MPI_NODE_IDX_T, sendcounts, sendbuf,
+                                    recvcounts, rdispls, split_dsts);
+
+        // each split destination is sent as its number of edges
+        // followed by its sources
+        vector<uint64_t> edge_sendbuf, edge_recvbuf;
+        vector<size_t> edge_sendcounts(size, 0);
+        sort(split_dsts.begin(), split_dsts.end());
+        for (const NODE_IDX_T dst : split_dsts)
+          {
+            auto it = dst_edge_ranges.find(dst);
+            throw_assert_nomsg(it != dst_edge_ranges.end());
+            size_t num_edges = 0;
+            for (auto const& range : it->second)
+              {
+                num_edges += range.second - range.first;
+              }
+            const size_t owner = node_owner(dst, num_dst, size);
+            edge_sendbuf.push_back(dst);
+            edge_sendbuf.push_back(num_edges);
+            for (auto const& range : it->second)
+              {
+                edge_sendbuf.insert(edge_sendbuf.end(),
+                                    src_idx.begin() + range.first,
+                                    src_idx.begin() + range.second);
+              }
+            edge_sendcounts[owner] += 2 + num_edges;
+            dst_edge_ranges.erase(it);
+          }
+        exchange_values<uint64_t>(comm, MPI_UINT64_T, edge_sendcounts, edge_sendbuf,
+                                  recvcounts, rdispls, edge_recvbuf);
+        for (size_t i = 0; i < edge_recvbuf.size(); )
+          {
+            const NODE_IDX_T dst = edge_recvbuf[i];
+            const size_t num_edges = edge_recvbuf[i+1];
+            vector<NODE_IDX_T>& adj = merged_dst_edges[dst];
+            adj.insert(adj.end(), edge_recvbuf.begin() + i + 2,
+                       edge_recvbuf.begin() + i + 2 + num_edges);
+            i += 2 + num_edges;
+          }
+      }
+
+      // counters of the nodes touched by this rank, sent to the owners
+      // of their ranges
+      const size_t num_nodes = node_range.count;
+      map<size_t, array<uint64_t, num_degree_counters> > node_counts;
+      vector<NODE_IDX_T> adj;
+      auto count_row = [&] (const size_t dst)
+        {
+          sort(adj.begin(), adj.end());
+          if (edge_map_type == EdgeMapDst)
+            {
+              array<uint64_t, num_degree_counters>& c = node_counts[dst];
+              c[0] = 1;
+              c[1] += adj.size();
+              c[2] += distance(adj.begin(), unique(adj.begin(), adj.end()));
+            }
+          else
+            {
+              for (size_t j = 0; j < adj.size(); )
+                {
+                  const size_t src = adj[j];
+                  throw_assert(src < num_nodes,
+                               "read_projection_degree: source " << src
+                               << " out of range in projection "
+                               << src_pop_name << " -> " << dst_pop_name);
+                  size_t k = j;
+                  while ((k < adj.size()) && (adj[k] == adj[j])) k++;
+                  array<uint64_t, num_degree_counters>& c = node_counts[src];
+                  c[0] = 1;
+                  c[1] += k - j;
+                  c[2] += 1;
+                  j = k;
+                }
+            }
+        };
+      for (auto const& it : dst_edge_ranges)
+        {
+          adj.clear();
+          for (auto const& range : it.second)
+            {
+              adj.insert(adj.end(), src_idx.begin() + range.first, src_idx.begin() + range.second);
+            }
+          count_row(it.first);
+        }
+      for (auto& it : merged_dst_edges)
+        {
+          adj.swap(it.second);
+          count_row(it.first);
+        }
+      dst_edge_ranges.clear();
+      merged_dst_edges.clear();
+      src_idx.clear();
+
+      vector<uint64_t> local_counts;
+      {
+        mpi::PhaseTimer timer("reduce_degree");
+        const size_t count_size = 1 + num_degree_counters;
+        vector<size_t> sendcounts(size, 0), recvcounts, rdispls;
+        vector<uint64_t> sendbuf, recvbuf;
+        sendbuf.reserve(count_size * node_counts.size());
+        for (auto const& it : node_counts)
+          {
+            sendcounts[node_owner(it.first, num_nodes, size)] += count_size;
+            sendbuf.push_back(it.first);
+            sendbuf.insert(sendbuf.end(), it.second.begin(), it.second.end());
+          }
+        node_counts.clear();
+        exchange_values<uint64_t>(comm, MPI_UINT64_T, sendcounts, sendbuf,
+                                  recvcounts, rdispls, recvbuf);
+
+        const size_t local_start = range_start(rank, num_nodes, size);
+        const size_t local_count = range_start(rank + 1, num_nodes, size) - local_start;
+        local_counts.assign(num_degree_counters * local_count, 0);
+        for (size_t i = 0; i < recvbuf.size(); i += count_size)
+          {
+            uint64_t* c = &local_counts[num_degree_counters * (recvbuf[i] - local_start)];
+            c[0] = 1;
+            c[1] += recvbuf[i+2];
+            c[2] += recvbuf[i+3];
+          }
+      }
+
+      result.node_id.clear();
+      result.degree.clear();
+      result.unique_degree.clear();
+      const size_t local_start = range_start(rank, num_nodes, size);
+      uint64_t local_totals[2] = { 0, 0 };
+      for (size_t i = 0; i < local_counts.size(); i += num_degree_counters)
+        {
+          if (local_counts[i] > 0)
+            {
+              result.node_id.push_back(node_range.start + local_start + i / num_degree_counters);
+              result.degree.push_back(local_counts[i+1]);
+              result.unique_degree.push_back(local_counts[i+2]);
+              local_totals[0] += local_counts[i+1];
+              local_totals[1] += local_counts[i+2];
+            }
+        }
+
+      uint64_t totals[2] = { 0, 0 };
+      throw_assert(MPI_Allreduce(local_totals, totals, 2, MPI_UINT64_T, MPI_SUM,
+                                 comm) == MPI_SUCCESS,
+                   "read_projection_degree: error in MPI_Allreduce");
+      result.total_degree = totals[0];
+      result.total_unique_degree = totals[1];
+    }
+
+  }
+}
@@ -15,6 +15,7 @@
 #include "debug.hh"
 #include "path_names.hh"
 #include "group_contents.hh"
+#include "file_session.hh"
 #include "serialize_data.hh"
 #include "throw_assert.hh"
 
@@ -60,74 +61,85 @@ namespace neuroh5
         // MPI rank 0 reads and broadcasts the number of ranges
         hid_t file = -1;
 
-        // MPI rank 0 reads and broadcasts the projection names
-        if (rank == 0)
+        hdf5::FileSession* session = hdf5::FileSession::find(comm, file_name);
+        if ((session == nullptr) ||
+            !(session->find_metadata("projection_src_pop_names", prj_src_pop_names) &&
+              session->find_metadata("projection_dst_pop_names", prj_dst_pop_names)))
           {
-            vector <string> dst_pop_names;
-            file = H5Fopen(file_name.c_str(), H5F_ACC_RDONLY, H5P_DEFAULT);
-            if (file >= 0)
+            // MPI rank 0 reads and broadcasts the projection names
+            if (rank == 0)
               {
+                vector <string> dst_pop_names;
+                file = H5Fopen(file_name.c_str(), H5F_ACC_RDONLY, H5P_DEFAULT);
+                if (file >= 0)
+                  {
 
-                throw_assert_nomsg(hdf5::group_contents(comm, file, hdf5::PROJECTIONS, dst_pop_names) >= 0);
+                    throw_assert_nomsg(hdf5::group_contents(comm, file, hdf5::PROJECTIONS, dst_pop_names) >= 0);
                 
-                for (size_t i=0; i<dst_pop_names.size(); i++)
-                  {
-                    vector <string> src_pop_names;
-                    const string& dst_pop_name = dst_pop_names[i];
+                    for (size_t i=0; i<dst_pop_names.size(); i++)
+                      {
+                        vector <string> src_pop_names;
+                        const string& dst_pop_name = dst_pop_names[i];
                     
-                    throw_assert_nomsg(hdf5::group_contents(comm, file, hdf5::PROJECTIONS+"/"+dst_pop_name, src_pop_names) >= 0);
+                        throw_assert_nomsg(hdf5::group_contents(comm, file, hdf5::PROJECTIONS+"/"+dst_pop_name, src_pop_names) >= 0);
                     
-                    for (size_t j=0; j<src_pop_names.size(); j++)
-                      {
-                        prj_src_pop_names.push_back(src_pop_names[j]);
-                        prj_dst_pop_names.push_back(dst_pop_name);
+                        for (size_t j=0; j<src_pop_names.size(); j++)
+                          {
+                            prj_src_pop_names.push_back(src_pop_names[j]);
+                            prj_dst_pop_names.push_back(dst_pop_name);
+                          }
                       }
-                  }
                 
-                throw_assert_nomsg(H5Fclose(file) >= 0);
-              }
-            else
-              {
-                ierr = file;
+                    throw_assert_nomsg(H5Fclose(file) >= 0);
+                  }
+                else
+                  {
+                    ierr = file;
+                  }
               }
-          }
         
-        // Broadcast projection names
-        {
-          vector<char> sendbuf; uint32_t sendbuf_size=0;
-          if (rank == 0)
+            // Broadcast projection names
             {
-              data::serialize_data(prj_src_pop_names, sendbuf);
-              sendbuf_size = sendbuf.size();
-            }
+              vector<char> sendbuf; uint32_t sendbuf_size=0;
+              if (rank == 0)
+                {
+                  data::serialize_data(prj_src_pop_names, sendbuf);
+                  sendbuf_size = sendbuf.size();
+                }
 
-          throw_assert_nomsg(MPI_Bcast(&sendbuf_size, 1, MPI_UINT32_T, 0, comm) == MPI_SUCCESS);
-          sendbuf.resize(sendbuf_size);
-          throw_assert_nomsg(MPI_Bcast(&sendbuf[0], sendbuf_size, MPI_CHAR, 0, comm) == MPI_SUCCESS);
+              throw_assert_nomsg(MPI_Bcast(&sendbuf_size, 1, MPI_UINT32_T, 0, comm) == MPI_SUCCESS);
+              sendbuf.resize(sendbuf_size);
+              throw_assert_nomsg(MPI_Bcast(&sendbuf[0], sendbuf_size, MPI_CHAR, 0, comm) == MPI_SUCCESS);
           
-          if (rank != 0)
-            {
-              data::deserialize_data(sendbuf, prj_src_pop_names);
+              if (rank != 0)
+                {
+                  data::deserialize_data(sendbuf, prj_src_pop_names);
+                }
             }
-        }
-        {
-          vector<char> sendbuf; uint32_t sendbuf_size=0;
-          if (rank == 0)
             {
-              data::serialize_data(prj_dst_pop_names, sendbuf);
-              sendbuf_size = sendbuf.size();
-            }
+              vector<char> sendbuf; uint32_t sendbuf_size=0;
+              if (rank == 0)
+                {
+                  data::serialize_data(prj_dst_pop_names, sendbuf);
+                  sendbuf_size = sendbuf.size();
+                }
           
 
-          throw_assert_nomsg(MPI_Bcast(&sendbuf_size, 1, MPI_UINT32_T, 0, comm) == MPI_SUCCESS);
-          sendbuf.resize(sendbuf_size);
-          throw_assert_nomsg(MPI_Bcast(&sendbuf[0], sendbuf_size, MPI_CHAR, 0, comm) == MPI_SUCCESS);
+              throw_assert_nomsg(MPI_Bcast(&sendbuf_size, 1, MPI_UINT32_T, 0, comm) == MPI_SUCCESS);
+              sendbuf.resize(sendbuf_size);
+              throw_assert_nomsg(MPI_Bcast(&sendbuf[0], sendbuf_size, MPI_CHAR, 0, comm) == MPI_SUCCESS);
           
-          if (rank != 0)
-            {
-              data::deserialize_data(sendbuf, prj_dst_pop_names);
+              if (rank != 0)
+                {
+                  data::deserialize_data(sendbuf, prj_dst_pop_names);
+                }
             }
-        }
+            if (session != nullptr)
+              {
+                session->insert_metadata("projection_src_pop_names", prj_src_pop_names);
+                session->insert_metadata("projection_dst_pop_names", prj_dst_pop_names);
+              }
+          }
 
 
         for (size_t i=0; i<prj_dst_pop_names.size(); i++)
@@ -31,7 +31,7 @@ namespace neuroh5
      const std::string&    file_name,
      const vector<string>& edge_attr_name_spaces,
      const vector< pair<string, string> >& prj_names,
-     std::vector<edge_map_t>& prj_vector,
+     std::vector<EdgeCSR>& prj_vector,
      vector < map <string, vector < vector<string> > > > & edge_attr_names_vector,
      size_t&              total_num_nodes,
      size_t&              local_num_edges,
@@ -129,8 +129,30 @@ namespace neuroh5
       return 0;
     }
 
-
-
+    int read_graph
+    (
+     MPI_Comm              comm,
+     const std::string&    file_name,
+     const vector<string>& edge_attr_name_spaces,
+     const vector< pair<string, string> >& prj_names,
+     std::vector<edge_map_t>& prj_vector,
+     vector < map <string, vector < vector<string> > > > & edge_attr_names_vector,
+     size_t&              total_num_nodes,
+     size_t&              local_num_edges,
+     size_t&              total_num_edges
+     )
+    {
+      std::vector<EdgeCSR> prj_csr_vector;
+      int status = read_graph(comm, file_name, edge_attr_name_spaces, prj_names,
+                              prj_csr_vector, edge_attr_names_vector,
+                              total_num_nodes, local_num_edges, total_num_edges);
+      for (const EdgeCSR& prj_edge_csr : prj_csr_vector)
+        {
+          prj_vector.emplace_back();
+          prj_edge_csr.to_edge_map(prj_vector.back());
+        }
+      return status;
+    }
 
   }
 }
@@ -14,7 +14,7 @@
 #include "edge_attributes.hh"
 #include "read_projection_datasets.hh"
 #include "validate_edge_list.hh"
-#include "append_edge_map.hh"
+#include "append_edge_csr.hh"
 #include "mpi_debug.hh"
 #include "debug.hh"
 
@@ -46,7 +46,7 @@ namespace neuroh5
      const NODE_IDX_T&          src_start,
      const NODE_IDX_T&          dst_start,
      const vector<string>&      attr_namespaces,
-     vector<edge_map_t>&       prj_vector,
+     vector<data::EdgeCSR>&    prj_vector,
      vector < map <string, vector < vector<string> > > > & edge_attr_names_vector,
      size_t&                    local_num_nodes,
      size_t&                    local_num_edges,
@@ -113,15 +113,15 @@ namespace neuroh5
       
       size_t local_prj_num_edges=0;
 
-      edge_map_t prj_edge_map;
-      // append to the vectors representing a projection (sources,
+      data::EdgeCSR prj_edge_csr;
+      // append to the flat arrays representing a projection (sources,
       // destinations, edge attributes)
-      throw_assert(data::append_edge_map(dst_start, src_start, dst_blk_ptr, dst_idx,
+      throw_assert(data::append_edge_csr(dst_start, src_start, dst_blk_ptr, dst_idx,
                                          dst_ptr, src_idx, attr_namespaces, edge_attr_map,
-                                         local_prj_num_edges, prj_edge_map,
+                                         local_prj_num_edges, prj_edge_csr,
                                          EdgeMapDst) >= 0,
-                   "read_projection: error in append_edge_map");
-      local_num_nodes = prj_edge_map.size();
+                   "read_projection: error in append_edge_csr");
+      local_num_nodes = prj_edge_csr.num_nodes();
       
       mpi::MPI_DEBUG(comm, "read_projection: local_num_nodes = ", 
                      local_num_nodes, 
@@ -133,7 +133,7 @@ namespace neuroh5
       throw_assert(local_prj_num_edges == edge_count,
                    "read_projection: edge count mismatch");
 
-      prj_vector.push_back(prj_edge_map);
+      prj_vector.push_back(std::move(prj_edge_csr));
       edge_attr_names_vector.push_back (edge_attr_names);
 #ifdef NEUROH5_DEBUG
       throw_assert(MPI_Barrier(comm) == MPI_SUCCESS,
@@ -143,7 +143,44 @@ namespace neuroh5
       return ierr;
     }
 
-    
+
+    herr_t read_projection
+    (
+     MPI_Comm                   comm,
+     const std::string&         file_name,
+     const pop_search_range_map_t&     pop_search_ranges,
+     const set < pair<pop_t, pop_t> >& pop_pairs,
+     const std::string&         src_pop_name,
+     const std::string&         dst_pop_name,
+     const NODE_IDX_T&          src_start,
+     const NODE_IDX_T&          dst_start,
+     const vector<string>&      attr_namespaces,
+     vector<edge_map_t>&       prj_vector,
+     vector < map <string, vector < vector<string> > > > & edge_attr_names_vector,
+     size_t&                    local_num_nodes,
+     size_t&                    local_num_edges,
+     size_t&                    total_num_edges,
+     hsize_t&                   local_read_blocks,
+     hsize_t&                   total_read_blocks,
+     size_t                     offset,
+     size_t                     numitems,
+     bool collective
+     )
+    {
+      vector<data::EdgeCSR> prj_csr_vector;
+      herr_t ierr = read_projection(comm, file_name, pop_search_ranges, pop_pairs,
+                                    src_pop_name, dst_pop_name, src_start, dst_start,
+                                    attr_namespaces, prj_csr_vector, edge_attr_names_vector,
+                                    local_num_nodes, local_num_edges, total_num_edges,
+                                    local_read_blocks, total_read_blocks,
+                                    offset, numitems, collective);
+      for (const data::EdgeCSR& prj_edge_csr : prj_csr_vector)
+        {
+          prj_vector.emplace_back();
+          prj_edge_csr.to_edge_map(prj_vector.back());
+        }
+      return ierr;
+    }
+
   }
 }
-
@@ -13,6 +13,7 @@
 #include "cell_populations.hh"
 #include "scatter_read_projection.hh"
 #include "scatter_read_graph.hh"
+#include "phase_stats.hh"
 #include "throw_assert.hh"
 #include "debug.hh"
 
@@ -44,7 +45,7 @@ namespace neuroh5
      const vector< pair<string, string> >&         prj_names,
      // A vector that maps nodes to compute ranks
      const node_rank_map_t&  node_rank_map,
-     vector < edge_map_t >& prj_vector,
+     vector < data::EdgeCSR >& prj_vector,
      vector < map <string, vector < vector<string> > > > & edge_attr_names_vector,
      size_t                       &local_num_nodes,
      size_t                       &total_num_nodes,
@@ -52,6 +53,8 @@ namespace neuroh5
      size_t                       &total_num_edges
      )
     {
+      mpi::PhaseTimer timer("scatter_read_graph");
+
       int ierr = 0;
       // The set of compute ranks for which the current I/O rank is responsible
       set< pair<pop_t, pop_t> > pop_pairs;
@@ -62,11 +65,14 @@ namespace neuroh5
       throw_assert_nomsg(MPI_Comm_size(all_comm, &size) == MPI_SUCCESS);
       throw_assert_nomsg(MPI_Comm_rank(all_comm, &rank) == MPI_SUCCESS);
           
-       throw_assert_nomsg(cell::read_population_ranges
-                          (all_comm, file_name, pop_ranges, total_num_nodes)
-                          >= 0);
-       throw_assert_nomsg(cell::read_population_labels(all_comm, file_name, pop_labels) >= 0);
-       throw_assert_nomsg(cell::read_population_combos(all_comm, file_name, pop_pairs)  >= 0);
+       {
+         mpi::PhaseTimer timer("read_population_info");
+         throw_assert_nomsg(cell::read_population_ranges
+                            (all_comm, file_name, pop_ranges, total_num_nodes)
+                            >= 0);
+         throw_assert_nomsg(cell::read_population_labels(all_comm, file_name, pop_labels) >= 0);
+         throw_assert_nomsg(cell::read_population_combos(all_comm, file_name, pop_pairs)  >= 0);
+       }
 
        pop_search_range_map_t pop_search_ranges;
        for (auto &x : pop_ranges)
@@ -118,6 +124,39 @@ namespace neuroh5
       return ierr;
     }
 
+
+    int scatter_read_graph
+    (
+     MPI_Comm                      all_comm,
+     const EdgeMapType             edge_map_type,
+     const std::string&            file_name,
+     const int                     io_size,
+     const vector<string> &        attr_namespaces,
+     const vector< pair<string, string> >&         prj_names,
+     // A vector that maps nodes to compute ranks
+     const node_rank_map_t&  node_rank_map,
+     vector < edge_map_t >& prj_vector,
+     vector < map <string, vector < vector<string> > > > & edge_attr_names_vector,
+     size_t                       &local_num_nodes,
+     size_t                       &total_num_nodes,
+     size_t                       &local_num_edges,
+     size_t                       &total_num_edges
+     )
+    {
+      vector < data::EdgeCSR > prj_csr_vector;
+      int ierr = scatter_read_graph(all_comm, edge_map_type, file_name, io_size,
+                                    attr_namespaces, prj_names, node_rank_map,
+                                    prj_csr_vector, edge_attr_names_vector,
+                                    local_num_nodes, total_num_nodes,
+                                    local_num_edges, total_num_edges);
+      for (const data::EdgeCSR& prj_edge_csr : prj_csr_vector)
+        {
+          prj_vector.emplace_back();
+          prj_edge_csr.to_edge_map(prj_vector.back());
+        }
+      return ierr;
+    }
+
   }
   
 }
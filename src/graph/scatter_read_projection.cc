@@ -19,9 +19,11 @@
 #include "alltoallv_template.hh"
 #include "serialize_edge.hh"
 #include "serialize_data.hh"
-#include "append_rank_edge_map.hh"
-#include "range_sample.hh"
+#include "append_edge_csr.hh"
+#include "io_rank_set.hh"
+#include "chunk_info.hh"
 #include "mpi_debug.hh"
+#include "phase_stats.hh"
 #include "throw_assert.hh"
 
 #include <cstdio>
@@ -29,6 +31,7 @@
 #include <sstream>
 #include <string>
 #include <cstring>
+#include <algorithm>
 #include <set>
 #include <map>
 #include <vector>
@@ -40,6 +43,270 @@ namespace neuroh5
   namespace graph
   {
     
+    /*****************************************************************************
+     * Broadcast the edge attribute names read by rank 0
+     *****************************************************************************/
+
+    static void bcast_edge_attr_names (MPI_Comm all_comm, const int rank,
+                                       const vector<string> &attr_namespaces,
+                                       map<string, vector< vector<string> > >& edge_attr_names,
+                                       vector < map <string, vector < vector<string> > > > & edge_attr_names_vector)
+    {
+      if (!attr_namespaces.empty())
+        {
+          mpi::PhaseTimer timer("bcast_edge_attr_names");
+          vector<char> sendbuf; uint32_t sendbuf_size=0;
+          if (rank == 0)
+            {
+              data::serialize_data(edge_attr_names, sendbuf);
+              sendbuf_size = sendbuf.size();
+            }
+            
+          MPI_Request bcast_req;
+
+          throw_assert_nomsg(MPI_Barrier(all_comm) == MPI_SUCCESS);
+          throw_assert(MPI_Ibcast(&sendbuf_size, 1, MPI_UINT32_T, 0, all_comm,
+                                  &bcast_req) == MPI_SUCCESS,
+                       "error in MPI_Ibcast");
+          throw_assert(MPI_Wait(&bcast_req, MPI_STATUS_IGNORE) == MPI_SUCCESS,
+                       "error in MPI_Wait");
+          sendbuf.resize(sendbuf_size);
+          throw_assert(MPI_Ibcast(&sendbuf[0], sendbuf_size, MPI_CHAR, 0, all_comm,
+                                  &bcast_req) == MPI_SUCCESS,
+                       "error in MPI_Ibcast");
+          throw_assert(MPI_Wait(&bcast_req, MPI_STATUS_IGNORE) == MPI_SUCCESS,
+                       "error in MPI_Wait");
+
+          mpi::MPI_DEBUG(all_comm, "scatter_read_projection: sendbuf size is ", sendbuf_size);
+            
+          if (rank != 0)
+            {
+              data::deserialize_data(sendbuf, edge_attr_names);
+            }
+          edge_attr_names_vector.push_back(edge_attr_names);
+            
+          mpi::MPI_DEBUG(all_comm, "scatter_read_projection: deserialized edge attr names");
+        }
+    }
+
+    
+    /*****************************************************************************
+     * Pipelined variant of scatter_read_projection: the I/O ranks read their
+     * destination blocks batch_size blocks at a time, and the exchange of
+     * each batch proceeds while the next batch is being read.
+     *****************************************************************************/
+
+    static void scatter_read_projection_batched (MPI_Comm all_comm, MPI_Comm io_comm,
+                                                 const bool is_io_rank, const size_t io_rank_root,
+                                                 const size_t batch_size,
+                                                 EdgeMapType edge_map_type, 
+                                                 const string& file_name, const string& src_pop_name, const string& dst_pop_name, 
+                                                 const NODE_IDX_T& src_start,
+                                                 const NODE_IDX_T& dst_start,
+                                                 const vector<string> &attr_namespaces,
+                                                 const node_rank_map_t&  node_rank_map,
+                                                 const pop_search_range_map_t& pop_search_ranges,
+                                                 const set< pair<pop_t, pop_t> >& pop_pairs,
+                                                 data::EdgeCSR& prj_edge_csr,
+                                                 map<string, vector< vector<string> > >& edge_attr_names,
+                                                 size_t &total_num_edges,
+                                                 hsize_t& total_read_blocks)
+    {
+      int rank, size;
+      throw_assert_nomsg(MPI_Comm_size(all_comm, &size) == MPI_SUCCESS);
+      throw_assert_nomsg(MPI_Comm_rank(all_comm, &rank) == MPI_SUCCESS);
+
+      DST_BLK_PTR_T block_base = 0;
+      DST_PTR_T edge_base = 0, edge_count = 0;
+      vector<DST_BLK_PTR_T> dst_blk_ptr;
+      vector<NODE_IDX_T> dst_idx;
+      vector<DST_PTR_T> dst_ptr;
+      map<string, vector< pair<string,AttrKind> > > edge_attr_info;
+      uint64_t num_batches = 0;
+
+      if (is_io_rank)
+        {
+          mpi::PhaseTimer timer("read_projection_pointers");
+          // the pointer datasets are small relative to the source index
+          // and attribute datasets, and are read only once
+          throw_assert(hdf5::read_projection_pointers(io_comm, file_name, src_pop_name, dst_pop_name,
+                                                      block_base, edge_base, edge_count,
+                                                      dst_blk_ptr, dst_idx, dst_ptr,
+                                                      total_num_edges, total_read_blocks) >= 0,
+                       "error in read_projection_pointers");
+          
+          for (const string& attr_namespace : attr_namespaces) 
+            {
+              throw_assert_nomsg(graph::get_edge_attributes(io_comm, file_name, src_pop_name, dst_pop_name,
+                                                            attr_namespace, edge_attr_info[attr_namespace]) >= 0);
+            }
+
+          uint64_t local_num_batches = (dst_idx.size() + batch_size - 1) / batch_size;
+          throw_assert(MPI_Allreduce(&local_num_batches, &num_batches, 1, MPI_UINT64_T, MPI_MAX,
+                                     io_comm) == MPI_SUCCESS,
+                       "error in MPI_Allreduce");
+        }
+
+      {
+        MPI_Request bcast_req[3];
+        throw_assert(MPI_Ibcast(&total_read_blocks, 1, MPI_SIZE_T, io_rank_root, all_comm,
+                                &bcast_req[0]) == MPI_SUCCESS,
+                     "error in MPI_Ibcast");
+        throw_assert(MPI_Ibcast(&num_batches, 1, MPI_UINT64_T, io_rank_root, all_comm,
+                                &bcast_req[1]) == MPI_SUCCESS,
+                     "error in MPI_Ibcast");
+        throw_assert(MPI_Ibcast(&total_num_edges, 1, MPI_SIZE_T, io_rank_root, all_comm,
+                                &bcast_req[2]) == MPI_SUCCESS,
+                     "error in MPI_Ibcast");
+        throw_assert(MPI_Waitall(3, bcast_req, MPI_STATUSES_IGNORE) == MPI_SUCCESS,
+                     "error in MPI_Waitall");
+      }
+
+      mpi::MPI_DEBUG(all_comm, "scatter_read_projection: reading ", src_pop_name, " -> ", dst_pop_name,
+                     " in ", num_batches, " batches");
+
+      // the send buffer of a batch must remain valid until its exchange
+      // completes, which happens after the following batch has been read
+      vector<char> sendbufs[2];
+      vector<char> recvbuf;
+      vector<size_t> recvcounts, rdispls;
+      vector<MPI_Request> requests;
+      bool exchange_pending = false;
+      vector<data::EdgeCSR> recv_edge_csr;
+
+      auto complete_exchange = [&] ()
+        {
+          if (!exchange_pending)
+            return;
+          if (!requests.empty())
+            {
+              mpi::PhaseTimer timer("wait_exchange");
+              throw_assert(MPI_Waitall(requests.size(), &requests[0], MPI_STATUSES_IGNORE) == MPI_SUCCESS,
+                           "error in MPI_Waitall");
+            }
+          requests.clear();
+          mpi::PhaseTimer timer("deserialize_edges");
+          data::deserialize_rank_edge_csr(size, recvbuf, recvcounts, rdispls, recv_edge_csr);
+          recvbuf.clear();
+          exchange_pending = false;
+        };
+      
+      for (size_t k = 0; k < num_batches; k++)
+        {
+          vector<char>& sendbuf = sendbufs[k % 2];
+          vector<size_t> sendcounts(size,0), sdispls(size,0);
+          sendbuf.clear();
+          
+          if (is_io_rank)
+            {
+              // local blocks [b0, b1), destination pointers [p0, p1) and
+              // edges [e0, e1) of this batch
+              const size_t num_blocks = dst_idx.size();
+              const size_t b0 = std::min(k * batch_size, num_blocks);
+              const size_t b1 = std::min(b0 + batch_size, num_blocks);
+              size_t p0 = 0;
+              DST_PTR_T e0 = 0, e1 = 0;
+
+              vector<DST_BLK_PTR_T> batch_dst_blk_ptr;
+              vector<NODE_IDX_T> batch_dst_idx;
+              vector<DST_PTR_T> batch_dst_ptr;
+              if (b1 > b0)
+                {
+                  p0 = dst_blk_ptr[b0];
+                  const size_t p1 = dst_blk_ptr[b1];
+                  e0 = (p0 < dst_ptr.size()) ? dst_ptr[p0] : edge_count;
+                  e1 = (p1 < dst_ptr.size()) ? dst_ptr[p1] : edge_count;
+
+                  for (size_t b = b0; b <= b1; b++)
+                    {
+                      batch_dst_blk_ptr.push_back(dst_blk_ptr[b] - p0);
+                    }
+                  batch_dst_idx.assign(dst_idx.begin()+b0, dst_idx.begin()+b1);
+                  for (size_t p = p0; p < p1; p++)
+                    {
+                      batch_dst_ptr.push_back(dst_ptr[p] - e0);
+                    }
+                  batch_dst_ptr.push_back(e1 - e0);
+                }
+
+              // ranks without blocks in this batch still take part in
+              // the collective reads with an empty selection
+              vector<NODE_IDX_T> src_idx;
+              {
+                mpi::PhaseTimer timer("read_projection_src_idx");
+                throw_assert(hdf5::read_projection_src_idx(io_comm, file_name, src_pop_name, dst_pop_name,
+                                                           edge_base + e0, e1 - e0, src_idx) >= 0,
+                             "error in read_projection_src_idx");
+              }
+
+              throw_assert_nomsg(validate_edge_list(dst_start, src_start, batch_dst_blk_ptr, batch_dst_idx,
+                                                    batch_dst_ptr, src_idx, pop_search_ranges, pop_pairs) == true);
+
+              map<string, data::NamedAttrVal> edge_attr_map;
+              for (const string& attr_namespace : attr_namespaces) 
+                {
+                  mpi::PhaseTimer timer("read_edge_attributes");
+                  throw_assert_nomsg(graph::read_all_edge_attributes(io_comm, file_name,
+                                                                     src_pop_name, dst_pop_name, attr_namespace,
+                                                                     edge_base + e0, e1 - e0,
+                                                                     edge_attr_info[attr_namespace],
+                                                                     edge_attr_map[attr_namespace]) >= 0);
+                  edge_attr_map[attr_namespace].attr_names(edge_attr_names[attr_namespace]);
+                }
+
+              // p0 destinations precede this batch, so that the default
+              // assignment of destinations to ranks is the same as in the
+              // single-pass read
+              size_t num_edges = 0;
+              data::rank_edge_csr_t prj_rank_edge_csr;
+              {
+                mpi::PhaseTimer timer("append_rank_edge_map");
+                throw_assert(data::append_rank_edge_csr(rank + p0, size, dst_start, src_start,
+                                                        batch_dst_blk_ptr, batch_dst_idx, batch_dst_ptr, src_idx,
+                                                        attr_namespaces, edge_attr_map, node_rank_map, num_edges,
+                                                        prj_rank_edge_csr, edge_map_type) >= 0,
+                             "error in append_rank_edge_csr");
+              }
+              throw_assert(num_edges == src_idx.size(),
+                           "edge count mismatch: num_edges = " << num_edges <<
+                           " src_idx.size = " << src_idx.size());
+
+              size_t num_packed_edges = 0;
+              {
+                mpi::PhaseTimer timer("serialize_edges");
+                data::serialize_rank_edge_csr (size, rank, prj_rank_edge_csr, 
+                                               num_packed_edges, sendcounts, sendbuf, sdispls);
+              }
+              throw_assert_nomsg(num_packed_edges == num_edges);
+
+              mpi::MPI_DEBUG(io_comm, "scatter_read_projection: batch ", k, ": packed ", num_packed_edges,
+                             " edges from projection ", src_pop_name, " -> ", dst_pop_name);
+            }
+
+          complete_exchange();
+
+          mpi::PhaseTimer timer("alltoallv");
+          throw_assert_nomsg(mpi::ialltoallv_vector<char>(all_comm, MPI_CHAR, sendcounts, sdispls, sendbuf,
+                                                          recvcounts, rdispls, recvbuf, requests) >= 0);
+          exchange_pending = true;
+        }
+
+      complete_exchange();
+
+      if (recv_edge_csr.size() == 1)
+        {
+          prj_edge_csr = std::move(recv_edge_csr[0]);
+        }
+      else if (recv_edge_csr.size() > 1)
+        {
+          // edges of a node received in several batches or from several
+          // ranks are concatenated in batch and sender rank order
+          mpi::PhaseTimer timer("merge_edge_csr");
+          data::merge_edge_csr(recv_edge_csr, prj_edge_csr);
+        }
+    }
+
+    
     /*****************************************************************************
      * Load and scatter edge data structures 
      *****************************************************************************/
@@ -52,12 +319,15 @@ namespace neuroh5
                                  const node_rank_map_t&  node_rank_map,
                                  const pop_search_range_map_t& pop_search_ranges,
                                  const set< pair<pop_t, pop_t> >& pop_pairs,
-                                 vector < edge_map_t >& prj_vector,
+                                 vector < data::EdgeCSR >& prj_vector,
                                  vector < map <string, vector < vector<string> > > > & edge_attr_names_vector,
                                  size_t &local_num_nodes, size_t &local_num_edges, size_t &total_num_edges,
                                  hsize_t& total_read_blocks,
-                                 size_t offset, size_t numitems)
+                                 size_t offset, size_t numitems,
+                                 size_t batch_size)
     {
+      mpi::PhaseTimer timer("scatter_read_projection");
+
       // MPI Communicator for I/O ranks
       MPI_Comm io_comm;
       // MPI group color value used for I/O ranks
@@ -70,7 +340,7 @@ namespace neuroh5
       throw_assert_nomsg(MPI_Barrier(all_comm) == MPI_SUCCESS);
 
       set<size_t> io_rank_set;
-      data::range_sample(size, io_size, io_rank_set);
+      mpi::select_io_ranks(all_comm, io_size, io_rank_set);
       bool is_io_rank = (io_rank_set.find(rank) != io_rank_set.end());
 
       size_t io_rank_root = 0;
@@ -91,15 +361,43 @@ namespace neuroh5
         }
 
       vector<NODE_IDX_T> send_edges, recv_edges, total_recv_edges;
-      rank_edge_map_t prj_rank_edge_map;
-      edge_map_t prj_edge_map;
+      data::rank_edge_csr_t prj_rank_edge_csr;
+      data::EdgeCSR prj_edge_csr(edge_map_type);
       size_t num_edges = 0;
       map<string, vector< vector<string> > > edge_attr_names;
       
       local_num_nodes=0; local_num_edges=0;
-      
+
+      // the batched read covers all blocks of the projection; a range
+      // of blocks given with offset and numitems is read in one pass
+      if ((offset > 0) || (numitems > 0))
+        {
+          batch_size = 0;
+        }
+      else if (batch_size == 0)
+        {
+          batch_size = data::get_scatter_batch_size();
+        }
+
+      if (batch_size > 0)
+        {
+          scatter_read_projection_batched(all_comm, io_comm, is_io_rank, io_rank_root, batch_size,
+                                          edge_map_type, file_name, src_pop_name, dst_pop_name,
+                                          src_start, dst_start, attr_namespaces,
+                                          node_rank_map, pop_search_ranges, pop_pairs,
+                                          prj_edge_csr, edge_attr_names,
+                                          total_num_edges, total_read_blocks);
+          MPI_Comm_free(&io_comm);
+
+          prj_edge_csr.edge_map_type = edge_map_type;
+          local_num_nodes = prj_edge_csr.num_nodes();
+          local_num_edges = prj_edge_csr.num_edges();
+
+          bcast_edge_attr_names(all_comm, rank, attr_namespaces, edge_attr_names, edge_attr_names_vector);
+        }
+      else
       {
-        vector<char> recvbuf;
+        mpi::RecvBuffer<char> recvbuf;
         vector<size_t> recvcounts, rdispls;
 
         {
@@ -124,12 +422,15 @@ namespace neuroh5
               hsize_t local_read_blocks;
 
               mpi::MPI_DEBUG(io_comm, "scatter_read_projection: reading projection ", src_pop_name, " -> ", dst_pop_name);
-              throw_assert(hdf5::read_projection_datasets(io_comm, file_name, src_pop_name, dst_pop_name,
-                                                          block_base, edge_base,
-                                                          dst_blk_ptr, dst_idx, dst_ptr, src_idx,
-                                                          total_num_edges, total_read_blocks, local_read_blocks,
-                                                          offset, numitems * size) >= 0,
-                           "error in read_projection_datasets");
+              {
+                mpi::PhaseTimer timer("read_projection_datasets");
+                throw_assert(hdf5::read_projection_datasets(io_comm, file_name, src_pop_name, dst_pop_name,
+                                                            block_base, edge_base,
+                                                            dst_blk_ptr, dst_idx, dst_ptr, src_idx,
+                                                            total_num_edges, total_read_blocks, local_read_blocks,
+                                                            offset, numitems * size) >= 0,
+                             "error in read_projection_datasets");
+              }
           
               mpi::MPI_DEBUG(io_comm, "scatter_read_projection: validating projection ", src_pop_name, " -> ", dst_pop_name);
               // validate the edges
@@ -140,6 +441,7 @@ namespace neuroh5
               mpi::MPI_DEBUG(io_comm, "scatter_read_projection: reading attributes for ", src_pop_name, " -> ", dst_pop_name);
               for (const string& attr_namespace : attr_namespaces) 
                 {
+                  mpi::PhaseTimer timer("read_edge_attributes");
                   vector< pair<string,AttrKind> > edge_attr_info;
                   throw_assert_nomsg(graph::get_edge_attributes(io_comm, file_name, src_pop_name, dst_pop_name,
                                                                 attr_namespace, edge_attr_info) >= 0);
@@ -153,11 +455,14 @@ namespace neuroh5
                 }
 
               
-              // append to the edge map
-              throw_assert(data::append_rank_edge_map(rank, size, dst_start, src_start, dst_blk_ptr, dst_idx, dst_ptr, src_idx,
-                                                      attr_namespaces, edge_attr_map, node_rank_map, num_edges, prj_rank_edge_map,
-                                                      edge_map_type) >= 0,
-                           "error in append_rank_edge_map");
+              // append to the per-rank edge containers
+              {
+                mpi::PhaseTimer timer("append_rank_edge_map");
+                throw_assert(data::append_rank_edge_csr(rank, size, dst_start, src_start, dst_blk_ptr, dst_idx, dst_ptr, src_idx,
+                                                        attr_namespaces, edge_attr_map, node_rank_map, num_edges, prj_rank_edge_csr,
+                                                        edge_map_type) >= 0,
+                             "error in append_rank_edge_csr");
+              }
               
               mpi::MPI_DEBUG(io_comm, "scatter_read_projection: read ", num_edges,
                              " edges from projection ", src_pop_name, " -> ", dst_pop_name);
@@ -170,8 +475,11 @@ namespace neuroh5
           
               size_t num_packed_edges = 0;
           
-              data::serialize_rank_edge_map (size, rank, prj_rank_edge_map, 
-                                             num_packed_edges, sendcounts, sendbuf, sdispls);
+              {
+                mpi::PhaseTimer timer("serialize_edges");
+                data::serialize_rank_edge_csr (size, rank, prj_rank_edge_csr, 
+                                               num_packed_edges, sendcounts, sendbuf, sdispls);
+              }
 
               // ensure the correct number of edges is being packed
               throw_assert_nomsg(num_packed_edges == num_edges);
@@ -182,72 +490,79 @@ namespace neuroh5
 
           
           MPI_Comm_free(&io_comm);
-          MPI_Request bcast_req;
+          MPI_Request bcast_req[2];
           throw_assert(MPI_Ibcast(&total_read_blocks, 1, MPI_SIZE_T, io_rank_root, all_comm,
-                                  &bcast_req) == MPI_SUCCESS,
+                                  &bcast_req[0]) == MPI_SUCCESS,
                        "error in MPI_Ibcast");
-          throw_assert(MPI_Wait(&bcast_req, MPI_STATUS_IGNORE) == MPI_SUCCESS,
-                       "error in MPI_Wait");
+          throw_assert(MPI_Ibcast(&total_num_edges, 1, MPI_SIZE_T, io_rank_root, all_comm,
+                                  &bcast_req[1]) == MPI_SUCCESS,
+                       "error in MPI_Ibcast");
+          throw_assert(MPI_Waitall(2, bcast_req, MPI_STATUSES_IGNORE) == MPI_SUCCESS,
+                       "error in MPI_Waitall");
 
-          throw_assert_nomsg(mpi::alltoallv_vector<char>(all_comm, MPI_CHAR, sendcounts, sdispls, sendbuf,
-                                                         recvcounts, rdispls, recvbuf) >= 0);
+          // only the I/O ranks have data to send
+          mpi::PhaseTimer timer("alltoallv");
+          throw_assert_nomsg(mpi::scatter_alltoallv_vector<char>(all_comm, MPI_CHAR, sendcounts, sdispls, sendbuf,
+                                                                 recvcounts, rdispls, recvbuf) >= 0);
         }
 
         mpi::MPI_DEBUG(all_comm, "scatter_read_projection: recvbuf size is ", recvbuf.size());
 
         if (recvbuf.size() > 0)
           {
-            data::deserialize_rank_edge_map (size, recvbuf, recvcounts, rdispls, 
-                                             prj_edge_map, local_num_nodes, local_num_edges);
+            mpi::PhaseTimer timer("deserialize_edges");
+            data::deserialize_rank_edge_csr (size, recvbuf.data(), recvbuf.size(), recvcounts, rdispls, 
+                                             prj_edge_csr, local_num_nodes, local_num_edges);
           }
+        recvbuf.free();
+        prj_edge_csr.edge_map_type = edge_map_type;
 
-        mpi::MPI_DEBUG(all_comm, "scatter_read_projection: prj_edge_map size is ", prj_edge_map.size());
+        mpi::MPI_DEBUG(all_comm, "scatter_read_projection: prj_edge_csr size is ", prj_edge_csr.num_nodes());
         
-        if (!attr_namespaces.empty())
-          {
-            vector<char> sendbuf; uint32_t sendbuf_size=0;
-            if (rank == 0)
-              {
-                data::serialize_data(edge_attr_names, sendbuf);
-                sendbuf_size = sendbuf.size();
-              }
-            
-            MPI_Request bcast_req;
-
-            throw_assert_nomsg(MPI_Barrier(all_comm) == MPI_SUCCESS);
-            throw_assert(MPI_Ibcast(&sendbuf_size, 1, MPI_UINT32_T, 0, all_comm,
-                                    &bcast_req) == MPI_SUCCESS,
-                         "error in MPI_Ibcast");
-            throw_assert(MPI_Wait(&bcast_req, MPI_STATUS_IGNORE) == MPI_SUCCESS,
-                         "error in MPI_Wait");
-            sendbuf.resize(sendbuf_size);
-            throw_assert(MPI_Ibcast(&sendbuf[0], sendbuf_size, MPI_CHAR, 0, all_comm,
-                                    &bcast_req) == MPI_SUCCESS,
-                         "error in MPI_Ibcast");
-            throw_assert(MPI_Wait(&bcast_req, MPI_STATUS_IGNORE) == MPI_SUCCESS,
-                         "error in MPI_Wait");
-
-            mpi::MPI_DEBUG(all_comm, "scatter_read_projection: sendbuf size is ", sendbuf_size);
-            
-            if (rank != 0)
-              {
-                data::deserialize_data(sendbuf, edge_attr_names);
-              }
-            edge_attr_names_vector.push_back(edge_attr_names);
-            
-            mpi::MPI_DEBUG(all_comm, "scatter_read_projection: deserialized edge attr names");
-          }
+        bcast_edge_attr_names(all_comm, rank, attr_namespaces, edge_attr_names, edge_attr_names_vector);
       }
 
       
       mpi::MPI_DEBUG(all_comm, "scatter_read_projection: unpacked ", local_num_edges,
                      " edges for projection ", src_pop_name, " -> ", dst_pop_name);
       
-      prj_vector.push_back(prj_edge_map);
+      prj_vector.push_back(std::move(prj_edge_csr));
 
       return 0;
     }
 
+    
+    int scatter_read_projection (MPI_Comm all_comm, const int io_size, EdgeMapType edge_map_type, 
+                                 const string& file_name, const string& src_pop_name, const string& dst_pop_name, 
+                                 const NODE_IDX_T& src_start,
+                                 const NODE_IDX_T& dst_start,
+                                 const vector<string> &attr_namespaces,
+                                 const node_rank_map_t&  node_rank_map,
+                                 const pop_search_range_map_t& pop_search_ranges,
+                                 const set< pair<pop_t, pop_t> >& pop_pairs,
+                                 vector < edge_map_t >& prj_vector,
+                                 vector < map <string, vector < vector<string> > > > & edge_attr_names_vector,
+                                 size_t &local_num_nodes, size_t &local_num_edges, size_t &total_num_edges,
+                                 hsize_t& total_read_blocks,
+                                 size_t offset, size_t numitems,
+                                 size_t batch_size)
+    {
+      vector < data::EdgeCSR > prj_csr_vector;
+      int status = scatter_read_projection (all_comm, io_size, edge_map_type,
+                                            file_name, src_pop_name, dst_pop_name,
+                                            src_start, dst_start, attr_namespaces,
+                                            node_rank_map, pop_search_ranges, pop_pairs,
+                                            prj_csr_vector, edge_attr_names_vector,
+                                            local_num_nodes, local_num_edges, total_num_edges,
+                                            total_read_blocks, offset, numitems, batch_size);
+      for (const data::EdgeCSR& prj_edge_csr : prj_csr_vector)
+        {
+          prj_vector.emplace_back();
+          prj_edge_csr.to_edge_map(prj_vector.back());
+        }
+      return status;
+    }
+
 
   }
   
@@ -18,7 +18,7 @@
 #include "serialize_edge.hh"
 #include "serialize_data.hh"
 #include "alltoallv_template.hh"
-#include "range_sample.hh"
+#include "io_rank_set.hh"
 #include "throw_assert.hh"
 #include "mpi_debug.hh"
 #include "debug.hh"
@@ -72,7 +72,7 @@ namespace neuroh5
       throw_assert(MPI_Comm_rank(comm, &rank) == MPI_SUCCESS, "unable to obtain MPI communicator rank");
 
       set<size_t> io_rank_set;
-      data::range_sample(size, io_size, io_rank_set);
+      mpi::select_io_ranks(comm, io_size, io_rank_set);
       bool is_io_rank = (io_rank_set.find(rank) != io_rank_set.end());
 
       // Am I an I/O rank?
@@ -16,11 +16,14 @@
 #include "cell_populations.hh"
 #include "write_graph.hh"
 #include "write_projection.hh"
+#include "exchange_edge_csr.hh"
+#include "projection_edge_index.hh"
 #include "path_names.hh"
 #include "sort_permutation.hh"
 #include "serialize_edge.hh"
 #include "range_sample.hh"
 #include "node_rank_map.hh"
+#include "phase_stats.hh"
 #include "throw_assert.hh"
 #include "debug.hh"
 
@@ -34,45 +37,99 @@ namespace neuroh5
 {
   namespace graph
   {
-    
-    int write_graph
+
+    // Writes the edges received by the I/O ranks, as an edge map or as
+    // CSR rows, to a new projection
+    template <class Edges>
+    static void write_received_edges
     (
      MPI_Comm         all_comm,
-     const int        io_size_arg,
+     const bool       is_io_rank,
      const string&    file_name,
      const string&    src_pop_name,
      const string&    dst_pop_name,
+     const size_t     src_start,
+     const size_t     src_end,
+     const size_t     dst_start,
+     const size_t     dst_end,
+     const size_t     num_unpacked_edges,
+     const Edges&     prj_edges,
      const std::map <std::string, std::pair <size_t, data::AttrIndex > >& edge_attr_index,
-     const edge_map_t&  input_edge_map,
-     const hsize_t    chunk_size
+     const hsize_t    chunk_size,
+     const hdf5::DatasetCreationPolicy& dataset_policy,
+     const bool       edge_index
      )
     {
-      size_t io_size;
-      size_t num_edges = 0;
+      int rank;
+      throw_assert_nomsg(MPI_Comm_rank(all_comm, &rank) == MPI_SUCCESS);
+
+      // Create an I/O communicator
+      MPI_Comm  io_comm;
+      // MPI group color value used for I/O ranks
+      int io_color = 1;
+      if (is_io_rank)
+        {
+          MPI_Comm_split(all_comm,io_color,rank,&io_comm);
+          MPI_Comm_set_errhandler(io_comm, MPI_ERRORS_RETURN);
+        }
+      else
+        {
+          MPI_Comm_split(all_comm,0,rank,&io_comm);
+        }
+
       
+      if (is_io_rank)
+        {
+          mpi::PhaseTimer timer("write_projection");
+          hid_t fapl = H5Pcreate(H5P_FILE_ACCESS);
+          throw_assert_nomsg(fapl >= 0);
+#ifdef HDF5_IS_PARALLEL
+          throw_assert_nomsg(H5Pset_fapl_mpio(fapl, io_comm, MPI_INFO_NULL) >= 0);
+#endif
+          
+          hid_t file = H5Fopen(file_name.c_str(), H5F_ACC_RDWR, fapl);
+          throw_assert_nomsg(file >= 0);
+          
+          write_projection (io_comm, file, src_pop_name, dst_pop_name,
+                            src_start, src_end, dst_start, dst_end,
+                            num_unpacked_edges, prj_edges, edge_attr_index,
+                            chunk_size, 1000000, true, dataset_policy);
+
+          if (edge_index)
+            {
+              hdf5::write_projection_edge_index(io_comm, file, src_pop_name, dst_pop_name,
+                                                chunk_size, dataset_policy);
+            }
+          
+          throw_assert_nomsg(H5Fclose(file) >= 0);
+          throw_assert_nomsg(H5Pclose(fapl) >= 0);
+          throw_assert_nomsg(MPI_Barrier(io_comm) == MPI_SUCCESS);
+        }
+
+      throw_assert_nomsg(MPI_Comm_free(&io_comm) == MPI_SUCCESS);
+    }
+
+
+    // Reads the node ranges of the source and destination populations
+    static void projection_node_ranges
+    (
+     MPI_Comm         all_comm,
+     const string&    file_name,
+     const string&    src_pop_name,
+     const string&    dst_pop_name,
+     size_t&          src_start,
+     size_t&          src_end,
+     size_t&          dst_start,
+     size_t&          dst_end
+     )
+    {
       // read the population info
       set< pair<pop_t, pop_t> > pop_pairs;
       pop_range_map_t pop_ranges;
       pop_label_map_t pop_labels;
       size_t src_pop_idx, dst_pop_idx; bool src_pop_set=false, dst_pop_set=false;
       size_t total_num_nodes=0;
-      size_t dst_start, dst_end;
-      size_t src_start, src_end;
-
-      auto compare_nodes = [](const NODE_IDX_T& a, const NODE_IDX_T& b) { return (a < b); };
-
-      int size, rank;
-      throw_assert_nomsg(MPI_Comm_size(all_comm, &size) == MPI_SUCCESS);
-      throw_assert_nomsg(MPI_Comm_rank(all_comm, &rank) == MPI_SUCCESS);
 
-      if (size < io_size_arg)
-        {
-          io_size = size > 0 ? size : 1;
-        }
-      else
-        {
-          io_size = io_size_arg > 0 ? io_size_arg : 1;
-        }
       //FIXME: throw_assert_nomsg(io::hdf5::read_population_combos(comm, file_name, pop_pairs) >= 0);
       throw_assert_nomsg(cell::read_population_ranges(all_comm, file_name, pop_ranges, total_num_nodes) >= 0);
       throw_assert_nomsg(cell::read_population_labels(all_comm, file_name, pop_labels) >= 0);
@@ -96,6 +153,48 @@ namespace neuroh5
       dst_end   = dst_start + pop_ranges[dst_pop_idx].count;
       src_start = pop_ranges[src_pop_idx].start;
       src_end   = src_start + pop_ranges[src_pop_idx].count;
+    }
+
+    
+    int write_graph
+    (
+     MPI_Comm         all_comm,
+     const int        io_size_arg,
+     const string&    file_name,
+     const string&    src_pop_name,
+     const string&    dst_pop_name,
+     const std::map <std::string, std::pair <size_t, data::AttrIndex > >& edge_attr_index,
+     const edge_map_t&  input_edge_map,
+     const hsize_t    chunk_size,
+     const hdf5::DatasetCreationPolicy& dataset_policy,
+     const bool       edge_index
+     )
+    {
+      mpi::PhaseTimer timer("write_graph");
+
+      size_t io_size;
+      size_t num_edges = 0;
+      
+      size_t total_num_nodes=0;
+      size_t dst_start, dst_end;
+      size_t src_start, src_end;
+
+      auto compare_nodes = [](const NODE_IDX_T& a, const NODE_IDX_T& b) { return (a < b); };
+
+      int size, rank;
+      throw_assert_nomsg(MPI_Comm_size(all_comm, &size) == MPI_SUCCESS);
+      throw_assert_nomsg(MPI_Comm_rank(all_comm, &rank) == MPI_SUCCESS);
+
+      if (size < io_size_arg)
+        {
+          io_size = size > 0 ? size : 1;
+        }
+      else
+        {
+          io_size = io_size_arg > 0 ? io_size_arg : 1;
+        }
+      projection_node_ranges(all_comm, file_name, src_pop_name, dst_pop_name,
+                             src_start, src_end, dst_start, dst_end);
 
       vector< NODE_IDX_T > local_node_index;
       for (auto iter: input_edge_map)
@@ -220,12 +319,18 @@ namespace neuroh5
       // Create serialized object with the edges of vertices for the respective I/O rank
       size_t num_packed_edges = 0; 
 
-      data::serialize_rank_edge_map (size, rank, rank_edge_map, num_packed_edges,
-                                     sendcounts, sendbuf, sdispls);
+      {
+        mpi::PhaseTimer timer("serialize_edges");
+        data::serialize_rank_edge_map (size, rank, rank_edge_map, num_packed_edges,
+                                       sendcounts, sendbuf, sdispls);
+      }
       rank_edge_map.clear();
 
-      throw_assert_nomsg(mpi::alltoallv_vector<char>(all_comm, MPI_CHAR, sendcounts, sdispls, sendbuf,
-                                                     recvcounts, rdispls, recvbuf) >= 0);
+      {
+        mpi::PhaseTimer timer("alltoallv");
+        throw_assert_nomsg(mpi::alltoallv_vector<char>(all_comm, MPI_CHAR, sendcounts, sdispls, sendbuf,
+                                                       recvcounts, rdispls, recvbuf) >= 0);
+      }
       sendbuf.clear();
       sendbuf.shrink_to_fit();
       sendcounts.clear();
@@ -235,6 +340,7 @@ namespace neuroh5
       edge_map_t prj_edge_map;
       if (recvbuf.size() > 0)
         {
+          mpi::PhaseTimer timer("deserialize_edges");
           data::deserialize_rank_edge_map (size, recvbuf, recvcounts, rdispls, 
                                            prj_edge_map, num_unpacked_nodes,
                                            num_unpacked_edges);
@@ -244,44 +350,69 @@ namespace neuroh5
       recvcounts.clear();
       rdispls.clear();
 
-      
-      // Create an I/O communicator
-      MPI_Comm  io_comm;
-      // MPI group color value used for I/O ranks
-      int io_color = 1;
-      if (is_io_rank)
+      write_received_edges(all_comm, is_io_rank, file_name, src_pop_name, dst_pop_name,
+                           src_start, src_end, dst_start, dst_end,
+                           num_unpacked_edges, prj_edge_map, edge_attr_index,
+                           chunk_size, dataset_policy, edge_index);
+      MPI_Barrier(all_comm);
+
+      return 0;
+    }
+
+
+    int write_graph
+    (
+     MPI_Comm         all_comm,
+     const int        io_size_arg,
+     const string&    file_name,
+     const string&    src_pop_name,
+     const string&    dst_pop_name,
+     const std::map <std::string, std::pair <size_t, data::AttrIndex > >& edge_attr_index,
+     const data::EdgeCSR& input_edges,
+     const hsize_t    chunk_size,
+     const hdf5::DatasetCreationPolicy& dataset_policy,
+     const bool       edge_index
+     )
+    {
+      mpi::PhaseTimer timer("write_graph");
+
+      int size, rank;
+      throw_assert_nomsg(MPI_Comm_size(all_comm, &size) == MPI_SUCCESS);
+      throw_assert_nomsg(MPI_Comm_rank(all_comm, &rank) == MPI_SUCCESS);
+
+      size_t io_size;
+      if (size < io_size_arg)
         {
-          MPI_Comm_split(all_comm,io_color,rank,&io_comm);
-          MPI_Comm_set_errhandler(io_comm, MPI_ERRORS_RETURN);
+          io_size = size > 0 ? size : 1;
         }
       else
         {
-          MPI_Comm_split(all_comm,0,rank,&io_comm);
+          io_size = io_size_arg > 0 ? io_size_arg : 1;
         }
 
-      
-      if (is_io_rank)
+      size_t dst_start, dst_end, src_start, src_end;
+      projection_node_ranges(all_comm, file_name, src_pop_name, dst_pop_name,
+                             src_start, src_end, dst_start, dst_end);
+
+      set<size_t> io_rank_set;
+      data::range_sample(size, io_size, io_rank_set);
+      bool is_io_rank = (io_rank_set.find(rank) != io_rank_set.end());
+
+      size_t total_num_nodes = 0;
+      data::EdgeCSR prj_edges;
+      exchange_edge_csr(all_comm, io_rank_set, src_start, src_end, dst_start, dst_end,
+                        input_edges, total_num_nodes, prj_edges);
+      if (total_num_nodes == 0)
         {
-          hid_t fapl = H5Pcreate(H5P_FILE_ACCESS);
-          throw_assert_nomsg(fapl >= 0);
-#ifdef HDF5_IS_PARALLEL
-          throw_assert_nomsg(H5Pset_fapl_mpio(fapl, io_comm, MPI_INFO_NULL) >= 0);
-#endif
-          
-          hid_t file = H5Fopen(file_name.c_str(), H5F_ACC_RDWR, fapl);
-          throw_assert_nomsg(file >= 0);
-          
-          write_projection (io_comm, file, src_pop_name, dst_pop_name,
-                            src_start, src_end, dst_start, dst_end,
-                            num_unpacked_edges, prj_edge_map, edge_attr_index,
-                            chunk_size);
-          
-          throw_assert_nomsg(H5Fclose(file) >= 0);
-          throw_assert_nomsg(H5Pclose(fapl) >= 0);
-          throw_assert_nomsg(MPI_Barrier(io_comm) == MPI_SUCCESS);
+          throw_assert_nomsg(MPI_Barrier(all_comm) == MPI_SUCCESS);
+          return 0;
         }
 
-      throw_assert_nomsg(MPI_Comm_free(&io_comm) == MPI_SUCCESS);
+      const size_t num_unpacked_edges = prj_edges.num_edges();
+      write_received_edges(all_comm, is_io_rank, file_name, src_pop_name, dst_pop_name,
+                           src_start, src_end, dst_start, dst_end,
+                           num_unpacked_edges, prj_edges, edge_attr_index,
+                           chunk_size, dataset_policy, edge_index);
       MPI_Barrier(all_comm);
 
       return 0;
@@ -4,7 +4,10 @@
 #include "neuroh5_types.hh"
 #include "path_names.hh"
 #include "write_projection.hh"
+#include "edge_csr.hh"
+#include "dataset_creation.hh"
 #include "write_template.hh"
+#include "phase_stats.hh"
 #include "edge_attributes.hh"
 #include "throw_assert.hh"
 
@@ -35,7 +38,36 @@ namespace neuroh5
      const std::map <std::string, std::pair <size_t, data::AttrIndex > >& edge_attr_index,
      hsize_t                   chunk_size,
      hsize_t                   block_size,
-     const bool collective
+     const bool collective,
+     const hdf5::DatasetCreationPolicy& dataset_policy
+     )
+    {
+      data::EdgeCSR prj_edges;
+      prj_edges.from_edge_map(prj_edge_map);
+      write_projection(comm, file, src_pop_name, dst_pop_name,
+                       src_start, src_end, dst_start, dst_end,
+                       num_edges, prj_edges, edge_attr_index,
+                       chunk_size, block_size, collective, dataset_policy);
+    }
+
+
+    void write_projection
+    (
+     MPI_Comm                  comm,
+     hid_t                     file,
+     const string&             src_pop_name,
+     const string&             dst_pop_name,
+     const NODE_IDX_T&         src_start,
+     const NODE_IDX_T&         src_end,
+     const NODE_IDX_T&         dst_start,
+     const NODE_IDX_T&         dst_end,
+     const size_t&             num_edges,
+     const data::EdgeCSR&      prj_edges,
+     const std::map <std::string, std::pair <size_t, data::AttrIndex > >& edge_attr_index,
+     hsize_t                   chunk_size,
+     hsize_t                   block_size,
+     const bool collective,
+     const hdf5::DatasetCreationPolicy& dataset_policy
      )
     {
       // do a sanity check on the input
@@ -49,26 +81,25 @@ namespace neuroh5
       size = (size_t)ssize;
       rank = (size_t)srank;
         
-      size_t num_dest = prj_edge_map.size();
+      size_t num_dest = prj_edges.num_nodes();
       size_t num_blocks = num_dest > 0 ? 1 : 0;
         
-      // create relative destination pointers and source index
+      // create relative destination pointers; the source index is the
+      // adjacency array of the rows
       vector<DST_BLK_PTR_T> dst_blk_ptr; 
       vector<DST_PTR_T> dst_ptr;
-      vector<NODE_IDX_T> dst_blk_idx, src_idx;
-      NODE_IDX_T first_idx = 0, last_idx = 0;
-      hsize_t num_block_edges = 0, num_prj_edges = 0;
-      if (!prj_edge_map.empty())
+      vector<NODE_IDX_T> dst_blk_idx;
+      const vector<NODE_IDX_T>& src_idx = prj_edges.adj;
+      NODE_IDX_T last_idx = 0;
+      hsize_t num_block_edges = 0;
+      if (num_dest > 0)
         {
-          first_idx = (prj_edge_map.begin())->first;
-          last_idx  = first_idx;
-          dst_blk_idx.push_back(first_idx - dst_start);
+          last_idx = prj_edges.keys[0];
+          dst_blk_idx.push_back(last_idx - dst_start);
           dst_blk_ptr.push_back(0);
-          for (auto iter = prj_edge_map.begin(); iter != prj_edge_map.end(); ++iter)
+          for (size_t i = 0; i < num_dest; i++)
             {
-              NODE_IDX_T dst = iter->first;
-              edge_tuple_t et = iter->second;
-              vector<NODE_IDX_T> &v = get<0>(et);
+              NODE_IDX_T dst = prj_edges.keys[i];
               
               // creates new block if non-contiguous dst indices
               if (((dst > 0) && ((dst-1) > last_idx)) || (num_block_edges > block_size))
@@ -80,13 +111,11 @@ namespace neuroh5
                 }
               last_idx = dst;
               
-              copy(v.begin(), v.end(), back_inserter(src_idx));
-              dst_ptr.push_back(num_prj_edges);
-              num_prj_edges += v.size();
-              num_block_edges += v.size();
+              dst_ptr.push_back(prj_edges.row_begin(i));
+              num_block_edges += prj_edges.row_size(i);
             }
         }
-      dst_ptr.push_back(num_prj_edges);
+      dst_ptr.push_back(prj_edges.num_edges());
       throw_assert_nomsg(num_edges == src_idx.size());
 
       
@@ -127,9 +156,7 @@ namespace neuroh5
       throw_assert_nomsg(H5Pset_create_intermediate_group(lcpl, 1) >= 0);
 
       /* Dataset creation property list to enable chunking */
-      hid_t dcpl = H5Pcreate(H5P_DATASET_CREATE);
-      throw_assert_nomsg(dcpl >= 0);
-      hsize_t chunk = chunk_size;
+      hid_t dcpl;
 
       hid_t wapl = H5P_DEFAULT;
 #ifdef HDF5_IS_PARALLEL
@@ -168,20 +195,12 @@ namespace neuroh5
       hsize_t dst_blk_idx_dims = (hsize_t)total_num_blocks, one = 1;
       hid_t fspace = H5Screate_simple(1, &dst_blk_idx_dims, &dst_blk_idx_dims);
       throw_assert_nomsg(fspace >= 0);
-      if (chunk < dst_blk_idx_dims)
-        {
-          throw_assert_nomsg(H5Pset_chunk(dcpl, 1, &chunk ) >= 0);
-        }
-      else
-        {
-          throw_assert_nomsg(H5Pset_chunk(dcpl, 1, &dst_blk_idx_dims ) >= 0);
-        }
-#ifdef H5_HAS_PARALLEL_DEFLATE
-      throw_assert_nomsg(H5Pset_deflate(dcpl, 9) >= 0);
-#endif
+      dcpl = hdf5::create_dataset_creation_plist(dataset_policy, hdf5::DatasetIndex,
+                                                 chunk_size, dst_blk_idx_dims);
       hid_t dset = H5Dcreate2(file, path.c_str(), NODE_IDX_H5_FILE_T, fspace,
                               lcpl, dcpl, H5P_DEFAULT);
       throw_assert_nomsg(dset >= 0);
+      throw_assert_nomsg(H5Pclose(dcpl) >= 0);
       block = num_blocks;
       hid_t mspace = H5Screate_simple(1, &block, &block);
       throw_assert_nomsg(mspace >= 0);
@@ -202,6 +221,7 @@ namespace neuroh5
         }
       throw_assert_nomsg(H5Dwrite(dset, NODE_IDX_H5_NATIVE_T, mspace, fspace,
 		      wapl, &dst_blk_idx[0]) >= 0);
+      mpi::count_write(block * sizeof(dst_blk_idx[0]));
 
       throw_assert_nomsg(H5Dclose(dset) >= 0);
       throw_assert_nomsg(H5Sclose(mspace) >= 0);
@@ -227,20 +247,12 @@ namespace neuroh5
       hsize_t dst_blk_ptr_dims = (hsize_t)total_num_blocks+1;
       fspace = H5Screate_simple(1, &dst_blk_ptr_dims, &dst_blk_ptr_dims);
       throw_assert_nomsg(fspace >= 0);
-      if (chunk < dst_blk_ptr_dims)
-        {
-          throw_assert_nomsg(H5Pset_chunk(dcpl, 1, &chunk ) >= 0);
-        }
-      else
-        {
-          throw_assert_nomsg(H5Pset_chunk(dcpl, 1, &dst_blk_ptr_dims ) >= 0);
-        }
-#ifdef H5_HAS_PARALLEL_DEFLATE
-      throw_assert_nomsg(H5Pset_deflate(dcpl, 9) >= 0);
-#endif
+      dcpl = hdf5::create_dataset_creation_plist(dataset_policy, hdf5::DatasetPointer,
+                                                 chunk_size, dst_blk_ptr_dims);
       dset = H5Dcreate2(file, path.c_str(), DST_BLK_PTR_H5_FILE_T,
                         fspace, lcpl, dcpl, H5P_DEFAULT);
       throw_assert_nomsg(dset >= 0);
+      throw_assert_nomsg(H5Pclose(dcpl) >= 0);
       if (rank == last_rank)
         {
           block = num_blocks+1;
@@ -270,6 +282,7 @@ namespace neuroh5
         }
       throw_assert_nomsg(H5Dwrite(dset, DST_BLK_PTR_H5_NATIVE_T, mspace, fspace,
                       wapl, &dst_blk_ptr[0]) >= 0);
+      mpi::count_write(block * sizeof(dst_blk_ptr[0]));
 
       throw_assert_nomsg(H5Dclose(dset) >= 0);
       throw_assert_nomsg(H5Sclose(mspace) >= 0);
@@ -304,20 +317,12 @@ namespace neuroh5
 
       fspace = H5Screate_simple(1, &dst_ptr_dims, &dst_ptr_dims);
       throw_assert_nomsg(fspace >= 0);
-      if (chunk < dst_ptr_dims)
-        {
-          throw_assert_nomsg(H5Pset_chunk(dcpl, 1, &chunk ) >= 0);
-        }
-      else
-        {
-          throw_assert_nomsg(H5Pset_chunk(dcpl, 1, &dst_ptr_dims ) >= 0);
-        }
-#ifdef H5_HAS_PARALLEL_DEFLATE
-      throw_assert_nomsg(H5Pset_deflate(dcpl, 9) >= 0);
-#endif
+      dcpl = hdf5::create_dataset_creation_plist(dataset_policy, hdf5::DatasetPointer,
+                                                 chunk_size, dst_ptr_dims);
       dset = H5Dcreate2(file, path.c_str(), DST_PTR_H5_FILE_T,
                         fspace, lcpl, dcpl, H5P_DEFAULT);
       throw_assert_nomsg(dset >= 0);
+      throw_assert_nomsg(H5Pclose(dcpl) >= 0);
       block = (hsize_t) dst_ptr.size();
       mspace = H5Screate_simple(1, &block, &block);
       throw_assert_nomsg(mspace >= 0);
@@ -335,6 +340,7 @@ namespace neuroh5
 
       throw_assert_nomsg(H5Dwrite(dset, DST_PTR_H5_NATIVE_T, mspace, fspace,
                       wapl, &dst_ptr[0]) >= 0);
+      mpi::count_write(block * sizeof(dst_ptr[0]));
 
       throw_assert_nomsg(H5Dclose(dset) >= 0);
       throw_assert_nomsg(H5Sclose(mspace) >= 0);
@@ -352,20 +358,12 @@ namespace neuroh5
 
       fspace = H5Screate_simple(1, &src_idx_dims, &src_idx_dims);
       throw_assert_nomsg(fspace >= 0);
-      if (chunk < src_idx_dims)
-        {
-          throw_assert_nomsg(H5Pset_chunk(dcpl, 1, &chunk ) >= 0);
-        }
-      else
-        {
-          throw_assert_nomsg(H5Pset_chunk(dcpl, 1, &src_idx_dims ) >= 0);
-        }
-#ifdef H5_HAS_PARALLEL_DEFLATE
-      throw_assert_nomsg(H5Pset_deflate(dcpl, 9) >= 0);
-#endif
+      dcpl = hdf5::create_dataset_creation_plist(dataset_policy, hdf5::DatasetValue,
+                                                 chunk_size, src_idx_dims);
       dset = H5Dcreate2(file, path.c_str(), NODE_IDX_H5_FILE_T,
                         fspace, lcpl, dcpl, H5P_DEFAULT);
       throw_assert_nomsg(dset >= 0);
+      throw_assert_nomsg(H5Pclose(dcpl) >= 0);
 
       block = (hsize_t) src_idx.size();
       mspace = H5Screate_simple(1, &block, &block);
@@ -384,6 +382,7 @@ namespace neuroh5
 
       throw_assert_nomsg(H5Dwrite(dset, NODE_IDX_H5_NATIVE_T, mspace, fspace,
                       wapl, &src_idx[0]) >= 0);
+      mpi::count_write(block * sizeof(src_idx[0]));
 
       throw_assert_nomsg(H5Dclose(dset) >= 0);
       throw_assert_nomsg(H5Sclose(mspace) >= 0);
@@ -414,43 +413,37 @@ namespace neuroh5
         }
         
       
-      for (auto const& iter : prj_edge_map)
-	{
-	  const edge_tuple_t& et = iter.second;
-          const vector<NODE_IDX_T>& v = get<0>(et);
-          const vector<data::AttrVal>& a = get<1>(et);
-	  if (v.size() > 0)
-	    {
-              size_t ni=0;
-              for (auto & attr_values : a)
-                {
-                  throw_assert_nomsg(ni < edge_attr_name_spaces.size());
-                  const string & attr_namespace = edge_attr_name_spaces[ni];
-                  edge_attr_map[attr_namespace].append(attr_values);
-                  ni++;
-                }
-            }
-	}
+      for (size_t ni = 0; ni < prj_edges.attrs.size(); ni++)
+        {
+          throw_assert_nomsg(ni < edge_attr_name_spaces.size());
+          edge_attr_map[edge_attr_name_spaces[ni]].append(prj_edges.attrs[ni]);
+        }
 
       throw_assert_nomsg(MPI_Barrier(comm) == MPI_SUCCESS);
 
       write_edge_attribute_map<float>(comm, file, src_pop_name, dst_pop_name,
-                                      edge_attr_map, edge_attr_index);
+                                      edge_attr_map, edge_attr_index,
+                                      chunk_size, dataset_policy);
       write_edge_attribute_map<uint8_t>(comm, file, src_pop_name, dst_pop_name,
-                                        edge_attr_map, edge_attr_index);
+                                        edge_attr_map, edge_attr_index,
+                                        chunk_size, dataset_policy);
       write_edge_attribute_map<uint16_t>(comm, file, src_pop_name, dst_pop_name,
-                                         edge_attr_map, edge_attr_index);
+                                         edge_attr_map, edge_attr_index,
+                                         chunk_size, dataset_policy);
       write_edge_attribute_map<uint32_t>(comm, file, src_pop_name, dst_pop_name,
-                                         edge_attr_map, edge_attr_index);
+                                         edge_attr_map, edge_attr_index,
+                                         chunk_size, dataset_policy);
       write_edge_attribute_map<int8_t>(comm, file, src_pop_name, dst_pop_name,
-                                       edge_attr_map, edge_attr_index);
+                                       edge_attr_map, edge_attr_index,
+                                       chunk_size, dataset_policy);
       write_edge_attribute_map<int16_t>(comm, file, src_pop_name, dst_pop_name,
-                                        edge_attr_map, edge_attr_index);
+                                        edge_attr_map, edge_attr_index,
+                                        chunk_size, dataset_policy);
       write_edge_attribute_map<int32_t>(comm, file, src_pop_name, dst_pop_name,
-                                        edge_attr_map, edge_attr_index);
+                                        edge_attr_map, edge_attr_index,
+                                        chunk_size, dataset_policy);
       
       // clean-up
-      throw_assert_nomsg(H5Pclose(dcpl) >= 0);
       throw_assert_nomsg(H5Pclose(lcpl) >= 0);
       throw_assert_nomsg(H5Pclose(wapl) >= 0);
 
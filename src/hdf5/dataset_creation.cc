@@ -0,0 +1,72 @@
+// -*- mode: c++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+//==============================================================================
+///  @file dataset_creation.cc
+///
+///  Chunking and filter settings for the datasets created by the writers.
+///
+///  Copyright (C) 2016-2025 Project NeuroH5.
+//==============================================================================
+
+#include <hdf5.h>
+
+#include <algorithm>
+
+#include "neuroh5_types.hh"
+#include "dataset_creation.hh"
+#include "throw_assert.hh"
+
+namespace neuroh5
+{
+  namespace hdf5
+  {
+
+    hid_t create_dataset_creation_plist
+    (
+     const DatasetCreationPolicy& policy,
+     const DatasetRole            role,
+     const hsize_t                chunk_size,
+     const hsize_t                max_chunk_size
+     )
+    {
+      throw_assert(policy.deflate_level <= 9,
+                   "create_dataset_creation_plist: invalid deflate level " << policy.deflate_level);
+
+      hid_t dcpl = H5Pcreate(H5P_DATASET_CREATE);
+      throw_assert(dcpl >= 0,
+                   "create_dataset_creation_plist: unable to create dataset creation property list");
+      throw_assert(H5Pset_layout(dcpl, H5D_CHUNKED) >= 0,
+                   "create_dataset_creation_plist: unable to set chunked layout");
+
+      hsize_t chunk = policy.chunk_size(role, chunk_size);
+      if (max_chunk_size > 0)
+        {
+          chunk = std::min(chunk, max_chunk_size);
+        }
+      chunk = std::max(chunk, (hsize_t)1);
+      throw_assert(H5Pset_chunk(dcpl, 1, &chunk) >= 0,
+                   "create_dataset_creation_plist: unable to set chunk size " << chunk);
+
+#ifdef H5_HAS_PARALLEL_DEFLATE
+      // filters are applied in order: shuffle, deflate, checksum
+      if (policy.shuffle)
+        {
+          throw_assert(H5Pset_shuffle(dcpl) >= 0,
+                       "create_dataset_creation_plist: unable to add shuffle filter");
+        }
+      if (policy.deflate_level >= 0)
+        {
+          throw_assert(H5Pset_deflate(dcpl, policy.deflate_level) >= 0,
+                       "create_dataset_creation_plist: unable to add deflate filter");
+        }
+      if (policy.fletcher32)
+        {
+          throw_assert(H5Pset_fletcher32(dcpl) >= 0,
+                       "create_dataset_creation_plist: unable to add Fletcher32 filter");
+        }
+#endif
+
+      return dcpl;
+    }
+
+  }
+}
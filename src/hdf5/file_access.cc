@@ -3,6 +3,7 @@
 #include <string>
 #include <vector>
 #include "throw_assert.hh"
+#include "file_session.hh"
 
 namespace neuroh5
 {
@@ -21,6 +22,24 @@ namespace neuroh5
      const size_t cache_size = 1*1024*1024
      )
     {
+      // reuse the file of an open session, if there is one that can be
+      // used by the caller
+      FileSession* session = collective ?
+        FileSession::find(comm, file_name, rdwr) :
+        FileSession::find(file_name);
+      if ((session != nullptr) && (rdwr == session->options().rdwr))
+        {
+#ifdef HDF5_IS_PARALLEL
+          if (collective || !session->options().collective_metadata)
+#endif
+            {
+              return session->reopen();
+            }
+        }
+      throw_assert(!(rdwr && (FileSession::find(file_name) != nullptr) &&
+                     !FileSession::find(file_name)->options().rdwr),
+                   "open_file: file " << file_name << " is open read-only in a file session");
+
       hid_t fapl = H5Pcreate(H5P_FILE_ACCESS);
       throw_assert_nomsg(fapl >= 0);
 
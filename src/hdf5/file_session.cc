@@ -0,0 +1,141 @@
+// -*- mode: c++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+//==============================================================================
+///  @file file_session.cc
+///
+///  An open NeuroH5 file shared by repeated read operations.
+///
+///  Copyright (C) 2016-2025 Project NeuroH5.
+//==============================================================================
+
+#include <mpi.h>
+#include <hdf5.h>
+
+#include <algorithm>
+#include <map>
+#include <string>
+#include <vector>
+
+#include "file_session.hh"
+#include "throw_assert.hh"
+
+using namespace std;
+
+namespace neuroh5
+{
+  namespace hdf5
+  {
+
+    /// Sessions alive in this process, by file name
+    static map<string, vector<FileSession*> > active_sessions;
+
+    FileSession::FileSession (MPI_Comm comm, const string& file_name,
+                              const FileSessionOptions& options)
+      : file_name_(file_name), options_(options), file_(-1)
+    {
+      throw_assert(MPI_Comm_dup(comm, &comm_) == MPI_SUCCESS,
+                   "FileSession: unable to duplicate MPI communicator");
+
+      hid_t fapl = H5Pcreate(H5P_FILE_ACCESS);
+      throw_assert(fapl >= 0,
+                   "FileSession: unable to create file access property list");
+
+      int nelemts; size_t nslots, nbytes; double w0;
+      throw_assert(H5Pget_cache(fapl, &nelemts, &nslots, &nbytes, &w0) >= 0,
+                   "FileSession: error in H5Pget_cache");
+      throw_assert(H5Pset_cache(fapl, nelemts, options.chunk_cache_slots,
+                                options.chunk_cache_size, options.chunk_cache_w0) >= 0,
+                   "FileSession: error in H5Pset_cache");
+
+      H5AC_cache_config_t mdc_config;
+      mdc_config.version = H5AC__CURR_CACHE_CONFIG_VERSION;
+      throw_assert(H5Pget_mdc_config(fapl, &mdc_config) >= 0,
+                   "FileSession: error in H5Pget_mdc_config");
+      mdc_config.set_initial_size = true;
+      mdc_config.initial_size = options.metadata_cache_size;
+      mdc_config.max_size = std::max(mdc_config.max_size, options.metadata_cache_size);
+      mdc_config.min_size = std::min(mdc_config.min_size, options.metadata_cache_size);
+      throw_assert(H5Pset_mdc_config(fapl, &mdc_config) >= 0,
+                   "FileSession: error in H5Pset_mdc_config");
+
+#ifdef HDF5_IS_PARALLEL
+      throw_assert(H5Pset_fapl_mpio(fapl, comm_, MPI_INFO_NULL) >= 0,
+                   "FileSession: error in H5Pset_fapl_mpio");
+#if H5_VERSION_GE(1,10,0)
+      if (options.collective_metadata)
+        {
+          throw_assert(H5Pset_all_coll_metadata_ops(fapl, true) >= 0,
+                       "FileSession: error in H5Pset_all_coll_metadata_ops");
+          throw_assert(H5Pset_coll_metadata_write(fapl, true) >= 0,
+                       "FileSession: error in H5Pset_coll_metadata_write");
+        }
+#endif
+#endif
+
+      file_ = H5Fopen(file_name.c_str(), options.rdwr ? H5F_ACC_RDWR : H5F_ACC_RDONLY, fapl);
+      throw_assert(file_ >= 0,
+                   "FileSession: unable to open file " << file_name);
+      throw_assert(H5Pclose(fapl) >= 0,
+                   "FileSession: unable to close file access property list");
+
+      active_sessions[file_name_].push_back(this);
+    }
+
+    FileSession::~FileSession ()
+    {
+      auto it = active_sessions.find(file_name_);
+      if (it != active_sessions.end())
+        {
+          vector<FileSession*>& sessions = it->second;
+          sessions.erase(std::remove(sessions.begin(), sessions.end(), this), sessions.end());
+          if (sessions.empty())
+            {
+              active_sessions.erase(it);
+            }
+        }
+
+      if (file_ >= 0)
+        {
+          H5Fclose(file_);
+        }
+      MPI_Comm_free(&comm_);
+    }
+
+    hid_t FileSession::reopen () const
+    {
+      hid_t file = H5Freopen(file_);
+      throw_assert(file >= 0,
+                   "FileSession: unable to reopen file " << file_name_);
+      return file;
+    }
+
+    FileSession* FileSession::find (MPI_Comm comm, const string& file_name, const bool rdwr)
+    {
+      auto it = active_sessions.find(file_name);
+      if (it == active_sessions.end())
+        return nullptr;
+
+      for (FileSession* session : it->second)
+        {
+          if (rdwr && !session->options_.rdwr)
+            continue;
+          int result;
+          throw_assert(MPI_Comm_compare(comm, session->comm_, &result) == MPI_SUCCESS,
+                       "FileSession: error in MPI_Comm_compare");
+          if ((result == MPI_IDENT) || (result == MPI_CONGRUENT))
+            {
+              return session;
+            }
+        }
+      return nullptr;
+    }
+
+    FileSession* FileSession::find (const string& file_name)
+    {
+      auto it = active_sessions.find(file_name);
+      if ((it == active_sessions.end()) || (it->second.empty()))
+        return nullptr;
+      return it->second.front();
+    }
+
+  }
+}
@@ -0,0 +1,206 @@
+// -*- mode: c++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+//==============================================================================
+///  @file mapped_dataset.cc
+///
+///  Serial read access to NeuroH5 datasets by mapping their contiguous
+///  storage into memory.
+///
+///  Copyright (C) 2016-2025 Project NeuroH5.
+//==============================================================================
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <string>
+#include <vector>
+
+#include "mapped_dataset.hh"
+#include "path_names.hh"
+#include "throw_assert.hh"
+
+using namespace std;
+
+namespace neuroh5
+{
+  namespace hdf5
+  {
+
+    MappedFile::MappedFile (const string& file_name)
+      : file_name_(file_name)
+    {
+      file_ = H5Fopen(file_name.c_str(), H5F_ACC_RDONLY, H5P_DEFAULT);
+      throw_assert(file_ >= 0,
+                   "MappedFile: unable to open file " << file_name);
+      fd_ = open(file_name.c_str(), O_RDONLY);
+      throw_assert(fd_ >= 0,
+                   "MappedFile: unable to open file " << file_name);
+    }
+
+    MappedFile::~MappedFile ()
+    {
+      close(fd_);
+      H5Fclose(file_);
+    }
+
+    bool MappedFile::map_dataset (const string& path,
+                                  hid_t ntype,
+                                  const size_t type_size,
+                                  shared_ptr<const void>& region,
+                                  const void*& data,
+                                  size_t& size) const
+    {
+      bool result = false;
+
+      hid_t dset = H5Dopen2(file_, path.c_str(), H5P_DEFAULT);
+      throw_assert(dset >= 0,
+                   "MappedFile: unable to open dataset " << path);
+      hid_t dcpl = H5Dget_create_plist(dset);
+      throw_assert(dcpl >= 0, "MappedFile: error in H5Dget_create_plist");
+      hid_t ftype = H5Dget_type(dset);
+      throw_assert(ftype >= 0, "MappedFile: error in H5Dget_type");
+      hid_t fspace = H5Dget_space(dset);
+      throw_assert(fspace >= 0, "MappedFile: error in H5Dget_space");
+
+      // contiguous storage in the file itself, with elements in the
+      // memory representation of the requested type
+      bool mappable =
+        (H5Pget_layout(dcpl) == H5D_CONTIGUOUS) &&
+        (H5Pget_external_count(dcpl) == 0) &&
+        (H5Tequal(ftype, ntype) > 0) &&
+        (H5Tget_size(ftype) == type_size) &&
+        (H5Sget_simple_extent_ndims(fspace) == 1);
+
+      if (mappable)
+        {
+          hssize_t num_elements = H5Sget_simple_extent_npoints(fspace);
+          throw_assert(num_elements >= 0,
+                       "MappedFile: error in H5Sget_simple_extent_npoints");
+
+          if (num_elements == 0)
+            {
+              region.reset();
+              data = nullptr;
+              size = 0;
+              result = true;
+            }
+          else
+            {
+              haddr_t offset = H5Dget_offset(dset);
+              size_t length = num_elements * type_size;
+              struct stat st;
+              throw_assert(fstat(fd_, &st) == 0,
+                           "MappedFile: unable to stat file " << file_name_);
+
+              // storage is allocated, inside the file, and aligned for
+              // element access
+              if ((offset != HADDR_UNDEF) &&
+                  (offset % type_size == 0) &&
+                  (offset + length <= (haddr_t)st.st_size))
+                {
+                  haddr_t page_size = sysconf(_SC_PAGESIZE);
+                  haddr_t map_offset = offset - (offset % page_size);
+                  size_t map_length = length + (offset - map_offset);
+                  void* addr = mmap(NULL, map_length, PROT_READ, MAP_SHARED,
+                                    fd_, (off_t)map_offset);
+                  if (addr != MAP_FAILED)
+                    {
+                      region = shared_ptr<const void>
+                        (addr, [map_length] (const void* p)
+                         { munmap(const_cast<void*>(p), map_length); });
+                      data = static_cast<const char*>(addr) + (offset - map_offset);
+                      size = num_elements;
+                      result = true;
+                    }
+                }
+            }
+        }
+
+      throw_assert(H5Sclose(fspace) >= 0, "MappedFile: error in H5Sclose");
+      throw_assert(H5Tclose(ftype) >= 0, "MappedFile: error in H5Tclose");
+      throw_assert(H5Pclose(dcpl) >= 0, "MappedFile: error in H5Pclose");
+      throw_assert(H5Dclose(dset) >= 0, "MappedFile: error in H5Dclose");
+
+      return result;
+    }
+
+
+    ProjectionView view_projection
+    (
+     const MappedFile&          file,
+     const string&              src_pop_name,
+     const string&              dst_pop_name
+     )
+    {
+      ProjectionView result;
+
+      result.dst_blk_ptr = file.view<DST_BLK_PTR_T>
+        (edge_attribute_path(src_pop_name, dst_pop_name, EDGES, DST_BLK_PTR),
+         DST_BLK_PTR_H5_NATIVE_T);
+      result.dst_blk_idx = file.view<NODE_IDX_T>
+        (edge_attribute_path(src_pop_name, dst_pop_name, EDGES, DST_BLK_IDX),
+         NODE_IDX_H5_NATIVE_T);
+      result.dst_ptr = file.view<DST_PTR_T>
+        (edge_attribute_path(src_pop_name, dst_pop_name, EDGES, DST_PTR),
+         DST_PTR_H5_NATIVE_T);
+      result.src_idx = file.view<NODE_IDX_T>
+        (edge_attribute_path(src_pop_name, dst_pop_name, EDGES, SRC_IDX),
+         NODE_IDX_H5_NATIVE_T);
+
+      return result;
+    }
+
+
+    template <class T>
+    CellAttributeView<T> view_cell_attribute
+    (
+     const MappedFile&          file,
+     const string&              name_space,
+     const string&              pop_name,
+     const string&              attr_name
+     )
+    {
+      CellAttributeView<T> result;
+      string path = cell_attribute_path(name_space, pop_name, attr_name);
+
+      // values are read in the native representation of the stored type,
+      // as in read_cell_attribute
+      hid_t dset = H5Dopen2(file.file(), (path + "/" + ATTR_VAL).c_str(), H5P_DEFAULT);
+      throw_assert(dset >= 0,
+                   "view_cell_attribute: unable to open values of attribute " << path);
+      hid_t ftype = H5Dget_type(dset);
+      throw_assert(ftype >= 0, "view_cell_attribute: error in H5Dget_type");
+      hid_t mtype = H5Tget_native_type(ftype, H5T_DIR_ASCEND);
+      throw_assert(mtype >= 0, "view_cell_attribute: error in H5Tget_native_type");
+      throw_assert(H5Tget_size(mtype) == sizeof(T),
+                   "view_cell_attribute: type size mismatch for attribute " << path);
+      throw_assert(H5Tclose(ftype) >= 0, "view_cell_attribute: error in H5Tclose");
+      throw_assert(H5Dclose(dset) >= 0, "view_cell_attribute: error in H5Dclose");
+
+      result.index = file.view<CELL_IDX_T>(path + "/" + CELL_INDEX, CELL_IDX_H5_NATIVE_T);
+      result.ptr   = file.view<ATTR_PTR_T>(path + "/" + ATTR_PTR, ATTR_PTR_H5_NATIVE_T);
+      result.value = file.view<T>(path + "/" + ATTR_VAL, mtype);
+
+      throw_assert(H5Tclose(mtype) >= 0, "view_cell_attribute: error in H5Tclose");
+
+      return result;
+    }
+
+    template CellAttributeView<float> view_cell_attribute<float>
+    (const MappedFile&, const string&, const string&, const string&);
+    template CellAttributeView<uint8_t> view_cell_attribute<uint8_t>
+    (const MappedFile&, const string&, const string&, const string&);
+    template CellAttributeView<int8_t> view_cell_attribute<int8_t>
+    (const MappedFile&, const string&, const string&, const string&);
+    template CellAttributeView<uint16_t> view_cell_attribute<uint16_t>
+    (const MappedFile&, const string&, const string&, const string&);
+    template CellAttributeView<int16_t> view_cell_attribute<int16_t>
+    (const MappedFile&, const string&, const string&, const string&);
+    template CellAttributeView<uint32_t> view_cell_attribute<uint32_t>
+    (const MappedFile&, const string&, const string&, const string&);
+    template CellAttributeView<int32_t> view_cell_attribute<int32_t>
+    (const MappedFile&, const string&, const string&, const string&);
+
+  }
+}
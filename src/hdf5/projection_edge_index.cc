@@ -0,0 +1,430 @@
+// -*- mode: c++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+//==============================================================================
+///  @file projection_edge_index.cc
+///
+///  Index of the source index range of each destination of a projection in
+///  DBS (Destination Block Sparse) format.
+///
+///  Copyright (C) 2016-2025 Project NeuroH5.
+//==============================================================================
+
+#include <hdf5.h>
+#include <mpi.h>
+
+#include <algorithm>
+#include <map>
+#include <string>
+#include <vector>
+
+#include "neuroh5_types.hh"
+#include "path_names.hh"
+#include "projection_edge_index.hh"
+#include "dataset_num_elements.hh"
+#include "exists_dataset.hh"
+#include "read_template.hh"
+#include "write_template.hh"
+#include "phase_stats.hh"
+#include "alltoallv_template.hh"
+#include "rank_range.hh"
+#include "mpi_debug.hh"
+#include "throw_assert.hh"
+
+using namespace std;
+
+namespace neuroh5
+{
+  namespace hdf5
+  {
+
+    bool exists_projection_edge_index
+    (
+     hid_t                      file,
+     const std::string&         src_pop_name,
+     const std::string&         dst_pop_name
+     )
+    {
+      return
+        (exists_dataset (file, edge_attribute_path(src_pop_name, dst_pop_name, EDGES, DST_EDGE_START)) > 0) &&
+        (exists_dataset (file, edge_attribute_path(src_pop_name, dst_pop_name, EDGES, DST_EDGE_COUNT)) > 0);
+    }
+
+
+    // Returns the rank whose range, in ranges offset by range_start,
+    // contains idx
+    static size_t index_range_rank
+    (
+     const vector< pair<hsize_t,hsize_t> >& ranges,
+     const hsize_t range_start,
+     const hsize_t idx
+     )
+    {
+      size_t r = ranges.size() - 1;
+      while ((r > 0) && ((ranges[r].second == 0) || (range_start + ranges[r].first > idx)))
+        r--;
+      return r;
+    }
+
+
+    // Writes the given elements of an index dataset by point selection
+    static herr_t write_index_elements
+    (
+     hid_t                      file,
+     const string&              path,
+     const vector<hsize_t>&     coords,
+     const vector<DST_PTR_T>&   values,
+     const hid_t                xfer_plist
+     )
+    {
+      herr_t ierr = 0;
+      hid_t dset = H5Dopen2(file, path.c_str(), H5P_DEFAULT);
+      throw_assert(dset >= 0,
+                   "write_projection_edge_index: unable to open dataset " << path);
+      hid_t fspace = H5Dget_space(dset);
+      throw_assert_nomsg(fspace >= 0);
+      hsize_t num_coords = coords.size();
+      hid_t mspace = H5Screate_simple(1, &num_coords, NULL);
+      throw_assert_nomsg(mspace >= 0);
+      if (num_coords > 0)
+        {
+          throw_assert(H5Sselect_elements(fspace, H5S_SELECT_SET, num_coords, &coords[0]) >= 0,
+                       "write_projection_edge_index: error in H5Sselect_elements");
+        }
+      else
+        {
+          throw_assert_nomsg(H5Sselect_none(fspace) >= 0);
+          throw_assert_nomsg(H5Sselect_none(mspace) >= 0);
+        }
+      ierr = H5Dwrite(dset, DST_PTR_H5_NATIVE_T, mspace, fspace, xfer_plist, values.data());
+      throw_assert(ierr >= 0,
+                   "write_projection_edge_index: unable to write dataset " << path);
+      mpi::count_write(num_coords * sizeof(DST_PTR_T));
+      throw_assert_nomsg(H5Sclose(mspace) >= 0);
+      throw_assert_nomsg(H5Sclose(fspace) >= 0);
+      throw_assert_nomsg(H5Dclose(dset) >= 0);
+      return ierr;
+    }
+
+
+    herr_t write_projection_edge_index
+    (
+     MPI_Comm                   comm,
+     hid_t                      file,
+     const std::string&         src_pop_name,
+     const std::string&         dst_pop_name,
+     const hsize_t              chunk_size,
+     const DatasetCreationPolicy& dataset_policy,
+     const bool                 collective,
+     const hsize_t              first_block
+     )
+    {
+      herr_t ierr = 0;
+      int srank, ssize;
+      throw_assert_nomsg(MPI_Comm_size(comm, &ssize) == MPI_SUCCESS);
+      throw_assert_nomsg(MPI_Comm_rank(comm, &srank) == MPI_SUCCESS);
+      size_t rank = srank, size = ssize;
+
+      hid_t xfer_plist = H5Pcreate(H5P_DATASET_XFER);
+      throw_assert_nomsg(xfer_plist >= 0);
+#ifdef HDF5_IS_PARALLEL
+      if (collective)
+        {
+          throw_assert(H5Pset_dxpl_mpio(xfer_plist, H5FD_MPIO_COLLECTIVE) >= 0,
+                       "write_projection_edge_index: error in H5Pset_dxpl_mpio");
+        }
+#endif
+
+      const string dst_blk_ptr_path = edge_attribute_path(src_pop_name, dst_pop_name, EDGES, DST_BLK_PTR);
+      const string dst_blk_idx_path = edge_attribute_path(src_pop_name, dst_pop_name, EDGES, DST_BLK_IDX);
+      const string dst_ptr_path = edge_attribute_path(src_pop_name, dst_pop_name, EDGES, DST_PTR);
+      const string start_path = edge_attribute_path(src_pop_name, dst_pop_name, EDGES, DST_EDGE_START);
+
+      size_t num_blocks = dataset_num_elements(file, dst_blk_ptr_path);
+      if (num_blocks > 0)
+        num_blocks--;
+      size_t num_dst_ptr = dataset_num_elements(file, dst_ptr_path);
+
+      // an existing index is updated with the blocks from first_block on,
+      // and otherwise built from all blocks
+      const bool update = (first_block > 0) &&
+        exists_projection_edge_index(file, src_pop_name, dst_pop_name);
+      const hsize_t indexed_blocks = update ? first_block : 0;
+      const hsize_t indexed_size = update ? dataset_num_elements(file, start_path) : 0;
+      throw_assert(indexed_blocks <= num_blocks,
+                   "write_projection_edge_index: first block " << first_block <<
+                   " is past the last block");
+
+      // each rank reads the pointers of a contiguous range of blocks
+      vector< pair<hsize_t,hsize_t> > block_ranges;
+      mpi::rank_ranges(num_blocks - indexed_blocks, size, block_ranges);
+      hsize_t block_start = indexed_blocks + block_ranges[rank].first;
+      hsize_t block_count = block_ranges[rank].second;
+
+      vector<DST_BLK_PTR_T> dst_blk_ptr;
+      vector<NODE_IDX_T> dst_blk_idx;
+      vector<DST_PTR_T> dst_ptr;
+      hsize_t dst_ptr_start = 0, dst_ptr_count = 0;
+
+      if (block_count > 0)
+        {
+          dst_blk_ptr.resize(block_count+1);
+          dst_blk_idx.resize(block_count);
+        }
+      ierr = read<DST_BLK_PTR_T>(file, dst_blk_ptr_path, block_start,
+                                 (block_count > 0) ? block_count+1 : 0,
+                                 DST_BLK_PTR_H5_NATIVE_T, dst_blk_ptr, xfer_plist);
+      throw_assert(ierr >= 0,
+                   "write_projection_edge_index: unable to read destination block pointer");
+      ierr = read<NODE_IDX_T>(file, dst_blk_idx_path, block_start, block_count,
+                              NODE_IDX_H5_NATIVE_T, dst_blk_idx, xfer_plist);
+      throw_assert(ierr >= 0,
+                   "write_projection_edge_index: unable to read destination block index");
+
+      if (block_count > 0)
+        {
+          // the pointer of the last block is one past the last destination
+          dst_ptr_start = dst_blk_ptr.front();
+          DST_BLK_PTR_T dst_ptr_end = std::min((DST_BLK_PTR_T)num_dst_ptr-1, dst_blk_ptr.back());
+          dst_ptr_count = dst_ptr_end - dst_ptr_start + 1;
+          dst_ptr.resize(dst_ptr_count);
+        }
+      ierr = read<DST_PTR_T>(file, dst_ptr_path, dst_ptr_start, dst_ptr_count,
+                             DST_PTR_H5_NATIVE_T, dst_ptr, xfer_plist);
+      throw_assert(ierr >= 0,
+                   "write_projection_edge_index: unable to read destination pointer");
+
+      vector<NODE_IDX_T> entry_idx;
+      vector<DST_PTR_T> entry_start, entry_count;
+      uint64_t local_index_size = 0;
+      for (size_t b = 0; b < block_count; b++)
+        {
+          DST_BLK_PTR_T pos_start = dst_blk_ptr[b] - dst_ptr_start;
+          DST_BLK_PTR_T pos_end = std::min((DST_BLK_PTR_T)(dst_blk_ptr[b+1] - dst_ptr_start),
+                                           (DST_BLK_PTR_T)(dst_ptr_count-1));
+          for (DST_BLK_PTR_T pos = pos_start; pos < pos_end; pos++)
+            {
+              NODE_IDX_T dst = dst_blk_idx[b] + (pos - pos_start);
+              entry_idx.push_back(dst);
+              entry_start.push_back(dst_ptr[pos]);
+              entry_count.push_back(dst_ptr[pos+1] - dst_ptr[pos]);
+              local_index_size = std::max(local_index_size, (uint64_t)dst + 1);
+            }
+        }
+
+      uint64_t index_size = 0;
+      throw_assert(MPI_Allreduce(&local_index_size, &index_size, 1, MPI_UINT64_T, MPI_MAX, comm) == MPI_SUCCESS,
+                   "write_projection_edge_index: error in MPI_Allreduce");
+      index_size = std::max(index_size, (uint64_t)indexed_size);
+
+      // send the entries to the ranks that write the corresponding
+      // ranges of the index: the entries already in the index are
+      // updated element-wise, and the index is extended by contiguous
+      // ranges
+      vector< pair<hsize_t,hsize_t> > update_ranges, index_ranges;
+      mpi::rank_ranges(indexed_size, size, update_ranges);
+      mpi::rank_ranges(index_size - indexed_size, size, index_ranges);
+
+      vector<size_t> entry_ranks(entry_idx.size());
+      vector<size_t> sendcounts(size, 0), sdispls(size, 0), recvcounts(size, 0), rdispls(size, 0);
+      for (size_t i = 0; i < entry_idx.size(); i++)
+        {
+          size_t dst_rank = (entry_idx[i] < indexed_size) ?
+            index_range_rank(update_ranges, 0, entry_idx[i]) :
+            index_range_rank(index_ranges, indexed_size, entry_idx[i]);
+          entry_ranks[i] = dst_rank;
+          sendcounts[dst_rank]++;
+        }
+      for (size_t r = 1; r < size; r++)
+        {
+          sdispls[r] = sdispls[r-1] + sendcounts[r-1];
+        }
+
+      vector<NODE_IDX_T> send_idx(entry_idx.size());
+      vector<DST_PTR_T> send_start(entry_idx.size()), send_count(entry_idx.size());
+      {
+        vector<size_t> offsets = sdispls;
+        for (size_t i = 0; i < entry_idx.size(); i++)
+          {
+            size_t pos = offsets[entry_ranks[i]]++;
+            send_idx[pos] = entry_idx[i];
+            send_start[pos] = entry_start[i];
+            send_count[pos] = entry_count[i];
+          }
+      }
+
+      vector<NODE_IDX_T> recv_idx;
+      vector<DST_PTR_T> recv_start, recv_count;
+      throw_assert(mpi::alltoallv_vector<NODE_IDX_T>(comm, MPI_NODE_IDX_T, sendcounts, sdispls, send_idx,
+                                                     recvcounts, rdispls, recv_idx) >= 0,
+                   "write_projection_edge_index: error while sending index entries");
+      throw_assert(mpi::alltoallv_vector<DST_PTR_T>(comm, MPI_ATTR_PTR_T, sendcounts, sdispls, send_start,
+                                                    recvcounts, rdispls, recv_start) >= 0,
+                   "write_projection_edge_index: error while sending index entries");
+      throw_assert(mpi::alltoallv_vector<DST_PTR_T>(comm, MPI_ATTR_PTR_T, sendcounts, sdispls, send_count,
+                                                    recvcounts, rdispls, recv_count) >= 0,
+                   "write_projection_edge_index: error while sending index entries");
+
+      hsize_t index_start = indexed_size + index_ranges[rank].first;
+      hsize_t index_count = index_ranges[rank].second;
+      vector<DST_PTR_T> index_edge_start(index_count, EDGE_INDEX_NONE), index_edge_count(index_count, 0);
+      map<NODE_IDX_T, pair<DST_PTR_T, DST_PTR_T> > updates;
+      for (size_t i = 0; i < recv_idx.size(); i++)
+        {
+          // edges of later blocks have larger offsets
+          if (recv_idx[i] < indexed_size)
+            {
+              auto it = updates.find(recv_idx[i]);
+              if ((it == updates.end()) || (recv_start[i] < it->second.first))
+                {
+                  updates[recv_idx[i]] = make_pair(recv_start[i], recv_count[i]);
+                }
+              continue;
+            }
+          size_t pos = recv_idx[i] - index_start;
+          if (recv_start[i] < index_edge_start[pos])
+            {
+              index_edge_start[pos] = recv_start[i];
+              index_edge_count[pos] = recv_count[i];
+            }
+        }
+
+      // destinations already in the index keep the entry of their first
+      // block; the index datasets are opened on all ranks, as required by
+      // collective metadata operations
+      vector<hsize_t> update_coords;
+      vector<DST_PTR_T> update_edge_start, update_edge_count;
+      if (update)
+        {
+          vector<NODE_IDX_T> update_idx;
+          for (const auto& update_entry : updates)
+            {
+              update_idx.push_back(update_entry.first);
+            }
+          vector<DST_PTR_T> indexed_edge_start, indexed_edge_count;
+          ierr = read_projection_edge_index(file, src_pop_name, dst_pop_name, update_idx,
+                                            indexed_edge_start, indexed_edge_count);
+          throw_assert(ierr >= 0,
+                       "write_projection_edge_index: unable to read edge index");
+          size_t i = 0;
+          for (const auto& update_entry : updates)
+            {
+              if (indexed_edge_start[i++] == EDGE_INDEX_NONE)
+                {
+                  update_coords.push_back(update_entry.first);
+                  update_edge_start.push_back(update_entry.second.first);
+                  update_edge_count.push_back(update_entry.second.second);
+                }
+            }
+        }
+
+      for (const string& name : { DST_EDGE_START, DST_EDGE_COUNT })
+        {
+          const string path = edge_attribute_path(src_pop_name, dst_pop_name, EDGES, name);
+          if (!(exists_dataset(file, path) > 0))
+            {
+              hsize_t dims = index_size, maxdims = H5S_UNLIMITED;
+              hid_t fspace = H5Screate_simple(1, &dims, &maxdims);
+              throw_assert_nomsg(fspace >= 0);
+              hid_t lcpl = H5Pcreate(H5P_LINK_CREATE);
+              throw_assert_nomsg(lcpl >= 0);
+              throw_assert_nomsg(H5Pset_create_intermediate_group(lcpl, 1) >= 0);
+              hid_t dcpl = create_dataset_creation_plist(dataset_policy, DatasetIndex, chunk_size);
+              hid_t dset = H5Dcreate2(file, path.c_str(), DST_PTR_H5_FILE_T, fspace,
+                                      lcpl, dcpl, H5P_DEFAULT);
+              throw_assert(dset >= 0,
+                           "write_projection_edge_index: unable to create dataset " << path);
+              throw_assert_nomsg(H5Dclose(dset) >= 0);
+              throw_assert_nomsg(H5Pclose(dcpl) >= 0);
+              throw_assert_nomsg(H5Pclose(lcpl) >= 0);
+              throw_assert_nomsg(H5Sclose(fspace) >= 0);
+            }
+
+          ierr = write<DST_PTR_T>(file, path, index_size, index_start, index_count, DST_PTR_H5_NATIVE_T,
+                                  (name == DST_EDGE_START) ? index_edge_start : index_edge_count,
+                                  xfer_plist);
+          throw_assert(ierr >= 0,
+                       "write_projection_edge_index: unable to write dataset " << path);
+          if (update)
+            {
+              ierr = write_index_elements(file, path, update_coords,
+                                          (name == DST_EDGE_START) ? update_edge_start : update_edge_count,
+                                          xfer_plist);
+            }
+        }
+
+      throw_assert_nomsg(H5Pclose(xfer_plist) >= 0);
+
+      return ierr;
+    }
+
+
+    herr_t read_projection_edge_index
+    (
+     hid_t                      file,
+     const std::string&         src_pop_name,
+     const std::string&         dst_pop_name,
+     const std::vector<NODE_IDX_T>& dst_idx,
+     std::vector<DST_PTR_T>&    edge_start,
+     std::vector<DST_PTR_T>&    edge_count
+     )
+    {
+      herr_t ierr = 0;
+
+      edge_start.assign(dst_idx.size(), EDGE_INDEX_NONE);
+      edge_count.assign(dst_idx.size(), 0);
+
+      const string start_path = edge_attribute_path(src_pop_name, dst_pop_name, EDGES, DST_EDGE_START);
+      const string count_path = edge_attribute_path(src_pop_name, dst_pop_name, EDGES, DST_EDGE_COUNT);
+
+      hsize_t index_size = dataset_num_elements(file, start_path);
+
+      vector<hsize_t> coords;
+      vector<size_t> coord_pos;
+      for (size_t i = 0; i < dst_idx.size(); i++)
+        {
+          if (dst_idx[i] < index_size)
+            {
+              coords.push_back(dst_idx[i]);
+              coord_pos.push_back(i);
+            }
+        }
+
+      hsize_t num_coords = coords.size();
+      vector<DST_PTR_T> values(num_coords);
+      for (const string& path : { start_path, count_path })
+        {
+          hid_t dset = H5Dopen2(file, path.c_str(), H5P_DEFAULT);
+          throw_assert(dset >= 0,
+                       "read_projection_edge_index: unable to open dataset " << path);
+          hid_t fspace = H5Dget_space(dset);
+          throw_assert_nomsg(fspace >= 0);
+          hid_t mspace = H5Screate_simple(1, &num_coords, NULL);
+          throw_assert_nomsg(mspace >= 0);
+          if (num_coords > 0)
+            {
+              throw_assert(H5Sselect_elements(fspace, H5S_SELECT_SET, num_coords, &coords[0]) >= 0,
+                           "read_projection_edge_index: error in H5Sselect_elements");
+            }
+          else
+            {
+              throw_assert_nomsg(H5Sselect_none(fspace) >= 0);
+              throw_assert_nomsg(H5Sselect_none(mspace) >= 0);
+            }
+          ierr = H5Dread(dset, DST_PTR_H5_NATIVE_T, mspace, fspace, H5P_DEFAULT, values.data());
+          throw_assert(ierr >= 0,
+                       "read_projection_edge_index: unable to read dataset " << path);
+          throw_assert_nomsg(H5Sclose(mspace) >= 0);
+          throw_assert_nomsg(H5Sclose(fspace) >= 0);
+          throw_assert_nomsg(H5Dclose(dset) >= 0);
+
+          vector<DST_PTR_T>& result = (path == start_path) ? edge_start : edge_count;
+          for (size_t i = 0; i < num_coords; i++)
+            {
+              result[coord_pos[i]] = values[i];
+            }
+        }
+
+      return ierr;
+    }
+
+  }
+}
@@ -21,6 +21,8 @@
 #include "path_names.hh"
 #include "rank_range.hh"
 #include "read_projection_datasets.hh"
+#include "file_access.hh"
+#include "projection_edge_index.hh"
 #include "sort_permutation.hh"
 #include "mpi_debug.hh"
 #include "throw_assert.hh"
@@ -61,6 +63,7 @@ namespace neuroh5
       throw_assert_nomsg(MPI_Comm_rank(comm, (int*)&rank) == MPI_SUCCESS);
 
       size_t num_blocks=0;
+      uint8_t has_edge_index=0;
       
       if (rank == 0)
         {
@@ -77,15 +80,62 @@ namespace neuroh5
           total_num_edges = hdf5::dataset_num_elements
             (file, hdf5::edge_attribute_path(src_pop_name, dst_pop_name, hdf5::EDGES, hdf5::SRC_IDX));
 
+          has_edge_index = hdf5::exists_projection_edge_index(file, src_pop_name, dst_pop_name) ? 1 : 0;
+
           throw_assert_nomsg(H5Fclose(file) >= 0);
         }
       
       throw_assert_nomsg(MPI_Bcast(&num_blocks, 1, MPI_SIZE_T, 0, comm) == MPI_SUCCESS);
       throw_assert_nomsg(MPI_Bcast(&total_num_edges, 1, MPI_SIZE_T, 0, comm) == MPI_SUCCESS);
+      throw_assert_nomsg(MPI_Bcast(&has_edge_index, 1, MPI_UINT8_T, 0, comm) == MPI_SUCCESS);
 
       hsize_t read_blocks = num_blocks;
+      src_idx_ranges.clear();
+      ATTR_PTR_T selection_dst_ptr_pos = 0;
       
-      if (read_blocks > 0)
+      if ((read_blocks > 0) && has_edge_index)
+        {
+          // each rank reads the index entries of its selection
+          vector<NODE_IDX_T> dst_idx;
+          vector<NODE_IDX_T> dst_selection;
+          for (const NODE_IDX_T& s : selection) 
+            {
+              if (s >= dst_start)
+                {
+                  dst_selection.push_back(s);
+                  dst_idx.push_back(s-dst_start);
+                }
+            }
+
+          mpi::MPI_DEBUG(comm, "read_projection_dataset_selection: reading edge index for: ", 
+                         src_pop_name, " -> ", dst_pop_name, ": ", dst_idx.size(), " selection indices");
+
+          // the file is opened on all ranks of the communicator, those
+          // with an empty selection included
+          vector<DST_PTR_T> edge_start, edge_count;
+          hid_t file = hdf5::open_file(comm, file_name);
+          throw_assert_nomsg(file >= 0);
+          ierr = hdf5::read_projection_edge_index(file, src_pop_name, dst_pop_name, dst_idx,
+                                                  edge_start, edge_count);
+          throw_assert_nomsg(ierr >= 0);
+          throw_assert_nomsg(hdf5::close_file(file) >= 0);
+
+          edge_base = 0;
+          for (size_t i = 0; i < dst_idx.size(); i++)
+            {
+              if (edge_start[i] == hdf5::EDGE_INDEX_NONE)
+                {
+                  throw runtime_error(string("read_projection_dataset_selection: destination index ")+
+                                      std::to_string(dst_selection[i])+
+                                      string(" not found in destination index dataset ")+
+                                      hdf5::edge_attribute_path(src_pop_name, dst_pop_name, 
+                                                                hdf5::EDGES, hdf5::DST_EDGE_START));
+                }
+              selection_dst_idx.push_back(dst_selection[i]);
+              src_idx_ranges.push_back(make_pair(edge_start[i], edge_count[i]));
+            }
+        }
+      else if (read_blocks > 0)
         {
           DST_BLK_PTR_T block_rebase = 0;
           vector<DST_BLK_PTR_T> dst_blk_ptr(read_blocks+1, 0);
@@ -207,8 +257,6 @@ namespace neuroh5
           
           DST_PTR_T dst_rebase = 0;
           // Create source index ranges based on selection_dst_ptr
-          src_idx_ranges.clear();
-          ATTR_PTR_T selection_dst_ptr_pos = 0;
           if (dst_ptr_block > 0)
             {
               dst_rebase = dst_ptr[0];
@@ -265,25 +313,28 @@ namespace neuroh5
                         }
                     }
                 }
+            }
+        }
 
-              auto compare_range_idx = [](const std::pair<hsize_t, hsize_t>& a, const std::pair<hsize_t, hsize_t>& b) 
-                { return (a.first < b.first); };
+      if (read_blocks > 0)
+        {
+          auto compare_range_idx = [](const std::pair<hsize_t, hsize_t>& a, const std::pair<hsize_t, hsize_t>& b) 
+            { return (a.first < b.first); };
 	  
-              vector<size_t> range_sort_p = data::sort_permutation(src_idx_ranges, compare_range_idx);
-              
-              data::apply_permutation_in_place(selection_dst_idx, range_sort_p);
-              data::apply_permutation_in_place(src_idx_ranges, range_sort_p);
+          vector<size_t> range_sort_p = data::sort_permutation(src_idx_ranges, compare_range_idx);
+          
+          data::apply_permutation_in_place(selection_dst_idx, range_sort_p);
+          data::apply_permutation_in_place(src_idx_ranges, range_sort_p);
 
-              for (const auto& range : src_idx_ranges)
-                {
-                  hsize_t src_idx_start=range.first;
-                  hsize_t src_idx_block=range.second;
+          for (const auto& range : src_idx_ranges)
+            {
+              hsize_t src_idx_start=range.first;
+              hsize_t src_idx_block=range.second;
 
-                  selection_dst_ptr.push_back(selection_dst_ptr_pos);
-                  selection_dst_ptr_pos += src_idx_block;
-                }
               selection_dst_ptr.push_back(selection_dst_ptr_pos);
+              selection_dst_ptr_pos += src_idx_block;
             }
+          selection_dst_ptr.push_back(selection_dst_ptr_pos);
 
 
           if (src_idx_ranges.size() > 0)
@@ -299,13 +350,6 @@ namespace neuroh5
           
           {
             
-            /* Create property list for parallel file access. */
-            hid_t fapl = H5Pcreate(H5P_FILE_ACCESS);
-            throw_assert_nomsg(fapl >= 0);
-#ifdef HDF5_IS_PARALLEL
-            throw_assert_nomsg(H5Pset_fapl_mpio(fapl, comm, MPI_INFO_NULL) >= 0);
-#endif
-            
             /* Create property list for collective dataset operations. */
             hid_t rapl = H5Pcreate (H5P_DATASET_XFER);
 #ifdef HDF5_IS_PARALLEL
@@ -317,7 +361,7 @@ namespace neuroh5
               }
 #endif
             
-            hid_t file = H5Fopen(file_name.c_str(), H5F_ACC_RDONLY, fapl);
+            hid_t file = hdf5::open_file(comm, file_name, true);
             throw_assert_nomsg(file >= 0);
             
             ierr = hdf5::read_selection<NODE_IDX_T>
@@ -331,8 +375,7 @@ namespace neuroh5
                );
             throw_assert_nomsg(ierr >= 0);
             
-            throw_assert_nomsg(H5Fclose(file) >= 0);
-            throw_assert_nomsg(H5Pclose(fapl) >= 0);
+            throw_assert_nomsg(hdf5::close_file(file) >= 0);
             throw_assert_nomsg(H5Pclose(rapl) >= 0);
 
           }
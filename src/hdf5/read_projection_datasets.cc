@@ -21,6 +21,7 @@
 #include "path_names.hh"
 #include "rank_range.hh"
 #include "read_projection_datasets.hh"
+#include "file_access.hh"
 #include "mpi_debug.hh"
 #include "throw_assert.hh"
 
@@ -161,8 +162,7 @@ namespace neuroh5
       herr_t ierr = 0;
     
       // Open file
-      hid_t fapl = H5Pcreate(H5P_FILE_ACCESS);
-      hid_t file = H5Fopen(file_name.c_str(), H5F_ACC_RDONLY, fapl);
+      hid_t file = hdf5::open_file(MPI_COMM_SELF, file_name);
       
       // Get dataset sizes
       total_read_blocks = hdf5::dataset_num_elements
@@ -212,8 +212,7 @@ namespace neuroh5
          H5P_DEFAULT
          );
       
-      H5Fclose(file);
-      H5Pclose(fapl);
+      hdf5::close_file(file);
       
       return ierr;
     }
@@ -443,49 +442,39 @@ namespace neuroh5
      const std::string&         file_name,
      const std::string&         src_pop_name,
      const std::string&         dst_pop_name,
-     const RankAssignments&      rank_assignments,
+     const hsize_t              edge_start,
+     const hsize_t              edge_count,
      vector<NODE_IDX_T>&        src_idx
      )
     {
       herr_t ierr = 0;
-      unsigned int rank, size;
-      MPI_Comm_size(comm, (int*)&size);
-      MPI_Comm_rank(comm, (int*)&rank);
     
-      //      if (rank_assignments.src_idx_count[rank] > 0)
-        {
-          // Open the file with parallel access
-          hid_t fapl = H5Pcreate(H5P_FILE_ACCESS);
-#ifdef HDF5_IS_PARALLEL
-          H5Pset_fapl_mpio(fapl, comm, MPI_INFO_NULL);
-#endif
-          hid_t file = H5Fopen(file_name.c_str(), H5F_ACC_RDONLY, fapl);
+      // Open the file with parallel access
+      hid_t file = hdf5::open_file(comm, file_name, true);
         
-          // Create property list for collective dataset operations
-          hid_t rapl = H5Pcreate(H5P_DATASET_XFER);
+      // Create property list for collective dataset operations
+      hid_t rapl = H5Pcreate(H5P_DATASET_XFER);
 #ifdef HDF5_IS_PARALLEL
-          H5Pset_dxpl_mpio(rapl, H5FD_MPIO_COLLECTIVE);
+      H5Pset_dxpl_mpio(rapl, H5FD_MPIO_COLLECTIVE);
 #endif
         
-          // Resize to accommodate the data
-          src_idx.resize(rank_assignments.src_idx_count[rank], 0);
+      // Resize to accommodate the data
+      src_idx.resize(edge_count, 0);
         
-          // Read the data
-          ierr = hdf5::read<NODE_IDX_T>
-            (
-             file,
-             hdf5::edge_attribute_path(src_pop_name, dst_pop_name, hdf5::EDGES, hdf5::SRC_IDX),
-             rank_assignments.src_idx_start[rank],
-             rank_assignments.src_idx_count[rank],
-             NODE_IDX_H5_NATIVE_T,
-             src_idx,
-             rapl
-             );
+      // Read the data
+      ierr = hdf5::read<NODE_IDX_T>
+        (
+         file,
+         hdf5::edge_attribute_path(src_pop_name, dst_pop_name, hdf5::EDGES, hdf5::SRC_IDX),
+         edge_start,
+         edge_count,
+         NODE_IDX_H5_NATIVE_T,
+         src_idx,
+         rapl
+         );
           
-          H5Pclose(rapl);
-          H5Fclose(file);
-          H5Pclose(fapl);
-        }
+      H5Pclose(rapl);
+      hdf5::close_file(file);
     
       return ierr;
     }
@@ -686,10 +675,10 @@ namespace neuroh5
     }
     
     /**************************************************************************
-     * Read the basic DBS graph structure
+     * Read the pointer datasets of the DBS graph structure
      *************************************************************************/
 
-    herr_t read_projection_datasets
+    herr_t read_projection_pointers
     (
      MPI_Comm                   comm,
      const std::string&         file_name,
@@ -697,16 +686,12 @@ namespace neuroh5
      const std::string&         dst_pop_name,
      DST_BLK_PTR_T&             block_base,
      DST_PTR_T&                 edge_base,
+     DST_PTR_T&                 edge_count,
      vector<DST_BLK_PTR_T>&     dst_blk_ptr,
      vector<NODE_IDX_T>&        dst_idx,
      vector<DST_PTR_T>&         dst_ptr,
-     vector<NODE_IDX_T>&        src_idx,
      size_t&                    total_num_edges,
-     hsize_t&                   total_read_blocks,
-     hsize_t&                   local_read_blocks,
-     size_t                     offset,
-     size_t                     numitems,
-     bool collective
+     hsize_t&                   total_read_blocks
      )
     {
       herr_t ierr = 0;
@@ -770,11 +755,48 @@ namespace neuroh5
       distribute_assignments(comm, rank_assignments);
       block_base = rank_assignments.dst_block_start[rank];
       edge_base = rank_assignments.src_idx_start[rank];
+      edge_count = rank_assignments.src_idx_count[rank];
+
+      return ierr;
+    }
 
+    
+    /**************************************************************************
+     * Read the basic DBS graph structure
+     *************************************************************************/
+
+    herr_t read_projection_datasets
+    (
+     MPI_Comm                   comm,
+     const std::string&         file_name,
+     const std::string&         src_pop_name,
+     const std::string&         dst_pop_name,
+     DST_BLK_PTR_T&             block_base,
+     DST_PTR_T&                 edge_base,
+     vector<DST_BLK_PTR_T>&     dst_blk_ptr,
+     vector<NODE_IDX_T>&        dst_idx,
+     vector<DST_PTR_T>&         dst_ptr,
+     vector<NODE_IDX_T>&        src_idx,
+     size_t&                    total_num_edges,
+     hsize_t&                   total_read_blocks,
+     hsize_t&                   local_read_blocks,
+     size_t                     offset,
+     size_t                     numitems,
+     bool collective
+     )
+    {
+      herr_t ierr = 0;
+      DST_PTR_T edge_count = 0;
+
+      // Steps 1-5: read and distribute the pointer datasets
+      ierr = read_projection_pointers(comm, file_name, src_pop_name, dst_pop_name,
+                                      block_base, edge_base, edge_count,
+                                      dst_blk_ptr, dst_idx, dst_ptr,
+                                      total_num_edges, total_read_blocks);
       
       // Step 6: Each rank reads its portion of src_idx based on its assignment
       ierr = read_projection_src_idx(comm, file_name, src_pop_name, dst_pop_name, 
-                                     rank_assignments, src_idx);
+                                     edge_base, edge_count, src_idx);
 
       return ierr;
     }
@@ -800,13 +822,7 @@ namespace neuroh5
       throw_assert_nomsg(MPI_Comm_rank(comm, (int*)&rank) == MPI_SUCCESS);
 
 
-      hid_t fapl = H5Pcreate(H5P_FILE_ACCESS);
-      throw_assert_nomsg(fapl >= 0);
-#ifdef HDF5_IS_PARALLEL
-      throw_assert_nomsg(H5Pset_fapl_mpio(fapl, comm, MPI_INFO_NULL) >= 0);
-#endif
-
-      hid_t file = H5Fopen(file_name.c_str(), H5F_ACC_RDONLY, fapl);
+      hid_t file = hdf5::open_file(comm, file_name, true);
       throw_assert_nomsg(file >= 0);
 
       // determine number of blocks in projection
@@ -944,8 +960,7 @@ namespace neuroh5
           
           throw_assert_nomsg(H5Pclose(rapl) >= 0);
         }
-      throw_assert_nomsg(H5Fclose(file) >= 0);
-      throw_assert_nomsg(H5Pclose(fapl) >= 0);
+      throw_assert_nomsg(hdf5::close_file(file) >= 0);
 
       return ierr;
     }
@@ -11,8 +11,8 @@
 
 #include <cstdio>
 #include <iostream>
-#include <sstream>
 #include <fstream>
+#include <iterator>
 #include <string>
 #include <set>
 #include <map>
@@ -22,6 +22,7 @@
 #include "ngraph.hh"
 #include "neuroh5_types.hh"
 #include "contract_tree.hh"
+#include "txt_tokenizer.hh"
 #include "throw_assert.hh"
 
 using namespace std;
@@ -33,6 +34,15 @@ namespace neuroh5
   namespace io
   {
     
+    // reads a whole file, which is then tokenized line by line
+    static void read_file_contents (const std::string& file_name, std::string& content)
+    {
+      ifstream infile(file_name, ios::binary);
+      throw_assert(infile.good(), "unable to open SWC file " << file_name);
+      content.assign(istreambuf_iterator<char>(infile), istreambuf_iterator<char>());
+      infile.close();
+    }
+
     /*****************************************************************************
      * Load tree data structures 
      *****************************************************************************/
@@ -57,28 +67,32 @@ namespace neuroh5
       std::deque<SWC_TYPE_T> swc_types;   // SWC types
       Graph::vertex_set roots;
 
-      ifstream infile(file_name);
-      string line;
+      string content;
+      read_file_contents(file_name, content);
       size_t i = 0;
-    
-      while (getline(infile, line))
+
+      const char* p = content.data();
+      const char* content_end = p + content.size();
+      while (p < content_end)
         {
-          istringstream iss(line);
+          const char* line = p;
+          const char* line_end = io::find_line_end(line, content_end);
+          p = (line_end < content_end) ? line_end + 1 : content_end;
           NODE_IDX_T id, idpar; int opt_idpar;
           int layer_value; LAYER_IDX_T layer;
           REALVAL_T radius;
           COORD_T x, y, z;
 
-          iss >> id;
+          // lines that do not start with a node index are comments
+          if (!io::parse_token(line, line_end, id)) continue;
           id = id+id_offset;
-          if (iss.fail()) continue;
         
-          throw_assert_nomsg (iss >> layer_value);
-          throw_assert_nomsg (iss >> x);
-          throw_assert_nomsg (iss >> y);
-          throw_assert_nomsg (iss >> z);
-          throw_assert_nomsg (iss >> radius);
-          throw_assert_nomsg (iss >> opt_idpar);
+          throw_assert_nomsg (io::parse_token(line, line_end, layer_value));
+          throw_assert_nomsg (io::parse_token(line, line_end, x));
+          throw_assert_nomsg (io::parse_token(line, line_end, y));
+          throw_assert_nomsg (io::parse_token(line, line_end, z));
+          throw_assert_nomsg (io::parse_token(line, line_end, radius));
+          throw_assert_nomsg (io::parse_token(line, line_end, opt_idpar));
 
           if (layer_value < 0)
             {
@@ -118,8 +132,6 @@ namespace neuroh5
         
           i++;
         }
-    
-      infile.close();
 
       //cout << A;
 
@@ -227,32 +239,35 @@ namespace neuroh5
       std::deque<SWC_TYPE_T> swc_types;   // SWC types
       Graph::vertex_set roots;
 
-      ifstream infile(file_name);
-      string line;
+      string content;
+      read_file_contents(file_name, content);
       size_t i = 0;
-    
-      while (getline(infile, line))
+
+      const char* p = content.data();
+      const char* content_end = p + content.size();
+      while (p < content_end)
         {
-          istringstream iss(line);
+          const char* line = p;
+          const char* line_end = io::find_line_end(line, content_end);
+          p = (line_end < content_end) ? line_end + 1 : content_end;
           NODE_IDX_T id, idpar; int opt_idpar;
           int swc_value; int opt_layer; LAYER_IDX_T layer=-1;
           SWC_TYPE_T swc_type;
           REALVAL_T radius;
           COORD_T x, y, z;
 
-          iss >> id;
+          // lines that do not start with a node index are comments
+          if (!io::parse_token(line, line_end, id)) continue;
           id = id+id_offset;
-          if (iss.fail()) continue;
         
-          throw_assert_nomsg (iss >> swc_value);
+          throw_assert_nomsg (io::parse_token(line, line_end, swc_value));
           swc_type = swc_value;
-          throw_assert_nomsg (iss >> x);
-          throw_assert_nomsg (iss >> y);
-          throw_assert_nomsg (iss >> z);
-          throw_assert_nomsg (iss >> radius);
-          throw_assert_nomsg (iss >> opt_idpar);
-          iss >> opt_layer;
-          if (!iss.fail())
+          throw_assert_nomsg (io::parse_token(line, line_end, x));
+          throw_assert_nomsg (io::parse_token(line, line_end, y));
+          throw_assert_nomsg (io::parse_token(line, line_end, z));
+          throw_assert_nomsg (io::parse_token(line, line_end, radius));
+          throw_assert_nomsg (io::parse_token(line, line_end, opt_idpar));
+          if (io::parse_token(line, line_end, opt_layer))
             {
               layer = opt_layer;
             }
@@ -287,8 +302,6 @@ namespace neuroh5
         
           i++;
         }
-    
-      infile.close();
 
       //cout << A;
     
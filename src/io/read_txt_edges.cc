@@ -0,0 +1,274 @@
+// -*- mode: c++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+//==============================================================================
+///  @file read_txt_edges.cc
+///
+///  Parallel reading of projection edges in text format.
+///
+///  Copyright (C) 2016-2025 Project NeuroH5.
+//==============================================================================
+
+#include <mpi.h>
+
+#include <algorithm>
+#include <string>
+#include <vector>
+#include <map>
+
+#include "read_txt_edges.hh"
+#include "txt_tokenizer.hh"
+#include "rank_range.hh"
+#include "sort_permutation.hh"
+#include "throw_assert.hh"
+
+using namespace std;
+
+namespace neuroh5
+{
+  namespace io
+  {
+
+    // MPI counts are int, so large ranges are read in pieces
+    static const size_t txt_read_max_count = 1 << 30;
+    // read size used to complete a line that extends past a byte range
+    static const size_t txt_read_tail_size = 1 << 16;
+
+
+    void read_txt_byte_range
+    (
+     MPI_Comm              comm,
+     const string&         file_name,
+     vector<char>&         buffer
+     )
+    {
+      int srank, ssize;
+      throw_assert_nomsg(MPI_Comm_size(comm, &ssize) == MPI_SUCCESS);
+      throw_assert_nomsg(MPI_Comm_rank(comm, &srank) == MPI_SUCCESS);
+
+      MPI_File fh;
+      throw_assert(MPI_File_open(comm, file_name.c_str(), MPI_MODE_RDONLY,
+                                 MPI_INFO_NULL, &fh) == MPI_SUCCESS,
+                   "read_txt_byte_range: unable to open file " << file_name);
+      MPI_Offset file_size;
+      throw_assert(MPI_File_get_size(fh, &file_size) == MPI_SUCCESS,
+                   "read_txt_byte_range: unable to determine size of file " << file_name);
+
+      vector< pair<hsize_t,hsize_t> > ranges;
+      mpi::rank_ranges(file_size, ssize, ranges);
+      const size_t start = ranges[srank].first, end = start + ranges[srank].second;
+
+      // the byte before the range tells whether a line starts at its
+      // first byte
+      const size_t read_start = (start > 0) ? start - 1 : 0;
+      const size_t read_size  = (end > start) ? end - read_start : 0;
+      buffer.resize(read_size);
+
+      uint64_t num_rounds = (read_size + txt_read_max_count - 1) / txt_read_max_count;
+      throw_assert(MPI_Allreduce(MPI_IN_PLACE, &num_rounds, 1, MPI_UINT64_T, MPI_MAX,
+                                 comm) == MPI_SUCCESS,
+                   "read_txt_byte_range: error in MPI_Allreduce");
+      for (size_t r = 0; r < num_rounds; r++)
+        {
+          size_t offset = min(r * txt_read_max_count, read_size);
+          int count = min(txt_read_max_count, read_size - offset);
+          MPI_Status status;
+          throw_assert(MPI_File_read_at_all(fh, read_start + offset, &buffer[0] + offset, count,
+                                            MPI_CHAR, &status) == MPI_SUCCESS,
+                       "read_txt_byte_range: error reading file " << file_name);
+        }
+
+      // the first line owned by this rank starts after the first newline
+      // before the last byte of the range
+      size_t line_start = read_size;
+      if (read_size > 0)
+        {
+          if (start == 0)
+            {
+              line_start = 0;
+            }
+          else
+            {
+              auto it = find(buffer.begin(), buffer.end() - 1, '\n');
+              if (it != buffer.end() - 1)
+                {
+                  line_start = (it - buffer.begin()) + 1;
+                }
+            }
+        }
+
+      if (line_start < read_size)
+        {
+          // completes the last line, which may extend into the ranges of
+          // the following ranks
+          size_t read_end = end;
+          while ((buffer.back() != '\n') && (read_end < (size_t)file_size))
+            {
+              size_t count = min(txt_read_tail_size, (size_t)file_size - read_end);
+              size_t pos = buffer.size();
+              buffer.resize(pos + count);
+              MPI_Status status;
+              throw_assert(MPI_File_read_at(fh, read_end, &buffer[pos], count,
+                                            MPI_CHAR, &status) == MPI_SUCCESS,
+                           "read_txt_byte_range: error reading file " << file_name);
+              auto it = find(buffer.begin() + pos, buffer.end(), '\n');
+              if (it != buffer.end())
+                {
+                  buffer.erase(it + 1, buffer.end());
+                }
+              read_end += count;
+            }
+          buffer.erase(buffer.begin(), buffer.begin() + line_start);
+        }
+      else
+        {
+          buffer.clear();
+        }
+
+      throw_assert(MPI_File_close(&fh) == MPI_SUCCESS,
+                   "read_txt_byte_range: unable to close file " << file_name);
+    }
+
+
+    template <class T>
+    static void parse_attr_values (const char*& p, const char* line_end, const size_t num_values,
+                                   data::AttrVal& attr_val)
+    {
+      for (size_t a = 0; a < num_values; a++)
+        {
+          T v;
+          throw_assert(parse_token(p, line_end, v),
+                       "parse_txt_edges: invalid attribute value in line: " <<
+                       string(p, line_end));
+          attr_val.attr_vec<T>(a).push_back(v);
+        }
+    }
+
+
+    size_t parse_txt_edges
+    (
+     const char*           begin,
+     const char*           end,
+     const map <string, vector <size_t> >& num_attrs,
+     vector<NODE_IDX_T>&   dst_idx,
+     vector<NODE_IDX_T>&   src_idx,
+     map <string, data::AttrVal>& attrs_map
+     )
+    {
+      vector<data::AttrVal*> attr_vals;
+      for (const auto& iter : num_attrs)
+        {
+          data::AttrVal& attr_val = attrs_map[iter.first];
+          attr_val.resize<float>(iter.second[data::AttrVal::attr_index_float]);
+          attr_val.resize<uint8_t>(iter.second[data::AttrVal::attr_index_uint8]);
+          attr_val.resize<uint16_t>(iter.second[data::AttrVal::attr_index_uint16]);
+          attr_val.resize<uint32_t>(iter.second[data::AttrVal::attr_index_uint32]);
+          attr_val.resize<int8_t>(iter.second[data::AttrVal::attr_index_int8]);
+          attr_val.resize<int16_t>(iter.second[data::AttrVal::attr_index_int16]);
+          attr_val.resize<int32_t>(iter.second[data::AttrVal::attr_index_int32]);
+          attr_vals.push_back(&attr_val);
+        }
+
+      size_t num_edges = 0;
+      const char* p = begin;
+      while (p < end)
+        {
+          const char* line_end = find_line_end(p, end);
+          p = skip_blanks(p, line_end);
+          if ((p < line_end) && (*p != '#'))
+            {
+              NODE_IDX_T dst, src;
+              throw_assert(parse_token(p, line_end, dst) && parse_token(p, line_end, src),
+                           "parse_txt_edges: invalid node index in line: " <<
+                           string(p, line_end));
+              dst_idx.push_back(dst);
+              src_idx.push_back(src);
+
+              size_t ns = 0;
+              for (const auto& iter : num_attrs)
+                {
+                  data::AttrVal& attr_val = *attr_vals[ns];
+                  parse_attr_values<float>(p, line_end, iter.second[data::AttrVal::attr_index_float], attr_val);
+                  parse_attr_values<uint8_t>(p, line_end, iter.second[data::AttrVal::attr_index_uint8], attr_val);
+                  parse_attr_values<uint16_t>(p, line_end, iter.second[data::AttrVal::attr_index_uint16], attr_val);
+                  parse_attr_values<uint32_t>(p, line_end, iter.second[data::AttrVal::attr_index_uint32], attr_val);
+                  parse_attr_values<int8_t>(p, line_end, iter.second[data::AttrVal::attr_index_int8], attr_val);
+                  parse_attr_values<int16_t>(p, line_end, iter.second[data::AttrVal::attr_index_int16], attr_val);
+                  parse_attr_values<int32_t>(p, line_end, iter.second[data::AttrVal::attr_index_int32], attr_val);
+                  ns++;
+                }
+              num_edges++;
+            }
+          p = (line_end < end) ? line_end + 1 : end;
+        }
+
+      return num_edges;
+    }
+
+
+    template <class T>
+    static void permute_attr_values (data::AttrVal& attr_val, const vector<size_t>& p)
+    {
+      for (size_t a = 0; a < attr_val.size_attr_vec<T>(); a++)
+        {
+          vector<T>& values = attr_val.attr_vec<T>(a);
+          values = data::apply_permutation(values, p);
+        }
+    }
+
+
+    int read_txt_edges
+    (
+     MPI_Comm              comm,
+     const string&         file_name,
+     const map <string, vector <size_t> >& num_attrs,
+     vector<NODE_IDX_T>&   dst_idx,
+     vector<DST_PTR_T>&    src_idx_ptr,
+     vector<NODE_IDX_T>&   src_idx,
+     map <string, data::AttrVal>& attrs_map
+     )
+    {
+      vector<char> buffer;
+      read_txt_byte_range(comm, file_name, buffer);
+
+      vector<NODE_IDX_T> edge_dst;
+      dst_idx.clear();
+      src_idx_ptr.clear();
+      src_idx.clear();
+      attrs_map.clear();
+      const char* begin = buffer.data();
+      size_t num_edges = parse_txt_edges(begin, begin + buffer.size(), num_attrs,
+                                         edge_dst, src_idx, attrs_map);
+      buffer.clear();
+      buffer.shrink_to_fit();
+
+      // groups the edges by destination
+      auto compare_nodes = [](const NODE_IDX_T& a, const NODE_IDX_T& b) { return (a < b); };
+      vector<size_t> p = data::sort_permutation(edge_dst, compare_nodes);
+      edge_dst = data::apply_permutation(edge_dst, p);
+      src_idx  = data::apply_permutation(src_idx, p);
+      for (auto& attrs_iter : attrs_map)
+        {
+          data::AttrVal& attr_val = attrs_iter.second;
+          permute_attr_values<float>(attr_val, p);
+          permute_attr_values<uint8_t>(attr_val, p);
+          permute_attr_values<int8_t>(attr_val, p);
+          permute_attr_values<uint16_t>(attr_val, p);
+          permute_attr_values<int16_t>(attr_val, p);
+          permute_attr_values<uint32_t>(attr_val, p);
+          permute_attr_values<int32_t>(attr_val, p);
+        }
+
+      for (size_t i = 0; i < num_edges; i++)
+        {
+          if ((i == 0) || (edge_dst[i] != edge_dst[i-1]))
+            {
+              dst_idx.push_back(edge_dst[i]);
+              src_idx_ptr.push_back(i);
+            }
+        }
+      src_idx_ptr.push_back(num_edges);
+
+      return 0;
+    }
+
+  }
+}
@@ -0,0 +1,135 @@
+// -*- mode: c++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+//==============================================================================
+///  @file io_rank_set.cc
+///
+///  Selection of the ranks that perform collective I/O, spread over the
+///  shared-memory nodes of a communicator.
+///
+///  Copyright (C) 2016-2025 Project NeuroH5.
+//==============================================================================
+
+#include <mpi.h>
+
+#include <algorithm>
+#include <map>
+#include <set>
+#include <vector>
+
+#include "io_rank_set.hh"
+#include "throw_assert.hh"
+
+using namespace std;
+
+namespace neuroh5
+{
+
+  namespace mpi
+  {
+
+    void node_range_sample
+    (
+     const vector<int>& rank_nodes,
+     size_t             io_size,
+     set<size_t>&       io_rank_set
+     )
+    {
+      throw_assert(rank_nodes.size() > 0, "node_range_sample: empty rank list");
+      throw_assert(io_size > 0, "node_range_sample: invalid io_size <= 0");
+
+      // ranks of each node, in order of the lowest rank of the node
+      map<int, size_t> node_order;
+      vector< vector<size_t> > node_ranks;
+      for (size_t r = 0; r < rank_nodes.size(); r++)
+        {
+          auto it = node_order.find(rank_nodes[r]);
+          if (it == node_order.end())
+            {
+              it = node_order.insert(make_pair(rank_nodes[r], node_ranks.size())).first;
+              node_ranks.push_back(vector<size_t>());
+            }
+          node_ranks[it->second].push_back(r);
+        }
+
+      size_t num_nodes = node_ranks.size();
+      io_size = std::min(io_size, rank_nodes.size());
+
+      // number of I/O ranks on each node
+      vector<size_t> node_io_size(num_nodes, 0);
+      if (io_size < num_nodes)
+        {
+          size_t h = num_nodes / io_size;
+          for (size_t i = 0; i < io_size; i++)
+            {
+              node_io_size[i*h] = 1;
+            }
+        }
+      else
+        {
+          // even shares, with the remainder given to the first nodes that
+          // have ranks to spare
+          size_t remaining = io_size;
+          while (remaining > 0)
+            {
+              size_t num_open = 0;
+              for (size_t n = 0; n < num_nodes; n++)
+                {
+                  if (node_io_size[n] < node_ranks[n].size())
+                    num_open++;
+                }
+              throw_assert(num_open > 0, "node_range_sample: no ranks left to select");
+              size_t share = std::max(remaining / num_open, (size_t)1);
+              for (size_t n = 0; (n < num_nodes) && (remaining > 0); n++)
+                {
+                  size_t count = std::min(std::min(share, remaining),
+                                          node_ranks[n].size() - node_io_size[n]);
+                  node_io_size[n] += count;
+                  remaining -= count;
+                }
+            }
+        }
+
+      for (size_t n = 0; n < num_nodes; n++)
+        {
+          size_t node_size = node_ranks[n].size();
+          for (size_t j = 0; j < node_io_size[n]; j++)
+            {
+              io_rank_set.insert(node_ranks[n][(j * node_size) / node_io_size[n]]);
+            }
+        }
+
+      throw_assert(io_rank_set.size() == io_size,
+                   "node_range_sample: invalid output set");
+    }
+
+
+    void select_io_ranks
+    (
+     MPI_Comm      comm,
+     size_t        io_size,
+     set<size_t>&  io_rank_set
+     )
+    {
+      int rank, size;
+      throw_assert_nomsg(MPI_Comm_rank(comm, &rank) == MPI_SUCCESS);
+      throw_assert_nomsg(MPI_Comm_size(comm, &size) == MPI_SUCCESS);
+
+      MPI_Comm node_comm;
+      throw_assert(MPI_Comm_split_type(comm, MPI_COMM_TYPE_SHARED, rank,
+                                       MPI_INFO_NULL, &node_comm) == MPI_SUCCESS,
+                   "select_io_ranks: error in MPI_Comm_split_type");
+      // each node is identified by its lowest rank
+      int node_leader = rank;
+      throw_assert(MPI_Allreduce(&rank, &node_leader, 1, MPI_INT, MPI_MIN, node_comm) == MPI_SUCCESS,
+                   "select_io_ranks: error in MPI_Allreduce");
+      throw_assert_nomsg(MPI_Comm_free(&node_comm) == MPI_SUCCESS);
+
+      vector<int> rank_nodes(size, 0);
+      throw_assert(MPI_Allgather(&node_leader, 1, MPI_INT,
+                                 &rank_nodes[0], 1, MPI_INT, comm) == MPI_SUCCESS,
+                   "select_io_ranks: error in MPI_Allgather");
+
+      node_range_sample(rank_nodes, io_size, io_rank_set);
+    }
+
+  }
+}
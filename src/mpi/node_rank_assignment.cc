@@ -0,0 +1,520 @@
+// -*- mode: c++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+//==============================================================================
+///  @file node_rank_assignment.cc
+///
+///  Weight-balanced assignment of graph nodes to MPI ranks.
+///
+///  Copyright (C) 2016-2025 Project NeuroH5.
+//==============================================================================
+
+#include <mpi.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <map>
+#include <set>
+#include <string>
+#include <vector>
+
+#include "mpi_debug.hh"
+#include "throw_assert.hh"
+#include "neuroh5_types.hh"
+#include "node_rank_assignment.hh"
+#include "alltoallv_template.hh"
+
+using namespace std;
+
+
+namespace neuroh5
+{
+
+  namespace mpi
+  {
+
+    // A node in the distributed sort; origin is the rank to which the
+    // assignment of the node is returned.
+    struct node_rank_item
+    {
+      uint64_t   key;
+      NODE_IDX_T node;
+      rank_t     origin;
+      double     weight;
+      float      coords[3];
+    };
+
+    struct node_rank_result
+    {
+      NODE_IDX_T node;
+      rank_t     rank;
+    };
+
+    static bool item_less (const node_rank_item& a, const node_rank_item& b)
+    {
+      return (a.key < b.key) || ((a.key == b.key) && (a.node < b.node));
+    }
+
+
+    /// Sends items[p] to rank p and returns the received items in rank
+    /// order; items are packed into a byte buffer.
+    template <class T>
+    static void exchange_items (MPI_Comm comm,
+                                vector< vector<T> >& items,
+                                vector<T>& recv_items)
+    {
+      const size_t size = items.size();
+      vector<size_t> sendcounts(size, 0), sdispls(size, 0);
+      vector<char> sendbuf;
+      size_t sendbuf_size = 0;
+      for (size_t p = 0; p < size; p++)
+        {
+          sdispls[p] = sendbuf_size;
+          sendcounts[p] = items[p].size() * sizeof(T);
+          sendbuf_size += sendcounts[p];
+        }
+      sendbuf.resize(sendbuf_size);
+      for (size_t p = 0; p < size; p++)
+        {
+          if (sendcounts[p] > 0)
+            {
+              memcpy(&sendbuf[sdispls[p]], items[p].data(), sendcounts[p]);
+            }
+          items[p].clear();
+          items[p].shrink_to_fit();
+        }
+
+      vector<size_t> recvcounts, rdispls;
+      vector<char> recvbuf;
+      throw_assert(alltoallv_vector<char>(comm, MPI_CHAR, sendcounts, sdispls, sendbuf,
+                                          recvcounts, rdispls, recvbuf) >= 0,
+                   "assign_node_ranks: error in alltoallv_vector");
+      sendbuf.clear();
+
+      recv_items.resize(recvbuf.size() / sizeof(T));
+      if (recvbuf.size() > 0)
+        {
+          memcpy(recv_items.data(), recvbuf.data(), recvbuf.size());
+        }
+    }
+
+
+    /// Distributed sample sort of items by (key, node). Items with equal
+    /// key and node are placed on the same rank. Each rank draws regular
+    /// samples in proportion to its share of the items, so that about
+    /// sample_sort_oversample * size samples are gathered on rank 0 in
+    /// total; rank 0 chooses the size-1 splitters and broadcasts them.
+    static const size_t sample_sort_oversample = 32;
+
+    static void sample_sort (MPI_Comm comm, vector<node_rank_item>& items)
+    {
+      int rank, size;
+      throw_assert_nomsg(MPI_Comm_rank(comm, &rank) == MPI_SUCCESS);
+      throw_assert_nomsg(MPI_Comm_size(comm, &size) == MPI_SUCCESS);
+
+      std::sort(items.begin(), items.end(), item_less);
+      if (size == 1)
+        return;
+
+      uint64_t num_items = items.size(), total_num_items = 0;
+      throw_assert(MPI_Allreduce(&num_items, &total_num_items, 1, MPI_UINT64_T, MPI_SUM, comm) == MPI_SUCCESS,
+                   "assign_node_ranks: error in MPI_Allreduce");
+
+      // regular samples of the local items
+      vector<node_rank_item> samples;
+      if (num_items > 0)
+        {
+          const uint64_t total_num_samples = sample_sort_oversample * size;
+          size_t num_local_samples =
+            std::min(num_items, std::max((uint64_t)1, (total_num_samples * num_items) / total_num_items));
+          for (size_t k = 0; k < num_local_samples; k++)
+            {
+              samples.push_back(items[(k * num_items) / num_local_samples]);
+            }
+        }
+
+      int samples_size = samples.size() * sizeof(node_rank_item);
+      vector<int> recvcounts(size, 0), rdispls(size, 0);
+      throw_assert(MPI_Gather(&samples_size, 1, MPI_INT,
+                              &recvcounts[0], 1, MPI_INT, 0, comm) == MPI_SUCCESS,
+                   "assign_node_ranks: error in MPI_Gather");
+      size_t total_samples_size = recvcounts[0];
+      for (int p = 1; p < size; p++)
+        {
+          rdispls[p] = rdispls[p-1] + recvcounts[p-1];
+          total_samples_size += recvcounts[p];
+        }
+      vector<node_rank_item> all_samples;
+      if (rank == 0)
+        {
+          all_samples.resize(total_samples_size / sizeof(node_rank_item));
+        }
+      throw_assert(MPI_Gatherv(samples.data(), samples_size, MPI_BYTE,
+                               all_samples.data(), &recvcounts[0], &rdispls[0], MPI_BYTE,
+                               0, comm) == MPI_SUCCESS,
+                   "assign_node_ranks: error in MPI_Gatherv");
+
+      vector<node_rank_item> splitters;
+      if (rank == 0)
+        {
+          std::sort(all_samples.begin(), all_samples.end(), item_less);
+          if (all_samples.size() > 0)
+            {
+              for (int k = 1; k < size; k++)
+                {
+                  splitters.push_back(all_samples[(k * all_samples.size()) / size]);
+                }
+            }
+        }
+      int num_splitters = splitters.size();
+      throw_assert(MPI_Bcast(&num_splitters, 1, MPI_INT, 0, comm) == MPI_SUCCESS,
+                   "assign_node_ranks: error in MPI_Bcast");
+      splitters.resize(num_splitters);
+      if (num_splitters > 0)
+        {
+          throw_assert(MPI_Bcast(splitters.data(), num_splitters * sizeof(node_rank_item),
+                                 MPI_BYTE, 0, comm) == MPI_SUCCESS,
+                       "assign_node_ranks: error in MPI_Bcast");
+        }
+
+      // items are sorted, so each destination receives a contiguous range
+      vector< vector<node_rank_item> > send_items(size);
+      for (const node_rank_item& item : items)
+        {
+          size_t dst = std::upper_bound(splitters.begin(), splitters.end(), item, item_less) -
+            splitters.begin();
+          send_items[dst].push_back(item);
+        }
+      items.clear();
+      exchange_items(comm, send_items, items);
+      std::sort(items.begin(), items.end(), item_less);
+    }
+
+
+    /// Hilbert index of a point with 21-bit coordinates (J. Skilling,
+    /// "Programming the Hilbert curve", AIP Conf. Proc. 707, 2004).
+    static uint64_t hilbert_index (uint32_t x[3])
+    {
+      const int n = 3, b = 21;
+      const uint32_t m = 1U << (b-1);
+
+      // inverse undo
+      for (uint32_t q = m; q > 1; q >>= 1)
+        {
+          const uint32_t p = q - 1;
+          for (int i = 0; i < n; i++)
+            {
+              if (x[i] & q)
+                {
+                  x[0] ^= p;
+                }
+              else
+                {
+                  const uint32_t t = (x[0] ^ x[i]) & p;
+                  x[0] ^= t;
+                  x[i] ^= t;
+                }
+            }
+        }
+
+      // Gray encode
+      for (int i = 1; i < n; i++)
+        {
+          x[i] ^= x[i-1];
+        }
+      uint32_t t = 0;
+      for (uint32_t q = m; q > 1; q >>= 1)
+        {
+          if (x[n-1] & q)
+            {
+              t ^= q - 1;
+            }
+        }
+      for (int i = 0; i < n; i++)
+        {
+          x[i] ^= t;
+        }
+
+      uint64_t h = 0;
+      for (int j = b-1; j >= 0; j--)
+        {
+          for (int i = 0; i < n; i++)
+            {
+              h = (h << 1) | ((x[i] >> j) & 1);
+            }
+        }
+      return h;
+    }
+
+
+    /// Sets the sort key of each item to the Hilbert index of its
+    /// coordinates within the global bounding box. Returns false if all
+    /// coordinates are equal.
+    static bool hilbert_keys (MPI_Comm comm, vector<node_rank_item>& items)
+    {
+      float local_min[3], local_max[3], global_min[3], global_max[3];
+      for (int d = 0; d < 3; d++)
+        {
+          local_min[d] = std::numeric_limits<float>::max();
+          local_max[d] = std::numeric_limits<float>::lowest();
+        }
+      for (const node_rank_item& item : items)
+        {
+          for (int d = 0; d < 3; d++)
+            {
+              local_min[d] = std::min(local_min[d], item.coords[d]);
+              local_max[d] = std::max(local_max[d], item.coords[d]);
+            }
+        }
+      throw_assert(MPI_Allreduce(local_min, global_min, 3, MPI_FLOAT, MPI_MIN, comm) == MPI_SUCCESS,
+                   "assign_node_ranks: error in MPI_Allreduce");
+      throw_assert(MPI_Allreduce(local_max, global_max, 3, MPI_FLOAT, MPI_MAX, comm) == MPI_SUCCESS,
+                   "assign_node_ranks: error in MPI_Allreduce");
+
+      double extent = 0.0;
+      for (int d = 0; d < 3; d++)
+        {
+          extent = std::max(extent, (double)global_max[d] - (double)global_min[d]);
+        }
+      if (!(extent > 0.0))
+        return false;
+
+      const double scale = (double)((1U << 21) - 1) / extent;
+      for (node_rank_item& item : items)
+        {
+          uint32_t x[3];
+          for (int d = 0; d < 3; d++)
+            {
+              x[d] = (uint32_t)std::floor(((double)item.coords[d] - (double)global_min[d]) * scale);
+            }
+          item.key = hilbert_index(x);
+        }
+      return true;
+    }
+
+
+    /// Orders the target ranks by shared-memory node, and by rank within
+    /// each node.
+    static void hierarchical_rank_order (MPI_Comm comm, vector<rank_t>& target_ranks)
+    {
+      int rank, size;
+      throw_assert_nomsg(MPI_Comm_rank(comm, &rank) == MPI_SUCCESS);
+      throw_assert_nomsg(MPI_Comm_size(comm, &size) == MPI_SUCCESS);
+
+      MPI_Comm host_comm;
+      throw_assert(MPI_Comm_split_type(comm, MPI_COMM_TYPE_SHARED, rank,
+                                       MPI_INFO_NULL, &host_comm) == MPI_SUCCESS,
+                   "assign_node_ranks: error in MPI_Comm_split_type");
+      // each host is identified by its lowest rank
+      int host_id = rank, host_leader = rank;
+      throw_assert(MPI_Allreduce(&host_id, &host_leader, 1, MPI_INT, MPI_MIN, host_comm) == MPI_SUCCESS,
+                   "assign_node_ranks: error in MPI_Allreduce");
+      throw_assert_nomsg(MPI_Comm_free(&host_comm) == MPI_SUCCESS);
+
+      vector<int> host_leaders(size, 0);
+      throw_assert(MPI_Allgather(&host_leader, 1, MPI_INT,
+                                 &host_leaders[0], 1, MPI_INT, comm) == MPI_SUCCESS,
+                   "assign_node_ranks: error in MPI_Allgather");
+
+      std::stable_sort(target_ranks.begin(), target_ranks.end(),
+                       [&] (rank_t a, rank_t b) { return host_leaders[a] < host_leaders[b]; });
+    }
+
+
+    NodeRankStrategy parse_node_rank_strategy (const string& name)
+    {
+      if (name == "round_robin")
+        return NodeRankRoundRobin;
+      if (name == "greedy")
+        return NodeRankGreedy;
+      if (name == "hilbert")
+        return NodeRankHilbert;
+      throw_assert(name == "hierarchical",
+                   "parse_node_rank_strategy: unknown strategy " << name);
+      return NodeRankHierarchical;
+    }
+
+
+    void assign_node_ranks
+    (
+     MPI_Comm comm,
+     const set<size_t> &rank_set,
+     const vector<NodeRankInput> &local_nodes,
+     const NodeRankStrategy strategy,
+     size_t &total_num_nodes,
+     map<NODE_IDX_T, rank_t> &node_rank_map,
+     vector<NODE_IDX_T> &assigned_nodes
+     )
+    {
+      int srank, ssize;
+      throw_assert_nomsg(MPI_Comm_rank(comm, &srank) == MPI_SUCCESS);
+      throw_assert_nomsg(MPI_Comm_size(comm, &ssize) == MPI_SUCCESS);
+      const rank_t rank = srank;
+      const size_t size = ssize;
+
+      throw_assert(rank_set.size() > 0,
+                   "assign_node_ranks: empty rank set");
+      vector<rank_t> target_ranks;
+      for (const size_t r : rank_set)
+        {
+          throw_assert(r < size, "assign_node_ranks: invalid rank " << r);
+          target_ranks.push_back(r);
+        }
+      const size_t num_bins = target_ranks.size();
+
+      // 1. Sort by node index and combine the entries of each node
+      vector<node_rank_item> items;
+      items.reserve(local_nodes.size());
+      for (const NodeRankInput& input : local_nodes)
+        {
+          throw_assert(input.weight >= 0.0,
+                       "assign_node_ranks: negative weight for node " << input.node);
+          node_rank_item item;
+          item.key    = input.node;
+          item.node   = input.node;
+          item.origin = rank;
+          item.weight = input.weight;
+          memcpy(item.coords, input.coords, sizeof(item.coords));
+          items.push_back(item);
+        }
+      sample_sort(comm, items);
+
+      // origins of the nodes held by this rank after the first sort
+      map<NODE_IDX_T, vector<rank_t> > node_origins;
+      vector<node_rank_item> nodes;
+      for (const node_rank_item& item : items)
+        {
+          if (nodes.empty() || (nodes.back().node != item.node))
+            {
+              nodes.push_back(item);
+              nodes.back().origin = rank;
+            }
+          else
+            {
+              nodes.back().weight += item.weight;
+            }
+          vector<rank_t>& origins = node_origins[item.node];
+          if (origins.empty() || (origins.back() != item.origin))
+            {
+              origins.push_back(item.origin);
+            }
+        }
+      items.clear();
+      items.shrink_to_fit();
+
+      // 2. Sort by the key of the strategy
+      bool contiguous = false;
+      switch (strategy)
+        {
+        case NodeRankRoundRobin:
+          break;
+        case NodeRankGreedy:
+          for (node_rank_item& item : nodes)
+            {
+              // the bit patterns of non-negative doubles are ordered as
+              // the values; the complement sorts by decreasing weight
+              uint64_t bits;
+              memcpy(&bits, &item.weight, sizeof(bits));
+              item.key = ~bits;
+            }
+          break;
+        case NodeRankHilbert:
+          throw_assert(hilbert_keys(comm, nodes),
+                       "assign_node_ranks: Hilbert ordering requires node coordinates");
+          contiguous = true;
+          break;
+        case NodeRankHierarchical:
+          hilbert_keys(comm, nodes);
+          hierarchical_rank_order(comm, target_ranks);
+          contiguous = true;
+          break;
+        }
+      sample_sort(comm, nodes);
+
+      // 3. Global position and weight prefix of the local nodes
+      uint64_t local_count = nodes.size(), count_offset = 0, total_count = 0;
+      double local_weight = 0.0, weight_offset = 0.0, total_weight = 0.0;
+      for (const node_rank_item& item : nodes)
+        {
+          local_weight += item.weight;
+        }
+      throw_assert(MPI_Exscan(&local_count, &count_offset, 1, MPI_UINT64_T, MPI_SUM, comm) == MPI_SUCCESS,
+                   "assign_node_ranks: error in MPI_Exscan");
+      throw_assert(MPI_Exscan(&local_weight, &weight_offset, 1, MPI_DOUBLE, MPI_SUM, comm) == MPI_SUCCESS,
+                   "assign_node_ranks: error in MPI_Exscan");
+      if (rank == 0)
+        {
+          count_offset = 0;
+          weight_offset = 0.0;
+        }
+      throw_assert(MPI_Allreduce(&local_count, &total_count, 1, MPI_UINT64_T, MPI_SUM, comm) == MPI_SUCCESS,
+                   "assign_node_ranks: error in MPI_Allreduce");
+      throw_assert(MPI_Allreduce(&local_weight, &total_weight, 1, MPI_DOUBLE, MPI_SUM, comm) == MPI_SUCCESS,
+                   "assign_node_ranks: error in MPI_Allreduce");
+      total_num_nodes = total_count;
+
+      // 4. Assign a bin to each node
+      vector< vector<node_rank_result> > results(size);
+      vector< vector<NODE_IDX_T> > bin_nodes(size);
+      uint64_t pos = count_offset;
+      double weight_prefix = weight_offset;
+      for (const node_rank_item& item : nodes)
+        {
+          size_t bin = 0;
+          if (contiguous)
+            {
+              if (total_weight > 0.0)
+                {
+                  bin = (size_t)(((weight_prefix + 0.5 * item.weight) / total_weight) * num_bins);
+                }
+              else
+                {
+                  bin = (pos * num_bins) / total_count;
+                }
+              bin = std::min(bin, num_bins-1);
+            }
+          else if (strategy == NodeRankGreedy)
+            {
+              const size_t round = pos / num_bins, j = pos % num_bins;
+              bin = (round % 2 == 0) ? j : (num_bins - 1 - j);
+            }
+          else
+            {
+              bin = pos % num_bins;
+            }
+          const rank_t node_rank = target_ranks[bin];
+          results[item.origin].push_back(node_rank_result { item.node, node_rank });
+          bin_nodes[node_rank].push_back(item.node);
+          pos++;
+          weight_prefix += item.weight;
+        }
+      nodes.clear();
+      nodes.shrink_to_fit();
+
+      // 5. Return the assignments to the ranks that hold the node origins
+      //    after the first sort, and from there to the origins
+      vector<node_rank_result> node_results;
+      exchange_items(comm, results, node_results);
+      results.resize(size);
+      for (const node_rank_result& result : node_results)
+        {
+          for (const rank_t origin : node_origins[result.node])
+            {
+              results[origin].push_back(result);
+            }
+        }
+      node_origins.clear();
+      exchange_items(comm, results, node_results);
+
+      node_rank_map.clear();
+      for (const node_rank_result& result : node_results)
+        {
+          node_rank_map.insert(make_pair(result.node, result.rank));
+        }
+
+      exchange_items(comm, bin_nodes, assigned_nodes);
+      std::sort(assigned_nodes.begin(), assigned_nodes.end());
+    }
+
+  }
+}
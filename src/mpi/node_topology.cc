@@ -0,0 +1,94 @@
+// -*- mode: c++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+//==============================================================================
+///  @file node_topology.cc
+///
+///  The shared-memory nodes of a communicator, as used by the
+///  node-aggregated exchange.
+///
+///  Copyright (C) 2016-2025 Project NeuroH5.
+//==============================================================================
+
+#include <mpi.h>
+
+#include <map>
+#include <vector>
+
+#include "node_topology.hh"
+#include "throw_assert.hh"
+
+using namespace std;
+
+namespace neuroh5
+{
+
+  namespace mpi
+  {
+
+    NodeTopology::NodeTopology (MPI_Comm comm, MPI_Comm node_comm)
+      : node_comm(node_comm)
+    {
+      int rank, size;
+      throw_assert_nomsg(MPI_Comm_rank(comm, &rank) == MPI_SUCCESS);
+      throw_assert_nomsg(MPI_Comm_size(comm, &size) == MPI_SUCCESS);
+      throw_assert_nomsg(MPI_Comm_rank(node_comm, &node_rank) == MPI_SUCCESS);
+      throw_assert_nomsg(MPI_Comm_size(node_comm, &node_size) == MPI_SUCCESS);
+
+      node_ranks.resize(node_size, 0);
+      throw_assert(MPI_Allgather(&rank, 1, MPI_INT, &node_ranks[0], 1, MPI_INT,
+                                 node_comm) == MPI_SUCCESS,
+                   "NodeTopology: error in MPI_Allgather");
+      const int node_leader = node_ranks[0];
+      rank_leaders.resize(size, 0);
+      throw_assert(MPI_Allgather(&node_leader, 1, MPI_INT, &rank_leaders[0], 1, MPI_INT,
+                                 comm) == MPI_SUCCESS,
+                   "NodeTopology: error in MPI_Allgather");
+
+      for (int i = 0; i < size; i++)
+        {
+          node_members[rank_leaders[i]].push_back(i);
+        }
+    }
+
+
+    // Frees the cached topology of a communicator that is being freed
+    static int delete_node_topology (MPI_Comm comm, int keyval, void *attr, void *extra_state)
+    {
+      NodeTopology *topology = static_cast<NodeTopology*>(attr);
+      int status = MPI_Comm_free(&(topology->node_comm));
+      delete topology;
+      return status;
+    }
+
+
+    const NodeTopology& node_topology (MPI_Comm comm)
+    {
+      static int keyval = MPI_KEYVAL_INVALID;
+      if (keyval == MPI_KEYVAL_INVALID)
+        {
+          throw_assert(MPI_Comm_create_keyval(MPI_COMM_NULL_COPY_FN, delete_node_topology,
+                                              &keyval, NULL) == MPI_SUCCESS,
+                       "node_topology: error in MPI_Comm_create_keyval");
+        }
+
+      void *attr; int found = 0;
+      throw_assert(MPI_Comm_get_attr(comm, keyval, &attr, &found) == MPI_SUCCESS,
+                   "node_topology: error in MPI_Comm_get_attr");
+      if (found)
+        {
+          return *static_cast<NodeTopology*>(attr);
+        }
+
+      int rank;
+      throw_assert_nomsg(MPI_Comm_rank(comm, &rank) == MPI_SUCCESS);
+      MPI_Comm node_comm;
+      throw_assert(MPI_Comm_split_type(comm, MPI_COMM_TYPE_SHARED, rank,
+                                       MPI_INFO_NULL, &node_comm) == MPI_SUCCESS,
+                   "node_topology: error in MPI_Comm_split_type");
+      NodeTopology *topology = new NodeTopology(comm, node_comm);
+      throw_assert(MPI_Comm_set_attr(comm, keyval, topology) == MPI_SUCCESS,
+                   "node_topology: error in MPI_Comm_set_attr");
+      return *topology;
+    }
+
+  }
+}
@@ -0,0 +1,320 @@
+// -*- mode: c++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+//==============================================================================
+///  @file phase_stats.cc
+///
+///  Runtime instrumentation of the phases of collective reads and writes.
+///
+///  Copyright (C) 2016-2025 Project NeuroH5.
+//==============================================================================
+
+#include <mpi.h>
+#include <sys/resource.h>
+
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <mutex>
+#include <set>
+#include <sstream>
+
+#include "phase_stats.hh"
+#include "throw_assert.hh"
+
+using namespace std;
+
+namespace neuroh5
+{
+
+  namespace mpi
+  {
+
+    const vector<string> phase_counter_names = {
+      "time", "calls", "bytes_read", "bytes_written",
+      "bytes_sent", "bytes_recv", "messages_sent", "messages_recv"
+    };
+
+    static bool stats_enabled_from_env ()
+    {
+      const char* env = getenv("NEUROH5_STATS");
+      return (env != nullptr) && (strlen(env) > 0) && (strcmp(env, "0") != 0);
+    }
+
+    bool stats_enabled_flag = stats_enabled_from_env();
+
+    // counters by phase name, and names of the phases running on each
+    // thread; phase_counters is guarded by phase_mutex
+    static map<string, PhaseCounters> phase_counters;
+    static thread_local vector<string> phase_stack;
+    static mutex phase_mutex;
+
+    static PhaseCounters& current_phase ()
+    {
+      return phase_counters[phase_stack.empty() ? string("unscoped") : phase_stack.back()];
+    }
+
+    void enable_stats (bool enabled)
+    {
+      stats_enabled_flag = enabled;
+    }
+
+    void reset_stats ()
+    {
+      lock_guard<mutex> lock(phase_mutex);
+      phase_counters.clear();
+    }
+
+    PhaseTimer::PhaseTimer (const char* name)
+      : active(stats_enabled()), start(0.0)
+    {
+      if (active)
+        {
+          if (phase_stack.empty())
+            {
+              phase_stack.push_back(string(name));
+            }
+          else
+            {
+              phase_stack.push_back(phase_stack.back() + "/" + name);
+            }
+          start = MPI_Wtime();
+        }
+    }
+
+    PhaseTimer::~PhaseTimer ()
+    {
+      if (active)
+        {
+          lock_guard<mutex> lock(phase_mutex);
+          PhaseCounters& counters = phase_counters[phase_stack.back()];
+          counters.time += MPI_Wtime() - start;
+          counters.calls++;
+          phase_stack.pop_back();
+        }
+    }
+
+    void count_read (uint64_t bytes)
+    {
+      if (stats_enabled())
+        {
+          lock_guard<mutex> lock(phase_mutex);
+          current_phase().bytes_read += bytes;
+        }
+    }
+
+    void count_write (uint64_t bytes)
+    {
+      if (stats_enabled())
+        {
+          lock_guard<mutex> lock(phase_mutex);
+          current_phase().bytes_written += bytes;
+        }
+    }
+
+    void count_sent (uint64_t bytes, uint64_t messages)
+    {
+      if (stats_enabled())
+        {
+          lock_guard<mutex> lock(phase_mutex);
+          PhaseCounters& counters = current_phase();
+          counters.bytes_sent += bytes;
+          counters.messages_sent += messages;
+        }
+    }
+
+    void count_recv (uint64_t bytes, uint64_t messages)
+    {
+      if (stats_enabled())
+        {
+          lock_guard<mutex> lock(phase_mutex);
+          PhaseCounters& counters = current_phase();
+          counters.bytes_recv += bytes;
+          counters.messages_recv += messages;
+        }
+    }
+
+    const map<string, PhaseCounters>& local_stats ()
+    {
+      return phase_counters;
+    }
+
+    uint64_t peak_rss ()
+    {
+      struct rusage usage;
+      if (getrusage(RUSAGE_SELF, &usage) != 0)
+        {
+          return 0;
+        }
+#ifdef __APPLE__
+      return usage.ru_maxrss;
+#else
+      return (uint64_t)usage.ru_maxrss * 1024;
+#endif
+    }
+
+    static StatSummary summarize (double min_value, double max_value, double sum, int size)
+    {
+      StatSummary summary;
+      summary.min  = min_value;
+      summary.max  = max_value;
+      summary.mean = sum / size;
+      summary.imbalance = (summary.mean > 0.0) ? (max_value / summary.mean) : 1.0;
+      return summary;
+    }
+
+    void collect_stats (MPI_Comm comm, StatsReport& report)
+    {
+      int rank, size;
+      throw_assert_nomsg(MPI_Comm_size(comm, &size) == MPI_SUCCESS);
+      throw_assert_nomsg(MPI_Comm_rank(comm, &rank) == MPI_SUCCESS);
+
+      // a snapshot of the counters of this rank
+      map<string, PhaseCounters> counters_snapshot;
+      {
+        lock_guard<mutex> lock(phase_mutex);
+        counters_snapshot = phase_counters;
+      }
+
+      // union of the phase names of all ranks
+      string local_names;
+      for (const auto& iter : counters_snapshot)
+        {
+          local_names += iter.first;
+          local_names.push_back('\0');
+        }
+      int local_names_size = local_names.size();
+      vector<int> names_sizes(size, 0), names_displs(size, 0);
+      throw_assert(MPI_Allgather(&local_names_size, 1, MPI_INT, &names_sizes[0], 1, MPI_INT,
+                                 comm) == MPI_SUCCESS,
+                   "collect_stats: error in MPI_Allgather");
+      for (int p = 1; p < size; p++)
+        {
+          names_displs[p] = names_displs[p-1] + names_sizes[p-1];
+        }
+      vector<char> all_names(names_displs[size-1] + names_sizes[size-1] + 1, '\0');
+      throw_assert(MPI_Allgatherv(local_names.data(), local_names_size, MPI_CHAR,
+                                  &all_names[0], &names_sizes[0], &names_displs[0], MPI_CHAR,
+                                  comm) == MPI_SUCCESS,
+                   "collect_stats: error in MPI_Allgatherv");
+      set<string> phase_names;
+      for (size_t pos = 0; pos + 1 < all_names.size(); )
+        {
+          string name(&all_names[pos]);
+          pos += name.size() + 1;
+          phase_names.insert(name);
+        }
+
+      // counters of every phase, followed by the peak RSS
+      const size_t num_counters = phase_counter_names.size();
+      vector<double> values;
+      values.reserve(phase_names.size() * num_counters + 1);
+      for (const string& name : phase_names)
+        {
+          PhaseCounters counters;
+          auto it = counters_snapshot.find(name);
+          if (it != counters_snapshot.end())
+            {
+              counters = it->second;
+            }
+          values.push_back(counters.time);
+          values.push_back(counters.calls);
+          values.push_back(counters.bytes_read);
+          values.push_back(counters.bytes_written);
+          values.push_back(counters.bytes_sent);
+          values.push_back(counters.bytes_recv);
+          values.push_back(counters.messages_sent);
+          values.push_back(counters.messages_recv);
+        }
+      values.push_back(peak_rss());
+
+      vector<double> min_values(values.size()), max_values(values.size()), sum_values(values.size());
+      throw_assert(MPI_Allreduce(&values[0], &min_values[0], values.size(), MPI_DOUBLE, MPI_MIN,
+                                 comm) == MPI_SUCCESS,
+                   "collect_stats: error in MPI_Allreduce");
+      throw_assert(MPI_Allreduce(&values[0], &max_values[0], values.size(), MPI_DOUBLE, MPI_MAX,
+                                 comm) == MPI_SUCCESS,
+                   "collect_stats: error in MPI_Allreduce");
+      throw_assert(MPI_Allreduce(&values[0], &sum_values[0], values.size(), MPI_DOUBLE, MPI_SUM,
+                                 comm) == MPI_SUCCESS,
+                   "collect_stats: error in MPI_Allreduce");
+
+      report.num_ranks = size;
+      report.phases.clear();
+      size_t k = 0;
+      for (const string& name : phase_names)
+        {
+          map<string, StatSummary>& phase = report.phases[name];
+          for (const string& counter_name : phase_counter_names)
+            {
+              phase[counter_name] = summarize(min_values[k], max_values[k], sum_values[k], size);
+              k++;
+            }
+        }
+      report.peak_rss_bytes = summarize(min_values[k], max_values[k], sum_values[k], size);
+    }
+
+    static string json_string (const string& s)
+    {
+      string result = "\"";
+      for (char c : s)
+        {
+          if ((c == '"') || (c == '\\'))
+            {
+              result.push_back('\\');
+            }
+          result.push_back(c);
+        }
+      result.push_back('"');
+      return result;
+    }
+
+    static void json_summary (ostream& os, const StatSummary& summary)
+    {
+      os << "{\"min\": " << summary.min
+         << ", \"mean\": " << summary.mean
+         << ", \"max\": " << summary.max
+         << ", \"imbalance\": " << summary.imbalance << "}";
+    }
+
+    string stats_json (const StatsReport& report)
+    {
+      ostringstream os;
+      os << setprecision(9);
+      os << "{\"ranks\": " << report.num_ranks << ", \"peak_rss_bytes\": ";
+      json_summary(os, report.peak_rss_bytes);
+      os << ", \"phases\": {";
+      bool first_phase = true;
+      for (const auto& phase_iter : report.phases)
+        {
+          os << (first_phase ? "" : ", ") << json_string(phase_iter.first) << ": {";
+          first_phase = false;
+          bool first_counter = true;
+          for (const auto& counter_iter : phase_iter.second)
+            {
+              os << (first_counter ? "" : ", ") << json_string(counter_iter.first) << ": ";
+              first_counter = false;
+              json_summary(os, counter_iter.second);
+            }
+          os << "}";
+        }
+      os << "}}";
+      return os.str();
+    }
+
+    void write_stats (MPI_Comm comm, const string& file_name)
+    {
+      int rank;
+      throw_assert_nomsg(MPI_Comm_rank(comm, &rank) == MPI_SUCCESS);
+
+      StatsReport report;
+      collect_stats(comm, report);
+      if (rank == 0)
+        {
+          ofstream out(file_name.c_str(), ios::app);
+          throw_assert(out.good(), "write_stats: unable to open file " << file_name);
+          out << stats_json(report) << endl;
+        }
+    }
+
+  }
+}
@@ -0,0 +1,206 @@
+// -*- mode: c++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+//==============================================================================
+///  @file shared_segment.cc
+///
+///  Memory segments shared by the ranks of each shared-memory node.
+///
+///  Copyright (C) 2016-2025 Project NeuroH5.
+//==============================================================================
+
+#include <mpi.h>
+
+#include <algorithm>
+#include <climits>
+#include <map>
+#include <mutex>
+#include <vector>
+
+#include "shared_segment.hh"
+#include "throw_assert.hh"
+
+using namespace std;
+
+namespace neuroh5
+{
+
+  namespace mpi
+  {
+
+    /// A segment destroyed on this rank and not yet freed
+    struct ReleasedSegment
+    {
+      SharedSegment::key_t key;
+      int      node_size;
+      MPI_Comm node_comm;
+      MPI_Comm leader_comm;
+      MPI_Win  win;
+    };
+
+    // segments are destroyed by whichever thread drops the last view
+    static mutex released_segments_mutex;
+    static vector<ReleasedSegment> released_segments;
+    // number of segments created with this rank as the root rank
+    static uint64_t num_root_segments = 0;
+
+
+    SharedSegment::SharedSegment (MPI_Comm comm, size_t size, int root)
+      : node_size_(0), node_comm_(MPI_COMM_NULL), leader_comm_(MPI_COMM_NULL),
+        win_(MPI_WIN_NULL), data_(nullptr), size_(size)
+    {
+      int rank, world_rank;
+      throw_assert_nomsg(MPI_Comm_rank(comm, &rank) == MPI_SUCCESS);
+      throw_assert_nomsg(MPI_Comm_rank(MPI_COMM_WORLD, &world_rank) == MPI_SUCCESS);
+      is_root_ = (rank == root);
+
+      uint64_t header[3] = { size_, (uint64_t)world_rank, 0 };
+      if (is_root_)
+        {
+          header[2] = num_root_segments++;
+        }
+      throw_assert(MPI_Bcast(header, 3, MPI_UINT64_T, root, comm) == MPI_SUCCESS,
+                   "SharedSegment: error in MPI_Bcast");
+      size_ = header[0];
+      key_[0] = header[1];
+      key_[1] = header[2];
+
+      // the root rank comes first on its node and among the node leaders
+      int key = is_root_ ? 0 : rank + 1;
+      throw_assert(MPI_Comm_split_type(comm, MPI_COMM_TYPE_SHARED, key,
+                                       MPI_INFO_NULL, &node_comm_) == MPI_SUCCESS,
+                   "SharedSegment: error in MPI_Comm_split_type");
+      int node_rank;
+      throw_assert_nomsg(MPI_Comm_rank(node_comm_, &node_rank) == MPI_SUCCESS);
+      throw_assert_nomsg(MPI_Comm_size(node_comm_, &node_size_) == MPI_SUCCESS);
+      uint64_t leader_world_rank = world_rank;
+      throw_assert(MPI_Bcast(&leader_world_rank, 1, MPI_UINT64_T, 0, node_comm_) == MPI_SUCCESS,
+                   "SharedSegment: error in MPI_Bcast");
+      key_[2] = leader_world_rank;
+      throw_assert(MPI_Comm_split(comm, (node_rank == 0) ? 0 : MPI_UNDEFINED, key,
+                                  &leader_comm_) == MPI_SUCCESS,
+                   "SharedSegment: error in MPI_Comm_split");
+
+      char* base = nullptr;
+      throw_assert(MPI_Win_allocate_shared((node_rank == 0) ? size_ : 0, 1, MPI_INFO_NULL,
+                                           node_comm_, &base, &win_) == MPI_SUCCESS,
+                   "SharedSegment: error in MPI_Win_allocate_shared");
+      MPI_Aint query_size;
+      int disp_unit;
+      throw_assert(MPI_Win_shared_query(win_, 0, &query_size, &disp_unit, &data_) == MPI_SUCCESS,
+                   "SharedSegment: error in MPI_Win_shared_query");
+      throw_assert((size_t)query_size == size_,
+                   "SharedSegment: unexpected size of shared segment");
+    }
+
+
+    SharedSegment::~SharedSegment ()
+    {
+      // segments that outlive MPI (e.g. held by Python objects at exit)
+      // are released with the process
+      int finalized = 0;
+      MPI_Finalized(&finalized);
+      if (finalized)
+        return;
+
+      lock_guard<mutex> guard(released_segments_mutex);
+      released_segments.push_back({ key_, node_size_, node_comm_, leader_comm_, win_ });
+    }
+
+
+    void SharedSegment::bcast ()
+    {
+      if (leader_comm_ != MPI_COMM_NULL)
+        {
+          // MPI counts are int, so the segment is sent in pieces
+          const size_t max_count = INT_MAX;
+          for (size_t offset = 0; offset < size_; offset += max_count)
+            {
+              int count = std::min(max_count, size_ - offset);
+              throw_assert(MPI_Bcast(data_ + offset, count, MPI_CHAR, 0, leader_comm_) == MPI_SUCCESS,
+                           "SharedSegment: error in MPI_Bcast");
+            }
+        }
+
+      // makes the stores of the node leader visible to the node
+      throw_assert(MPI_Win_fence(0, win_) == MPI_SUCCESS,
+                   "SharedSegment: error in MPI_Win_fence");
+      throw_assert(MPI_Barrier(node_comm_) == MPI_SUCCESS,
+                   "SharedSegment: error in MPI_Barrier");
+
+      // the communicators are not needed once the segment is complete
+      if (leader_comm_ != MPI_COMM_NULL)
+        {
+          throw_assert(MPI_Comm_free(&leader_comm_) == MPI_SUCCESS,
+                       "SharedSegment: error in MPI_Comm_free");
+        }
+      throw_assert(MPI_Comm_free(&node_comm_) == MPI_SUCCESS,
+                   "SharedSegment: error in MPI_Comm_free");
+    }
+
+
+    size_t release_shared_segments (MPI_Comm comm)
+    {
+      lock_guard<mutex> guard(released_segments_mutex);
+
+      int size;
+      throw_assert_nomsg(MPI_Comm_size(comm, &size) == MPI_SUCCESS);
+
+      vector<uint64_t> sendbuf;
+      for (const ReleasedSegment& segment : released_segments)
+        {
+          sendbuf.insert(sendbuf.end(), segment.key.begin(), segment.key.end());
+        }
+      int sendcount = sendbuf.size();
+      vector<int> recvcounts(size, 0), displs(size + 1, 0);
+      throw_assert(MPI_Allgather(&sendcount, 1, MPI_INT, recvcounts.data(), 1, MPI_INT,
+                                 comm) == MPI_SUCCESS,
+                   "release_shared_segments: error in MPI_Allgather");
+      for (int p = 0; p < size; p++)
+        {
+          displs[p+1] = displs[p] + recvcounts[p];
+        }
+      vector<uint64_t> recvbuf(max(displs[size], 1));
+      throw_assert(MPI_Allgatherv(sendbuf.data(), sendcount, MPI_UINT64_T,
+                                  recvbuf.data(), recvcounts.data(), displs.data(), MPI_UINT64_T,
+                                  comm) == MPI_SUCCESS,
+                   "release_shared_segments: error in MPI_Allgatherv");
+
+      // number of ranks that destroyed each segment
+      map<SharedSegment::key_t, int> num_released;
+      for (int i = 0; i < displs[size]; i += 3)
+        {
+          SharedSegment::key_t key = { recvbuf[i], recvbuf[i+1], recvbuf[i+2] };
+          num_released[key]++;
+        }
+
+      // the ranks of a node free their common segments in key order
+      sort(released_segments.begin(), released_segments.end(),
+           [] (const ReleasedSegment& a, const ReleasedSegment& b) { return a.key < b.key; });
+      size_t num_freed = 0;
+      vector<ReleasedSegment> kept;
+      for (ReleasedSegment& segment : released_segments)
+        {
+          if (num_released[segment.key] < segment.node_size)
+            {
+              kept.push_back(segment);
+              continue;
+            }
+          throw_assert(MPI_Win_free(&segment.win) == MPI_SUCCESS,
+                       "release_shared_segments: error in MPI_Win_free");
+          // only left if the segment was destroyed before bcast
+          if (segment.leader_comm != MPI_COMM_NULL)
+            {
+              throw_assert_nomsg(MPI_Comm_free(&segment.leader_comm) == MPI_SUCCESS);
+            }
+          if (segment.node_comm != MPI_COMM_NULL)
+            {
+              throw_assert_nomsg(MPI_Comm_free(&segment.node_comm) == MPI_SUCCESS);
+            }
+          num_freed++;
+        }
+      released_segments.swap(kept);
+
+      return num_freed;
+    }
+
+  }
+}
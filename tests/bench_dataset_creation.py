@@ -0,0 +1,106 @@
+##
+## Write throughput and compression ratio of graph and cell attribute
+## datasets for different dataset creation settings.
+##
+## Usage: mpirun -n N python bench_dataset_creation.py [output_dir] [nodes_per_rank] [edges_per_node]
+##
+
+import os, sys, time
+from mpi4py import MPI
+import h5py
+import numpy as np
+from neuroh5.io import write_graph, write_cell_attributes
+
+comm = MPI.COMM_WORLD
+rank = comm.Get_rank()
+size = comm.Get_size()
+
+output_dir = sys.argv[1] if len(sys.argv) > 1 else "data"
+nodes_per_rank = int(sys.argv[2]) if len(sys.argv) > 2 else 1000
+edges_per_node = int(sys.argv[3]) if len(sys.argv) > 3 else 100
+
+num_nodes = nodes_per_rank * size
+
+settings = [ ("deflate 9 (default)", None),
+             ("no compression", False),
+             ("deflate 1", 1),
+             ("deflate 4", 4),
+             ("shuffle + deflate 4", { 'level': 4, 'shuffle': True }),
+             ("shuffle + deflate 1 + fletcher32", { 'level': 1, 'shuffle': True, 'fletcher32': True }),
+             ("deflate 4, large value chunks", { 'level': 4, 'value_chunk_size': 1 << 16 }) ]
+
+path_population_labels = '/H5Types/Population labels'
+path_population_range = '/H5Types/Population range'
+
+
+def create_file(output_path):
+    pop_defs = [ ('SRC', 0, num_nodes, 0), ('DST', num_nodes, num_nodes, 1) ]
+    with h5py.File(output_path, "w") as h5:
+        mapping = { name: idx for name, start, count, idx in pop_defs }
+        h5[path_population_labels] = h5py.special_dtype(enum=(np.uint16, mapping))
+        h5[path_population_range] = np.dtype([("Start", np.uint64), ("Count", np.uint32),
+                                              ("Population", h5[path_population_labels].dtype)])
+        dt = h5[path_population_range].dtype
+        a = np.zeros(len(pop_defs), dtype=dt)
+        for name, start, count, idx in pop_defs:
+            a[idx]["Start"] = start
+            a[idx]["Count"] = count
+            a[idx]["Population"] = idx
+        h5['H5Types'].create_dataset('Populations', data=a, maxshape=(len(pop_defs),))
+
+
+def storage_sizes(output_path, group_name):
+    sizes = [0, 0]
+    def visit(name, obj):
+        if isinstance(obj, h5py.Dataset):
+            sizes[0] += obj.size * obj.dtype.itemsize
+            sizes[1] += obj.id.get_storage_size()
+    with h5py.File(output_path, "r") as h5:
+        h5[group_name].visititems(visit)
+    return sizes
+
+
+## Edges with sources clustered around the destination and a distance
+## attribute, which compress roughly like connectivity data
+rng = np.random.RandomState(rank)
+edges = {}
+cell_attrs = {}
+for i in range(nodes_per_rank):
+    dst = num_nodes + rank * nodes_per_rank + i
+    src = np.sort(np.clip(rng.normal(dst - num_nodes, num_nodes / 20., edges_per_node),
+                          0, num_nodes - 1)).astype(np.uint32)
+    distance = np.abs(src.astype(np.float32) - float(dst - num_nodes))
+    edges[dst] = (src, { 'Synapses': { 'distance': distance } })
+    cell_attrs[dst] = { 'weights': rng.lognormal(size=edges_per_node).astype(np.float32),
+                        'syn_ids': np.arange(edges_per_node, dtype=np.uint32) }
+
+if rank == 0:
+    print("%-36s %10s %10s %8s %10s %10s %8s" %
+          ("setting", "graph MB", "MB/s", "ratio", "attr MB", "MB/s", "ratio"))
+
+for i, (name, compression) in enumerate(settings):
+    output_path = os.path.join(output_dir, "bench_dataset_creation_%d.h5" % i)
+    if rank == 0:
+        create_file(output_path)
+    comm.barrier()
+
+    t0 = MPI.Wtime()
+    write_graph(output_path, 'SRC', 'DST', edges, comm=comm, compression=compression)
+    comm.barrier()
+    t_graph = MPI.Wtime() - t0
+
+    t0 = MPI.Wtime()
+    write_cell_attributes(output_path, 'DST', cell_attrs, namespace='Synapse Attributes',
+                          comm=comm, compression=compression)
+    comm.barrier()
+    t_attr = MPI.Wtime() - t0
+
+    if rank == 0:
+        graph_raw, graph_stored = storage_sizes(output_path, 'Projections')
+        attr_raw, attr_stored = storage_sizes(output_path, 'Populations')
+        print("%-36s %10.2f %10.2f %8.2f %10.2f %10.2f %8.2f" %
+              (name,
+               graph_raw / 1e6, graph_raw / 1e6 / t_graph, float(graph_raw) / max(graph_stored, 1),
+               attr_raw / 1e6, attr_raw / 1e6 / t_attr, float(attr_raw) / max(attr_stored, 1)))
+        os.remove(output_path)
+    comm.barrier()
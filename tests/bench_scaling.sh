@@ -0,0 +1,24 @@
+#!/bin/bash
+
+## Strong and weak scaling runs of the benchmark driver on one workstation.
+##
+## Usage: bench_scaling.sh [bench-binary] [results-file] [max-ranks]
+##
+## Results are appended to the CSV file, one row per phase and repetition.
+
+BENCH=${1:-./build/bin/neuroh5_bench}
+RESULTS=${2:-neuroh5_bench.csv}
+MAX_RANKS=${3:-$(nproc)}
+FILE=${TMPDIR:-/tmp}/neuroh5_bench.$$.h5
+
+ranks=1
+while [ $ranks -le $MAX_RANKS ]; do
+    io_size=$(( ranks < 4 ? ranks : 4 ))
+    ## strong scaling: fixed total problem size
+    mpirun -n $ranks $BENCH --cells=20000 --degree=100 --io-size=$io_size \
+           --output=$RESULTS $FILE || exit 1
+    ## weak scaling: fixed problem size per rank
+    mpirun -n $ranks $BENCH --cells-per-rank=5000 --degree=100 --io-size=$io_size \
+           --output=$RESULTS $FILE || exit 1
+    ranks=$(( ranks * 2 ))
+done
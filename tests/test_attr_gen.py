@@ -20,7 +20,8 @@ script_name = 'test_attr_gen.py'
 @click.option("--coords-namespace", type=str, default='Coordinates')
 @click.option("--io-size", type=int, default=-1)
 @click.option("--cache-size", type=int, default=10)
-def main(coords_path, coords_namespace, io_size, cache_size):
+@click.option("--prefetch", is_flag=True)
+def main(coords_path, coords_namespace, io_size, cache_size, prefetch):
 
     comm = MPI.COMM_WORLD
     rank = comm.rank
@@ -35,8 +36,12 @@ def main(coords_path, coords_namespace, io_size, cache_size):
     for population in population_ranges.keys():
 
         attr_iter = NeuroH5CellAttrGen(coords_path, population, namespace=coords_namespace, \
-                                        comm=comm, io_size=io_size, cache_size=cache_size)
+                                        comm=comm, io_size=io_size, cache_size=cache_size,
+                                        prefetch=prefetch)
 
+        # all ranks receive the same number of items, so they leave the
+        # loop together; close() releases the file and communicator of the
+        # unfinished generator on all ranks
         i = 0
         for cell_gid, coords_dict in attr_iter:
 
@@ -46,9 +51,10 @@ def main(coords_path, coords_namespace, io_size, cache_size):
                 cell_v = coords_dict['V Coordinate']
                 
                 print ('Rank %i: gid = %i u = %f v = %f' % (rank, cell_gid, cell_u, cell_v))
-                if i > 10:
-                    break
-                i = i+1
+            if i > 10:
+                break
+            i = i+1
+        attr_iter.close()
                 
     if rank == 0:
         import h5py
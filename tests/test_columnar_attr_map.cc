@@ -0,0 +1,89 @@
+// -*- mode: c++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+//==============================================================================
+///  @file test_columnar_attr_map.cc
+///
+///  Tests for the columnar cell attribute container.
+///
+///  Copyright (C) 2016-2025 Project NeuroH5.
+//==============================================================================
+
+#include <cstdio>
+#include <iostream>
+#include <string>
+#include <map>
+#include <vector>
+
+#undef NDEBUG
+#include <cassert>
+
+#include "neuroh5_types.hh"
+#include "columnar_attr_map.hh"
+#include "append_rank_attr_map.hh"
+#include "serialize_cell_attributes.hh"
+
+using namespace std;
+using namespace neuroh5;
+
+
+int main (int argc, char **argv)
+{
+  data::ColumnarAttrMap attr_map;
+
+  // values as returned by hdf5::read_cell_attribute for a block that
+  // does not start at the beginning of the value dataset
+  vector<CELL_IDX_T> index = { 4, 9, 12 };
+  vector<ATTR_PTR_T> ptr = { 2, 4, 5, 8 };
+  vector<float> values = { -1., -1., 0.5, 1.5, 2.5, 3.5, 4.5, 5.5 };
+  size_t x_index = attr_map.insert("x", std::move(index), std::move(ptr), std::move(values));
+  assert(x_index == 0);
+
+  // a second block appended out of order
+  attr_map.insert("x", vector<CELL_IDX_T>({ 2 }), vector<ATTR_PTR_T>({ 0, 1 }),
+                  vector<float>({ 7.5 }));
+  attr_map.insert("n", vector<CELL_IDX_T>({ 9, 20 }), vector<ATTR_PTR_T>({ 0, 1, 2 }),
+                  vector<uint32_t>({ 3, 4 }));
+
+  assert(attr_map.index == vector<CELL_IDX_T>({ 2, 4, 9, 12, 20 }));
+  const data::AttrColumn<float>& x = attr_map.columns<float>()[0];
+  assert(x.index == vector<CELL_IDX_T>({ 2, 4, 9, 12 }));
+  assert(x.ptr == vector<ATTR_PTR_T>({ 0, 1, 3, 4, 7 }));
+  assert(x.row_size(x.find(12)) == 3);
+  assert(x.row_data(x.find(12))[0] == 3.5);
+  assert(x.find(20) == x.size());
+  assert(attr_map.attr_index<uint32_t>("n") == 0);
+
+  // conversion to and from NamedAttrMap
+  data::NamedAttrMap named_attr_map;
+  attr_map.to_attr_map(named_attr_map);
+  assert(named_attr_map.find<float>(12)[0] == deque<float>({ 3.5, 4.5, 5.5 }));
+  data::ColumnarAttrMap converted;
+  converted.from_attr_map(named_attr_map);
+  assert(converted.index == attr_map.index);
+  assert(converted.columns<float>()[0].values == x.values);
+
+  // partitioning among ranks and serialization
+  node_rank_map_t node_rank_map;
+  node_rank_map[2].insert(0);
+  node_rank_map[4].insert(1);
+  node_rank_map[9].insert(1);
+  node_rank_map[12].insert(0);
+  node_rank_map[20].insert(1);
+  map <rank_t, data::ColumnarAttrMap> rank_attr_map;
+  data::append_rank_attr_map(attr_map, node_rank_map, rank_attr_map);
+  assert(rank_attr_map[0].index == vector<CELL_IDX_T>({ 2, 12 }));
+  assert(rank_attr_map[1].index == vector<CELL_IDX_T>({ 4, 9, 20 }));
+
+  vector<size_t> sendcounts, sdispls;
+  vector<char> sendbuf;
+  data::serialize_rank_attr_map(2, 0, rank_attr_map, sendcounts, sendbuf, sdispls);
+
+  data::ColumnarAttrMap received;
+  data::deserialize_rank_attr_map(2, sendbuf, sendcounts, sdispls, received);
+  assert(received.index == attr_map.index);
+  assert(received.columns<float>()[0].ptr == x.ptr);
+  assert(received.columns<float>()[0].values == x.values);
+  assert(received.columns<uint32_t>()[0].values == vector<uint32_t>({ 3, 4 }));
+
+  printf("test_columnar_attr_map: passed\n");
+  return 0;
+}
@@ -0,0 +1,125 @@
+// -*- mode: c++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+//==============================================================================
+///  @file test_compact_rank_map.cc
+///
+///  Tests for the compact node to rank map.
+///
+///  Copyright (C) 2016-2025 Project NeuroH5.
+//==============================================================================
+
+#include <cstdio>
+#include <set>
+#include <vector>
+
+#undef NDEBUG
+#include <cassert>
+
+#include "neuroh5_types.hh"
+#include "serialize_data.hh"
+
+using namespace std;
+using namespace neuroh5;
+
+
+int main (int argc, char **argv)
+{
+  // closed form round-robin and contiguous assignments
+  node_rank_map_t rr_map;
+  rr_map.assign_round_robin(10, 100, 4);
+  assert(rr_map.size() == 100);
+  assert(rr_map.find(9) == rr_map.end());
+  assert(rr_map.find(110) == rr_map.end());
+  assert(*(rr_map.find(15)->second.begin()) == 1);
+
+  node_rank_map_t block_map;
+  block_map.assign_contiguous(0, 10, 4);
+  vector<rank_t> block_ranks;
+  for (const auto& element : block_map)
+    {
+      assert(element.second.size() == 1);
+      block_ranks.push_back(*(element.second.begin()));
+    }
+  assert(block_ranks == vector<rank_t>({ 0, 0, 1, 1, 1, 2, 2, 3, 3, 3 }));
+
+  // explicit assignment, including a node assigned to two ranks and
+  // nodes spanning several pages
+  node_rank_map_t node_rank_map;
+  node_rank_map[5000].insert(2);
+  node_rank_map[3].insert(1);
+  node_rank_map[3].insert(0);
+  node_rank_map[3].insert(1);
+  node_rank_map[7].insert(3);
+  assert(node_rank_map.size() == 3);
+  assert(node_rank_map.count(4) == 0);
+  auto it = node_rank_map.find(3);
+  assert(it != node_rank_map.end());
+  assert(set<rank_t>(it->second) == set<rank_t>({ 0, 1 }));
+  assert(it->second.count(1) == 1);
+
+  vector<CELL_IDX_T> keys;
+  for (const auto& element : node_rank_map)
+    {
+      keys.push_back(element.first);
+    }
+  assert(keys == vector<CELL_IDX_T>({ 3, 7, 5000 }));
+
+  // a sparse selection takes a few bytes per node, one node per page
+  node_rank_map_t sparse_map;
+  for (CELL_IDX_T i = 0; i < 1000; i++)
+    {
+      sparse_map[i * 1500 + 7].insert(i % 3);
+    }
+  vector<char> sparse_buf;
+  data::serialize_data(sparse_map, sparse_buf);
+  assert(sparse_buf.size() < 1000 * 64);
+  assert(*(sparse_map.find(1507)->second.begin()) == 1);
+  assert(sparse_map.count(1508) == 0);
+
+  // a page filled out of order becomes dense without losing nodes
+  node_rank_map_t dense_map;
+  for (CELL_IDX_T i = 0; i < 1024; i++)
+    {
+      const CELL_IDX_T key = 2048 + (i * 7) % 1024;
+      if (key % 5 != 0)
+        {
+          dense_map[key].insert(key % 4);
+        }
+    }
+  dense_map[2051].insert(0);
+  CELL_IDX_T next_key = 2048;
+  for (const auto& element : dense_map)
+    {
+      while (next_key % 5 == 0)
+        next_key++;
+      assert(element.first == next_key);
+      if (element.first == 2051)
+        {
+          assert(set<rank_t>(element.second) == set<rank_t>({ 0, 3 }));
+        }
+      else
+        {
+          assert(set<rank_t>(element.second) == set<rank_t>({ rank_t(element.first % 4) }));
+        }
+      next_key++;
+    }
+  assert(next_key == 3072);
+  assert(dense_map.count(2051) == 1);
+  assert(dense_map.count(2055) == 0);
+
+  // inserting into a closed form assignment converts it
+  rr_map[200].insert(0);
+  assert(rr_map.size() == 101);
+  assert(*(rr_map.find(15)->second.begin()) == 1);
+  assert(rr_map.layout() == node_rank_map_t::LayoutExplicit);
+
+  vector<char> sendbuf;
+  data::serialize_data(node_rank_map, sendbuf);
+  node_rank_map_t received;
+  data::deserialize_data(sendbuf, received);
+  assert(received.size() == 3);
+  assert(set<rank_t>(received.find(3)->second) == set<rank_t>({ 0, 1 }));
+  assert(*(received.find(5000)->second.begin()) == 2);
+
+  printf("test_compact_rank_map: passed\n");
+  return 0;
+}
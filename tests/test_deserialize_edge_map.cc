@@ -0,0 +1,116 @@
+// -*- mode: c++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+//==============================================================================
+///  @file test_deserialize_edge_map.cc
+///
+///  Tests for unpacking and merging edge maps received from several ranks;
+///  the received buffers are large enough to be unpacked by several
+///  threads when built with OpenMP.
+///
+///  Copyright (C) 2016-2025 Project NeuroH5.
+//==============================================================================
+
+#include <cstdio>
+#include <map>
+#include <vector>
+
+#undef NDEBUG
+#include <cassert>
+
+#include "neuroh5_types.hh"
+#include "serialize_edge.hh"
+
+using namespace std;
+using namespace neuroh5;
+
+
+void append_edges (const edge_tuple_t& src, edge_tuple_t& dst)
+{
+  vector<NODE_IDX_T>& adj = get<0>(dst);
+  if (adj.empty())
+    {
+      dst = src;
+      return;
+    }
+  adj.insert(adj.end(), get<0>(src).begin(), get<0>(src).end());
+  get<1>(dst)[0].append(get<1>(src)[0]);
+}
+
+
+bool equal_edges (const edge_tuple_t& a, const edge_tuple_t& b)
+{
+  return (get<0>(a) == get<0>(b)) &&
+    (get<1>(a)[0].const_attr_vec<float>(0) == get<1>(b)[0].const_attr_vec<float>(0)) &&
+    (get<1>(a)[0].const_attr_vec<uint8_t>(0) == get<1>(b)[0].const_attr_vec<uint8_t>(0));
+}
+
+
+int main (int argc, char **argv)
+{
+  const size_t num_ranks = 4, num_nodes = 6000, num_edges = 16;
+
+  // every rank sends edges of an overlapping range of destinations
+  vector<char> recvbuf;
+  vector<size_t> recvcounts(num_ranks, 0), rdispls(num_ranks, 0);
+  edge_map_t expected;
+
+  // entries present before the received edges
+  edge_map_t prj_edge_map;
+  for (NODE_IDX_T dst = 0; dst < 100; dst++)
+    {
+      edge_tuple_t& et = prj_edge_map[dst*7];
+      get<0>(et).push_back(dst);
+      get<1>(et).resize(1);
+      get<1>(et)[0].insert(vector<float>(1, -1.0));
+      get<1>(et)[0].insert(vector<uint8_t>(1, 0));
+      append_edges(et, expected[dst*7]);
+    }
+
+  for (size_t r = 0; r < num_ranks; r++)
+    {
+      edge_map_t edge_map;
+      for (size_t i = 0; i < num_nodes; i++)
+        {
+          NODE_IDX_T dst = (r * num_nodes / 2) + i;
+          edge_tuple_t& et = edge_map[dst];
+          vector<float> weights;
+          vector<uint8_t> layers;
+          for (size_t j = 0; j < num_edges; j++)
+            {
+              get<0>(et).push_back(r * 100000 + i * num_edges + j);
+              weights.push_back(r + 0.5 * j);
+              layers.push_back(j % 4);
+            }
+          get<1>(et).resize(1);
+          get<1>(et)[0].insert(weights);
+          get<1>(et)[0].insert(layers);
+        }
+
+      for (auto it = edge_map.cbegin(); it != edge_map.cend(); ++it)
+        {
+          append_edges(it->second, expected[it->first]);
+        }
+
+      size_t num_packed_edges = 0;
+      rdispls[r] = recvbuf.size();
+      data::serialize_edge_map(edge_map, num_packed_edges, recvbuf);
+      recvcounts[r] = recvbuf.size() - rdispls[r];
+      assert(num_packed_edges == num_nodes * num_edges);
+    }
+
+  size_t num_unpacked_nodes = 0, num_unpacked_edges = 0;
+  data::deserialize_rank_edge_map(num_ranks, recvbuf, recvcounts, rdispls,
+                                  prj_edge_map, num_unpacked_nodes, num_unpacked_edges);
+
+  assert(num_unpacked_edges == num_ranks * num_nodes * num_edges);
+  assert(num_unpacked_nodes == expected.size() - 100);
+  assert(prj_edge_map.size() == expected.size());
+  for (auto it = expected.cbegin(); it != expected.cend(); ++it)
+    {
+      auto jt = prj_edge_map.find(it->first);
+      assert(jt != prj_edge_map.end());
+      assert(equal_edges(it->second, jt->second));
+    }
+
+  printf("test_deserialize_edge_map: passed\n");
+  return 0;
+}
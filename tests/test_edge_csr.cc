@@ -0,0 +1,107 @@
+// -*- mode: c++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+//==============================================================================
+///  @file test_edge_csr.cc
+///
+///  Tests for the flat CSR edge container.
+///
+///  Copyright (C) 2016-2025 Project NeuroH5.
+//==============================================================================
+
+#include <cstdio>
+#include <iostream>
+#include <string>
+#include <map>
+#include <vector>
+
+#undef NDEBUG
+#include <cassert>
+
+#include "neuroh5_types.hh"
+#include "edge_csr.hh"
+#include "serialize_edge.hh"
+
+using namespace std;
+using namespace neuroh5;
+
+
+int main (int argc, char **argv)
+{
+  // two senders with overlapping keys, as received in scatter_read_projection
+  vector<data::EdgeCSR> inputs(2);
+  vector<NODE_IDX_T> src = { 10, 11, 12, 13, 14 };
+  data::AttrVal attr_val;
+  attr_val.resize<float>(1);
+  attr_val.attr_vec<float>(0) = { 0.5, 1.5, 2.5, 3.5, 4.5 };
+  vector<const data::AttrVal*> attr_values(1, &attr_val);
+
+  inputs[0].init_attrs(attr_values);
+  inputs[1].init_attrs(attr_values);
+  // rows appended out of order are put in order by sort_rows
+  inputs[0].append_row(7, src, attr_values, 2, 4);
+  inputs[0].append_row(3, src, attr_values, 0, 2);
+  inputs[0].sort_rows();
+  assert(inputs[0].keys == vector<NODE_IDX_T>({3, 7}));
+  assert(inputs[0].adj == vector<NODE_IDX_T>({10, 11, 12, 13}));
+  inputs[1].append_row(3, src, attr_values, 4, 5, 100);
+
+  data::EdgeCSR merged;
+  data::merge_edge_csr(inputs, merged);
+  assert(merged.num_nodes() == 2);
+  assert(merged.num_edges() == 5);
+  assert(merged.find(3) == 0);
+  assert(merged.find(5) == merged.num_nodes());
+  assert(merged.adj == vector<NODE_IDX_T>({10, 11, 114, 12, 13}));
+  assert(merged.attrs[0].const_attr_vec<float>(0)[2] == 4.5);
+
+  // conversion to and from edge_map_t
+  edge_map_t edge_map;
+  merged.to_edge_map(edge_map);
+  assert(get<0>(edge_map[3]) == vector<NODE_IDX_T>({10, 11, 114}));
+  assert(get<1>(edge_map[7])[0].const_attr_vec<float>(0)[1] == 3.5);
+
+  data::EdgeCSR converted;
+  converted.from_edge_map(edge_map);
+  assert(converted.offsets == merged.offsets);
+  assert(converted.attrs[0].const_attr_vec<float>(0) == merged.attrs[0].const_attr_vec<float>(0));
+
+  // per-rank serialization
+  data::rank_edge_csr_t rank_edge_csr;
+  rank_edge_csr[0] = inputs[0];
+  rank_edge_csr[1] = inputs[1];
+  size_t num_packed_edges = 0;
+  vector<size_t> sendcounts, sdispls;
+  vector<char> sendbuf;
+  data::serialize_rank_edge_csr(2, 1, rank_edge_csr, num_packed_edges,
+                                sendcounts, sendbuf, sdispls);
+  assert(num_packed_edges == 5);
+
+  data::EdgeCSR received;
+  size_t num_nodes = 0, num_edges = 0;
+  data::deserialize_rank_edge_csr(2, sendbuf, sendcounts, sdispls,
+                                  received, num_nodes, num_edges);
+  assert(num_nodes == 2);
+  assert(num_edges == 5);
+  assert(received.adj == merged.adj);
+
+  // edge maps use the same wire format
+  rank_edge_map_t rank_edge_map;
+  rank_edge_map[1] = edge_map;
+  num_packed_edges = 0;
+  sendbuf.clear();
+  data::serialize_rank_edge_map(2, 0, rank_edge_map, num_packed_edges,
+                                sendcounts, sendbuf, sdispls);
+  assert(num_packed_edges == 5);
+  assert(sendcounts[0] == 0);
+  edge_map_t received_map;
+  num_nodes = 0; num_edges = 0;
+  data::deserialize_rank_edge_map(2, sendbuf, sendcounts, sdispls,
+                                  received_map, num_nodes, num_edges);
+  assert(num_nodes == 2);
+  assert(num_edges == 5);
+  assert(get<0>(received_map[3]) == get<0>(edge_map[3]));
+  assert(get<1>(received_map[7])[0].const_attr_vec<float>(0) ==
+         get<1>(edge_map[7])[0].const_attr_vec<float>(0));
+
+  printf("test_edge_csr: passed\n");
+  return 0;
+}
@@ -0,0 +1,87 @@
+// -*- mode: c++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+//==============================================================================
+///  @file test_io_rank_set.cc
+///
+///  Tests for the selection of I/O ranks over shared-memory nodes.
+///
+///  Copyright (C) 2016-2025 Project NeuroH5.
+//==============================================================================
+
+#include <cstdio>
+#include <set>
+#include <vector>
+
+#undef NDEBUG
+#include <cassert>
+
+#include "io_rank_set.hh"
+
+using namespace std;
+using namespace neuroh5;
+
+
+// num_nodes nodes of node_size consecutive ranks each
+vector<int> block_nodes (size_t num_nodes, size_t node_size)
+{
+  vector<int> rank_nodes;
+  for (size_t n = 0; n < num_nodes; n++)
+    {
+      rank_nodes.insert(rank_nodes.end(), node_size, n * node_size);
+    }
+  return rank_nodes;
+}
+
+
+int main (int argc, char **argv)
+{
+  // one I/O rank per node, on the lowest rank of the node
+  {
+    set<size_t> io_rank_set;
+    mpi::node_range_sample(block_nodes(4, 8), 4, io_rank_set);
+    assert(io_rank_set == set<size_t>({ 0, 8, 16, 24 }));
+  }
+
+  // two I/O ranks per node, evenly spaced within the node
+  {
+    set<size_t> io_rank_set;
+    mpi::node_range_sample(block_nodes(4, 8), 8, io_rank_set);
+    assert(io_rank_set == set<size_t>({ 0, 4, 8, 12, 16, 20, 24, 28 }));
+  }
+
+  // fewer I/O ranks than nodes
+  {
+    set<size_t> io_rank_set;
+    mpi::node_range_sample(block_nodes(4, 8), 2, io_rank_set);
+    assert(io_rank_set == set<size_t>({ 0, 16 }));
+  }
+
+  // the remainder goes to the first nodes
+  {
+    set<size_t> io_rank_set;
+    mpi::node_range_sample(block_nodes(3, 4), 5, io_rank_set);
+    assert(io_rank_set == set<size_t>({ 0, 2, 4, 6, 8 }));
+  }
+
+  // round-robin placement of ranks, and nodes of unequal size: the
+  // I/O ranks of a full node are given to the others
+  {
+    vector<int> rank_nodes({ 0, 1, 0, 1, 1, 1 });
+    set<size_t> io_rank_set;
+    mpi::node_range_sample(rank_nodes, 5, io_rank_set);
+    assert(io_rank_set == set<size_t>({ 0, 1, 2, 3, 4 }));
+
+    io_rank_set.clear();
+    mpi::node_range_sample(rank_nodes, 2, io_rank_set);
+    assert(io_rank_set == set<size_t>({ 0, 1 }));
+  }
+
+  // more I/O ranks than ranks
+  {
+    set<size_t> io_rank_set;
+    mpi::node_range_sample(block_nodes(2, 2), 8, io_rank_set);
+    assert(io_rank_set == set<size_t>({ 0, 1, 2, 3 }));
+  }
+
+  printf("test_io_rank_set: passed\n");
+  return 0;
+}
@@ -0,0 +1,128 @@
+// -*- mode: c++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+//==============================================================================
+///  @file test_mapped_dataset.cc
+///
+///  Tests for mapped dataset views of projections and cell attributes.
+///
+///  Copyright (C) 2016-2025 Project NeuroH5.
+//==============================================================================
+
+#include <hdf5.h>
+
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#undef NDEBUG
+#include <cassert>
+
+#include "neuroh5_types.hh"
+#include "path_names.hh"
+#include "mapped_dataset.hh"
+
+using namespace std;
+using namespace neuroh5;
+
+
+template <class T>
+void write_dataset (hid_t file, const string& path, hid_t ftype, hid_t mtype,
+                    const vector<T>& values, const bool chunked)
+{
+  hsize_t dims = values.size(), chunk = 2;
+  hid_t lcpl = H5Pcreate(H5P_LINK_CREATE);
+  H5Pset_create_intermediate_group(lcpl, 1);
+  hid_t dcpl = H5Pcreate(H5P_DATASET_CREATE);
+  if (chunked)
+    {
+      H5Pset_chunk(dcpl, 1, &chunk);
+    }
+  hid_t space = H5Screate_simple(1, &dims, NULL);
+  hid_t dset = H5Dcreate2(file, path.c_str(), ftype, space, lcpl, dcpl, H5P_DEFAULT);
+  assert(dset >= 0);
+  if (dims > 0)
+    {
+      assert(H5Dwrite(dset, mtype, H5S_ALL, H5S_ALL, H5P_DEFAULT, values.data()) >= 0);
+    }
+  H5Dclose(dset);
+  H5Sclose(space);
+  H5Pclose(dcpl);
+  H5Pclose(lcpl);
+}
+
+
+int main (int argc, char **argv)
+{
+  const string file_name = "test_mapped_dataset.h5";
+
+  vector<DST_BLK_PTR_T> dst_blk_ptr({ 0, 2, 3 });
+  vector<NODE_IDX_T> dst_blk_idx({ 10, 20 });
+  vector<DST_PTR_T> dst_ptr({ 0, 2, 3, 6 });
+  vector<NODE_IDX_T> src_idx({ 1, 2, 3, 4, 5, 6 });
+
+  vector<CELL_IDX_T> cell_index({ 5, 7 });
+  vector<ATTR_PTR_T> attr_ptr({ 0, 1, 3 });
+  vector<float> attr_value({ 0.5, 1.5, 2.5 });
+
+  hid_t file = H5Fcreate(file_name.c_str(), H5F_ACC_TRUNC, H5P_DEFAULT, H5P_DEFAULT);
+  assert(file >= 0);
+  write_dataset(file, hdf5::edge_attribute_path("A", "B", hdf5::EDGES, hdf5::DST_BLK_PTR),
+                H5T_NATIVE_UINT64, H5T_NATIVE_UINT64, dst_blk_ptr, false);
+  write_dataset(file, hdf5::edge_attribute_path("A", "B", hdf5::EDGES, hdf5::DST_BLK_IDX),
+                H5T_NATIVE_UINT32, H5T_NATIVE_UINT32, dst_blk_idx, false);
+  // chunked: read through HDF5
+  write_dataset(file, hdf5::edge_attribute_path("A", "B", hdf5::EDGES, hdf5::DST_PTR),
+                H5T_NATIVE_UINT64, H5T_NATIVE_UINT64, dst_ptr, true);
+  // non-native byte order: read through HDF5
+  write_dataset(file, hdf5::edge_attribute_path("A", "B", hdf5::EDGES, hdf5::SRC_IDX),
+                H5T_STD_U32BE, H5T_NATIVE_UINT32, src_idx, false);
+
+  string attr_path = hdf5::cell_attribute_path("Attributes", "GC", "a");
+  write_dataset(file, attr_path + "/" + hdf5::CELL_INDEX,
+                H5T_NATIVE_UINT32, H5T_NATIVE_UINT32, cell_index, false);
+  write_dataset(file, attr_path + "/" + hdf5::ATTR_PTR,
+                H5T_NATIVE_UINT64, H5T_NATIVE_UINT64, attr_ptr, false);
+  write_dataset(file, attr_path + "/" + hdf5::ATTR_VAL,
+                H5T_NATIVE_FLOAT, H5T_NATIVE_FLOAT, attr_value, false);
+  // empty dataset
+  write_dataset(file, "/empty", H5T_NATIVE_UINT32, H5T_NATIVE_UINT32, vector<uint32_t>(), false);
+  assert(H5Fclose(file) >= 0);
+
+  hdf5::DatasetView<DST_BLK_PTR_T> dst_blk_ptr_view;
+  hdf5::DatasetView<DST_PTR_T> dst_ptr_view;
+  {
+    hdf5::MappedFile mapped_file(file_name);
+    hdf5::ProjectionView prj = hdf5::view_projection(mapped_file, "A", "B");
+
+    assert(prj.dst_blk_ptr.mapped());
+    assert(prj.dst_blk_idx.mapped());
+    assert(!prj.dst_ptr.mapped());
+    assert(!prj.src_idx.mapped());
+
+    assert(vector<DST_BLK_PTR_T>(prj.dst_blk_ptr.begin(), prj.dst_blk_ptr.end()) == dst_blk_ptr);
+    assert(vector<NODE_IDX_T>(prj.dst_blk_idx.begin(), prj.dst_blk_idx.end()) == dst_blk_idx);
+    assert(vector<DST_PTR_T>(prj.dst_ptr.begin(), prj.dst_ptr.end()) == dst_ptr);
+    assert(vector<NODE_IDX_T>(prj.src_idx.begin(), prj.src_idx.end()) == src_idx);
+
+    hdf5::CellAttributeView<float> attr =
+      hdf5::view_cell_attribute<float>(mapped_file, "Attributes", "GC", "a");
+    assert(attr.index.mapped() && attr.ptr.mapped() && attr.value.mapped());
+    assert(vector<CELL_IDX_T>(attr.index.begin(), attr.index.end()) == cell_index);
+    assert(vector<ATTR_PTR_T>(attr.ptr.begin(), attr.ptr.end()) == attr_ptr);
+    assert(vector<float>(attr.value.begin(), attr.value.end()) == attr_value);
+
+    hdf5::DatasetView<uint32_t> empty = mapped_file.view<uint32_t>("/empty", H5T_NATIVE_UINT32);
+    assert(empty.empty());
+
+    dst_blk_ptr_view = prj.dst_blk_ptr;
+    dst_ptr_view = prj.dst_ptr;
+  }
+
+  // views outlive the file
+  assert(dst_blk_ptr_view.mapped() && dst_blk_ptr_view[2] == 3);
+  assert(dst_ptr_view.size() == dst_ptr.size() && dst_ptr_view[3] == 6);
+
+  remove(file_name.c_str());
+
+  printf("test_mapped_dataset: passed\n");
+  return 0;
+}
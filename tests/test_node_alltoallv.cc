@@ -0,0 +1,106 @@
+// -*- mode: c++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+//==============================================================================
+///  @file test_node_alltoallv.cc
+///
+///  Tests for the node-aggregated all-to-all exchange; run with several MPI
+///  ranks. Nodes of two ranks are simulated by splitting the ranks of one
+///  shared-memory node.
+///
+///  Copyright (C) 2016-2025 Project NeuroH5.
+//==============================================================================
+
+#include <mpi.h>
+
+#include <cstdio>
+#include <vector>
+
+#undef NDEBUG
+#include <cassert>
+
+#include "alltoallv_template.hh"
+
+using namespace std;
+using namespace neuroh5;
+
+
+// Sends from every second rank a varying number of values to every third
+// rank, and checks that the node exchange receives the same data as the
+// sparse exchange
+static void check_exchange (MPI_Comm comm, MPI_Comm node_comm)
+{
+  int rank, size;
+  MPI_Comm_rank(comm, &rank);
+  MPI_Comm_size(comm, &size);
+
+  vector<size_t> sendcounts(size, 0), sdispls(size, 0);
+  vector<int> sendbuf;
+  for (int j = 0; j < size; j++)
+    {
+      sdispls[j] = sendbuf.size();
+      if ((rank % 2 == 0) && (j % 3 != 1))
+        {
+          sendcounts[j] = (rank + 2*j) % 5;
+          for (size_t k = 0; k < sendcounts[j]; k++)
+            {
+              sendbuf.push_back(rank * 10000 + j * 100 + k);
+            }
+        }
+    }
+
+  vector<size_t> recvcounts, rdispls, node_recvcounts, node_rdispls;
+  vector<int> recvbuf;
+  mpi::RecvBuffer<int> node_recvbuf;
+  assert(mpi::sparse_alltoallv_vector<int>(comm, MPI_INT, sendcounts, sdispls, sendbuf,
+                                           recvcounts, rdispls, recvbuf) == MPI_SUCCESS);
+  if (node_comm == MPI_COMM_NULL)
+    {
+      assert(mpi::node_alltoallv_vector<int>(comm, MPI_INT, sendcounts, sdispls, sendbuf,
+                                             node_recvcounts, node_rdispls, node_recvbuf) == MPI_SUCCESS);
+    }
+  else
+    {
+      mpi::NodeTopology topology(comm, node_comm);
+      assert(mpi::node_alltoallv_vector<int>(comm, topology, MPI_INT, sendcounts, sdispls, sendbuf,
+                                             node_recvcounts, node_rdispls, node_recvbuf) == MPI_SUCCESS);
+    }
+
+  assert(node_recvcounts == recvcounts);
+  assert(node_rdispls == rdispls);
+  assert(node_recvbuf.size() == recvbuf.size());
+  assert(vector<int>(node_recvbuf.data(), node_recvbuf.data() + node_recvbuf.size()) == recvbuf);
+  node_recvbuf.free();
+}
+
+
+int main (int argc, char **argv)
+{
+  MPI_Init(&argc, &argv);
+  int rank;
+  MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+
+  // the shared-memory nodes of the communicator, whose topology is
+  // cached on the communicator after the first exchange
+  MPI_Comm comm;
+  MPI_Comm_dup(MPI_COMM_WORLD, &comm);
+  check_exchange(comm, MPI_COMM_NULL);
+  check_exchange(comm, MPI_COMM_NULL);
+  MPI_Comm_free(&comm);
+
+  // nodes of two ranks, so that data is also sent between nodes
+  MPI_Comm node_comm;
+  MPI_Comm_split(MPI_COMM_WORLD, rank / 2, rank, &node_comm);
+  check_exchange(MPI_COMM_WORLD, node_comm);
+  MPI_Comm_free(&node_comm);
+
+  // nodes with interleaved ranks
+  MPI_Comm_split(MPI_COMM_WORLD, rank % 2, rank, &node_comm);
+  check_exchange(MPI_COMM_WORLD, node_comm);
+  MPI_Comm_free(&node_comm);
+
+  if (rank == 0)
+    {
+      printf("test_node_alltoallv: passed\n");
+    }
+  MPI_Finalize();
+  return 0;
+}
@@ -0,0 +1,104 @@
+// -*- mode: c++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+//==============================================================================
+///  @file test_phase_stats.cc
+///
+///  Tests for the runtime phase statistics; run with several MPI ranks.
+///
+///  Copyright (C) 2016-2025 Project NeuroH5.
+//==============================================================================
+
+#include <mpi.h>
+
+#include <cstdio>
+#include <string>
+#include <thread>
+#include <vector>
+
+#undef NDEBUG
+#include <cassert>
+
+#include "phase_stats.hh"
+
+using namespace std;
+using namespace neuroh5;
+
+
+int main (int argc, char **argv)
+{
+  MPI_Init(&argc, &argv);
+
+  int rank, size;
+  MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+  MPI_Comm_size(MPI_COMM_WORLD, &size);
+
+  // nothing is recorded while disabled
+  mpi::enable_stats(false);
+  {
+    mpi::PhaseTimer timer("disabled");
+    mpi::count_read(1);
+  }
+  assert(mpi::local_stats().empty());
+
+  mpi::enable_stats(true);
+  for (int k = 0; k < 2; k++)
+    {
+      mpi::PhaseTimer timer("outer");
+      mpi::count_read(100);
+      {
+        mpi::PhaseTimer timer("inner");
+        // every rank sends 3 ints to each other rank
+        vector<size_t> counts(size, 3);
+        mpi::count_exchange<int>(rank, counts, counts);
+      }
+    }
+  if (rank == 0)
+    {
+      mpi::PhaseTimer timer("rank0");
+      mpi::count_write(10);
+    }
+  // phases nest per thread
+  {
+    mpi::PhaseTimer timer("main");
+    thread worker([] () {
+        mpi::PhaseTimer timer("worker");
+        mpi::count_read(5);
+      });
+    worker.join();
+  }
+
+  const auto& local = mpi::local_stats();
+  assert(local.at("outer").calls == 2);
+  assert(local.at("outer").bytes_read == 200);
+  assert(local.at("outer").bytes_sent == 0);
+  assert(local.at("outer/inner").bytes_sent == 2 * 3 * sizeof(int) * (size - 1));
+  assert(local.at("outer/inner").messages_recv == 2 * (size_t)(size - 1));
+  assert(local.at("outer/inner").time <= local.at("outer").time);
+  assert(local.at("worker").bytes_read == 5);
+  assert(local.at("main").bytes_read == 0);
+
+  mpi::StatsReport report;
+  mpi::collect_stats(MPI_COMM_WORLD, report);
+  assert(report.num_ranks == size);
+  assert(report.phases.size() == 5);
+  assert(report.phases["outer"]["bytes_read"].min == 200);
+  assert(report.phases["outer"]["bytes_read"].imbalance == 1.0);
+  // the phase run by rank 0 only counts as zero on the other ranks
+  const mpi::StatSummary& written = report.phases["rank0"]["bytes_written"];
+  assert(written.max == 10);
+  assert(written.min == ((size > 1) ? 0 : 10));
+  assert(written.imbalance == size);
+  assert(report.peak_rss_bytes.min > 0);
+
+  string json = mpi::stats_json(report);
+  assert(json.find("\"outer/inner\": {") != string::npos);
+
+  mpi::reset_stats();
+  assert(mpi::local_stats().empty());
+
+  if (rank == 0)
+    {
+      printf("test_phase_stats: passed\n");
+    }
+  MPI_Finalize();
+  return 0;
+}
@@ -0,0 +1,130 @@
+// -*- mode: c++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+//==============================================================================
+///  @file test_read_txt_edges.cc
+///
+///  Tests for the parallel reading of text projections; run with several
+///  MPI ranks.
+///
+///  Copyright (C) 2016-2025 Project NeuroH5.
+//==============================================================================
+
+#include <mpi.h>
+
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+#include <map>
+
+#undef NDEBUG
+#include <cassert>
+
+#include "neuroh5_types.hh"
+#include "attr_val.hh"
+#include "txt_tokenizer.hh"
+#include "read_txt_edges.hh"
+
+using namespace std;
+using namespace neuroh5;
+
+
+void test_parse_token ()
+{
+  const char* line = " 12\t-3 0.5 7x 300";
+  const char* end = line + strlen(line);
+  const char* p = line;
+  uint32_t u; int32_t i; float f; uint8_t b;
+  assert(io::parse_token(p, end, u) && u == 12);
+  assert(io::parse_token(p, end, i) && i == -3);
+  assert(io::parse_token(p, end, f) && f == 0.5f);
+  // incomplete values and values out of range are rejected
+  assert(!io::parse_token(p, end, u));
+  p = strchr(line, 'x') + 1;
+  assert(!io::parse_token(p, end, b));
+  assert(io::parse_token(p, end, u) && u == 300);
+  assert(!io::parse_token(p, end, u));
+}
+
+
+int main (int argc, char **argv)
+{
+  MPI_Init(&argc, &argv);
+
+  int rank, size;
+  MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+  MPI_Comm_size(MPI_COMM_WORLD, &size);
+
+  test_parse_token();
+
+  char file_name[] = "/tmp/test_read_txt_edges.txt";
+  const size_t num_lines = 1000;
+  size_t num_expected = 0;
+  if (rank == 0)
+    {
+      FILE* f = fopen(file_name, "w");
+      fprintf(f, "# dst src weight layer\n");
+      for (size_t i = 0; i < num_lines; i++)
+        {
+          unsigned int dst = (i * 7) % 101, src = i;
+          if (i % 17 == 0)
+            {
+              fprintf(f, "\n");
+            }
+          // lines of varying length, the last one without newline
+          fprintf(f, "%u%*s%u %g %u%s", dst, (int)(1 + i % 5), " ", src, 0.5 * i, (unsigned)(i % 11),
+                  (i + 1 < num_lines) ? "\n" : "");
+          num_expected++;
+        }
+      fclose(f);
+    }
+  MPI_Barrier(MPI_COMM_WORLD);
+
+  map <string, vector <size_t> > num_attrs;
+  num_attrs["Synapses"].resize(data::AttrVal::num_attr_types, 0);
+  num_attrs["Synapses"][data::AttrVal::attr_index_float] = 1;
+  num_attrs["Synapses"][data::AttrVal::attr_index_uint8] = 1;
+
+  vector<NODE_IDX_T> dst_idx, src_idx;
+  vector<DST_PTR_T> src_idx_ptr;
+  map <string, data::AttrVal> attrs_map;
+  assert(io::read_txt_edges(MPI_COMM_WORLD, file_name, num_attrs,
+                            dst_idx, src_idx_ptr, src_idx, attrs_map) == 0);
+
+  assert(src_idx_ptr.size() == dst_idx.size() + 1);
+  assert(src_idx_ptr.back() == src_idx.size());
+  const data::AttrVal& attr_val = attrs_map["Synapses"];
+  assert(attr_val.size_attr_vec<float>() == 1);
+  assert(attr_val.size_attr_vec<uint8_t>() == 1);
+  assert(attr_val.const_attr_vec<float>(0).size() == src_idx.size());
+
+  uint64_t num_edges = src_idx.size(), src_sum = 0;
+  for (size_t d = 0; d < dst_idx.size(); d++)
+    {
+      if (d > 0)
+        {
+          assert(dst_idx[d-1] < dst_idx[d]);
+        }
+      for (size_t j = src_idx_ptr[d]; j < src_idx_ptr[d+1]; j++)
+        {
+          size_t i = src_idx[j];
+          src_sum += i;
+          assert(dst_idx[d] == (i * 7) % 101);
+          assert(attr_val.const_attr_vec<float>(0)[j] == (float)(0.5 * i));
+          assert(attr_val.const_attr_vec<uint8_t>(0)[j] == i % 11);
+        }
+    }
+
+  // every line is read by exactly one rank
+  uint64_t total_num_edges = 0, total_src_sum = 0;
+  MPI_Allreduce(&num_edges, &total_num_edges, 1, MPI_UINT64_T, MPI_SUM, MPI_COMM_WORLD);
+  MPI_Allreduce(&src_sum, &total_src_sum, 1, MPI_UINT64_T, MPI_SUM, MPI_COMM_WORLD);
+  if (rank == 0)
+    {
+      assert(total_num_edges == num_expected);
+      assert(total_src_sum == num_lines * (num_lines - 1) / 2);
+      remove(file_name);
+      printf("test_read_txt_edges: passed\n");
+    }
+  MPI_Finalize();
+  return 0;
+}
@@ -0,0 +1,111 @@
+// -*- mode: c++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+//==============================================================================
+///  @file test_shared_edge_csr.cc
+///
+///  Tests for copying projection edges to memory shared by the ranks of
+///  each node; run with several MPI ranks.
+///
+///  Copyright (C) 2016-2025 Project NeuroH5.
+//==============================================================================
+
+#include <mpi.h>
+
+#include <cstdio>
+#include <vector>
+
+#undef NDEBUG
+#include <cassert>
+
+#include "neuroh5_types.hh"
+#include "edge_csr.hh"
+#include "shared_edge_csr.hh"
+#include "shared_segment.hh"
+
+using namespace std;
+using namespace neuroh5;
+
+
+int main (int argc, char **argv)
+{
+  MPI_Init(&argc, &argv);
+
+  int rank, size;
+  MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+  MPI_Comm_size(MPI_COMM_WORLD, &size);
+  const int root = size - 1;
+
+  const size_t num_nodes = 100, num_edges = 5;
+  data::EdgeCSR edge_csr(EdgeMapSrc);
+  if (rank == root)
+    {
+      vector<NODE_IDX_T> adj_values;
+      data::AttrVal attr_val;
+      vector<float> weights;
+      vector<uint8_t> layers;
+      for (size_t i = 0; i < num_nodes * num_edges; i++)
+        {
+          adj_values.push_back(i * 3);
+          weights.push_back(0.25 * i);
+          layers.push_back(i % 7);
+        }
+      attr_val.insert(weights);
+      attr_val.insert(layers);
+      vector<const data::AttrVal*> attr_values({ &attr_val });
+      edge_csr.init_attrs(attr_values);
+      for (size_t i = 0; i < num_nodes; i++)
+        {
+          edge_csr.append_row(i * 2, adj_values, attr_values, i * num_edges, (i+1) * num_edges);
+        }
+    }
+
+  data::SharedEdgeCSR shared_edge_csr;
+  data::bcast_shared_edge_csr(MPI_COMM_WORLD, root, edge_csr, shared_edge_csr);
+
+  assert(shared_edge_csr.edge_map_type == EdgeMapSrc);
+  assert(shared_edge_csr.num_nodes() == num_nodes);
+  assert(shared_edge_csr.num_edges() == num_nodes * num_edges);
+  assert(shared_edge_csr.keys.mapped());
+  assert(shared_edge_csr.attrs.size() == 1);
+  const data::SharedAttrColumns& attr_columns = shared_edge_csr.attrs[0];
+  assert(attr_columns.attr_columns<float>().size() == 1);
+  assert(attr_columns.attr_columns<uint8_t>().size() == 1);
+  assert(attr_columns.attr_columns<int32_t>().size() == 0);
+
+  for (size_t i = 0; i < num_nodes; i++)
+    {
+      assert(shared_edge_csr.keys[i] == i * 2);
+      assert(shared_edge_csr.offsets[i] == i * num_edges);
+    }
+  assert(shared_edge_csr.offsets[num_nodes] == num_nodes * num_edges);
+  for (size_t i = 0; i < num_nodes * num_edges; i++)
+    {
+      assert(shared_edge_csr.adj[i] == i * 3);
+      assert(attr_columns.attr_columns<float>()[0][i] == 0.25f * i);
+      assert(attr_columns.attr_columns<uint8_t>()[0][i] == i % 7);
+    }
+
+  // the segment is kept until its views are destroyed on all ranks
+  assert(mpi::release_shared_segments(MPI_COMM_WORLD) == 0);
+  data::SharedEdgeCSR shared_edge_csr_copy = shared_edge_csr;
+  shared_edge_csr = data::SharedEdgeCSR();
+  if (rank % 2 == 0)
+    {
+      shared_edge_csr_copy = data::SharedEdgeCSR();
+    }
+  // the segment of a node with even ranks only is freed first
+  MPI_Comm node_comm;
+  MPI_Comm_split_type(MPI_COMM_WORLD, MPI_COMM_TYPE_SHARED, rank, MPI_INFO_NULL, &node_comm);
+  int even = (rank % 2 == 0), node_even;
+  MPI_Allreduce(&even, &node_even, 1, MPI_INT, MPI_MIN, node_comm);
+  MPI_Comm_free(&node_comm);
+  assert(mpi::release_shared_segments(MPI_COMM_WORLD) == (node_even ? 1 : 0));
+  shared_edge_csr_copy = data::SharedEdgeCSR();
+  assert(mpi::release_shared_segments(MPI_COMM_WORLD) == (node_even ? 0 : 1));
+
+  if (rank == 0)
+    {
+      printf("test_shared_edge_csr: passed\n");
+    }
+  MPI_Finalize();
+  return 0;
+}
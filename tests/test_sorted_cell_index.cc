@@ -0,0 +1,69 @@
+// -*- mode: c++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+//==============================================================================
+///  @file test_sorted_cell_index.cc
+///
+///  Tests for the sorted cell attribute index and the cell index cache.
+///
+///  Copyright (C) 2016-2025 Project NeuroH5.
+//==============================================================================
+
+#include <cstdio>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#undef NDEBUG
+#include <cassert>
+
+#include "neuroh5_types.hh"
+#include "cell_index_cache.hh"
+
+using namespace std;
+using namespace neuroh5;
+
+
+int main (int argc, char **argv)
+{
+  // unsorted index; cell 12 has no values
+  vector<CELL_IDX_T> index({ 15, 10, 12, 11 });
+  vector<ATTR_PTR_T> ptr({ 0, 3, 5, 5, 9 });
+  data::SortedCellIndex sorted_index(index, ptr);
+  assert(sorted_index.size() == 4);
+
+  vector<CELL_IDX_T> selection_index;
+  vector< pair<hsize_t,hsize_t> > ranges;
+  sorted_index.select(10, { 11, 15, 9, 12, 10, 20 }, selection_index, ranges);
+
+  // ranges are ordered by value offset, then by selection order
+  assert(selection_index == vector<CELL_IDX_T>({ 15, 10, 11, 12 }));
+  assert(ranges == (vector< pair<hsize_t,hsize_t> >({ {0,3}, {3,2}, {5,4}, {5,0} })));
+
+  // sorted index, and selection below the population start
+  data::SortedCellIndex sorted_index2(vector<CELL_IDX_T>({ 100, 101, 102 }),
+                                      vector<ATTR_PTR_T>({ 0, 1, 2, 3 }));
+  selection_index.clear(); ranges.clear();
+  sorted_index2.select(101, { 102, 100, 101 }, selection_index, ranges);
+  assert(selection_index == vector<CELL_IDX_T>({ 101, 102 }));
+  assert(ranges == (vector< pair<hsize_t,hsize_t> >({ {1,1}, {2,1} })));
+
+  // empty index
+  data::SortedCellIndex empty_index;
+  selection_index.clear(); ranges.clear();
+  empty_index.select(0, { 1, 2 }, selection_index, ranges);
+  assert(empty_index.empty() && selection_index.empty() && ranges.empty());
+
+  // cache lookups by namespace, population and population start
+  data::CellIndexCache cache;
+  auto attr_index = make_shared<data::CellAttributeIndex>();
+  attr_index->attributes.push_back(make_pair(string("a"), AttrKind(FloatVal, 4)));
+  attr_index->indices.push_back(make_shared<data::SortedCellIndex>(index, ptr));
+  cache.insert("Attributes", "GC", 10, attr_index);
+  assert(cache.find("Attributes", "GC", 10) == attr_index);
+  assert(cache.find("Attributes", "GC", 0) == nullptr);
+  assert(cache.find("Other", "GC", 10) == nullptr);
+  cache.clear();
+  assert(cache.find("Attributes", "GC", 10) == nullptr);
+
+  printf("test_sorted_cell_index: passed\n");
+  return 0;
+}
@@ -0,0 +1,135 @@
+##
+## Writes the same projection and cell attributes with the dictionary
+## entry points (write_graph, append_cell_attributes) and the array entry
+## points (write_graph_arrays, append_cell_attribute_arrays), and checks
+## that the data read back from both files are equal. The last rank
+## gives no data, so that the array entry points are also checked with
+## empty arrays and omitted attributes.
+##
+## Usage: mpirun -n N python test_write_graph_arrays.py [output_dir]
+##
+
+import os, sys
+from mpi4py import MPI
+import h5py
+import numpy as np
+from neuroh5.io import write_graph, write_graph_arrays, read_graph, \
+     append_cell_attributes, append_cell_attribute_arrays, read_cell_attributes
+
+comm = MPI.COMM_WORLD
+rank = comm.Get_rank()
+size = comm.Get_size()
+
+output_dir = sys.argv[1] if len(sys.argv) > 1 else "data"
+nodes_per_rank = 20
+num_nodes = nodes_per_rank * size
+
+path_population_labels = '/H5Types/Population labels'
+path_population_range = '/H5Types/Population range'
+
+
+def create_file(output_path):
+    pop_defs = [ ('SRC', 0, num_nodes, 0), ('DST', num_nodes, num_nodes, 1) ]
+    with h5py.File(output_path, "w") as h5:
+        mapping = { name: idx for name, start, count, idx in pop_defs }
+        h5[path_population_labels] = h5py.special_dtype(enum=(np.uint16, mapping))
+        h5[path_population_range] = np.dtype([("Start", np.uint64), ("Count", np.uint32),
+                                              ("Population", h5[path_population_labels].dtype)])
+        dt = h5[path_population_range].dtype
+        a = np.zeros(len(pop_defs), dtype=dt)
+        for name, start, count, idx in pop_defs:
+            a[idx]["Start"] = start
+            a[idx]["Count"] = count
+            a[idx]["Population"] = idx
+        h5['H5Types'].create_dataset('Populations', data=a, maxshape=(len(pop_defs),))
+
+
+## Destinations of this rank in descending order, with a varying number
+## of edges (including none) and unsorted sources
+rng = np.random.RandomState(rank)
+dst_gids = []
+if (size == 1) or (rank < size - 1):
+    dst_gids = [ num_nodes + rank * nodes_per_rank + i for i in reversed(range(nodes_per_rank)) ]
+
+edges = {}
+cell_attrs = {}
+for dst in dst_gids:
+    num_edges = dst % 5
+    src = rng.randint(0, num_nodes, size=num_edges).astype(np.uint32)
+    distance = rng.uniform(size=num_edges).astype(np.float32)
+    layer = rng.randint(0, 4, size=num_edges).astype(np.uint8)
+    edges[dst] = (src, { 'Synapses': { 'distance': distance, 'layer': layer } })
+    cell_attrs[dst] = { 'weights': rng.lognormal(size=dst % 3 + 1).astype(np.float32),
+                        'syn_ids': np.arange(dst % 4, dtype=np.uint32) }
+
+## The same data in CSR layout
+edge_dst_gids = np.asarray(dst_gids, dtype=np.uint32)
+edge_dst_ptr = np.zeros(len(dst_gids) + 1, dtype=np.uint64)
+edge_dst_ptr[1:] = np.cumsum([ len(edges[dst][0]) for dst in dst_gids ])
+edge_src_gids = np.concatenate([ edges[dst][0] for dst in dst_gids ] + [ np.zeros(0, dtype=np.uint32) ])
+edge_attrs = {}
+if len(dst_gids) > 0:
+    edge_attrs = { 'Synapses': { name: np.concatenate([ edges[dst][1]['Synapses'][name]
+                                                        for dst in dst_gids ])
+                                 for name in ['distance', 'layer'] } }
+
+cell_attr_arrays = {}
+if len(dst_gids) > 0:
+    for name in ['weights', 'syn_ids']:
+        attr_ptr = np.zeros(len(dst_gids) + 1, dtype=np.uint64)
+        attr_ptr[1:] = np.cumsum([ len(cell_attrs[dst][name]) for dst in dst_gids ])
+        values = np.concatenate([ cell_attrs[dst][name] for dst in dst_gids ])
+        cell_attr_arrays[name] = (attr_ptr, values)
+
+dict_path = os.path.join(output_dir, "test_write_graph_dict.h5")
+array_path = os.path.join(output_dir, "test_write_graph_arrays.h5")
+if rank == 0:
+    create_file(dict_path)
+    create_file(array_path)
+comm.barrier()
+
+write_graph(dict_path, 'SRC', 'DST', edges, comm=comm, io_size=2)
+append_cell_attributes(dict_path, 'DST', cell_attrs, namespace='Test Attributes',
+                       comm=comm, io_size=2)
+
+write_graph_arrays(array_path, 'SRC', 'DST', edge_dst_gids, edge_dst_ptr, edge_src_gids,
+                   edge_attrs=edge_attrs, comm=comm, io_size=2)
+append_cell_attribute_arrays(array_path, 'DST', edge_dst_gids, cell_attr_arrays,
+                             namespace='Test Attributes', comm=comm, io_size=2)
+comm.barrier()
+
+
+def read_edges(path):
+    (graph, _) = read_graph(path, namespaces=['Synapses'], comm=comm)
+    return { dst: (src, attrs) for dst, (src, attrs) in graph['DST']['SRC'] }
+
+
+def read_attrs(path):
+    return { gid: attrs for gid, attrs in read_cell_attributes(path, 'DST', namespace='Test Attributes',
+                                                               comm=comm) }
+
+dict_edges = read_edges(dict_path)
+array_edges = read_edges(array_path)
+assert sorted(dict_edges.keys()) == sorted(array_edges.keys())
+for dst in dict_edges:
+    (dict_src, dict_attrs) = dict_edges[dst]
+    (array_src, array_attrs) = array_edges[dst]
+    assert np.array_equal(dict_src, array_src)
+    assert len(dict_attrs['Synapses']) == len(array_attrs['Synapses'])
+    for (a, b) in zip(dict_attrs['Synapses'], array_attrs['Synapses']):
+        assert np.array_equal(a, b)
+
+dict_cell_attrs = read_attrs(dict_path)
+array_cell_attrs = read_attrs(array_path)
+assert sorted(dict_cell_attrs.keys()) == sorted(array_cell_attrs.keys())
+for gid in dict_cell_attrs:
+    assert sorted(dict_cell_attrs[gid].keys()) == sorted(array_cell_attrs[gid].keys())
+    for name in dict_cell_attrs[gid]:
+        assert np.array_equal(dict_cell_attrs[gid][name], array_cell_attrs[gid][name])
+
+num_edges = comm.allreduce(len(dict_edges), op=MPI.SUM)
+num_cells = comm.allreduce(len(dict_cell_attrs), op=MPI.SUM)
+if rank == 0:
+    print("test_write_graph_arrays: %d destinations and %d cells are equal" % (num_edges, num_cells))
+    os.remove(dict_path)
+    os.remove(array_path)